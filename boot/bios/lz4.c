@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "lz4.h"
+#include <constants.h>
+#include <stdint.h>
+
+/* Compressed chunk staging area: sectors land here, the decoder reads
+   straight out of it.  Static so stage 2 needs no allocator. */
+static uint8_t s_ChunkBuf[LZ4_CHUNK_MAX];
+
+/* Pull exactly `count` bytes through the read callback (FS_Read may
+   return short reads at sector boundaries). */
+static int read_full(int fd, lz4_read_fn read_fn, uint8_t *buf, uint32_t count)
+{
+   uint32_t done = 0;
+   while (done < count)
+   {
+      int n = read_fn(fd, buf + done, (int)(count - done));
+      if (n <= 0) return -EIO;
+      done += (uint32_t)n;
+   }
+   return 0;
+}
+
+/* Decode one raw LZ4 block.  `dst_base` marks the start of the output
+   image so match offsets may reach back across chunk boundaries.
+   Returns bytes written or negative on malformed input. */
+static int lz4_decode_block(const uint8_t *src, uint32_t src_len, uint8_t *dst,
+                            uint32_t dst_cap, const uint8_t *dst_base)
+{
+   uint32_t si = 0;
+   uint32_t di = 0;
+
+   while (si < src_len)
+   {
+      uint8_t token = src[si++];
+
+      /* Literal run */
+      uint32_t lit = token >> 4;
+      if (lit == 15)
+      {
+         uint8_t b;
+         do
+         {
+            if (si >= src_len) return -EINVAL;
+            b = src[si++];
+            lit += b;
+         } while (b == 255);
+      }
+
+      if (si + lit > src_len || di + lit > dst_cap) return -EINVAL;
+      for (uint32_t i = 0; i < lit; i++) dst[di + i] = src[si + i];
+      si += lit;
+      di += lit;
+
+      /* Last sequence has no match part. */
+      if (si >= src_len) break;
+
+      if (si + 2 > src_len) return -EINVAL;
+      uint32_t offset = (uint32_t)src[si] | ((uint32_t)src[si + 1] << 8);
+      si += 2;
+      if (offset == 0 || offset > (uint32_t)(&dst[di] - dst_base))
+         return -EINVAL;
+
+      uint32_t mlen = token & 0x0F;
+      if (mlen == 15)
+      {
+         uint8_t b;
+         do
+         {
+            if (si >= src_len) return -EINVAL;
+            b = src[si++];
+            mlen += b;
+         } while (b == 255);
+      }
+      mlen += 4;
+
+      if (di + mlen > dst_cap) return -EINVAL;
+
+      /* Byte-wise copy: overlapping matches (offset < mlen) are the
+         RLE case and must replay already-written bytes. */
+      const uint8_t *match = &dst[di] - offset;
+      for (uint32_t i = 0; i < mlen; i++) dst[di + i] = match[i];
+      di += mlen;
+   }
+
+   return (int)di;
+}
+
+int LZ4_DecompressImage(int fd, lz4_read_fn read_fn, void *out,
+                        uint32_t out_cap, uint32_t *out_size)
+{
+   uint8_t *dst = (uint8_t *)out;
+   uint32_t header[2];
+
+   if (read_full(fd, read_fn, (uint8_t *)header, sizeof(header)) != 0)
+      return -EIO;
+   if (header[0] != LZ4_IMAGE_MAGIC) return -EINVAL;
+
+   uint32_t total = header[1];
+   if (total > out_cap) return -EINVAL;
+
+   uint32_t done = 0;
+   while (done < total)
+   {
+      uint32_t chunk[2];
+      if (read_full(fd, read_fn, (uint8_t *)chunk, sizeof(chunk)) != 0)
+         return -EIO;
+
+      uint32_t csize = chunk[0];
+      uint32_t dsize = chunk[1];
+      if (dsize == 0 || dsize > LZ4_CHUNK_MAX || done + dsize > total)
+         return -EINVAL;
+
+      if (csize == 0)
+      {
+         /* Stored chunk: read straight into place. */
+         if (read_full(fd, read_fn, dst + done, dsize) != 0) return -EIO;
+      }
+      else
+      {
+         if (csize > LZ4_CHUNK_MAX) return -EINVAL;
+         if (read_full(fd, read_fn, s_ChunkBuf, csize) != 0) return -EIO;
+
+         int n = lz4_decode_block(s_ChunkBuf, csize, dst + done,
+                                  total - done, dst);
+         if (n < 0) return n;
+         if ((uint32_t)n != dsize) return -EINVAL;
+      }
+
+      done += dsize;
+   }
+
+   if (out_size) *out_size = done;
+   return SUCCESS;
+}
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef BOOT_LZ4_H
+#define BOOT_LZ4_H
+
+#include <stdint.h>
+
+/*
+ * Streaming decompressor for the LZ4-compressed kernel image.
+ *
+ * The build pipeline (scripts/scons/lz4.py) wraps raw LZ4 blocks in a
+ * minimal container so the loader can decompress while sectors arrive:
+ *
+ *   u32 magic "VLZ4"          (0x345A4C56 little endian)
+ *   u32 uncompressed size
+ *   per chunk:
+ *     u32 csize               (0 = chunk stored uncompressed)
+ *     u32 dsize               (uncompressed bytes in this chunk)
+ *     csize (or dsize) bytes of payload
+ *
+ * Chunks are compressed independently, so each one can be decoded as
+ * soon as its bytes are read, overlapping disk I/O with decompression.
+ */
+
+#define LZ4_IMAGE_MAGIC 0x345A4C56u
+#define LZ4_CHUNK_MAX 32768u
+
+/* Read callback: same shape as the corefs FS_Read export. */
+typedef int (*lz4_read_fn)(int fd, void *buffer, int count);
+
+/* Decompress a whole image from an open file into `out`.
+ * Returns 0 on success (uncompressed size in *out_size), negative on
+ * bad container data, read failure or output overflow. */
+int LZ4_DecompressImage(int fd, lz4_read_fn read_fn, void *out,
+                        uint32_t out_cap, uint32_t *out_size);
+
+#endif /* BOOT_LZ4_H */
@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 
+#include "lz4.h"
 #include "video/video.h"
 #include <constants.h>
 // #include <"video/logo_gen.h">
@@ -64,6 +65,13 @@ int g_PrimaryOutputSystem = 0;
 int preferredOutput = OUTPUT_VGATEXT;
 const char *stage3Path = "/boot/libTheBootloader-" OS_VERSION ".a";
 
+/* The image pipeline stages the LZ4-compressed kernel under this fixed
+ * name; it is decompressed here into high memory, above everything the
+ * loader itself touches. */
+const char *kernelLz4Path = "/boot/kernel.lz4";
+#define KERNEL_LOAD_ADDRESS 0x01000000u /* 16 MiB */
+#define KERNEL_LOAD_MAX 0x01000000u     /* room for a 16 MiB image */
+
 static void init_framebuffer_info(uint8_t *ptr)
 {
    for (;;)
@@ -276,6 +284,13 @@ int main(const BootParams *bootParams)
 
    g_PrimaryOutputSystem = availableOutputs;
 
+#ifdef BOOT_QUIET
+   /* Quiet boot: hold the informational dumps below until the kernel
+    * image read is issued, so slow consoles do not gate the disk work.
+    * Error paths flush the backlog immediately for context. */
+   Print_SetQuiet(true);
+#endif
+
    print_available_outputs(availableOutputs);
    print_memory_map(ptr);
    print_boot_drive_number(bootDrive);
@@ -300,6 +315,7 @@ int main(const BootParams *bootParams)
                              partitionLabel);
       if (rc != SUCCESS)
       {
+         Print_FlushDeferred();
          puts("  FS_Initialize failed: ");
          puti(rc);
          puts(".\n");
@@ -339,8 +355,48 @@ int main(const BootParams *bootParams)
                FS_Close(fd2);
             }
          }
+
+         /* Load the compressed kernel image, decoding chunk by chunk
+          * as its sectors arrive. */
+         {
+            int kfd = FS_Open(kernelLz4Path);
+            if (kfd >= 0)
+            {
+               /* The kernel read is in flight: the deferred output no
+                * longer delays it, so replay the backlog now. */
+               Print_FlushDeferred();
+
+               uint32_t kernelSize = 0;
+               int krc = LZ4_DecompressImage(kfd, FS_Read,
+                                             (void *)KERNEL_LOAD_ADDRESS,
+                                             KERNEL_LOAD_MAX, &kernelSize);
+               FS_Close(kfd);
+
+               if (krc == SUCCESS)
+               {
+                  puts("  Kernel image decompressed: ");
+                  puti((int)kernelSize);
+                  puts(" bytes at 16 MiB.\n");
+               }
+               else
+               {
+                  puts("  Kernel decompression failed: ");
+                  puti(krc);
+                  puts(".\n");
+               }
+            }
+            else
+            {
+               Print_FlushDeferred();
+               puts("  No compressed kernel image found.\n");
+            }
+         }
       }
    }
 
+   /* Push any partial last line before handing off. */
+   Print_FlushDeferred();
+   Print_Flush();
+
    return 0;
 }
\ No newline at end of file
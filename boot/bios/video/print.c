@@ -56,7 +56,22 @@ static void put_signed(long long val, unsigned radix, const char *digits,
    }
 }
 
-void putc(char c)
+/* Output is staged in a line buffer and flushed whole lines at a time;
+ * VGA text mode gets the line as one VGATEXT_PutString call (rep movsw
+ * plus a single cursor update) instead of per-character writes. */
+#define PRINT_LINE_MAX 256
+static char s_LineBuf[PRINT_LINE_MAX];
+static int s_LineLen = 0;
+
+/* Quiet mode parks everything written through putc here; the buffer is
+ * replayed by Print_FlushDeferred once the kernel image read has been
+ * issued (or as soon as something goes wrong). */
+#define PRINT_DEFER_MAX 8192
+static char s_DeferBuf[PRINT_DEFER_MAX];
+static int s_DeferLen = 0;
+static bool s_Quiet = false;
+
+static void backend_putc(char c)
 {
    switch (preferredOutput)
    {
@@ -78,6 +93,52 @@ void putc(char c)
    }
 }
 
+void Print_Flush(void)
+{
+   if (s_LineLen == 0) return;
+
+   if (preferredOutput == OUTPUT_VGATEXT)
+   {
+      VGATEXT_PutString(s_LineBuf, s_LineLen, VGATEXT_DEFAULT_COLOR);
+   }
+   else
+   {
+      for (int i = 0; i < s_LineLen; i++) backend_putc(s_LineBuf[i]);
+   }
+   s_LineLen = 0;
+}
+
+void Print_SetQuiet(bool on)
+{
+   if (!on && s_Quiet) Print_FlushDeferred();
+   s_Quiet = on;
+}
+
+void Print_FlushDeferred(void)
+{
+   if (!s_Quiet) return;
+
+   /* Replay through the normal buffered path. */
+   s_Quiet = false;
+   for (int i = 0; i < s_DeferLen; i++) putc(s_DeferBuf[i]);
+   s_DeferLen = 0;
+   Print_Flush();
+}
+
+void putc(char c)
+{
+   if (s_Quiet)
+   {
+      /* Deferred output is best effort; a full buffer drops the rest
+       * rather than slowing the boot it exists to speed up. */
+      if (s_DeferLen < PRINT_DEFER_MAX) s_DeferBuf[s_DeferLen++] = c;
+      return;
+   }
+
+   s_LineBuf[s_LineLen++] = c;
+   if (c == '\n' || s_LineLen == PRINT_LINE_MAX) Print_Flush();
+}
+
 void puts(const char *str)
 {
    if (!str) return;
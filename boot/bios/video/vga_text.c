@@ -157,6 +157,69 @@ int VGATEXT_PutChar(char c, int x, int y, char color)
    return SUCCESS;
 }
 
+int VGATEXT_PutString(const char *str, int len, char color)
+{
+   if (!s_Initialized) return -ENODEV;
+   if (!str || len < 0) return -EINVAL;
+
+   while (len > 0)
+   {
+      /* Control characters keep the per-character path (cursor motion,
+       * scrolling). */
+      if (*str == '\n' || *str == '\r' || *str == '\t' || *str == '\b')
+      {
+         VGATEXT_PutChar(*str, -1, -1, color);
+         str++;
+         len--;
+         continue;
+      }
+
+      /* Length of the printable run ahead of us. */
+      int run = 0;
+      while (run < len && str[run] != '\n' && str[run] != '\r' &&
+             str[run] != '\t' && str[run] != '\b')
+         run++;
+
+      /* Blit the run row by row with rep movsw; the hardware cursor is
+       * only reprogrammed once, below, instead of two port writes per
+       * character. */
+      while (run > 0)
+      {
+         int space = VGATEXT_WIDTH - s_CursorX;
+         int n = (run < space) ? run : space;
+
+         uint16_t cells[VGATEXT_WIDTH];
+         for (int i = 0; i < n; i++)
+            cells[i] =
+                (uint16_t)((uint8_t)str[i] | ((uint16_t)(uint8_t)color << 8));
+
+         volatile uint16_t *dst = (volatile uint16_t *)VGATEXT_BUFFER +
+                                  s_CursorY * VGATEXT_WIDTH + s_CursorX;
+         const uint16_t *src = cells;
+         int cnt = n;
+         __asm__ volatile("rep movsw"
+                          : "+S"(src), "+D"(dst), "+c"(cnt)
+                          :
+                          : "memory");
+
+         s_CursorX += n;
+         if (s_CursorX >= VGATEXT_WIDTH)
+         {
+            s_CursorX = 0;
+            s_CursorY++;
+            if (s_CursorY >= VGATEXT_HEIGHT) scroll();
+         }
+
+         str += n;
+         len -= n;
+         run -= n;
+      }
+   }
+
+   move_cursor(s_CursorX, s_CursorY);
+   return SUCCESS;
+}
+
 int VGATEXT_PutPixel(int pixel, int x, int y)
 {
    (void)pixel;
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #pragma once
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -48,6 +49,7 @@ extern int preferredOutput; /* Preferred output system. */
 
 int VGATEXT_Initialize(void); /* Initialize VGA text mode. */
 int VGATEXT_PutChar(char c, int x, int y, char color); /* Put text char. */
+int VGATEXT_PutString(const char *str, int len, char color); /* Blit run. */
 int VGATEXT_PutPixel(int pixel, int x, int y);         /* Text mode: -EINVAL. */
 
 int Serial_Initialize(void); /* Initialize COM1 serial. */
@@ -74,6 +76,9 @@ int VGA_PutPixel(int pixel, int x, int y);         /* Put VGA pixel. */
 
 void putc(char c);                   /* Write a single character. */
 void puts(const char *str);          /* Write a null-terminated string. */
+void Print_Flush(void);              /* Flush the pending output line. */
+void Print_SetQuiet(bool on);        /* Defer non-error output. */
+void Print_FlushDeferred(void);      /* Replay deferred quiet output. */
 void puti(int val);                  /* Write signed int as decimal. */
 void putd(int val);                  /* Write signed int as decimal. */
 void putl(long val);                 /* Write signed long as decimal. */
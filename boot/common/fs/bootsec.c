@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Shared sector cache for the stage-2 partition hunt.
+ *
+ * MBR and GPT probing both read the first sectors of every candidate
+ * drive, and each probe/list pair re-reads what the probe just fetched.
+ * Cache those single sectors per (drive, LBA) so the hunt issues one
+ * BIOS read per sector instead of a burst of duplicates.  Boot media
+ * does not change underneath stage-2, so entries never expire. */
+
+#define BOOTSEC_SECTOR_SIZE 512
+#define BOOTSEC_CACHE_SLOTS 8
+#define BOOTSEC_MAX_CHS_SECTOR 63
+
+extern int DISK_Read(uint8_t drive, uint16_t cylinder, uint8_t sector,
+                     uint8_t head, uint8_t count, void *buffer);
+
+static uint8_t s_Sectors[BOOTSEC_CACHE_SLOTS][BOOTSEC_SECTOR_SIZE];
+static uint8_t s_Drive[BOOTSEC_CACHE_SLOTS];
+static uint32_t s_Lba[BOOTSEC_CACHE_SLOTS];
+static int s_Used[BOOTSEC_CACHE_SLOTS];
+static int s_Next = 0; /* round-robin victim */
+
+/* Return a cached copy of one early sector of a drive, reading it on
+   first use.  Only the CHS-reachable low sectors qualify (cylinder 0,
+   head 0); NULL on read failure or out-of-range LBA. */
+const uint8_t *BOOTSEC_ReadCached(uint8_t drive, uint32_t lba)
+{
+   if (lba >= BOOTSEC_MAX_CHS_SECTOR) return NULL;
+
+   for (int i = 0; i < BOOTSEC_CACHE_SLOTS; i++)
+   {
+      if (s_Used[i] && s_Drive[i] == drive && s_Lba[i] == lba)
+         return s_Sectors[i];
+   }
+
+   int slot = s_Next;
+   s_Next = (s_Next + 1) % BOOTSEC_CACHE_SLOTS;
+
+   if (DISK_Read(drive, 0, (uint8_t)(lba + 1), 0, 1, s_Sectors[slot]) != 0)
+   {
+      s_Used[slot] = 0;
+      return NULL;
+   }
+
+   s_Used[slot] = 1;
+   s_Drive[slot] = drive;
+   s_Lba[slot] = lba;
+   return s_Sectors[slot];
+}
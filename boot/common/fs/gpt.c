@@ -48,6 +48,7 @@ typedef struct
 
 extern int DISK_Read(uint8_t drive, uint16_t cylinder, uint8_t sector,
                      uint8_t head, uint8_t count, void *buffer);
+extern const uint8_t *BOOTSEC_ReadCached(uint8_t drive, uint32_t lba);
 
 static bool gpt_signature_valid(const uint8_t *sector)
 {
@@ -83,14 +84,9 @@ static bool gpt_lba_to_chs(uint64_t lba, uint16_t *cylinder, uint8_t *head,
 
 bool GPT_Probe(int driveId)
 {
-   uint8_t sector[GPT_SECTOR_SIZE];
-   uint16_t cylinder = 0;
-   uint8_t head = 0;
-   uint8_t sector_num = 0;
-
-   if (!gpt_lba_to_chs(1, &cylinder, &head, &sector_num)) return false;
-   if (DISK_Read((uint8_t)driveId, cylinder, sector_num, head, 1, sector) != 0)
-      return false;
+   /* Header at LBA 1; cached so GPT_List does not re-read it */
+   const uint8_t *sector = BOOTSEC_ReadCached((uint8_t)driveId, 1);
+   if (!sector) return false;
 
    return gpt_signature_valid(sector);
 }
@@ -99,20 +95,19 @@ int GPT_List(int driveId, int **offsets_out)
 {
    static int offsets[GPT_MAX_ENTRIES];
    static uint8_t entry_sectors[GPT_MAX_ENTRY_SECTORS * GPT_SECTOR_SIZE];
-   uint8_t header_sector[GPT_SECTOR_SIZE];
    uint16_t cylinder = 0;
    uint8_t head = 0;
    uint8_t sector_num = 0;
 
    if (!offsets_out) return -1;
-   if (!gpt_lba_to_chs(1, &cylinder, &head, &sector_num)) return -1;
-   if (DISK_Read((uint8_t)driveId, cylinder, sector_num, head, 1,
-                 header_sector) != 0)
-      return -1;
+
+   /* Header at LBA 1 (cache hit after GPT_Probe on the same drive) */
+   const uint8_t *header_sector = BOOTSEC_ReadCached((uint8_t)driveId, 1);
+   if (!header_sector) return -1;
 
    if (!gpt_signature_valid(header_sector)) return -1;
 
-   GPT_Header *header = (GPT_Header *)header_sector;
+   const GPT_Header *header = (const GPT_Header *)header_sector;
    if (header->size_of_partition_entry != GPT_ENTRY_SIZE) return -1;
 
    uint32_t entry_count = header->num_partition_entries;
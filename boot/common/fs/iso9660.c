@@ -9,6 +9,8 @@ struct FS_File;
 struct FS_Operations;
 
 static int iso_read_sector(uint64_t iso_lba, void *buffer);
+static const uint8_t *iso_read_dir_sector(uint64_t iso_lba);
+static void dir_cache_seed(uint64_t iso_lba, const uint8_t *data);
 static int parse_dir_record(const uint8_t *buf, int off, uint32_t *extent_lba,
                             uint32_t *extent_size, uint8_t *flags,
                             uint8_t *name_len);
@@ -44,6 +46,10 @@ static int resolve_path(const char *path, uint32_t *out_lba,
 
 #define MAX_OPEN_FILES 8
 
+/* Largest run one INT 13h extended read will accept; many BIOSes cap
+   the Disk Address Packet count at 127 sectors. */
+#define ISO_MAX_BATCH_SECTORS 127u
+
 struct FS_File
 {
    int used;
@@ -114,6 +120,61 @@ static int iso_read_sector(uint64_t iso_lba, void *buffer)
    return DISK_ReadLBA(drive, lba, count, buffer);
 }
 
+/* Cache of directory extent sectors (plus the volume descriptor).
+ *
+ * The bootloader opens several files that share parent directories;
+ * without this every ISO9660_Open re-read the same extents from disk.
+ * Small round-robin pool: after the first pass, path resolution is
+ * memory-only until the final file extent fetch. */
+#define DIR_CACHE_SECTORS 8
+
+static uint8_t s_DirCache[DIR_CACHE_SECTORS][SECTOR_SIZE_ISO];
+static uint64_t s_DirCacheLBA[DIR_CACHE_SECTORS];
+static int s_DirCacheUsed[DIR_CACHE_SECTORS];
+static int s_DirCacheNext = 0; /* round-robin victim */
+
+static void dir_cache_reset(void)
+{
+   for (int i = 0; i < DIR_CACHE_SECTORS; i++) s_DirCacheUsed[i] = 0;
+   s_DirCacheNext = 0;
+}
+
+/* Install an already-read sector into the cache, so data the partition
+   hunt fetched (the winning volume descriptor) is not read again. */
+static void dir_cache_seed(uint64_t iso_lba, const uint8_t *data)
+{
+   int slot = s_DirCacheNext;
+   s_DirCacheNext = (s_DirCacheNext + 1) % DIR_CACHE_SECTORS;
+
+   for (int i = 0; i < SECTOR_SIZE_ISO; i++) s_DirCache[slot][i] = data[i];
+   s_DirCacheUsed[slot] = 1;
+   s_DirCacheLBA[slot] = iso_lba;
+}
+
+/* Return a cached copy of the given ISO sector, reading it on first
+   use.  NULL on read failure. */
+static const uint8_t *iso_read_dir_sector(uint64_t iso_lba)
+{
+   for (int i = 0; i < DIR_CACHE_SECTORS; i++)
+   {
+      if (s_DirCacheUsed[i] && s_DirCacheLBA[i] == iso_lba)
+         return s_DirCache[i];
+   }
+
+   int slot = s_DirCacheNext;
+   s_DirCacheNext = (s_DirCacheNext + 1) % DIR_CACHE_SECTORS;
+
+   if (iso_read_sector(iso_lba, s_DirCache[slot]) != 0)
+   {
+      s_DirCacheUsed[slot] = 0;
+      return NULL;
+   }
+
+   s_DirCacheUsed[slot] = 1;
+   s_DirCacheLBA[slot] = iso_lba;
+   return s_DirCache[slot];
+}
+
 static int parse_dir_record(const uint8_t *buf, int off, uint32_t *extent_lba,
                             uint32_t *extent_size, uint8_t *flags,
                             uint8_t *name_len)
@@ -176,11 +237,16 @@ static int label_match(const uint8_t *isoLabel, const uint8_t *expected)
    return 1;
 }
 
+/* Volume descriptor read by the most recent successful check_partition;
+   ISO9660_Initialize seeds the directory cache from it so the winning
+   partition's PVD is not read a second time. */
+static uint8_t s_PvdBuf[SECTOR_SIZE_ISO];
+
 static int check_partition(uint8_t drive, int partLba,
                            const uint8_t *expectedLabel,
                            const uint8_t *expectedUuid)
 {
-   uint8_t buf[SECTOR_SIZE_ISO];
+   uint8_t *buf = s_PvdBuf;
    uint64_t pvd_lba = 0;
    uint16_t pvd_count = 0;
 
@@ -231,14 +297,14 @@ static int lookup_component(uint64_t dir_lba, uint32_t dir_size,
                             uint32_t *out_lba, uint32_t *out_size,
                             uint8_t *out_flags)
 {
-   uint8_t buf[SECTOR_SIZE_ISO];
    uint32_t bytes_read = 0;
 
    while (bytes_read < dir_size)
    {
       uint64_t sector_idx = bytes_read / SECTOR_SIZE_ISO;
 
-      if (iso_read_sector(dir_lba + sector_idx, buf) != 0) return -EIO;
+      const uint8_t *buf = iso_read_dir_sector(dir_lba + sector_idx);
+      if (!buf) return -EIO;
 
       int off = 0;
       while (off < SECTOR_SIZE_ISO)
@@ -321,10 +387,11 @@ int ISO9660_Initialize(const uint8_t *biosDriveList,
                        const uint8_t *partitionUuid,
                        const uint8_t *partitionLabel)
 {
-   uint8_t buf[SECTOR_SIZE_ISO];
-
    if (!biosDriveList || biosDriveListCount == 0) return -EINVAL;
 
+   /* Cached sectors are keyed relative to the selected partition. */
+   dir_cache_reset();
+
    {
       int found = 0;
       for (uint32_t i = 0; i < biosDriveListCount && !found; i++)
@@ -361,9 +428,14 @@ int ISO9660_Initialize(const uint8_t *biosDriveList,
          }
       }
       if (!found) return -ENODEV;
+
+      /* The winning check_partition left the PVD in s_PvdBuf; reuse it
+         instead of issuing the same read again. */
+      dir_cache_seed(PVD_LBA, s_PvdBuf);
    }
 
-   if (iso_read_sector(PVD_LBA, buf) != 0) return -EIO;
+   const uint8_t *buf = iso_read_dir_sector(PVD_LBA);
+   if (!buf) return -EIO;
    if (buf[0] != 1) return -EINVAL;
    if (!mem_eq(&buf[1], ISO_SIGNATURE, 5)) return -EINVAL;
 
@@ -435,10 +507,37 @@ int ISO9660_Read(int fd, void *buffer, int count)
       uint32_t file_off = f->position + bytes_done;
       uint64_t phys_sector = f->start_lba + file_off / phys_ss;
       uint32_t phys_off = file_off % phys_ss;
-      uint32_t chunk = phys_ss - phys_off;
+      uint32_t left = (uint32_t)count - bytes_done;
+
+      /* Sector-aligned body: read the whole remaining run in large
+         extended reads straight into the caller's buffer instead of
+         bouncing one sector at a time. */
+      if (phys_off == 0 && left >= phys_ss)
+      {
+         uint32_t run = left / phys_ss;
+         if (run > ISO_MAX_BATCH_SECTORS) run = ISO_MAX_BATCH_SECTORS;
 
-      if (chunk > (uint32_t)count - bytes_done)
-         chunk = (uint32_t)count - bytes_done;
+         /* Keep each transfer inside one 64 KiB window; some BIOSes
+            fail extended reads that cross it. */
+         uint32_t dest = (uint32_t)(uintptr_t)(buf + bytes_done);
+         uint32_t window = 0x10000u - (dest & 0xFFFFu);
+         if (run * phys_ss > window) run = window / phys_ss;
+
+         if (run > 0)
+         {
+            if (DISK_ReadLBA(drive, phys_sector, (uint16_t)run,
+                             buf + bytes_done) != 0)
+               return (bytes_done > 0) ? (int)bytes_done : EIO;
+
+            bytes_done += run * phys_ss;
+            continue;
+         }
+         /* Too close to the window edge for even one sector: fall
+            through to the bounced path below. */
+      }
+
+      uint32_t chunk = phys_ss - phys_off;
+      if (chunk > left) chunk = left;
 
       uint8_t tmp[SECTOR_SIZE_ISO];
       if (DISK_ReadLBA(drive, phys_sector, 1, tmp) != 0)
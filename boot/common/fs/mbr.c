@@ -20,13 +20,87 @@ typedef struct
 
 extern int DISK_Read(uint8_t drive, uint16_t cylinder, uint8_t sector,
                      uint8_t head, uint8_t count, void *buffer);
+extern const uint8_t *BOOTSEC_ReadCached(uint8_t drive, uint32_t lba);
 
-bool MBR_Probe(int driveId)
+/* -------------------------------------------------------------------------
+ * Kernel handoff: resolved partition map
+ *
+ * Every MBR this stage parses is also published at a fixed physical
+ * address so the kernel can mount root without re-reading the partition
+ * tables.  The wire format is shared with kernel/sys/system.h
+ * (BOOT_PartMap) - keep the two definitions in sync.
+ * ------------------------------------------------------------------------- */
+#define PARTMAP_ADDR 0x00000600u
+#define PARTMAP_MAGIC 0x544D5056u /* "VPMT" little-endian */
+#define PARTMAP_MAX 8
+
+typedef struct
 {
-   uint8_t sector[512];
+   uint8_t drive; /* BIOS drive number */
+   uint8_t type;  /* MBR partition type byte */
+   uint16_t reserved;
+   uint32_t lbaStart;
+   uint32_t sectorCount;
+} __attribute__((packed)) PartMapEntry;
+
+typedef struct
+{
+   uint32_t magic;
+   uint16_t count;
+   uint16_t checksum; /* 16-bit byte sum over entries[0..count) */
+   PartMapEntry entries[PARTMAP_MAX];
+} __attribute__((packed)) PartMap;
+
+static bool partmap_started = false;
+
+static void partmap_publish(int driveId, const uint8_t *sector)
+{
+   PartMap *map = (PartMap *)PARTMAP_ADDR;
+
+   if (!partmap_started)
+   {
+      map->magic = PARTMAP_MAGIC;
+      map->count = 0;
+      map->checksum = 0;
+      partmap_started = true;
+   }
+
+   /* A drive may be probed more than once; publish it only once. */
+   for (uint16_t i = 0; i < map->count; i++)
+   {
+      if (map->entries[i].drive == (uint8_t)driveId) return;
+   }
 
-   /* Read the first sector (CHS 0:0:1) - the MBR */
-   if (DISK_Read((uint8_t)driveId, 0, 1, 0, 1, sector) != 0) return false;
+   for (int i = 0; i < MBR_PARTITION_COUNT; i++)
+   {
+      const MBR_PartitionEntry *entry =
+          (const MBR_PartitionEntry *)&sector[446 + i * 16];
+
+      if (entry->type == 0) continue;
+      if (map->count >= PARTMAP_MAX) break;
+
+      PartMapEntry *out = &map->entries[map->count];
+      out->drive = (uint8_t)driveId;
+      out->type = entry->type;
+      out->reserved = 0;
+      out->lbaStart = entry->lba_start;
+      out->sectorCount = entry->sector_count;
+      map->count++;
+   }
+
+   uint16_t sum = 0;
+   const uint8_t *bytes = (const uint8_t *)map->entries;
+   for (uint32_t i = 0; i < map->count * sizeof(PartMapEntry); i++)
+      sum = (uint16_t)(sum + bytes[i]);
+   map->checksum = sum;
+}
+
+bool MBR_Probe(int driveId)
+{
+   /* Read the first sector (LBA 0) - the MBR; cached so MBR_List and
+    * the GPT probe on the same drive do not re-read it */
+   const uint8_t *sector = BOOTSEC_ReadCached((uint8_t)driveId, 0);
+   if (!sector) return false;
 
    /* Check for the 0xAA55 boot signature at offset 510 */
    uint16_t sig = (uint16_t)(sector[510] | ((uint16_t)sector[511] << 8));
@@ -35,21 +109,25 @@ bool MBR_Probe(int driveId)
 
 int MBR_List(int driveId, int **offset)
 {
-   uint8_t sector[512];
    static int offsets[MBR_PARTITION_COUNT];
    int count = 0;
 
-   /* Read the MBR */
-   if (DISK_Read((uint8_t)driveId, 0, 1, 0, 1, sector) != 0) return -1;
+   /* Read the MBR (cache hit after MBR_Probe on the same drive) */
+   const uint8_t *sector = BOOTSEC_ReadCached((uint8_t)driveId, 0);
+   if (!sector) return -1;
 
    /* Verify signature */
    uint16_t sig = (uint16_t)(sector[510] | ((uint16_t)sector[511] << 8));
    if (sig != MBR_SIGNATURE) return -1;
 
+   /* Hand the parsed table to the kernel while we have it in hand */
+   partmap_publish(driveId, sector);
+
    /* Parse the four primary partition entries starting at offset 446 */
    for (int i = 0; i < MBR_PARTITION_COUNT; i++)
    {
-      MBR_PartitionEntry *entry = (MBR_PartitionEntry *)&sector[446 + i * 16];
+      const MBR_PartitionEntry *entry =
+          (const MBR_PartitionEntry *)&sector[446 + i * 16];
 
       /* A partition entry with type 0 is unused */
       if (entry->type != 0)
@@ -17,5 +17,8 @@
 #define ECHILD 10
 #define EACCES 13
 #define ENOMEM 12
+#define ESRCH 3
+#define EAGAIN 11
+#define EFAULT 14
 
 #endif /* CONSTANTS_H */
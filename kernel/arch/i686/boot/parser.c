@@ -67,6 +67,33 @@ static void ZeroBytes(void *ptr, uint32_t len)
    for (uint32_t i = 0; i < len; i++) p[i] = 0;
 }
 
+/* -------------------------------------------------------------------------
+ * CapturePartMap
+ *
+ * Copies the stage-2 partition map from its fixed physical address into
+ * BOOT_Info, if one was published.  Validation is deliberately paranoid
+ * (magic, bounded count, byte checksum) because the address holds
+ * whatever was in conventional memory when a foreign loader booted us.
+ * On any mismatch the map count stays 0 and DISK_Scan parses the MBR.
+ * ------------------------------------------------------------------------- */
+static void CapturePartMap(void)
+{
+   const BOOT_PartMap *map = (const BOOT_PartMap *)BOOT_PARTMAP_ADDR;
+
+   if (map->magic != BOOT_PARTMAP_MAGIC) return;
+   if (map->count == 0 || map->count > BOOT_PARTMAP_MAX) return;
+
+   uint16_t sum = 0;
+   const uint8_t *bytes = (const uint8_t *)map->entries;
+   for (uint32_t i = 0; i < map->count * sizeof(BOOT_PartMapEntry); i++)
+      sum = (uint16_t)(sum + bytes[i]);
+   if (sum != map->checksum) return;
+
+   for (uint32_t i = 0; i < map->count; i++)
+      s_bootInfo.partMap[i] = map->entries[i];
+   s_bootInfo.partMapCount = map->count;
+}
+
 /* -------------------------------------------------------------------------
  * Parser_Multiboot
  *
@@ -132,6 +159,21 @@ void Parser_Multiboot(uint32_t magic, multiboot_info_t *mbi)
       s_bootInfo.memMapLength = mbi->mmap_length;
    }
 
+   /* --- Linear framebuffer (Multiboot flags bit 12) ----------------------
+    * Only direct-RGB modes (type 1) are captured; in EGA text mode
+    * (type 2) fbAddr stays 0 and the VGA text backend is used. */
+   if ((mbi->flags & (1u << 12)) && mbi->framebuffer_type == 1)
+   {
+      s_bootInfo.fbAddr = mbi->framebuffer_addr;
+      s_bootInfo.fbPitch = mbi->framebuffer_pitch;
+      s_bootInfo.fbWidth = mbi->framebuffer_width;
+      s_bootInfo.fbHeight = mbi->framebuffer_height;
+      s_bootInfo.fbBpp = mbi->framebuffer_bpp;
+   }
+
+   /* --- Stage-2 partition map (fixed-address handshake) ------------------ */
+   CapturePartMap();
+
    /* --- Hand off to the kernel ------------------------------------------ */
    start(&s_bootInfo);
 
@@ -34,6 +34,20 @@ typedef struct
    uint32_t drives_addr;      /* Physical address of drive info buffer */
    uint32_t config_table;     /* Physical address of ROM configuration table */
    uint32_t boot_loader_name; /* Physical address of bootloader name string */
+   uint32_t apm_table;        /* Physical address of APM table */
+   uint32_t vbe_control_info; /* VBE controller information block */
+   uint32_t vbe_mode_info;    /* VBE mode information block */
+   uint16_t vbe_mode;         /* Current VBE mode number */
+   uint16_t vbe_interface_seg;
+   uint16_t vbe_interface_off;
+   uint16_t vbe_interface_len;
+   uint64_t framebuffer_addr;   /* Physical linear framebuffer base */
+   uint32_t framebuffer_pitch;  /* Bytes per scanline */
+   uint32_t framebuffer_width;  /* Pixels (or columns for type 2) */
+   uint32_t framebuffer_height; /* Pixels (or rows for type 2) */
+   uint8_t framebuffer_bpp;     /* Bits per pixel */
+   uint8_t framebuffer_type;    /* 0 = indexed, 1 = direct RGB, 2 = text */
+   uint8_t color_info[6];       /* Palette / channel layout (unused) */
 } __attribute__((packed)) multiboot_info_t;
 
 /* -------------------------------------------------------------------------
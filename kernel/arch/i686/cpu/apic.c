@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "apic.h"
+#include "i8259.h"
+#include "isr.h"
+#include "smp.h"
+#include <arch/i686/mem/paging.h>
+#include <std/stdio.h>
+#include <stddef.h>
+
+#define CPU_FEATURE_APIC 0x00000200u // CPUID.1:EDX bit 9
+extern uint32_t get_cpu_features(void);
+
+/* Local APIC registers, as offsets from the MMIO base.  Every register
+ * is a 32-bit slot on a 16-byte stride. */
+#define LAPIC_REG_ID 0x020
+#define LAPIC_REG_TPR 0x080
+#define LAPIC_REG_EOI 0x0B0
+#define LAPIC_REG_SVR 0x0F0
+
+#define LAPIC_SVR_ENABLE 0x100u
+#define LAPIC_SPURIOUS_VECTOR 0xFFu
+
+/* I/O APIC: an index/data window pair.  Redirection entry n is the
+ * 64-bit value in registers 0x10+2n (low) and 0x11+2n (high). */
+#define IOAPIC_REG_SELECT 0x00
+#define IOAPIC_REG_DATA 0x10
+#define IOAPIC_REG_VERSION 0x01
+#define IOAPIC_REG_REDIR_BASE 0x10
+
+#define IOAPIC_REDIR_ACTIVE_LOW (1u << 13)
+#define IOAPIC_REDIR_LEVEL (1u << 15)
+#define IOAPIC_REDIR_MASKED (1u << 16)
+
+#define APIC_ISA_IRQS 16
+
+static volatile uint32_t *g_Lapic = NULL;
+static uint32_t g_IoApicBase = 0;
+static uint32_t g_IoApicPins = 0;
+static bool g_ApicActive = false;
+
+/* Where each ISA IRQ ended up in the redirection table (identity unless
+ * the MADT carries an interrupt source override, e.g. IRQ0 -> pin 2). */
+static uint32_t g_IsaPin[APIC_ISA_IRQS];
+
+static inline uint32_t lapic_read(uint32_t reg)
+{
+   return g_Lapic[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value)
+{
+   g_Lapic[reg / 4] = value;
+}
+
+static uint32_t ioapic_read(uint32_t reg)
+{
+   *(volatile uint32_t *)(g_IoApicBase + IOAPIC_REG_SELECT) = reg;
+   return *(volatile uint32_t *)(g_IoApicBase + IOAPIC_REG_DATA);
+}
+
+static void ioapic_write(uint32_t reg, uint32_t value)
+{
+   *(volatile uint32_t *)(g_IoApicBase + IOAPIC_REG_SELECT) = reg;
+   *(volatile uint32_t *)(g_IoApicBase + IOAPIC_REG_DATA) = value;
+}
+
+/* The spurious vector fires on transient INTR glitches; per spec it
+ * must not be acknowledged. */
+static void apic_spurious_isr(Registers *regs)
+{
+   (void)regs;
+}
+
+static int APIC_Probe(void)
+{
+   if (!(get_cpu_features() & CPU_FEATURE_APIC)) return -ENODEV;
+
+   /* SYS_Initialize normally ran the table scan already; Detect is
+    * parse-once so this is free when it did. */
+   i686_SMP_Detect();
+
+   uint32_t lapic_phys = i686_SMP_LapicPhys();
+   uint32_t ioapic_phys = i686_SMP_IoApicPhys();
+   if (!lapic_phys || !ioapic_phys) return -ENODEV;
+   if (i686_SMP_IoApicGsiBase() != 0) return -ENODEV;
+
+   /* Both register windows live above the identity window, so they get
+    * their own uncached pages in the shared kernel directory. */
+   if (i686_Paging_MapMmioPage(lapic_phys) != SUCCESS) return -ENODEV;
+   if (i686_Paging_MapMmioPage(ioapic_phys) != SUCCESS) return -ENODEV;
+
+   g_Lapic = (volatile uint32_t *)lapic_phys;
+   g_IoApicBase = ioapic_phys;
+
+   uint32_t version = ioapic_read(IOAPIC_REG_VERSION);
+   g_IoApicPins = ((version >> 16) & 0xFFu) + 1;
+   if (g_IoApicPins < APIC_ISA_IRQS) return -ENODEV;
+
+   return SUCCESS;
+}
+
+static void APIC_Initialize(uint8_t offsetPic1, uint8_t offsetPic2,
+                            bool autoEoi)
+{
+   (void)autoEoi; /* The LAPIC EOI register is the only mode */
+
+   /* Remap the 8259 away from the exception vectors before masking it,
+    * so a stray pulse during handoff cannot alias a CPU fault. */
+   const PICDriver *pic = i8259_GetDriver();
+   pic->Initialize(offsetPic1, offsetPic2, false);
+   pic->Disable();
+
+   i686_ISR_RegisterHandler(LAPIC_SPURIOUS_VECTOR, apic_spurious_isr);
+   lapic_write(LAPIC_REG_TPR, 0);
+   lapic_write(LAPIC_REG_SVR, LAPIC_SVR_ENABLE | LAPIC_SPURIOUS_VECTOR);
+
+   uint32_t dest = lapic_read(LAPIC_REG_ID) & (0xFFu << 24);
+
+   for (uint32_t irq = 0; irq < APIC_ISA_IRQS; irq++)
+   {
+      uint32_t gsi = irq;
+      uint16_t over_flags = 0;
+      uint32_t low = (uint32_t)offsetPic1 + irq; /* fixed, physical dest */
+
+      if (i686_SMP_IrqOverride((uint8_t)irq, &gsi, &over_flags))
+      {
+         /* MPS INTI flags: 11b = active low / level triggered. */
+         if ((over_flags & 0x3) == 0x3) low |= IOAPIC_REDIR_ACTIVE_LOW;
+         if (((over_flags >> 2) & 0x3) == 0x3) low |= IOAPIC_REDIR_LEVEL;
+      }
+
+      g_IsaPin[irq] = gsi;
+      if (gsi >= g_IoApicPins) continue;
+
+      ioapic_write(IOAPIC_REG_REDIR_BASE + 1 + 2 * gsi, dest);
+      ioapic_write(IOAPIC_REG_REDIR_BASE + 2 * gsi, low | IOAPIC_REDIR_MASKED);
+   }
+
+   g_ApicActive = true;
+   logfmt(LOG_INFO, "[APIC] routed: lapic=%x ioapic=%x pins=%u\n",
+          (uint32_t)(uintptr_t)g_Lapic, g_IoApicBase, g_IoApicPins);
+}
+
+static void APIC_Disable(void)
+{
+   for (uint32_t irq = 0; irq < APIC_ISA_IRQS; irq++)
+   {
+      uint32_t gsi = g_IsaPin[irq];
+      if (gsi >= g_IoApicPins) continue;
+      ioapic_write(IOAPIC_REG_REDIR_BASE + 2 * gsi,
+                   ioapic_read(IOAPIC_REG_REDIR_BASE + 2 * gsi) |
+                       IOAPIC_REDIR_MASKED);
+   }
+}
+
+static void APIC_SendEndOfInterrupt(int irq)
+{
+   (void)irq; /* One store, no matter which line; vs. 1-2 port writes */
+   lapic_write(LAPIC_REG_EOI, 0);
+}
+
+static void APIC_Mask(int irq)
+{
+   if (irq < 0 || irq >= APIC_ISA_IRQS) return;
+
+   uint32_t gsi = g_IsaPin[irq];
+   if (gsi >= g_IoApicPins) return;
+   ioapic_write(IOAPIC_REG_REDIR_BASE + 2 * gsi,
+                ioapic_read(IOAPIC_REG_REDIR_BASE + 2 * gsi) | IOAPIC_REDIR_MASKED);
+}
+
+static void APIC_Unmask(int irq)
+{
+   if (irq < 0 || irq >= APIC_ISA_IRQS) return;
+
+   uint32_t gsi = g_IsaPin[irq];
+   if (gsi >= g_IoApicPins) return;
+   ioapic_write(IOAPIC_REG_REDIR_BASE + 2 * gsi,
+                ioapic_read(IOAPIC_REG_REDIR_BASE + 2 * gsi) &
+                    ~IOAPIC_REDIR_MASKED);
+}
+
+static const PICDriver g_ApicDriver = {
+    .Name = "APIC",
+    .Probe = &APIC_Probe,
+    .Initialize = &APIC_Initialize,
+    .Disable = &APIC_Disable,
+    .SendEndOfInterrupt = &APIC_SendEndOfInterrupt,
+    .Mask = &APIC_Mask,
+    .Unmask = &APIC_Unmask,
+};
+
+const PICDriver *i686_APIC_GetDriver(void) { return &g_ApicDriver; }
+
+bool i686_APIC_Active(void) { return g_ApicActive; }
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef I686_APIC_H
+#define I686_APIC_H
+
+#include "pic.h"
+#include <stdbool.h>
+
+/* =========================================================================
+ * Local APIC + I/O APIC interrupt controller
+ *
+ * Replaces the dual 8259 where the firmware tables describe one: ISA
+ * IRQs are routed through the I/O APIC redirection table and every EOI
+ * becomes a single MMIO store instead of one or two port writes with
+ * their settle delays.  Probed before use; boards without the tables
+ * keep the 8259 driver.
+ * ====================================================================== */
+
+const PICDriver *i686_APIC_GetDriver(void);
+
+/* True once the APIC driver is the active interrupt controller. */
+bool i686_APIC_Active(void);
+
+#endif
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/* Lazy FPU/SSE context switching via CR0.TS.
+ *
+ * The context switch never touches x87/SSE registers; it only sets
+ * CR0.TS when the incoming process is not the current FPU owner.  The
+ * first FPU/SSE instruction the process (or the kernel's SSE memcpy
+ * on its behalf) then executes raises #NM, and the handler below
+ * moves ownership: fxsave the old owner's registers into its PCB
+ * buffer, fxrstor the new owner's, clear TS.  Processes that never
+ * touch the FPU - most of them - pay nothing on any tick.
+ *
+ * The owner is tracked by PID rather than by pointer: PIDs are never
+ * reused (g_NextPid only grows), so a Process_FindByPid miss cleanly
+ * detects that the owner exited and its state needs no save. */
+
+#include "fpu.h"
+#include "isr.h"
+#include <cpu/process.h>
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <sys/sys.h>
+
+#define CR0_TS 0x00000008u
+#define CPU_FEATURE_FXSR 0x01000000u // CPUID.1:EDX bit 24
+
+static bool g_FpuLazyEnabled = false;
+static uint32_t g_FpuOwnerPid = 0; /* 0: nobody owns the FPU */
+
+/* Pristine post-fninit image handed to first-time users. */
+static uint8_t g_FpuInitState[PROCESS_FPU_ALLOC_SIZE];
+
+static inline void fpu_set_ts(void)
+{
+   uint32_t cr0;
+   __asm__ __volatile__("mov %%cr0, %0" : "=r"(cr0));
+   cr0 |= CR0_TS;
+   __asm__ __volatile__("mov %0, %%cr0" ::"r"(cr0) : "memory");
+}
+
+static inline void fpu_clear_ts(void) { __asm__ __volatile__("clts"); }
+
+static inline void fpu_save(void *image)
+{
+   __asm__ __volatile__("fxsave (%0)" ::"r"(image) : "memory");
+}
+
+static inline void fpu_restore(const void *image)
+{
+   __asm__ __volatile__("fxrstor (%0)" ::"r"(image) : "memory");
+}
+
+/* #NM (device not available): the faulting instruction restarts after
+ * we hand the FPU over, so this is transparent to the toucher. */
+static void fpu_not_available(Registers *regs)
+{
+   (void)regs;
+
+   fpu_clear_ts();
+
+   Process *current = Process_GetCurrent();
+   if (current && current->pid == g_FpuOwnerPid)
+   {
+      return; /* Already ours; TS was set spuriously */
+   }
+
+   if (g_FpuOwnerPid != 0)
+   {
+      Process *owner = Process_FindByPid(g_FpuOwnerPid);
+      if (owner && owner->fpu_state)
+      {
+         fpu_save(Process_FpuImage(owner->fpu_state));
+      }
+      g_FpuOwnerPid = 0;
+   }
+
+   if (!current)
+   {
+      /* Kernel-context FPU use (SSE memcpy during bring-up) with no
+       * process to charge it to; leave the FPU unowned. */
+      return;
+   }
+
+   if (!current->fpu_state)
+   {
+      current->fpu_state = kmalloc(PROCESS_FPU_ALLOC_SIZE);
+      if (!current->fpu_state)
+      {
+         /* Degraded: the process runs on the pristine image but its
+          * state cannot be preserved across a switch. */
+         logfmt(LOG_WARNING, "[FPU] pid=%u state_alloc=nomem\n",
+                current->pid);
+         fpu_restore(Process_FpuImage(g_FpuInitState));
+         return;
+      }
+      fpu_restore(Process_FpuImage(g_FpuInitState));
+   }
+   else
+   {
+      fpu_restore(Process_FpuImage(current->fpu_state));
+   }
+
+   g_FpuOwnerPid = current->pid;
+}
+
+void i686_FPU_Initialize(void)
+{
+   /* fxsave/fxrstor carry the SSE state too; without them fall back
+    * to eager-free operation (TS stays clear, nothing is switched),
+    * matching the pre-lazy behaviour on ancient CPUs. */
+   if (!(get_cpu_features() & CPU_FEATURE_FXSR))
+   {
+      logfmt(LOG_WARNING, "[FPU] lazy=0 reason=no_fxsr\n");
+      return;
+   }
+
+   fpu_clear_ts();
+   __asm__ __volatile__("fninit");
+   fpu_save(Process_FpuImage(g_FpuInitState));
+
+   i686_ISR_RegisterHandler(7, fpu_not_available);
+
+   g_FpuLazyEnabled = true;
+   fpu_set_ts();
+   logfmt(LOG_INFO, "[FPU] lazy=1\n");
+}
+
+/* Arm the trap for the incoming process unless it already owns the
+ * FPU; this replaces any save/restore on the context switch path. */
+void i686_FPU_OnContextSwitch(Process *next)
+{
+   if (!g_FpuLazyEnabled) return;
+
+   if (next && next->pid == g_FpuOwnerPid)
+   {
+      fpu_clear_ts();
+   }
+   else
+   {
+      fpu_set_ts();
+   }
+}
+
+/* Force the owner's live registers out to its PCB buffer (fork needs
+ * the parent's buffer current before copying it to the child). */
+void i686_FPU_Flush(void)
+{
+   if (!g_FpuLazyEnabled || g_FpuOwnerPid == 0) return;
+
+   Process *owner = Process_FindByPid(g_FpuOwnerPid);
+   if (owner && owner->fpu_state)
+   {
+      fpu_clear_ts();
+      fpu_save(Process_FpuImage(owner->fpu_state));
+      /* Recompute TS: the owner keeps the registers, so only re-arm
+       * the trap if somebody else is running. */
+      i686_FPU_OnContextSwitch(Process_GetCurrent());
+   }
+}
+
+/* Drop ownership without saving (exec: the old program's FPU state
+ * must not leak into the new image). */
+void i686_FPU_Discard(void)
+{
+   if (!g_FpuLazyEnabled) return;
+
+   Process *current = Process_GetCurrent();
+   if (current && current->pid == g_FpuOwnerPid)
+   {
+      g_FpuOwnerPid = 0;
+      fpu_set_ts();
+   }
+}
@@ -0,0 +1,13 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef I686_FPU_H
+#define I686_FPU_H
+
+void i686_FPU_Initialize(void);
+void i686_FPU_Flush(void);
+void i686_FPU_Discard(void);
+
+struct Process;
+void i686_FPU_OnContextSwitch(struct Process *next);
+
+#endif
@@ -2,10 +2,20 @@
 
 #include "i8253.h"
 #include <arch/i686/io/io.h>
+#include <cpu/profile.h>
+#include <cpu/timer.h>
 #include <sys/sys.h>
 
 volatile uint64_t system_ticks = 0;
 
+/* Tickless idle state.  While g_TicklessSpan is non-zero channel 0 is
+ * running a mode 0 one-shot that stands in for that many periodic
+ * ticks; the handler (full expiry) or i686_i8253_ExitTickless (early
+ * wake-up by another interrupt) settles the accounting. */
+static uint32_t g_PeriodicFrequency = 0;
+static uint32_t g_TicklessSpan = 0;
+static uint32_t g_TicklessReload = 0;
+
 void i686_i8253_SetFrequency(uint32_t freq)
 {
    uint32_t reload = PIT_FREQ / freq;
@@ -22,11 +32,130 @@ void i686_i8253_SetFrequency(uint32_t freq)
 
 void i686_i8253_Initialize(uint32_t frequency)
 {
+   g_PeriodicFrequency = frequency;
    i686_i8253_SetFrequency(frequency);
 }
 
+void i686_i8253_EnterTickless(uint32_t ticks)
+{
+   if (!g_PeriodicFrequency) return;
+
+   /* One reload unit per periodic tick; the 16-bit counter caps the
+    * stretch at ~54 ms.  ticks == 0 means no deadline is armed - sleep
+    * the full span anyway so the clock keeps visible progress. */
+   uint32_t unit = PIT_FREQ / g_PeriodicFrequency;
+   uint32_t max_ticks = 0xFFFFu / unit;
+   if (ticks == 0 || ticks > max_ticks) ticks = max_ticks;
+   if (ticks <= 1) return; /* The periodic tick is already optimal */
+
+   uint32_t reload = ticks * unit;
+
+   i686_outb(PIT_COMMAND, PIT_CH0 | PIT_LSB_MSB | PIT_MODE0 | PIT_BINARY);
+   i686_outb(PIT_CH0_DATA, reload & 0xFF);
+   i686_outb(PIT_CH0_DATA, (reload >> 8) & 0xFF);
+
+   g_TicklessReload = reload;
+   g_TicklessSpan = ticks;
+}
+
+void i686_i8253_ExitTickless(void)
+{
+   if (!g_TicklessSpan) return; /* Already settled by the handler */
+
+   /* Woken early by some other interrupt: latch the count that is
+    * still outstanding and credit only the ticks that really passed. */
+   i686_outb(PIT_COMMAND, PIT_CH0 | PIT_LATCH);
+   uint32_t remaining = i686_inb(PIT_CH0_DATA);
+   remaining |= (uint32_t)i686_inb(PIT_CH0_DATA) << 8;
+
+   uint32_t unit = PIT_FREQ / g_PeriodicFrequency;
+   uint32_t elapsed = 0;
+   if (remaining < g_TicklessReload)
+   {
+      elapsed = (g_TicklessReload - remaining) / unit;
+   }
+   if (elapsed > g_TicklessSpan) elapsed = g_TicklessSpan;
+
+   g_TicklessSpan = 0;
+   i686_i8253_SetFrequency(g_PeriodicFrequency);
+
+   while (elapsed--)
+   {
+      system_ticks++;
+      Timer_Tick();
+   }
+}
+
+/* The kernel only targets i686, so rdtsc is used directly rather than
+ * going through the HAL. */
+static inline uint64_t i8253_rdtsc(void)
+{
+   uint32_t lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * i686_i8253_CalibrateTsc – measure the TSC frequency against the PIT.
+ *
+ * PIT channel 2 (the speaker channel, gated through port 0x61) counts
+ * down a known 10 ms interval in one-shot mode while the TSC runs.
+ * Channel 2 is used so channel 0, the scheduler tick, is untouched.
+ * Elapsed cycles over 10 ms divided by 10 is cycles per ms, i.e. kHz.
+ *
+ * Returns the TSC frequency in kHz, or 0 if OUT2 never fired (no gate
+ * on exotic hardware) - callers then fall back to tick resolution.
+ */
+uint32_t i686_i8253_CalibrateTsc(void)
+{
+   const uint32_t calibrate_ms = 10;
+   uint16_t reload = (uint16_t)(PIT_FREQ * calibrate_ms / 1000);
+
+   /* Enable the channel 2 gate (bit 0), keep the speaker muted (bit 1) */
+   uint8_t gate = i686_inb(0x61);
+   i686_outb(0x61, (uint8_t)((gate & ~0x02) | 0x01));
+
+   i686_outb(PIT_COMMAND, PIT_CH2 | PIT_LSB_MSB | PIT_MODE0 | PIT_BINARY);
+   i686_outb(PIT_CH2_DATA, reload & 0xFF);
+   i686_outb(PIT_CH2_DATA, (reload >> 8) & 0xFF);
+
+   uint64_t start = i8253_rdtsc();
+
+   /* OUT2 (port 0x61 bit 5) goes high on terminal count.  Bound the
+    * poll so a missing gate cannot hang boot. */
+   uint32_t guard = 100000000u;
+   while (!(i686_inb(0x61) & 0x20) && --guard);
+
+   uint64_t end = i8253_rdtsc();
+
+   /* Restore the gate/speaker bits we touched */
+   i686_outb(0x61, (uint8_t)(gate & ~0x03));
+
+   if (guard == 0) return 0;
+
+   /* 10 ms of cycles fits 32 bits for any clock below 429 GHz */
+   return (uint32_t)(end - start) / calibrate_ms;
+}
+
 void i686_i8253_TimerHandler(Registers *regs)
 {
-   (void)regs;
-   system_ticks++;
+   /* One sample per interrupt, not per accounted tick: the EIP only
+    * describes the context this IRQ actually cut into. */
+   Profile_Sample(regs->eip);
+
+   uint32_t ticks = 1;
+   if (g_TicklessSpan)
+   {
+      /* The stretched one-shot ran to terminal count: account every
+       * tick it stood in for, then resume the periodic rate. */
+      ticks = g_TicklessSpan;
+      g_TicklessSpan = 0;
+      i686_i8253_SetFrequency(g_PeriodicFrequency);
+   }
+
+   while (ticks--)
+   {
+      system_ticks++;
+      Timer_Tick();
+   }
 }
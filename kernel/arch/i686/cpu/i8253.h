@@ -44,4 +44,16 @@ void i686_i8253_Initialize(uint32_t frequency);
 void i686_i8253_SetFrequency(uint32_t freq);
 void i686_i8253_TimerHandler(Registers *regs);
 
+/* Measure the TSC frequency against PIT channel 2.  Returns kHz, or 0
+ * when calibration failed; feed the result to Timer_SetTscFrequency. */
+uint32_t i686_i8253_CalibrateTsc(void);
+
+/* Tickless idle: stretch channel 0 into a one-shot standing in for
+ * `ticks` periodic ticks (clamped to the 16-bit counter, ~54 ms; 0 =
+ * as long as possible).  ExitTickless settles the clock after an early
+ * wake-up and restores the periodic rate; both run with interrupts
+ * disabled. */
+void i686_i8253_EnterTickless(uint32_t ticks);
+void i686_i8253_ExitTickless(void);
+
 #endif
@@ -1,13 +1,17 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "irq.h"
+#include "apic.h"
 #include "i8259.h"
 #include "pic.h"
 #include <arch/i686/io/io.h>
+#include <cpu/softirq.h>
 #include <drivers/keyboard/keyboard.h>
 #include <std/arrays.h>
 #include <std/stdio.h>
+#include <std/string.h>
 #include <stddef.h>
+#include <sys/cmdline.h>
 #include <sys/sys.h>
 
 #define PIC_REMAP_OFFSET 0x20
@@ -15,6 +19,94 @@
 IRQHandler g_IRQHandlers[16];
 static const PICDriver *g_Driver = NULL;
 
+/* -------------------------------------------------------------------------
+ * Per-vector latency instrumentation
+ *
+ * Every dispatch is timed with rdtsc and folded into count/total/max
+ * plus a power-of-two histogram; /dev/irqstat renders the table.  A
+ * handler that runs past the irq_warn boot flag's cycle threshold is
+ * logged, since a long handler delays the timer behind it.
+ * ---------------------------------------------------------------------- */
+
+#define IRQ_HIST_BUCKETS 16
+
+typedef struct
+{
+   uint64_t count;
+   uint64_t cycles;
+   uint32_t max_cycles;
+   uint32_t hist[IRQ_HIST_BUCKETS]; /* bucket n counts [2^n, 2^(n+1)) */
+} IrqStatEntry;
+
+static IrqStatEntry g_IrqStats[16];
+static uint32_t g_IrqWarnCycles = 0; /* 0 = warnings off */
+
+/* The kernel only targets i686, so rdtsc is used directly. */
+static inline uint64_t irq_rdtsc(void)
+{
+   uint32_t lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((uint64_t)hi << 32) | lo;
+}
+
+static inline uint32_t irq_hist_bucket(uint32_t cycles)
+{
+   if (cycles == 0) return 0;
+   uint32_t b = 31u - (uint32_t)__builtin_clz(cycles);
+   return (b < IRQ_HIST_BUCKETS) ? b : IRQ_HIST_BUCKETS - 1;
+}
+
+void i686_IRQ_StatsInitialize(void)
+{
+   g_IrqWarnCycles = CmdLine_GetU32(CMDLINE_OPT_IRQ_WARN, 0);
+   if (g_IrqWarnCycles)
+   {
+      logfmt(LOG_INFO, "[IRQ] slow-handler warning at %u cycles\n",
+             g_IrqWarnCycles);
+   }
+}
+
+uint32_t i686_IRQ_StatsRead(uint32_t offset, uint32_t size, void *buffer)
+{
+   static char text[4096];
+   uint32_t len = 0;
+
+   for (int irq = 0; irq < 16; irq++)
+   {
+      const IrqStatEntry *e = &g_IrqStats[irq];
+      if (e->count == 0) continue;
+
+      int n = snprintf(text + len, sizeof(text) - len,
+                       "irq=%d count=%llu cycles=%llu max=%u hist=", irq,
+                       e->count, e->cycles, e->max_cycles);
+      if (n < 0) break;
+      len += (uint32_t)n;
+
+      for (uint32_t b = 0; b < IRQ_HIST_BUCKETS && len < sizeof(text); b++)
+      {
+         n = snprintf(text + len, sizeof(text) - len, "%s%u",
+                      b ? "," : "", e->hist[b]);
+         if (n < 0) break;
+         len += (uint32_t)n;
+      }
+
+      if (len < sizeof(text)) text[len++] = '\n';
+      if (len >= sizeof(text))
+      {
+         len = sizeof(text) - 1;
+         break;
+      }
+   }
+
+   if (offset >= len) return 0;
+
+   uint32_t avail = len - offset;
+   if (avail > size) avail = size;
+   memcpy((uint8_t *)buffer, text + offset, avail);
+
+   return avail;
+}
+
 void i686_IRQ_Handler(Registers *regs)
 {
    int irq = regs->interrupt - PIC_REMAP_OFFSET;
@@ -29,8 +121,26 @@ void i686_IRQ_Handler(Registers *regs)
 
    if (g_IRQHandlers[irq] != NULL)
    {
+      uint64_t start = irq_rdtsc();
+
       // handle IRQ
       g_IRQHandlers[irq](regs);
+
+      uint64_t delta64 = irq_rdtsc() - start;
+      uint32_t delta =
+          (delta64 > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)delta64;
+
+      IrqStatEntry *st = &g_IrqStats[irq];
+      st->count++;
+      st->cycles += delta;
+      if (delta > st->max_cycles) st->max_cycles = delta;
+      st->hist[irq_hist_bucket(delta)]++;
+
+      if (g_IrqWarnCycles && delta >= g_IrqWarnCycles)
+      {
+         logfmt(LOG_WARNING, "[IRQ] slow handler: irq=%d cycles=%u max=%u\n",
+                irq, delta, st->max_cycles);
+      }
    }
    else
    {
@@ -39,13 +149,27 @@ void i686_IRQ_Handler(Registers *regs)
 
    // send EOI
    g_Driver->SendEndOfInterrupt(irq);
+
+   /* Bottom halves: on the way back to user mode, run the work the
+    * handlers deferred - with interrupts enabled, so further IRQs are
+    * not held off behind it.  Kernel-mode returns leave the queue for
+    * the idle loop (or the next user return) to keep nesting shallow. */
+   if ((regs->cs & 0x3) == 0x3)
+   {
+      i686_EnableInterrupts();
+      Softirq_Drain();
+      i686_DisableInterrupts();
+   }
 }
 
 void i686_IRQ_Initialize()
 {
    logfmt(LOG_INFO, "[IRQ] initialized\n");
+   /* Later entries take precedence: the APIC replaces the 8259 when
+    * the firmware tables describe one. */
    const PICDriver *drivers[] = {
        i8259_GetDriver(),
+       i686_APIC_GetDriver(),
    };
 
    for (size_t i = 0; i < SIZE(drivers); i++)
@@ -77,8 +201,8 @@ void i686_IRQ_Initialize()
 
    /* Populate IRQ info in SYS_Info */
    g_SysInfo->irq.irq_count = 16;
-   g_SysInfo->irq.pic_type = 1;      /* 8259 PIC */
-   g_SysInfo->irq.timer_freq = 1000; /* 1000 Hz timer */
+   g_SysInfo->irq.pic_type = i686_APIC_Active() ? 2 : 1; /* 2 = APIC */
+   g_SysInfo->irq.timer_freq = 1000;                     /* 1000 Hz timer */
 }
 
 void i686_IRQ_RegisterHandler(int irq, IRQHandler handler)
@@ -20,4 +20,11 @@ void i686_IRQ_Initialize();
 void i686_IRQ_RegisterHandler(int irq, IRQHandler handler);
 void i686_IRQ_Unmask(int irq);
 
+/* Reads the irq_warn boot flag (handler cycle threshold for slow-IRQ
+ * warnings); call after CmdLine_Initialize. */
+void i686_IRQ_StatsInitialize(void);
+
+/* Render the per-vector dispatch statistics for /dev/irqstat. */
+uint32_t i686_IRQ_StatsRead(uint32_t offset, uint32_t size, void *buffer);
+
 #endif
\ No newline at end of file
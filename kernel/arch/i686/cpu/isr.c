@@ -4,6 +4,7 @@
 #include "gdt.h"
 #include "idt.h"
 #include <arch/i686/io/io.h>
+#include <std/compiler.h>
 #include <std/stdio.h>
 #include <stddef.h>
 
@@ -45,7 +46,35 @@ static const char *const g_Exceptions[] = {"Divide by zero error",
 
 void i686_ISR_InitializeGates();
 
-void i686_ISR_Initialize()
+/* Fatal-exception report, pulled out of the dispatch path so the
+ * register dump and panic never share icache lines with it. */
+static KCOLD void isr_unhandled_exception(Registers *regs)
+{
+   printf("Unhandled exception %d %s\n", regs->interrupt,
+          g_Exceptions[regs->interrupt]);
+
+   printf("  eax=%x  ebx=%x  ecx=%x  edx=%x  esi=%x  edi=%x\n", regs->eax,
+          regs->ebx, regs->ecx, regs->edx, regs->esi, regs->edi);
+
+   printf("  esp=%x  ebp=%x  eip=%x  eflags=%x  cs=%x  ds=%x  ss=%x\n",
+          regs->esp, regs->ebp, regs->eip, regs->eflags, regs->cs, regs->ds,
+          regs->ss);
+
+   printf("  interrupt=%x  errorcode=%x\n", regs->interrupt, regs->error);
+
+   // For page faults (exception 14), read CR2 to get the faulting address
+   if (regs->interrupt == 14)
+   {
+      uint32_t fault_addr;
+      __asm__ __volatile__("mov %%cr2, %0" : "=r"(fault_addr));
+      printf("  fault_address=%x\n", fault_addr);
+   }
+
+   logfmt(LOG_FATAL, "KERNEL PANIC!\n");
+   i686_Panic();
+}
+
+KCOLD void i686_ISR_Initialize()
 {
    i686_ISR_InitializeGates();
    i686_IDT_SetGate(0x80, i686_ISR128, i686_GDT_CODE_SEGMENT,
@@ -63,30 +92,7 @@ void __attribute__((cdecl)) i686_ISR_Handler(Registers *regs)
       logfmt(LOG_WARNING, "[ISR] Unhandled interrupt %d!\n", regs->interrupt);
 
    else
-   {
-      printf("Unhandled exception %d %s\n", regs->interrupt,
-             g_Exceptions[regs->interrupt]);
-
-      printf("  eax=%x  ebx=%x  ecx=%x  edx=%x  esi=%x  edi=%x\n", regs->eax,
-             regs->ebx, regs->ecx, regs->edx, regs->esi, regs->edi);
-
-      printf("  esp=%x  ebp=%x  eip=%x  eflags=%x  cs=%x  ds=%x  ss=%x\n",
-             regs->esp, regs->ebp, regs->eip, regs->eflags, regs->cs, regs->ds,
-             regs->ss);
-
-      printf("  interrupt=%x  errorcode=%x\n", regs->interrupt, regs->error);
-
-      // For page faults (exception 14), read CR2 to get the faulting address
-      if (regs->interrupt == 14)
-      {
-         uint32_t fault_addr;
-         __asm__ __volatile__("mov %%cr2, %0" : "=r"(fault_addr));
-         printf("  fault_address=%x\n", fault_addr);
-      }
-
-      logfmt(LOG_FATAL, "KERNEL PANIC!\n");
-      i686_Panic();
-   }
+      isr_unhandled_exception(regs);
 }
 
 void i686_ISR_RegisterHandler(int interrupt, ISRHandler handler)
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "scheduler.h"
+#include "fpu.h"
 #include "gdt.h"
 #include <cpu/process.h>
 #include <cpu/scheduler.h>
@@ -61,6 +62,10 @@ Registers *i686_Scheduler_ContextSwitch_Impl(void)
             g_HalIoOperations->DisableInterrupts();
          }
 
+         /* Lazy FPU: arm CR0.TS instead of saving/restoring x87/SSE
+          * state; the #NM handler switches it on first use. */
+         i686_FPU_OnContextSwitch(next);
+
          if (!next->saved_regs)
          {
             return build_initial_frame(next);
@@ -0,0 +1,357 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "smp.h"
+#include <std/stdio.h>
+#include <std/string.h>
+
+/* Both tables live in the low identity-mapped window, so they can be
+ * read through plain pointers. */
+
+/* ---- Intel MP specification structures ------------------------------- */
+
+typedef struct
+{
+   uint32_t signature; /* "_MP_" */
+   uint32_t config_phys;
+   uint8_t length;
+   uint8_t spec_rev;
+   uint8_t checksum;
+   uint8_t features[5];
+} __attribute__((packed)) MpFloatingPointer;
+
+typedef struct
+{
+   uint32_t signature; /* "PCMP" */
+   uint16_t base_length;
+   uint8_t spec_rev;
+   uint8_t checksum;
+   char oem_id[8];
+   char product_id[12];
+   uint32_t oem_table_phys;
+   uint16_t oem_table_size;
+   uint16_t entry_count;
+   uint32_t lapic_phys;
+   uint16_t ext_length;
+   uint8_t ext_checksum;
+   uint8_t reserved;
+} __attribute__((packed)) MpConfigHeader;
+
+typedef struct
+{
+   uint8_t type; /* 0 = processor */
+   uint8_t lapic_id;
+   uint8_t lapic_version;
+   uint8_t cpu_flags; /* bit0 usable, bit1 BSP */
+   uint32_t signature;
+   uint32_t features;
+   uint8_t reserved[8];
+} __attribute__((packed)) MpProcessorEntry;
+
+#define MP_SIG_FPS 0x5F504D5Fu  /* "_MP_" */
+#define MP_SIG_PCMP 0x504D4350u /* "PCMP" */
+
+/* ---- ACPI structures -------------------------------------------------- */
+
+typedef struct
+{
+   char signature[8]; /* "RSD PTR " */
+   uint8_t checksum;
+   char oem_id[6];
+   uint8_t revision;
+   uint32_t rsdt_phys;
+} __attribute__((packed)) AcpiRsdp;
+
+typedef struct
+{
+   char signature[4];
+   uint32_t length;
+   uint8_t revision;
+   uint8_t checksum;
+   char oem_id[6];
+   char oem_table_id[8];
+   uint32_t oem_revision;
+   uint32_t creator_id;
+   uint32_t creator_revision;
+} __attribute__((packed)) AcpiSdtHeader;
+
+typedef struct
+{
+   uint8_t type; /* 0 = processor local APIC */
+   uint8_t length;
+   uint8_t acpi_processor_id;
+   uint8_t apic_id;
+   uint32_t flags; /* bit0 enabled */
+} __attribute__((packed)) AcpiMadtLapic;
+
+typedef struct
+{
+   uint8_t type; /* 1 = I/O APIC */
+   uint8_t length;
+   uint8_t ioapic_id;
+   uint8_t reserved;
+   uint32_t ioapic_phys;
+   uint32_t gsi_base;
+} __attribute__((packed)) AcpiMadtIoApic;
+
+typedef struct
+{
+   uint8_t type; /* 2 = interrupt source override */
+   uint8_t length;
+   uint8_t bus; /* always 0 (ISA) */
+   uint8_t source;
+   uint32_t gsi;
+   uint16_t flags; /* bits 0-1 polarity, bits 2-3 trigger mode */
+} __attribute__((packed)) AcpiMadtOverride;
+
+/* ---- Detection -------------------------------------------------------- */
+
+static SMP_Cpu g_SmpCpus[SMP_MAX_CPUS];
+static uint32_t g_SmpCpuCount = 0;
+static bool g_SmpScanned = false;
+
+/* Interrupt routing pieces for the APIC driver. */
+static uint32_t g_LapicPhys = 0;
+static uint32_t g_IoApicPhys = 0;
+static uint32_t g_IoApicGsiBase = 0;
+
+#define SMP_MAX_IRQ_OVERRIDES 16
+
+typedef struct
+{
+   uint8_t source; /* ISA IRQ */
+   uint32_t gsi;
+   uint16_t flags;
+} IrqOverride;
+
+static IrqOverride g_IrqOverrides[SMP_MAX_IRQ_OVERRIDES];
+static uint32_t g_IrqOverrideCount = 0;
+
+/* No memcmp in the freestanding string set; signatures are short. */
+static bool bytes_equal(const void *a, const char *b, uint32_t length)
+{
+   const uint8_t *pa = (const uint8_t *)a;
+   for (uint32_t i = 0; i < length; i++)
+   {
+      if (pa[i] != (uint8_t)b[i]) return false;
+   }
+   return true;
+}
+
+static uint8_t checksum_bytes(const void *base, uint32_t length)
+{
+   const uint8_t *p = (const uint8_t *)base;
+   uint8_t sum = 0;
+   while (length--) sum = (uint8_t)(sum + *p++);
+   return sum;
+}
+
+static void smp_record_cpu(uint8_t lapic_id, bool bsp)
+{
+   for (uint32_t i = 0; i < g_SmpCpuCount; i++)
+   {
+      if (g_SmpCpus[i].lapic_id == lapic_id) return; /* Both tables agree */
+   }
+   if (g_SmpCpuCount >= SMP_MAX_CPUS)
+   {
+      logfmt(LOG_WARNING, "[SMP] more than %u cpus, ignoring extras\n",
+             SMP_MAX_CPUS);
+      return;
+   }
+
+   g_SmpCpus[g_SmpCpuCount].lapic_id = lapic_id;
+   g_SmpCpus[g_SmpCpuCount].bsp = bsp;
+   g_SmpCpuCount++;
+}
+
+static const MpFloatingPointer *mp_scan_range(uint32_t start, uint32_t end)
+{
+   for (uint32_t addr = start; addr + sizeof(MpFloatingPointer) <= end;
+        addr += 16)
+   {
+      const MpFloatingPointer *fps = (const MpFloatingPointer *)addr;
+      if (fps->signature != MP_SIG_FPS) continue;
+      if (checksum_bytes(fps, (uint32_t)fps->length * 16) != 0) continue;
+      return fps;
+   }
+   return NULL;
+}
+
+static void mp_parse(void)
+{
+   /* Spec-mandated search order: first KB of the EBDA, last KB of base
+    * memory, then the BIOS ROM. */
+   uint32_t ebda = (uint32_t)(*(const uint16_t *)0x40E) << 4;
+
+   const MpFloatingPointer *fps = NULL;
+   if (ebda) fps = mp_scan_range(ebda, ebda + 1024);
+   if (!fps) fps = mp_scan_range(0x9FC00, 0xA0000);
+   if (!fps) fps = mp_scan_range(0xF0000, 0x100000);
+   if (!fps || !fps->config_phys) return;
+
+   const MpConfigHeader *cfg = (const MpConfigHeader *)fps->config_phys;
+   if (cfg->signature != MP_SIG_PCMP) return;
+   if (checksum_bytes(cfg, cfg->base_length) != 0) return;
+
+   if (!g_LapicPhys) g_LapicPhys = cfg->lapic_phys;
+
+   const uint8_t *entry = (const uint8_t *)(cfg + 1);
+   for (uint16_t i = 0; i < cfg->entry_count; i++)
+   {
+      if (*entry == 0) /* Processor: 20 bytes, everything else is 8 */
+      {
+         const MpProcessorEntry *p = (const MpProcessorEntry *)entry;
+         if (p->cpu_flags & 0x1)
+         {
+            smp_record_cpu(p->lapic_id, (p->cpu_flags & 0x2) != 0);
+         }
+         entry += sizeof(MpProcessorEntry);
+      }
+      else
+      {
+         entry += 8;
+      }
+   }
+}
+
+static const AcpiRsdp *acpi_scan_range(uint32_t start, uint32_t end)
+{
+   for (uint32_t addr = start; addr + sizeof(AcpiRsdp) <= end; addr += 16)
+   {
+      const AcpiRsdp *rsdp = (const AcpiRsdp *)addr;
+      if (!bytes_equal(rsdp->signature, "RSD PTR ", 8)) continue;
+      if (checksum_bytes(rsdp, sizeof(AcpiRsdp)) != 0) continue;
+      return rsdp;
+   }
+   return NULL;
+}
+
+static void acpi_parse_madt(const AcpiSdtHeader *madt)
+{
+   /* The MADT body starts after the header plus the local APIC address
+    * and flags words. */
+   const uint8_t *body = (const uint8_t *)madt + sizeof(AcpiSdtHeader);
+   const uint8_t *entry = body + 8;
+   const uint8_t *end = (const uint8_t *)madt + madt->length;
+
+   g_LapicPhys = *(const uint32_t *)body;
+
+   while (entry + 2 <= end && entry[1] >= 2 && entry + entry[1] <= end)
+   {
+      if (entry[0] == 0 && entry[1] >= sizeof(AcpiMadtLapic))
+      {
+         const AcpiMadtLapic *lapic = (const AcpiMadtLapic *)entry;
+         if (lapic->flags & 0x1)
+         {
+            /* ACPI does not mark the BSP; the first CPU listed is the
+             * one firmware booted. */
+            smp_record_cpu(lapic->apic_id, g_SmpCpuCount == 0);
+         }
+      }
+      else if (entry[0] == 1 && entry[1] >= sizeof(AcpiMadtIoApic))
+      {
+         /* Only the I/O APIC serving the ISA range (gsi base 0) is
+          * routed; a second chip would need more redirection setup. */
+         const AcpiMadtIoApic *ioapic = (const AcpiMadtIoApic *)entry;
+         if (!g_IoApicPhys || ioapic->gsi_base == 0)
+         {
+            g_IoApicPhys = ioapic->ioapic_phys;
+            g_IoApicGsiBase = ioapic->gsi_base;
+         }
+      }
+      else if (entry[0] == 2 && entry[1] >= sizeof(AcpiMadtOverride))
+      {
+         const AcpiMadtOverride *ovr = (const AcpiMadtOverride *)entry;
+         if (g_IrqOverrideCount < SMP_MAX_IRQ_OVERRIDES)
+         {
+            g_IrqOverrides[g_IrqOverrideCount].source = ovr->source;
+            g_IrqOverrides[g_IrqOverrideCount].gsi = ovr->gsi;
+            g_IrqOverrides[g_IrqOverrideCount].flags = ovr->flags;
+            g_IrqOverrideCount++;
+         }
+      }
+      entry += entry[1];
+   }
+}
+
+static void acpi_parse(void)
+{
+   uint32_t ebda = (uint32_t)(*(const uint16_t *)0x40E) << 4;
+
+   const AcpiRsdp *rsdp = NULL;
+   if (ebda) rsdp = acpi_scan_range(ebda, ebda + 1024);
+   if (!rsdp) rsdp = acpi_scan_range(0xE0000, 0x100000);
+   if (!rsdp || !rsdp->rsdt_phys) return;
+
+   const AcpiSdtHeader *rsdt = (const AcpiSdtHeader *)rsdp->rsdt_phys;
+   if (!bytes_equal(rsdt->signature, "RSDT", 4)) return;
+   if (checksum_bytes(rsdt, rsdt->length) != 0) return;
+
+   uint32_t entries = (rsdt->length - sizeof(AcpiSdtHeader)) / 4;
+   const uint32_t *tables = (const uint32_t *)(rsdt + 1);
+
+   for (uint32_t i = 0; i < entries; i++)
+   {
+      const AcpiSdtHeader *sdt = (const AcpiSdtHeader *)tables[i];
+      if (!sdt) continue;
+      if (!bytes_equal(sdt->signature, "APIC", 4)) continue;
+      if (checksum_bytes(sdt, sdt->length) != 0) continue;
+
+      acpi_parse_madt(sdt);
+      return;
+   }
+}
+
+uint32_t i686_SMP_Detect(void)
+{
+   /* Parse once; the APIC driver re-calls this from its probe in case
+    * it ever runs before SYS_Initialize. */
+   if (g_SmpScanned) return g_SmpCpuCount;
+   g_SmpScanned = true;
+
+   g_SmpCpuCount = 0;
+
+   /* The MADT is authoritative on anything modern; the MP table covers
+    * pre-ACPI boards.  Duplicate lapic ids are folded. */
+   acpi_parse();
+   mp_parse();
+
+   for (uint32_t i = 0; i < g_SmpCpuCount; i++)
+   {
+      logfmt(LOG_INFO, "[SMP] cpu%u: lapic_id=%u%s\n", i,
+             g_SmpCpus[i].lapic_id, g_SmpCpus[i].bsp ? " (bsp)" : "");
+   }
+
+   if (g_SmpCpuCount == 0)
+   {
+      logfmt(LOG_INFO, "[SMP] no MP/ACPI cpu tables, assuming 1 cpu\n");
+   }
+
+   return g_SmpCpuCount;
+}
+
+uint32_t i686_SMP_CpuCount(void) { return g_SmpCpuCount; }
+
+const SMP_Cpu *i686_SMP_Cpu(uint32_t index)
+{
+   if (index >= g_SmpCpuCount) return NULL;
+   return &g_SmpCpus[index];
+}
+
+uint32_t i686_SMP_LapicPhys(void) { return g_LapicPhys; }
+
+uint32_t i686_SMP_IoApicPhys(void) { return g_IoApicPhys; }
+
+uint32_t i686_SMP_IoApicGsiBase(void) { return g_IoApicGsiBase; }
+
+bool i686_SMP_IrqOverride(uint8_t isa_irq, uint32_t *gsi, uint16_t *flags)
+{
+   for (uint32_t i = 0; i < g_IrqOverrideCount; i++)
+   {
+      if (g_IrqOverrides[i].source != isa_irq) continue;
+
+      *gsi = g_IrqOverrides[i].gsi;
+      *flags = g_IrqOverrides[i].flags;
+      return true;
+   }
+   return false;
+}
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef I686_SMP_H
+#define I686_SMP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* =========================================================================
+ * CPU enumeration (MP table / ACPI MADT)
+ *
+ * First stage of SMP bring-up: find out how many cores the board has
+ * and record their local APIC ids.  AP startup and per-CPU scheduler
+ * state build on this once the single-writer invariants elsewhere in
+ * the kernel are converted.
+ * ====================================================================== */
+
+#define SMP_MAX_CPUS 8
+
+typedef struct
+{
+   uint8_t lapic_id;
+   bool bsp; /* The bootstrap processor we are running on */
+} SMP_Cpu;
+
+/* Scan the MP floating pointer structure and the ACPI MADT for
+ * processors.  Returns the number of usable CPUs found (0 when neither
+ * table exists; callers should then assume a single CPU). */
+uint32_t i686_SMP_Detect(void);
+
+uint32_t i686_SMP_CpuCount(void);
+const SMP_Cpu *i686_SMP_Cpu(uint32_t index);
+
+/* Interrupt routing details recorded while walking the tables, for the
+ * APIC driver (cpu/apic.c).  All return 0 when the tables are absent. */
+uint32_t i686_SMP_LapicPhys(void);
+uint32_t i686_SMP_IoApicPhys(void);
+uint32_t i686_SMP_IoApicGsiBase(void);
+
+/* ISA IRQ -> global system interrupt override from the MADT.  Returns
+ * true and fills gsi/flags when firmware rerouted the line; callers
+ * assume identity mapping otherwise. */
+bool i686_SMP_IrqOverride(uint8_t isa_irq, uint32_t *gsi, uint16_t *flags);
+
+#endif
@@ -3,7 +3,37 @@
 #include "tss.h"
 #include "gdt.h"
 #include <mem/mm_kernel.h>
+#include <std/stdio.h>
 #include <std/string.h>
+#include <stdbool.h>
+
+/* SYSENTER/SYSEXIT fast syscall path.  The MSRs are programmed here
+ * because they travel with the TSS: IA32_SYSENTER_ESP must track esp0
+ * on every kernel-stack switch, exactly like the TSS field does.  The
+ * int 0x80 gate stays installed as the fallback for pre-SEP CPUs and
+ * for 6-argument syscalls (the sysenter ABI sacrifices ebp). */
+#define MSR_SYSENTER_CS 0x174u
+#define MSR_SYSENTER_ESP 0x175u
+#define MSR_SYSENTER_EIP 0x176u
+
+extern void __attribute__((cdecl)) i686_SysenterEntry(void);
+
+static bool g_SysenterEnabled = false;
+
+static inline void wrmsr(uint32_t msr, uint32_t lo, uint32_t hi)
+{
+   __asm__ __volatile__("wrmsr" : : "c"(msr), "a"(lo), "d"(hi));
+}
+
+/* CPUID.1:EDX bit 11 (SEP) - SYSENTER/SYSEXIT available */
+static bool sysenter_supported(void)
+{
+   uint32_t eax, ebx, ecx, edx;
+   __asm__ __volatile__("cpuid"
+                        : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                        : "a"(1));
+   return (edx & (1u << 11)) != 0;
+}
 
 typedef struct
 {
@@ -51,8 +81,27 @@ void i686_TSS_Initialize(void)
 
    uint16_t selector = i686_GDT_TSS_SEGMENT;
    __asm__ __volatile__("ltr %0" : : "r"(selector));
+
+   if (sysenter_supported())
+   {
+      /* SYSEXIT derives the user selectors from IA32_SYSENTER_CS
+       * (+16 = user code, +24 = user data), which matches this GDT's
+       * layout exactly - see gdt.h. */
+      wrmsr(MSR_SYSENTER_CS, i686_GDT_CODE_SEGMENT, 0);
+      wrmsr(MSR_SYSENTER_ESP, g_Tss.esp0, 0);
+      wrmsr(MSR_SYSENTER_EIP, (uint32_t)i686_SysenterEntry, 0);
+      g_SysenterEnabled = true;
+      logfmt(LOG_INFO, "[TSS] sysenter fast syscall path enabled\n");
+   }
 }
 
-void i686_TSS_SetKernelStack(uint32_t esp0) { g_Tss.esp0 = esp0; }
+void i686_TSS_SetKernelStack(uint32_t esp0)
+{
+   g_Tss.esp0 = esp0;
+
+   /* Keep the fast path entering on the same kernel stack the int 0x80
+    * gate would use. */
+   if (g_SysenterEnabled) wrmsr(MSR_SYSENTER_ESP, esp0, 0);
+}
 
 uint32_t i686_TSS_GetKernelStack(void) { return g_Tss.esp0; }
\ No newline at end of file
@@ -3,27 +3,49 @@
 #include "ps2.h"
 #include <arch/i686/cpu/irq.h>
 #include <arch/i686/io/io.h>
+#include <constants.h>
+#include <cpu/softirq.h>
 #include <drivers/keyboard/keyboard.h>
+#include <stddef.h>
 #include <stdint.h>
 
-/* PS/2 keyboard port */
+/* PS/2 keyboard ports */
 #define PS2_DATA_PORT 0x60
+#define PS2_STATUS_PORT 0x64
+#define PS2_STATUS_OBF 0x01 /* output buffer full */
 
 /* Global counter for keypress events for debugging (incremented in IRQ). */
 volatile uint32_t g_kb_count = 0;
 
+/* Bottom half: scancode translation and TTY echo run here, outside
+ * hard-IRQ context, so the PIC is not masked while they work. */
+static void ps2_keyboard_work(void *arg)
+{
+   (void)arg;
+   Keyboard_DrainQueue();
+}
+
 /**
  * i686-specific IRQ handler for PS/2 keyboard (IRQ1)
- * Reads scancode from port 0x60 and processes it
+ * Slurps every scancode the controller has buffered into the keyboard
+ * queue, then defers translation to a bottom half.  Fast pastes deliver
+ * several bytes per interrupt; reading them all here keeps the
+ * controller from overrunning while translation waits.
  */
 void ps2_keyboard_irq(Registers *regs)
 {
    (void)regs;
-   uint8_t scancode = i686_inb(PS2_DATA_PORT);
-   g_kb_count++;
 
-   /* Process scancode through generic keyboard handler. */
-   Keyboard_HandleScancode(scancode);
+   do
+   {
+      Keyboard_QueueScancode(i686_inb(PS2_DATA_PORT));
+      g_kb_count++;
+   } while (i686_inb(PS2_STATUS_PORT) & PS2_STATUS_OBF);
+
+   if (Softirq_Queue(ps2_keyboard_work, NULL) != SUCCESS)
+   {
+      Keyboard_DrainQueue(); /* Ring full: do the work inline */
+   }
 }
 
 /**
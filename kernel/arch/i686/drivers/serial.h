@@ -3,6 +3,17 @@
 #ifndef I686_SERIAL_H
 #define I686_SERIAL_H
 
+#include <stdint.h>
+
+/* 16550 UART on COM1: interrupt-driven TX through a ring buffer; see
+ * serial.c.  Probes for the hardware and stays silent without it. */
+void i686_Serial_Initialize(void);
+
+/* Queue a buffer for transmission.  Never blocks: returns the number
+ * of bytes accepted; anything beyond ring + FIFO capacity while the
+ * line is busy is dropped and counted. */
+uint32_t i686_Serial_Write(const void *data, uint32_t length);
+
 void i686_Serial_PutChar(char c);
 
-#endif
\ No newline at end of file
+#endif
@@ -1,9 +1,11 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "paging.h"
+#include "vm_layout.h"
 #include <mem/mm_kernel.h>
 #include <std/stdio.h>
 #include <std/string.h>
+#include <std/trace.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -13,13 +15,32 @@ extern uint8_t __end; // provided by linker, end of kernel image
 #define PAGE_TABLE_ENTRIES 1024
 #define PAGE_DIR_ENTRIES 1024
 
+// The recursive self-map slot: the last PDE of every directory points
+// back at the directory itself (see KERNEL_RECURSIVE_BASE in
+// vm_layout.h), so any PTE of the live address space sits at a
+// computable virtual address with no table walk and no dependence on
+// the table's frame being identity-mapped.
+#define RECURSIVE_SLOT (KERNEL_RECURSIVE_BASE >> 22)
+
 // Identity-map a low window so existing kernel code keeps working.
-#define IDENTITY_MAP_LIMIT (64 * 1024 * 1024u) // 64 MiB
+// The size is published as KERNEL_IDENTITY_LIMIT in vm_layout.h.
+#define IDENTITY_MAP_LIMIT KERNEL_IDENTITY_LIMIT
 
 static uint32_t *kernel_page_directory = NULL;
 static uint32_t *current_page_directory = NULL;
 static uintptr_t phys_alloc_ptr = 0;
 
+// True once CR4.PSE is enabled; the identity map then uses 4 MiB PDEs.
+static bool large_pages_enabled = false;
+
+// True once CR4.PGE is enabled; identity-map entries then carry the
+// global bit and survive the CR3 reload on every context switch.
+static bool global_pages_enabled = false;
+
+#define CPU_FEATURE_PSE 0x00000008u // CPUID.1:EDX bit 3
+#define CPU_FEATURE_PGE 0x00002000u // CPUID.1:EDX bit 13
+#define LARGE_PAGE_SIZE (4 * 1024 * 1024u)
+
 static inline uintptr_t align_up(uintptr_t v, size_t a)
 {
    return (v + (a - 1)) & ~(uintptr_t)(a - 1);
@@ -35,6 +56,9 @@ static inline void enable_paging_hw(void)
    uint32_t cr0;
    __asm__ __volatile__("mov %%cr0, %0" : "=r"(cr0));
    cr0 |= 0x80000000u; // set PG bit
+   // Set WP so supervisor writes also honor read-only PTEs; without it a
+   // syscall writing into a user buffer would bypass copy-on-write.
+   cr0 |= 0x00010000u;
    __asm__ __volatile__("mov %0, %%cr0" ::"r"(cr0) : "memory");
 }
 
@@ -50,6 +74,36 @@ static inline uint32_t read_cr3(void)
    return val;
 }
 
+// Local interrupt save/restore for walks that must not race the fault
+// handler or a context switch mid-PTE-update.
+static inline uint32_t irq_save(void)
+{
+   uint32_t eflags;
+   __asm__ __volatile__("pushf; pop %0; cli" : "=r"(eflags)::"memory");
+   return eflags;
+}
+
+static inline void irq_restore(uint32_t eflags)
+{
+   if (eflags & 0x200) __asm__ __volatile__("sti" ::: "memory");
+}
+
+static inline void enable_pse_hw(void)
+{
+   uint32_t cr4;
+   __asm__ __volatile__("mov %%cr4, %0" : "=r"(cr4));
+   cr4 |= 0x00000010u; // set PSE bit
+   __asm__ __volatile__("mov %0, %%cr4" ::"r"(cr4) : "memory");
+}
+
+static inline void enable_pge_hw(void)
+{
+   uint32_t cr4;
+   __asm__ __volatile__("mov %%cr4, %0" : "=r"(cr4));
+   cr4 |= 0x00000080u; // set PGE bit
+   __asm__ __volatile__("mov %0, %%cr4" ::"r"(cr4) : "memory");
+}
+
 // Prefer the real physical memory manager when available.
 // Falls back to the tiny bump allocator only if PMM has not been initialized.
 static uint32_t alloc_frame(void)
@@ -118,9 +172,25 @@ static uint32_t *alloc_page_directory(void)
 
 static void identity_map_range(uint32_t *pd, uint32_t start, uint32_t end)
 {
-   for (uint32_t addr = start; addr < end; addr += PAGE_SIZE)
+   // These mappings are identical in every directory, so with PGE they
+   // are marked global and survive the CR3 reload on context switches.
+   uint32_t global = global_pages_enabled ? PAGE_GLOBAL : 0;
+   uint32_t addr = start;
+   while (addr < end)
    {
-      uint32_t pd_idx = addr >> 22;           // top 10 bits
+      uint32_t pd_idx = addr >> 22; // top 10 bits
+
+      // With PSE an aligned 4 MiB chunk becomes one PDE: no page table,
+      // and one TLB entry instead of 1024.
+      if (large_pages_enabled && (addr & (LARGE_PAGE_SIZE - 1)) == 0 &&
+          end - addr >= LARGE_PAGE_SIZE)
+      {
+         pd[pd_idx] = (addr & 0xFFC00000u) | PAGE_PRESENT | PAGE_RW |
+                      PAGE_LARGE | global;
+         addr += LARGE_PAGE_SIZE;
+         continue;
+      }
+
       uint32_t pt_idx = (addr >> 12) & 0x3FF; // middle 10 bits
 
       if (!(pd[pd_idx] & PAGE_PRESENT))
@@ -130,12 +200,32 @@ static void identity_map_range(uint32_t *pd, uint32_t start, uint32_t end)
       }
 
       uint32_t *pt = (uint32_t *)(pd[pd_idx] & 0xFFFFF000u);
-      pt[pt_idx] = (addr & 0xFFFFF000u) | PAGE_PRESENT | PAGE_RW;
+      pt[pt_idx] = (addr & 0xFFFFF000u) | PAGE_PRESENT | PAGE_RW | global;
+      addr += PAGE_SIZE;
    }
 }
 
 void i686_Paging_Initialize(void)
 {
+   // Use 4 MiB pages for the identity map when the CPU supports PSE.
+   extern uint32_t get_cpu_features(void);
+   if (get_cpu_features() & CPU_FEATURE_PSE)
+   {
+      enable_pse_hw();
+      large_pages_enabled = true;
+      logfmt(LOG_INFO, "[PAGING] PSE enabled, identity map uses 4 MiB pages\n");
+   }
+
+   // Mark the shared identity map global so context-switch CR3 reloads
+   // keep the kernel's TLB entries warm.
+   if (get_cpu_features() & CPU_FEATURE_PGE)
+   {
+      enable_pge_hw();
+      global_pages_enabled = true;
+      logfmt(LOG_INFO,
+             "[PAGING] PGE enabled, kernel mappings survive CR3 reloads\n");
+   }
+
    // Bootstrap identity-mapped kernel directory
    kernel_page_directory = alloc_page_directory();
    if (!kernel_page_directory)
@@ -145,6 +235,10 @@ void i686_Paging_Initialize(void)
    }
    identity_map_range(kernel_page_directory, 0, IDENTITY_MAP_LIMIT);
 
+   // Install the recursive self-map before the directory goes live.
+   kernel_page_directory[RECURSIVE_SLOT] =
+       ((uint32_t)kernel_page_directory) | PAGE_PRESENT | PAGE_RW;
+
    // Set current directory and enable
    current_page_directory = kernel_page_directory;
    load_cr3((uint32_t)kernel_page_directory);
@@ -167,6 +261,9 @@ void *i686_Paging_CreatePageDirectory(void)
    {
       pd[i] = kernel_page_directory[i];
    }
+   // The copied self-map slot still points at the kernel directory;
+   // each directory must self-map its own frame.
+   pd[RECURSIVE_SLOT] = ((uint32_t)pd) | PAGE_PRESENT | PAGE_RW;
    return pd;
 }
 
@@ -176,6 +273,51 @@ void i686_Paging_DestroyPageDirectory(void *page_dir)
    (void)page_dir;
 }
 
+// Replace a 4 MiB PDE with an equivalent page table of 4 KiB PTEs so a
+// single page inside it can be remapped.  Existing translations stay
+// identical, so no TLB shootdown is needed here; the caller invalidates
+// whatever entry it goes on to change.
+static uint32_t *split_large_page(uint32_t *pd, uint32_t pd_idx)
+{
+   uint32_t pde = pd[pd_idx];
+   uint32_t *pt = alloc_page_table();
+   if (!pt)
+   {
+      logfmt(LOG_ERROR, "[PAGING] split_large_page - alloc failed\n");
+      return NULL;
+   }
+
+   uint32_t base = pde & 0xFFC00000u;
+   uint32_t flags = (pde & 0xFFFu) & ~(uint32_t)PAGE_LARGE;
+   for (uint32_t i = 0; i < PAGE_TABLE_ENTRIES; ++i)
+   {
+      pt[i] = (base + (i * PAGE_SIZE)) | flags;
+   }
+
+   pd[pd_idx] = ((uint32_t)pt) | flags;
+   if (pd == current_page_directory)
+   {
+      // The recursive window for this slot previously translated
+      // through the large PDE; drop that entry.
+      invlpg(KERNEL_RECURSIVE_BASE + (pd_idx << 12));
+   }
+   return pt;
+}
+
+// Virtual address of the page table covering pd_idx.  The live
+// directory is reached through the recursive window - one computed
+// address, zero lookups; another process's tables are reached through
+// their physical address (frames are identity-mapped).
+static inline uint32_t *table_virtual(uint32_t *pd, uint32_t pd_idx,
+                                      uint32_t pde)
+{
+   if (pd == current_page_directory)
+   {
+      return (uint32_t *)(KERNEL_RECURSIVE_BASE + (pd_idx << 12));
+   }
+   return (uint32_t *)(pde & 0xFFFFF000u);
+}
+
 static uint32_t *get_page_table(uint32_t *pd, uint32_t vaddr, bool create)
 {
    uint32_t pd_idx = vaddr >> 22;
@@ -191,15 +333,36 @@ static uint32_t *get_page_table(uint32_t *pd, uint32_t vaddr, bool create)
          return NULL;
       }
       pd[pd_idx] = ((uint32_t)pt) | PAGE_PRESENT | PAGE_RW;
-      return pt;
+      if (pd == current_page_directory)
+      {
+         // Drop any cached not-present translation for this table's
+         // recursive-window page before handing the window out.
+         invlpg(KERNEL_RECURSIVE_BASE + (pd_idx << 12));
+      }
+      return table_virtual(pd, pd_idx, pd[pd_idx]);
    }
-   return (uint32_t *)(pde & 0xFFFFF000u);
+   if (pde & PAGE_LARGE)
+   {
+      if (!create) return NULL;
+      return split_large_page(pd, pd_idx);
+   }
+   return table_virtual(pd, pd_idx, pde);
 }
 
-int i686_Paging_MapPage(void *page_dir, uint32_t vaddr, uint32_t paddr,
-                        uint32_t flags)
+// Install one PTE without touching the TLB; callers invalidate.
+static int map_page_at(uint32_t *pd, uint32_t vaddr, uint32_t paddr,
+                       uint32_t flags)
 {
-   uint32_t *pd = (uint32_t *)page_dir;
+   // A kernel identity remap inside a 4 MiB page is already covered by
+   // the PDE; don't split it for a no-op (AllocateKernelPages does this).
+   uint32_t pde = pd[vaddr >> 22];
+   if ((pde & PAGE_PRESENT) && (pde & PAGE_LARGE) &&
+       (paddr & 0xFFFFF000u) == (vaddr & 0xFFFFF000u) &&
+       (pde & 0xFFC00000u) == (vaddr & 0xFFC00000u) && !(flags & PAGE_USER))
+   {
+      return SUCCESS;
+   }
+
    uint32_t *pt = get_page_table(pd, vaddr, true);
    if (!pt) return I686_PAGING_ENOMEM;
 
@@ -215,7 +378,112 @@ int i686_Paging_MapPage(void *page_dir, uint32_t vaddr, uint32_t paddr,
 
    uint32_t pt_idx = (vaddr >> 12) & 0x3FF;
    pt[pt_idx] = (paddr & 0xFFFFF000u) | (flags & 0xFFF) | PAGE_PRESENT;
-   invlpg(vaddr);
+   return SUCCESS;
+}
+
+// Above this many pages a full flush is cheaper than per-page invlpg.
+// With PGE live a plain CR3 reload would skip the global identity-map
+// entries, so the full flush goes through i686_Paging_FlushTlb.
+#define TLB_BATCH_THRESHOLD 32u
+
+static void flush_range(uint32_t *pd, uint32_t vaddr, uint32_t page_count)
+{
+   if (pd != current_page_directory)
+   {
+      // Not live; the next directory switch reloads CR3 anyway.
+      return;
+   }
+
+   if (page_count > TLB_BATCH_THRESHOLD)
+   {
+      i686_Paging_FlushTlb();
+      return;
+   }
+
+   for (uint32_t i = 0; i < page_count; ++i)
+   {
+      invlpg(vaddr + (i * PAGE_SIZE));
+   }
+}
+
+int i686_Paging_MapPage(void *page_dir, uint32_t vaddr, uint32_t paddr,
+                        uint32_t flags)
+{
+   int rc = map_page_at((uint32_t *)page_dir, vaddr, paddr, flags);
+   if (rc == SUCCESS) invlpg(vaddr);
+   return rc;
+}
+
+int i686_Paging_MapMmioPage(uint32_t paddr)
+{
+   uint32_t page = paddr & ~(uint32_t)(PAGE_SIZE - 1);
+   return i686_Paging_MapPage(kernel_page_directory, page, page,
+                              PAGE_PRESENT | PAGE_RW | PAGE_PCD | PAGE_PWT);
+}
+
+int i686_Paging_MapRange(void *page_dir, uint32_t vaddr, uint32_t paddr,
+                         uint32_t page_count, uint32_t flags)
+{
+   uint32_t *pd = (uint32_t *)page_dir;
+
+   for (uint32_t i = 0; i < page_count; ++i)
+   {
+      int rc = map_page_at(pd, vaddr + (i * PAGE_SIZE),
+                           paddr + (i * PAGE_SIZE), flags);
+      if (rc < 0)
+      {
+         i686_Paging_UnmapRange(page_dir, vaddr, i);
+         return rc;
+      }
+   }
+
+   flush_range(pd, vaddr, page_count);
+   return SUCCESS;
+}
+
+int i686_Paging_UnmapRange(void *page_dir, uint32_t vaddr, uint32_t page_count)
+{
+   uint32_t *pd = (uint32_t *)page_dir;
+   uint32_t va = vaddr;
+   uint32_t remaining = page_count;
+
+   while (remaining > 0)
+   {
+      uint32_t pt_idx = (va >> 12) & 0x3FF;
+      uint32_t in_table = PAGE_TABLE_ENTRIES - pt_idx;
+      uint32_t span = remaining < in_table ? remaining : in_table;
+
+      uint32_t pde = pd[va >> 22];
+      if (!(pde & PAGE_PRESENT))
+      {
+         // Whole table absent: skip it without touching 1024 PTEs.
+         va += span * PAGE_SIZE;
+         remaining -= span;
+         continue;
+      }
+
+      if (pde & PAGE_LARGE)
+      {
+         logfmt(LOG_WARNING,
+                "[PAGING] UnmapRange: refusing to unmap 4 MiB page at "
+                "0x%08x\n",
+                va);
+         va += span * PAGE_SIZE;
+         remaining -= span;
+         continue;
+      }
+
+      uint32_t *pt = table_virtual(pd, va >> 22, pde);
+      for (uint32_t i = 0; i < span; ++i)
+      {
+         pt[pt_idx + i] = 0;
+      }
+
+      va += span * PAGE_SIZE;
+      remaining -= span;
+   }
+
+   flush_range(pd, vaddr, page_count);
    return SUCCESS;
 }
 
@@ -233,6 +501,13 @@ int i686_Paging_UnmapPage(void *page_dir, uint32_t vaddr)
 uint32_t i686_Paging_GetPhysicalAddress(void *page_dir, uint32_t vaddr)
 {
    uint32_t *pd = (uint32_t *)page_dir;
+
+   uint32_t pde = pd[vaddr >> 22];
+   if ((pde & PAGE_PRESENT) && (pde & PAGE_LARGE))
+   {
+      return (pde & 0xFFC00000u) | (vaddr & 0x3FFFFFu);
+   }
+
    uint32_t *pt = get_page_table(pd, vaddr, false);
    if (!pt) return 0;
    uint32_t pt_idx = (vaddr >> 12) & 0x3FF;
@@ -247,7 +522,194 @@ int i686_Paging_IsPageMapped(void *page_dir, uint32_t vaddr)
                                                                : -EINVAL;
 }
 
-void i686_Paging_PageFaultHandler(uint32_t fault_address, uint32_t error_code)
+uint32_t i686_Paging_GetPageFlags(void *page_dir, uint32_t vaddr)
+{
+   uint32_t *pd = (uint32_t *)page_dir;
+
+   uint32_t pde = pd[vaddr >> 22];
+   if ((pde & PAGE_PRESENT) && (pde & PAGE_LARGE))
+   {
+      return pde & 0xFFFu;
+   }
+
+   uint32_t *pt = get_page_table(pd, vaddr, false);
+   if (!pt) return 0;
+   uint32_t pt_idx = (vaddr >> 12) & 0x3FF;
+   uint32_t pte = pt[pt_idx];
+   if (!(pte & PAGE_PRESENT)) return 0;
+   return pte & 0xFFFu;
+}
+
+// Two-pass accessed-bit aging over one range of an address space.  The
+// first visit clears the hardware accessed bit and marks the PTE idle;
+// a later visit that still finds the idle mark with the accessed bit
+// clear compresses the page into the zstore and frees its frame.  The
+// PTE then carries the store slot with PAGE_SWAPPED set, and the fault
+// path decompresses the page back on the next touch.  Only exclusive,
+// non-COW frames qualify: a shared frame would need per-mapping
+// bookkeeping the store does not carry.
+uint32_t i686_Paging_ScanIdlePages(void *page_dir, uint32_t start,
+                                   uint32_t end, uint32_t max_out)
+{
+   uint32_t *pd = (uint32_t *)page_dir;
+   bool live = (pd == current_page_directory);
+   uint32_t compressed = 0;
+
+   // Interrupts stay off for the whole walk so a preempting process
+   // cannot dirty a page between its snapshot and its PTE rewrite.
+   uint32_t eflags = irq_save();
+
+   for (uint32_t va = start & ~0xFFFu; va < end && compressed < max_out;
+        va += PAGE_SIZE)
+   {
+      uint32_t pde = pd[va >> 22];
+      if (!(pde & PAGE_PRESENT) || (pde & PAGE_LARGE))
+      {
+         // Whole table absent (or a 4 MiB kernel mapping): skip to the
+         // next page-table boundary without touching 1024 PTEs.
+         uint32_t next = ((va >> 22) + 1) << 22;
+         if (next <= va) break; // wrapped past 4 GiB
+         va = next - PAGE_SIZE;
+         continue;
+      }
+
+      uint32_t *pt = table_virtual(pd, va >> 22, pde);
+      uint32_t pt_idx = (va >> 12) & 0x3FF;
+      uint32_t pte = pt[pt_idx];
+
+      if (!(pte & PAGE_PRESENT) || (pte & PAGE_COW)) continue;
+
+      uint32_t phys = pte & 0xFFFFF000u;
+      if (PMM_GetPageRefCount(phys) != 1) continue;
+
+      if (pte & PAGE_ACCESSED)
+      {
+         // Touched since the last pass: restart its aging clock.  The
+         // invalidate matters - a stale TLB entry would let the CPU
+         // keep using the page without ever setting the bit again.
+         pt[pt_idx] = pte & ~(uint32_t)(PAGE_ACCESSED | PAGE_IDLE);
+         if (live) invlpg(va);
+         continue;
+      }
+
+      if (!(pte & PAGE_IDLE))
+      {
+         pt[pt_idx] = pte | PAGE_IDLE;
+         continue;
+      }
+
+      // Cold through two passes: compress the frame out.
+      int slot = ZStore_Save(pd, va, (const void *)phys);
+      if (slot == -ENOMEM) break; // store full; nothing more fits
+      if (slot < 0) continue;     // incompressible page; keep it resident
+
+      pt[pt_idx] = ((uint32_t)slot << 12) | PAGE_SWAPPED;
+      if (live) invlpg(va);
+      PMM_FreePhysicalPage(phys);
+      compressed++;
+   }
+
+   irq_restore(eflags);
+   return compressed;
+}
+
+// Resolve a write to a copy-on-write page in the current directory.
+// Returns SUCCESS when the fault was handled, -EINVAL otherwise.
+static int resolve_cow_fault(uint32_t fault_address, uint32_t error_code)
+{
+   // Only protection faults caused by a write can be COW.
+   if ((error_code & 0x3) != 0x3) return -EINVAL;
+
+   uint32_t *pt = get_page_table(current_page_directory, fault_address, false);
+   if (!pt) return -EINVAL;
+
+   uint32_t pt_idx = (fault_address >> 12) & 0x3FF;
+   uint32_t pte = pt[pt_idx];
+   if (!(pte & PAGE_PRESENT) || !(pte & PAGE_COW)) return -EINVAL;
+
+   uint32_t old_phys = pte & 0xFFFFF000u;
+   uint32_t flags = ((pte & 0xFFFu) & ~PAGE_COW) | PAGE_RW;
+
+   if (PMM_GetPageRefCount(old_phys) <= 1)
+   {
+      // Last holder of the frame: upgrade in place, nothing to copy.
+      pt[pt_idx] = old_phys | flags;
+      invlpg(fault_address);
+      return SUCCESS;
+   }
+
+   // A write to the shared zero page just needs a fresh zeroed frame;
+   // pre-zeroed frames from the idle queue skip the copy entirely.
+   if (old_phys == PMM_GetZeroPage())
+   {
+      uint32_t zeroed = PMM_AllocateZeroedPage();
+      if (zeroed == 0)
+      {
+         logfmt(LOG_ERROR,
+                "[PAGING] COW: out of memory copying page at 0x%08x\n",
+                fault_address);
+         return -EINVAL;
+      }
+      pt[pt_idx] = zeroed | flags;
+      invlpg(fault_address);
+      return SUCCESS;
+   }
+
+   uint32_t new_phys = PMM_AllocatePhysicalPage();
+   if (new_phys == 0)
+   {
+      logfmt(LOG_ERROR,
+             "[PAGING] COW: out of memory copying page at 0x%08x\n",
+             fault_address);
+      return -EINVAL;
+   }
+
+   // Frames live in the identity-mapped window, so copy directly.
+   memcpy((void *)new_phys, (void *)old_phys, PAGE_SIZE);
+   pt[pt_idx] = new_phys | flags;
+   invlpg(fault_address);
+   PMM_FreePhysicalPage(old_phys); // drop our reference to the shared frame
+   return SUCCESS;
+}
+
+// Fault a compressed-out page back in.  A swapped PTE is non-present
+// and carries a zstore slot in its frame field with PAGE_SWAPPED set.
+// Only exclusive anonymous heap pages are ever compressed out, so the
+// restored mapping is always private RW|USER.
+static int resolve_swapped_fault(uint32_t fault_address, uint32_t error_code)
+{
+   if (error_code & 0x1) return -EINVAL; // protection fault, not swap
+
+   uint32_t *pt = get_page_table(current_page_directory, fault_address, false);
+   if (!pt) return -EINVAL;
+
+   uint32_t pt_idx = (fault_address >> 12) & 0x3FF;
+   uint32_t pte = pt[pt_idx];
+   if ((pte & PAGE_PRESENT) || !(pte & PAGE_SWAPPED)) return -EINVAL;
+
+   uint32_t phys = PMM_AllocatePhysicalPage();
+   if (phys == 0)
+   {
+      logfmt(LOG_ERROR,
+             "[PAGING] swap-in: out of memory restoring page at 0x%08x\n",
+             fault_address);
+      return -EINVAL;
+   }
+
+   // Frames live in the identity-mapped window; decompress straight in.
+   if (ZStore_Fetch(pte >> 12, current_page_directory,
+                    fault_address & 0xFFFFF000u, (void *)phys) != SUCCESS)
+   {
+      PMM_FreePhysicalPage(phys);
+      return -EINVAL;
+   }
+
+   pt[pt_idx] = phys | PAGE_PRESENT | PAGE_RW | PAGE_USER;
+   invlpg(fault_address);
+   return SUCCESS;
+}
+
+static void page_fault_fatal(uint32_t fault_address, uint32_t error_code)
 {
    logfmt(LOG_FATAL, "Page fault at 0x%08x, error=0x%x\n", fault_address,
           error_code);
@@ -258,9 +720,70 @@ void i686_Paging_PageFaultHandler(uint32_t fault_address, uint32_t error_code)
    for (;;) __asm__ __volatile__("hlt");
 }
 
+void i686_Paging_PageFaultHandler(uint32_t fault_address, uint32_t error_code)
+{
+   TRACE_EVENT(TRACE_EV_PAGE_FAULT, fault_address);
+
+   if (resolve_cow_fault(fault_address, error_code) == SUCCESS) return;
+
+   if (resolve_swapped_fault(fault_address, error_code) == SUCCESS) return;
+
+   // Non-present fault: may be a demand-paged ELF page.
+   if (!(error_code & 0x1) &&
+       Process_HandlePageFault(fault_address, error_code) == SUCCESS)
+   {
+      return;
+   }
+
+   page_fault_fatal(fault_address, error_code);
+}
+
+void i686_Paging_PageFaultIsr(Registers *regs)
+{
+   uint32_t fault_address;
+   __asm__ __volatile__("mov %%cr2, %0" : "=r"(fault_address));
+
+   TRACE_EVENT(TRACE_EV_PAGE_FAULT, fault_address);
+
+   if (resolve_cow_fault(fault_address, regs->error) == SUCCESS) return;
+
+   if (resolve_swapped_fault(fault_address, regs->error) == SUCCESS) return;
+
+   if (!(regs->error & 0x1) &&
+       Process_HandlePageFault(fault_address, regs->error) == SUCCESS)
+   {
+      return;
+   }
+
+   // A fault inside a guarded user copy resumes at its fixup label
+   // (same frame - rep movs pushes nothing) and surfaces as -EFAULT.
+   uint32_t resume = mem_user_fault_fixup(regs->eip);
+   if (resume != 0)
+   {
+      regs->eip = resume;
+      return;
+   }
+
+   page_fault_fatal(fault_address, regs->error);
+}
+
 void i686_Paging_InvalidateTlbEntry(uint32_t vaddr) { invlpg(vaddr); }
 
-void i686_Paging_FlushTlb(void) { load_cr3(read_cr3()); }
+void i686_Paging_FlushTlb(void)
+{
+   if (global_pages_enabled)
+   {
+      // A CR3 reload deliberately skips global entries; toggling
+      // CR4.PGE is the documented way to flush those too.
+      uint32_t cr4;
+      __asm__ __volatile__("mov %%cr4, %0" : "=r"(cr4));
+      __asm__ __volatile__("mov %0, %%cr4" ::"r"(cr4 & ~0x00000080u)
+                           : "memory");
+      __asm__ __volatile__("mov %0, %%cr4" ::"r"(cr4) : "memory");
+      return;
+   }
+   load_cr3(read_cr3());
+}
 
 void i686_Paging_SwitchPageDirectory(void *page_dir)
 {
@@ -4,6 +4,7 @@
 #ifndef I686_PAGING_H
 #define I686_PAGING_H
 
+#include <arch/i686/cpu/isr.h>
 #include <mem/mm_kernel.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -12,6 +13,20 @@
 #define PAGE_PRESENT 0x001
 #define PAGE_RW 0x002
 #define PAGE_USER 0x004
+#define PAGE_PWT 0x008   // Write-through caching
+#define PAGE_PCD 0x010   // Cache disable (MMIO registers)
+#define PAGE_LARGE 0x080 // PDE maps a 4 MiB page (requires CR4.PSE)
+#define PAGE_GLOBAL 0x100 // PTE/4 MiB PDE survives CR3 reloads (CR4.PGE)
+#define PAGE_COW 0x200   // AVL bit: frame is shared, copy on first write
+#define PAGE_ACCESSED 0x020 // Hardware-set on any access; cleared for aging
+
+// Second AVL bit, meaning keyed on PAGE_PRESENT.  On a present PTE it
+// marks a page whose accessed bit stayed clear through one aging pass
+// (candidate for compression).  On a non-present PTE the frame field
+// holds a zstore slot instead of a physical address and the fault path
+// decompresses the page back in.
+#define PAGE_IDLE 0x400
+#define PAGE_SWAPPED 0x400
 
 #define I686_PAGING_ENOMEM (-2)
 
@@ -28,12 +43,34 @@ int i686_Paging_MapPage(void *page_dir, uint32_t vaddr, uint32_t paddr,
                         uint32_t flags);
 int i686_Paging_UnmapPage(void *page_dir, uint32_t vaddr);
 
+// Range variants: update all PTEs first, then invalidate the touched
+// pages once (full CR3 reload past a threshold)
+int i686_Paging_MapRange(void *page_dir, uint32_t vaddr, uint32_t paddr,
+                         uint32_t page_count, uint32_t flags);
+int i686_Paging_UnmapRange(void *page_dir, uint32_t vaddr,
+                           uint32_t page_count);
+
+// Identity-map one device-register page (uncached) into the shared
+// kernel page directory.  Must run before the first user process is
+// created: process directories copy the kernel PDEs at creation time,
+// so a PDE added later would be missing from existing address spaces.
+int i686_Paging_MapMmioPage(uint32_t paddr);
+
 // Page lookup
 uint32_t i686_Paging_GetPhysicalAddress(void *page_dir, uint32_t vaddr);
 int i686_Paging_IsPageMapped(void *page_dir, uint32_t vaddr);
+uint32_t i686_Paging_GetPageFlags(void *page_dir, uint32_t vaddr);
+
+// Accessed-bit aging over one address range: pages idle through two
+// consecutive passes are compressed into the zstore and their frames
+// freed.  Returns the number of pages compressed out (at most max_out).
+// Runs with interrupts disabled internally; call from process context.
+uint32_t i686_Paging_ScanIdlePages(void *page_dir, uint32_t start,
+                                   uint32_t end, uint32_t max_out);
 
 // Page fault handling
 void i686_Paging_PageFaultHandler(uint32_t fault_address, uint32_t error_code);
+void i686_Paging_PageFaultIsr(Registers *regs);
 
 // TLB management
 void i686_Paging_InvalidateTlbEntry(uint32_t vaddr);
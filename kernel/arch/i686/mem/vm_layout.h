@@ -11,6 +11,20 @@ extern uint8_t __end;
 /** Kernel base address - identity mapped at 3GB (0xC0000000) */
 #define KERNEL_BASE 0xC0000000UL
 
+/** Top of the low identity-mapped kernel window.  The page tables for
+ *  this range are created once and shared by every page directory
+ *  (i686_Paging_CreatePageDirectory copies the PDEs), so per-process
+ *  code must never remap anything below this address */
+#define KERNEL_IDENTITY_LIMIT (64 * 1024 * 1024UL) // 64 MiB
+
+/** Recursive page-directory self-map window (top 4 MiB).  PDE 1023 of
+ *  every directory points back at the directory itself, so the MMU
+ *  exposes the page table for directory index N of the *current*
+ *  address space at KERNEL_RECURSIVE_BASE + N * PAGE_SIZE (and the
+ *  directory itself at the window's last page).  Nothing else may ever
+ *  be mapped in this range */
+#define KERNEL_RECURSIVE_BASE 0xFFC00000UL
+
 /* ========== USER SPACE (Low addresses, 0 - 3GB) ========== */
 
 /** User space end (before kernel space) */
@@ -32,6 +46,14 @@ extern uint8_t __end;
 /** Per-process stack size (default, can be adjusted per process) */
 #define USER_STACK_SIZE 0x10000UL // 64KB
 
+/** Pages mapped up front; most processes never need more than this */
+#define USER_STACK_INITIAL_SIZE 0x4000UL // 16KB
+
+/** Hard growth limit.  The region between the mapped stack and this
+ *  bound acts as a guard: faults there grow the stack on demand
+ *  (Process_HandlePageFault), faults beyond it stay fatal */
+#define USER_STACK_MAX_SIZE 0x40000UL // 256KB
+
 /** Per-process code/data region (typically loaded from 0x08048000 on x86 Linux
  * convention) */
 #define USER_CODE_START 0x08048000UL // 128MiB + 16KB (standard x86 32-bit)
@@ -42,4 +64,8 @@ extern uint8_t __end;
  *  Must be in user-accessible but protected region */
 #define USER_EXIT_TRAMPOLINE_VA (USER_STACK_START + PAGE_SIZE)
 
+/** Shared read-only kernel info page (pid/ppid, ticks, TSC calibration)
+ *  mapped into every user address space; see kernel/cpu/kinfo.h */
+#define USER_KINFO_VA (USER_EXIT_TRAMPOLINE_VA + PAGE_SIZE)
+
 #endif
\ No newline at end of file
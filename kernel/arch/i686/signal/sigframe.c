@@ -1 +1,150 @@
-// SPDX-License-Identifier: GPL-3.0-only
\ No newline at end of file
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "sigframe.h"
+#include <constants.h>
+#include <cpu/process.h>
+#include <mem/mm_kernel.h>
+#include <signal/signal.h>
+#include <std/string.h>
+#include <stddef.h>
+
+/* User-stack frame builder for signal delivery.
+ *
+ * All deliverable caught signals are delivered in one return-to-user
+ * transition: the builder stacks one SigFrame per signal, and each
+ * frame's saved context enters the next handler directly, so only the
+ * innermost frame resumes the interrupted code.  A burst of N signals
+ * therefore costs a single kernel exit plus one sigreturn syscall per
+ * handler instead of N full save/restore round trips. */
+
+/* Sigreturn trampoline bytes (sigreturn_asm.S).  They never execute
+ * from the kernel image: the builder copies them onto the user stack
+ * and every frame's return address points at the copy. */
+extern const uint8_t i686_SigreturnTrampoline[];
+extern const uint8_t i686_SigreturnTrampolineEnd[];
+
+/* EFLAGS bits user code may control: CF, PF, AF, ZF, SF, DF, OF.
+ * Everything else (IOPL, NT, TF, ...) is forced off and IF plus the
+ * always-one bit 1 are forced on, so a forged frame cannot raise
+ * privilege or mask interrupts. */
+#define SIGFRAME_EFLAGS_USER 0x0CD5u
+#define SIGFRAME_EFLAGS_FORCED 0x0202u
+
+int i686_Signal_SetupFrames(struct Process *proc, Registers *regs)
+{
+   if (!proc || !regs) return -EINVAL;
+
+   /* Frames only make sense on top of a ring-3 trap frame; leave the
+    * signals pending when the kernel was interrupted mid-flight. */
+   if ((regs->cs & 0x3) != 0x3) return 0;
+
+   /* Collect every deliverable signal with a real handler.  Default
+    * and ignore dispositions are the generic layer's business. */
+   uint32_t caught = 0;
+   uint32_t scan = proc->signal_pending & ~proc->signal_mask;
+   while (scan != 0)
+   {
+      int signum = __builtin_ctz(scan) + 1;
+      uint32_t bit = SIGNAL_BIT(signum);
+      scan &= ~bit;
+
+      if (proc->signal_handlers[signum - 1] > SIG_IGN) caught |= bit;
+   }
+   if (caught == 0) return 0;
+
+   int sigs[SIGNAL_MAX];
+   int count = 0;
+   scan = caught;
+   while (scan != 0)
+   {
+      sigs[count++] = __builtin_ctz(scan) + 1;
+      scan &= scan - 1;
+   }
+
+   /* Trampoline goes in first, above the frames. */
+   uint32_t tramp_size =
+       (uint32_t)(i686_SigreturnTrampolineEnd - i686_SigreturnTrampoline);
+   uint32_t usp = regs->esp - tramp_size;
+   uint32_t tramp_addr = usp;
+   if (copy_to_user((void *)usp, i686_SigreturnTrampoline, tramp_size) !=
+       SUCCESS)
+      return -EFAULT;
+   usp &= ~0x3u;
+
+   /* Build frames innermost first.  Frame k's saved context is the
+    * entry state of handler k+1, so handler k's sigreturn falls
+    * straight into the next handler; only the innermost frame carries
+    * the interrupted context.  restore_mask chains the same way: each
+    * sigreturn keeps the still-queued higher signals blocked and the
+    * last one restores the original mask. */
+   uint32_t orig_mask = proc->signal_mask;
+   Registers next = *regs;
+
+   for (int k = count - 1; k >= 0; k--)
+   {
+      uint32_t addr = usp - (uint32_t)(count - k) * sizeof(SigFrame);
+
+      uint32_t queued_above = 0;
+      for (int j = k + 1; j < count; j++)
+         queued_above |= SIGNAL_BIT(sigs[j]);
+
+      SigFrame frame;
+      memset(&frame, 0, sizeof(frame));
+      frame.ret_addr = tramp_addr;
+      frame.signum = (uint32_t)sigs[k];
+      frame.restore_mask = orig_mask | queued_above;
+      frame.context = next;
+
+      if (copy_to_user((void *)addr, &frame, sizeof(frame)) != SUCCESS)
+         return -EFAULT;
+
+      next = *regs;
+      next.eip = (uint32_t)proc->signal_handlers[sigs[k] - 1];
+      next.esp = addr;
+
+      proc->signal_pending &= ~SIGNAL_BIT(sigs[k]);
+   }
+
+   /* Kernel exit now lands in the first handler; the whole batch stays
+    * blocked until its frame's sigreturn unwinds it. */
+   regs->eip = next.eip;
+   regs->esp = next.esp;
+   proc->signal_mask = orig_mask | caught;
+   Signal_UpdateDeliverable(proc);
+
+   return count;
+}
+
+intptr_t i686_Signal_Sigreturn(struct Process *proc, Registers *regs)
+{
+   if (!proc || !regs) return -EINVAL;
+
+   /* The handler's ret popped ret_addr, so the trap frame's ESP points
+    * at signum and the SigFrame starts one slot below it. */
+   SigFrame frame;
+   if (copy_from_user(&frame, (const void *)(regs->esp - 4),
+                      sizeof(frame)) != SUCCESS)
+      return -EFAULT;
+
+   /* Take the general registers and resume point from the frame but
+    * never segment or privilege state: a corrupted frame must not be
+    * able to return to ring 0. */
+   Registers restored = frame.context;
+   restored.ds = regs->ds;
+   restored.cs = regs->cs;
+   restored.ss = regs->ss;
+   restored.kern_esp = regs->kern_esp;
+   restored.interrupt = regs->interrupt;
+   restored.error = regs->error;
+   restored.eflags =
+       (frame.context.eflags & SIGFRAME_EFLAGS_USER) | SIGFRAME_EFLAGS_FORCED;
+
+   *regs = restored;
+
+   proc->signal_mask = frame.restore_mask & ~SIGNAL_UNBLOCKABLE;
+   Signal_UpdateDeliverable(proc);
+
+   /* The dispatcher stores the syscall result in the frame's EAX slot;
+    * hand back the restored EAX so the resumed context keeps it. */
+   return (intptr_t)restored.eax;
+}
@@ -3,4 +3,34 @@
 #ifndef I686_SIGFRAME_H
 #define I686_SIGFRAME_H
 
-#endif
\ No newline at end of file
+#include <arch/i686/cpu/isr.h>
+#include <stdint.h>
+
+struct Process;
+
+/* One user-stack record per delivered signal.  The layout doubles as
+ * the handler's call frame: on entry ESP points at ret_addr, so the
+ * cdecl handler sees signum as its first argument and returns into the
+ * sigreturn trampoline copied just above the frames. */
+typedef struct
+{
+   uint32_t ret_addr;     /* handler returns into the trampoline */
+   uint32_t signum;       /* handler argument */
+   uint32_t restore_mask; /* signal mask after this frame's sigreturn */
+   Registers context;     /* context this frame's sigreturn restores */
+} __attribute__((packed)) SigFrame;
+
+/* Stack one frame per deliverable caught signal onto the user stack and
+ * rewrite the trap frame to enter the first handler, so a burst of N
+ * signals costs one kernel exit instead of N.  Returns the number of
+ * frames pushed (0 when nothing is caught or the trap frame is not a
+ * ring-3 frame) or a negative errno when the user stack is unwritable. */
+int i686_Signal_SetupFrames(struct Process *proc, Registers *regs);
+
+/* Restore the context saved in the frame the returning handler ran on.
+ * Returns the restored EAX (the dispatcher writes the result back into
+ * the trap frame's EAX slot) or a negative errno when the frame cannot
+ * be read back. */
+intptr_t i686_Signal_Sigreturn(struct Process *proc, Registers *regs);
+
+#endif
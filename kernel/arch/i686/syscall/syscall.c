@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "syscall.h"
+#include <cpu/process.h>
+#include <signal/signal.h>
 #include <std/stdio.h>
 #include <stdint.h>
 #include <syscall/syscall.h>
@@ -25,4 +27,13 @@ void i686_Syscall_IRQ(Registers *regs)
 
    // Store result in EAX for return to user
    regs->eax = (uint32_t)result;
+
+   /* Signal fast path: signal-free returns cost this single test.
+    * The flag caches (pending & ~blocked) != 0 and is maintained by
+    * kernel/signal at every mutation of either mask. */
+   Process *current = Process_GetCurrent();
+   if (current && current->signal_deliverable)
+   {
+      Signal_DeliverPending(current, regs);
+   }
 }
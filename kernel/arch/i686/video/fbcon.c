@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+ * kernel/arch/i686/video/fbcon.c
+ *
+ * Linear-framebuffer console renderer for the VBE mode the bootloader
+ * may leave us in.  vga.c owns the terminal state and calls down here;
+ * this file only turns text cells into pixels.
+ *
+ * The framebuffer is mapped uncached, so it is written strictly
+ * sequentially and never read: all rendering happens in an off-screen
+ * compose buffer in ordinary cached RAM, and Present copies just the
+ * scanline spans touched since the last call with the wide memcpy.
+ */
+
+#include "fbcon.h"
+#include "font.h"
+#include <arch/i686/mem/paging.h>
+#include <constants.h>
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <stdbool.h>
+#include <sys/sys.h>
+
+#define FBCON_GLYPH_W FONT_WIDTH
+#define FBCON_GLYPH_H FONT_HEIGHT
+
+/* Bounds on what the console will drive; wilder modes fall back to
+ * VGA text rather than risking a huge compose allocation. */
+#define FBCON_MIN_WIDTH 640u
+#define FBCON_MIN_HEIGHT 400u
+#define FBCON_MAX_WIDTH 1920u
+#define FBCON_MAX_HEIGHT 1200u
+
+#define FBCON_MAX_ROWS (FBCON_MAX_HEIGHT / FBCON_GLYPH_H)
+
+static bool s_Active = false;
+static uint8_t *s_Lfb = NULL;     /* Identity-mapped, uncached */
+static uint8_t *s_Compose = NULL; /* Same layout, cached RAM */
+static uint32_t s_Pitch = 0;
+static uint32_t s_Width = 0;
+static uint32_t s_Height = 0;
+static int s_Cols = 0;
+static int s_Rows = 0;
+
+/* Dirty tracking per text row: the column span touched since the last
+ * Present.  A keystroke echo moves 16 scanlines × 8 pixels over the
+ * bus instead of the whole frame. */
+typedef struct
+{
+   bool dirty;
+   int min_col;
+   int max_col;
+} FbRowSpan;
+
+static FbRowSpan s_Dirty[FBCON_MAX_ROWS];
+
+/* Software cursor: an XOR block over the cell's lower scanlines.
+ * XOR-ing again removes it, so no saved-under buffer is needed; a
+ * DrawCells over the cursor cell re-renders it away and clears
+ * s_CursorDrawn. */
+static int s_CursorX = -1;
+static int s_CursorY = -1;
+static bool s_CursorDrawn = false;
+
+/* Standard VGA 16-colour palette as 0x00RRGGBB. */
+static const uint32_t s_Palette[16] = {
+    0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA,
+    0xAA5500, 0xAAAAAA, 0x555555, 0x5555FF, 0x55FF55, 0x55FFFF,
+    0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF};
+
+static void fbcon_mark(int row, int col_lo, int col_hi)
+{
+   if (row < 0 || row >= s_Rows) return;
+
+   FbRowSpan *span = &s_Dirty[row];
+   if (!span->dirty)
+   {
+      span->dirty = true;
+      span->min_col = col_lo;
+      span->max_col = col_hi;
+      return;
+   }
+   if (col_lo < span->min_col) span->min_col = col_lo;
+   if (col_hi > span->max_col) span->max_col = col_hi;
+}
+
+static void fbcon_render_cell(int row, int col, uint16_t cell)
+{
+   uint8_t ch = (uint8_t)(cell & 0xFF);
+   uint8_t attr = (uint8_t)(cell >> 8);
+   uint32_t fg = s_Palette[attr & 0x0F];
+   uint32_t bg = s_Palette[(attr >> 4) & 0x07]; /* Bit 7 (blink) ignored */
+
+   const uint8_t *glyph = (ch >= FONT_FIRST && ch <= FONT_LAST)
+                              ? g_Font8x16[ch - FONT_FIRST]
+                              : g_Font8x16[0]; /* Space */
+
+   uint8_t *base = s_Compose + (uint32_t)(row * FBCON_GLYPH_H) * s_Pitch +
+                   (uint32_t)(col * FBCON_GLYPH_W) * 4u;
+   for (int r = 0; r < FBCON_GLYPH_H; r++)
+   {
+      uint32_t *dst = (uint32_t *)(base + (uint32_t)r * s_Pitch);
+      uint8_t bits = glyph[r];
+      for (int c = 0; c < FBCON_GLYPH_W; c++)
+      {
+         dst[c] = (bits & (0x80u >> c)) ? fg : bg;
+      }
+   }
+}
+
+static void fbcon_xor_cursor(int x, int y)
+{
+   uint8_t *base = s_Compose + (uint32_t)(y * FBCON_GLYPH_H + 12) * s_Pitch +
+                   (uint32_t)(x * FBCON_GLYPH_W) * 4u;
+   for (int r = 0; r < 4; r++)
+   {
+      uint32_t *dst = (uint32_t *)(base + (uint32_t)r * s_Pitch);
+      for (int c = 0; c < FBCON_GLYPH_W; c++) dst[c] ^= 0x00FFFFFFu;
+   }
+   fbcon_mark(y, x, x);
+}
+
+int i686_FBCON_Probe(int max_cols, int max_rows)
+{
+   const BOOT_Info *boot = &g_SysInfo->boot;
+
+   if (!boot->fbAddr) return -ENODEV;
+
+   /* Only 32 bpp direct-RGB modes: one pixel = one aligned store, and
+    * every VBE implementation worth using offers one. */
+   if (boot->fbBpp != 32)
+   {
+      logfmt(LOG_WARNING, "[FBCON] unsupported bpp=%u, staying on VGA text\n",
+             boot->fbBpp);
+      return -ENODEV;
+   }
+   if (boot->fbWidth < FBCON_MIN_WIDTH || boot->fbWidth > FBCON_MAX_WIDTH ||
+       boot->fbHeight < FBCON_MIN_HEIGHT || boot->fbHeight > FBCON_MAX_HEIGHT ||
+       boot->fbPitch < boot->fbWidth * 4u)
+   {
+      logfmt(LOG_WARNING, "[FBCON] unsupported mode %ux%u, staying on VGA "
+                          "text\n",
+             boot->fbWidth, boot->fbHeight);
+      return -ENODEV;
+   }
+   if (boot->fbAddr > 0xFFFFFFFFull - (uint64_t)boot->fbPitch * boot->fbHeight)
+   {
+      return -ENODEV;
+   }
+
+   s_Pitch = boot->fbPitch;
+   s_Width = boot->fbWidth;
+   s_Height = boot->fbHeight;
+   uint32_t bytes = s_Pitch * s_Height;
+
+   /* Identity-map the aperture uncached into the shared kernel page
+    * directory.  HAL_Initialize runs before the first user process, so
+    * the new PDEs reach every later address space. */
+   uint32_t base = (uint32_t)boot->fbAddr;
+   for (uint32_t off = 0; off < bytes; off += 4096u)
+   {
+      if (i686_Paging_MapMmioPage(base + off) < 0)
+      {
+         logfmt(LOG_ERROR, "[FBCON] framebuffer map failed at %x\n",
+                base + off);
+         return -ENOMEM;
+      }
+   }
+   s_Lfb = (uint8_t *)base;
+
+   s_Compose = kmalloc(bytes);
+   if (!s_Compose)
+   {
+      logfmt(LOG_ERROR, "[FBCON] compose buffer alloc failed: bytes=%u\n",
+             bytes);
+      return -ENOMEM;
+   }
+   memset(s_Compose, 0, bytes);
+   memset(s_Lfb, 0, bytes);
+
+   s_Cols = (int)(s_Width / FBCON_GLYPH_W);
+   s_Rows = (int)(s_Height / FBCON_GLYPH_H);
+   if (max_cols > 0 && s_Cols > max_cols) s_Cols = max_cols;
+   if (max_rows > 0 && s_Rows > max_rows) s_Rows = max_rows;
+   s_Active = true;
+
+   logfmt(LOG_INFO, "[FBCON] mode=%ux%ux32 pitch=%u console=%dx%d\n", s_Width,
+          s_Height, s_Pitch, s_Cols, s_Rows);
+   return SUCCESS;
+}
+
+int i686_FBCON_Cols(void)
+{
+   return s_Cols;
+}
+
+int i686_FBCON_Rows(void)
+{
+   return s_Rows;
+}
+
+void i686_FBCON_DrawCells(int row, int col, const uint16_t *cells, int count)
+{
+   if (!s_Active || row < 0 || row >= s_Rows || col < 0) return;
+   if (col + count > s_Cols) count = s_Cols - col;
+   if (count <= 0) return;
+
+   for (int i = 0; i < count; i++)
+   {
+      fbcon_render_cell(row, col + i, cells[i]);
+   }
+   fbcon_mark(row, col, col + count - 1);
+
+   /* Re-rendering the cursor cell painted over the XOR block. */
+   if (s_CursorDrawn && s_CursorY == row && s_CursorX >= col &&
+       s_CursorX < col + count)
+   {
+      s_CursorDrawn = false;
+   }
+}
+
+void i686_FBCON_ScrollUp(uint8_t color)
+{
+   if (!s_Active) return;
+
+   if (s_CursorDrawn)
+   {
+      fbcon_xor_cursor(s_CursorX, s_CursorY);
+      s_CursorDrawn = false;
+   }
+
+   uint32_t line_bytes = (uint32_t)FBCON_GLYPH_H * s_Pitch;
+   uint32_t rows_bytes = (uint32_t)s_Rows * line_bytes;
+   memmove(s_Compose, s_Compose + line_bytes, rows_bytes - line_bytes);
+
+   /* Clear the exposed bottom line to the background colour. */
+   uint32_t bg = s_Palette[(color >> 4) & 0x07];
+   uint32_t *bottom = (uint32_t *)(s_Compose + rows_bytes - line_bytes);
+   for (uint32_t i = 0; i < line_bytes / 4u; i++) bottom[i] = bg;
+
+   /* Every visible scanline changed. */
+   for (int row = 0; row < s_Rows; row++) fbcon_mark(row, 0, s_Cols - 1);
+}
+
+void i686_FBCON_SetCursor(int x, int y)
+{
+   if (!s_Active) return;
+   if (s_CursorDrawn && s_CursorX == x && s_CursorY == y) return;
+
+   if (s_CursorDrawn)
+   {
+      fbcon_xor_cursor(s_CursorX, s_CursorY);
+      s_CursorDrawn = false;
+   }
+   if (x >= 0 && x < s_Cols && y >= 0 && y < s_Rows)
+   {
+      fbcon_xor_cursor(x, y);
+      s_CursorX = x;
+      s_CursorY = y;
+      s_CursorDrawn = true;
+   }
+}
+
+void i686_FBCON_Present(void)
+{
+   if (!s_Active) return;
+
+   for (int row = 0; row < s_Rows; row++)
+   {
+      FbRowSpan *span = &s_Dirty[row];
+      if (!span->dirty) continue;
+      span->dirty = false;
+
+      uint32_t x_bytes = (uint32_t)(span->min_col * FBCON_GLYPH_W) * 4u;
+      uint32_t span_bytes =
+          (uint32_t)((span->max_col - span->min_col + 1) * FBCON_GLYPH_W) * 4u;
+      uint32_t offset = (uint32_t)(row * FBCON_GLYPH_H) * s_Pitch + x_bytes;
+
+      for (int r = 0; r < FBCON_GLYPH_H; r++)
+      {
+         memcpy(s_Lfb + offset, s_Compose + offset, span_bytes);
+         offset += s_Pitch;
+      }
+   }
+}
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef ARCH_I686_VIDEO_FBCON_H
+#define ARCH_I686_VIDEO_FBCON_H
+
+#include <stdint.h>
+
+/* Linear-framebuffer console backend — implementation in fbcon.c.
+ *
+ * This is not a full HAL video backend: the terminal logic (shadow
+ * buffer, ANSI parsing, scroll rotation) stays in vga.c, which routes
+ * its cell output here instead of to text VRAM when a direct-RGB
+ * framebuffer was handed over by the bootloader.  Glyphs are rendered
+ * into an off-screen compose buffer in cached RAM; Present pushes only
+ * the dirty scanline spans to the (uncached) framebuffer. */
+
+/* Detect a usable 32 bpp linear framebuffer in g_SysInfo->boot, map it
+ * and allocate the compose buffer.  The console grid is clamped to
+ * max_cols × max_rows (the caller's shadow-buffer capacity); pixels
+ * beyond it stay background.  Returns SUCCESS when the framebuffer
+ * console is up, a negative errno otherwise (the caller then stays on
+ * VGA text). */
+int i686_FBCON_Probe(int max_cols, int max_rows);
+
+/* Console geometry: width/8 × height/16, clamped as above. */
+int i686_FBCON_Cols(void);
+int i686_FBCON_Rows(void);
+
+/* Render `count` text cells (attr<<8 | char, VGA colour semantics)
+ * into the compose buffer starting at grid cell (col, row). */
+void i686_FBCON_DrawCells(int row, int col, const uint16_t *cells, int count);
+
+/* Shift the compose buffer up one glyph row and clear the exposed
+ * bottom line to `color`'s background; marks the whole surface dirty. */
+void i686_FBCON_ScrollUp(uint8_t color);
+
+/* Move the software cursor (XOR block in the cell's lower scanlines). */
+void i686_FBCON_SetCursor(int x, int y);
+
+/* Copy every dirty scanline span from the compose buffer to the
+ * framebuffer. */
+void i686_FBCON_Present(void);
+
+#endif /* ARCH_I686_VIDEO_FBCON_H */
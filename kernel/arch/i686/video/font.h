@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef ARCH_I686_VIDEO_FONT_H
+#define ARCH_I686_VIDEO_FONT_H
+
+#include <stdint.h>
+
+/* 8×16 bitmap font – one byte per row, 16 rows per glyph.
+ *
+ * Each byte encodes 8 horizontal pixels (MSB = leftmost pixel).
+ * Glyphs are defined for the printable ASCII range 0x20 … 0x7E.
+ *
+ * The table (font_gen.c) is generated at build time by the same
+ * boot/bios/video/mkfont.py the bootloader uses, so both consoles
+ * render from one set of glyph data. */
+
+#define FONT_WIDTH 8
+#define FONT_HEIGHT 16
+#define FONT_FIRST 0x20                       /* first defined glyph (space) */
+#define FONT_LAST 0x7E                        /* last  defined glyph (~) */
+#define FONT_NUM (FONT_LAST - FONT_FIRST + 1) /* 95 glyphs */
+
+/** 8×16 bitmap font table. */
+extern const uint8_t g_Font8x16[FONT_NUM][FONT_HEIGHT];
+
+#endif /* ARCH_I686_VIDEO_FONT_H */
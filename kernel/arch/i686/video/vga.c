@@ -11,8 +11,10 @@
  */
 
 #include "vga.h"
+#include "fbcon.h"
 #include <hal/io.h>
 #include <mem/mm_kernel.h>
+#include <std/compiler.h>
 #include <std/string.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -54,6 +56,8 @@
 #define VGA_CRTC_MAXSCAN 0x09  /* Maximum Scan Line (font height − 1)       */
 #define VGA_CRTC_CURSOR_START 0x0A /* Cursor Scan Line Start               */
 #define VGA_CRTC_CURSOR_END 0x0B   /* Cursor Scan Line End                 */
+#define VGA_CRTC_START_HI 0x0C     /* Start Address High byte              */
+#define VGA_CRTC_START_LO 0x0D     /* Start Address Low  byte              */
 #define VGA_CRTC_CURSOR_HI 0x0E    /* Cursor Location High byte            */
 #define VGA_CRTC_CURSOR_LO 0x0F    /* Cursor Location Low  byte            */
 #define VGA_CRTC_VRSTART 0x10 /* Vertical Retrace Start (low 8 bits)       */
@@ -71,6 +75,12 @@
 
 static int s_VGA_Cols = 80;
 static int s_VGA_Rows = 25;
+
+/* When the bootloader left us in a VBE linear-framebuffer mode, the
+ * terminal logic in this file stays in charge but cell output and the
+ * cursor are routed to the fbcon renderer instead of text VRAM and the
+ * CRT controller. */
+static bool s_FbActive = false;
 static bool s_font_cache_ready = false;
 static uint8_t s_font16[256 * 16];
 static uint8_t s_font8[256 * 8];
@@ -343,13 +353,49 @@ static void vga_prepare_font_cache(void)
    s_font_cache_ready = true;
 }
 
+/* Staged plane-2 image: glyphs laid out in their 32-byte slots exactly
+ * as the character generator wants them, so the upload itself is one
+ * wide copy.  Built at most once per font height; s_uploaded_height
+ * remembers what the hardware already holds so switching between modes
+ * with the same glyph height skips the upload entirely. */
+static uint8_t s_plane_image[256 * VGA_GLYPH_SLOT];
+static int s_plane_image_height = 0;
+static int s_uploaded_height = 0;
+
+static void vga_build_plane_image(int char_height)
+{
+   if (s_plane_image_height == char_height) return;
+
+   memset(s_plane_image, 0, sizeof(s_plane_image));
+   for (int ch = 0; ch < 256; ch++)
+   {
+      uint8_t *slot = &s_plane_image[ch * VGA_GLYPH_SLOT];
+      if (char_height == 8)
+      {
+         memcpy(slot, &s_font8[ch * 8], 8);
+      }
+      else
+      {
+         memcpy(slot, &s_font16[ch * 16], 16);
+      }
+   }
+   s_plane_image_height = char_height;
+}
+
 /*
  * vga_upload_font – upload a character generator into VGA font bank 0.
+ *
+ * No-op when plane 2 already holds this height's font (the common case
+ * for reinitialisations and same-height mode changes); otherwise one
+ * 8 KiB dword copy of the pre-staged image instead of per-byte writes.
  */
 static void vga_upload_font(int char_height)
 {
    vga_prepare_font_cache();
 
+   if (s_uploaded_height == char_height) return;
+   vga_build_plane_image(char_height);
+
    uint8_t s_seq2 = seq_read(0x02);
    uint8_t s_seq4 = seq_read(0x04);
    uint8_t s_gfx4 = gfx_read(0x04);
@@ -362,31 +408,17 @@ static void vga_upload_font(int char_height)
    gfx_write(0x05, 0x00);
    gfx_write(0x06, 0x04);
 
-   volatile uint8_t *plane = VGA_FONT_PLANE;
-   for (int ch = 0; ch < 256; ch++)
-   {
-      uint32_t base = (uint32_t)ch * VGA_GLYPH_SLOT;
-      if (char_height == 8)
-      {
-         for (int row = 0; row < 8; row++)
-            plane[base + (uint32_t)row] = s_font8[ch * 8 + row];
-         for (int row = 8; row < VGA_GLYPH_SLOT; row++)
-            plane[base + (uint32_t)row] = 0x00;
-      }
-      else
-      {
-         for (int row = 0; row < 16; row++)
-            plane[base + (uint32_t)row] = s_font16[ch * 16 + row];
-         for (int row = 16; row < VGA_GLYPH_SLOT; row++)
-            plane[base + (uint32_t)row] = 0x00;
-      }
-   }
+   volatile uint32_t *dst = (volatile uint32_t *)VGA_FONT_PLANE;
+   const uint32_t *src = (const uint32_t *)s_plane_image;
+   for (uint32_t i = 0; i < sizeof(s_plane_image) / 4u; i++) dst[i] = src[i];
 
    seq_write(0x02, s_seq2);
    seq_write(0x04, s_seq4);
    gfx_write(0x04, s_gfx4);
    gfx_write(0x05, s_gfx5);
    gfx_write(0x06, s_gfx6);
+
+   s_uploaded_height = char_height;
 }
 
 static inline void vga_clamp_cursor(void)
@@ -397,18 +429,223 @@ static inline void vga_clamp_cursor(void)
    if (s_TermCursorY >= s_VGA_Rows) s_TermCursorY = s_VGA_Rows - 1;
 }
 
+/* While a stream batch is open (i686_VGA_WriteStream), repaints and
+ * hardware cursor updates are deferred so a whole buffer costs one
+ * vga_present and one CRTC cursor write instead of one per character. */
+static bool s_StreamBatch = false;
+static bool s_StreamDirty = false;
+
+/* Hardware scrolling: logical screen row 0 starts at shadow row
+ * s_TermTopRow and VRAM cell s_VgaStartCell (CRTC start address).  A
+ * scroll advances both instead of copying anything; rows already on
+ * screen keep their shadow storage and their VRAM cells.  When the
+ * window would run off the end of the 32 KiB text VRAM it jumps back to
+ * cell 0 with a full repaint. */
+#define VGA_VRAM_CELLS 16384u
+static int s_TermTopRow = 0;
+static uint32_t s_VgaStartCell = 0;
+static uint32_t s_ProgrammedStartCell = 0;
+
+static inline int vga_phys_row(int row)
+{
+   return (s_TermTopRow + row) % s_VGA_Rows;
+}
+
+/* Shadow storage of logical screen row `row`. */
+static inline uint16_t *vga_row(int row)
+{
+   return s_TermBuffer[vga_phys_row(row)];
+}
+
+static void vga_program_start(void)
+{
+   g_HalIoOperations->outb(VGA_CRTC_ADDR, VGA_CRTC_START_HI);
+   g_HalIoOperations->outb(VGA_CRTC_DATA,
+                           (uint8_t)((s_VgaStartCell >> 8) & 0xFF));
+   g_HalIoOperations->outb(VGA_CRTC_ADDR, VGA_CRTC_START_LO);
+   g_HalIoOperations->outb(VGA_CRTC_DATA, (uint8_t)(s_VgaStartCell & 0xFF));
+   s_ProgrammedStartCell = s_VgaStartCell;
+}
+
+/* The VRAM cell the hardware cursor was last programmed to.  Characters
+ * only move the logical position; the CRTC registers are written here,
+ * alongside vga_present, and only when the cell actually changed —
+ * otherwise every character pays four port writes just for the
+ * cursor. */
+static uint32_t s_ProgrammedCursorCell = 0xFFFFFFFFu;
+
+static void vga_cursor_flush(void)
+{
+   if (s_FbActive)
+   {
+      /* Software cursor: fbcon XORs a block into the compose buffer
+       * and skips the work when the position is unchanged. */
+      i686_FBCON_SetCursor(s_TermCursorX, s_TermCursorY);
+      i686_FBCON_Present();
+      return;
+   }
+
+   uint32_t cell = s_VgaStartCell +
+                   (uint32_t)(s_TermCursorY * s_VGA_Cols + s_TermCursorX);
+   if (cell == s_ProgrammedCursorCell) return;
+   s_ProgrammedCursorCell = cell;
+
+   g_HalIoOperations->outb(VGA_CRTC_ADDR, VGA_CRTC_CURSOR_HI);
+   g_HalIoOperations->outb(VGA_CRTC_DATA, (uint8_t)((cell >> 8) & 0xFF));
+
+   g_HalIoOperations->outb(VGA_CRTC_ADDR, VGA_CRTC_CURSOR_LO);
+   g_HalIoOperations->outb(VGA_CRTC_DATA, (uint8_t)(cell & 0xFF));
+}
+
+/* Per-row dirty flags: vga_present copies only rows touched since the
+ * last present, so echoing a keystroke moves one row over the VGA bus
+ * instead of the whole screen.  Scrolls, clears and mode changes mark
+ * everything dirty.  Flags are indexed by shadow (physical) row so they
+ * follow their content across a scroll rotation. */
+static bool s_RowDirty[VGA_TERM_MAX_ROWS];
+
+/* Scrollback: rows leaving the top of the screen are archived in a
+ * ring instead of discarded.  Shift-PageUp (routed through the TTY)
+ * slides a view window back over the ring; the window is presented by
+ * repointing the row sources in vga_present, never by copying history
+ * around.  Any new output snaps the view back to the live screen. */
+#define VGA_SCROLLBACK_ROWS 256u /* Power of two; ~10 pages of 25 rows */
+static uint16_t s_Scrollback[VGA_SCROLLBACK_ROWS][VGA_TERM_MAX_COLS];
+static uint32_t s_ScrollbackHead = 0;  /* Next slot to overwrite */
+static uint32_t s_ScrollbackCount = 0; /* Valid archived rows */
+static uint32_t s_ViewOffset = 0;      /* Rows scrolled back; 0 = live */
+
+/* Source storage for view row `row`: rows still inside the offset come
+ * from the ring (back = 1 is the newest archived row, sitting directly
+ * above live row 0), the rest from the live shadow buffer. */
+static const uint16_t *vga_view_row(int row)
+{
+   if ((uint32_t)row >= s_ViewOffset)
+   {
+      return s_TermBuffer[vga_phys_row(row - (int)s_ViewOffset)];
+   }
+
+   uint32_t back = s_ViewOffset - (uint32_t)row;
+   uint32_t idx =
+       (s_ScrollbackHead + VGA_SCROLLBACK_ROWS - back) % VGA_SCROLLBACK_ROWS;
+   return s_Scrollback[idx];
+}
+
+static void vga_mark_row_dirty(int row)
+{
+   if (row >= 0 && row < s_VGA_Rows) s_RowDirty[vga_phys_row(row)] = true;
+}
+
+static void vga_mark_all_dirty(void)
+{
+   for (int row = 0; row < VGA_TERM_MAX_ROWS; row++) s_RowDirty[row] = true;
+}
+
+/* Leave history mode; the live rows must repaint over it. */
+static void vga_view_reset(void)
+{
+   if (s_ViewOffset == 0) return;
+   s_ViewOffset = 0;
+   vga_mark_all_dirty();
+}
+
+static void vga_present(void);
+
+static void vga_stream_present(void)
+{
+   if (s_StreamBatch)
+   {
+      s_StreamDirty = true;
+      return;
+   }
+   vga_present();
+}
+
 static void vga_present(void)
 {
    uint16_t blank = ((uint16_t)s_TermColor << 8) | ' ';
 
+   if (s_ViewOffset != 0)
+   {
+      /* History view: the dirty flags track live rows, not the window,
+       * so repaint every row from its (repointed) source.  The flags
+       * keep accumulating; vga_view_reset marks everything dirty on the
+       * way back to the live screen. */
+      static uint16_t line[VGA_TERM_MAX_COLS];
+
+      if (!s_FbActive && s_VgaStartCell != s_ProgrammedStartCell)
+      {
+         vga_program_start();
+      }
+
+      for (int row = 0; row < s_VGA_Rows; row++)
+      {
+         const uint16_t *src = vga_view_row(row);
+         for (int col = 0; col < s_VGA_Cols; col++)
+         {
+            uint16_t cell = src[col];
+            line[col] = cell ? cell : blank;
+         }
+
+         if (s_FbActive)
+         {
+            i686_FBCON_DrawCells(row, 0, line, s_VGA_Cols);
+         }
+         else
+         {
+            volatile uint16_t *dst =
+                &VGA_BUFFER[s_VgaStartCell + (uint32_t)(row * s_VGA_Cols)];
+            for (int col = 0; col < s_VGA_Cols; col++) dst[col] = line[col];
+         }
+      }
+
+      if (s_FbActive) i686_FBCON_Present();
+      /* The hardware cursor stays parked; it belongs to the live page. */
+      return;
+   }
+
+   if (s_FbActive)
+   {
+      static uint16_t line[VGA_TERM_MAX_COLS];
+
+      for (int row = 0; row < s_VGA_Rows; row++)
+      {
+         int phys = vga_phys_row(row);
+         if (!s_RowDirty[phys]) continue;
+         s_RowDirty[phys] = false;
+
+         const uint16_t *src = s_TermBuffer[phys];
+         for (int col = 0; col < s_VGA_Cols; col++)
+         {
+            uint16_t cell = src[col];
+            line[col] = cell ? cell : blank;
+         }
+         i686_FBCON_DrawCells(row, 0, line, s_VGA_Cols);
+      }
+      i686_FBCON_SetCursor(s_TermCursorX, s_TermCursorY);
+      i686_FBCON_Present();
+      return;
+   }
+
+   if (s_VgaStartCell != s_ProgrammedStartCell) vga_program_start();
+
    for (int row = 0; row < s_VGA_Rows; row++)
    {
+      int phys = vga_phys_row(row);
+      if (!s_RowDirty[phys]) continue;
+      s_RowDirty[phys] = false;
+
+      const uint16_t *src = s_TermBuffer[phys];
+      volatile uint16_t *dst =
+          &VGA_BUFFER[s_VgaStartCell + (uint32_t)(row * s_VGA_Cols)];
       for (int col = 0; col < s_VGA_Cols; col++)
       {
-         uint16_t cell = s_TermBuffer[row][col];
-         VGA_BUFFER[row * s_VGA_Cols + col] = cell ? cell : blank;
+         uint16_t cell = src[col];
+         dst[col] = cell ? cell : blank;
       }
    }
+
+   vga_cursor_flush();
 }
 
 static void vga_reset_terminal_state(uint8_t color)
@@ -422,17 +659,72 @@ static void vga_reset_terminal_state(uint8_t color)
    s_AnsiState = 0;
    s_AnsiParamCount = 0;
    memset(s_AnsiParams, 0, sizeof(s_AnsiParams));
+   s_TermTopRow = 0;
+   s_VgaStartCell = 0;
+   s_ViewOffset = 0;
+   vga_mark_all_dirty();
 }
 
 static void vga_scroll_up(void)
 {
    if (s_VGA_Rows <= 1) return;
 
-   memmove(s_TermBuffer[0], s_TermBuffer[1],
-           (size_t)(s_VGA_Rows - 1) * VGA_TERM_MAX_COLS * sizeof(uint16_t));
-   memset(s_TermBuffer[s_VGA_Rows - 1], 0,
+   /* Rotate instead of copying: the old top row becomes the new bottom
+      row and is cleared; everything else keeps its storage. */
+   s_TermTopRow = (s_TermTopRow + 1) % s_VGA_Rows;
+
+   /* The departing top row's storage is about to be recycled as the
+      new bottom row; archive its contents in the scrollback ring. */
+   memcpy(s_Scrollback[s_ScrollbackHead], vga_row(s_VGA_Rows - 1),
+          (size_t)VGA_TERM_MAX_COLS * sizeof(uint16_t));
+   s_ScrollbackHead = (s_ScrollbackHead + 1) % VGA_SCROLLBACK_ROWS;
+   if (s_ScrollbackCount < VGA_SCROLLBACK_ROWS) s_ScrollbackCount++;
+
+   memset(vga_row(s_VGA_Rows - 1), 0,
           (size_t)VGA_TERM_MAX_COLS * sizeof(uint16_t));
    s_TermCursorY = s_VGA_Rows - 1;
+
+   if (s_FbActive)
+   {
+      /* No CRTC start-address trick on a framebuffer: shift the
+         compose buffer instead, so only the new bottom row needs a
+         re-render before the (full-height) push. */
+      i686_FBCON_ScrollUp(s_TermColor);
+      vga_mark_row_dirty(s_VGA_Rows - 1);
+      return;
+   }
+
+   /* Advance the CRTC start address one row in step, so rows already on
+      screen keep their VRAM cells and only the new bottom row needs a
+      repaint; wrap back to cell 0 (full repaint) at the end of VRAM. */
+   s_VgaStartCell += (uint32_t)s_VGA_Cols;
+   if (s_VgaStartCell + (uint32_t)(s_VGA_Rows * s_VGA_Cols) > VGA_VRAM_CELLS)
+   {
+      s_VgaStartCell = 0;
+      vga_mark_all_dirty();
+   }
+   else
+   {
+      vga_mark_row_dirty(s_VGA_Rows - 1);
+   }
+}
+
+/* Put the shadow buffer back into physical order (s_TermTopRow == 0).
+ * Only needed on the rare mode change, where the row count the rotation
+ * is taken modulo changes; scroll performance does not depend on it. */
+static void vga_unrotate(void)
+{
+   uint16_t tmp[VGA_TERM_MAX_COLS];
+
+   while (s_TermTopRow != 0)
+   {
+      memcpy(tmp, s_TermBuffer[0], sizeof(tmp));
+      memmove(s_TermBuffer[0], s_TermBuffer[1],
+              (size_t)(s_VGA_Rows - 1) * VGA_TERM_MAX_COLS *
+                  sizeof(uint16_t));
+      memcpy(s_TermBuffer[s_VGA_Rows - 1], tmp, sizeof(tmp));
+      s_TermTopRow = (s_TermTopRow + s_VGA_Rows - 1) % s_VGA_Rows;
+   }
 }
 
 static void vga_handle_ansi_sgr(void)
@@ -517,12 +809,13 @@ static void vga_handle_ansi_command(char cmd)
          memset(s_TermBuffer, 0, sizeof(s_TermBuffer));
          s_TermCursorX = 0;
          s_TermCursorY = 0;
-         vga_present();
+         vga_mark_all_dirty();
+         vga_stream_present();
       }
       break;
    case 'K':
    {
-      uint16_t *row = s_TermBuffer[s_TermCursorY];
+      uint16_t *row = vga_row(s_TermCursorY);
 
       if (n == 0)
          memset(&row[s_TermCursorX], 0,
@@ -532,7 +825,8 @@ static void vga_handle_ansi_command(char cmd)
       else
          memset(row, 0, (size_t)s_VGA_Cols * sizeof(uint16_t));
 
-      vga_present();
+      vga_mark_row_dirty(s_TermCursorY);
+      vga_stream_present();
       break;
    }
    case 'm':
@@ -611,7 +905,7 @@ static void vga_stream_put_char(char c)
 
    if (vga_process_ansi(c) == 0)
    {
-      i686_VGA_SetCursor(s_TermCursorX, s_TermCursorY);
+      if (!s_StreamBatch) vga_cursor_flush();
       return;
    }
 
@@ -639,18 +933,20 @@ static void vga_stream_put_char(char c)
    {
       if (s_TermCursorX > 0)
       {
+         uint16_t *row = vga_row(s_TermCursorY);
          s_TermCursorX--;
-         memmove(&s_TermBuffer[s_TermCursorY][s_TermCursorX],
-                 &s_TermBuffer[s_TermCursorY][s_TermCursorX + 1],
+         memmove(&row[s_TermCursorX], &row[s_TermCursorX + 1],
                  (size_t)(s_VGA_Cols - s_TermCursorX - 1) * sizeof(uint16_t));
-         s_TermBuffer[s_TermCursorY][s_VGA_Cols - 1] = 0;
+         row[s_VGA_Cols - 1] = 0;
+         vga_mark_row_dirty(s_TermCursorY);
          repaint = true;
       }
    }
    else if ((unsigned char)c >= 0x20)
    {
-      s_TermBuffer[s_TermCursorY][s_TermCursorX] =
+      vga_row(s_TermCursorY)[s_TermCursorX] =
           ((uint16_t)s_TermColor << 8) | (uint8_t)c;
+      vga_mark_row_dirty(s_TermCursorY);
       s_TermCursorX++;
 
       if (s_TermCursorX >= s_VGA_Cols)
@@ -663,8 +959,10 @@ static void vga_stream_put_char(char c)
       repaint = true;
    }
 
-   if (repaint) vga_present();
-   i686_VGA_SetCursor(s_TermCursorX, s_TermCursorY);
+   /* vga_present flushes the cursor itself; only a pure cursor motion
+    * ('\r', backspace at column 0) needs an explicit flush. */
+   if (repaint) vga_stream_present();
+   else if (!s_StreamBatch) vga_cursor_flush();
 }
 
 /* ── Backend implementation ──────────────────────────────────────────────── */
@@ -678,8 +976,32 @@ static void vga_stream_put_char(char c)
  *   - Register 0x0B (Cursor End):   scan line 15.
  * Then homes the cursor to (0, 0).
  */
-void i686_VGA_Initialize(void)
+KCOLD void i686_VGA_Initialize(void)
 {
+   /* Prefer the linear framebuffer when the bootloader set a VBE mode:
+    * in that case text VRAM is not scanned out at all, and a composed
+    * blit beats VGA plane I/O anyway.  The grid is clamped to the
+    * shadow buffer's capacity; a 1280×800 mode maps exactly onto the
+    * 160×50 maximum. */
+   if (i686_FBCON_Probe(VGA_TERM_MAX_COLS, VGA_TERM_MAX_ROWS) == 0)
+   {
+      s_FbActive = true;
+
+      /* Early boot output is already in the shadow buffer; carry it
+       * over to the framebuffer instead of clearing.  The rotation is
+       * taken modulo the row count, so settle the buffer into physical
+       * order before the dimensions change. */
+      vga_unrotate();
+      s_VgaStartCell = 0;
+      s_VGA_Cols = i686_FBCON_Cols();
+      s_VGA_Rows = i686_FBCON_Rows();
+      vga_clamp_cursor();
+      vga_mark_all_dirty();
+      vga_present();
+      i686_VGA_SetCursor(s_TermCursorX, s_TermCursorY);
+      return;
+   }
+
    /* Cursor Start: enable cursor (bit 5 = 0), start scan line 14 */
    g_HalIoOperations->outb(VGA_CRTC_ADDR, VGA_CRTC_CURSOR_START);
    g_HalIoOperations->outb(VGA_CRTC_DATA, 0x0E);
@@ -691,6 +1013,7 @@ void i686_VGA_Initialize(void)
    s_VGA_Cols = 80;
    s_VGA_Rows = 25;
    vga_reset_terminal_state(0x07);
+   vga_program_start(); /* BIOS may leave a nonzero start address */
    vga_present();
    i686_VGA_SetCursor(0, 0);
 }
@@ -707,6 +1030,10 @@ void i686_VGA_Initialize(void)
  */
 int i686_VGA_SetDisplaySize(int cols, int rows)
 {
+   /* The framebuffer resolution is fixed by the bootloader's mode set;
+    * there is no text-mode reprogramming to do. */
+   if (s_FbActive) return -1;
+
    /* ── 1. Find the requested mode ───────────────────────── */
    const VGA_ModeDesc *mode = (void *)0;
    for (int i = 0; i < VGA_MODE_COUNT; i++)
@@ -776,10 +1103,21 @@ int i686_VGA_SetDisplaySize(int cols, int rows)
     * registers, font data, and the PAS latch are fully settled.        */
    seq_write(0x00, 0x03);
 
-   /* ── 11. Update tracked dimensions ─────────────────────── */
+   /* ── 11. Update tracked dimensions ───────────────────────
+    * The scroll rotation is taken modulo the row count, so settle the
+    * shadow buffer into physical order and restart the scroll window at
+    * VRAM cell 0 before the dimensions change. */
+   vga_unrotate();
+   s_VgaStartCell = 0;
    s_VGA_Cols = cols;
    s_VGA_Rows = rows;
+   /* Archived rows were captured at the old width; drop them rather
+      than present misaligned history. */
+   s_ScrollbackHead = 0;
+   s_ScrollbackCount = 0;
+   s_ViewOffset = 0;
    vga_clamp_cursor();
+   vga_mark_all_dirty();
    vga_present();
    i686_VGA_SetCursor(s_TermCursorX, s_TermCursorY);
 
@@ -792,32 +1130,76 @@ int i686_VGA_SetDisplaySize(int cols, int rows)
  * In stream mode (x/y < 0) this routes through the internal terminal parser,
  * including ANSI handling and cursor movement.
  */
-void i686_VGA_PutChar(char c, uint8_t color, int x, int y)
+/* External colour (TTY default) should not clobber active ANSI colour
+ * on each character.  Only adopt it when the caller changes it. */
+static void vga_stream_adopt_color(uint8_t color)
 {
-   if (x < 0 || y < 0)
+   if (color != s_TermInputColor)
    {
-      /* External colour (TTY default) should not clobber active ANSI colour
-       * on each character.  Only adopt it when the caller changes it. */
-      if (color != s_TermInputColor)
+      s_TermInputColor = color;
+      s_TermDefaultColor = color;
+      if (s_AnsiState == 0)
       {
-         s_TermInputColor = color;
-         s_TermDefaultColor = color;
-         if (s_AnsiState == 0)
-         {
-            s_TermColor = color;
-         }
+         s_TermColor = color;
       }
+   }
+}
+
+void i686_VGA_PutChar(char c, uint8_t color, int x, int y)
+{
+   vga_view_reset();
+
+   if (x < 0 || y < 0)
+   {
+      vga_stream_adopt_color(color);
       vga_stream_put_char(c);
       return;
    }
 
    if (x >= s_VGA_Cols || y >= s_VGA_Rows) return;
 
-   VGA_BUFFER[y * s_VGA_Cols + x] = ((uint16_t)color << 8) | (uint8_t)c;
+   uint16_t cell = ((uint16_t)color << 8) | (uint8_t)c;
+
+   if (s_FbActive)
+   {
+      vga_row(y)[x] = cell;
+      i686_FBCON_DrawCells(y, x, &cell, 1);
+      i686_FBCON_Present();
+      return;
+   }
+
+   VGA_BUFFER[s_VgaStartCell + (uint32_t)(y * s_VGA_Cols + x)] = cell;
    if (x < VGA_TERM_MAX_COLS && y < VGA_TERM_MAX_ROWS)
    {
-      s_TermBuffer[y][x] = ((uint16_t)color << 8) | (uint8_t)c;
+      vga_row(y)[x] = cell;
+   }
+}
+
+/*
+ * VGA_WriteStream — run a whole buffer through the terminal parser.
+ *
+ * Equivalent to calling VGA_PutChar in stream mode per character, but the
+ * VRAM repaint and the CRTC cursor programming are deferred until the end
+ * of the buffer, so large writes cost one present instead of one per
+ * printable character.
+ */
+void i686_VGA_WriteStream(const char *data, uint32_t len, uint8_t color)
+{
+   if (!data || len == 0) return;
+
+   vga_view_reset();
+   vga_stream_adopt_color(color);
+
+   s_StreamBatch = true;
+   s_StreamDirty = false;
+   for (uint32_t i = 0; i < len; i++)
+   {
+      vga_stream_put_char(data[i]);
    }
+   s_StreamBatch = false;
+
+   if (s_StreamDirty) vga_present();
+   else vga_cursor_flush();
 }
 
 /*
@@ -851,13 +1233,7 @@ void i686_VGA_SetCursor(int x, int y)
    s_TermCursorX = x;
    s_TermCursorY = y;
 
-   uint16_t pos = (uint16_t)(y * s_VGA_Cols + x);
-
-   g_HalIoOperations->outb(VGA_CRTC_ADDR, VGA_CRTC_CURSOR_HI);
-   g_HalIoOperations->outb(VGA_CRTC_DATA, (uint8_t)((pos >> 8) & 0xFF));
-
-   g_HalIoOperations->outb(VGA_CRTC_ADDR, VGA_CRTC_CURSOR_LO);
-   g_HalIoOperations->outb(VGA_CRTC_DATA, (uint8_t)(pos & 0xFF));
+   vga_cursor_flush();
 }
 
 void i686_VGA_GetCursor(int *x, int *y)
@@ -865,3 +1241,84 @@ void i686_VGA_GetCursor(int *x, int *y)
    if (x) *x = s_TermCursorX;
    if (y) *y = s_TermCursorY;
 }
+
+/*
+ * VGA_Scrollback — move the view window over the scrollback ring.
+ *
+ * dir > 0 pages toward older output, dir < 0 toward the live screen,
+ * dir == 0 jumps straight back to live.  Presentation repoints the row
+ * sources (vga_view_row); nothing in the ring is copied or reordered.
+ */
+void i686_VGA_Scrollback(int dir)
+{
+   uint32_t page = (uint32_t)(s_VGA_Rows > 1 ? s_VGA_Rows - 1 : 1);
+   uint32_t offset = s_ViewOffset;
+
+   if (dir > 0)
+   {
+      offset += page;
+      if (offset > s_ScrollbackCount) offset = s_ScrollbackCount;
+   }
+   else if (dir < 0)
+   {
+      offset = (offset > page) ? offset - page : 0;
+   }
+   else
+   {
+      offset = 0;
+   }
+
+   if (offset == s_ViewOffset) return;
+
+   s_ViewOffset = offset;
+   if (offset == 0) vga_mark_all_dirty();
+   vga_present();
+}
+
+/*
+ * VGA_SaveText / VGA_RestoreText — whole-screen snapshot and repaint
+ * for virtual-console switching.
+ *
+ * The TTY layer keeps one cols×rows cell image per virtual console:
+ * switching a console out copies the live shadow rows into its image,
+ * switching one in repaints from its image with a single present.
+ * Cells use the shadow encoding (0 = blank in the current colour); any
+ * area outside the current mode is saved and restored as blank.
+ */
+void i686_VGA_SaveText(uint16_t *cells, int cols, int rows)
+{
+   if (!cells) return;
+
+   for (int y = 0; y < rows; y++)
+   {
+      const uint16_t *src = (y < s_VGA_Rows) ? vga_row(y) : NULL;
+      for (int x = 0; x < cols; x++)
+      {
+         cells[y * cols + x] = (src && x < s_VGA_Cols) ? src[x] : 0;
+      }
+   }
+}
+
+void i686_VGA_RestoreText(const uint16_t *cells, int cols, int rows)
+{
+   if (!cells) return;
+
+   vga_view_reset();
+
+   /* The stream parser must not carry a half-read escape sequence from
+      the console that was just switched away. */
+   s_AnsiState = 0;
+   s_AnsiParamCount = 0;
+
+   for (int y = 0; y < s_VGA_Rows; y++)
+   {
+      uint16_t *dst = vga_row(y);
+      for (int x = 0; x < s_VGA_Cols; x++)
+      {
+         dst[x] = (y < rows && x < cols) ? cells[y * cols + x] : 0;
+      }
+   }
+
+   vga_mark_all_dirty();
+   vga_present();
+}
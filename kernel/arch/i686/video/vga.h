@@ -11,9 +11,13 @@
 
 void i686_VGA_Initialize(void);
 void i686_VGA_PutChar(char c, uint8_t color, int x, int y);
+void i686_VGA_WriteStream(const char *data, uint32_t len, uint8_t color);
 void i686_VGA_Clear(uint8_t color);
 void i686_VGA_SetCursor(int x, int y);
 void i686_VGA_GetCursor(int *x, int *y);
+void i686_VGA_Scrollback(int dir);
+void i686_VGA_SaveText(uint16_t *cells, int cols, int rows);
+void i686_VGA_RestoreText(const uint16_t *cells, int cols, int rows);
 
 /**
  * Switch to a supported VGA text mode.
@@ -1,5 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include "kinfo.h"
+#include "kstack.h"
 #include "process.h"
 #include "scheduler.h"
 #include <constants.h>
@@ -9,6 +11,7 @@
 #include <hal/tss.h>
 #include <mem/mm_kernel.h>
 #include <mem/mm_proc.h>
+#include <signal/signal.h>
 #include <std/stdio.h>
 #include <std/string.h>
 #include <sys/elf.h>
@@ -19,11 +22,15 @@ static void *g_KernelPageDirectory = NULL;
 
 int Process_InitializeStandardIO(Process *proc)
 {
-   if (!proc) return -1;
+   if (!proc || !proc->fd_table) return -1;
 
    for (int fd = 0; fd < 3; ++fd)
    {
-      if (proc->fd_table[fd]) continue;
+      if (proc->fd_table->entries[fd]) continue;
+
+      /* Adding a descriptor mutates the table; give this process its
+         own copy if fork siblings still share it. */
+      if (FD_TableUnshare(proc) < 0) return -1;
 
       FileDescriptor *tty_fd =
           (FileDescriptor *)kmalloc(sizeof(FileDescriptor));
@@ -42,42 +49,112 @@ int Process_InitializeStandardIO(Process *proc)
          return -1;
       }
 
-      proc->fd_table[fd] = tty_fd;
+      proc->fd_table->entries[fd] = tty_fd;
+      proc->fd_table->bitmap |= (1u << fd);
    }
 
    return 0;
 }
 
-static Process *find_process_by_pid(uint32_t pid)
+/* PID hash table.  Chained buckets keyed by the low pid bits; pids are
+ * allocated sequentially, so consecutive processes land in consecutive
+ * buckets and chains stay short. */
+#define PID_HASH_BUCKETS 64u
+
+static Process *g_PidHash[PID_HASH_BUCKETS];
+
+static inline uint32_t pid_hash(uint32_t pid)
 {
-   uint32_t count = Scheduler_GetProcessCount();
-   for (uint32_t i = 0; i < count; ++i)
+   return pid & (PID_HASH_BUCKETS - 1);
+}
+
+void Process_PidHashInsert(Process *proc)
+{
+   if (!proc) return;
+
+   uint32_t bucket = pid_hash(proc->pid);
+   proc->pid_hash_next = g_PidHash[bucket];
+   g_PidHash[bucket] = proc;
+}
+
+void Process_PidHashRemove(Process *proc)
+{
+   if (!proc) return;
+
+   Process **link = &g_PidHash[pid_hash(proc->pid)];
+   while (*link && *link != proc) link = &(*link)->pid_hash_next;
+   if (*link) *link = proc->pid_hash_next;
+   proc->pid_hash_next = NULL;
+}
+
+Process *Process_FindByPid(uint32_t pid)
+{
+   for (Process *p = g_PidHash[pid_hash(pid)]; p; p = p->pid_hash_next)
    {
-      Process *candidate = Scheduler_GetProcessAt(i);
-      if (candidate && candidate->pid == pid) return candidate;
+      if (p->pid == pid) return p;
    }
-
    return NULL;
 }
 
-static int process_matches_wait_target(const Process *child,
-                                       uint32_t parent_pid, int32_t pid)
+void Process_ChildLink(Process *parent, Process *child)
 {
-   if (!child) return -1;
-   if (child->ppid != parent_pid) return -1;
-   if (pid > 0 && child->pid != (uint32_t)pid) return -1;
-   return 0;
+   if (!parent || !child) return;
+
+   child->child_sibling = parent->child_head;
+   parent->child_head = child;
+}
+
+void Process_ChildUnlink(Process *parent, Process *child)
+{
+   if (!parent || !child) return;
+
+   Process **link = &parent->child_head;
+   while (*link && *link != child) link = &(*link)->child_sibling;
+   if (*link) *link = child->child_sibling;
+   child->child_sibling = NULL;
 }
 
 static void free_kernel_stack(Process *proc)
 {
    if (!proc || !proc->kernel_stack) return;
 
-   free(proc->kernel_stack);
+   KStack_Free(proc->kernel_stack, proc->kernel_stack_size);
    proc->kernel_stack = NULL;
    proc->kernel_stack_size = 0;
 }
 
+/* Frames gathered per flush while walking a dying address space; sized
+ * to cover a full user stack in one batch. */
+#define TEARDOWN_FREE_BATCH 64
+
+/* Release one mapped range: collect the backing frames during the walk
+ * and hand them to the PMM in batches, then drop the mappings with one
+ * batched-TLB unmap.  Teardown latency gates fork-per-request services,
+ * so the per-frame call overhead matters here. */
+static void cleanup_user_range(Process *proc, uint32_t start, uint32_t pages)
+{
+   uint32_t batch[TEARDOWN_FREE_BATCH];
+   uint32_t batched = 0;
+
+   for (uint32_t i = 0; i < pages; ++i)
+   {
+      uint32_t va = start + (i * PAGE_SIZE);
+      uint32_t phys = g_HalPagingOperations->GetPhysicalAddress(
+          proc->page_directory, va);
+      if (!phys) continue;
+
+      batch[batched++] = phys;
+      if (batched == TEARDOWN_FREE_BATCH)
+      {
+         PMM_FreePageArray(batch, batched);
+         batched = 0;
+      }
+   }
+   if (batched > 0) PMM_FreePageArray(batch, batched);
+
+   g_HalPagingOperations->UnmapRange(proc->page_directory, start, pages);
+}
+
 static void cleanup_user_address_space(Process *proc)
 {
    if (!proc || !proc->page_directory) return;
@@ -85,14 +162,7 @@ static void cleanup_user_address_space(Process *proc)
    if (proc->stack_start && proc->stack_end)
    {
       uint32_t pages = (proc->stack_end - proc->stack_start) / PAGE_SIZE;
-      for (uint32_t i = 0; i < pages; ++i)
-      {
-         uint32_t va = proc->stack_start + (i * PAGE_SIZE);
-         uint32_t phys = g_HalPagingOperations->GetPhysicalAddress(
-             proc->page_directory, va);
-         g_HalPagingOperations->UnmapPage(proc->page_directory, va);
-         if (phys) PMM_FreePhysicalPage(phys);
-      }
+      cleanup_user_range(proc, proc->stack_start, pages);
    }
 
    uint32_t tramp_phys = g_HalPagingOperations->GetPhysicalAddress(
@@ -108,15 +178,12 @@ static void cleanup_user_address_space(Process *proc)
    {
       uint32_t heap_pages =
           (proc->heap_end - proc->heap_start + PAGE_SIZE - 1) / PAGE_SIZE;
-      for (uint32_t i = 0; i < heap_pages; ++i)
-      {
-         uint32_t va = proc->heap_start + (i * PAGE_SIZE);
-         uint32_t phys = g_HalPagingOperations->GetPhysicalAddress(
-             proc->page_directory, va);
-         g_HalPagingOperations->UnmapPage(proc->page_directory, va);
-         if (phys) PMM_FreePhysicalPage(phys);
-      }
+      cleanup_user_range(proc, proc->heap_start, heap_pages);
    }
+
+   /* Heap pages compressed out while the process idled have no frame
+    * behind their PTEs; release their store slots directly. */
+   ZStore_DropDirectory(proc->page_directory);
 }
 
 uint32_t Process_AllocatePid(void) { return g_NextPid++; }
@@ -138,18 +205,48 @@ void Process_Destroy(Process *proc)
 {
    if (!proc) return;
 
+   /* Leave the parent's child list, and orphan any children still on
+    * our own (their ppid keeps its historical value, as before, but
+    * the sibling links must not dangle). */
+   Process_ChildUnlink(Process_FindByPid(proc->ppid), proc);
+   while (proc->child_head)
+   {
+      Process *child = proc->child_head;
+      proc->child_head = child->child_sibling;
+      child->child_sibling = NULL;
+   }
+
    Scheduler_UnregisterProcess(proc);
 
-   if (!proc->kernel_mode) cleanup_user_address_space(proc);
+   if (!proc->kernel_mode)
+   {
+      Process_ReleaseMappings(proc);
+      cleanup_user_address_space(proc);
+   }
 
    if (proc->page_directory && !proc->kernel_mode)
    {
+      VMM_DestroySpace(proc->page_directory);
       g_HalPagingOperations->DestroyPageDirectory(proc->page_directory);
    }
 
+   if (proc->exec_file)
+   {
+      VFS_Close(proc->exec_file);
+      proc->exec_file = NULL;
+   }
+
    FD_CloseAll(proc);
    free_kernel_stack(proc);
 
+   /* Lazy FPU ownership is tracked by PID (never reused), so the
+      buffer can go without notifying the arch layer. */
+   if (proc->fpu_state)
+   {
+      free(proc->fpu_state);
+      proc->fpu_state = NULL;
+   }
+
    if (g_CurrentProcess == proc)
    {
       g_CurrentProcess = NULL;
@@ -173,50 +270,83 @@ void Process_Exit(Process *proc, int exit_code)
 
    proc->exit_code = exit_code;
    proc->state = STATE_ZOMBIE;
+   Scheduler_UpdateRunnable(proc);
 
-   Process *parent = find_process_by_pid(proc->ppid);
-   if (parent && parent->state == STATE_WAITING)
+   Process *parent = Process_FindByPid(proc->ppid);
+   if (parent)
    {
-      parent->state = STATE_READY;
+      /* POSIX child-exit notification.  Dropped at send time while the
+         parent keeps the default disposition, so only parents that
+         installed a handler ever see it. */
+      Signal_Send(parent, SIGCHLD);
+
+      if (parent->state == STATE_WAITING)
+      {
+         parent->state = STATE_READY;
+         Scheduler_UpdateRunnable(parent);
+      }
    }
 }
 
 int Process_Wait(Process *parent, int32_t pid, int *status, int options)
 {
-   (void)options;
-
    if (!parent) return -EINVAL;
 
    for (;;)
    {
       bool has_child = false;
-      uint32_t count = Scheduler_GetProcessCount();
+      Process *zombie = NULL;
 
-      for (uint32_t i = 0; i < count; ++i)
+      /* Only this parent's children live on the list, so each pass is
+       * O(children of this process), not O(all processes). */
+      for (Process *child = parent->child_head; child;
+           child = child->child_sibling)
       {
-         Process *child = Scheduler_GetProcessAt(i);
-         if (process_matches_wait_target(child, parent->pid, pid) < 0) continue;
+         if (pid > 0 && child->pid != (uint32_t)pid) continue;
 
          has_child = true;
-         if (child->state != STATE_ZOMBIE) continue;
+         if (child->state == STATE_ZOMBIE)
+         {
+            zombie = child;
+            break;
+         }
+      }
+
+      if (zombie)
+      {
+         int child_status = zombie->exit_code;
+         uint32_t child_pid = zombie->pid;
 
-         int child_status = child->exit_code;
-         uint32_t child_pid = child->pid;
+         /* Capture the child's CPU times before the struct goes away;
+          * wait4 reads them back for rusage. */
+         parent->reaped_user_ticks = zombie->cpu_user_ticks;
+         parent->reaped_system_ticks = zombie->cpu_system_ticks;
 
-         Process_Destroy(child);
+         Process_Destroy(zombie);
 
          if (status) *status = child_status;
          parent->state = STATE_RUNNING;
+         Scheduler_UpdateRunnable(parent);
          return (int)child_pid;
       }
 
       if (!has_child)
       {
          parent->state = STATE_RUNNING;
+         Scheduler_UpdateRunnable(parent);
          return -ECHILD;
       }
 
+      if (options & WNOHANG)
+      {
+         /* Children exist but none has exited; report without blocking. */
+         parent->state = STATE_RUNNING;
+         Scheduler_UpdateRunnable(parent);
+         return 0;
+      }
+
       parent->state = STATE_WAITING;
+      Scheduler_UpdateRunnable(parent);
       if (g_HalSchedulerOperations && g_HalSchedulerOperations->ContextSwitch)
       {
          g_HalSchedulerOperations->ContextSwitch();
@@ -232,6 +362,7 @@ void Process_BlockOn(Process *proc, void *wait_channel)
 
    proc->wait_channel = wait_channel;
    proc->state = STATE_BLOCKED;
+   Scheduler_UpdateRunnable(proc);
 }
 
 void Process_Unblock(Process *proc)
@@ -242,6 +373,7 @@ void Process_Unblock(Process *proc)
    if (proc->state == STATE_BLOCKED)
    {
       proc->state = (proc == g_CurrentProcess) ? STATE_RUNNING : STATE_READY;
+      Scheduler_UpdateRunnable(proc);
    }
 }
 
@@ -259,6 +391,11 @@ void Process_WakeByChannel(void *wait_channel)
 
       proc->wait_channel = NULL;
       proc->state = (proc == g_CurrentProcess) ? STATE_RUNNING : STATE_READY;
+      /* Wake-up boost: a process leaving an I/O wait is most likely
+       * latency-sensitive (keystroke, disk completion), so let it run
+       * from the interactive class for its next few picks. */
+      proc->sched_boost = PROCESS_WAKE_BOOST;
+      Scheduler_UpdateRunnable(proc);
    }
 }
 
@@ -283,6 +420,10 @@ void Process_SetCurrent(Process *proc)
          uint32_t esp0 = (uint32_t)proc->kernel_stack + proc->kernel_stack_size;
          g_HalTssOperations->SetKernelStack(esp0);
       }
+
+      /* Keep the shared info page's per-process fields current (one
+         CPU, so the page always describes whoever runs next). */
+      KInfo_PublishProcess(proc->pid, proc->ppid);
    }
    else
    {
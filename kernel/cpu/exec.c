@@ -1,228 +1,132 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "process.h"
+#include <cpu/execcache.h>
+#include <cpu/kinfo.h>
+#include <hal/fpu.h>
 #include <hal/mem.h>
 #include <hal/scheduler.h>
 #include <mem/mm_kernel.h>
 #include <mem/mm_proc.h>
+#include <std/minmax.h>
 #include <std/stdio.h>
 #include <std/string.h>
-
-typedef struct
-{
-   unsigned char e_ident[16];
-   uint16_t e_type;
-   uint16_t e_machine;
-   uint32_t e_version;
-   uint32_t e_entry;
-   uint32_t e_phoff;
-   uint32_t e_shoff;
-   uint32_t e_flags;
-   uint16_t e_ehsize;
-   uint16_t e_phentsize;
-   uint16_t e_phnum;
-   uint16_t e_shentsize;
-   uint16_t e_shnum;
-   uint16_t e_shstrndx;
-} __attribute__((packed)) Elf32_Ehdr;
-
-typedef struct
-{
-   uint32_t p_type;
-   uint32_t p_offset;
-   uint32_t p_vaddr;
-   uint32_t p_paddr;
-   uint32_t p_filesz;
-   uint32_t p_memsz;
-   uint32_t p_flags;
-   uint32_t p_align;
-} __attribute__((packed)) Elf32_Phdr;
-
-#define EI_MAG0 0
-#define EI_MAG1 1
-#define EI_MAG2 2
-#define EI_MAG3 3
-#define ELFMAG0 0x7f
-#define ELFMAG1 'E'
-#define ELFMAG2 'L'
-#define ELFMAG3 'F'
-#define ELFCLASS32 1
-#define ELFDATA2LSB 1
-#define EM_386 3
-#define PT_LOAD 1
+#include <sys/elf.h>
 
 #define EXEC_MAX_ARGS 64
 #define EXEC_MAX_ENVP 64
 #define EXEC_MAX_STR 4096
 
-static int map_user_trampoline(Process *proc)
+/* The exit trampoline is two bytes of identical code in every process,
+ * so one frame is built on first use and shared by all address spaces,
+ * the same scheme as the kinfo page below.  Saves an allocation, a
+ * directory switch and a page of RAM per exec. */
+static uint32_t trampoline_frame(void)
 {
-   uint32_t phys = PMM_AllocatePhysicalPage();
-   if (!phys) return -1;
+   static uint32_t frame = 0;
+   if (frame) return frame;
 
-   if (g_HalPagingOperations->MapPage(
-           proc->page_directory, USER_EXIT_TRAMPOLINE_VA, phys,
-           HAL_PAGE_PRESENT | HAL_PAGE_RW | HAL_PAGE_USER) < 0)
-   {
-      PMM_FreePhysicalPage(phys);
-      return -1;
-   }
+   uint32_t phys = PMM_AllocateZeroedPage();
+   if (!phys) return 0;
 
-   void *kernel_pd = Process_GetKernelPageDirectory();
-   if (!kernel_pd) kernel_pd = g_HalPagingOperations->GetCurrentPageDirectory();
-
-   g_HalPagingOperations->SwitchPageDirectory(proc->page_directory);
-   memset((void *)USER_EXIT_TRAMPOLINE_VA, 0, PAGE_SIZE);
-   ((uint8_t *)USER_EXIT_TRAMPOLINE_VA)[0] = 0xEB;
-   ((uint8_t *)USER_EXIT_TRAMPOLINE_VA)[1] = 0xFE;
-   g_HalPagingOperations->SwitchPageDirectory(kernel_pd);
+   /* jmp $ - parks the thread until exit tears the process down. */
+   uint8_t *code = (uint8_t *)phys; /* Identity-mapped */
+   code[0] = 0xEB;
+   code[1] = 0xFE;
 
-   return 0;
+   frame = phys;
+   return frame;
 }
 
-static int load_header(VFS_File *file, Elf32_Ehdr *ehdr)
+static int map_user_trampoline(Process *proc)
 {
-   if (VFS_Seek(file, 0) < 0) return -1;
-
-   if (VFS_Read(file, sizeof(*ehdr), ehdr) != sizeof(*ehdr)) return -1;
-
-   if (ehdr->e_ident[EI_MAG0] != ELFMAG0 || ehdr->e_ident[EI_MAG1] != ELFMAG1 ||
-       ehdr->e_ident[EI_MAG2] != ELFMAG2 || ehdr->e_ident[EI_MAG3] != ELFMAG3)
-   {
-      return -1;
-   }
-
-   if (ehdr->e_ident[4] != ELFCLASS32 || ehdr->e_ident[5] != ELFDATA2LSB)
+   uint32_t frame = trampoline_frame();
+   if (!frame) return -1;
+
+   /* Read-only: the content is shared, and nothing legitimate writes
+    * a trampoline. */
+   if (g_HalPagingOperations->MapPage(proc->page_directory,
+                                      USER_EXIT_TRAMPOLINE_VA, frame,
+                                      HAL_PAGE_PRESENT | HAL_PAGE_USER) < 0)
    {
       return -1;
    }
 
-   if (ehdr->e_machine != EM_386) return -1;
-
+   /* Address-space teardown frees every mapped frame; the extra
+      reference keeps the shared page alive across process exits. */
+   PMM_RetainPhysicalPage(frame);
    return 0;
 }
 
-static int load_segments_into_directory(VFS_File *file, void *page_directory,
-                                        const Elf32_Ehdr *ehdr)
+/* Map the shared kernel info page read-only at its fixed vaddr.  The
+ * frame is global and refcounted; fork's COW walk sees a clean
+ * read-only page and keeps sharing it. */
+static int map_user_kinfo(Process *proc)
 {
-   Elf32_Phdr phdr;
+   uint32_t frame = KInfo_Frame();
+   if (!frame) return 0; /* Info page unavailable: not fatal */
 
-   for (uint16_t i = 0; i < ehdr->e_phnum; ++i)
+   if (g_HalPagingOperations->MapPage(proc->page_directory, USER_KINFO_VA,
+                                      frame,
+                                      HAL_PAGE_PRESENT | HAL_PAGE_USER) < 0)
    {
-      uint32_t phoff = ehdr->e_phoff + (i * ehdr->e_phentsize);
-      if (VFS_Seek(file, phoff) < 0) return -1;
-      if (VFS_Read(file, sizeof(phdr), &phdr) != sizeof(phdr)) return -1;
-
-      if (phdr.p_type != PT_LOAD) continue;
-
-      uint32_t vaddr = phdr.p_vaddr;
-      uint32_t memsz = phdr.p_memsz;
-      uint32_t filesz = phdr.p_filesz;
-
-      uint32_t start = vaddr & ~0xFFFu;
-      uint32_t end = vaddr + memsz;
-      uint32_t pages = (end - start + PAGE_SIZE - 1) / PAGE_SIZE;
-
-      for (uint32_t p = 0; p < pages; ++p)
-      {
-         uint32_t page_va = start + (p * PAGE_SIZE);
-         uint32_t phys = PMM_AllocatePhysicalPage();
-         if (!phys) return -1;
-
-         if (g_HalPagingOperations->MapPage(page_directory, page_va, phys,
-                                            HAL_PAGE_PRESENT | HAL_PAGE_RW |
-                                                HAL_PAGE_USER) < 0)
-         {
-            PMM_FreePhysicalPage(phys);
-            return -1;
-         }
-      }
-
-      if (VFS_Seek(file, phdr.p_offset) < 0) return -1;
-
-      uint8_t *buffer = (uint8_t *)kmalloc(512);
-      if (!buffer) return -1;
-
-      uint32_t remaining = filesz;
-      uint32_t offset = 0;
-      void *kernel_pd = Process_GetKernelPageDirectory();
-      if (!kernel_pd)
-      {
-         kernel_pd = g_HalPagingOperations->GetCurrentPageDirectory();
-      }
-
-      while (remaining > 0)
-      {
-         uint32_t chunk = remaining < 512 ? remaining : 512;
-         uint32_t got = VFS_Read(file, chunk, buffer);
-         if (got == 0 || got > chunk)
-         {
-            free(buffer);
-            return -1;
-         }
-
-         g_HalPagingOperations->SwitchPageDirectory(page_directory);
-         memcpy((void *)(vaddr + offset), buffer, got);
-         g_HalPagingOperations->SwitchPageDirectory(kernel_pd);
-
-         offset += got;
-         remaining -= got;
-      }
-
-      free(buffer);
-
-      if (memsz > filesz)
-      {
-         void *kernel_pd = Process_GetKernelPageDirectory();
-         if (!kernel_pd)
-         {
-            kernel_pd = g_HalPagingOperations->GetCurrentPageDirectory();
-         }
-
-         g_HalPagingOperations->SwitchPageDirectory(page_directory);
-         memset((void *)(vaddr + filesz), 0, memsz - filesz);
-         g_HalPagingOperations->SwitchPageDirectory(kernel_pd);
-      }
+      return -1;
    }
 
+   /* Address-space teardown frees every mapped frame; the extra
+      reference keeps the shared page alive across process exits. */
+   PMM_RetainPhysicalPage(frame);
    return 0;
 }
 
-static void free_vector_copy(char **vec, int count)
+/* Per-exec bump arena: the argv/envp copies live for the length of one
+ * Process_Execute, so they share a single sized-to-fit allocation and
+ * one free instead of a kmalloc/free pair per string. */
+typedef struct
 {
-   if (!vec) return;
-   for (int i = 0; i < count; ++i)
-   {
-      if (vec[i]) free(vec[i]);
-   }
+   char *base;
+   uint32_t used;
+} ExecArena;
+
+static char *arena_copy_string(ExecArena *arena, const char *s, uint32_t len)
+{
+   char *dst = arena->base + arena->used;
+   arena->used += len + 1;
+   memcpy(dst, s, len + 1);
+   return dst;
 }
 
-static int copy_string_vector(const char *const in[], char **out, int max_count)
+/* Validate one vector and add its copy footprint to *total.  Returns
+ * the element count, or -1 on an oversized string or vector. */
+static int measure_string_vector(const char *const in[], int max_count,
+                                 uint32_t *total)
 {
    int count = 0;
 
-   if (!in)
-   {
-      out[0] = NULL;
-      return 0;
-   }
+   if (!in) return 0;
 
-   while (in[count] && count < max_count)
+   while (in[count])
    {
+      if (count >= max_count) return -1;
+
       unsigned len = strlen(in[count]);
       if (len >= EXEC_MAX_STR) return -1;
 
-      out[count] = (char *)kmalloc(len + 1);
-      if (!out[count]) return -1;
-
-      memcpy(out[count], in[count], len + 1);
+      *total += len + 1;
       ++count;
    }
 
-   if (count == max_count && in[count] != NULL) return -1;
+   return count;
+}
 
+static void copy_string_vector(ExecArena *arena, const char *const in[],
+                               char **out, int count)
+{
+   for (int i = 0; i < count; ++i)
+   {
+      out[i] = arena_copy_string(arena, in[i], strlen(in[i]));
+   }
    out[count] = NULL;
-   return count;
 }
 
 static int build_initial_user_stack(Process *proc, const char *const argv[],
@@ -233,16 +137,21 @@ static int build_initial_user_stack(Process *proc, const char *const argv[],
    uint32_t argv_ptrs[EXEC_MAX_ARGS];
    uint32_t envp_ptrs[EXEC_MAX_ENVP];
 
-   int argc = copy_string_vector(argv, argv_copy, EXEC_MAX_ARGS);
-   if (argc < 0) return -1;
+   uint32_t total = 0;
+   int argc = measure_string_vector(argv, EXEC_MAX_ARGS, &total);
+   int envc = measure_string_vector(envp, EXEC_MAX_ENVP, &total);
+   if (argc < 0 || envc < 0) return -1;
 
-   int envc = copy_string_vector(envp, envp_copy, EXEC_MAX_ENVP);
-   if (envc < 0)
+   ExecArena arena = {NULL, 0};
+   if (total)
    {
-      free_vector_copy(argv_copy, argc > 0 ? argc : 0);
-      return -1;
+      arena.base = (char *)kmalloc(total);
+      if (!arena.base) return -1;
    }
 
+   copy_string_vector(&arena, argv, argv_copy, argc);
+   copy_string_vector(&arena, envp, envp_copy, envc);
+
    uint32_t sp = proc->stack_end;
 
    void *kernel_pd = Process_GetKernelPageDirectory();
@@ -298,8 +207,7 @@ static int build_initial_user_stack(Process *proc, const char *const argv[],
    proc->esp = sp;
    proc->ebp = sp;
 
-   free_vector_copy(argv_copy, argc);
-   free_vector_copy(envp_copy, envc);
+   if (arena.base) free(arena.base);
 
    return 0;
 }
@@ -309,6 +217,7 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
 {
    if (!proc || !path) return -1;
    if (proc->kernel_mode) return -1;
+   if (strlen(path) >= PROCESS_EXEC_PATH_MAX) return -1;
 
    if (VFS_Access(path, proc->euid, proc->egid, VFS_ACCESS_EXEC) < 0)
    {
@@ -318,8 +227,19 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
    VFS_File *file = VFS_Open(path);
    if (!file) return -2;
 
+   /* Parsed-form cache: a hit replaces the header and program header
+    * reads below; segment pages then come from cached frames in the
+    * fault path, so a repeat exec reads nothing from the file. */
+   uint32_t cached_entry = 0;
+   ProcessSegment cached_segments[PROCESS_MAX_SEGMENTS];
+   uint32_t cached_segment_count = 0;
+   bool from_cache =
+       ExecCache_Lookup(path, file->partition, file->partition->write_gen,
+                        VFS_GetSize(file), &cached_entry, cached_segments,
+                        &cached_segment_count) == SUCCESS;
+
    Elf32_Ehdr ehdr;
-   if (load_header(file, &ehdr) < 0)
+   if (!from_cache && ELF_ReadHeader(file, &ehdr) < 0)
    {
       VFS_Close(file);
       return -3;
@@ -344,7 +264,8 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
       return -1;
    }
 
-   if (Stack_ProcessInitialize(&staged, USER_STACK_TOP, USER_STACK_SIZE) != 0)
+   if (Stack_ProcessInitialize(&staged, USER_STACK_TOP,
+                               USER_STACK_INITIAL_SIZE) != 0)
    {
       g_HalPagingOperations->DestroyPageDirectory(new_pd);
       VFS_Close(file);
@@ -358,13 +279,31 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
       return -1;
    }
 
-   if (load_segments_into_directory(file, new_pd, &ehdr) != 0)
+   if (map_user_kinfo(&staged) != 0)
    {
       g_HalPagingOperations->DestroyPageDirectory(new_pd);
       VFS_Close(file);
       return -1;
    }
 
+   if (from_cache)
+   {
+      memcpy(staged.segments, cached_segments, sizeof(staged.segments));
+      staged.segment_count = cached_segment_count;
+   }
+   else if (ELF_RecordSegments(file, &staged, &ehdr) != 0)
+   {
+      g_HalPagingOperations->DestroyPageDirectory(new_pd);
+      VFS_Close(file);
+      return -1;
+   }
+   else
+   {
+      ExecCache_Insert(path, file->partition, file->partition->write_gen,
+                       VFS_GetSize(file), ehdr.e_entry, staged.segments,
+                       staged.segment_count);
+   }
+
    VFS_Close(file);
 
    if (build_initial_user_stack(&staged, argv, envp) != 0)
@@ -379,6 +318,10 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
       return -1;
    }
 
+   /* mmap regions do not survive exec; release them while the old
+      directory (which holds their frames) is still attached. */
+   Process_ReleaseMappings(proc);
+
    void *old_pd = proc->page_directory;
 
    proc->page_directory = staged.page_directory;
@@ -386,7 +329,14 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
    proc->heap_end = staged.heap_end;
    proc->stack_start = staged.stack_start;
    proc->stack_end = staged.stack_end;
-   proc->eip = ehdr.e_entry;
+
+   /* Swap in the new binary's demand-paging state. */
+   if (proc->exec_file) VFS_Close(proc->exec_file);
+   proc->exec_file = NULL;
+   memcpy(proc->segments, staged.segments, sizeof(proc->segments));
+   proc->segment_count = staged.segment_count;
+   memcpy(proc->exec_path, path, strlen(path) + 1);
+   proc->eip = from_cache ? cached_entry : ehdr.e_entry;
    proc->esp = staged.esp;
    proc->ebp = staged.ebp;
    proc->eax = proc->ebx = proc->ecx = proc->edx = 0;
@@ -394,7 +344,21 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
    proc->eflags = 0x202u;
    proc->saved_regs = NULL;
 
-   if (old_pd) g_HalPagingOperations->DestroyPageDirectory(old_pd);
+   /* The old program's FPU/SSE state must not leak into the new
+      image; drop lazy ownership and let first use start pristine. */
+   g_HalFpuOperations->Discard();
+   if (proc->fpu_state)
+   {
+      free(proc->fpu_state);
+      proc->fpu_state = NULL;
+   }
+
+   if (old_pd)
+   {
+      ZStore_DropDirectory(old_pd); /* compressed pages die with the image */
+      VMM_DestroySpace(old_pd);
+      g_HalPagingOperations->DestroyPageDirectory(old_pd);
+   }
 
    logfmt(LOG_INFO, "[PROC] exec: pid=%u path=%s entry=0x%08x\n", proc->pid,
           path, proc->eip);
@@ -406,3 +370,252 @@ int Process_Execute(Process *proc, const char *path, const char *const argv[],
 
    return 0;
 }
+
+/* Fault a demand-paged ELF page in from the current binary.
+ *
+ * Called from the architecture page-fault path for non-present faults.
+ * Returns 0 when the page was populated and the access can retry, -1
+ * when the address is not covered by a recorded segment (the caller
+ * then falls through to its fatal path).
+ */
+int Process_HandlePageFault(uint32_t fault_address, uint32_t error_code)
+{
+   if (error_code & 0x1) return -1; // Protection faults are not ours
+
+   Process *proc = Process_GetCurrent();
+   if (!proc) return -1;
+
+   uint32_t page_va = fault_address & ~0xFFFu;
+
+   /* Demand stack growth: the unmapped window between the mapped stack
+    * and USER_STACK_MAX_SIZE below the top acts as a guard region.  A
+    * fault there extends the stack down to the faulting page, mapped
+    * the same way Stack_ProcessInitialize maps the initial pages (COW
+    * onto the shared zero page), so only touched pages ever cost a
+    * frame.  Faults below the limit stay fatal. */
+   if (proc->stack_end != 0 && page_va < proc->stack_start &&
+       page_va >= proc->stack_end - USER_STACK_MAX_SIZE)
+   {
+      uint32_t zero_page = PMM_GetZeroPage();
+      while (proc->stack_start > page_va)
+      {
+         uint32_t va = proc->stack_start - PAGE_SIZE;
+         uint32_t phys = zero_page;
+         uint32_t flags = HAL_PAGE_PRESENT | HAL_PAGE_USER | HAL_PAGE_COW;
+         if (!phys)
+         {
+            phys = PMM_AllocateZeroedPage();
+            if (!phys) return -1;
+            flags = HAL_PAGE_PRESENT | HAL_PAGE_RW | HAL_PAGE_USER;
+         }
+         if (g_HalPagingOperations->MapPage(proc->page_directory, va, phys,
+                                            flags) < 0)
+         {
+            if (!zero_page) PMM_FreePhysicalPage(phys);
+            return -1;
+         }
+         /* Grow one page at a time so a mid-loop failure leaves
+          * stack_start describing exactly what is mapped. */
+         proc->stack_start = va;
+      }
+      return 0;
+   }
+
+   ProcessSegment *seg = NULL;
+   for (uint32_t i = 0; i < proc->segment_count; ++i)
+   {
+      ProcessSegment *s = &proc->segments[i];
+      if (page_va + PAGE_SIZE > s->vaddr && page_va < s->vaddr + s->memsz)
+      {
+         seg = s;
+         break;
+      }
+   }
+   if (!seg) return Process_HandleMappingFault(proc, page_va);
+
+   /* Cached frame from an earlier exec of this binary: map it shared
+    * copy-on-write and skip the file read entirely. */
+   uint32_t cached = ExecCache_GetPage(proc->exec_path, page_va);
+   if (cached)
+   {
+      if (g_HalPagingOperations->MapPage(proc->page_directory, page_va, cached,
+                                         HAL_PAGE_PRESENT | HAL_PAGE_USER |
+                                             HAL_PAGE_COW) < 0)
+      {
+         PMM_FreePhysicalPage(cached);
+         return -1;
+      }
+      return 0;
+   }
+
+   /* A pre-zeroed frame covers BSS and the segment's unaligned edges;
+      frames live in the identity-mapped window, so fill directly. */
+   uint32_t phys = PMM_AllocateZeroedPage();
+   if (!phys) return -1;
+
+   uint32_t file_lo = max(page_va, seg->vaddr);
+   uint32_t file_hi = min(page_va + PAGE_SIZE, seg->vaddr + seg->filesz);
+
+   if (file_hi > file_lo)
+   {
+      if (!proc->exec_file && proc->exec_path[0])
+      {
+         proc->exec_file = VFS_Open(proc->exec_path);
+      }
+      if (!proc->exec_file)
+      {
+         PMM_FreePhysicalPage(phys);
+         return -1;
+      }
+
+      if (VFS_Seek(proc->exec_file,
+                   seg->file_offset + (file_lo - seg->vaddr)) < 0)
+      {
+         PMM_FreePhysicalPage(phys);
+         return -1;
+      }
+
+      uint8_t *dst = (uint8_t *)phys + (file_lo - page_va);
+      uint32_t remaining = file_hi - file_lo;
+      while (remaining > 0)
+      {
+         uint32_t got = VFS_Read(proc->exec_file, remaining, dst);
+         if (got == 0 || got > remaining)
+         {
+            PMM_FreePhysicalPage(phys);
+            return -1;
+         }
+         dst += got;
+         remaining -= got;
+      }
+   }
+
+   /* Offer the frame to the exec cache.  Once the cache holds a
+    * reference the frame is shared, so this mapping must be COW; a
+    * rejected offer keeps the old private writable mapping. */
+   uint32_t page_flags = HAL_PAGE_PRESENT | HAL_PAGE_RW | HAL_PAGE_USER;
+   if (ExecCache_PutPage(proc->exec_path, page_va, phys) == SUCCESS)
+   {
+      page_flags = HAL_PAGE_PRESENT | HAL_PAGE_USER | HAL_PAGE_COW;
+   }
+
+   if (g_HalPagingOperations->MapPage(proc->page_directory, page_va, phys,
+                                      page_flags) < 0)
+   {
+      PMM_FreePhysicalPage(phys);
+      return -1;
+   }
+
+   return 0;
+}
+
+/* Warm the exec cache with one binary without executing it.
+ *
+ * Parses the image the way Process_Execute would, inserts the parsed
+ * form, then reads every file-backed segment page into a cache frame,
+ * so the first real exec after boot hits memory instead of cold FAT
+ * reads.  Pure-BSS pages are left to the fault path - they cost no
+ * disk I/O.  Returns the number of pages cached, or a negative error.
+ */
+int Process_PreloadBinary(const char *path)
+{
+   if (!path || strlen(path) >= PROCESS_EXEC_PATH_MAX) return -EINVAL;
+
+   VFS_File *file = VFS_Open(path);
+   if (!file) return -ENOENT;
+
+   /* Already cached and still valid: nothing to warm. */
+   uint32_t entry_point;
+   ProcessSegment segments[PROCESS_MAX_SEGMENTS];
+   uint32_t segment_count;
+   if (ExecCache_Lookup(path, file->partition, file->partition->write_gen,
+                        VFS_GetSize(file), &entry_point, segments,
+                        &segment_count) == SUCCESS)
+   {
+      VFS_Close(file);
+      return 0;
+   }
+
+   Elf32_Ehdr ehdr;
+   if (ELF_ReadHeader(file, &ehdr) < 0)
+   {
+      VFS_Close(file);
+      return -EINVAL;
+   }
+
+   /* ELF_RecordSegments fills a Process; a static scratch keeps the
+    * large struct off the kthread stack.  Preload runs on the single
+    * initlate thread, so there is no reentry. */
+   static Process scratch;
+   memset(&scratch, 0, sizeof(scratch));
+   if (ELF_RecordSegments(file, &scratch, &ehdr) != 0)
+   {
+      VFS_Close(file);
+      return -EINVAL;
+   }
+
+   ExecCache_Insert(path, file->partition, file->partition->write_gen,
+                    VFS_GetSize(file), ehdr.e_entry, scratch.segments,
+                    scratch.segment_count);
+
+   int cached_pages = 0;
+   for (uint32_t i = 0; i < scratch.segment_count; ++i)
+   {
+      ProcessSegment *seg = &scratch.segments[i];
+
+      for (uint32_t page_va = seg->vaddr & ~0xFFFu;
+           page_va < seg->vaddr + seg->filesz; page_va += PAGE_SIZE)
+      {
+         /* A segment boundary can share a page with the previous one;
+          * GetPage retains a reference we must give back. */
+         uint32_t dup = ExecCache_GetPage(path, page_va);
+         if (dup)
+         {
+            PMM_FreePhysicalPage(dup);
+            continue;
+         }
+
+         uint32_t phys = PMM_AllocateZeroedPage();
+         if (!phys) goto out;
+
+         uint32_t file_lo = max(page_va, seg->vaddr);
+         uint32_t file_hi = min(page_va + PAGE_SIZE, seg->vaddr + seg->filesz);
+
+         if (VFS_Seek(file, seg->file_offset + (file_lo - seg->vaddr)) < 0)
+         {
+            PMM_FreePhysicalPage(phys);
+            goto out;
+         }
+
+         uint8_t *dst = (uint8_t *)phys + (file_lo - page_va);
+         uint32_t remaining = file_hi - file_lo;
+         while (remaining > 0)
+         {
+            uint32_t got = VFS_Read(file, remaining, dst);
+            if (got == 0 || got > remaining)
+            {
+               PMM_FreePhysicalPage(phys);
+               goto out;
+            }
+            dst += got;
+            remaining -= got;
+         }
+
+         if (ExecCache_PutPage(path, page_va, phys) != SUCCESS)
+         {
+            /* Per-binary page budget reached (or the entry was evicted
+             * under memory pressure): stop reading ahead. */
+            PMM_FreePhysicalPage(phys);
+            goto out;
+         }
+
+         /* The cache holds its own reference now; drop ours. */
+         PMM_FreePhysicalPage(phys);
+         cached_pages++;
+      }
+   }
+
+out:
+   VFS_Close(file);
+   return cached_pages;
+}
@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "execcache.h"
+#include "lockstat.h"
+#include "spinlock.h"
+#include "timer.h"
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <std/string.h>
+
+#define EXECCACHE_MAX_ENTRIES 8
+#define EXECCACHE_MAX_PAGES 64 /* per binary; bigger ones pass through */
+
+typedef struct
+{
+   uint32_t page_va;
+   uint32_t phys;
+} CachedPage;
+
+typedef struct
+{
+   bool used;
+   char path[PROCESS_EXEC_PATH_MAX];
+
+   /* Validity stamp: any write on the partition or a size change means
+    * the binary may differ and the entry is rebuilt from disk. */
+   const void *partition;
+   uint32_t write_gen;
+   uint32_t size;
+
+   /* Parsed form - what Process_Execute otherwise reads from disk. */
+   uint32_t entry_point;
+   ProcessSegment segments[PROCESS_MAX_SEGMENTS];
+   uint32_t segment_count;
+
+   CachedPage pages[EXECCACHE_MAX_PAGES];
+   uint32_t page_count;
+
+   uint64_t last_used; /* Timer_GetTicks at last hit, for eviction */
+} ExecCacheEntry;
+
+static ExecCacheEntry g_ExecCache[EXECCACHE_MAX_ENTRIES];
+static Spinlock g_ExecCacheLock = SPINLOCK_INIT;
+
+static void execcache_release_entry(ExecCacheEntry *entry);
+
+/* Memory-pressure shrinker: evict least-recently-used entries until
+ * the request is covered.  Cached binaries are pure optimization, and
+ * frames still COW-mapped by running processes survive on their own
+ * references, so eviction is always safe. */
+static uint32_t execcache_shrink(uint32_t pages_wanted)
+{
+   uint32_t released = 0;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_ExecCacheLock);
+   while (released < pages_wanted)
+   {
+      ExecCacheEntry *victim = NULL;
+      for (int i = 0; i < EXECCACHE_MAX_ENTRIES; i++)
+      {
+         ExecCacheEntry *entry = &g_ExecCache[i];
+         if (!entry->used) continue;
+         if (!victim || entry->last_used < victim->last_used) victim = entry;
+      }
+      if (!victim) break;
+
+      released += victim->page_count;
+      execcache_release_entry(victim);
+   }
+   Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+
+   return released;
+}
+
+void ExecCache_Initialize(void)
+{
+   Lockstat_Register(&g_ExecCacheLock, "execcache");
+   PMM_RegisterShrinker("execcache", execcache_shrink, 1);
+}
+
+/* Drop an entry's frame references.  Frames still COW-mapped by live
+ * processes survive on their own references. */
+static void execcache_release_entry(ExecCacheEntry *entry)
+{
+   for (uint32_t i = 0; i < entry->page_count; i++)
+   {
+      PMM_FreePhysicalPage(entry->pages[i].phys);
+   }
+   entry->page_count = 0;
+   entry->used = false;
+}
+
+static ExecCacheEntry *execcache_find(const char *path)
+{
+   for (uint32_t i = 0; i < EXECCACHE_MAX_ENTRIES; i++)
+   {
+      if (g_ExecCache[i].used && strcmp(g_ExecCache[i].path, path) == 0)
+      {
+         return &g_ExecCache[i];
+      }
+   }
+   return NULL;
+}
+
+int ExecCache_Lookup(const char *path, const void *partition,
+                     uint32_t write_gen, uint32_t size, uint32_t *entry_point,
+                     ProcessSegment *segments, uint32_t *segment_count)
+{
+   if (!path) return -EINVAL;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_ExecCacheLock);
+
+   ExecCacheEntry *entry = execcache_find(path);
+   if (!entry)
+   {
+      Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+      return -ENOENT;
+   }
+
+   if (entry->partition != partition || entry->write_gen != write_gen ||
+       entry->size != size)
+   {
+      /* The partition was written to since the cache was filled; this
+       * binary may be among the changes.  Rebuild from disk. */
+      execcache_release_entry(entry);
+      Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+      return -ENOENT;
+   }
+
+   *entry_point = entry->entry_point;
+   memcpy(segments, entry->segments, sizeof(entry->segments));
+   *segment_count = entry->segment_count;
+   entry->last_used = Timer_GetTicks();
+
+   Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+   return SUCCESS;
+}
+
+void ExecCache_Insert(const char *path, const void *partition,
+                      uint32_t write_gen, uint32_t size, uint32_t entry_point,
+                      const ProcessSegment *segments, uint32_t segment_count)
+{
+   if (!path || strlen(path) >= PROCESS_EXEC_PATH_MAX) return;
+   if (segment_count > PROCESS_MAX_SEGMENTS) return;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_ExecCacheLock);
+
+   ExecCacheEntry *entry = execcache_find(path);
+   if (!entry)
+   {
+      /* Free slot, else evict the least recently hit binary. */
+      ExecCacheEntry *victim = &g_ExecCache[0];
+      for (uint32_t i = 0; i < EXECCACHE_MAX_ENTRIES; i++)
+      {
+         if (!g_ExecCache[i].used)
+         {
+            victim = &g_ExecCache[i];
+            break;
+         }
+         if (g_ExecCache[i].last_used < victim->last_used)
+            victim = &g_ExecCache[i];
+      }
+      if (victim->used) execcache_release_entry(victim);
+      entry = victim;
+   }
+   else
+   {
+      execcache_release_entry(entry);
+   }
+
+   entry->used = true;
+   memcpy(entry->path, path, strlen(path) + 1);
+   entry->partition = partition;
+   entry->write_gen = write_gen;
+   entry->size = size;
+   entry->entry_point = entry_point;
+   memcpy(entry->segments, segments, sizeof(entry->segments));
+   entry->segment_count = segment_count;
+   entry->page_count = 0;
+   entry->last_used = Timer_GetTicks();
+
+   Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+}
+
+uint32_t ExecCache_GetPage(const char *path, uint32_t page_va)
+{
+   if (!path || !path[0]) return 0;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_ExecCacheLock);
+
+   uint32_t phys = 0;
+   ExecCacheEntry *entry = execcache_find(path);
+   if (entry)
+   {
+      for (uint32_t i = 0; i < entry->page_count; i++)
+      {
+         if (entry->pages[i].page_va != page_va) continue;
+         phys = entry->pages[i].phys;
+         PMM_RetainPhysicalPage(phys); /* Reference for the new mapping */
+         entry->last_used = Timer_GetTicks();
+         break;
+      }
+   }
+
+   Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+   return phys;
+}
+
+int ExecCache_PutPage(const char *path, uint32_t page_va, uint32_t phys)
+{
+   if (!path || !path[0]) return -EINVAL;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_ExecCacheLock);
+
+   ExecCacheEntry *entry = execcache_find(path);
+   if (!entry || entry->page_count >= EXECCACHE_MAX_PAGES)
+   {
+      Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+      return -ENOMEM;
+   }
+
+   for (uint32_t i = 0; i < entry->page_count; i++)
+   {
+      /* Lost a race against another fault on the same page. */
+      if (entry->pages[i].page_va == page_va)
+      {
+         Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+         return -ENOMEM;
+      }
+   }
+
+   entry->pages[entry->page_count].page_va = page_va;
+   entry->pages[entry->page_count].phys = phys;
+   entry->page_count++;
+   PMM_RetainPhysicalPage(phys); /* The cache's own reference */
+
+   Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+   return SUCCESS;
+}
+
+void ExecCache_Invalidate(const char *path)
+{
+   if (!path) return;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_ExecCacheLock);
+
+   ExecCacheEntry *entry = execcache_find(path);
+   if (entry) execcache_release_entry(entry);
+
+   Spinlock_ReleaseIrqRestore(&g_ExecCacheLock, interrupts_were_enabled);
+}
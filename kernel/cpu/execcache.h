@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef EXECCACHE_H
+#define EXECCACHE_H
+
+#include "process.h"
+#include <stdint.h>
+
+/* =========================================================================
+ * Exec binary cache
+ *
+ * Shells re-run the same few utilities constantly, and every exec was
+ * re-reading the ELF header, program headers and (via demand paging)
+ * the same segment pages from disk.  The cache keeps the parsed
+ * entry point + PT_LOAD extents and the faulted-in segment frames of
+ * recently executed binaries.  Cached frames are handed out with an
+ * extra reference and mapped copy-on-write, so every process shares
+ * one physical copy until it writes.
+ *
+ * An entry is validated on lookup against the partition's write
+ * generation and the file size, and dropped explicitly by VFS_Delete;
+ * a stale entry frees its frame references and is re-populated from
+ * disk on the next exec.
+ * ====================================================================== */
+
+/* Registers the cache lock with the lockstat table. */
+void ExecCache_Initialize(void);
+
+/* Fetch the parsed form of `path`.  Returns SUCCESS and fills the
+ * entry point and segment table on a fresh hit; -ENOENT on miss or
+ * when the entry went stale (it is evicted on the way out). */
+int ExecCache_Lookup(const char *path, const void *partition,
+                     uint32_t write_gen, uint32_t size, uint32_t *entry_point,
+                     ProcessSegment *segments, uint32_t *segment_count);
+
+/* Remember the parsed form of a freshly loaded binary. */
+void ExecCache_Insert(const char *path, const void *partition,
+                      uint32_t write_gen, uint32_t size, uint32_t entry_point,
+                      const ProcessSegment *segments, uint32_t segment_count);
+
+/* Page-level side: returns the cached frame for one segment page with
+ * an extra reference taken (caller maps it COW), or 0 on miss. */
+uint32_t ExecCache_GetPage(const char *path, uint32_t page_va);
+
+/* Offer a freshly read segment frame for caching.  Returns SUCCESS
+ * when the cache took a reference - the caller must then map its copy
+ * COW, not writable - or -ENOMEM when the page store is full. */
+int ExecCache_PutPage(const char *path, uint32_t page_va, uint32_t phys);
+
+/* Drop the entry for `path`, if any (VFS_Delete). */
+void ExecCache_Invalidate(const char *path);
+
+#endif
@@ -1,31 +1,29 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include "kstack.h"
 #include "process.h"
 #include "scheduler.h"
+#include <hal/fpu.h>
 #include <hal/mem.h>
 #include <mem/mm_kernel.h>
+#include <mem/mm_proc.h>
 #include <std/stdio.h>
 #include <std/string.h>
 #include <sys/sys.h>
 
 static int allocate_kernel_stack(Process *proc)
 {
-   uint32_t stack_size = (g_SysInfo && g_SysInfo->memory.kernel_stack_size)
-                             ? g_SysInfo->memory.kernel_stack_size
-                             : 65536u;
-
-   proc->kernel_stack = kmalloc(stack_size);
-   if (!proc->kernel_stack) return -1;
-
-   proc->kernel_stack_size = stack_size;
-   return 0;
+   proc->kernel_stack = KStack_Allocate(&proc->kernel_stack_size);
+   return proc->kernel_stack ? 0 : -1;
 }
 
 static void cleanup_child_space(Process *child)
 {
    if (!child || !child->page_directory) return;
 
-   for (uint32_t va = PAGE_SIZE; va < HEAP_MAX; va += PAGE_SIZE)
+   /* Start above the shared kernel identity window: its page tables are
+      shared between all directories and must never be touched here. */
+   for (uint32_t va = KERNEL_IDENTITY_LIMIT; va < HEAP_MAX; va += PAGE_SIZE)
    {
       if (g_HalPagingOperations->IsPageMapped(child->page_directory, va) < 0)
       {
@@ -34,9 +32,15 @@ static void cleanup_child_space(Process *child)
 
       uint32_t phys =
           g_HalPagingOperations->GetPhysicalAddress(child->page_directory, va);
-      g_HalPagingOperations->UnmapPage(child->page_directory, va);
       if (phys) PMM_FreePhysicalPage(phys);
    }
+
+   /* One pass over the tables, one TLB invalidation (a no-op here since
+      the child's directory was never live). */
+   g_HalPagingOperations->UnmapRange(child->page_directory,
+                                     KERNEL_IDENTITY_LIMIT,
+                                     (HEAP_MAX - KERNEL_IDENTITY_LIMIT) /
+                                         PAGE_SIZE);
 }
 
 Process *Process_Clone(Process *parent, const Registers *parent_regs)
@@ -50,6 +54,9 @@ Process *Process_Clone(Process *parent, const Registers *parent_regs)
    child->ppid = parent->pid;
    child->state = STATE_READY;
    child->kernel_mode = parent->kernel_mode;
+   child->sched_class = parent->sched_class;
+   child->sched_boost = 0;
+   child->cpu_affinity = parent->cpu_affinity;
    child->uid = parent->uid;
    child->gid = parent->gid;
    child->euid = parent->euid;
@@ -58,13 +65,48 @@ Process *Process_Clone(Process *parent, const Registers *parent_regs)
    child->ticks_remaining = parent->ticks_remaining;
    child->wait_channel = NULL;
    child->signal_mask = parent->signal_mask;
+   /* Handlers are inherited; the pending set starts empty (POSIX). */
+   memcpy(child->signal_handlers, parent->signal_handlers,
+          sizeof(child->signal_handlers));
+   child->signal_pending = 0;
+   child->signal_deliverable = false;
    child->exit_code = 0;
 
+   /* FPU/SSE state is inherited.  Flush the lazily-held registers so
+      the parent's buffer is current before it is copied; on nomem the
+      child just starts from the pristine image. */
+   child->fpu_state = NULL;
+   if (parent->fpu_state)
+   {
+      g_HalFpuOperations->Flush();
+      child->fpu_state = kmalloc(PROCESS_FPU_ALLOC_SIZE);
+      if (child->fpu_state)
+      {
+         memcpy(Process_FpuImage(child->fpu_state),
+                Process_FpuImage(parent->fpu_state), PROCESS_FPU_IMAGE_SIZE);
+      }
+   }
+
    child->heap_start = parent->heap_start;
    child->heap_end = parent->heap_end;
    child->stack_start = parent->stack_start;
    child->stack_end = parent->stack_end;
 
+   /* Inherit the demand-paging extents; unfaulted segment pages are
+      filled from the binary in each process separately.  The handle is
+      opened lazily on the child's first fault. */
+   memcpy(child->segments, parent->segments, sizeof(child->segments));
+   child->segment_count = parent->segment_count;
+   memcpy(child->exec_path, parent->exec_path, sizeof(child->exec_path));
+   child->exec_file = NULL;
+
+   /* mmap regions are inherited; cached file handles are per process. */
+   memcpy(child->mappings, parent->mappings, sizeof(child->mappings));
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      child->mappings[i].file = NULL;
+   }
+
    child->page_directory = g_HalPagingOperations->CreatePageDirectory();
    if (!child->page_directory)
    {
@@ -72,67 +114,88 @@ Process *Process_Clone(Process *parent, const Registers *parent_regs)
       return NULL;
    }
 
+   /* Record the inherited mapping ranges in the child's VMA space so a
+      later mmap in the child cannot be placed on top of them. */
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      if (!child->mappings[i].used) continue;
+      if (VMM_ReserveRangeInDir(child->page_directory,
+                                child->mappings[i].start,
+                                child->mappings[i].length,
+                                HAL_PAGE_USER) < 0)
+      {
+         logfmt(LOG_WARNING,
+                "[PROC] fork: failed to reserve inherited mapping "
+                "0x%08x\n",
+                child->mappings[i].start);
+      }
+   }
+
    if (allocate_kernel_stack(child) != 0)
    {
+      VMM_DestroySpace(child->page_directory);
       g_HalPagingOperations->DestroyPageDirectory(child->page_directory);
       free(child);
       return NULL;
    }
 
-   uint8_t *copy_buffer = (uint8_t *)kmalloc(PAGE_SIZE);
-   if (!copy_buffer)
+   /* Fault any compressed-out parent pages back in first: a swapped PTE
+    * carries a store slot private to the parent's directory and cannot
+    * be shared, and the COW walk below only sees present frames. */
+   if (ZStore_RestoreDirectory(parent->page_directory) < 0)
    {
-      cleanup_child_space(child);
+      logfmt(LOG_ERROR,
+             "[PROC] fork: out of memory restoring compressed pages\n");
+      VMM_DestroySpace(child->page_directory);
       g_HalPagingOperations->DestroyPageDirectory(child->page_directory);
-      free(child->kernel_stack);
+      KStack_Free(child->kernel_stack, child->kernel_stack_size);
       free(child);
       return NULL;
    }
 
-   void *kernel_pd = Process_GetKernelPageDirectory();
-   if (!kernel_pd) kernel_pd = g_HalPagingOperations->GetCurrentPageDirectory();
-
-   for (uint32_t va = PAGE_SIZE; va < HEAP_MAX; va += PAGE_SIZE)
+   /* Copy-on-write: share every parent frame with the child read-only.
+    * The first write to either mapping faults and the page-fault handler
+    * copies the frame then; pages that are never written stay shared.
+    */
+   for (uint32_t va = KERNEL_IDENTITY_LIMIT; va < HEAP_MAX; va += PAGE_SIZE)
    {
       if (g_HalPagingOperations->IsPageMapped(parent->page_directory, va) < 0)
       {
          continue;
       }
 
-      uint32_t new_phys = PMM_AllocatePhysicalPage();
-      if (!new_phys)
+      uint32_t phys = g_HalPagingOperations->GetPhysicalAddress(
+                          parent->page_directory, va) &
+                      ~0xFFFu;
+      uint32_t flags =
+          g_HalPagingOperations->GetPageFlags(parent->page_directory, va);
+
+      uint32_t shared_flags = HAL_PAGE_PRESENT | HAL_PAGE_USER;
+      if (flags & (HAL_PAGE_RW | HAL_PAGE_COW))
       {
-         free(copy_buffer);
-         cleanup_child_space(child);
-         g_HalPagingOperations->DestroyPageDirectory(child->page_directory);
-         free(child->kernel_stack);
-         free(child);
-         return NULL;
+         /* Writable (or already COW) page: strip RW and mark COW so the
+            next write in either process triggers the copy. */
+         shared_flags |= HAL_PAGE_COW;
       }
 
-      if (g_HalPagingOperations->MapPage(child->page_directory, va, new_phys,
-                                         HAL_PAGE_PRESENT | HAL_PAGE_RW |
-                                             HAL_PAGE_USER) < 0)
+      if (g_HalPagingOperations->MapPage(child->page_directory, va, phys,
+                                         shared_flags) < 0)
       {
-         PMM_FreePhysicalPage(new_phys);
-         free(copy_buffer);
          cleanup_child_space(child);
+         VMM_DestroySpace(child->page_directory);
          g_HalPagingOperations->DestroyPageDirectory(child->page_directory);
-         free(child->kernel_stack);
+         KStack_Free(child->kernel_stack, child->kernel_stack_size);
          free(child);
          return NULL;
       }
 
-      g_HalPagingOperations->SwitchPageDirectory(parent->page_directory);
-      memcpy(copy_buffer, (void *)va, PAGE_SIZE);
-
-      g_HalPagingOperations->SwitchPageDirectory(child->page_directory);
-      memcpy((void *)va, copy_buffer, PAGE_SIZE);
-
-      g_HalPagingOperations->SwitchPageDirectory(kernel_pd);
+      g_HalPagingOperations->MapPage(parent->page_directory, va, phys,
+                                     shared_flags);
+      PMM_RetainPhysicalPage(phys);
    }
 
-   free(copy_buffer);
+   /* The parent's directory is live; flush the downgraded translations. */
+   g_HalPagingOperations->FlushTlb();
 
    child->eip = parent->eip;
    child->esp = parent->esp;
@@ -160,16 +223,16 @@ Process *Process_Clone(Process *parent, const Registers *parent_regs)
       child->eax = 0;
    }
 
-   for (int i = 0; i < 16; ++i)
-   {
-      child->fd_table[i] = parent->fd_table[i];
-      if (child->fd_table[i]) FD_Retain(child->fd_table[i]);
-   }
+   /* Share the descriptor table by reference; the first open/close/
+      dup in either process copies it (FD_TableUnshare).  Children
+      that exec immediately never pay for a duplicate. */
+   child->fd_table = FD_TableShare(parent->fd_table);
 
    logfmt(LOG_INFO, "[PROC] fork: parent=%u child=%u\n", parent->pid,
           child->pid);
 
    Scheduler_RegisterProcess(child);
+   Process_ChildLink(parent, child);
 
    return child;
 }
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+ * Futex: user-space synchronization with kernel-assisted waiting.
+ *
+ * The uncontended path never enters the kernel - userland flips the
+ * lock word with cmpxchg and only calls down here when it must sleep
+ * (WAIT) or has sleepers to release (WAKE).  The wait channel is the
+ * physical address of the futex word, so processes that map the same
+ * shared-memory segment at different virtual addresses still meet on
+ * one channel; private mappings get distinct frames and never collide.
+ */
+
+#include "futex.h"
+#include "process.h"
+#include "scheduler.h"
+#include <constants.h>
+#include <hal/io.h>
+#include <mem/mm_proc.h>
+
+/* Resolve the futex word to its physical address (the wait channel). */
+static void *futex_channel(Process *proc, uint32_t *uaddr)
+{
+   if (!proc || !proc->page_directory || !uaddr) return NULL;
+   if (((uint32_t)uaddr & 3u) != 0) return NULL; /* Must be aligned */
+
+   uint32_t phys = VMM_GetPhysInDir(proc->page_directory, (uint32_t)uaddr);
+   if (phys == 0) return NULL;
+
+   return (void *)(phys | ((uint32_t)uaddr & (PAGE_SIZE - 1)));
+}
+
+intptr_t Futex_Wait(void *proc_ptr, uint32_t *uaddr, uint32_t expected)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   void *channel = futex_channel(proc, uaddr);
+   if (!channel) return -EINVAL;
+
+   /* The value check and the block must not lose a wake in between:
+    * the waker updates the word before calling FUTEX_WAKE, so with the
+    * check done after Process_BlockOn a concurrent wake either sees us
+    * blocked (and releases us) or happened before the check (and the
+    * check fails). */
+   Process_BlockOn(proc, channel);
+
+   if (*uaddr != expected)
+   {
+      Process_Unblock(proc);
+      return -EAGAIN;
+   }
+
+   /* Sleep until a wake flips the state back (same wait beat as the
+    * pipe transport: hlt, let the scheduler run someone else). */
+   while (proc->state == STATE_BLOCKED)
+   {
+      uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+      if (!interrupts_were_enabled) g_HalIoOperations->DisableInterrupts();
+   }
+
+   return SUCCESS;
+}
+
+intptr_t Futex_Wake(void *proc_ptr, uint32_t *uaddr, uint32_t count)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   void *channel = futex_channel(proc, uaddr);
+   if (!channel) return -EINVAL;
+   if (count == 0) return 0;
+
+   /* Counted variant of Process_WakeByChannel: stop after releasing
+    * count sleepers so a single-waiter handoff does not thunder the
+    * whole wait list awake. */
+   intptr_t woken = 0;
+   uint32_t procs = Scheduler_GetProcessCount();
+   for (uint32_t i = 0; i < procs && (uint32_t)woken < count; ++i)
+   {
+      Process *p = Scheduler_GetProcessAt(i);
+      if (!p) continue;
+      if (p->state != STATE_BLOCKED) continue;
+      if (p->wait_channel != channel) continue;
+
+      p->wait_channel = NULL;
+      p->state = STATE_READY;
+      p->sched_boost = PROCESS_WAKE_BOOST;
+      Scheduler_UpdateRunnable(p);
+      ++woken;
+   }
+
+   return woken;
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include <stdint.h>
+
+/* Futex operations (SYS_FUTEX first argument) */
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+
+/* Block the caller while *uaddr still holds expected.  Returns 0 after
+ * a wake, -EAGAIN when the value already changed (the fast path raced
+ * ahead), -EINVAL for a bad address. */
+intptr_t Futex_Wait(void *proc, uint32_t *uaddr, uint32_t expected);
+
+/* Wake up to count processes waiting on uaddr; returns how many. */
+intptr_t Futex_Wake(void *proc, uint32_t *uaddr, uint32_t count);
+
+#endif
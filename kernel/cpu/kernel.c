@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include "kstack.h"
 #include "process.h"
 #include "scheduler.h"
 #include <hal/mem.h>
@@ -9,15 +10,8 @@
 
 static int allocate_kernel_stack(Process *proc)
 {
-   uint32_t stack_size = (g_SysInfo && g_SysInfo->memory.kernel_stack_size)
-                             ? g_SysInfo->memory.kernel_stack_size
-                             : 65536u;
-
-   proc->kernel_stack = kmalloc(stack_size);
-   if (!proc->kernel_stack) return -1;
-
-   proc->kernel_stack_size = stack_size;
-   return 0;
+   proc->kernel_stack = KStack_Allocate(&proc->kernel_stack_size);
+   return proc->kernel_stack ? 0 : -1;
 }
 
 Process *Process_CreateKernel(uint32_t entry_point)
@@ -33,6 +27,9 @@ Process *Process_CreateKernel(uint32_t entry_point)
    proc->ppid = 0;
    proc->state = STATE_READY;
    proc->kernel_mode = true;
+   proc->sched_class = CLASS_NORMAL;
+   proc->sched_boost = 0;
+   proc->cpu_affinity = PROCESS_AFFINITY_ALL;
    proc->uid = 0;
    proc->gid = 0;
    proc->euid = 0;
@@ -40,6 +37,8 @@ Process *Process_CreateKernel(uint32_t entry_point)
    proc->priority = 10;
    proc->ticks_remaining = 0;
    proc->signal_mask = 0;
+   proc->signal_pending = 0;
+   proc->signal_deliverable = false;
    proc->exit_code = 0;
 
    proc->page_directory = Process_GetKernelPageDirectory();
@@ -66,10 +65,11 @@ Process *Process_CreateKernel(uint32_t entry_point)
    proc->eflags = 0x202u;
    proc->saved_regs = NULL;
 
-   for (int i = 0; i < 16; ++i) proc->fd_table[i] = NULL;
+   proc->fd_table = FD_TableCreate();
 
-   if (Process_InitializeStandardIO(proc) != 0)
+   if (!proc->fd_table || Process_InitializeStandardIO(proc) != 0)
    {
+      FD_CloseAll(proc);
       free(proc->kernel_stack);
       free(proc);
       return NULL;
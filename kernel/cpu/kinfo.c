@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "kinfo.h"
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+
+/* The frame lives in the identity-mapped kernel window, so the kernel
+ * writes it through its physical address while user space reads the
+ * read-only alias at USER_KINFO_VA. */
+static uint32_t g_KInfoFrame = 0;
+static KernelInfoPage *g_KInfo = NULL;
+
+void KInfo_Initialize(void)
+{
+   g_KInfoFrame = PMM_AllocateZeroedPage();
+   if (!g_KInfoFrame)
+   {
+      logfmt(LOG_WARNING, "[KINFO] no frame for info page, queries stay "
+                          "syscall-only\n");
+      return;
+   }
+
+   g_KInfo = (KernelInfoPage *)g_KInfoFrame;
+   g_KInfo->magic = KINFO_MAGIC;
+   g_KInfo->version = KINFO_VERSION;
+
+   logfmt(LOG_INFO, "[KINFO] info page ready: frame=0x%08x\n", g_KInfoFrame);
+}
+
+uint32_t KInfo_Frame(void) { return g_KInfoFrame; }
+
+void KInfo_PublishTick(uint64_t ticks)
+{
+   if (!g_KInfo) return;
+
+   /* Single IRQ-context writer; odd seq tells readers a torn value may
+    * be in flight. */
+   g_KInfo->tick_seq++;
+   g_KInfo->tick_lo = (uint32_t)ticks;
+   g_KInfo->tick_hi = (uint32_t)(ticks >> 32);
+   g_KInfo->tick_seq++;
+}
+
+void KInfo_PublishTsc(uint32_t khz, uint32_t mult, uint32_t shift)
+{
+   if (!g_KInfo) return;
+
+   g_KInfo->tsc_mult = mult;
+   g_KInfo->tsc_shift = shift;
+   g_KInfo->tsc_khz = khz; /* Written last: non-zero khz marks validity */
+}
+
+void KInfo_PublishProcess(uint32_t pid, uint32_t ppid)
+{
+   if (!g_KInfo) return;
+
+   g_KInfo->pid = pid;
+   g_KInfo->ppid = ppid;
+}
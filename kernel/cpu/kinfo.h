@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef KINFO_H
+#define KINFO_H
+
+#include <stdint.h>
+
+/* =========================================================================
+ * Shared kernel info page (vDSO-style)
+ *
+ * One physical frame, mapped read-only into every user address space at
+ * USER_KINFO_VA, so libc-level wrappers answer getpid/gettime queries
+ * without a syscall round trip.  The kernel is uniprocessor, so the
+ * per-process fields are simply rewritten at context switch.
+ * ====================================================================== */
+
+#define KINFO_MAGIC 0x4F464E4Bu /* "KNFO" */
+#define KINFO_VERSION 1u
+
+/* Layout shared with userspace - append-only; bump KINFO_VERSION when
+ * fields change meaning. */
+typedef struct
+{
+   uint32_t magic;   /* KINFO_MAGIC */
+   uint32_t version; /* KINFO_VERSION */
+
+   /* Current process; rewritten by the scheduler at context switch. */
+   uint32_t pid;
+   uint32_t ppid;
+
+   /* Timer tick counter.  tick_seq is odd while the halves are being
+    * updated: readers retry until seq is even and unchanged across the
+    * two loads (seqlock, single IRQ writer). */
+   volatile uint32_t tick_seq;
+   volatile uint32_t tick_lo;
+   volatile uint32_t tick_hi;
+
+   /* TSC calibration: ns = cycles * tsc_mult >> tsc_shift (split the
+    * 64x32 product as Timer_GetMonotonicNs does).  tsc_khz is 0 until
+    * calibration succeeds - fall back to the tick counter then. */
+   uint32_t tsc_khz;
+   uint32_t tsc_mult;
+   uint32_t tsc_shift;
+} KernelInfoPage;
+
+void KInfo_Initialize(void);
+
+/* Physical frame backing the page, or 0 before initialization; exec
+ * maps it into each new address space. */
+uint32_t KInfo_Frame(void);
+
+/* Publishers - each overwrites its fields in place. */
+void KInfo_PublishTick(uint64_t ticks);
+void KInfo_PublishTsc(uint32_t khz, uint32_t mult, uint32_t shift);
+void KInfo_PublishProcess(uint32_t pid, uint32_t ppid);
+
+#endif
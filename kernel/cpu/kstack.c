@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "kstack.h"
+#include "lockstat.h"
+#include "spinlock.h"
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <stdbool.h>
+#include <sys/sys.h>
+
+#define KSTACK_POOL_CAPACITY 16u
+#define KSTACK_REFILL_BATCH 4u
+
+/* Written into the lowest word at allocation; a kernel stack grows down
+ * toward it, so an overflow clobbers the canary before anything else. */
+#define KSTACK_CANARY 0x57ACCA5Eu
+
+static void *g_StackPool[KSTACK_POOL_CAPACITY];
+static uint32_t g_StackPoolTop = 0;
+static Spinlock g_StackLock = SPINLOCK_INIT;
+
+static uint32_t kstack_size(void)
+{
+   return (g_SysInfo && g_SysInfo->memory.kernel_stack_size)
+              ? g_SysInfo->memory.kernel_stack_size
+              : 65536u;
+}
+
+void KStack_Initialize(void)
+{
+   Lockstat_Register(&g_StackLock, "kstack");
+}
+
+void *KStack_Allocate(uint32_t *size_out)
+{
+   uint32_t size = kstack_size();
+   void *stack = NULL;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_StackLock);
+   if (g_StackPoolTop > 0) stack = g_StackPool[--g_StackPoolTop];
+   Spinlock_ReleaseIrqRestore(&g_StackLock, interrupts_were_enabled);
+
+   if (!stack)
+   {
+      /* Pool dry: pull a batch off the heap so the next few forks are
+       * list pops again.  The heap work stays outside the lock. */
+      void *batch[KSTACK_REFILL_BATCH];
+      uint32_t got = 0;
+
+      for (uint32_t i = 0; i < KSTACK_REFILL_BATCH; i++)
+      {
+         batch[got] = kmalloc(size);
+         if (!batch[got]) break;
+         *(uint32_t *)batch[got] = KSTACK_CANARY;
+         got++;
+      }
+      if (got == 0) return NULL;
+
+      stack = batch[--got];
+
+      interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_StackLock);
+      while (got > 0 && g_StackPoolTop < KSTACK_POOL_CAPACITY)
+      {
+         g_StackPool[g_StackPoolTop++] = batch[--got];
+      }
+      Spinlock_ReleaseIrqRestore(&g_StackLock, interrupts_were_enabled);
+
+      while (got > 0) free(batch[--got]);
+   }
+
+   *size_out = size;
+   return stack;
+}
+
+void KStack_Free(void *stack, uint32_t size)
+{
+   if (!stack) return;
+
+   if (*(uint32_t *)stack != KSTACK_CANARY)
+   {
+      logfmt(LOG_WARNING, "[KSTACK] overflow canary clobbered: stack=%x\n",
+             (uint32_t)(uintptr_t)stack);
+      free(stack);
+      return;
+   }
+
+   /* Off-size stacks (e.g. after a config change) go back to the heap;
+    * the pool holds one size only. */
+   if (size != kstack_size())
+   {
+      free(stack);
+      return;
+   }
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_StackLock);
+   bool pooled = g_StackPoolTop < KSTACK_POOL_CAPACITY;
+   if (pooled) g_StackPool[g_StackPoolTop++] = stack; /* LIFO: warm first */
+   Spinlock_ReleaseIrqRestore(&g_StackLock, interrupts_were_enabled);
+
+   if (!pooled) free(stack);
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef KSTACK_H
+#define KSTACK_H
+
+#include <stdint.h>
+
+/* =========================================================================
+ * Kernel stack pool
+ *
+ * Every process needs a same-sized kernel stack, so fork+exit churn
+ * turns into a stream of identical kmalloc/free pairs.  The pool keeps
+ * retired stacks on a LIFO free list (the most recently used stack is
+ * the cache-warm one) and refills from the heap in batches when it
+ * runs dry.  The lowest word of each stack carries a canary that is
+ * checked on release; a clobbered canary means the owner overflowed
+ * and the stack is discarded instead of recycled.
+ * ====================================================================== */
+
+/* Registers the pool lock with the lockstat table. */
+void KStack_Initialize(void);
+
+/* Returns a kernel stack and stores its size, or NULL when the heap is
+ * exhausted. */
+void *KStack_Allocate(uint32_t *size_out);
+
+/* Returns a stack to the pool (or the heap, if the pool is full or the
+ * stack is damaged). */
+void KStack_Free(void *stack, uint32_t size);
+
+#endif
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "kthread.h"
+#include "scheduler.h"
+#include <hal/io.h>
+#include <std/stdio.h>
+
+/* Every kernel thread starts here with fn/arg handed over on its fresh
+ * stack (cdecl, pushed by KThread_Create), so one trampoline serves
+ * all workers without per-thread state. */
+static void __attribute__((noreturn)) kthread_entry(KThreadFn fn, void *arg)
+{
+   fn(arg);
+   KThread_Exit();
+}
+
+Process *KThread_Create(const char *name, KThreadFn fn, void *arg)
+{
+   if (!fn) return NULL;
+
+   Process *t = Process_CreateKernel((uint32_t)kthread_entry);
+   if (!t) return NULL;
+
+   /* Background services yield to everything else. */
+   t->sched_class = CLASS_BATCH;
+   Scheduler_UpdateRunnable(t);
+
+   /* Seed the entry trampoline's frame: [return][fn][arg].  The return
+    * slot is never used - kthread_entry does not return. */
+   t->esp -= 3 * sizeof(uint32_t);
+   uint32_t *sp = (uint32_t *)t->esp;
+   sp[0] = 0;
+   sp[1] = (uint32_t)fn;
+   sp[2] = (uint32_t)arg;
+   t->ebp = t->esp;
+
+   if (name)
+   {
+      snprintf(t->exec_path, sizeof(t->exec_path), "[%s]", name);
+   }
+
+   logfmt(LOG_INFO, "[KTHREAD] created: pid=%u name=%s\n", t->pid,
+          name ? name : "?");
+   return t;
+}
+
+void KThread_Park(void)
+{
+   Process *self = Process_GetCurrent();
+   if (!self || !self->kernel_mode) return;
+
+   uint8_t interrupts_were_enabled = g_HalIoOperations->DisableInterrupts();
+
+   /* A wake already arrived: consume it and keep running. */
+   if (self->kthread_unpark)
+   {
+      self->kthread_unpark = false;
+      if (interrupts_were_enabled) g_HalIoOperations->EnableInterrupts();
+      return;
+   }
+
+   Process_BlockOn(self, (void *)self);
+
+   /* Same idiom as the driver IRQ waits: sleep until the scheduler
+    * takes us off the CPU and a wake puts us back. */
+   g_HalIoOperations->EnableInterrupts();
+   while (self->state == STATE_BLOCKED)
+   {
+      g_HalIoOperations->iowait();
+   }
+   g_HalIoOperations->DisableInterrupts();
+
+   self->kthread_unpark = false;
+   if (interrupts_were_enabled) g_HalIoOperations->EnableInterrupts();
+}
+
+void KThread_Wake(Process *thread)
+{
+   if (!thread || !thread->kernel_mode) return;
+
+   /* Latch first so a park racing with this wake sees it. */
+   thread->kthread_unpark = true;
+   if (thread->state == STATE_BLOCKED)
+   {
+      Process_Unblock(thread);
+   }
+}
+
+void KThread_Exit(void)
+{
+   Process *self = Process_GetCurrent();
+   if (self)
+   {
+      logfmt(LOG_INFO, "[KTHREAD] exit: pid=%u\n", self->pid);
+      Process_Exit(self, 0);
+   }
+
+   /* Wait out the remainder of the time slice as a zombie. */
+   for (;;)
+   {
+      g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+   }
+}
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef KTHREAD_H
+#define KTHREAD_H
+
+#include <cpu/process.h>
+
+/* =========================================================================
+ * Kernel threads
+ *
+ * Thin wrapper over Process_CreateKernel for background services
+ * (write-back, read-ahead, frame zeroing...).  Threads run from the
+ * batch class so they never compete with interactive work, and follow
+ * a park/wake discipline: the worker parks itself when its queue is
+ * empty and producers wake it when there is something to do.
+ * ====================================================================== */
+
+typedef void (*KThreadFn)(void *arg);
+
+/* Spawn a kernel thread running fn(arg).  `name` shows up in the
+ * process table as "[name]".  Returns NULL on failure; the thread is
+ * runnable immediately. */
+Process *KThread_Create(const char *name, KThreadFn fn, void *arg);
+
+/* Block the calling thread until the next KThread_Wake.  A wake that
+ * raced ahead of the park is consumed instead of lost. */
+void KThread_Park(void);
+
+/* Make a parked thread runnable again.  IRQ-safe; waking a thread
+ * that is not parked just primes its next park to return at once. */
+void KThread_Wake(Process *thread);
+
+/* Terminate the calling thread.  Returning from fn does this
+ * implicitly. */
+void KThread_Exit(void) __attribute__((noreturn));
+
+#endif
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "lockstat.h"
+#include <mem/mm_kernel.h> /* memcpy */
+#include <std/stdio.h>
+
+#define LOCKSTAT_MAX_LOCKS 32
+
+typedef struct
+{
+   Spinlock *lock;
+   const char *name;
+} LockstatEntry;
+
+static LockstatEntry g_Lockstats[LOCKSTAT_MAX_LOCKS];
+static uint32_t g_LockstatCount = 0;
+
+void Lockstat_Register(Spinlock *lock, const char *name)
+{
+   if (!lock || !name) return;
+
+   if (g_LockstatCount >= LOCKSTAT_MAX_LOCKS)
+   {
+      logfmt(LOG_WARNING, "[LOCK] stat table full, %s not tracked\n", name);
+      return;
+   }
+
+   g_Lockstats[g_LockstatCount].lock = lock;
+   g_Lockstats[g_LockstatCount].name = name;
+   g_LockstatCount++;
+}
+
+uint32_t Lockstat_Read(uint32_t offset, uint32_t size, void *buffer)
+{
+   static char text[4096];
+   uint32_t len = 0;
+
+   for (uint32_t i = 0; i < g_LockstatCount && len < sizeof(text); i++)
+   {
+      const Spinlock *lock = g_Lockstats[i].lock;
+      uint32_t acquisitions = lock->acquisitions;
+      uint64_t avg_hold =
+          acquisitions ? lock->hold_cycles / acquisitions : 0;
+
+      int n = snprintf(text + len, sizeof(text) - len,
+                       "lock=%s acquisitions=%u spins=%u hold=%llu avg=%llu\n",
+                       g_Lockstats[i].name, acquisitions, lock->spins,
+                       lock->hold_cycles, avg_hold);
+      if (n < 0) break;
+      len += (uint32_t)n;
+   }
+
+   if (len >= sizeof(text)) len = sizeof(text) - 1;
+   if (offset >= len) return 0;
+
+   uint32_t avail = len - offset;
+   if (avail > size) avail = size;
+   memcpy((uint8_t *)buffer, text + offset, avail);
+
+   return avail;
+}
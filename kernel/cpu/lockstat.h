@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef LOCKSTAT_H
+#define LOCKSTAT_H
+
+#include "spinlock.h"
+#include <stdint.h>
+
+/* =========================================================================
+ * Lock contention registry
+ *
+ * Long-lived locks register here by name; /dev/lockstat renders their
+ * acquisition, spin and hold-cycle counters as text, same shape as
+ * /dev/kstat and /dev/irqstat.  Registration is optional - short-lived
+ * or per-object locks just stay unlisted.
+ * ====================================================================== */
+
+void Lockstat_Register(Spinlock *lock, const char *name);
+
+/* devfs read callback body for /dev/lockstat. */
+uint32_t Lockstat_Read(uint32_t offset, uint32_t size, void *buffer);
+
+#endif
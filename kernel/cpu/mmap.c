@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "process.h"
+#include <hal/mem.h>
+#include <mem/mm_kernel.h>
+#include <mem/mm_proc.h>
+#include <std/minmax.h>
+#include <std/stdio.h>
+#include <std/string.h>
+#include <syscall/syscall.h>
+
+#define MMAP_ALIGN_UP(v) (((v) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
+
+static ProcessMapping *find_free_slot(Process *proc)
+{
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      if (!proc->mappings[i].used) return &proc->mappings[i];
+   }
+   return NULL;
+}
+
+static ProcessMapping *find_mapping(Process *proc, uint32_t page_va)
+{
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      ProcessMapping *m = &proc->mappings[i];
+      if (!m->used) continue;
+      if (page_va >= m->start && page_va < m->start + m->length) return m;
+   }
+   return NULL;
+}
+
+static void release_mapping(Process *proc, ProcessMapping *m)
+{
+   /* VMM_FreeInDir frees whatever frames were faulted in, drops the
+      mappings in one pass and returns the VMA range to the free pool;
+      never-touched pages of a file mapping simply have no frame. */
+   VMM_FreeInDir(proc->page_directory, (void *)m->start, m->length);
+
+   if (m->file)
+   {
+      VFS_Close(m->file);
+      m->file = NULL;
+   }
+   memset(m, 0, sizeof(*m));
+}
+
+static intptr_t mmap_anonymous(Process *proc, ProcessMapping *m,
+                               uint32_t length, uint32_t prot)
+{
+   uint32_t page_flags = HAL_PAGE_USER;
+   if (prot & PROT_WRITE) page_flags |= HAL_PAGE_RW;
+
+   /* Anonymous memory is populated eagerly: VMM_AllocateInDir hands back
+      zeroed pages, which is exactly the mmap contract. */
+   void *va = VMM_AllocateInDir(proc->page_directory, NULL, length,
+                                page_flags);
+   if (!va) return -ENOMEM;
+
+   m->start = (uint32_t)va;
+   m->length = length;
+   m->page_flags = page_flags | HAL_PAGE_PRESENT;
+   m->file_backed = false;
+   m->used = true;
+   return (intptr_t)va;
+}
+
+static intptr_t mmap_file(Process *proc, ProcessMapping *m, uint32_t length,
+                          uint32_t prot, int fd, uint32_t offset)
+{
+   /* Only read-only file mappings are supported; writeback of dirty
+      mapped pages is a separate problem. */
+   if (prot & PROT_WRITE) return -EACCES;
+   if (offset & (PAGE_SIZE - 1)) return -EINVAL;
+
+   if (fd < 0 || fd >= FD_TABLE_SIZE) return -EBADF;
+   FileDescriptor *fdesc = FD_Get(proc, fd);
+   if (!fdesc || !fdesc->readable || !fdesc->inode) return -EBADF;
+   if (strlen(fdesc->path) >= PROCESS_EXEC_PATH_MAX) return -EINVAL;
+
+   uint32_t size = VFS_GetSize((VFS_File *)fdesc->inode);
+   if (offset >= size) return -EINVAL;
+
+   /* Reserve address space only; pages are read in on first access by
+      Process_HandleMappingFault, through the VFS and the block cache. */
+   void *va = VMM_ReserveInDir(proc->page_directory, length,
+                               HAL_PAGE_USER);
+   if (!va) return -ENOMEM;
+
+   m->start = (uint32_t)va;
+   m->length = length;
+   m->page_flags = HAL_PAGE_PRESENT | HAL_PAGE_USER;
+   m->file_backed = true;
+   m->file_offset = offset;
+   m->file_size = min(length, size - offset);
+   memcpy(m->path, fdesc->path, strlen(fdesc->path) + 1);
+   m->file = NULL;
+   m->used = true;
+   return (intptr_t)va;
+}
+
+intptr_t Process_Mmap(Process *proc, uint32_t length, uint32_t prot,
+                      uint32_t flags, int fd, uint32_t offset)
+{
+   if (!proc || length == 0) return -EINVAL;
+
+   uint32_t aligned_length = MMAP_ALIGN_UP(length);
+   if (aligned_length < length) return -EINVAL; // Wrapped past 4 GiB
+
+   ProcessMapping *m = find_free_slot(proc);
+   if (!m) return -ENOMEM;
+
+   if ((flags & MAP_ANONYMOUS) || fd < 0)
+   {
+      return mmap_anonymous(proc, m, aligned_length, prot);
+   }
+
+   return mmap_file(proc, m, aligned_length, prot, fd, offset);
+}
+
+int Process_Munmap(Process *proc, uint32_t addr, uint32_t length)
+{
+   if (!proc || length == 0) return -EINVAL;
+   if (addr & (PAGE_SIZE - 1)) return -EINVAL;
+
+   uint32_t aligned_length = MMAP_ALIGN_UP(length);
+
+   /* Whole-mapping unmaps only; splitting a mapping is not supported. */
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      ProcessMapping *m = &proc->mappings[i];
+      if (!m->used) continue;
+      if (m->start != addr || m->length != aligned_length) continue;
+
+      release_mapping(proc, m);
+      return SUCCESS;
+   }
+
+   return -EINVAL;
+}
+
+/* Fault a page of an mmap region in.  Anonymous mappings are eagerly
+ * populated, so in practice this serves read-only file mappings: the
+ * page is zero-filled, overlaid with file bytes where the mapping is
+ * backed, and installed read-only.
+ */
+int Process_HandleMappingFault(Process *proc, uint32_t page_va)
+{
+   ProcessMapping *m = find_mapping(proc, page_va);
+   if (!m) return -1;
+
+   /* Pre-zeroed frames live in the identity-mapped window; fill the
+      file-backed part directly. */
+   uint32_t phys = PMM_AllocateZeroedPage();
+   if (!phys) return -1;
+
+   uint32_t map_off = page_va - m->start;
+   if (m->file_backed && map_off < m->file_size)
+   {
+      if (!m->file && m->path[0]) m->file = VFS_Open(m->path);
+      if (!m->file)
+      {
+         PMM_FreePhysicalPage(phys);
+         return -1;
+      }
+
+      if (VFS_Seek(m->file, m->file_offset + map_off) < 0)
+      {
+         PMM_FreePhysicalPage(phys);
+         return -1;
+      }
+
+      uint8_t *dst = (uint8_t *)phys;
+      uint32_t remaining = min(PAGE_SIZE, m->file_size - map_off);
+      while (remaining > 0)
+      {
+         uint32_t got = VFS_Read(m->file, remaining, dst);
+         if (got == 0 || got > remaining)
+         {
+            PMM_FreePhysicalPage(phys);
+            return -1;
+         }
+         dst += got;
+         remaining -= got;
+      }
+   }
+
+   if (g_HalPagingOperations->MapPage(proc->page_directory, page_va, phys,
+                                      m->page_flags) < 0)
+   {
+      PMM_FreePhysicalPage(phys);
+      return -1;
+   }
+
+   return 0;
+}
+
+void Process_ReleaseMappings(Process *proc)
+{
+   if (!proc || !proc->page_directory) return;
+
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      if (proc->mappings[i].used) release_mapping(proc, &proc->mappings[i]);
+   }
+
+   /* The batched-syscall ring page was one of those mappings; drop the
+      kernel view with it. */
+   proc->ring_page = NULL;
+   proc->ring_sq_entries = 0;
+   proc->ring_cq_entries = 0;
+}
@@ -22,13 +22,101 @@ typedef enum
    STATE_WAITING = 4u,
 } ProcessState;
 
+/* Scheduling classes, highest priority first.  The scheduler drains the
+ * highest non-empty class before looking at the next one. */
+typedef enum
+{
+   CLASS_INTERACTIVE = 0u,
+   CLASS_NORMAL = 1u,
+   CLASS_BATCH = 2u,
+} ProcessClass;
+
+#define PROCESS_CLASS_COUNT 3
+
+/* Picks a freshly woken process gets scheduled from the interactive
+ * class before falling back to its base class. */
+#define PROCESS_WAKE_BOOST 4
+
+/* Default CPU affinity: runnable anywhere.  One bit per CPU index as
+ * enumerated by i686_SMP_Detect; only bit 0 matters until the APs are
+ * brought online. */
+#define PROCESS_AFFINITY_ALL 0xFFFFFFFFu
+
+/* Demand paging: PT_LOAD extents recorded at exec time.  Pages are
+ * faulted in from the binary on first access instead of being read
+ * eagerly, so exec latency no longer scales with binary size. */
+#define PROCESS_MAX_SEGMENTS 8
+#define PROCESS_EXEC_PATH_MAX 256
+
+typedef struct
+{
+   uint32_t vaddr;       // Segment start (not necessarily page-aligned)
+   uint32_t memsz;       // Bytes in memory (anything past filesz is BSS)
+   uint32_t filesz;      // Bytes backed by the file
+   uint32_t file_offset; // Offset of the segment within the binary
+} ProcessSegment;
+
+/* Lazy FPU/SSE context (arch i686 fpu.c).  The 512-byte fxsave image
+ * needs 16-byte alignment and the heap only guarantees 8, so the
+ * buffer is over-allocated and the image aligned inside it. */
+#define PROCESS_FPU_IMAGE_SIZE 512u
+#define PROCESS_FPU_ALLOC_SIZE (PROCESS_FPU_IMAGE_SIZE + 15u)
+
+static inline void *Process_FpuImage(void *fpu_state)
+{
+   return (void *)(((uintptr_t)fpu_state + 15u) & ~(uintptr_t)15u);
+}
+
+/* mmap regions.  Anonymous mappings are populated eagerly; read-only
+ * file mappings demand-page through the VFS (and so the block cache),
+ * reusing the lazy-handle pattern of the exec segments above. */
+#define PROCESS_MAX_MAPPINGS 8
+
 typedef struct
+{
+   uint32_t start;       // Page-aligned base of the mapping
+   uint32_t length;      // Page-aligned span in bytes
+   uint32_t page_flags;  // HAL_PAGE_* flags applied when faulting in
+   bool file_backed;     // false: anonymous zero-fill memory
+   uint32_t file_offset; // Offset of the mapping within the file
+   uint32_t file_size;   // Bytes backed by the file; the rest zero-fills
+   char path[PROCESS_EXEC_PATH_MAX];
+   VFS_File *file; // Cached handle, opened lazily on first fault
+   bool used;
+} ProcessMapping;
+
+typedef struct Process
 {
    uint32_t pid;     // Process ID
    uint32_t ppid;    // Parent process ID
    uint32_t state;   // ProcessState
    bool kernel_mode; // true if running in kernel mode
 
+   /* Slot index in the scheduler's process table; maintained by
+    * Scheduler_RegisterProcess so ready-bitmap updates are O(1).  Only
+    * meaningful while the process is registered. */
+   uint32_t sched_slot;
+
+   /* Chain link for the PID hash table (core.c); maintained alongside
+    * the scheduler registration so pid lookups are O(1). */
+   struct Process *pid_hash_next;
+
+   /* Intrusive list of this process's children (fork links, destroy
+    * unlinks), so Process_Wait scans only its own children instead of
+    * the whole scheduler table. */
+   struct Process *child_head;
+   struct Process *child_sibling;
+
+   /* Base scheduling class (ProcessClass) and remaining wake-up boost
+    * picks.  While sched_boost is nonzero the process is scheduled from
+    * the interactive class so I/O completions get low latency. */
+   uint32_t sched_class;
+   uint32_t sched_boost;
+
+   /* Bitmask of CPUs this process may run on (bit n = CPU n).  The
+    * scheduler skips slots whose mask excludes the selecting CPU. */
+   uint32_t cpu_affinity;
+
    // Identity and credentials
    uint32_t uid;
    uint32_t gid;
@@ -42,6 +130,17 @@ typedef struct
    uint32_t stack_start; // Start of user stack
    uint32_t stack_end;   // End of user stack
 
+   /* Demand-paged ELF segments of the current binary.  exec_file caches
+    * the open handle between faults and is opened lazily from exec_path
+    * (a fork child starts with exec_file == NULL). */
+   ProcessSegment segments[PROCESS_MAX_SEGMENTS];
+   uint32_t segment_count;
+   char exec_path[PROCESS_EXEC_PATH_MAX];
+   VFS_File *exec_file;
+
+   /* mmap regions (SYS_MMAP/SYS_MUNMAP). */
+   ProcessMapping mappings[PROCESS_MAX_MAPPINGS];
+
    /* CPU state – flat fields used at process creation and fork.
     * During a live context switch the scheduler instead consults
     * saved_regs, which points directly into the interrupt stack frame
@@ -61,16 +160,56 @@ typedef struct
     * been preempted (e.g. a freshly-created, not-yet-run process). */
    Registers *saved_regs;
 
-   // File descriptors
-   FileDescriptor *fd_table[16]; // Open file descriptors (per-process)
+   /* Lazily saved FPU/SSE context (PROCESS_FPU_ALLOC_SIZE bytes, see
+    * Process_FpuImage above).  NULL until the process first touches
+    * the FPU; owned and filled by the arch #NM handler. */
+   void *fpu_state;
+
+   /* Descriptor table; shared with fork siblings until the first
+    * mutation copies it (see FdTable in fs/fd/fd.h). */
+   FdTable *fd_table;
+
+   /* Batched-syscall ring (syscall/ring.c).  ring_page is the kernel
+    * identity-mapped view of the shared page; the user-side mapping
+    * lives in mappings[] and is torn down with the rest of them on
+    * exec/exit.  Entry counts are cached here so the kernel never
+    * trusts geometry read back from user-writable memory.  Fork leaves
+    * these NULL/0 in the child: its copy of the page is plain memory
+    * until it sets up a ring of its own. */
+   void *ring_page;
+   uint32_t ring_sq_entries;
+   uint32_t ring_cq_entries;
 
    // Scheduling
    uint32_t priority;        // Priority level
    uint32_t ticks_remaining; // Time slice remaining
    void *wait_channel;       // Sleep channel for blocking operations
 
-   // Signals
-   uint32_t signal_mask; // Blocked signals
+   /* Kernel threads only: a wake that arrives before the thread parks
+    * is latched here so KThread_Park returns immediately instead of
+    * sleeping through it (see cpu/kthread.c). */
+   volatile bool kthread_unpark;
+
+   /* Signals.  Pending and blocked sets are 32-bit masks (bit n-1 for
+    * signal n) so send, mask and dispatch are single mask operations;
+    * signal_deliverable caches (pending & ~mask) != 0 so the syscall
+    * return path pays one test when nothing is pending. */
+   uint32_t signal_mask;          // Blocked signals
+   uint32_t signal_pending;       // Raised but not yet delivered
+   bool signal_deliverable;       // Fast flag for the return path
+   uintptr_t signal_handlers[32]; // SIG_DFL / SIG_IGN / user entry
+
+   /* CPU accounting (PIT ticks).  Timer_Tick charges the interrupted
+    * process one tick per interrupt: to system time while it sits
+    * inside a syscall (or is a kernel thread), to user time otherwise.
+    * syscall_depth is maintained by syscall_dispatch.  The reaped_*
+    * fields hold the times of the most recently reaped child, captured
+    * by Process_Wait so wait4 can fill rusage after the child is gone. */
+   uint64_t cpu_user_ticks;
+   uint64_t cpu_system_ticks;
+   uint32_t syscall_depth;
+   uint64_t reaped_user_ticks;
+   uint64_t reaped_system_ticks;
 
    // Exit status
    int exit_code; // Exit status when terminated
@@ -87,11 +226,36 @@ Process *Process_CreateKernel(uint32_t entry_point);
 Process *Process_Clone(Process *parent, const Registers *parent_regs);
 int Process_Execute(Process *proc, const char *path, const char *const argv[],
                     const char *const envp[]);
+int Process_HandlePageFault(uint32_t fault_address, uint32_t error_code);
+
+/* Warm the exec cache with one binary without executing it (boot-time
+ * preload); returns the number of pages cached or a negative error. */
+int Process_PreloadBinary(const char *path);
+
+/* mmap support (kernel/cpu/mmap.c) */
+intptr_t Process_Mmap(Process *proc, uint32_t length, uint32_t prot,
+                      uint32_t flags, int fd, uint32_t offset);
+int Process_Munmap(Process *proc, uint32_t addr, uint32_t length);
+int Process_HandleMappingFault(Process *proc, uint32_t page_va);
+void Process_ReleaseMappings(Process *proc);
 void Process_Exit(Process *proc, int exit_code);
 void Process_Destroy(Process *proc);
+
+/* wait4 options */
+#define WNOHANG 0x1
+
 int Process_Wait(Process *parent, int32_t pid, int *status, int options);
+void Process_ChildLink(Process *parent, Process *child);
+void Process_ChildUnlink(Process *parent, Process *child);
 Process *Process_GetCurrent(void);
 void Process_SetCurrent(Process *proc);
+
+/* PID hash table: O(1) pid -> process lookups for waitpid, kill and
+ * getppid-style queries.  Insert/remove are called by the scheduler
+ * when a process enters or leaves its table. */
+Process *Process_FindByPid(uint32_t pid);
+void Process_PidHashInsert(Process *proc);
+void Process_PidHashRemove(Process *proc);
 int Process_InitializeStandardIO(Process *proc);
 void Process_SelfTest(void);
 void Process_BlockOn(Process *proc, void *wait_channel);
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "profile.h"
+#include <std/compiler.h>
+#include <std/stdio.h>
+#include <std/string.h>
+#include <sys/cmdline.h>
+#include <sys/sys.h>
+
+/* 8192 samples is ~8 seconds of history at TIMER_HZ; the ring simply
+ * overwrites the oldest sample, so a read always sees the most recent
+ * window. */
+#define PROFILE_RING_SIZE 8192u
+
+/* Each sample renders as "xxxxxxxx\n" so readers can seek by sample
+ * index without the kernel staging the whole dump. */
+#define PROFILE_LINE_LEN 9u
+
+static bool g_ProfileEnabled = false;
+static uint32_t g_ProfileRing[PROFILE_RING_SIZE];
+static volatile uint32_t g_ProfileHead = 0; /* Total samples ever taken */
+
+KCOLD void Profile_Initialize(void)
+{
+   if (CmdLine_GetBool(CMDLINE_OPT_PROFILE))
+   {
+      g_ProfileEnabled = true;
+      logfmt(LOG_INFO, "[PROFILE] eip sampling enabled: ring=%u\n",
+             PROFILE_RING_SIZE);
+   }
+}
+
+void Profile_Sample(uint32_t eip)
+{
+   if (!g_ProfileEnabled) return;
+
+   /* Single IRQ-context writer, so no locking around the ring. */
+   g_ProfileRing[g_ProfileHead % PROFILE_RING_SIZE] = eip;
+   g_ProfileHead++;
+}
+
+uint32_t Profile_Read(uint32_t offset, uint32_t size, void *buffer)
+{
+   uint32_t head = g_ProfileHead;
+   uint32_t count = (head < PROFILE_RING_SIZE) ? head : PROFILE_RING_SIZE;
+   uint32_t start = head - count; /* Oldest retained sample */
+
+   uint32_t total = count * PROFILE_LINE_LEN;
+   if (offset >= total) return 0;
+
+   uint8_t *out = (uint8_t *)buffer;
+   uint32_t copied = 0;
+
+   while (copied < size && offset + copied < total)
+   {
+      uint32_t pos = offset + copied;
+      uint32_t sample = (start + pos / PROFILE_LINE_LEN) % PROFILE_RING_SIZE;
+      uint32_t column = pos % PROFILE_LINE_LEN;
+
+      char line[PROFILE_LINE_LEN + 1];
+      snprintf(line, sizeof(line), "%08x\n", g_ProfileRing[sample]);
+
+      uint32_t chunk = PROFILE_LINE_LEN - column;
+      if (chunk > size - copied) chunk = size - copied;
+
+      memcpy(out + copied, line + column, chunk);
+      copied += chunk;
+   }
+
+   return copied;
+}
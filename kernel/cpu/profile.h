@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+/* =========================================================================
+ * Statistical profiler (boot with "profile" to enable)
+ *
+ * The timer interrupt records the interrupted EIP into a ring buffer;
+ * /dev/profile renders the samples as fixed-width hex lines and
+ * scripts/profile_symbolize.py folds them into a flat per-symbol
+ * profile against the kernel ELF.
+ * ====================================================================== */
+
+void Profile_Initialize(void);
+
+/* Record one sample.  Called from the timer IRQ; a single branch when
+ * profiling is disabled. */
+void Profile_Sample(uint32_t eip);
+
+/* Render the retained samples as text for /dev/profile. */
+uint32_t Profile_Read(uint32_t offset, uint32_t size, void *buffer);
+
+#endif
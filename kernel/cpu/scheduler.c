@@ -1,9 +1,17 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "scheduler.h"
+#include "softirq.h"
+#include "timer.h"
+#include <hal/hal.h>
+#include <hal/io.h>
+#include <mem/mm_kernel.h>
+#include <std/klog.h>
 #include <std/stdio.h>
+#include <std/trace.h>
 
 #define SCHED_MAX_PROCESSES 128
+#define SCHED_BITMAP_WORDS (SCHED_MAX_PROCESSES / 32)
 
 #define PROCESS_STATE_READY 0u
 #define PROCESS_STATE_RUNNING 1u
@@ -11,92 +19,305 @@
 #define PROCESS_STATE_ZOMBIE 3u
 #define PROCESS_STATE_WAITING 4u
 
+/* Processes keep their slot for their whole lifetime (no compaction), so
+ * Process->sched_slot stays a valid index and the ready bitmap below can
+ * be updated in O(1) on every state change.  Scheduler_GetProcessAt may
+ * therefore return NULL for holes; iterating callers already skip them. */
 static Process *g_SchedulerProcesses[SCHED_MAX_PROCESSES];
-static uint32_t g_SchedulerProcessCount = 0;
-static uint32_t g_SchedulerLastIndex = 0;
+static uint32_t g_SchedulerSlotHigh = 0; /* Highest used slot + 1 */
+
+/* One bitmap per scheduling class, one bit per slot; a bit is set while
+ * the slot's process is runnable (READY or RUNNING) in that class.
+ * Scheduler_Schedule drains the highest non-empty class, round-robin
+ * within it, so selection cost stays a handful of word tests regardless
+ * of how many blocked processes exist. */
+static uint32_t g_SchedulerReadyBitmap[PROCESS_CLASS_COUNT]
+                                      [SCHED_BITMAP_WORDS];
+static uint32_t g_SchedulerLastSlot[PROCESS_CLASS_COUNT];
 static Process *g_SchedulerNextRunnable = NULL;
 
+/* The idle task.  It lives outside the process table and the class
+ * bitmaps and is handed out by Scheduler_Schedule only when no real
+ * process is runnable, so an idle machine sits in hlt instead of
+ * spinning through the scheduler; the i8253 tick wakes it back up. */
+static Process *g_SchedulerIdleProcess = NULL;
+
+#define SCHED_IDLE_STACK_SIZE 16384u
+
+static void scheduler_idle_loop(void)
+{
+   for (;;)
+   {
+      /* Cheap deferred work first, then sleep until the next interrupt.
+       * Frame zeroing moved to the kzero kernel thread. */
+      Softirq_Drain();
+      KLOG_Drain();
+      Heap_CheckIncremental();
+
+      /* Keep the atomic-context reserves stocked while nothing is
+       * runnable; both are cheap no-ops when already at watermark. */
+      PMM_ReplenishAtomicReserve();
+      Slab_RefillIrqPools();
+
+      /* Nudge the cache shrinkers before real pressure turns into
+       * allocation failures; a no-op above the watermark. */
+      PMM_ShrinkIfLow();
+
+      /* Age one process's heap and compress out pages idle through two
+       * passes; cold daemon heaps stop pinning whole frames. */
+      ZStore_BackgroundScan();
+
+      /* Dynamic tick: with nothing runnable, stretch the PIT into a
+       * one-shot aimed at the nearest timer-wheel deadline instead of
+       * taking TIMER_HZ pointless wake-ups a second (a constant exit
+       * storm under virtualization). */
+      g_HalIoOperations->DisableInterrupts();
+      if (Scheduler_RunnableCount() == 0)
+      {
+         i686_i8253_EnterTickless(Timer_TicksToNextDeadline());
+      }
+
+      g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+
+      /* Whatever woke us: settle the tick accounting and restore the
+       * periodic rate before anything runs off the wheel. */
+      g_HalIoOperations->DisableInterrupts();
+      i686_i8253_ExitTickless();
+      g_HalIoOperations->EnableInterrupts();
+   }
+}
+
+static void scheduler_create_idle(void)
+{
+   Process *idle = (Process *)kzalloc(sizeof(Process));
+   if (!idle)
+   {
+      logfmt(LOG_WARNING, "[SCHED] no memory for idle task\n");
+      return;
+   }
+
+   idle->kernel_stack = kmalloc(SCHED_IDLE_STACK_SIZE);
+   if (!idle->kernel_stack)
+   {
+      logfmt(LOG_WARNING, "[SCHED] no memory for idle stack\n");
+      free(idle);
+      return;
+   }
+   idle->kernel_stack_size = SCHED_IDLE_STACK_SIZE;
+
+   idle->pid = 0; /* never enters the process table or the pid hash */
+   idle->state = PROCESS_STATE_READY;
+   idle->kernel_mode = true;
+   idle->sched_class = CLASS_BATCH;
+   idle->sched_slot = SCHED_MAX_PROCESSES;
+   idle->eip = (uint32_t)scheduler_idle_loop;
+   idle->esp = (uint32_t)idle->kernel_stack + SCHED_IDLE_STACK_SIZE;
+   idle->ebp = idle->esp;
+   idle->eflags = 0x202u;
+
+   g_SchedulerIdleProcess = idle;
+}
+
+static inline bool scheduler_state_runnable(uint32_t state)
+{
+   return state == PROCESS_STATE_READY || state == PROCESS_STATE_RUNNING;
+}
+
+/* The class a process is scheduled from right now: its base class, or
+ * CLASS_INTERACTIVE while a wake-up boost is pending. */
+static inline uint32_t scheduler_effective_class(const Process *process)
+{
+   if (process->sched_boost > 0) return CLASS_INTERACTIVE;
+   if (process->sched_class >= PROCESS_CLASS_COUNT) return CLASS_NORMAL;
+   return process->sched_class;
+}
+
+static inline void scheduler_bitmap_set(uint32_t cls, uint32_t slot)
+{
+   g_SchedulerReadyBitmap[cls][slot / 32] |= 1u << (slot % 32);
+}
+
+static inline void scheduler_bitmap_clear(uint32_t cls, uint32_t slot)
+{
+   g_SchedulerReadyBitmap[cls][slot / 32] &= ~(1u << (slot % 32));
+}
+
+static inline void scheduler_bitmap_clear_all(uint32_t slot)
+{
+   for (uint32_t cls = 0; cls < PROCESS_CLASS_COUNT; ++cls)
+      scheduler_bitmap_clear(cls, slot);
+}
+
+/* Find the first set bit of `cls` at or after `start`, wrapping around
+ * once.  Returns the slot index, or -1 when the class is empty. */
+static int scheduler_bitmap_next(uint32_t cls, uint32_t start)
+{
+   start %= SCHED_MAX_PROCESSES;
+
+   for (uint32_t n = 0; n <= SCHED_BITMAP_WORDS; ++n)
+   {
+      uint32_t word_index = ((start / 32) + n) % SCHED_BITMAP_WORDS;
+      uint32_t word = g_SchedulerReadyBitmap[cls][word_index];
+
+      if (n == 0)
+      {
+         /* Mask off bits before the starting slot in the first word. */
+         word &= ~0u << (start % 32);
+      }
+      else if (n == SCHED_BITMAP_WORDS)
+      {
+         /* Wrapped all the way around: only bits before `start` remain. */
+         if (word_index != start / 32) break;
+         word &= ~(~0u << (start % 32));
+      }
+
+      if (word != 0)
+      {
+         return (int)(word_index * 32 + (uint32_t)__builtin_ctz(word));
+      }
+   }
+
+   return -1;
+}
+
 void Scheduler_Initialize()
 {
    for (uint32_t i = 0; i < SCHED_MAX_PROCESSES; ++i)
    {
       g_SchedulerProcesses[i] = NULL;
    }
+   for (uint32_t cls = 0; cls < PROCESS_CLASS_COUNT; ++cls)
+   {
+      for (uint32_t i = 0; i < SCHED_BITMAP_WORDS; ++i)
+      {
+         g_SchedulerReadyBitmap[cls][i] = 0;
+      }
+      g_SchedulerLastSlot[cls] = 0;
+   }
 
-   g_SchedulerProcessCount = 0;
-   g_SchedulerLastIndex = 0;
+   g_SchedulerSlotHigh = 0;
    g_SchedulerNextRunnable = NULL;
+
+   scheduler_create_idle();
 }
 
 void Scheduler_RegisterProcess(Process *process)
 {
    if (!process) return;
 
-   for (uint32_t i = 0; i < g_SchedulerProcessCount; ++i)
+   /* Already registered? */
+   if (process->sched_slot < SCHED_MAX_PROCESSES &&
+       g_SchedulerProcesses[process->sched_slot] == process)
    {
-      if (g_SchedulerProcesses[i] == process)
-      {
-         return;
-      }
+      return;
    }
 
-   if (g_SchedulerProcessCount >= SCHED_MAX_PROCESSES)
+   for (uint32_t i = 0; i < SCHED_MAX_PROCESSES; ++i)
    {
-      logfmt(LOG_WARNING, "[SCHED] process list full, pid=%u not queued\n",
-             process->pid);
+      if (g_SchedulerProcesses[i] != NULL) continue;
+
+      g_SchedulerProcesses[i] = process;
+      process->sched_slot = i;
+      if (i >= g_SchedulerSlotHigh) g_SchedulerSlotHigh = i + 1;
+
+      scheduler_bitmap_clear_all(i);
+      if (scheduler_state_runnable(process->state))
+         scheduler_bitmap_set(scheduler_effective_class(process), i);
+      Process_PidHashInsert(process);
       return;
    }
 
-   g_SchedulerProcesses[g_SchedulerProcessCount++] = process;
+   logfmt(LOG_WARNING, "[SCHED] process list full, pid=%u not queued\n",
+          process->pid);
 }
 
 void Scheduler_UnregisterProcess(Process *process)
 {
-   if (!process || g_SchedulerProcessCount == 0) return;
+   if (!process) return;
 
-   for (uint32_t i = 0; i < g_SchedulerProcessCount; ++i)
+   uint32_t slot = process->sched_slot;
+   if (slot >= SCHED_MAX_PROCESSES || g_SchedulerProcesses[slot] != process)
+      return; /* Not registered */
+
+   g_SchedulerProcesses[slot] = NULL;
+   scheduler_bitmap_clear_all(slot);
+   Process_PidHashRemove(process);
+
+   while (g_SchedulerSlotHigh > 0 &&
+          g_SchedulerProcesses[g_SchedulerSlotHigh - 1] == NULL)
    {
-      if (g_SchedulerProcesses[i] != process) continue;
+      --g_SchedulerSlotHigh;
+   }
 
-      for (uint32_t j = i; j + 1 < g_SchedulerProcessCount; ++j)
-      {
-         g_SchedulerProcesses[j] = g_SchedulerProcesses[j + 1];
-      }
+   if (g_SchedulerNextRunnable == process) g_SchedulerNextRunnable = NULL;
+}
 
-      g_SchedulerProcesses[g_SchedulerProcessCount - 1] = NULL;
-      --g_SchedulerProcessCount;
+void Scheduler_UpdateRunnable(Process *process)
+{
+   if (!process) return;
 
-      if (g_SchedulerProcessCount == 0)
-      {
-         g_SchedulerLastIndex = 0;
-      }
-      else if (g_SchedulerLastIndex >= g_SchedulerProcessCount)
-      {
-         g_SchedulerLastIndex = 0;
-      }
+   uint32_t slot = process->sched_slot;
+   if (slot >= SCHED_MAX_PROCESSES || g_SchedulerProcesses[slot] != process)
+      return; /* Not registered */
 
-      return;
-   }
+   scheduler_bitmap_clear_all(slot);
+   if (scheduler_state_runnable(process->state))
+      scheduler_bitmap_set(scheduler_effective_class(process), slot);
 }
 
+/* The mask bit of the CPU running the scheduler.  Always the BSP until
+ * AP bring-up gives each core its own selection path. */
+static inline uint32_t scheduler_cpu_mask(void) { return 1u << 0; }
+
 void Scheduler_GetNextRunnableProcess()
 {
    g_SchedulerNextRunnable = NULL;
-   if (g_SchedulerProcessCount == 0) return;
 
-   for (uint32_t n = 0; n < g_SchedulerProcessCount; ++n)
+   for (uint32_t cls = 0; cls < PROCESS_CLASS_COUNT; ++cls)
    {
-      uint32_t idx = (g_SchedulerLastIndex + n) % g_SchedulerProcessCount;
-      Process *candidate = g_SchedulerProcesses[idx];
+      /* Walk the class bitmap from the round-robin cursor, skipping
+       * slots pinned to another CPU; the try bound covers one full
+       * wrap of the table. */
+      uint32_t start = g_SchedulerLastSlot[cls];
+
+      for (uint32_t tries = 0; tries < SCHED_MAX_PROCESSES; ++tries)
+      {
+         int slot = scheduler_bitmap_next(cls, start);
+         if (slot < 0) break;
 
-      if (!candidate) continue;
-      if (candidate->state == PROCESS_STATE_BLOCKED) continue;
-      if (candidate->state == PROCESS_STATE_ZOMBIE) continue;
-      if (candidate->state == PROCESS_STATE_WAITING) continue;
+         Process *candidate = g_SchedulerProcesses[slot];
+         if (!candidate || !scheduler_state_runnable(candidate->state))
+         {
+            /* Stale bit (state changed without notification); repair it. */
+            scheduler_bitmap_clear(cls, (uint32_t)slot);
+            start = ((uint32_t)slot + 1) % SCHED_MAX_PROCESSES;
+            continue;
+         }
 
-      g_SchedulerNextRunnable = candidate;
-      g_SchedulerLastIndex = (idx + 1) % g_SchedulerProcessCount;
-      return;
+         if ((candidate->cpu_affinity & scheduler_cpu_mask()) == 0)
+         {
+            start = ((uint32_t)slot + 1) % SCHED_MAX_PROCESSES;
+            continue;
+         }
+
+         /* Burn one boost pick; once spent the process drops back to its
+          * base class bitmap. */
+         if (candidate->sched_boost > 0)
+         {
+            candidate->sched_boost--;
+            if (candidate->sched_boost == 0)
+            {
+               scheduler_bitmap_clear(cls, (uint32_t)slot);
+               scheduler_bitmap_set(scheduler_effective_class(candidate),
+                                    (uint32_t)slot);
+            }
+         }
+
+         g_SchedulerNextRunnable = candidate;
+         g_SchedulerLastSlot[cls] = ((uint32_t)slot + 1) % SCHED_MAX_PROCESSES;
+         return;
+      }
    }
 }
 
@@ -117,16 +338,32 @@ void Scheduler_Schedule()
    Scheduler_GetNextRunnableProcess();
 
    Process *next = g_SchedulerNextRunnable;
+   if (!next) next = g_SchedulerIdleProcess;
    if (!next) return;
 
    next->state = PROCESS_STATE_RUNNING;
    Process_SetCurrent(next);
+
+   TRACE_EVENT(TRACE_EV_SCHED, next->pid);
 }
 
-uint32_t Scheduler_GetProcessCount(void) { return g_SchedulerProcessCount; }
+uint32_t Scheduler_GetProcessCount(void) { return g_SchedulerSlotHigh; }
+
+uint32_t Scheduler_RunnableCount(void)
+{
+   uint32_t count = 0;
+   for (uint32_t cls = 0; cls < PROCESS_CLASS_COUNT; ++cls)
+   {
+      for (uint32_t w = 0; w < SCHED_BITMAP_WORDS; ++w)
+      {
+         count += (uint32_t)__builtin_popcount(g_SchedulerReadyBitmap[cls][w]);
+      }
+   }
+   return count;
+}
 
 Process *Scheduler_GetProcessAt(uint32_t index)
 {
-   if (index >= g_SchedulerProcessCount) return NULL;
+   if (index >= g_SchedulerSlotHigh) return NULL;
    return g_SchedulerProcesses[index];
-}
\ No newline at end of file
+}
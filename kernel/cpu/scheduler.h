@@ -10,11 +10,20 @@ void Scheduler_Initialize();
 void Scheduler_RegisterProcess(Process *process);
 void Scheduler_UnregisterProcess(Process *process);
 
+/* Re-sync the ready bitmap with process->state.  Must be called after
+ * any state transition made outside the scheduler itself. */
+void Scheduler_UpdateRunnable(Process *process);
+
 void Scheduler_Schedule();
 
 void Scheduler_SetProcessState();
 void Scheduler_GetNextRunnableProcess();
 uint32_t Scheduler_GetProcessCount(void);
+
+/* Number of READY/RUNNING processes across all classes; the tickless
+ * idle path stops the periodic tick only when this is zero. */
+uint32_t Scheduler_RunnableCount(void);
+
 Process *Scheduler_GetProcessAt(uint32_t index);
 
 #endif
\ No newline at end of file
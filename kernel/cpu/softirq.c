@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "softirq.h"
+#include "lockstat.h"
+#include "spinlock.h"
+#include <constants.h>
+#include <hal/io.h>
+#include <std/stdio.h>
+#include <stdbool.h>
+
+/* Static ring: enqueue happens in IRQ context where the heap is off
+ * limits.  Coalescing keeps it small - a device raising many IRQs
+ * before the next drain still holds one slot. */
+#define SOFTIRQ_RING_SIZE 64u /* power of two */
+#define SOFTIRQ_RING_MASK (SOFTIRQ_RING_SIZE - 1)
+
+typedef struct
+{
+   SoftirqFn fn;
+   void *arg;
+} SoftirqItem;
+
+static SoftirqItem g_SoftirqRing[SOFTIRQ_RING_SIZE];
+static volatile uint32_t g_SoftirqHead = 0; /* producer writes */
+static volatile uint32_t g_SoftirqTail = 0; /* consumer writes */
+static uint32_t g_SoftirqDropped = 0;
+
+/* Ring lock: IRQ-safe since producers run in interrupt context.  On
+ * one CPU this degenerates to the old cli/sti window plus counters. */
+static Spinlock g_SoftirqLock = SPINLOCK_INIT;
+
+void Softirq_Initialize(void)
+{
+   Lockstat_Register(&g_SoftirqLock, "softirq");
+}
+
+int Softirq_Queue(SoftirqFn fn, void *arg)
+{
+   if (!fn) return -EINVAL;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_SoftirqLock);
+
+   /* Coalesce: one pending instance per fn/arg pair is enough, the
+    * work function picks up everything that accumulated. */
+   for (uint32_t i = g_SoftirqTail; i != g_SoftirqHead; i++)
+   {
+      SoftirqItem *it = &g_SoftirqRing[i & SOFTIRQ_RING_MASK];
+      if (it->fn == fn && it->arg == arg)
+      {
+         Spinlock_ReleaseIrqRestore(&g_SoftirqLock, interrupts_were_enabled);
+         return SUCCESS;
+      }
+   }
+
+   if (g_SoftirqHead - g_SoftirqTail >= SOFTIRQ_RING_SIZE)
+   {
+      g_SoftirqDropped++;
+      Spinlock_ReleaseIrqRestore(&g_SoftirqLock, interrupts_were_enabled);
+      return -ENOMEM;
+   }
+
+   SoftirqItem *it = &g_SoftirqRing[g_SoftirqHead & SOFTIRQ_RING_MASK];
+   it->fn = fn;
+   it->arg = arg;
+   g_SoftirqHead++;
+
+   Spinlock_ReleaseIrqRestore(&g_SoftirqLock, interrupts_were_enabled);
+   return SUCCESS;
+}
+
+void Softirq_Drain(void)
+{
+   /* Single CPU: the flag stops the idle loop and the return-to-user
+    * path from running the same queue twice, and stops work items that
+    * take an interrupt from recursing into the drain. */
+   static volatile bool draining = false;
+   if (draining) return;
+   draining = true;
+
+   for (;;)
+   {
+      uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_SoftirqLock);
+
+      if (g_SoftirqTail == g_SoftirqHead)
+      {
+         Spinlock_ReleaseIrqRestore(&g_SoftirqLock, interrupts_were_enabled);
+         break;
+      }
+
+      SoftirqItem item = g_SoftirqRing[g_SoftirqTail & SOFTIRQ_RING_MASK];
+      g_SoftirqTail++;
+      Spinlock_Release(&g_SoftirqLock);
+
+      /* Run the item with interrupts enabled; that is the point. */
+      g_HalIoOperations->EnableInterrupts();
+      item.fn(item.arg);
+      if (!interrupts_were_enabled) g_HalIoOperations->DisableInterrupts();
+   }
+
+   draining = false;
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef SOFTIRQ_H
+#define SOFTIRQ_H
+
+#include <stdint.h>
+
+/* =========================================================================
+ * Deferred work (bottom halves)
+ *
+ * Hard-IRQ handlers queue a function to run later instead of doing
+ * their heavy lifting with the PIC masked; the queue is drained on the
+ * way back to user mode and from the idle loop, with interrupts
+ * enabled.  This bounds hard-IRQ time and with it worst-case timer
+ * jitter.
+ * ====================================================================== */
+
+typedef void (*SoftirqFn)(void *arg);
+
+/* Registers the ring lock with the lockstat table. */
+void Softirq_Initialize(void);
+
+/* Queue one deferred call.  IRQ-safe; an identical fn/arg pair already
+ * pending is coalesced into it.  Returns SUCCESS, or -ENOMEM when the
+ * ring is full (callers should then fall back to doing the work
+ * inline). */
+int Softirq_Queue(SoftirqFn fn, void *arg);
+
+/* Run every queued item.  Call with interrupts enabled from a context
+ * that tolerates arbitrary driver work; re-entrant calls return
+ * immediately. */
+void Softirq_Drain(void);
+
+#endif
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <hal/io.h>
+#include <stdint.h>
+
+/* =========================================================================
+ * Ticket spinlocks and readers-writer locks
+ *
+ * Locking foundation ahead of SMP: FIFO ticket locks (test-and-set
+ * starves waiters under contention), IRQ-safe variants for anything
+ * shared with interrupt context, and per-lock contention counters so
+ * hot locks are measurable from day one - locks handed to
+ * Lockstat_Register (cpu/lockstat.c) render through /dev/lockstat.
+ * On the current single CPU an uncontended acquire costs one locked
+ * add, an rdtsc and two counter stores.
+ * ====================================================================== */
+
+typedef struct
+{
+   volatile uint32_t next_ticket;
+   volatile uint32_t now_serving;
+
+   /* Contention statistics.  All but `spins` are written only while
+    * the lock is held, so they need no further synchronization. */
+   uint32_t acquisitions;
+   uint32_t spins; /* pause iterations spent waiting */
+   uint64_t hold_cycles;
+   uint64_t acquired_tsc;
+} Spinlock;
+
+#define SPINLOCK_INIT {0, 0, 0, 0, 0, 0}
+
+static inline uint64_t spinlock_rdtsc(void)
+{
+   uint32_t lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void Spinlock_Acquire(Spinlock *lock)
+{
+   uint32_t ticket = __sync_fetch_and_add(&lock->next_ticket, 1u);
+   uint32_t waited = 0;
+
+   while (lock->now_serving != ticket)
+   {
+      waited++;
+      __asm__ volatile("pause");
+   }
+
+   if (waited) __sync_fetch_and_add(&lock->spins, waited);
+   lock->acquisitions++;
+   lock->acquired_tsc = spinlock_rdtsc();
+}
+
+static inline void Spinlock_Release(Spinlock *lock)
+{
+   lock->hold_cycles += spinlock_rdtsc() - lock->acquired_tsc;
+   __sync_synchronize();
+   lock->now_serving++;
+}
+
+/* Acquire with interrupts disabled; returns the previous interrupt
+ * state for the matching ReleaseIrqRestore. */
+static inline uint8_t Spinlock_AcquireIrqSave(Spinlock *lock)
+{
+   uint8_t interrupts_were_enabled = g_HalIoOperations->DisableInterrupts();
+   Spinlock_Acquire(lock);
+   return interrupts_were_enabled;
+}
+
+static inline void Spinlock_ReleaseIrqRestore(Spinlock *lock,
+                                              uint8_t interrupts_were_enabled)
+{
+   Spinlock_Release(lock);
+   if (interrupts_were_enabled) g_HalIoOperations->EnableInterrupts();
+}
+
+/* -------------------------------------------------------------------------
+ * Readers-writer lock.  Readers take the ticket lock only long enough
+ * to bump the count, so read sections run in parallel; a writer holds
+ * the ticket lock (blocking new readers) and waits the count out.
+ * Write sections shared with interrupt context use the IrqSave pair.
+ * ---------------------------------------------------------------------- */
+
+typedef struct
+{
+   Spinlock lock; /* held by writers, briefly by entering readers */
+   volatile uint32_t readers;
+} RwLock;
+
+#define RWLOCK_INIT {SPINLOCK_INIT, 0}
+
+static inline void RwLock_ReadAcquire(RwLock *rw)
+{
+   Spinlock_Acquire(&rw->lock);
+   __sync_fetch_and_add(&rw->readers, 1u);
+   Spinlock_Release(&rw->lock);
+}
+
+static inline void RwLock_ReadRelease(RwLock *rw)
+{
+   __sync_fetch_and_sub(&rw->readers, 1u);
+}
+
+static inline void RwLock_WriteAcquire(RwLock *rw)
+{
+   Spinlock_Acquire(&rw->lock);
+   while (rw->readers) __asm__ volatile("pause");
+}
+
+static inline void RwLock_WriteRelease(RwLock *rw)
+{
+   Spinlock_Release(&rw->lock);
+}
+
+static inline uint8_t RwLock_WriteAcquireIrqSave(RwLock *rw)
+{
+   uint8_t interrupts_were_enabled = g_HalIoOperations->DisableInterrupts();
+   RwLock_WriteAcquire(rw);
+   return interrupts_were_enabled;
+}
+
+static inline void RwLock_WriteReleaseIrqRestore(RwLock *rw,
+                                                 uint8_t interrupts_were_enabled)
+{
+   RwLock_WriteRelease(rw);
+   if (interrupts_were_enabled) g_HalIoOperations->EnableInterrupts();
+}
+
+#endif
@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "timer.h"
+#include "kinfo.h"
+#include "process.h"
+#include <constants.h>
+#include <hal/io.h>
+#include <std/stdio.h>
+#include <std/string.h>
+
+/* =========================================================================
+ * Tick-driven timer wheel
+ *
+ * TIMER_WHEEL_SLOTS buckets, one advanced per tick; an armed entry lives
+ * in the bucket its expiry tick hashes to, so arming and expiring are
+ * O(entries in one bucket).  Entries come from a static pool because the
+ * expiry side runs in IRQ context where the heap is off limits.
+ * ====================================================================== */
+
+#define TIMER_WHEEL_SLOTS 256u
+#define TIMER_MAX_ENTRIES 64u
+
+typedef struct TimerEntry
+{
+   uint64_t expiry;        /* Absolute tick the entry fires at */
+   volatile bool fired;    /* Set by Timer_Tick once expired */
+   bool in_use;
+   Process *waiter;        /* Woken on expiry; may be NULL */
+   struct TimerEntry *next;
+} TimerEntry;
+
+static TimerEntry g_TimerEntries[TIMER_MAX_ENTRIES];
+static TimerEntry *g_TimerWheel[TIMER_WHEEL_SLOTS];
+static volatile uint64_t g_TimerTicks = 0;
+
+void Timer_Initialize(void)
+{
+   memset(g_TimerEntries, 0, sizeof(g_TimerEntries));
+   memset(g_TimerWheel, 0, sizeof(g_TimerWheel));
+   g_TimerTicks = 0;
+
+   logfmt(LOG_INFO, "[TIMER] wheel ready: %u slots, %u entries, %u Hz\n",
+          TIMER_WHEEL_SLOTS, TIMER_MAX_ENTRIES, TIMER_HZ);
+}
+
+uint64_t Timer_GetTicks(void) { return g_TimerTicks; }
+
+/* =========================================================================
+ * TSC monotonic clock
+ *
+ * Nanoseconds are derived from the cycle counter with a fixed-point
+ * multiply (ns = cycles * mult >> TSC_NS_SHIFT) so the hot path never
+ * divides.  The HAL installs the calibration result at boot.
+ * ====================================================================== */
+
+#define TSC_NS_SHIFT 20
+
+static uint32_t g_TscMult = 0; /* 0 = not calibrated, use tick fallback */
+
+/* The kernel only targets i686, so rdtsc is used directly rather than
+ * going through the HAL. */
+static inline uint64_t timer_rdtsc(void)
+{
+   uint32_t lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((uint64_t)hi << 32) | lo;
+}
+
+void Timer_SetTscFrequency(uint32_t khz)
+{
+   if (khz == 0)
+   {
+      logfmt(LOG_WARNING,
+             "[TIMER] tsc calibration failed, clock at tick resolution\n");
+      return;
+   }
+
+   /* ns per cycle = 1e6 / kHz, kept with 20 fractional bits (~1 ppm) */
+   g_TscMult = (uint32_t)((1000000ULL << TSC_NS_SHIFT) / khz);
+   logfmt(LOG_INFO, "[TIMER] tsc calibrated: freq=%u kHz mult=%u\n", khz,
+          g_TscMult);
+
+   /* Let userspace compute monotonic time without trapping. */
+   KInfo_PublishTsc(khz, g_TscMult, TSC_NS_SHIFT);
+}
+
+uint64_t Timer_GetMonotonicNs(void)
+{
+   if (g_TscMult == 0)
+      return g_TimerTicks * (1000000000u / TIMER_HZ); /* Tick fallback */
+
+   /* Split 64x32 multiply so the intermediate product cannot overflow;
+    * exact for far longer than any plausible uptime. */
+   uint64_t tsc = timer_rdtsc();
+   uint64_t lo = (uint32_t)tsc;
+   uint64_t hi = tsc >> 32;
+   return ((hi * g_TscMult) << (32 - TSC_NS_SHIFT)) +
+          ((lo * g_TscMult) >> TSC_NS_SHIFT);
+}
+
+uint32_t Timer_TicksToNextDeadline(void)
+{
+   /* Pool scan, not a wheel walk: TIMER_MAX_ENTRIES is small and this
+    * only runs on the idle path.  Caller holds interrupts disabled. */
+   uint64_t best = 0;
+   for (uint32_t i = 0; i < TIMER_MAX_ENTRIES; i++)
+   {
+      if (!g_TimerEntries[i].in_use) continue;
+      if (best == 0 || g_TimerEntries[i].expiry < best)
+         best = g_TimerEntries[i].expiry;
+   }
+
+   if (best == 0) return 0;
+   if (best <= g_TimerTicks) return 1;
+
+   uint64_t delta = best - g_TimerTicks;
+   return (delta > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)delta;
+}
+
+/* Arm an entry for an absolute expiry tick.  Runs with interrupts
+ * disabled so the IRQ-side bucket walk never sees a half-linked entry.
+ * Returns NULL when the pool is exhausted. */
+static TimerEntry *timer_arm(uint64_t expiry, Process *waiter)
+{
+   uint8_t interrupts_were_enabled = g_HalIoOperations->DisableInterrupts();
+
+   TimerEntry *e = NULL;
+   for (uint32_t i = 0; i < TIMER_MAX_ENTRIES; i++)
+   {
+      if (!g_TimerEntries[i].in_use)
+      {
+         e = &g_TimerEntries[i];
+         break;
+      }
+   }
+
+   if (e)
+   {
+      e->expiry = expiry;
+      e->fired = false;
+      e->waiter = waiter;
+      e->in_use = true;
+
+      uint32_t slot = (uint32_t)(expiry % TIMER_WHEEL_SLOTS);
+      e->next = g_TimerWheel[slot];
+      g_TimerWheel[slot] = e;
+   }
+
+   if (interrupts_were_enabled) g_HalIoOperations->EnableInterrupts();
+   return e;
+}
+
+void Timer_Tick(void)
+{
+   g_TimerTicks++;
+   KInfo_PublishTick(g_TimerTicks);
+
+   /* Charge the interrupted process for this tick.  Sampling at timer
+    * frequency is coarse but free; the split follows where the process
+    * was when the interrupt landed. */
+   Process *cur = Process_GetCurrent();
+   if (cur)
+   {
+      if (cur->syscall_depth > 0 || cur->kernel_mode)
+         cur->cpu_system_ticks++;
+      else
+         cur->cpu_user_ticks++;
+   }
+
+   uint32_t slot = (uint32_t)(g_TimerTicks % TIMER_WHEEL_SLOTS);
+   TimerEntry **link = &g_TimerWheel[slot];
+
+   while (*link)
+   {
+      TimerEntry *e = *link;
+
+      /* Entries more than one wheel revolution out share the bucket;
+       * leave them for a later pass. */
+      if (e->expiry > g_TimerTicks)
+      {
+         link = &e->next;
+         continue;
+      }
+
+      *link = e->next;
+      e->next = NULL;
+      e->fired = true;
+      if (e->waiter) Process_Unblock(e->waiter);
+      e->waiter = NULL;
+      e->in_use = false;
+   }
+}
+
+int Timer_SleepTicks(uint32_t ticks)
+{
+   if (ticks == 0) return SUCCESS;
+
+   uint64_t deadline = g_TimerTicks + ticks;
+   Process *cur = Process_GetCurrent();
+   TimerEntry *e = timer_arm(deadline, cur);
+
+   uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+
+   if (e)
+   {
+      /* Same idiom as the driver IRQ waits: park the process on the
+       * entry, re-check after blocking in case the tick already fired. */
+      while (!e->fired)
+      {
+         if (cur)
+         {
+            Process_BlockOn(cur, (void *)e);
+            if (e->fired) Process_Unblock(cur);
+         }
+         g_HalIoOperations->iowait();
+      }
+      if (cur) Process_Unblock(cur);
+   }
+   else
+   {
+      /* Pool exhausted: bounded poll on the tick counter.  The escape
+       * hatch keeps boot-time callers from hanging if the timer IRQ is
+       * not running yet. */
+      uint32_t spins = 0;
+      while (g_TimerTicks < deadline && ++spins < 0x1000000)
+         g_HalIoOperations->iowait();
+   }
+
+   if (!interrupts_were_enabled) g_HalIoOperations->DisableInterrupts();
+   return SUCCESS;
+}
+
+int Timer_SleepMs(uint32_t ms)
+{
+   /* One tick is 1 ms at TIMER_HZ = 1000; round up for other rates. */
+   uint64_t ticks = ((uint64_t)ms * TIMER_HZ + 999u) / 1000u;
+   if (ms != 0 && ticks == 0) ticks = 1;
+   return Timer_SleepTicks((uint32_t)ticks);
+}
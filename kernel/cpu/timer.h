@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+/* Tick rate the PIT is programmed to in HAL_Initialize. */
+#define TIMER_HZ 1000u
+
+void Timer_Initialize(void);
+
+/* Advance the wheel by one tick and fire expired entries.  Called from
+ * the timer IRQ handler; everything it touches is IRQ-safe. */
+void Timer_Tick(void);
+
+uint64_t Timer_GetTicks(void);
+
+/* Install the boot-time TSC calibration result (kHz).  Until this is
+ * called - or if calibration failed (0) - the monotonic clock falls
+ * back to tick resolution. */
+void Timer_SetTscFrequency(uint32_t khz);
+
+/* Monotonic nanoseconds since boot, TSC-backed when calibrated (tick
+ * resolution otherwise).  Backs clock_gettime(CLOCK_MONOTONIC). */
+uint64_t Timer_GetMonotonicNs(void);
+
+/* Block the calling process for at least `ticks` timer ticks (one tick =
+ * 1/TIMER_HZ s).  Falls back to a bounded busy-wait when no process
+ * context or wheel entry is available.  Returns SUCCESS. */
+int Timer_SleepTicks(uint32_t ticks);
+int Timer_SleepMs(uint32_t ms);
+
+/* Ticks until the nearest armed wheel entry fires, or 0 when nothing
+ * is armed.  Used by the tickless idle path to size its one-shot; call
+ * with interrupts disabled. */
+uint32_t Timer_TicksToNextDeadline(void);
+
+#endif
@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include "kstack.h"
 #include "process.h"
 #include "scheduler.h"
 #include <hal/mem.h>
@@ -13,15 +14,8 @@
 
 static int allocate_kernel_stack(Process *proc)
 {
-   uint32_t stack_size = (g_SysInfo && g_SysInfo->memory.kernel_stack_size)
-                             ? g_SysInfo->memory.kernel_stack_size
-                             : 65536u;
-
-   proc->kernel_stack = kmalloc(stack_size);
-   if (!proc->kernel_stack) return -1;
-
-   proc->kernel_stack_size = stack_size;
-   return 0;
+   proc->kernel_stack = KStack_Allocate(&proc->kernel_stack_size);
+   return proc->kernel_stack ? 0 : -1;
 }
 
 static int map_user_trampoline(Process *proc)
@@ -64,6 +58,9 @@ Process *Process_CreateUser(uint32_t entry_point)
    proc->ppid = 0;
    proc->state = STATE_READY;
    proc->kernel_mode = false;
+   proc->sched_class = CLASS_NORMAL;
+   proc->sched_boost = 0;
+   proc->cpu_affinity = PROCESS_AFFINITY_ALL;
    proc->uid = 0;
    proc->gid = 0;
    proc->euid = 0;
@@ -71,6 +68,8 @@ Process *Process_CreateUser(uint32_t entry_point)
    proc->priority = 10;
    proc->ticks_remaining = 0;
    proc->signal_mask = 0;
+   proc->signal_pending = 0;
+   proc->signal_deliverable = false;
    proc->exit_code = 0;
 
    proc->page_directory = g_HalPagingOperations->CreatePageDirectory();
@@ -95,7 +94,8 @@ Process *Process_CreateUser(uint32_t entry_point)
       return NULL;
    }
 
-   if (Stack_ProcessInitialize(proc, USER_STACK_TOP, USER_STACK_SIZE) != 0)
+   if (Stack_ProcessInitialize(proc, USER_STACK_TOP, USER_STACK_INITIAL_SIZE) !=
+       0)
    {
       g_HalPagingOperations->DestroyPageDirectory(proc->page_directory);
       free(proc->kernel_stack);
@@ -145,10 +145,11 @@ Process *Process_CreateUser(uint32_t entry_point)
       proc->saved_regs = frame;
    }
 
-   for (int i = 0; i < 16; ++i) proc->fd_table[i] = NULL;
+   proc->fd_table = FD_TableCreate();
 
-   if (Process_InitializeStandardIO(proc) != 0)
+   if (!proc->fd_table || Process_InitializeStandardIO(proc) != 0)
    {
+      FD_CloseAll(proc);
       g_HalPagingOperations->DestroyPageDirectory(proc->page_directory);
       free(proc->kernel_stack);
       free(proc);
@@ -1,9 +1,71 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "crypto.h"
+#include <cpu/timer.h>
+#include <mem/mm_kernel.h>
 #include <std/stdio.h>
 #include <sys/sys.h>
 
+/* Hash a 64 KiB buffer repeatedly through both digests and report the
+   elapsed ticks (one tick is 1 ms at the default timer rate).  Purely
+   informational - a slow result is logged, never failed. */
+static void crypto_throughput_test(void)
+{
+   enum
+   {
+      BENCH_BUFFER_SIZE = 64 * 1024,
+      BENCH_ITERATIONS = 16,
+   };
+
+   uint8_t *buffer = kmalloc(BENCH_BUFFER_SIZE);
+   uint8_t digest[SHA1_DIGEST_SIZE];
+   uint32_t total_kib =
+       (uint32_t)(BENCH_BUFFER_SIZE / 1024) * BENCH_ITERATIONS;
+   uint64_t start;
+   uint32_t md5_ticks;
+   uint32_t sha1_ticks;
+   uint32_t crc32_ticks;
+
+   if (!buffer)
+   {
+      logfmt(LOG_WARNING, "[CRYPTO] throughput test skipped reason=nomem\n");
+      return;
+   }
+
+   for (size_t i = 0; i < BENCH_BUFFER_SIZE; i++)
+   {
+      buffer[i] = (uint8_t)(i * 31u);
+   }
+
+   start = Timer_GetTicks();
+   for (size_t i = 0; i < BENCH_ITERATIONS; i++)
+   {
+      MD5_Calculate(buffer, BENCH_BUFFER_SIZE, digest);
+   }
+   md5_ticks = (uint32_t)(Timer_GetTicks() - start);
+
+   start = Timer_GetTicks();
+   for (size_t i = 0; i < BENCH_ITERATIONS; i++)
+   {
+      SHA1_Calculate(buffer, BENCH_BUFFER_SIZE, digest);
+   }
+   sha1_ticks = (uint32_t)(Timer_GetTicks() - start);
+
+   start = Timer_GetTicks();
+   for (size_t i = 0; i < BENCH_ITERATIONS; i++)
+   {
+      (void)CRC32_Calculate(buffer, BENCH_BUFFER_SIZE);
+   }
+   crc32_ticks = (uint32_t)(Timer_GetTicks() - start);
+
+   logfmt(LOG_INFO,
+          "[CRYPTO] throughput kib=%u md5_ticks=%u sha1_ticks=%u "
+          "crc32_ticks=%u\n",
+          total_kib, md5_ticks, sha1_ticks, crc32_ticks);
+
+   free(buffer);
+}
+
 void Crypto_SelfTest(void)
 {
    if (MD5_SelfTest() == SUCCESS)
@@ -23,4 +85,15 @@ void Crypto_SelfTest(void)
    {
       logfmt(LOG_ERROR, "[CRYPTO] SHA1 self-test=FAIL\n");
    }
+
+   if (CRC32_SelfTest() == SUCCESS)
+   {
+      logfmt(LOG_INFO, "[CRYPTO] CRC32 self-test=PASS\n");
+   }
+   else
+   {
+      logfmt(LOG_ERROR, "[CRYPTO] CRC32 self-test=FAIL\n");
+   }
+
+   crypto_throughput_test();
 }
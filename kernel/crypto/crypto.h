@@ -50,6 +50,20 @@ void SHA1_ToHex(const uint8_t digest[SHA1_DIGEST_SIZE],
                 char out_hex[SHA1_HEX_SIZE]);
 int SHA1_SelfTest(void);
 
+/* CRC-32 (IEEE, slice-by-4).  Not cryptographic; the default checksum
+ * where integrity checking must be cheap enough to stay on (block
+ * cache, module image validation). */
+typedef struct
+{
+   uint32_t Crc;
+} CRC32_Context;
+
+void CRC32_Init(CRC32_Context *ctx);
+void CRC32_Update(CRC32_Context *ctx, const void *data, size_t len);
+uint32_t CRC32_Final(CRC32_Context *ctx);
+uint32_t CRC32_Calculate(const void *data, size_t len);
+int CRC32_SelfTest(void);
+
 void Crypto_SelfTest(void);
 
 #endif
\ No newline at end of file
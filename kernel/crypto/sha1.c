@@ -6,6 +6,25 @@
 
 #define SHA1_ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
 
+/* Round functions for the four 20-step groups. */
+#define SHA1_F1(b, c, d) (((b) & (c)) | ((~(b)) & (d)))
+#define SHA1_F2(b, c, d) ((b) ^ (c) ^ (d))
+#define SHA1_F3(b, c, d) (((b) & (c)) | ((b) & (d)) | ((c) & (d)))
+
+#define SHA1_K1 0x5A827999u
+#define SHA1_K2 0x6ED9EBA1u
+#define SHA1_K3 0x8F1BBCDCu
+#define SHA1_K4 0xCA62C1D6u
+
+/* One round with the register rotation folded into the argument order,
+   so the compiler keeps a..e in registers instead of shuffling them. */
+#define SHA1_STEP(f, k, a, b, c, d, e, t)                                      \
+   do                                                                          \
+   {                                                                           \
+      (e) += SHA1_ROTL32((a), 5) + f((b), (c), (d)) + (k) + w[(t)];            \
+      (b) = SHA1_ROTL32((b), 30);                                              \
+   } while (0)
+
 static void SHA1_Encode32BE(uint8_t *out, const uint32_t *in, size_t len)
 {
    size_t i = 0;
@@ -47,39 +66,93 @@ static void SHA1_Transform(uint32_t state[5], const uint8_t block[64])
    uint32_t d = state[3];
    uint32_t e = state[4];
 
-   for (size_t t = 0; t < 80; t++)
-   {
-      uint32_t f;
-      uint32_t k;
-
-      if (t < 20)
-      {
-         f = (b & c) | ((~b) & d);
-         k = 0x5A827999;
-      }
-      else if (t < 40)
-      {
-         f = b ^ c ^ d;
-         k = 0x6ED9EBA1;
-      }
-      else if (t < 60)
-      {
-         f = (b & c) | (b & d) | (c & d);
-         k = 0x8F1BBCDC;
-      }
-      else
-      {
-         f = b ^ c ^ d;
-         k = 0xCA62C1D6;
-      }
-
-      uint32_t temp = SHA1_ROTL32(a, 5) + f + e + k + w[t];
-      e = d;
-      d = c;
-      c = SHA1_ROTL32(b, 30);
-      b = a;
-      a = temp;
-   }
+   /* Rounds 0-19 */
+   SHA1_STEP(SHA1_F1, SHA1_K1, a, b, c, d, e, 0);
+   SHA1_STEP(SHA1_F1, SHA1_K1, e, a, b, c, d, 1);
+   SHA1_STEP(SHA1_F1, SHA1_K1, d, e, a, b, c, 2);
+   SHA1_STEP(SHA1_F1, SHA1_K1, c, d, e, a, b, 3);
+   SHA1_STEP(SHA1_F1, SHA1_K1, b, c, d, e, a, 4);
+   SHA1_STEP(SHA1_F1, SHA1_K1, a, b, c, d, e, 5);
+   SHA1_STEP(SHA1_F1, SHA1_K1, e, a, b, c, d, 6);
+   SHA1_STEP(SHA1_F1, SHA1_K1, d, e, a, b, c, 7);
+   SHA1_STEP(SHA1_F1, SHA1_K1, c, d, e, a, b, 8);
+   SHA1_STEP(SHA1_F1, SHA1_K1, b, c, d, e, a, 9);
+   SHA1_STEP(SHA1_F1, SHA1_K1, a, b, c, d, e, 10);
+   SHA1_STEP(SHA1_F1, SHA1_K1, e, a, b, c, d, 11);
+   SHA1_STEP(SHA1_F1, SHA1_K1, d, e, a, b, c, 12);
+   SHA1_STEP(SHA1_F1, SHA1_K1, c, d, e, a, b, 13);
+   SHA1_STEP(SHA1_F1, SHA1_K1, b, c, d, e, a, 14);
+   SHA1_STEP(SHA1_F1, SHA1_K1, a, b, c, d, e, 15);
+   SHA1_STEP(SHA1_F1, SHA1_K1, e, a, b, c, d, 16);
+   SHA1_STEP(SHA1_F1, SHA1_K1, d, e, a, b, c, 17);
+   SHA1_STEP(SHA1_F1, SHA1_K1, c, d, e, a, b, 18);
+   SHA1_STEP(SHA1_F1, SHA1_K1, b, c, d, e, a, 19);
+
+   /* Rounds 20-39 */
+   SHA1_STEP(SHA1_F2, SHA1_K2, a, b, c, d, e, 20);
+   SHA1_STEP(SHA1_F2, SHA1_K2, e, a, b, c, d, 21);
+   SHA1_STEP(SHA1_F2, SHA1_K2, d, e, a, b, c, 22);
+   SHA1_STEP(SHA1_F2, SHA1_K2, c, d, e, a, b, 23);
+   SHA1_STEP(SHA1_F2, SHA1_K2, b, c, d, e, a, 24);
+   SHA1_STEP(SHA1_F2, SHA1_K2, a, b, c, d, e, 25);
+   SHA1_STEP(SHA1_F2, SHA1_K2, e, a, b, c, d, 26);
+   SHA1_STEP(SHA1_F2, SHA1_K2, d, e, a, b, c, 27);
+   SHA1_STEP(SHA1_F2, SHA1_K2, c, d, e, a, b, 28);
+   SHA1_STEP(SHA1_F2, SHA1_K2, b, c, d, e, a, 29);
+   SHA1_STEP(SHA1_F2, SHA1_K2, a, b, c, d, e, 30);
+   SHA1_STEP(SHA1_F2, SHA1_K2, e, a, b, c, d, 31);
+   SHA1_STEP(SHA1_F2, SHA1_K2, d, e, a, b, c, 32);
+   SHA1_STEP(SHA1_F2, SHA1_K2, c, d, e, a, b, 33);
+   SHA1_STEP(SHA1_F2, SHA1_K2, b, c, d, e, a, 34);
+   SHA1_STEP(SHA1_F2, SHA1_K2, a, b, c, d, e, 35);
+   SHA1_STEP(SHA1_F2, SHA1_K2, e, a, b, c, d, 36);
+   SHA1_STEP(SHA1_F2, SHA1_K2, d, e, a, b, c, 37);
+   SHA1_STEP(SHA1_F2, SHA1_K2, c, d, e, a, b, 38);
+   SHA1_STEP(SHA1_F2, SHA1_K2, b, c, d, e, a, 39);
+
+   /* Rounds 40-59 */
+   SHA1_STEP(SHA1_F3, SHA1_K3, a, b, c, d, e, 40);
+   SHA1_STEP(SHA1_F3, SHA1_K3, e, a, b, c, d, 41);
+   SHA1_STEP(SHA1_F3, SHA1_K3, d, e, a, b, c, 42);
+   SHA1_STEP(SHA1_F3, SHA1_K3, c, d, e, a, b, 43);
+   SHA1_STEP(SHA1_F3, SHA1_K3, b, c, d, e, a, 44);
+   SHA1_STEP(SHA1_F3, SHA1_K3, a, b, c, d, e, 45);
+   SHA1_STEP(SHA1_F3, SHA1_K3, e, a, b, c, d, 46);
+   SHA1_STEP(SHA1_F3, SHA1_K3, d, e, a, b, c, 47);
+   SHA1_STEP(SHA1_F3, SHA1_K3, c, d, e, a, b, 48);
+   SHA1_STEP(SHA1_F3, SHA1_K3, b, c, d, e, a, 49);
+   SHA1_STEP(SHA1_F3, SHA1_K3, a, b, c, d, e, 50);
+   SHA1_STEP(SHA1_F3, SHA1_K3, e, a, b, c, d, 51);
+   SHA1_STEP(SHA1_F3, SHA1_K3, d, e, a, b, c, 52);
+   SHA1_STEP(SHA1_F3, SHA1_K3, c, d, e, a, b, 53);
+   SHA1_STEP(SHA1_F3, SHA1_K3, b, c, d, e, a, 54);
+   SHA1_STEP(SHA1_F3, SHA1_K3, a, b, c, d, e, 55);
+   SHA1_STEP(SHA1_F3, SHA1_K3, e, a, b, c, d, 56);
+   SHA1_STEP(SHA1_F3, SHA1_K3, d, e, a, b, c, 57);
+   SHA1_STEP(SHA1_F3, SHA1_K3, c, d, e, a, b, 58);
+   SHA1_STEP(SHA1_F3, SHA1_K3, b, c, d, e, a, 59);
+
+   /* Rounds 60-79 */
+   SHA1_STEP(SHA1_F2, SHA1_K4, a, b, c, d, e, 60);
+   SHA1_STEP(SHA1_F2, SHA1_K4, e, a, b, c, d, 61);
+   SHA1_STEP(SHA1_F2, SHA1_K4, d, e, a, b, c, 62);
+   SHA1_STEP(SHA1_F2, SHA1_K4, c, d, e, a, b, 63);
+   SHA1_STEP(SHA1_F2, SHA1_K4, b, c, d, e, a, 64);
+   SHA1_STEP(SHA1_F2, SHA1_K4, a, b, c, d, e, 65);
+   SHA1_STEP(SHA1_F2, SHA1_K4, e, a, b, c, d, 66);
+   SHA1_STEP(SHA1_F2, SHA1_K4, d, e, a, b, c, 67);
+   SHA1_STEP(SHA1_F2, SHA1_K4, c, d, e, a, b, 68);
+   SHA1_STEP(SHA1_F2, SHA1_K4, b, c, d, e, a, 69);
+   SHA1_STEP(SHA1_F2, SHA1_K4, a, b, c, d, e, 70);
+   SHA1_STEP(SHA1_F2, SHA1_K4, e, a, b, c, d, 71);
+   SHA1_STEP(SHA1_F2, SHA1_K4, d, e, a, b, c, 72);
+   SHA1_STEP(SHA1_F2, SHA1_K4, c, d, e, a, b, 73);
+   SHA1_STEP(SHA1_F2, SHA1_K4, b, c, d, e, a, 74);
+   SHA1_STEP(SHA1_F2, SHA1_K4, a, b, c, d, e, 75);
+   SHA1_STEP(SHA1_F2, SHA1_K4, e, a, b, c, d, 76);
+   SHA1_STEP(SHA1_F2, SHA1_K4, d, e, a, b, c, 77);
+   SHA1_STEP(SHA1_F2, SHA1_K4, c, d, e, a, b, 78);
+   SHA1_STEP(SHA1_F2, SHA1_K4, b, c, d, e, a, 79);
 
    state[0] += a;
    state[1] += b;
@@ -1,9 +1,12 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "ata.h"
+#include <cpu/process.h>
 #include <fs/devfs/devfs.h>
 #include <hal/io.h>
+#include <hal/irq.h>
 #include <std/stdio.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <sys/sys.h>
 #include <sys/system.h>
@@ -30,9 +33,18 @@ static DEVFS_DeviceOps disk_ops = {.read = DISK_DevfsRead,
 #define ATA_STATUS_ERR 0x01  // Error
 
 // ATA commands
-#define ATA_CMD_READ_PIO 0x20  // 28-bit LBA read
-#define ATA_CMD_WRITE_PIO 0x30 // 28-bit LBA write
-#define ATA_CMD_IDENTIFY 0xEC  // Identify device
+#define ATA_CMD_READ_PIO 0x20       // 28-bit LBA read
+#define ATA_CMD_WRITE_PIO 0x30      // 28-bit LBA write
+#define ATA_CMD_READ_MULTIPLE 0xC4  // Block-per-DRQ read
+#define ATA_CMD_WRITE_MULTIPLE 0xC5 // Block-per-DRQ write
+#define ATA_CMD_SET_MULTIPLE 0xC6   // Negotiate DRQ block size
+#define ATA_CMD_IDENTIFY 0xEC       // Identify device
+#define ATA_CMD_FLUSH_CACHE 0xE7    // Commit the drive's write cache
+
+/* Largest DRQ block we ask for with SET MULTIPLE MODE.  16 sectors keeps
+ * interrupt-off polling bursts short while still amortising the per-DRQ
+ * status polling over 8 KiB. */
+#define ATA_MULTIPLE_MAX 16
 
 /*
  * Floating-bus sentinel: an 8-bit Status Register read returns 0xFF when no
@@ -50,6 +62,7 @@ typedef struct
    uint16_t dcr_port;  /* Alt-Status / Device Control port                    */
    uint16_t tf_port;   /* Task-file base port                                 */
    uint8_t slave_bits; /* Drive-select byte: 0xA0 (master) or 0xB0 (slave)   */
+   uint8_t multiple_block; /* Sectors per DRQ block (1 = single-sector PIO)  */
 } ata_driver_t;
 
 /*
@@ -66,6 +79,307 @@ static ata_driver_t secondary_master = {
 static ata_driver_t secondary_slave = {
     .dcr_port = 0x376, .tf_port = 0x170, .slave_bits = 0xB0};
 
+/* Probe topology cache: -1 = not probed yet, 0 = absent, 1 = present.
+ * A slot that probed absent stays absent for the life of the boot, so
+ * repeat scans skip the ready-wait timeouts instead of paying the full
+ * multi-second tax on every empty channel again. */
+static int8_t g_AtaTopology[2][2] = {{-1, -1}, {-1, -1}};
+
+/* =========================================================================
+ * Bus-master IDE DMA
+ *
+ * The PIIX-style IDE function (PCI class 0x01, subclass 0x01) exposes a
+ * bus-master engine through BAR4: per channel a command register, a
+ * status register and a PRD (Physical Region Descriptor) table pointer.
+ * We probe PCI configuration space directly (ports 0xCF8/0xCFC) since the
+ * kernel has no separate PCI layer yet.
+ *
+ * Transfers go through per-page bounce buffers allocated once from
+ * PMM_AllocatePhysicalPage (identity-mapped low memory), one PRD entry
+ * per page, so caller buffers need not be physically contiguous.  The CPU
+ * sleeps on the channel IRQ while the engine moves the data.
+ * ====================================================================== */
+
+#define PCI_CONFIG_ADDRESS 0xCF8
+#define PCI_CONFIG_DATA 0xCFC
+
+#define ATA_DMA_PAGES 8 /* PRD entries / bounce pages per transfer */
+#define ATA_DMA_MAX_SECTORS (ATA_DMA_PAGES * 8) /* 4 KiB = 8 sectors */
+
+/* Bus-master register offsets (secondary channel at +8) */
+#define BMIDE_REG_COMMAND 0x00
+#define BMIDE_REG_STATUS 0x02
+#define BMIDE_REG_PRDT 0x04
+
+#define BMIDE_CMD_START 0x01
+#define BMIDE_CMD_READ 0x08 /* Direction: device -> memory */
+#define BMIDE_STATUS_ERR 0x02
+#define BMIDE_STATUS_IRQ 0x04
+
+#define ATA_CMD_READ_DMA 0xC8
+#define ATA_CMD_WRITE_DMA 0xCA
+
+typedef struct
+{
+   uint32_t phys;  /* Physical base of the region */
+   uint16_t count; /* Byte count (0 = 64 KiB) */
+   uint16_t flags; /* Bit 15 = end of table */
+} __attribute__((packed)) ata_prd_t;
+
+static int ata_wait_irq(int channel); /* Defined with the IRQ path below */
+
+static uint16_t g_ata_bmide_base = 0; /* BAR4 I/O base; 0 = DMA unavailable */
+
+/* The two IDE channels are electrically independent and the bus master
+ * exposes a separate engine per channel (secondary registers at +8), so
+ * each channel gets its own PRD table and bounce pool.  With the
+ * per-channel busy flag and IRQ state above the task file, a transfer
+ * on one channel never touches state the other is using, and the data
+ * and log volumes split across channels genuinely overlap. */
+static ata_prd_t *g_ata_prdt[2];                  /* Halves of one page */
+static uint32_t g_ata_dma_page[2][ATA_DMA_PAGES]; /* Bounce page frames */
+
+static uint32_t pci_cfg_read32(uint8_t bus, uint8_t dev, uint8_t fn,
+                               uint8_t offset)
+{
+   uint32_t address = 0x80000000u | ((uint32_t)bus << 16) |
+                      ((uint32_t)dev << 11) | ((uint32_t)fn << 8) |
+                      (offset & 0xFC);
+   g_HalIoOperations->outl(PCI_CONFIG_ADDRESS, address);
+   return g_HalIoOperations->inl(PCI_CONFIG_DATA);
+}
+
+static void pci_cfg_write32(uint8_t bus, uint8_t dev, uint8_t fn,
+                            uint8_t offset, uint32_t value)
+{
+   uint32_t address = 0x80000000u | ((uint32_t)bus << 16) |
+                      ((uint32_t)dev << 11) | ((uint32_t)fn << 8) |
+                      (offset & 0xFC);
+   g_HalIoOperations->outl(PCI_CONFIG_ADDRESS, address);
+   g_HalIoOperations->outl(PCI_CONFIG_DATA, value);
+}
+
+/* Locate the IDE controller function and latch its bus-master base. */
+static void ata_dma_init(void)
+{
+   if (g_ata_bmide_base) return;
+
+   for (uint8_t bus = 0; bus < 4 && !g_ata_bmide_base; bus++)
+   {
+      for (uint8_t dev = 0; dev < 32 && !g_ata_bmide_base; dev++)
+      {
+         for (uint8_t fn = 0; fn < 8; fn++)
+         {
+            uint32_t id = pci_cfg_read32(bus, dev, fn, 0x00);
+            if ((id & 0xFFFF) == 0xFFFF) continue; /* No function */
+
+            uint32_t classcode = pci_cfg_read32(bus, dev, fn, 0x08);
+            if (((classcode >> 24) & 0xFF) != 0x01) continue; /* Storage */
+            if (((classcode >> 16) & 0xFF) != 0x01) continue; /* IDE */
+
+            uint32_t bar4 = pci_cfg_read32(bus, dev, fn, 0x20);
+            if (!(bar4 & 0x1)) continue; /* Must be I/O space */
+
+            /* Enable bus mastering in the PCI command register. */
+            uint32_t cmd = pci_cfg_read32(bus, dev, fn, 0x04);
+            pci_cfg_write32(bus, dev, fn, 0x04, cmd | 0x4);
+
+            g_ata_bmide_base = (uint16_t)(bar4 & 0xFFFC);
+            logfmt(LOG_INFO,
+                   "[ATA] Bus-master IDE at PCI %u:%u.%u, base=0x%04x\n", bus,
+                   dev, fn, g_ata_bmide_base);
+            break;
+         }
+      }
+   }
+
+   if (!g_ata_bmide_base) return;
+
+   /* PRD tables and bounce pages: identity-mapped physical pages.  One
+    * page hosts both channels' PRD tables (half a page each keeps them
+    * dword-aligned and clear of any 64 KiB boundary). */
+   uint32_t prdt_page = PMM_AllocatePhysicalPage();
+   if (!prdt_page)
+   {
+      g_ata_bmide_base = 0;
+      return;
+   }
+   g_ata_prdt[0] = (ata_prd_t *)prdt_page;
+   g_ata_prdt[1] = (ata_prd_t *)(prdt_page + 2048);
+
+   for (int ch = 0; ch < 2; ch++)
+   {
+      for (int i = 0; i < ATA_DMA_PAGES; i++)
+      {
+         g_ata_dma_page[ch][i] = PMM_AllocatePhysicalPage();
+         if (!g_ata_dma_page[ch][i])
+         {
+            logfmt(LOG_WARNING, "[ATA] DMA bounce pool exhausted, PIO only\n");
+            g_ata_bmide_base = 0;
+            return;
+         }
+      }
+   }
+}
+
+static inline uint16_t bmide_port(int channel, uint16_t reg)
+{
+   return (uint16_t)(g_ata_bmide_base + (channel ? 8 : 0) + reg);
+}
+
+/* Program the PRD table for `sectors` sectors and kick the engine.
+ * Returns 0 on clean completion. */
+static int ata_dma_transfer(int channel, uint32_t sectors, bool is_read)
+{
+   ata_prd_t *prdt = g_ata_prdt[channel];
+   uint32_t remaining = sectors * 512;
+   int entries = 0;
+   while (remaining > 0 && entries < ATA_DMA_PAGES)
+   {
+      uint32_t chunk = (remaining > 4096) ? 4096 : remaining;
+      prdt[entries].phys = g_ata_dma_page[channel][entries];
+      prdt[entries].count = (uint16_t)chunk;
+      prdt[entries].flags = 0;
+      remaining -= chunk;
+      entries++;
+   }
+   prdt[entries - 1].flags = 0x8000; /* End of table */
+
+   /* Load PRDT, clear stale status, set direction, start. */
+   g_HalIoOperations->outl(bmide_port(channel, BMIDE_REG_PRDT),
+                           (uint32_t)(uintptr_t)prdt);
+   g_HalIoOperations->outb(bmide_port(channel, BMIDE_REG_STATUS),
+                           BMIDE_STATUS_ERR | BMIDE_STATUS_IRQ);
+   uint8_t cmd = is_read ? BMIDE_CMD_READ : 0;
+   g_HalIoOperations->outb(bmide_port(channel, BMIDE_REG_COMMAND), cmd);
+   g_HalIoOperations->outb(bmide_port(channel, BMIDE_REG_COMMAND),
+                           (uint8_t)(cmd | BMIDE_CMD_START));
+
+   /* Sleep until the completion interrupt. */
+   int irq_rc = ata_wait_irq(channel);
+
+   /* Stop the engine and collect status. */
+   uint8_t status = g_HalIoOperations->inb(bmide_port(channel, BMIDE_REG_STATUS));
+   g_HalIoOperations->outb(bmide_port(channel, BMIDE_REG_COMMAND), 0);
+   g_HalIoOperations->outb(bmide_port(channel, BMIDE_REG_STATUS),
+                           BMIDE_STATUS_ERR | BMIDE_STATUS_IRQ);
+
+   if (irq_rc != 0 && !(status & BMIDE_STATUS_IRQ)) return -1;
+   if (status & BMIDE_STATUS_ERR) return -1;
+   return 0;
+}
+
+/* =========================================================================
+ * Interrupt-driven completion path
+ *
+ * Each IDE channel raises IRQ14 (primary) / IRQ15 (secondary) when a DRQ
+ * block is ready or a command completes.  The handler acknowledges the
+ * drive by reading Status, latches a per-channel flag and wakes any
+ * process sleeping on the channel, so a big background read no longer
+ * spins the CPU inside ata_wait_drq while the TTY starves.
+ *
+ * A per-channel busy flag serialises requests: a second process wanting
+ * the channel blocks on it instead of interleaving task-file writes.
+ * ====================================================================== */
+
+#define ATA_IRQ_PRIMARY 14
+#define ATA_IRQ_SECONDARY 15
+
+static volatile bool g_ata_irq_received[2];
+static volatile bool g_ata_channel_busy[2];
+static bool g_ata_irq_installed = false;
+
+static void ata_irq_handler_common(int channel, uint16_t tf_port)
+{
+   /* Reading Status clears the drive's INTRQ assertion. */
+   (void)g_HalIoOperations->inb(tf_port + ATA_REG_STATUS);
+   g_ata_irq_received[channel] = true;
+   Process_WakeByChannel((void *)&g_ata_irq_received[channel]);
+}
+
+static void ata_irq_handler_primary(Registers *regs)
+{
+   (void)regs;
+   ata_irq_handler_common(0, 0x1F0);
+}
+
+static void ata_irq_handler_secondary(Registers *regs)
+{
+   (void)regs;
+   ata_irq_handler_common(1, 0x170);
+}
+
+static void ata_irq_install(void)
+{
+   if (g_ata_irq_installed) return;
+
+   g_HalIrqOperations->RegisterHandler(ATA_IRQ_PRIMARY,
+                                       ata_irq_handler_primary);
+   g_HalIrqOperations->RegisterHandler(ATA_IRQ_SECONDARY,
+                                       ata_irq_handler_secondary);
+   g_HalIrqOperations->Unmask(ATA_IRQ_PRIMARY);
+   g_HalIrqOperations->Unmask(ATA_IRQ_SECONDARY);
+   g_ata_irq_installed = true;
+}
+
+/* Claim exclusive use of a channel, sleeping while another request owns
+ * it.  Safe before the scheduler is up: with no current process the flag
+ * can never be held by anyone else. */
+static void ata_channel_acquire(int channel)
+{
+   Process *cur = Process_GetCurrent();
+   while (g_ata_channel_busy[channel])
+   {
+      if (cur)
+      {
+         Process_BlockOn(cur, (void *)&g_ata_channel_busy[channel]);
+         /* Re-check before the switch happens; the owner may already
+          * have released and issued the wake. */
+         if (!g_ata_channel_busy[channel]) Process_Unblock(cur);
+      }
+      g_HalIoOperations->iowait();
+   }
+   g_ata_channel_busy[channel] = true;
+}
+
+static void ata_channel_release(int channel)
+{
+   g_ata_channel_busy[channel] = false;
+   Process_WakeByChannel((void *)&g_ata_channel_busy[channel]);
+}
+
+/* Wait for the channel's completion IRQ.  The calling process blocks so
+ * the scheduler can run somebody else; the IRQ handler wakes it.  Returns
+ * 0 when the interrupt arrived, -1 on timeout (caller falls back to
+ * status polling). */
+static int ata_wait_irq(int channel)
+{
+   if (!g_ata_irq_installed) return -1;
+
+   uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+   Process *cur = Process_GetCurrent();
+
+   unsigned timeout = 0x100000;
+   while (!g_ata_irq_received[channel] && timeout > 0)
+   {
+      if (cur)
+      {
+         Process_BlockOn(cur, (void *)&g_ata_irq_received[channel]);
+         if (g_ata_irq_received[channel]) Process_Unblock(cur);
+      }
+      timeout--;
+      g_HalIoOperations->iowait();
+   }
+
+   bool received = g_ata_irq_received[channel];
+   g_ata_irq_received[channel] = false;
+   if (cur) Process_Unblock(cur);
+
+   if (!interrupts_were_enabled) g_HalIoOperations->DisableInterrupts();
+
+   return received ? 0 : -1;
+}
+
 /**
  * Get driver for channel and drive
  */
@@ -78,6 +392,11 @@ static ata_driver_t *ata_get_driver(int channel, int drive)
    return NULL;
 }
 
+static inline int ata_channel_of(const ata_driver_t *drv)
+{
+   return (drv->tf_port == 0x1F0) ? 0 : 1;
+}
+
 /**
  * ata_400ns_delay – generate an ~400 ns bus delay by issuing five reads of the
  * Alternate Status register (DCR/Alt-Status port = tf_port + 0x206 offset, but
@@ -209,6 +528,33 @@ static void ata_soft_reset(uint16_t dcr_port)
    for (volatile int i = 0; i < 100000; i++);
 }
 
+/**
+ * ata_setup_multiple – negotiate the READ/WRITE MULTIPLE block size.
+ *
+ * IDENTIFY word 47 (low byte) advertises the maximum sectors the drive can
+ * transfer per DRQ interrupt.  We clamp it to ATA_MULTIPLE_MAX and program
+ * it with SET MULTIPLE MODE; on any failure the driver falls back to
+ * single-sector PIO (multiple_block = 1).
+ */
+static void ata_setup_multiple(ata_driver_t *drv, const uint16_t *id)
+{
+   drv->multiple_block = 1;
+
+   uint8_t max_block = (uint8_t)(id[47] & 0xFF);
+   if (max_block <= 1) return;
+   if (max_block > ATA_MULTIPLE_MAX) max_block = ATA_MULTIPLE_MAX;
+
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_NSECTOR, max_block);
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_COMMAND,
+                           ATA_CMD_SET_MULTIPLE);
+   if (ata_wait_busy(drv->tf_port) != 0) return;
+
+   uint8_t status = g_HalIoOperations->inb(drv->tf_port + ATA_REG_STATUS);
+   if (status & ATA_STATUS_ERR) return;
+
+   drv->multiple_block = max_block;
+}
+
 /**
  * ATA_Init – reset the channel and populate the driver descriptor.
  *
@@ -226,6 +572,13 @@ int ATA_Init(int channel, int drive, uint32_t partition_start,
    /* Bail immediately on a floating bus – no device present. */
    if (ata_is_floating_bus(drv->tf_port)) return -1;
 
+   /* Hook IRQ14/IRQ15 once so the transfer paths can sleep on completion
+    * interrupts instead of burning the CPU polling status. */
+   ata_irq_install();
+
+   /* Probe for a bus-master IDE function once physical pages exist. */
+   if (PMM_IsInitialized()) ata_dma_init();
+
    /* Software reset; then poll until BSY clears (mandatory post-reset wait). */
    ata_soft_reset(drv->dcr_port);
    if (ata_wait_busy(drv->tf_port) != 0) return -1;
@@ -273,28 +626,26 @@ int ATA_Init(int channel, int drive, uint32_t partition_start,
          /* LBA28: words 60–61 hold the 28-bit sector count (little-endian). */
          drv->partition_length = (uint32_t)id[60] | ((uint32_t)id[61] << 16);
       }
+
+      ata_setup_multiple(drv, id);
    }
 
    return 0;
 }
 
 /**
- * Read sectors from ATA drive using PIO mode (28-bit LBA)
+ * ata_read_cmd – issue one READ command for up to 255 sectors.
+ *
+ * Uses READ MULTIPLE when a DRQ block size was negotiated, so the status
+ * polling cost of ata_wait_drq is paid once per block instead of once per
+ * sector; falls back to READ SECTORS otherwise.
  */
-int ATA_Read(DISK *disk, uint32_t lba, uint8_t *buffer, uint32_t count)
+static int ata_read_cmd(ata_driver_t *drv, uint32_t lba, uint8_t *buffer,
+                        uint32_t count)
 {
-   /* Validate inputs and ensure private driver data exists */
-   if (!disk || !disk->private || !buffer || count == 0) return -1;
-   if (disk->type != DISK_TYPE_ATA) return -1;
-
-   ATA_DISK *priv = (ATA_DISK *)disk->private;
-   int channel = priv->channel;
-   int drive = priv->drive;
-   ata_driver_t *drv = ata_get_driver(channel, drive);
-   if (!drv) return -1;
-
-   // Limit to 255 sectors per read (8-bit sector count)
-   if (count > 255) count = 255;
+   uint8_t block = (drv->multiple_block > 1) ? drv->multiple_block : 1;
+   uint8_t cmd = (block > 1) ? ATA_CMD_READ_MULTIPLE : ATA_CMD_READ_PIO;
+   int channel = ata_channel_of(drv);
 
    /*
     * ATA drive-select sequence (OSDev ATA PIO, §3.2):
@@ -316,24 +667,29 @@ int ATA_Read(DISK *disk, uint32_t lba, uint8_t *buffer, uint32_t count)
    g_HalIoOperations->outb(drv->tf_port + ATA_REG_LBA_MID, (lba >> 8) & 0xFF);
    g_HalIoOperations->outb(drv->tf_port + ATA_REG_LBA_HIGH, (lba >> 16) & 0xFF);
 
-   // Issue READ SECTORS command
-   g_HalIoOperations->outb(drv->tf_port + ATA_REG_COMMAND, ATA_CMD_READ_PIO);
+   // Issue READ SECTORS / READ MULTIPLE command
+   g_ata_irq_received[channel] = false;
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_COMMAND, cmd);
 
-   // Read sectors
-   for (uint32_t sec = 0; sec < count; sec++)
+   // Stream whole DRQ blocks; the final block may be short
+   for (uint32_t sec = 0; sec < count; sec += block)
    {
-      // Wait for data ready or error
+      /* Sleep until the drive raises the block-ready interrupt, then
+       * confirm DRQ with a (now immediate) status poll.  A missed or
+       * masked IRQ degrades to the old polling behaviour. */
+      (void)ata_wait_irq(channel);
       if (ata_wait_drq(drv->tf_port) != 0)
       {
          return -1;
       }
 
-      // Read 512 bytes (256 words) from data port using 16-bit reads
-      uint8_t *dest = buffer + (sec * 512);
-      uint16_t *dest_words = (uint16_t *)dest;
-      for (int i = 0; i < 256; i++)
+      uint32_t run = count - sec;
+      if (run > block) run = block;
+
+      // Read run*512 bytes from the data port using 16-bit reads
+      uint16_t *dest_words = (uint16_t *)(buffer + sec * 512);
+      for (uint32_t i = 0; i < run * 256; i++)
       {
-         // Read 16-bit word from data port
          dest_words[i] = g_HalIoOperations->inw(drv->tf_port + ATA_REG_DATA);
       }
    }
@@ -342,25 +698,123 @@ int ATA_Read(DISK *disk, uint32_t lba, uint8_t *buffer, uint32_t count)
 }
 
 /**
- * Write sectors to ATA drive using PIO mode (28-bit LBA)
+ * ata_dma_rw_cmd – one READ DMA / WRITE DMA command through the bounce
+ * pool.  The engine moves the bytes while the caller sleeps; the CPU only
+ * touches the data for the bounce copies.
  */
-int ATA_Write(DISK *disk, uint32_t lba, const uint8_t *buffer, uint32_t count)
+static int ata_dma_rw_cmd(ata_driver_t *drv, uint32_t lba, uint8_t *buffer,
+                          uint32_t count, bool is_read)
+{
+   int channel = ata_channel_of(drv);
+
+   uint8_t device = drv->slave_bits | 0x40 | ((lba >> 24) & 0x0F);
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_DEVICE, device);
+   ata_400ns_delay(drv->dcr_port);
+   if (ata_wait_for_ready(drv->tf_port) != 0) return -1;
+
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_NSECTOR, count & 0xFF);
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_LBA_LOW, lba & 0xFF);
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_LBA_MID, (lba >> 8) & 0xFF);
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_LBA_HIGH, (lba >> 16) & 0xFF);
+
+   if (!is_read)
+   {
+      uint32_t left = count * 512;
+      for (int i = 0; i < ATA_DMA_PAGES && left > 0; i++)
+      {
+         uint32_t chunk = (left > 4096) ? 4096 : left;
+         memcpy((void *)g_ata_dma_page[channel][i], buffer + i * 4096, chunk);
+         left -= chunk;
+      }
+   }
+
+   g_ata_irq_received[channel] = false;
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_COMMAND,
+                           is_read ? ATA_CMD_READ_DMA : ATA_CMD_WRITE_DMA);
+
+   if (ata_dma_transfer(channel, count, is_read) != 0) return -1;
+
+   uint8_t status = g_HalIoOperations->inb(drv->tf_port + ATA_REG_STATUS);
+   if (status & ATA_STATUS_ERR)
+   {
+      uint8_t err = g_HalIoOperations->inb(drv->tf_port + ATA_REG_ERROR);
+      logfmt(LOG_ERROR, "[ATA] DMA error: status=0x%02x error=0x%02x\n",
+             status, err);
+      return -1;
+   }
+
+   if (is_read)
+   {
+      uint32_t left = count * 512;
+      for (int i = 0; i < ATA_DMA_PAGES && left > 0; i++)
+      {
+         uint32_t chunk = (left > 4096) ? 4096 : left;
+         memcpy(buffer + i * 4096, (const void *)g_ata_dma_page[channel][i],
+                chunk);
+         left -= chunk;
+      }
+   }
+
+   return 0;
+}
+
+/**
+ * Read sectors from ATA drive using PIO mode (28-bit LBA).
+ * Counts above 255 are split across multiple commands, so callers such as
+ * DISK_ReadSectors can hand down entire cluster runs in one call.
+ */
+int ATA_Read(DISK *disk, uint32_t lba, uint8_t *buffer, uint32_t count)
 {
    /* Validate inputs and ensure private driver data exists */
    if (!disk || !disk->private || !buffer || count == 0) return -1;
    if (disk->type != DISK_TYPE_ATA) return -1;
 
    ATA_DISK *priv = (ATA_DISK *)disk->private;
-   int channel = priv->channel;
-   int drive = priv->drive;
-
-   ata_driver_t *drv = ata_get_driver(channel, drive);
+   ata_driver_t *drv = ata_get_driver(priv->channel, priv->drive);
    if (!drv) return -1;
 
-   // Limit to 255 sectors per write (8-bit sector count)
-   if (count > 255) count = 255;
+   int channel = ata_channel_of(drv);
+   ata_channel_acquire(channel);
 
-   /* Same drive-select sequence as ATA_Read – DEVICE register first. */
+   bool use_dma = (g_ata_bmide_base != 0);
+   while (count > 0)
+   {
+      uint32_t limit = use_dma ? ATA_DMA_MAX_SECTORS : 255;
+      uint32_t chunk = (count > limit) ? limit : count;
+      int rc = use_dma ? ata_dma_rw_cmd(drv, lba, buffer, chunk, true)
+                       : ata_read_cmd(drv, lba, buffer, chunk);
+      if (rc != 0 && use_dma)
+      {
+         /* DMA failure: retry this chunk over PIO before giving up. */
+         use_dma = false;
+         continue;
+      }
+      if (rc != 0)
+      {
+         ata_channel_release(channel);
+         return -1;
+      }
+      lba += chunk;
+      buffer += chunk * 512;
+      count -= chunk;
+   }
+
+   ata_channel_release(channel);
+   return 0;
+}
+
+/**
+ * ata_write_cmd – issue one WRITE command for up to 255 sectors, using
+ * WRITE MULTIPLE when a DRQ block size was negotiated.
+ */
+static int ata_write_cmd(ata_driver_t *drv, uint32_t lba,
+                         const uint8_t *buffer, uint32_t count)
+{
+   uint8_t block = (drv->multiple_block > 1) ? drv->multiple_block : 1;
+   uint8_t cmd = (block > 1) ? ATA_CMD_WRITE_MULTIPLE : ATA_CMD_WRITE_PIO;
+   int channel = ata_channel_of(drv);
+
+   /* Same drive-select sequence as the read path – DEVICE register first. */
    uint8_t device = drv->slave_bits | 0x40 | ((lba >> 24) & 0x0F);
    g_HalIoOperations->outb(drv->tf_port + ATA_REG_DEVICE, device);
    ata_400ns_delay(drv->dcr_port);
@@ -371,11 +825,12 @@ int ATA_Write(DISK *disk, uint32_t lba, const uint8_t *buffer, uint32_t count)
    g_HalIoOperations->outb(drv->tf_port + ATA_REG_LBA_MID, (lba >> 8) & 0xFF);
    g_HalIoOperations->outb(drv->tf_port + ATA_REG_LBA_HIGH, (lba >> 16) & 0xFF);
 
-   // Issue WRITE SECTORS command
-   g_HalIoOperations->outb(drv->tf_port + ATA_REG_COMMAND, ATA_CMD_WRITE_PIO);
+   // Issue WRITE SECTORS / WRITE MULTIPLE command
+   g_ata_irq_received[channel] = false;
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_COMMAND, cmd);
 
-   // Write sectors
-   for (uint32_t sec = 0; sec < count; sec++)
+   // Stream whole DRQ blocks; the final block may be short
+   for (uint32_t sec = 0; sec < count; sec += block)
    {
       // Wait for drive ready to accept data
       if (ata_wait_drq(drv->tf_port) != 0)
@@ -383,30 +838,23 @@ int ATA_Write(DISK *disk, uint32_t lba, const uint8_t *buffer, uint32_t count)
          return -1;
       }
 
-      // Write 512 bytes (256 words) to data port using 16-bit writes
-      const uint8_t *src = buffer + (sec * 512);
-      const uint16_t *src_words = (const uint16_t *)src;
-      for (int i = 0; i < 256; i++)
+      uint32_t run = count - sec;
+      if (run > block) run = block;
+
+      // Write run*512 bytes to the data port using 16-bit writes
+      const uint16_t *src_words = (const uint16_t *)(buffer + sec * 512);
+      for (uint32_t i = 0; i < run * 256; i++)
       {
-         // Write 16-bit word to data port
          g_HalIoOperations->outw(drv->tf_port + ATA_REG_DATA, src_words[i]);
       }
+   }
 
-      // For all sectors except the last, wait briefly before next sector
-      // For the last sector, wait for completion
-      if (sec < count - 1)
-      {
-         // Brief delay between sectors
-         for (volatile int i = 0; i < 10000; i++);
-      }
-      else
-      {
-         // Last sector: wait for drive to finish
-         if (ata_wait_busy(drv->tf_port) != 0)
-         {
-            return -1;
-         }
-      }
+   /* Sleep until the completion interrupt rather than spinning on BSY;
+    * the polling wait stays as backstop for lost interrupts. */
+   (void)ata_wait_irq(channel);
+   if (ata_wait_busy(drv->tf_port) != 0)
+   {
+      return -1;
    }
 
    // Final status check to catch any errors
@@ -423,6 +871,105 @@ int ATA_Write(DISK *disk, uint32_t lba, const uint8_t *buffer, uint32_t count)
    return 0;
 }
 
+/**
+ * Write sectors to ATA drive using PIO mode (28-bit LBA).
+ * Counts above 255 are split across multiple commands.
+ */
+int ATA_Write(DISK *disk, uint32_t lba, const uint8_t *buffer, uint32_t count)
+{
+   /* Validate inputs and ensure private driver data exists */
+   if (!disk || !disk->private || !buffer || count == 0) return -1;
+   if (disk->type != DISK_TYPE_ATA) return -1;
+
+   ATA_DISK *priv = (ATA_DISK *)disk->private;
+   ata_driver_t *drv = ata_get_driver(priv->channel, priv->drive);
+   if (!drv) return -1;
+
+   int channel = ata_channel_of(drv);
+   ata_channel_acquire(channel);
+
+   bool use_dma = (g_ata_bmide_base != 0);
+   while (count > 0)
+   {
+      uint32_t limit = use_dma ? ATA_DMA_MAX_SECTORS : 255;
+      uint32_t chunk = (count > limit) ? limit : count;
+      int rc = use_dma
+                   ? ata_dma_rw_cmd(drv, lba, (uint8_t *)buffer, chunk, false)
+                   : ata_write_cmd(drv, lba, buffer, chunk);
+      if (rc != 0 && use_dma)
+      {
+         use_dma = false;
+         continue;
+      }
+      if (rc != 0)
+      {
+         ata_channel_release(channel);
+         return -1;
+      }
+      lba += chunk;
+      buffer += chunk * 512;
+      count -= chunk;
+   }
+
+   ata_channel_release(channel);
+   return 0;
+}
+
+/**
+ * Issue FLUSH CACHE so the drive commits its volatile write cache to
+ * media.  This is the barrier that makes running with the drive cache
+ * enabled safe: once it returns, every previously acknowledged write
+ * is durable.
+ */
+int ATA_FlushCache(DISK *disk)
+{
+   if (!disk || !disk->private) return -1;
+   if (disk->type != DISK_TYPE_ATA) return -1;
+
+   ATA_DISK *priv = (ATA_DISK *)disk->private;
+   ata_driver_t *drv = ata_get_driver(priv->channel, priv->drive);
+   if (!drv) return -1;
+
+   int channel = ata_channel_of(drv);
+   ata_channel_acquire(channel);
+
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_DEVICE,
+                           drv->slave_bits | 0x40);
+   ata_400ns_delay(drv->dcr_port);
+   if (ata_wait_for_ready(drv->tf_port) != 0)
+   {
+      ata_channel_release(channel);
+      return -1;
+   }
+
+   g_ata_irq_received[channel] = false;
+   g_HalIoOperations->outb(drv->tf_port + ATA_REG_COMMAND,
+                           ATA_CMD_FLUSH_CACHE);
+
+   /* Emptying a full cache can take the drive a while; sleep on the
+    * completion interrupt with the BSY poll as backstop, like the
+    * transfer paths. */
+   (void)ata_wait_irq(channel);
+   if (ata_wait_busy(drv->tf_port) != 0)
+   {
+      ata_channel_release(channel);
+      return -1;
+   }
+
+   uint8_t status = g_HalIoOperations->inb(drv->tf_port + ATA_REG_STATUS);
+   if (status & ATA_STATUS_ERR)
+   {
+      uint8_t err = g_HalIoOperations->inb(drv->tf_port + ATA_REG_ERROR);
+      logfmt(LOG_ERROR, "[ATA] Flush error: status=0x%02x error=0x%02x\n",
+             status, err);
+      ata_channel_release(channel);
+      return -1;
+   }
+
+   ata_channel_release(channel);
+   return 0;
+}
+
 /**
  * Perform software reset on ATA channel
  */
@@ -433,17 +980,17 @@ void ATA_Reset(int channel)
 }
 
 /**
- * ATA_Identify – issue IDENTIFY DEVICE and return the 256-word response.
+ * ata_identify_issue – select the drive and fire IDENTIFY without waiting
+ * for the data phase.  Splitting issue from collect lets ATA_Scan overlap
+ * the two channels: the secondary channel chews on its IDENTIFY while we
+ * are still collecting from the primary.
  *
  * Drive-select uses slave_bits directly (already encodes the master/slave
  * bit – no need to re-OR the drive index, which would corrupt bit 4).
  * A 400 ns delay follows the device-register write before polling DRDY.
  */
-int ATA_Identify(int channel, int drive, uint16_t *buffer)
+static int ata_identify_issue(ata_driver_t *driver)
 {
-   ata_driver_t *driver = ata_get_driver(channel, drive);
-   if (!driver) return -1;
-
    /* Guard against empty / floating channel. */
    if (ata_is_floating_bus(driver->tf_port)) return -1;
 
@@ -451,125 +998,189 @@ int ATA_Identify(int channel, int drive, uint16_t *buffer)
    g_HalIoOperations->outb(driver->tf_port + ATA_REG_DEVICE,
                            driver->slave_bits);
    ata_400ns_delay(driver->dcr_port);
+
+   /* A populated channel never floats, but a missing drive on it never
+    * drives Status either – it reads back 0x00 after the select.  Bail
+    * here rather than burning the full ready-wait timeout on it. */
+   if (g_HalIoOperations->inb(driver->tf_port + ATA_REG_STATUS) == 0x00)
+      return -1;
+
    if (ata_wait_for_ready(driver->tf_port) != 0) return -1;
 
-   /* Issue IDENTIFY and wait for the data buffer to fill. */
    g_HalIoOperations->outb(driver->tf_port + ATA_REG_COMMAND, ATA_CMD_IDENTIFY);
+   return 0;
+}
+
+/**
+ * ata_identify_collect – wait out the data phase of a previously issued
+ * IDENTIFY and read the 256-word response.
+ *
+ * ATA IDENTIFY stores ASCII strings in word-swapped order: within each
+ * 16-bit word the high byte is the first character.  Callers that extract
+ * model/serial strings must swap accordingly (see ATA_Scan below).
+ */
+static int ata_identify_collect(ata_driver_t *driver, uint16_t *buffer)
+{
    if (ata_wait_drq(driver->tf_port) != 0) return -1;
 
-   /*
-    * Read 256 words.
-    * ATA IDENTIFY stores ASCII strings in word-swapped order: within each
-    * 16-bit word the high byte is the first character.  Callers that extract
-    * model/serial strings must swap accordingly (see ATA_Scan below).
-    */
    for (int i = 0; i < 256; i++)
       buffer[i] = g_HalIoOperations->inw(driver->tf_port + ATA_REG_DATA);
 
    return 0;
 }
 
+/**
+ * ATA_Identify – issue IDENTIFY DEVICE and return the 256-word response.
+ */
+int ATA_Identify(int channel, int drive, uint16_t *buffer)
+{
+   ata_driver_t *driver = ata_get_driver(channel, drive);
+   if (!driver) return -1;
+
+   if (ata_identify_issue(driver) != 0) return -1;
+
+   return ata_identify_collect(driver, buffer);
+}
+
 /**
  * Scan for ATA disks
+ *
+ * All 4 possible devices (primary/secondary channel, master/slave) are
+ * probed in two overlapped rounds: IDENTIFY is issued to both channels
+ * first and collected afterwards, so one channel's BSY time hides behind
+ * the other's instead of adding up.  One floating-bus read per channel
+ * rules out unpopulated cables before any per-drive work, and results
+ * land in g_AtaTopology so repeat scans skip known-absent slots outright.
  */
 int ATA_Scan(DISK *disks, int maxDisks)
 {
    int count = 0;
 
-   // Scan all 4 possible ATA devices:
-   // Channel 0 (Primary), Drive 0 (Master)
-   // Channel 0 (Primary), Drive 1 (Slave)
-   // Channel 1 (Secondary), Drive 0 (Master)
-   // Channel 1 (Secondary), Drive 1 (Slave)
+   /* Phase 0: a floating Status register means nothing is on the cable
+    * at all – write off both drive slots of that channel at once. */
    for (int ch = 0; ch < 2; ch++)
    {
-      for (int dr = 0; dr < 2; dr++)
+      if (g_AtaTopology[ch][0] != -1) continue; /* Cached from a prior scan */
+      if (ata_is_floating_bus(ata_get_driver(ch, 0)->tf_port))
+      {
+         g_AtaTopology[ch][0] = 0;
+         g_AtaTopology[ch][1] = 0;
+      }
+   }
+
+   /* Probe the masters on both channels in parallel, then the slaves
+    * (the two drives of one channel share a cable and cannot overlap). */
+   for (int dr = 0; dr < 2; dr++)
+   {
+      bool pending[2] = {false, false};
+      uint16_t identify_buffer[2][256];
+
+      for (int ch = 0; ch < 2; ch++)
+      {
+         if (g_AtaTopology[ch][dr] == 0) continue; /* Known absent */
+
+         if (ata_identify_issue(ata_get_driver(ch, dr)) == 0)
+            pending[ch] = true;
+         else
+            g_AtaTopology[ch][dr] = 0;
+      }
+
+      for (int ch = 0; ch < 2; ch++)
       {
+         if (!pending[ch]) continue;
          if (count >= maxDisks) break;
 
-         // Attempt to initialize the controller/drive
-         // We pass 0 for partition info as we are just probing
-         if (ATA_Init(ch, dr, 0, 0) != 0)
+         if (ata_identify_collect(ata_get_driver(ch, dr),
+                                  identify_buffer[ch]) != 0)
          {
+            g_AtaTopology[ch][dr] = 0;
             continue;
          }
+         g_AtaTopology[ch][dr] = 1;
+
+         // Extract size: Use LBA48 if supported (words 100-103), else CHS
+         uint64_t total_sectors = 0;
+         if (identify_buffer[ch][83] & (1 << 10))
+         { // LBA48 supported
+            total_sectors = ((uint64_t)identify_buffer[ch][103] << 48) |
+                            ((uint64_t)identify_buffer[ch][102] << 32) |
+                            ((uint64_t)identify_buffer[ch][101] << 16) |
+                            identify_buffer[ch][100];
+         }
+         else
+         {
+            total_sectors = identify_buffer[ch][60] |
+                            ((uint32_t)identify_buffer[ch][61] << 16);
+         }
 
-         uint16_t identify_buffer[256];
-         if (ATA_Identify(ch, dr, identify_buffer) == 0)
+         /* Initialize the controller/drive.  The sector count from the
+          * scan IDENTIFY is passed along so ATA_Init can skip its own
+          * IDENTIFY round trip; only the DRQ block negotiation remains. */
+         if (ATA_Init(ch, dr, 0, (uint32_t)total_sectors) != 0)
          {
-            ATA_DISK *private = kmalloc(sizeof(ATA_DISK));
-            if (!private)
-            {
-               logfmt(LOG_ERROR,
-                      "[DISK] Failed to allocate ATA_DISK for ch%d dr%d\n", ch,
-                      dr);
-               continue;
-            }
-            private->channel = ch;
-            private->drive = dr;
-
-            /* BIOS-style drive ID: 0x80=primary-master, 0x81=primary-slave,
-             * 0x82=secondary-master, 0x83=secondary-slave */
-            disks[count].id = (uint8_t)(0x80 + ch * 2 + dr);
-            disks[count].type = 1; // DISK_TYPE_ATA
-
-            // Extract model name (words 27-46, 40 chars)
-            for (int i = 0; i < 20; i++)
-            {
-               uint16_t word = identify_buffer[27 + i];
-               disks[count].brand[i * 2] = (word >> 8) & 0xFF;
-               disks[count].brand[i * 2 + 1] = word & 0xFF;
-            }
-            disks[count].brand[40] = '\0';
-            // Trim trailing spaces
-            for (int i = 39; i >= 0; i--)
-            {
-               if (disks[count].brand[i] == ' ')
-                  disks[count].brand[i] = '\0';
-               else
-                  break;
-            }
-
-            // Extract size: Use LBA48 if supported (words 100-103), else CHS
-            uint64_t total_sectors = 0;
-            if (identify_buffer[83] & (1 << 10))
-            { // LBA48 supported
-               total_sectors = ((uint64_t)identify_buffer[103] << 48) |
-                               ((uint64_t)identify_buffer[102] << 32) |
-                               ((uint64_t)identify_buffer[101] << 16) |
-                               identify_buffer[100];
-            }
-            else
-            {
-               total_sectors =
-                   identify_buffer[60] | ((uint32_t)identify_buffer[61] << 16);
-            }
-            disks[count].size = total_sectors * 512; // Sector size is 512 bytes
-            disks[count].private = private;
+            g_AtaTopology[ch][dr] = 0;
+            continue;
+         }
+         ata_setup_multiple(ata_get_driver(ch, dr), identify_buffer[ch]);
 
-            logfmt(LOG_INFO,
-                   "[DISK] Found ATA disk: ID=0x%x, Type=%u, Brand='%s', "
-                   "Size=%llu bytes (Ch%d/Dr%d)\n",
-                   disks[count].id, disks[count].type, disks[count].brand,
-                   disks[count].size, ch, dr);
-
-            /* Register the disk device in devfs
-             * Device naming: hda, hdb, hdc, hdd for primary/secondary
-             * master/slave
-             */
-            char devname[8];
-            devname[0] = 'h';
-            devname[1] = 'd';
-            devname[2] = 'a' + (ch * 2) + dr; /* hda=0, hdb=1, hdc=2, hdd=3 */
-            devname[3] = '\0';
-
-            /* Major 3 for IDE disks, minor = disk index */
-            uint32_t disk_size = (uint32_t)(disks[count].size & 0xFFFFFFFF);
-            DEVFS_RegisterDevice(devname, DEVFS_TYPE_BLOCK, 3, count, disk_size,
-                                 &disk_ops, &disks[count]);
-
-            count++;
+         ATA_DISK *private = kmalloc(sizeof(ATA_DISK));
+         if (!private)
+         {
+            logfmt(LOG_ERROR,
+                   "[DISK] Failed to allocate ATA_DISK for ch%d dr%d\n", ch,
+                   dr);
+            continue;
+         }
+         private->channel = ch;
+         private->drive = dr;
+
+         /* BIOS-style drive ID: 0x80=primary-master, 0x81=primary-slave,
+          * 0x82=secondary-master, 0x83=secondary-slave */
+         disks[count].id = (uint8_t)(0x80 + ch * 2 + dr);
+         disks[count].type = 1; // DISK_TYPE_ATA
+
+         // Extract model name (words 27-46, 40 chars)
+         for (int i = 0; i < 20; i++)
+         {
+            uint16_t word = identify_buffer[ch][27 + i];
+            disks[count].brand[i * 2] = (word >> 8) & 0xFF;
+            disks[count].brand[i * 2 + 1] = word & 0xFF;
          }
+         disks[count].brand[40] = '\0';
+         // Trim trailing spaces
+         for (int i = 39; i >= 0; i--)
+         {
+            if (disks[count].brand[i] == ' ')
+               disks[count].brand[i] = '\0';
+            else
+               break;
+         }
+
+         disks[count].size = total_sectors * 512; // Sector size is 512 bytes
+         disks[count].private = private;
+
+         logfmt(LOG_INFO,
+                "[DISK] Found ATA disk: ID=0x%x, Type=%u, Brand='%s', "
+                "Size=%llu bytes (Ch%d/Dr%d)\n",
+                disks[count].id, disks[count].type, disks[count].brand,
+                disks[count].size, ch, dr);
+
+         /* Register the disk device in devfs
+          * Device naming: hda, hdb, hdc, hdd for primary/secondary
+          * master/slave
+          */
+         char devname[8];
+         devname[0] = 'h';
+         devname[1] = 'd';
+         devname[2] = 'a' + (ch * 2) + dr; /* hda=0, hdb=1, hdc=2, hdd=3 */
+         devname[3] = '\0';
+
+         /* Major 3 for IDE disks, minor = disk index */
+         uint32_t disk_size = (uint32_t)(disks[count].size & 0xFFFFFFFF);
+         DEVFS_RegisterDevice(devname, DEVFS_TYPE_BLOCK, 3, count, disk_size,
+                              &disk_ops, &disks[count]);
+
+         count++;
       }
    }
    return count;
@@ -54,6 +54,14 @@ int ATA_Read(DISK *disk, uint32_t lba, uint8_t *buffer, uint32_t count);
  */
 int ATA_Write(DISK *disk, uint32_t lba, const uint8_t *buffer, uint32_t count);
 
+/**
+ * Flush the drive's volatile write cache to media (FLUSH CACHE).
+ * Returns once previously acknowledged writes are durable.
+ * @param disk - ATA disk to flush
+ * @return 0 on success, -1 on failure
+ */
+int ATA_FlushCache(DISK *disk);
+
 /**
  * Perform software reset on ATA channel
  * @param channel - IDE channel (ATA_CHANNEL_PRIMARY or ATA_CHANNEL_SECONDARY)
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "fdc.h"
+#include <cpu/kthread.h>
+#include <cpu/timer.h>
 #include <fs/devfs/devfs.h>
 #include <hal/io.h>
 #include <hal/irq.h>
@@ -10,6 +12,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/cmdline.h>
 #include <sys/sys.h>
 #include <sys/system.h>
 
@@ -50,6 +53,49 @@ static DEVFS_DeviceOps disk_ops = {.read = DISK_DevfsRead,
 // boundary)
 #define FDC_DMA_BUFFER 0x1000
 
+#define FDC_TRACK_BYTES (FLOPPY_SECTORS_PER_TRACK * FLOPPY_SECTOR_SIZE)
+
+/* =========================================================================
+ * Track cache
+ *
+ * A seek plus rotational latency dwarfs the cost of the extra sectors,
+ * so the first read of any sector pulls its whole track (18 sectors,
+ * 9 KiB) in one DMA transfer and later reads on that track are served
+ * from memory.  Sequential loads - the common floppy workload - touch
+ * the mechanism once per 18 sectors instead of once per sector.
+ * ====================================================================== */
+
+#define FDC_TRACK_CACHE_ENTRIES 4
+
+typedef struct
+{
+   bool valid;
+   uint8_t drive;
+   uint8_t head;
+   uint8_t track;
+   uint64_t last_used; /* Timer_GetTicks at last hit, for eviction */
+   uint8_t data[FDC_TRACK_BYTES];
+} FdcTrackCache;
+
+static FdcTrackCache g_TrackCache[FDC_TRACK_CACHE_ENTRIES];
+
+/* =========================================================================
+ * Motor idle window
+ *
+ * Spin-up costs ~300 ms, so the motor is left running for a while after
+ * each transfer instead of stopping between bursts.  A parked kernel
+ * thread turns it off once the window (fdc_motor_ms boot flag, default
+ * 2000) passes without further I/O.
+ * ====================================================================== */
+
+#define FDC_MOTOR_IDLE_DEFAULT_MS 2000u
+
+static int g_MotorDrive = -1; /* Drive whose motor is running, -1 = none */
+static uint64_t g_MotorDeadline = 0;
+static uint32_t g_MotorIdleMs = FDC_MOTOR_IDLE_DEFAULT_MS;
+static bool g_MotorIdleParsed = false;
+static Process *g_MotorThread = NULL;
+
 // Global IRQ synchronization flag
 static volatile bool g_fdc_irq_received = false;
 
@@ -60,7 +106,7 @@ static uint8_t cmos_read(uint8_t idx)
    return g_HalIoOperations->inb(0x71);
 }
 
-static void fdc_dma_init(bool is_read)
+static void fdc_dma_init(bool is_read, uint32_t bytes)
 {
    /* Initialize DMA channel 2 for floppy disk controller
     * Mode for channel 2:
@@ -77,7 +123,7 @@ static void fdc_dma_init(bool is_read)
    if (is_read)
    {
       uint8_t *dma_buffer = (uint8_t *)FDC_DMA_BUFFER;
-      for (int i = 0; i < FLOPPY_SECTOR_SIZE; i++)
+      for (uint32_t i = 0; i < bytes; i++)
       {
          dma_buffer[i] = 0xAA;
       }
@@ -111,7 +157,7 @@ static void fdc_dma_init(bool is_read)
    g_HalIoOperations->outb(DMA_CHANNEL_2_PAGE, (addr >> 16) & 0xFF);
 
    // Set count (number of bytes - 1)
-   uint16_t count = FLOPPY_SECTOR_SIZE - 1;
+   uint16_t count = bytes - 1;
    g_HalIoOperations->outb(DMA_FLIP_FLOP_RESET, 0x0C);
    g_HalIoOperations->outb(DMA_CHANNEL_2_COUNT, count & 0xFF);
    g_HalIoOperations->outb(DMA_CHANNEL_2_COUNT, (count >> 8) & 0xFF);
@@ -121,6 +167,17 @@ static void fdc_dma_init(bool is_read)
                            0x02); // 0x02 = 0b0010 = mask clear | channel 2
 }
 
+/* Bytes the DMA controller did NOT transfer.  The count register holds
+ * `remaining - 1` and wraps to 0xFFFF on completion, so a finished
+ * transfer reads back as 0. */
+static uint32_t fdc_dma_residual(void)
+{
+   g_HalIoOperations->outb(DMA_FLIP_FLOP_RESET, 0x0C);
+   uint16_t count = g_HalIoOperations->inb(DMA_CHANNEL_2_COUNT);
+   count |= (uint16_t)g_HalIoOperations->inb(DMA_CHANNEL_2_COUNT) << 8;
+   return (uint32_t)((uint16_t)(count + 1));
+}
+
 // Build the Digital Output Register value for a drive
 static inline uint8_t fdc_make_dor(uint8_t drive, bool motor_on)
 {
@@ -139,6 +196,83 @@ static void fdc_motor_off(uint8_t drive)
    g_HalIoOperations->outb(FDC_DOR, fdc_make_dor(drive, false));
 }
 
+/* Background motor governor: parks until a transfer arms the idle
+ * window, then stops the motor once the window passes without I/O. */
+static void fdc_motor_worker(void *arg)
+{
+   (void)arg;
+   for (;;)
+   {
+      if (g_MotorDrive < 0)
+      {
+         KThread_Park();
+         continue;
+      }
+
+      uint64_t now = Timer_GetTicks();
+      if (now >= g_MotorDeadline)
+      {
+         fdc_motor_off((uint8_t)g_MotorDrive);
+         g_MotorDrive = -1;
+         continue;
+      }
+
+      /* The deadline moves on every transfer; re-check after sleeping
+       * up to it.  One tick is one millisecond. */
+      Timer_SleepMs((uint32_t)(g_MotorDeadline - now));
+   }
+}
+
+static uint32_t fdc_motor_idle_ms(void)
+{
+   if (!g_MotorIdleParsed)
+   {
+      g_MotorIdleMs =
+         CmdLine_GetU32(CMDLINE_OPT_FDC_MOTOR_MS, FDC_MOTOR_IDLE_DEFAULT_MS);
+      g_MotorIdleParsed = true;
+   }
+   return g_MotorIdleMs;
+}
+
+/* Select the drive and make sure its motor is up to speed.  The 300 ms
+ * spin-up is only paid when the motor was actually stopped; within the
+ * idle window it is still turning and the transfer starts immediately. */
+static void fdc_motor_begin(uint8_t drive)
+{
+   bool already_spinning = (g_MotorDrive == (int)drive);
+
+   fdc_motor_on(drive);
+   if (!already_spinning)
+   {
+      /* Spin-up delay: ~300 ms on real hardware.  Sleeping on the timer
+       * wheel lets other processes run instead of burning the CPU. */
+      Timer_SleepMs(300);
+   }
+   g_MotorDrive = drive;
+}
+
+/* Arm the idle window instead of stopping the motor.  If no worker
+ * thread can be created the motor is stopped immediately, restoring the
+ * old stop-per-burst behaviour. */
+static void fdc_motor_end(uint8_t drive)
+{
+   g_MotorDeadline = Timer_GetTicks() + fdc_motor_idle_ms();
+
+   if (!g_MotorThread)
+   {
+      g_MotorThread = KThread_Create("fdmotor", fdc_motor_worker, NULL);
+   }
+
+   if (!g_MotorThread)
+   {
+      fdc_motor_off(drive);
+      g_MotorDrive = -1;
+      return;
+   }
+
+   KThread_Wake(g_MotorThread);
+}
+
 // FDC IRQ handler - sets flag when interrupt is received
 static void fdc_irq_handler(Registers *regs)
 {
@@ -302,6 +436,198 @@ static void lba_to_chs(uint32_t lba, uint8_t *head, uint8_t *track,
    *sector = (lba % FLOPPY_SECTORS_PER_TRACK) + 1;
 }
 
+/* One sector via DMA, with retries.  Kept as the fallback for marginal
+ * media where a whole-track read keeps failing on one bad sector. */
+static int fdc_read_sector(uint8_t drive, uint8_t head, uint8_t track,
+                           uint8_t sector, uint8_t *out)
+{
+   /* Retry the sector up to 3 times.  On the first retry, recalibrate
+    * the drive so mechanical positioning errors are corrected. */
+   for (int attempt = 0; attempt < 3; attempt++)
+   {
+      if (attempt > 0)
+      {
+         logfmt(LOG_WARNING, "[FDC] Retry %d (T=%u H=%u S=%u)\n", attempt,
+                track, head, sector);
+         /* Recalibrate moves head back to track 0 — clears state */
+         fdc_recalibrate(drive);
+      }
+
+      /* Seek to correct track */
+      if (fdc_seek(drive, head, track) < 0) continue;
+
+      /* Set up DMA for a single-sector read */
+      fdc_dma_init(true, FLOPPY_SECTOR_SIZE);
+
+      g_fdc_irq_received = false;
+
+      /* Issue READ DATA command */
+      fdc_send_byte(FDC_CMD_READ_DATA);
+      fdc_send_byte((head << 2) | (drive & 0x03));
+      fdc_send_byte(track);
+      fdc_send_byte(head);
+      fdc_send_byte(sector);
+      fdc_send_byte(2);      /* N=2 → 512 bytes/sector */
+      fdc_send_byte(sector); /* EOT = same sector → read 1 sector */
+      fdc_send_byte(0x1B);   /* GPL */
+      fdc_send_byte(0xFF);   /* DTL */
+
+      if (fdc_wait_irq() < 0)
+      {
+         logfmt(LOG_WARNING, "[FDC] IRQ timeout on attempt %d\n", attempt);
+         continue;
+      }
+
+      /* Read all 7 result bytes (must be consumed regardless of error) */
+      uint8_t st0 = fdc_read_byte();
+      uint8_t st1 = fdc_read_byte();
+      uint8_t st2 = fdc_read_byte();
+      uint8_t rtrack = fdc_read_byte();
+      uint8_t rhead = fdc_read_byte();
+      uint8_t rsect = fdc_read_byte();
+      uint8_t bps = fdc_read_byte();
+
+      if ((st0 & 0xC0) != 0)
+      {
+         logfmt(LOG_ERROR,
+                "[FDC] Read error: st0=0x%02x st1=0x%02x st2=0x%02x "
+                "T=%u H=%u S=%u BPS=%u\n",
+                st0, st1, st2, rtrack, rhead, rsect, bps);
+         continue;
+      }
+
+      /* Verify the DMA engine actually moved every byte; a short
+       * transfer would leave stale fill bytes in the buffer. */
+      uint32_t residual = fdc_dma_residual();
+      if (residual != 0)
+      {
+         logfmt(LOG_ERROR, "[FDC] Short DMA transfer: residual=%u of %u\n",
+                residual, (unsigned)FLOPPY_SECTOR_SIZE);
+         continue;
+      }
+
+      memcpy(out, (uint8_t *)FDC_DMA_BUFFER, FLOPPY_SECTOR_SIZE);
+      return SUCCESS;
+   }
+
+   return -EIO;
+}
+
+/* One whole track (18 sectors) in a single READ DATA command: start at
+ * sector 1 with EOT past the last sector and let the controller stream
+ * the rotation into the DMA buffer.  Costs one seek and at most one
+ * revolution - the same mechanical price as reading a single sector. */
+static int fdc_read_track(uint8_t drive, uint8_t head, uint8_t track,
+                          uint8_t *out)
+{
+   for (int attempt = 0; attempt < 3; attempt++)
+   {
+      if (attempt > 0)
+      {
+         logfmt(LOG_WARNING, "[FDC] Track retry %d (T=%u H=%u)\n", attempt,
+                track, head);
+         fdc_recalibrate(drive);
+      }
+
+      if (fdc_seek(drive, head, track) < 0) continue;
+
+      fdc_dma_init(true, FDC_TRACK_BYTES);
+
+      g_fdc_irq_received = false;
+
+      fdc_send_byte(FDC_CMD_READ_DATA);
+      fdc_send_byte((head << 2) | (drive & 0x03));
+      fdc_send_byte(track);
+      fdc_send_byte(head);
+      fdc_send_byte(1);                        /* Start at sector 1 */
+      fdc_send_byte(2);                        /* N=2 → 512 bytes/sector */
+      fdc_send_byte(FLOPPY_SECTORS_PER_TRACK); /* EOT = whole track */
+      fdc_send_byte(0x1B);                     /* GPL */
+      fdc_send_byte(0xFF);                     /* DTL */
+
+      if (fdc_wait_irq() < 0)
+      {
+         logfmt(LOG_WARNING, "[FDC] Track IRQ timeout on attempt %d\n",
+                attempt);
+         continue;
+      }
+
+      uint8_t st0 = fdc_read_byte();
+      uint8_t st1 = fdc_read_byte();
+      uint8_t st2 = fdc_read_byte();
+      fdc_read_byte(); /* track */
+      fdc_read_byte(); /* head */
+      fdc_read_byte(); /* sector */
+      fdc_read_byte(); /* bytes-per-sector code */
+
+      if ((st0 & 0xC0) != 0)
+      {
+         logfmt(LOG_ERROR,
+                "[FDC] Track read error: st0=0x%02x st1=0x%02x st2=0x%02x "
+                "T=%u H=%u\n",
+                st0, st1, st2, track, head);
+         continue;
+      }
+
+      uint32_t residual = fdc_dma_residual();
+      if (residual != 0)
+      {
+         logfmt(LOG_ERROR, "[FDC] Short DMA transfer: residual=%u of %u\n",
+                residual, (unsigned)FDC_TRACK_BYTES);
+         continue;
+      }
+
+      memcpy(out, (uint8_t *)FDC_DMA_BUFFER, FDC_TRACK_BYTES);
+      return SUCCESS;
+   }
+
+   return -EIO;
+}
+
+static FdcTrackCache *fdc_track_cache_find(uint8_t drive, uint8_t head,
+                                           uint8_t track)
+{
+   for (int i = 0; i < FDC_TRACK_CACHE_ENTRIES; i++)
+   {
+      FdcTrackCache *entry = &g_TrackCache[i];
+      if (entry->valid && entry->drive == drive && entry->head == head &&
+          entry->track == track)
+      {
+         entry->last_used = Timer_GetTicks();
+         return entry;
+      }
+   }
+   return NULL;
+}
+
+/* Read the track into a free slot, evicting the least recently hit one
+ * when all are taken.  Returns NULL when the track read fails. */
+static FdcTrackCache *fdc_track_cache_fill(uint8_t drive, uint8_t head,
+                                           uint8_t track)
+{
+   FdcTrackCache *victim = &g_TrackCache[0];
+   for (int i = 0; i < FDC_TRACK_CACHE_ENTRIES; i++)
+   {
+      if (!g_TrackCache[i].valid)
+      {
+         victim = &g_TrackCache[i];
+         break;
+      }
+      if (g_TrackCache[i].last_used < victim->last_used)
+         victim = &g_TrackCache[i];
+   }
+
+   victim->valid = false; /* Stays invalid if the read fails midway */
+   if (fdc_read_track(drive, head, track, victim->data) < 0) return NULL;
+
+   victim->drive = drive;
+   victim->head = head;
+   victim->track = track;
+   victim->last_used = Timer_GetTicks();
+   victim->valid = true;
+   return victim;
+}
+
 int FDC_ReadLba(DISK *disk, uint32_t lba, uint8_t *buffer, size_t count)
 {
    if (!disk || !disk->private || !buffer || count == 0) return -1;
@@ -314,92 +640,38 @@ int FDC_ReadLba(DISK *disk, uint32_t lba, uint8_t *buffer, size_t count)
     * may have modified the PIC mask after FDC_Reset ran. */
    i686_IRQ_Unmask(FDC_IRQ);
 
-   fdc_motor_on(drive);
-
-   /* Spin-up delay: ~300 ms on real hardware.  In QEMU the floppy is
-    * virtual so the loop need not be huge, but a generous delay prevents
-    * races when the motor was previously off for a long time. */
-   for (volatile int i = 0; i < 500000; i++);
+   fdc_motor_begin(drive);
 
    for (size_t i = 0; i < count; i++)
    {
       uint8_t head, track, sector;
       lba_to_chs(lba + i, &head, &track, &sector);
 
-      bool sector_ok = false;
-
-      /* Retry the sector up to 3 times.  On the first retry, recalibrate
-       * the drive so mechanical positioning errors are corrected. */
-      for (int attempt = 0; attempt < 3 && !sector_ok; attempt++)
+      /* Serve from the track cache, pulling the whole track on a miss;
+       * the next 17 sectors of a sequential load then cost a memcpy. */
+      FdcTrackCache *cached = fdc_track_cache_find(drive, head, track);
+      if (!cached) cached = fdc_track_cache_fill(drive, head, track);
+      if (cached)
       {
-         if (attempt > 0)
-         {
-            logfmt(LOG_WARNING, "[FDC] Retry %d for LBA=%u (T=%u H=%u S=%u)\n",
-                   attempt, (unsigned)(lba + i), track, head, sector);
-            /* Recalibrate moves head back to track 0 — clears state */
-            fdc_recalibrate(drive);
-         }
-
-         /* Seek to correct track */
-         if (fdc_seek(drive, head, track) < 0) continue;
-
-         /* Set up DMA for a single-sector read */
-         fdc_dma_init(true);
-
-         g_fdc_irq_received = false;
-
-         /* Issue READ DATA command */
-         fdc_send_byte(FDC_CMD_READ_DATA);
-         fdc_send_byte((head << 2) | (drive & 0x03));
-         fdc_send_byte(track);
-         fdc_send_byte(head);
-         fdc_send_byte(sector);
-         fdc_send_byte(2);      /* N=2 → 512 bytes/sector */
-         fdc_send_byte(sector); /* EOT = same sector → read 1 sector */
-         fdc_send_byte(0x1B);   /* GPL */
-         fdc_send_byte(0xFF);   /* DTL */
-
-         if (fdc_wait_irq() < 0)
-         {
-            logfmt(LOG_WARNING, "[FDC] IRQ timeout on attempt %d\n", attempt);
-            continue;
-         }
-
-         /* Read all 7 result bytes (must be consumed regardless of error) */
-         uint8_t st0 = fdc_read_byte();
-         uint8_t st1 = fdc_read_byte();
-         uint8_t st2 = fdc_read_byte();
-         uint8_t rtrack = fdc_read_byte();
-         uint8_t rhead = fdc_read_byte();
-         uint8_t rsect = fdc_read_byte();
-         uint8_t bps = fdc_read_byte();
-
-         if ((st0 & 0xC0) != 0)
-         {
-            logfmt(LOG_ERROR,
-                   "[FDC] Read error: st0=0x%02x st1=0x%02x st2=0x%02x "
-                   "T=%u H=%u S=%u BPS=%u\n",
-                   st0, st1, st2, rtrack, rhead, rsect, bps);
-            continue;
-         }
-
-         /* Copy DMA buffer to caller's destination buffer */
-         uint8_t *dma_buffer = (uint8_t *)FDC_DMA_BUFFER;
-         memcpy(buffer + i * FLOPPY_SECTOR_SIZE, dma_buffer,
+         memcpy(buffer + i * FLOPPY_SECTOR_SIZE,
+                cached->data + (uint32_t)(sector - 1) * FLOPPY_SECTOR_SIZE,
                 FLOPPY_SECTOR_SIZE);
-         sector_ok = true;
+         continue;
       }
 
-      if (!sector_ok)
+      /* The track read kept failing - likely one bad sector spoiling
+       * the streamed transfer.  Try just the sector we need. */
+      if (fdc_read_sector(drive, head, track, sector,
+                          buffer + i * FLOPPY_SECTOR_SIZE) < 0)
       {
          logfmt(LOG_ERROR, "[FDC] All retries failed for LBA=%u\n",
                 (unsigned)(lba + i));
-         fdc_motor_off(drive);
+         fdc_motor_end(drive);
          return -EIO;
       }
    }
 
-   fdc_motor_off(drive);
+   fdc_motor_end(drive);
    return 0;
 }
 
@@ -413,9 +685,7 @@ int FDC_WriteLba(DISK *disk, uint32_t lba, const uint8_t *buffer, size_t count)
 
    i686_IRQ_Unmask(FDC_IRQ);
 
-   fdc_motor_on(drive);
-
-   for (volatile int i = 0; i < 500000; i++);
+   fdc_motor_begin(drive);
 
    for (size_t i = 0; i < count; i++)
    {
@@ -440,7 +710,7 @@ int FDC_WriteLba(DISK *disk, uint32_t lba, const uint8_t *buffer, size_t count)
          memcpy(dma_buffer, buffer + i * FLOPPY_SECTOR_SIZE,
                 FLOPPY_SECTOR_SIZE);
 
-         fdc_dma_init(false);
+         fdc_dma_init(false, FLOPPY_SECTOR_SIZE);
 
          g_fdc_irq_received = false;
 
@@ -485,12 +755,20 @@ int FDC_WriteLba(DISK *disk, uint32_t lba, const uint8_t *buffer, size_t count)
       {
          logfmt(LOG_ERROR, "[FDC] All write retries failed for LBA=%u\n",
                 (unsigned)(lba + i));
-         fdc_motor_off(drive);
+         fdc_motor_end(drive);
          return -EIO;
       }
+
+      /* Keep a cached copy of this track coherent with the medium. */
+      FdcTrackCache *cached = fdc_track_cache_find(drive, head, track);
+      if (cached)
+      {
+         memcpy(cached->data + (uint32_t)(sector - 1) * FLOPPY_SECTOR_SIZE,
+                buffer + i * FLOPPY_SECTOR_SIZE, FLOPPY_SECTOR_SIZE);
+      }
    }
 
-   fdc_motor_off(drive);
+   fdc_motor_end(drive);
    return 0;
 }
 
@@ -1,30 +1,32 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "keyboard.h"
+#include "keymap.h"
 #include <drivers/tty/tty.h>
+#include <std/compiler.h>
 #include <std/stdio.h>
 #include <stdint.h>
 
 /* modifier state */
 static int shift = 0;
 static int caps = 0;
+static int alt = 0;
 static int extended = 0; /* set when 0xE0 prefix received */
 
-/* Minimal set-1 scancode -> ASCII map for printable keys.
-   Extend as needed (this is not full; handles letters, digits, space, enter,
-   backspace). */
-static const char scancode_map[128] = {
-    0, 27, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=',
-    '\b', /* 0x00 - 0x0F */
-    '\t', 'q', 'w', 'e', 'r', 't', 'y', 'u', 'i', 'o', 'p', '[', ']', '\n',
-    0, /* 0x10 - 0x1F */
-    'a', 's', 'd', 'f', 'g', 'h', 'j', 'k', 'l', ';', '\'', '`', 0, '\\', 'z',
-    'x', /*0x20-0x2F*/
-    'c', 'v', 'b', 'n', 'm', ',', '.', '/', 0, '*', 0,
-    ' ', /* 0x30 - 0x3B (space at 0x39) */
-    /* rest zeros */
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+/* Raw scancode queue between the IRQ handler and translation.
+ *
+ * Single producer (IRQ1 pushes via Keyboard_QueueScancode), single
+ * consumer (Keyboard_DrainQueue): the producer only writes kb_head,
+ * the consumer only writes kb_tail, so no locking is needed.  Draining
+ * translates a whole batch and wakes blocked readers once per batch,
+ * which keeps fast pastes from dropping characters. */
+#define KB_QUEUE_SIZE 256u /* power of two */
+#define KB_QUEUE_MASK (KB_QUEUE_SIZE - 1)
+
+static volatile uint8_t kb_queue[KB_QUEUE_SIZE];
+static volatile uint32_t kb_head = 0; /* producer writes */
+static volatile uint32_t kb_tail = 0; /* consumer writes */
+static uint32_t kb_dropped = 0;
 
 /**
  * Generic scancode handler (platform-independent)
@@ -47,6 +49,7 @@ void Keyboard_HandleScancode(uint8_t scancode)
       /* key release: clear shift if shift released */
       uint8_t key = scancode & 0x7F;
       if (key == 0x2A || key == 0x36) shift = 0; /* left/right shift */
+      if (key == 0x38) alt = 0; /* alt (0xE0-prefixed for right alt) */
       /* if this was an extended key release, clear extended state */
       if (extended)
       {
@@ -70,6 +73,14 @@ void Keyboard_HandleScancode(uint8_t scancode)
       return;
    }
 
+   /* alt press (left alt; right alt arrives 0xE0-prefixed) */
+   if (scancode == 0x38)
+   {
+      alt = 1;
+      extended = 0;
+      return;
+   }
+
    /* Emit ANSI CSI escapes for cursor keys (ESC [ A/B/C/D). */
    if (extended)
    {
@@ -90,6 +101,12 @@ void Keyboard_HandleScancode(uint8_t scancode)
          case 0x4B:
             TTY_InputArrow(dev, 'D');
             break;
+         case 0x49: /* PageUp: with shift, page into scrollback */
+            if (shift) TTY_Scrollback(dev, 1);
+            break;
+         case 0x51: /* PageDown: with shift, page toward live */
+            if (shift) TTY_Scrollback(dev, -1);
+            break;
          default:
             break;
          }
@@ -99,96 +116,22 @@ void Keyboard_HandleScancode(uint8_t scancode)
       return;
    }
 
-   /* map scancode to character, apply shift/caps */
-   if (scancode < sizeof(scancode_map))
+   /* Alt+F1..F8: switch virtual consoles (F-keys are plain make codes
+    * 0x3B..0x42, one per TTY slot). */
+   if (alt && scancode >= 0x3B && scancode <= 0x42)
    {
-      char base = scancode_map[scancode];
-      if (!base) return;
+      TTY_SwitchConsole((uint32_t)(scancode - 0x3B));
+      return;
+   }
 
-      char out = base;
-      /* simple alphabetic handling for caps/shift */
-      if (out >= 'a' && out <= 'z')
-      {
-         if ((caps && !shift) || (shift && !caps))
-         {
-            out = out - 'a' + 'A';
-         }
-      }
-      else
-      {
-         /* rudimentary shifted symbols for digits/punctuation */
-         if (shift)
-         {
-            switch (out)
-            {
-            case '1':
-               out = '!';
-               break;
-            case '2':
-               out = '@';
-               break;
-            case '3':
-               out = '#';
-               break;
-            case '4':
-               out = '$';
-               break;
-            case '5':
-               out = '%';
-               break;
-            case '6':
-               out = '^';
-               break;
-            case '7':
-               out = '&';
-               break;
-            case '8':
-               out = '*';
-               break;
-            case '9':
-               out = '(';
-               break;
-            case '0':
-               out = ')';
-               break;
-            case '-':
-               out = '_';
-               break;
-            case '=':
-               out = '+';
-               break;
-            case '\\':
-               out = '|';
-               break;
-            case ';':
-               out = ':';
-               break;
-            case '\'':
-               out = '"';
-               break;
-            case ',':
-               out = '<';
-               break;
-            case '.':
-               out = '>';
-               break;
-            case '/':
-               out = '?';
-               break;
-            case '`':
-               out = '~';
-               break;
-            case '[':
-               out = '{';
-               break;
-            case ']':
-               out = '}';
-               break;
-            default:
-               break;
-            }
-         }
-      }
+   /* Flat translation: the generated tables (scripts/mkkeymap.py) bake
+    * shift and caps handling in per modifier state, so mapping a make
+    * code is two loads and no branching on the character itself. */
+   if (scancode < KEYMAP_CODES)
+   {
+      int state = (shift ? KEYMAP_SHIFT : 0) | (caps ? KEYMAP_CAPS : 0);
+      char out = g_Keymap[state][scancode];
+      if (!out) return;
 
       /* Forward translated character to active TTY input stream. */
       TTY_Device *dev = TTY_GetDevice();
@@ -196,14 +139,50 @@ void Keyboard_HandleScancode(uint8_t scancode)
    }
 }
 
+/**
+ * Queue one raw scancode from the IRQ handler.
+ * Lock-free single-producer push; drops (and counts) when full.
+ */
+void Keyboard_QueueScancode(uint8_t scancode)
+{
+   if (kb_head - kb_tail >= KB_QUEUE_SIZE)
+   {
+      kb_dropped++;
+      return;
+   }
+   kb_queue[kb_head & KB_QUEUE_MASK] = scancode;
+   kb_head++;
+}
+
+/**
+ * Translate everything queued since the last drain and feed it to the
+ * active TTY as one batch (readers are woken once at the end).
+ */
+void Keyboard_DrainQueue(void)
+{
+   if (kb_tail == kb_head) return;
+
+   TTY_Device *dev = TTY_GetDevice();
+   if (dev) TTY_InputBatchBegin(dev);
+
+   while (kb_tail != kb_head)
+   {
+      Keyboard_HandleScancode(kb_queue[kb_tail & KB_QUEUE_MASK]);
+      kb_tail++;
+   }
+
+   if (dev) TTY_InputBatchEnd(dev);
+}
+
 /**
  * Initialize keyboard state.
  */
-void Keyboard_Initialize(void)
+KCOLD void Keyboard_Initialize(void)
 {
    /* Reset modifier state */
    shift = 0;
    caps = 0;
+   alt = 0;
    extended = 0;
 
    logfmt(LOG_INFO, "[KEYBOARD] Initialized\n");
@@ -16,4 +16,10 @@ void Keyboard_Initialize(void);
 /* Process a scancode (called by platform-specific drivers) */
 void Keyboard_HandleScancode(uint8_t scancode);
 
+/* Interrupt-side scancode batching: the IRQ handler queues raw bytes
+ * lock-free, then the drain translates the whole batch and wakes
+ * blocked readers once */
+void Keyboard_QueueScancode(uint8_t scancode);
+void Keyboard_DrainQueue(void);
+
 #endif
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef KEYMAP_H
+#define KEYMAP_H
+
+/* Flat scancode translation tables (keymap_gen.c, generated at build
+ * time by scripts/mkkeymap.py).  Indexed by modifier state then
+ * scancode; 0 means no printable character for that combination. */
+
+#define KEYMAP_SHIFT 0x1
+#define KEYMAP_CAPS 0x2
+#define KEYMAP_STATES 4
+#define KEYMAP_CODES 128
+
+extern const char g_Keymap[KEYMAP_STATES][KEYMAP_CODES];
+
+#endif
@@ -0,0 +1,439 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "rtl8139.h"
+#include <constants.h>
+#include <cpu/process.h>
+#include <fs/devfs/devfs.h>
+#include <hal/io.h>
+#include <hal/irq.h>
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <std/string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* =========================================================================
+ * RTL8139 PCI Fast Ethernet
+ *
+ * Receive uses the chip's single DMA ring: one physically contiguous
+ * 16 KiB run from PMM_AllocateContiguous (8 KiB ring + the overflow
+ * slack the WRAP mode writes past the end).  Transmit uses the four
+ * hardware descriptors, each backed by a page allocated once at init
+ * and recycled round-robin - no allocation happens on either data path.
+ *
+ * The IRQ handler acknowledges once and then drains every frame the
+ * ring holds into a fixed pool of packet slots, so a burst costs one
+ * interrupt instead of one per frame.  /dev/net0 hands out one frame
+ * per read and sends one frame per write.
+ *
+ * PCI configuration space is probed directly through ports 0xCF8/0xCFC,
+ * same as the bus-master IDE setup in drivers/ata - the kernel still
+ * has no separate PCI layer.
+ * ====================================================================== */
+
+#define PCI_CONFIG_ADDRESS 0xCF8
+#define PCI_CONFIG_DATA 0xCFC
+
+#define RTL_VENDOR_ID 0x10EC
+#define RTL_DEVICE_ID 0x8139
+
+/* Register offsets from the I/O base (BAR0) */
+#define RTL_REG_IDR0 0x00    /* Station MAC address, 6 bytes */
+#define RTL_REG_TSD0 0x10    /* Transmit status, 4 descriptors */
+#define RTL_REG_TSAD0 0x20   /* Transmit buffer address, 4 descriptors */
+#define RTL_REG_RBSTART 0x30 /* Receive ring physical base */
+#define RTL_REG_CMD 0x37
+#define RTL_REG_CAPR 0x38 /* Read pointer into the receive ring */
+#define RTL_REG_IMR 0x3C
+#define RTL_REG_ISR 0x3E
+#define RTL_REG_TCR 0x40
+#define RTL_REG_RCR 0x44
+#define RTL_REG_CONFIG1 0x52
+
+#define RTL_CMD_BUFE 0x01 /* Receive ring empty */
+#define RTL_CMD_TE 0x04
+#define RTL_CMD_RE 0x08
+#define RTL_CMD_RESET 0x10
+
+#define RTL_ISR_ROK 0x0001
+#define RTL_ISR_RER 0x0002
+#define RTL_ISR_TOK 0x0004
+#define RTL_ISR_TER 0x0008
+#define RTL_ISR_RXOVW 0x0010
+#define RTL_ISR_FOVW 0x0040
+
+/* RCR: accept broadcast + multicast + our MAC, WRAP mode, unlimited DMA
+ * burst, store-and-forward threshold. */
+#define RTL_RCR_ACCEPT 0x0E
+#define RTL_RCR_WRAP 0x80
+#define RTL_RCR_MXDMA_UNLIM (7u << 8)
+#define RTL_RCR_RXFTH_SF (7u << 13)
+
+#define RTL_TSD_OWN 0x2000  /* Set by hardware once the DMA finished */
+#define RTL_TSD_TOK 0x8000u /* Frame made it onto the wire */
+
+/* 8 KiB ring (RBLEN 00) plus WRAP slack: one frame can be written past
+ * the ring end, so the backing run must cover 8192 + 16 header bytes +
+ * a maximal frame.  Order 2 = 16 KiB covers it. */
+#define RTL_RX_RING_SIZE 8192u
+#define RTL_RX_ALLOC_ORDER 2u
+
+#define RTL_TX_DESCRIPTORS 4
+#define RTL_TX_PAD_MIN 60u /* Chip does not pad runts for us */
+
+/* Received frames wait here for readers: fixed slots recycled in ring
+ * order, dropped (and counted) when userspace falls too far behind. */
+#define RTL_RX_SLOTS 32u
+
+typedef struct
+{
+   uint16_t len;
+   uint8_t data[RTL8139_FRAME_MAX + 2]; /* +2 keeps the payload aligned */
+} RtlRxSlot;
+
+static uint16_t g_RtlIoBase = 0; /* 0 = no NIC found */
+static uint8_t g_RtlIrq = 0;
+static uint8_t g_RtlMac[6];
+
+static uint8_t *g_RtlRxRing = NULL; /* Identity-mapped contiguous run */
+static uint32_t g_RtlRxOffset = 0;  /* Driver cursor into the ring */
+
+static uint8_t *g_RtlTxBuf[RTL_TX_DESCRIPTORS]; /* One page each */
+static uint32_t g_RtlTxNext = 0;                /* Round-robin descriptor */
+
+static RtlRxSlot g_RtlRxQueue[RTL_RX_SLOTS];
+static uint32_t g_RtlRxHead = 0; /* IRQ handler writes */
+static uint32_t g_RtlRxTail = 0; /* Readers consume */
+static volatile uint32_t g_RtlRxCount = 0;
+
+static uint32_t g_RtlRxDropped = 0;
+static uint32_t g_RtlRxErrors = 0;
+
+static RTL8139_RxHandler g_RtlRxHandler = NULL;
+
+static uint32_t pci_cfg_read32(uint8_t bus, uint8_t dev, uint8_t fn,
+                               uint8_t offset)
+{
+   uint32_t address = 0x80000000u | ((uint32_t)bus << 16) |
+                      ((uint32_t)dev << 11) | ((uint32_t)fn << 8) |
+                      (offset & 0xFC);
+   g_HalIoOperations->outl(PCI_CONFIG_ADDRESS, address);
+   return g_HalIoOperations->inl(PCI_CONFIG_DATA);
+}
+
+static void pci_cfg_write32(uint8_t bus, uint8_t dev, uint8_t fn,
+                            uint8_t offset, uint32_t value)
+{
+   uint32_t address = 0x80000000u | ((uint32_t)bus << 16) |
+                      ((uint32_t)dev << 11) | ((uint32_t)fn << 8) |
+                      (offset & 0xFC);
+   g_HalIoOperations->outl(PCI_CONFIG_ADDRESS, address);
+   g_HalIoOperations->outl(PCI_CONFIG_DATA, value);
+}
+
+static inline uint8_t rtl_inb(uint16_t reg)
+{
+   return g_HalIoOperations->inb(g_RtlIoBase + reg);
+}
+
+static inline uint16_t rtl_inw(uint16_t reg)
+{
+   return g_HalIoOperations->inw(g_RtlIoBase + reg);
+}
+
+static inline void rtl_outb(uint16_t reg, uint8_t val)
+{
+   g_HalIoOperations->outb(g_RtlIoBase + reg, val);
+}
+
+static inline void rtl_outw(uint16_t reg, uint16_t val)
+{
+   g_HalIoOperations->outw(g_RtlIoBase + reg, val);
+}
+
+static inline void rtl_outl(uint16_t reg, uint32_t val)
+{
+   g_HalIoOperations->outl(g_RtlIoBase + reg, val);
+}
+
+/* Locate the NIC function; latch I/O base and IRQ line. */
+static bool rtl_pci_probe(void)
+{
+   for (uint8_t bus = 0; bus < 4; bus++)
+   {
+      for (uint8_t dev = 0; dev < 32; dev++)
+      {
+         for (uint8_t fn = 0; fn < 8; fn++)
+         {
+            uint32_t id = pci_cfg_read32(bus, dev, fn, 0x00);
+            if ((id & 0xFFFF) == 0xFFFF) continue; /* No function */
+            if ((id & 0xFFFF) != RTL_VENDOR_ID) continue;
+            if ((id >> 16) != RTL_DEVICE_ID) continue;
+
+            uint32_t bar0 = pci_cfg_read32(bus, dev, fn, 0x10);
+            if (!(bar0 & 0x1)) continue; /* Must be I/O space */
+
+            /* Enable I/O decode and bus mastering. */
+            uint32_t cmd = pci_cfg_read32(bus, dev, fn, 0x04);
+            pci_cfg_write32(bus, dev, fn, 0x04, cmd | 0x5);
+
+            g_RtlIoBase = (uint16_t)(bar0 & 0xFFFC);
+            g_RtlIrq = (uint8_t)(pci_cfg_read32(bus, dev, fn, 0x3C) & 0xFF);
+            logfmt(LOG_INFO,
+                   "[NET] RTL8139 at PCI %u:%u.%u, base=0x%04x irq=%u\n", bus,
+                   dev, fn, g_RtlIoBase, g_RtlIrq);
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+/* Pull every complete frame out of the DMA ring into the slot queue.
+ * Called once per interrupt with the ISR already acknowledged, so a
+ * back-to-back burst is drained under a single interrupt. */
+static void rtl_rx_drain(void)
+{
+   bool woke = false;
+
+   while (!(rtl_inb(RTL_REG_CMD) & RTL_CMD_BUFE))
+   {
+      uint8_t *pkt = g_RtlRxRing + g_RtlRxOffset;
+      uint16_t status = (uint16_t)(pkt[0] | (pkt[1] << 8));
+      uint16_t length = (uint16_t)(pkt[2] | (pkt[3] << 8));
+
+      if (!(status & 0x1) || length < 8 || length > RTL8139_FRAME_MAX + 4)
+      {
+         /* Bad header: the cursor is out of step with the chip.  Reset
+          * the receiver rather than walk garbage. */
+         g_RtlRxErrors++;
+         rtl_outb(RTL_REG_CMD, RTL_CMD_TE);
+         rtl_outb(RTL_REG_CMD, RTL_CMD_TE | RTL_CMD_RE);
+         g_RtlRxOffset = 0;
+         rtl_outw(RTL_REG_CAPR, (uint16_t)-16);
+         break;
+      }
+
+      if (g_RtlRxHandler &&
+          g_RtlRxHandler(pkt + 4, (uint32_t)(length - 4)))
+      {
+         /* Consumed by the in-kernel stack; skip the raw queue */
+      }
+      else if (g_RtlRxCount < RTL_RX_SLOTS)
+      {
+         RtlRxSlot *slot = &g_RtlRxQueue[g_RtlRxHead];
+         slot->len = (uint16_t)(length - 4); /* Drop the trailing CRC */
+         memcpy(slot->data, pkt + 4, slot->len);
+         g_RtlRxHead = (g_RtlRxHead + 1) % RTL_RX_SLOTS;
+         g_RtlRxCount++;
+         woke = true;
+      }
+      else
+      {
+         g_RtlRxDropped++;
+      }
+
+      /* Advance past header + frame, dword-aligned; WRAP mode means
+       * the chip never splits a frame across the ring end. */
+      g_RtlRxOffset = (g_RtlRxOffset + length + 4 + 3) & ~3u;
+      if (g_RtlRxOffset >= RTL_RX_RING_SIZE) g_RtlRxOffset -= RTL_RX_RING_SIZE;
+      rtl_outw(RTL_REG_CAPR, (uint16_t)(g_RtlRxOffset - 16));
+   }
+
+   if (woke) Process_WakeByChannel((void *)&g_RtlRxQueue);
+}
+
+static void rtl_irq_handler(Registers *regs)
+{
+   (void)regs;
+
+   uint16_t isr = rtl_inw(RTL_REG_ISR);
+   if (!isr) return;
+   rtl_outw(RTL_REG_ISR, isr); /* Write-1-to-clear, one ack per burst */
+
+   if (isr & (RTL_ISR_ROK | RTL_ISR_RXOVW | RTL_ISR_FOVW)) rtl_rx_drain();
+   if (isr & RTL_ISR_RER) g_RtlRxErrors++;
+   /* TOK needs no work: descriptors are reclaimed lazily by the next
+    * transmit through the OWN bit. */
+}
+
+/* devfs ops ------------------------------------------------------------- */
+
+/* One frame per read.  Blocks until a frame arrives, same idle idiom as
+ * TTY_Read; a frame longer than the caller's buffer is truncated. */
+static uint32_t net_read(DEVFS_DeviceNode *node, uint32_t offset,
+                         uint32_t size, void *buffer)
+{
+   (void)node;
+   (void)offset;
+   if (!buffer || size == 0) return 0;
+
+   while (g_RtlRxCount == 0)
+   {
+      uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+      if (!interrupts_were_enabled)
+      {
+         g_HalIoOperations->DisableInterrupts();
+      }
+   }
+
+   RtlRxSlot *slot = &g_RtlRxQueue[g_RtlRxTail];
+   uint32_t len = slot->len;
+   if (len > size) len = size;
+   memcpy(buffer, slot->data, len);
+
+   g_RtlRxTail = (g_RtlRxTail + 1) % RTL_RX_SLOTS;
+   g_RtlRxCount--;
+   return len;
+}
+
+/* Next free descriptor buffer for an in-place frame build.  Spins
+ * briefly when all four descriptors are still owned by the DMA engine
+ * - at 100 Mbit that is bounded by the time four maximal frames take
+ * on the wire. */
+uint8_t *RTL8139_TxAcquire(void)
+{
+   if (!g_RtlIoBase) return NULL;
+
+   uint32_t tsd = (uint16_t)(RTL_REG_TSD0 + g_RtlTxNext * 4);
+   while (!(g_HalIoOperations->inl(g_RtlIoBase + tsd) & RTL_TSD_OWN))
+   {
+      /* Descriptor still transmitting */
+   }
+   return g_RtlTxBuf[g_RtlTxNext];
+}
+
+void RTL8139_TxSubmit(uint32_t len)
+{
+   if (!g_RtlIoBase || len == 0 || len > RTL8139_FRAME_MAX) return;
+
+   uint32_t desc = g_RtlTxNext;
+   g_RtlTxNext = (g_RtlTxNext + 1) % RTL_TX_DESCRIPTORS;
+
+   if (len < RTL_TX_PAD_MIN)
+   {
+      memset(g_RtlTxBuf[desc] + len, 0, RTL_TX_PAD_MIN - len);
+      len = RTL_TX_PAD_MIN;
+   }
+
+   /* Writing the size clears OWN and starts the DMA. */
+   rtl_outl((uint16_t)(RTL_REG_TSD0 + desc * 4), len);
+}
+
+int RTL8139_GetMac(uint8_t mac[6])
+{
+   if (!g_RtlIoBase) return -ENODEV;
+   memcpy(mac, g_RtlMac, 6);
+   return SUCCESS;
+}
+
+void RTL8139_SetRxHandler(RTL8139_RxHandler handler)
+{
+   g_RtlRxHandler = handler;
+}
+
+/* One frame per write. */
+static uint32_t net_write(DEVFS_DeviceNode *node, uint32_t offset,
+                          uint32_t size, const void *buffer)
+{
+   (void)node;
+   (void)offset;
+   if (!buffer || size == 0 || size > RTL8139_FRAME_MAX) return 0;
+
+   uint8_t *frame = RTL8139_TxAcquire();
+   if (!frame) return 0;
+   memcpy(frame, buffer, size);
+   RTL8139_TxSubmit(size);
+   return size;
+}
+
+static int net_ioctl(DEVFS_DeviceNode *node, uint32_t cmd, void *arg)
+{
+   (void)node;
+   switch (cmd)
+   {
+      case RTL8139_IOCTL_GETMAC:
+         if (!arg) return -EINVAL;
+         memcpy(arg, g_RtlMac, sizeof(g_RtlMac));
+         return SUCCESS;
+      default:
+         return -EINVAL;
+   }
+}
+
+static uint32_t net_poll(DEVFS_DeviceNode *node)
+{
+   (void)node;
+   uint32_t mask = DEVFS_POLLOUT;
+   if (g_RtlRxCount > 0) mask |= DEVFS_POLLIN;
+   return mask;
+}
+
+static const DEVFS_DeviceOps net_ops = {.read = net_read,
+                                        .write = net_write,
+                                        .ioctl = net_ioctl,
+                                        .close = NULL,
+                                        .poll = net_poll};
+
+void RTL8139_Initialize(void)
+{
+   if (!rtl_pci_probe()) return; /* No NIC on this box */
+
+   /* DMA memory first: a contiguous run for the receive ring, one page
+    * per transmit descriptor.  All identity-mapped physical pages. */
+   uint32_t ring = PMM_AllocateContiguous(RTL_RX_ALLOC_ORDER);
+   if (!ring)
+   {
+      logfmt(LOG_ERROR, "[NET] RTL8139: no memory for receive ring\n");
+      g_RtlIoBase = 0;
+      return;
+   }
+   g_RtlRxRing = (uint8_t *)ring;
+
+   for (int i = 0; i < RTL_TX_DESCRIPTORS; i++)
+   {
+      uint32_t page = PMM_AllocatePhysicalPage();
+      if (!page)
+      {
+         logfmt(LOG_ERROR, "[NET] RTL8139: no memory for transmit buffers\n");
+         PMM_FreeContiguous(ring, RTL_RX_ALLOC_ORDER);
+         g_RtlIoBase = 0;
+         return;
+      }
+      g_RtlTxBuf[i] = (uint8_t *)page;
+   }
+
+   /* Power up and reset the chip. */
+   rtl_outb(RTL_REG_CONFIG1, 0x00);
+   rtl_outb(RTL_REG_CMD, RTL_CMD_RESET);
+   while (rtl_inb(RTL_REG_CMD) & RTL_CMD_RESET)
+   {
+      /* Reset self-clears within microseconds */
+   }
+
+   for (int i = 0; i < 6; i++)
+      g_RtlMac[i] = rtl_inb((uint16_t)(RTL_REG_IDR0 + i));
+
+   rtl_outl(RTL_REG_RBSTART, ring);
+   for (int i = 0; i < RTL_TX_DESCRIPTORS; i++)
+      rtl_outl((uint16_t)(RTL_REG_TSAD0 + i * 4), (uint32_t)g_RtlTxBuf[i]);
+
+   rtl_outl(RTL_REG_RCR, RTL_RCR_ACCEPT | RTL_RCR_WRAP | RTL_RCR_MXDMA_UNLIM |
+                             RTL_RCR_RXFTH_SF);
+   rtl_outb(RTL_REG_CMD, RTL_CMD_TE | RTL_CMD_RE);
+   rtl_outw(RTL_REG_IMR, RTL_ISR_ROK | RTL_ISR_RER | RTL_ISR_TOK |
+                             RTL_ISR_TER | RTL_ISR_RXOVW | RTL_ISR_FOVW);
+
+   i686_IRQ_RegisterHandler(g_RtlIrq, rtl_irq_handler);
+   i686_IRQ_Unmask(g_RtlIrq);
+
+   DEVFS_RegisterDevice("net0", DEVFS_TYPE_CHAR, 6, 0, 0, &net_ops, NULL);
+
+   logfmt(LOG_INFO,
+          "[NET] RTL8139 up, mac=%02x:%02x:%02x:%02x:%02x:%02x ring=16K "
+          "tx_descriptors=%u\n",
+          g_RtlMac[0], g_RtlMac[1], g_RtlMac[2], g_RtlMac[3], g_RtlMac[4],
+          g_RtlMac[5], RTL_TX_DESCRIPTORS);
+}
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef RTL8139_H
+#define RTL8139_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ioctl commands on /dev/net0 */
+#define RTL8139_IOCTL_GETMAC 1 /* arg: uint8_t[6], station address */
+
+/* Largest frame accepted for transmit or handed out per read (standard
+ * Ethernet MTU plus header, no VLAN). */
+#define RTL8139_FRAME_MAX 1514
+
+/* Probe PCI for an RTL8139, bring the ring buffers up and register
+ * /dev/net0.  Quietly a no-op when no NIC is present. */
+void RTL8139_Initialize(void);
+
+/* Station MAC address; -ENODEV when no NIC was found. */
+int RTL8139_GetMac(uint8_t mac[6]);
+
+/* In-kernel receive tap, called from the IRQ drain for every frame
+ * before it is queued for /dev/net0 readers.  Return true to consume
+ * the frame (it then never reaches the raw device).  The network stack
+ * installs itself here. */
+typedef bool (*RTL8139_RxHandler)(const uint8_t *frame, uint32_t len);
+void RTL8139_SetRxHandler(RTL8139_RxHandler handler);
+
+/* In-kernel transmit path: acquire hands out the next free descriptor
+ * buffer (RTL8139_FRAME_MAX bytes; waits for the DMA engine when all
+ * four are busy, NULL without a NIC), submit pads and starts the DMA.
+ * Building a frame directly in the descriptor buffer avoids a bounce
+ * copy. */
+uint8_t *RTL8139_TxAcquire(void);
+void RTL8139_TxSubmit(uint32_t len);
+
+#endif
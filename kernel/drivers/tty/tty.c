@@ -7,6 +7,7 @@
 #include <hal/scheduler.h>
 #include <hal/video.h>
 #include <mem/mm_kernel.h>
+#include <std/compiler.h>
 
 /* TTY device array and active terminal */
 static TTY_Device *g_TTYDevices[TTY_MAX_DEVICES];
@@ -16,38 +17,98 @@ static bool g_TTYInitialized = false;
 /* Static BSS input storage for each TTY. */
 static char g_TTYInputBufs[TTY_MAX_DEVICES][TTY_INPUT_SIZE];
 
-static void buffer_init(TTY_Buffer *buf, char *data, uint32_t size)
-{
-   buf->data = data;
-   buf->size = size;
-   buf->head = 0;
-   buf->tail = 0;
-   buf->count = 0;
-}
+/*
+ * Shadow renderer — output for background virtual consoles.
+ *
+ * While a VT is in the background its writes never touch the display
+ * backend; this minimal terminal keeps its shadow image current so the
+ * screen is intact when the VT is switched back in.  It handles the
+ * control characters the line discipline emits (\n, \r, \b, \t) plus
+ * wrapping and scrolling; CSI sequences are consumed rather than
+ * interpreted, except clear ('J') and home ('H'), so escape-heavy
+ * output repaints approximately.  The foreground VT never comes
+ * through here — its exact cells are snapshotted from the backend at
+ * switch-out (TTY_SetActive).
+ */
 
-static int buffer_push(TTY_Buffer *buf, char c)
+static void tty_shadow_clear(TTY_Device *tty)
 {
-   if (buf->count >= buf->size) return -1;
-   buf->data[buf->tail] = c;
-   buf->tail = (buf->tail + 1) % buf->size;
-   buf->count++;
-   return 0;
+   /* Zero cells present as blanks in the backend's shadow encoding. */
+   memset(tty->shadow, 0, sizeof(tty->shadow));
+   tty->shadow_x = 0;
+   tty->shadow_y = 0;
 }
 
-static int buffer_pop(TTY_Buffer *buf)
+static void tty_shadow_scroll(TTY_Device *tty)
 {
-   if (buf->count == 0) return -1;
-   char c = buf->data[buf->head];
-   buf->head = (buf->head + 1) % buf->size;
-   buf->count--;
-   return (int)(unsigned char)c;
+   memmove(tty->shadow[0], tty->shadow[1],
+           (size_t)(SCREEN_HEIGHT - 1) * SCREEN_WIDTH * sizeof(uint16_t));
+   memset(tty->shadow[SCREEN_HEIGHT - 1], 0,
+          (size_t)SCREEN_WIDTH * sizeof(uint16_t));
 }
 
-static void buffer_clear(TTY_Buffer *buf)
+static void tty_shadow_putc(TTY_Device *tty, char c)
 {
-   buf->head = 0;
-   buf->tail = 0;
-   buf->count = 0;
+   if (tty->shadow_esc == 1)
+   {
+      tty->shadow_esc = (c == '[') ? 2 : 0;
+      return;
+   }
+   if (tty->shadow_esc == 2)
+   {
+      if (c >= '@' && c <= '~')
+      {
+         tty->shadow_esc = 0;
+         if (c == 'J') tty_shadow_clear(tty);
+         else if (c == 'H')
+         {
+            tty->shadow_x = 0;
+            tty->shadow_y = 0;
+         }
+      }
+      return;
+   }
+
+   switch (c)
+   {
+   case '\x1B':
+      tty->shadow_esc = 1;
+      return;
+   case '\n':
+      tty->shadow_x = 0;
+      tty->shadow_y++;
+      break;
+   case '\r':
+      tty->shadow_x = 0;
+      return;
+   case '\b':
+      if (tty->shadow_x > 0) tty->shadow_x--;
+      return;
+   case '\t':
+      tty->shadow_x = (tty->shadow_x + 8) & ~7;
+      if (tty->shadow_x >= SCREEN_WIDTH)
+      {
+         tty->shadow_x = 0;
+         tty->shadow_y++;
+      }
+      break;
+   default:
+      if ((unsigned char)c < 0x20) return;
+      tty->shadow[tty->shadow_y][tty->shadow_x] =
+          ((uint16_t)tty->color << 8) | (uint8_t)c;
+      if (++tty->shadow_x >= SCREEN_WIDTH)
+      {
+         tty->shadow_x = 0;
+         tty->shadow_y++;
+      }
+      break;
+   }
+
+   if (tty->shadow_y >= SCREEN_HEIGHT)
+   {
+      tty_shadow_scroll(tty);
+      tty->shadow_y = SCREEN_HEIGHT - 1;
+   }
 }
 
 static void tty_sync_cursor_from_backend(TTY_Device *tty)
@@ -57,28 +118,78 @@ static void tty_sync_cursor_from_backend(TTY_Device *tty)
    vdev->GetCursor(&tty->cursor_x, &tty->cursor_y);
 }
 
+static void tty_echo_flush(TTY_Device *tty)
+{
+   if (!tty || tty->echo_len == 0) return;
+
+   const HAL_VideoOperations *vdev = g_HalVideoOperations;
+   if (tty == g_ActiveTTY && vdev && vdev->WriteStream)
+   {
+      vdev->WriteStream(tty->echo_buf, tty->echo_len, tty->color);
+   }
+   else
+   {
+      /* The VT went background mid-batch: land the staged echo in its
+         shadow screen instead of dropping it. */
+      for (uint32_t i = 0; i < tty->echo_len; i++)
+      {
+         tty_shadow_putc(tty, tty->echo_buf[i]);
+      }
+   }
+   tty->echo_len = 0;
+   tty_sync_cursor_from_backend(tty);
+}
+
 static void tty_emit_to_display(TTY_Device *tty, char c)
 {
+   if (!tty) return;
+
+   if (tty != g_ActiveTTY)
+   {
+      /* Background VT: record into its shadow screen only. */
+      tty_shadow_putc(tty, c);
+      return;
+   }
+
    const HAL_VideoOperations *vdev = g_HalVideoOperations;
-   if (!tty || tty != g_ActiveTTY || !vdev || !vdev->PutChar) return;
+   if (!vdev || !vdev->PutChar) return;
+
+   /* While a keyboard batch is being drained, echo is staged and sent
+    * as one stream write at batch end — one repaint and one hardware
+    * cursor update for the whole burst instead of one per character. */
+   if (tty->input_batch && vdev->WriteStream)
+   {
+      if (tty->echo_len == sizeof(tty->echo_buf)) tty_echo_flush(tty);
+      tty->echo_buf[tty->echo_len++] = c;
+      return;
+   }
 
    /* x/y < 0 selects backend stream mode (ANSI + wrapping handled by VGA). */
    vdev->PutChar(c, tty->color, -1, -1);
    tty_sync_cursor_from_backend(tty);
 }
 
-static void line_flush(TTY_Device *tty)
+/* Wake blocked readers, or record the wake for TTY_InputBatchEnd while
+ * a keyboard batch is being drained. */
+static void tty_input_wake(TTY_Device *tty)
 {
-   for (uint32_t i = 0; i < tty->line_len; i++)
+   if (tty->input_batch)
    {
-      buffer_push(&tty->input, tty->line_buf[i]);
+      tty->wake_pending = true;
+      return;
    }
-   buffer_push(&tty->input, '\n');
+   Process_WakeByChannel(tty);
+}
+
+static void line_flush(TTY_Device *tty)
+{
+   CHARDEV_RingPush(&tty->input, tty->line_buf, tty->line_len);
+   CHARDEV_RingPutc(&tty->input, '\n');
    tty->line_len = 0;
    tty->line_pos = 0;
    tty->line_ready = true;
 
-   Process_WakeByChannel(tty);
+   tty_input_wake(tty);
 }
 
 static int tty_has_pending_read(TTY_Device *tty)
@@ -121,9 +232,29 @@ static void line_erase_char(TTY_Device *tty)
 
 static void line_kill(TTY_Device *tty)
 {
-   while (tty->line_len > 0)
+   uint32_t n = tty->line_len;
+
+   tty->line_len = 0;
+   tty->line_pos = 0;
+
+   if (n == 0 || TTY_IsEcho(tty) != 0) return;
+
+   /* Erase the whole line with staged chunks: one display write per 32
+    * characters instead of three per character. */
+   char chunk[96]; /* multiple of the 3-byte erase sequence */
+   while (n > 0)
    {
-      line_erase_char(tty);
+      uint32_t count = n;
+      if (count > sizeof(chunk) / 3) count = (uint32_t)(sizeof(chunk) / 3);
+
+      for (uint32_t i = 0; i < count; i++)
+      {
+         chunk[i * 3 + 0] = '\b';
+         chunk[i * 3 + 1] = ' ';
+         chunk[i * 3 + 2] = '\b';
+      }
+      TTY_WriteBuffer(tty, chunk, count * 3);
+      n -= count;
    }
 }
 
@@ -143,11 +274,11 @@ static void tty_input_noecho(TTY_Device *tty, char c)
 {
    if (!tty) return;
 
-   buffer_push(&tty->input, c);
-   Process_WakeByChannel(tty);
+   CHARDEV_RingPutc(&tty->input, c);
+   tty_input_wake(tty);
 }
 
-void TTY_Initialize(void)
+KCOLD void TTY_Initialize(void)
 {
    if (g_TTYInitialized) return;
 
@@ -174,7 +305,7 @@ TTY_Device *TTY_Create(uint32_t id)
    TTY_Device *tty = (TTY_Device *)kzalloc(sizeof(TTY_Device));
    if (!tty) return NULL;
 
-   buffer_init(&tty->input, g_TTYInputBufs[id], TTY_INPUT_SIZE);
+   CHARDEV_RingInit(&tty->input, g_TTYInputBufs[id], TTY_INPUT_SIZE);
 
    tty->id = id;
    tty->active = true;
@@ -182,8 +313,14 @@ TTY_Device *TTY_Create(uint32_t id)
    tty->line_pos = 0;
    tty->line_ready = false;
    tty->eof_pending = false;
+   tty->input_batch = false;
+   tty->wake_pending = false;
+   tty->echo_len = 0;
    tty->cursor_x = 0;
    tty->cursor_y = 0;
+   tty->shadow_x = 0;
+   tty->shadow_y = 0;
+   tty->shadow_esc = 0;
    tty->color = 0x07;
    tty->default_color = 0x07;
    tty->flags = TTY_DEFAULT_FLAGS;
@@ -216,17 +353,47 @@ TTY_Device *TTY_GetDeviceById(uint32_t id)
 
 void TTY_SetActive(TTY_Device *tty)
 {
-   if (!tty) return;
-   g_ActiveTTY = tty;
+   if (!tty || tty == g_ActiveTTY) return;
 
    const HAL_VideoOperations *vdev = g_HalVideoOperations;
+   TTY_Device *prev = g_ActiveTTY;
+
+   /* Snapshot the outgoing VT exactly as the backend rendered it, so
+    * switching back restores output the shadow renderer would only
+    * approximate.  The shadow cursor picks up where the backend's
+    * cursor was (clamped to the shadow dimensions). */
+   if (prev && vdev && vdev->SaveText)
+   {
+      vdev->SaveText(&prev->shadow[0][0], SCREEN_WIDTH, SCREEN_HEIGHT);
+      prev->shadow_x =
+          (prev->cursor_x < SCREEN_WIDTH) ? prev->cursor_x : SCREEN_WIDTH - 1;
+      prev->shadow_y = (prev->cursor_y < SCREEN_HEIGHT) ? prev->cursor_y
+                                                        : SCREEN_HEIGHT - 1;
+      prev->shadow_esc = 0;
+   }
+
+   g_ActiveTTY = tty;
+
+   if (vdev && vdev->RestoreText)
+   {
+      vdev->RestoreText(&tty->shadow[0][0], SCREEN_WIDTH, SCREEN_HEIGHT);
+   }
    if (vdev && vdev->SetCursor)
    {
-      vdev->SetCursor(tty->cursor_x, tty->cursor_y);
+      vdev->SetCursor(tty->shadow_x, tty->shadow_y);
       tty_sync_cursor_from_backend(tty);
    }
 }
 
+void TTY_SwitchConsole(uint32_t id)
+{
+   if (id >= TTY_MAX_DEVICES) return;
+
+   TTY_Device *tty = g_TTYDevices[id];
+   if (!tty) tty = TTY_Create(id);
+   if (tty) TTY_SetActive(tty);
+}
+
 void TTY_InputChar(TTY_Device *tty, char c)
 {
    if (!tty) return;
@@ -243,9 +410,7 @@ void TTY_InputChar(TTY_Device *tty, char c)
          /* TODO: Send SIGINT to foreground process. */
          if (TTY_IsEcho(tty) == 0)
          {
-            TTY_WriteChar(tty, '^');
-            TTY_WriteChar(tty, 'C');
-            TTY_WriteChar(tty, '\n');
+            TTY_Write(tty, "^C\n", 3);
          }
          tty->line_len = 0;
          tty->line_pos = 0;
@@ -258,7 +423,7 @@ void TTY_InputChar(TTY_Device *tty, char c)
          {
             tty->eof_pending = true;
             tty->line_ready = true;
-            Process_WakeByChannel(tty);
+            tty_input_wake(tty);
          }
          else
          {
@@ -272,9 +437,7 @@ void TTY_InputChar(TTY_Device *tty, char c)
          /* TODO: Send SIGTSTP to foreground process. */
          if (TTY_IsEcho(tty) == 0)
          {
-            TTY_WriteChar(tty, '^');
-            TTY_WriteChar(tty, 'Z');
-            TTY_WriteChar(tty, '\n');
+            TTY_Write(tty, "^Z\n", 3);
          }
          return;
       }
@@ -308,14 +471,33 @@ void TTY_InputChar(TTY_Device *tty, char c)
       return;
    }
 
-   buffer_push(&tty->input, c);
-   Process_WakeByChannel(tty);
+   CHARDEV_RingPutc(&tty->input, c);
+   tty_input_wake(tty);
    if (TTY_IsEcho(tty) == 0)
    {
       TTY_WriteChar(tty, c);
    }
 }
 
+void TTY_InputBatchBegin(TTY_Device *tty)
+{
+   if (!tty) return;
+   tty->input_batch = true;
+   tty->wake_pending = false;
+}
+
+void TTY_InputBatchEnd(TTY_Device *tty)
+{
+   if (!tty) return;
+   tty->input_batch = false;
+   tty_echo_flush(tty);
+   if (tty->wake_pending)
+   {
+      tty->wake_pending = false;
+      Process_WakeByChannel(tty);
+   }
+}
+
 void TTY_InputEscape(TTY_Device *tty, const char *seq)
 {
    if (!tty || !seq) return;
@@ -355,14 +537,50 @@ void TTY_WriteChar(TTY_Device *tty, char c)
    tty->bytes_written++;
 }
 
-void TTY_Write(TTY_Device *tty, const char *data, size_t len)
+/* Batched output: apply output processing into a staging chunk and hand
+ * whole chunks to the backend's stream writer, which repaints and moves
+ * the hardware cursor once per chunk instead of once per character. */
+void TTY_WriteBuffer(TTY_Device *tty, const char *data, size_t len)
 {
    if (!tty || !data) return;
 
+   const HAL_VideoOperations *vdev = g_HalVideoOperations;
+   if (tty != g_ActiveTTY || !vdev || !vdev->WriteStream)
+   {
+      /* Background VTs render per character into their shadow screens;
+         backends without a stream writer keep the per-character path. */
+      for (size_t i = 0; i < len; i++)
+      {
+         TTY_WriteChar(tty, data[i]);
+      }
+      return;
+   }
+
+   bool onlcr =
+       (tty->flags & TTY_FLAG_OPOST) && (tty->flags & TTY_FLAG_ONLCR);
+
+   char chunk[256];
+   uint32_t used = 0;
    for (size_t i = 0; i < len; i++)
    {
-      TTY_WriteChar(tty, data[i]);
+      uint32_t needed = (onlcr && data[i] == '\n') ? 2u : 1u;
+      if (used + needed > sizeof(chunk))
+      {
+         vdev->WriteStream(chunk, used, tty->color);
+         used = 0;
+      }
+      if (needed == 2) chunk[used++] = '\r';
+      chunk[used++] = data[i];
    }
+   if (used > 0) vdev->WriteStream(chunk, used, tty->color);
+
+   tty->bytes_written += len;
+   tty_sync_cursor_from_backend(tty);
+}
+
+void TTY_Write(TTY_Device *tty, const char *data, size_t len)
+{
+   TTY_WriteBuffer(tty, data, len);
 }
 
 int TTY_Read(TTY_Device *tty, char *buf, size_t count)
@@ -377,6 +595,19 @@ int TTY_Read(TTY_Device *tty, char *buf, size_t count)
          return 0;
       }
 
+      /* Sleep on the tty's wake channel so an idle console reader
+       * costs nothing between keystrokes; line_flush issues the wake.
+       * Pre-scheduler callers have no current process and fall back to
+       * the hlt-poll below, same as the ATA wait does. */
+      Process *cur = Process_GetCurrent();
+      if (cur)
+      {
+         Process_BlockOn(cur, tty);
+         /* Re-check before the switch happens; input may have landed
+          * (and the wake fired) just before the block. */
+         if (tty_has_pending_read(tty) == 0) Process_Unblock(cur);
+      }
+
       uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
       g_HalIoOperations->iowait();
       if (!interrupts_were_enabled)
@@ -395,7 +626,7 @@ int TTY_Read(TTY_Device *tty, char *buf, size_t count)
    size_t bytes_read = 0;
    while (bytes_read < count)
    {
-      int c = buffer_pop(&tty->input);
+      int c = CHARDEV_RingGetc(&tty->input);
       if (c < 0) break;
 
       buf[bytes_read++] = (char)c;
@@ -428,6 +659,10 @@ void TTY_ClearDevice(TTY_Device *tty)
       if (vdev && vdev->SetCursor) vdev->SetCursor(0, 0);
       tty_sync_cursor_from_backend(tty);
    }
+   else
+   {
+      tty_shadow_clear(tty);
+   }
 }
 
 void TTY_Clear(void)
@@ -456,6 +691,20 @@ void TTY_SetCursor(TTY_Device *tty, int x, int y)
       if (vdev && vdev->SetCursor) vdev->SetCursor(x, y);
       tty_sync_cursor_from_backend(tty);
    }
+   else
+   {
+      tty->shadow_x = (x < SCREEN_WIDTH) ? x : SCREEN_WIDTH - 1;
+      tty->shadow_y = (y < SCREEN_HEIGHT) ? y : SCREEN_HEIGHT - 1;
+   }
+}
+
+void TTY_Scrollback(TTY_Device *tty, int dir)
+{
+   /* History only exists on the presented console. */
+   if (!tty || tty != g_ActiveTTY) return;
+
+   const HAL_VideoOperations *vdev = g_HalVideoOperations;
+   if (vdev && vdev->Scrollback) vdev->Scrollback(dir);
 }
 
 void TTY_GetCursor(TTY_Device *tty, int *x, int *y)
@@ -514,6 +763,20 @@ uint32_t TTY_DevfsWrite(DEVFS_DeviceNode *node, uint32_t offset, uint32_t size,
    return size;
 }
 
+uint32_t TTY_DevfsPoll(DEVFS_DeviceNode *node)
+{
+   TTY_Device *tty = node ? (TTY_Device *)node->private_data : g_ActiveTTY;
+   if (!tty) tty = g_ActiveTTY;
+   if (!tty) return 0;
+
+   /* Output never blocks; input is ready when TTY_Read would return
+    * without waiting (a complete line in canonical mode, any byte in
+    * raw mode, or a pending EOF). */
+   uint32_t mask = DEVFS_POLLOUT;
+   if (tty_has_pending_read(tty) == 0) mask |= DEVFS_POLLIN;
+   return mask;
+}
+
 int TTY_DevfsIoctl(DEVFS_DeviceNode *node, uint32_t cmd, void *arg)
 {
    TTY_Device *tty = node ? (TTY_Device *)node->private_data : g_ActiveTTY;
@@ -530,7 +793,7 @@ int TTY_DevfsIoctl(DEVFS_DeviceNode *node, uint32_t cmd, void *arg)
       return 0;
 
    case TTY_IOCTL_FLUSH:
-      buffer_clear(&tty->input);
+      CHARDEV_RingClear(&tty->input);
       tty->line_len = 0;
       tty->line_pos = 0;
       tty->line_ready = false;
@@ -3,6 +3,7 @@
 #ifndef TTY_H
 #define TTY_H
 
+#include <fs/devfs/chardev.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -19,6 +20,8 @@ struct DEVFS_DeviceNode;
  * - Line editing
  * - Special character handling (CTRL+C, CTRL+D, etc.)
  * - Per-TTY input/output buffers
+ * - Virtual consoles (Alt+F1..F8): only the foreground VT renders,
+ *   background VTs write to their shadow screens only
  */
 
 /* Screen dimensions – default / minimum mode */
@@ -60,16 +63,6 @@ struct DEVFS_DeviceNode;
 #define TTY_IOCTL_FLUSH 0x0003
 #define TTY_IOCTL_GETSIZE 0x0004
 
-/* Circular buffer structure */
-typedef struct
-{
-   char *data;
-   uint32_t size;
-   volatile uint32_t head;  /* Read position */
-   volatile uint32_t tail;  /* Write position */
-   volatile uint32_t count; /* Number of bytes in buffer */
-} TTY_Buffer;
-
 /* TTY device structure */
 typedef struct TTY_Device
 {
@@ -78,12 +71,16 @@ typedef struct TTY_Device
    bool active; /* Is this TTY slot in use */
 
    /* Input handling */
-   TTY_Buffer input;             /* Cooked input (after line discipline) */
+   CHARDEV_Ring input;           /* Cooked input (after line discipline) */
    char line_buf[TTY_LINE_SIZE]; /* Line editing buffer */
    uint32_t line_pos;            /* Current position in line buffer */
    uint32_t line_len;            /* Length of current line */
    bool line_ready;              /* A complete line is ready */
    bool eof_pending;             /* EOF was received */
+   bool input_batch;             /* Reader wakes deferred to batch end */
+   bool wake_pending;            /* A deferred wake is owed */
+   char echo_buf[128];           /* Echo staged during an input batch */
+   uint32_t echo_len;            /* Staged echo bytes */
 
    /* Current text mode dimensions */
    int cols; /* Active columns */
@@ -93,6 +90,15 @@ typedef struct TTY_Device
    int cursor_x;
    int cursor_y;
 
+   /* Virtual-console shadow screen.  Background VTs render here instead
+    * of through the display backend (no VGA bus traffic at all); the
+    * image is repainted by TTY_SetActive when the VT comes foreground.
+    * Fixed at the default text mode — larger modes clamp on save. */
+   uint16_t shadow[SCREEN_HEIGHT][SCREEN_WIDTH];
+   int shadow_x;       /* Shadow cursor column */
+   int shadow_y;       /* Shadow cursor row */
+   uint8_t shadow_esc; /* Escape-skip state of the shadow renderer */
+
    /* Attributes */
    uint8_t color;         /* Current color attribute */
    uint8_t default_color; /* Default color */
@@ -121,11 +127,25 @@ TTY_Device *TTY_GetDevice(void); /* Get current/active TTY */
 TTY_Device *TTY_GetDeviceById(uint32_t id);
 void TTY_SetActive(TTY_Device *tty);
 
+/* Alt-Fn virtual-console switch (called by the keyboard driver):
+ * creates the target VT on demand and makes it the foreground TTY. */
+void TTY_SwitchConsole(uint32_t id);
+
 /* Input functions (called by keyboard driver) */
 void TTY_InputChar(TTY_Device *tty, char c);
+
+/* Bracket a burst of TTY_InputChar calls: reader wakes are deferred and
+ * issued once at batch end instead of per character. */
+void TTY_InputBatchBegin(TTY_Device *tty);
+void TTY_InputBatchEnd(TTY_Device *tty);
 void TTY_InputEscape(TTY_Device *tty, const char *seq);
 void TTY_InputArrow(TTY_Device *tty, char direction);
 void TTY_Write(TTY_Device *tty, const char *data, size_t len);
+
+/* Like TTY_Write, but explicitly batched: output processing is staged in
+ * chunks and the display backend presents once per chunk rather than
+ * once per character.  TTY_Write forwards here. */
+void TTY_WriteBuffer(TTY_Device *tty, const char *data, size_t len);
 void TTY_WriteChar(TTY_Device *tty, char c);
 
 /* Reading (for processes) */
@@ -139,6 +159,10 @@ void TTY_Clear(void);
 void TTY_SetCursor(TTY_Device *tty, int x, int y);
 void TTY_GetCursor(TTY_Device *tty, int *x, int *y);
 
+/* Page the console view through the backend scrollback ring (dir > 0 =
+ * older, dir < 0 = toward live, 0 = live).  Active TTY only. */
+void TTY_Scrollback(TTY_Device *tty, int dir);
+
 /* Attributes */
 void TTY_SetColor(uint8_t color);
 void TTY_SetFlags(TTY_Device *tty, uint32_t flags);
@@ -161,4 +185,8 @@ uint32_t TTY_DevfsWrite(struct DEVFS_DeviceNode *node, uint32_t offset,
                         uint32_t size, const void *buffer);
 int TTY_DevfsIoctl(struct DEVFS_DeviceNode *node, uint32_t cmd, void *arg);
 
+/* Readiness mask for the poll syscall (DEVFS_POLLIN when a read would
+ * not block, DEVFS_POLLOUT always) */
+uint32_t TTY_DevfsPoll(struct DEVFS_DeviceNode *node);
+
 #endif /* TTY_H */
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+ * Shared ring buffering for character devices (see chardev.h).
+ *
+ * Producers are typically IRQ handlers and consumers are blocked
+ * readers, so the push side takes the ring lock with interrupts
+ * disabled and the read side uses the same block/re-check/iowait idiom
+ * as the other device waits in the tree.  Copies move in at most two
+ * memcpy spans per call rather than a byte at a time.
+ */
+
+#include "chardev.h"
+#include "devfs.h"
+#include <cpu/process.h>
+#include <hal/io.h>
+#include <std/string.h>
+
+void CHARDEV_RingInit(CHARDEV_Ring *ring, void *storage, uint32_t size)
+{
+   memset(ring, 0, sizeof(*ring));
+   ring->data = (uint8_t *)storage;
+   ring->size = size;
+}
+
+uint32_t CHARDEV_RingPush(CHARDEV_Ring *ring, const void *data, uint32_t len)
+{
+   const uint8_t *src = (const uint8_t *)data;
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&ring->lock);
+
+   uint32_t space = ring->size - ring->count;
+   uint32_t accepted = len < space ? len : space;
+   ring->dropped += len - accepted;
+
+   /* At most two spans: tail to end of storage, then wrap to front. */
+   uint32_t first = ring->size - ring->tail;
+   if (first > accepted) first = accepted;
+   memcpy(&ring->data[ring->tail], src, first);
+   memcpy(&ring->data[0], src + first, accepted - first);
+
+   ring->tail = (ring->tail + accepted) % ring->size;
+   ring->count += accepted;
+
+   Spinlock_ReleaseIrqRestore(&ring->lock, interrupts_were_enabled);
+   return accepted;
+}
+
+int CHARDEV_RingPutc(CHARDEV_Ring *ring, char c)
+{
+   return CHARDEV_RingPush(ring, &c, 1) == 1 ? SUCCESS : -ENOMEM;
+}
+
+void CHARDEV_RingWake(CHARDEV_Ring *ring)
+{
+   Process_WakeByChannel(ring);
+}
+
+uint32_t CHARDEV_RingRead(CHARDEV_Ring *ring, void *buf, uint32_t count,
+                          bool nonblock)
+{
+   if (!buf || count == 0) return 0;
+
+   while (ring->count == 0)
+   {
+      if (nonblock) return 0;
+
+      /* Sleep until a producer pushes and wakes the channel; callers
+       * without a process context (early boot) hlt-poll instead. */
+      Process *cur = Process_GetCurrent();
+      if (cur)
+      {
+         Process_BlockOn(cur, ring);
+         /* Re-check before the switch happens; the push and its wake
+          * may already have landed. */
+         if (ring->count != 0) Process_Unblock(cur);
+      }
+
+      uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+      if (!interrupts_were_enabled)
+      {
+         g_HalIoOperations->DisableInterrupts();
+      }
+   }
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&ring->lock);
+
+   uint32_t taken = count < ring->count ? count : ring->count;
+   uint32_t first = ring->size - ring->head;
+   if (first > taken) first = taken;
+   memcpy(buf, &ring->data[ring->head], first);
+   memcpy((uint8_t *)buf + first, &ring->data[0], taken - first);
+
+   ring->head = (ring->head + taken) % ring->size;
+   ring->count -= taken;
+
+   Spinlock_ReleaseIrqRestore(&ring->lock, interrupts_were_enabled);
+   return taken;
+}
+
+int CHARDEV_RingGetc(CHARDEV_Ring *ring)
+{
+   uint8_t c;
+   if (CHARDEV_RingRead(ring, &c, 1, true) != 1) return -1;
+   return (int)c;
+}
+
+void CHARDEV_RingClear(CHARDEV_Ring *ring)
+{
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&ring->lock);
+   ring->head = 0;
+   ring->tail = 0;
+   ring->count = 0;
+   Spinlock_ReleaseIrqRestore(&ring->lock, interrupts_were_enabled);
+}
+
+uint32_t CHARDEV_RingCount(const CHARDEV_Ring *ring)
+{
+   return ring->count;
+}
+
+uint32_t CHARDEV_RingSpace(const CHARDEV_Ring *ring)
+{
+   return ring->size - ring->count;
+}
+
+uint32_t CHARDEV_RingPollMask(const CHARDEV_Ring *in, const CHARDEV_Ring *out)
+{
+   uint32_t mask = 0;
+   if (in && in->count > 0) mask |= DEVFS_POLLIN;
+   if (!out || out->count < out->size) mask |= DEVFS_POLLOUT;
+   return mask;
+}
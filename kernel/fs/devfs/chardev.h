@@ -0,0 +1,67 @@
+#include <constants.h>
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHARDEV_H
+#define CHARDEV_H
+
+#include <cpu/spinlock.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Shared ring buffering for character devices.
+ *
+ * One tested ring implementation instead of a hand-rolled copy per
+ * driver: IRQ-safe batched push on the producer side, blocking or
+ * non-blocking batched reads on the consumer side, and a readiness
+ * mask shaped for the devfs poll op.  Storage is caller-provided so a
+ * driver can keep its buffers static.
+ */
+
+typedef struct
+{
+   uint8_t *data;
+   uint32_t size;
+   volatile uint32_t head;  /* Read position */
+   volatile uint32_t tail;  /* Write position */
+   volatile uint32_t count; /* Bytes in the ring */
+   uint32_t dropped;        /* Producer bytes lost to overflow */
+   Spinlock lock;
+} CHARDEV_Ring;
+
+/* Bind caller-provided storage to a ring and reset it. */
+void CHARDEV_RingInit(CHARDEV_Ring *ring, void *storage, uint32_t size);
+
+/* Producer side (IRQ-safe): copy up to len bytes in; bytes that do not
+ * fit are dropped and counted.  Returns the number accepted.  Call
+ * CHARDEV_RingWake once per batch, not per byte. */
+uint32_t CHARDEV_RingPush(CHARDEV_Ring *ring, const void *data, uint32_t len);
+
+/* Single-byte producer convenience (IRQ-safe); SUCCESS or -ENOMEM. */
+int CHARDEV_RingPutc(CHARDEV_Ring *ring, char c);
+
+/* Wake readers blocked in CHARDEV_RingRead (process context). */
+void CHARDEV_RingWake(CHARDEV_Ring *ring);
+
+/* Consumer side: copy up to count bytes out in at most two memcpy
+ * spans.  Blocking mode sleeps on the ring until at least one byte is
+ * available; nonblock returns 0 immediately when the ring is empty
+ * (the caller maps that to -EAGAIN). */
+uint32_t CHARDEV_RingRead(CHARDEV_Ring *ring, void *buf, uint32_t count,
+                          bool nonblock);
+
+/* Single-byte consumer convenience; the byte, or -1 when empty. */
+int CHARDEV_RingGetc(CHARDEV_Ring *ring);
+
+/* Drop all buffered bytes. */
+void CHARDEV_RingClear(CHARDEV_Ring *ring);
+
+/* Bytes currently readable / writable without blocking. */
+uint32_t CHARDEV_RingCount(const CHARDEV_Ring *ring);
+uint32_t CHARDEV_RingSpace(const CHARDEV_Ring *ring);
+
+/* Readiness mask for a device's poll op: DEVFS_POLLIN when `in` holds
+ * data, DEVFS_POLLOUT when `out` has space.  Either ring may be NULL
+ * for devices with only one direction buffered. */
+uint32_t CHARDEV_RingPollMask(const CHARDEV_Ring *in, const CHARDEV_Ring *out);
+
+#endif
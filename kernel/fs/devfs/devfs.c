@@ -1,9 +1,12 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "devfs.h"
+#include <cpu/kthread.h>
 #include <drivers/tty/tty.h>
 #include <fs/vfs/vfs.h>
+#include <hal/io.h>
 #include <mem/mm_kernel.h>
+#include <sys/kmod/kmod.h>
 #include <std/stdio.h>
 #include <std/string.h>
 #include <stddef.h>
@@ -22,6 +25,53 @@ static DEVFS_DeviceNode g_DevNodes[DEVFS_MAXFILES];
 static uint32_t g_DevNodeCount = 0;
 static bool g_DevfsInitialized = false;
 
+/* Name hash table.  Chained buckets over the node array, so the
+ * per-open name lookup (three of them on every process creation for
+ * stdio) costs one hash and a short chain walk instead of a strcmp
+ * against every slot. */
+#define DEVFS_HASH_BUCKETS 64u
+
+static DEVFS_DeviceNode *g_DevHash[DEVFS_HASH_BUCKETS];
+
+static inline uint32_t devfs_name_hash(const char *name)
+{
+   /* FNV-1a over the device name; names are short and distinct in the
+    * first few characters, which this mixes well. */
+   uint32_t h = 2166136261u;
+   while (*name)
+   {
+      h ^= (uint8_t)*name++;
+      h *= 16777619u;
+   }
+   return h & (DEVFS_HASH_BUCKETS - 1);
+}
+
+static void devfs_hash_insert(DEVFS_DeviceNode *node)
+{
+   uint32_t bucket = devfs_name_hash(node->name);
+   node->hash_next = g_DevHash[bucket];
+   g_DevHash[bucket] = node;
+}
+
+static void devfs_hash_remove(DEVFS_DeviceNode *node)
+{
+   DEVFS_DeviceNode **link = &g_DevHash[devfs_name_hash(node->name)];
+   while (*link && *link != node) link = &(*link)->hash_next;
+   if (*link) *link = node->hash_next;
+   node->hash_next = NULL;
+}
+
+/* Hash-chain lookup by already-normalized name. */
+static DEVFS_DeviceNode *devfs_hash_find(const char *name)
+{
+   for (DEVFS_DeviceNode *n = g_DevHash[devfs_name_hash(name)]; n;
+        n = n->hash_next)
+   {
+      if (n->in_use && strncmp(n->name, name, DEVFS_PATHMAX) == 0) return n;
+   }
+   return NULL;
+}
+
 /* Devfs partition and filesystem structures (in-memory) */
 static Partition g_DevfsPartition;
 static Filesystem g_DevfsFilesystem;
@@ -36,6 +86,8 @@ static int devfs_vfs_seek(Partition *partition, void *fs_file, uint32_t pos);
 static void devfs_vfs_close(void *fs_file);
 static uint32_t devfs_vfs_get_size(void *fs_file);
 static int devfs_vfs_delete(Partition *partition, const char *path);
+static int devfs_vfs_stat(Partition *partition, const char *path,
+                          VFS_StatInfo *out);
 
 /* VFS operations table */
 static const VFS_Operations devfs_ops = {.open = devfs_vfs_open,
@@ -44,7 +96,8 @@ static const VFS_Operations devfs_ops = {.open = devfs_vfs_open,
                                          .seek = devfs_vfs_seek,
                                          .close = devfs_vfs_close,
                                          .get_size = devfs_vfs_get_size,
-                                         .delete = devfs_vfs_delete};
+                                         .delete = devfs_vfs_delete,
+                                         .stat = devfs_vfs_stat};
 
 /*
  * Helper functions
@@ -90,15 +143,28 @@ DEVFS_DeviceNode *DEVFS_RegisterDevice(const char *name, DEVFS_DeviceType type,
    }
 
    /* Check for duplicate name */
-   for (uint32_t i = 0; i < DEVFS_MAXFILES; i++)
+   DEVFS_DeviceNode *existing = devfs_hash_find(name);
+   if (existing)
    {
-      if (g_DevNodes[i].in_use &&
-          strncmp(g_DevNodes[i].name, name, DEVFS_PATHMAX) == 0)
+      if (existing->lazy)
       {
-         logfmt(LOG_ERROR, "[DEVFS] RegisterDevice: '%s' already exists\n",
-                name);
-         return NULL;
+         /* The backing module resolving its stub: adopt the real ops in
+          * place so openers blocked on the stub proceed with them. */
+         existing->type = type;
+         existing->major = major;
+         existing->minor = minor;
+         existing->size = size;
+         existing->ops = ops;
+         existing->private_data = private_data;
+         existing->lazy = false;
+
+         logfmt(LOG_INFO, "[DEVFS] Resolved lazy device: %s (module %s)\n",
+                name, existing->lazy_module);
+         return existing;
       }
+
+      logfmt(LOG_ERROR, "[DEVFS] RegisterDevice: '%s' already exists\n", name);
+      return NULL;
    }
 
    /* Find a free slot */
@@ -129,6 +195,7 @@ DEVFS_DeviceNode *DEVFS_RegisterDevice(const char *name, DEVFS_DeviceType type,
    node->ops = ops;
    node->private_data = private_data;
    node->in_use = true;
+   devfs_hash_insert(node);
 
    g_DevNodeCount++;
 
@@ -139,6 +206,71 @@ DEVFS_DeviceNode *DEVFS_RegisterDevice(const char *name, DEVFS_DeviceType type,
    return node;
 }
 
+DEVFS_DeviceNode *DEVFS_RegisterLazyDevice(const char *name,
+                                           DEVFS_DeviceType type,
+                                           uint32_t major, uint32_t minor,
+                                           const char *module_name,
+                                           const char *module_path)
+{
+   if (!module_name || module_name[0] == '\0' || !module_path ||
+       module_path[0] == '\0')
+   {
+      logfmt(LOG_ERROR, "[DEVFS] RegisterLazyDevice: invalid module\n");
+      return NULL;
+   }
+
+   DEVFS_DeviceNode *node =
+       DEVFS_RegisterDevice(name, type, major, minor, 0, NULL, NULL);
+   if (!node) return NULL;
+
+   node->lazy = true;
+   strncpy(node->lazy_module, module_name, sizeof(node->lazy_module) - 1);
+   node->lazy_module[sizeof(node->lazy_module) - 1] = '\0';
+   strncpy(node->lazy_path, module_path, DEVFS_PATHMAX - 1);
+   node->lazy_path[DEVFS_PATHMAX - 1] = '\0';
+
+   return node;
+}
+
+/* Loader kthread body for a lazy stub.  Resolution happens when the
+ * module's init re-registers the node; if the load fails or the module
+ * never does, fail the stub so waiters do not block forever. */
+static void devfs_lazy_loader(void *arg)
+{
+   DEVFS_DeviceNode *node = arg;
+
+   if (KMOD_Insmod(node->lazy_module, node->lazy_path) < 0)
+   {
+      logfmt(LOG_ERROR, "[DEVFS] %s: backing module %s failed to load\n",
+             node->name, node->lazy_module);
+   }
+
+   node->lazy = false;
+}
+
+/* First open of a lazy stub: kick the loader kthread, then block the
+ * opener (TTY_Read-style iowait loop) until the module resolves the
+ * node or the load fails. */
+static void devfs_lazy_resolve(DEVFS_DeviceNode *node)
+{
+   if (!node->lazy_pending)
+   {
+      node->lazy_pending = true;
+      if (!KThread_Create("modload", devfs_lazy_loader, node))
+      {
+         node->lazy = false; /* Cannot load; fail the open */
+         return;
+      }
+   }
+
+   while (node->lazy)
+   {
+      uint8_t iwe = g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+      if (!iwe) g_HalIoOperations->DisableInterrupts();
+   }
+}
+
 int DEVFS_UnregisterDevice(DEVFS_DeviceNode *node)
 {
    if (!node) return -EINVAL;
@@ -162,6 +294,9 @@ int DEVFS_UnregisterDevice(DEVFS_DeviceNode *node)
 
    logfmt(LOG_INFO, "[DEVFS] Unregistered device: %s\n", node->name);
 
+   /* Unlink before the memset wipes the name the hash is keyed on */
+   devfs_hash_remove(node);
+
    /* Clear the node */
    memset(node, 0, sizeof(DEVFS_DeviceNode));
    node->in_use = false;
@@ -177,16 +312,7 @@ DEVFS_DeviceNode *DEVFS_FindDevice(const char *name)
    const char *normalized = normalize_device_path(name);
    if (!normalized) return NULL;
 
-   for (uint32_t i = 0; i < DEVFS_MAXFILES; i++)
-   {
-      if (g_DevNodes[i].in_use &&
-          strncmp(g_DevNodes[i].name, normalized, DEVFS_PATHMAX) == 0)
-      {
-         return &g_DevNodes[i];
-      }
-   }
-
-   return NULL;
+   return devfs_hash_find(normalized);
 }
 
 void DEVFS_EnumerateDevices(DEVFS_EnumCallback callback, void *context)
@@ -226,6 +352,17 @@ DEVFS_File *DEVFS_Open(Partition *partition, const char *path)
       return NULL;
    }
 
+   if (node->lazy)
+   {
+      devfs_lazy_resolve(node);
+      if (!node->ops)
+      {
+         logfmt(LOG_WARNING, "[DEVFS] Open: '%s' has no backing driver\n",
+                path);
+         return NULL;
+      }
+   }
+
    DEVFS_File *file = kmalloc(sizeof(DEVFS_File));
    if (!file) return NULL;
 
@@ -298,6 +435,29 @@ uint32_t DEVFS_GetSize(DEVFS_File *file)
    return file->node->size;
 }
 
+int DEVFS_Ioctl(DEVFS_File *file, uint32_t cmd, void *arg)
+{
+   if (!file || !file->node) return -EINVAL;
+   if (!file->node->ops || !file->node->ops->ioctl) return -ENODEV;
+
+   return file->node->ops->ioctl(file->node, cmd, arg);
+}
+
+uint32_t DEVFS_Poll(DEVFS_File *file)
+{
+   if (!file || !file->node || !file->node->ops) return 0;
+
+   /* Devices with a poll op report their own readiness */
+   if (file->node->ops->poll) return file->node->ops->poll(file->node);
+
+   /* No poll op means the device never blocks: ready for whichever
+    * directions it implements at all */
+   uint32_t mask = 0;
+   if (file->node->ops->read) mask |= DEVFS_POLLIN;
+   if (file->node->ops->write) mask |= DEVFS_POLLOUT;
+   return mask;
+}
+
 /*
  * VFS wrapper functions
  */
@@ -320,6 +480,7 @@ static VFS_File *devfs_vfs_open(Partition *partition, const char *path)
    vf->fs_file = df;
    vf->is_directory = (df->node->type == DEVFS_TYPE_DIR);
    vf->size = df->node->size;
+   vf->size_gen = partition->write_gen; /* Size is fresh as of now */
 
    logfmt(LOG_INFO, "[DEVFS] Opened device: %s\n", path);
    return vf;
@@ -370,6 +531,22 @@ static int devfs_vfs_delete(Partition *partition, const char *path)
    return VFS_ENOTSUP;
 }
 
+static int devfs_vfs_stat(Partition *partition, const char *path,
+                          VFS_StatInfo *out)
+{
+   (void)partition;
+   if (!path || !out) return -EINVAL;
+
+   DEVFS_DeviceNode *node = devfs_hash_find(normalize_device_path(path));
+   if (!node) return -ENOENT;
+
+   memset(out, 0, sizeof(*out));
+   out->size = node->size;
+   out->mode = 0666; /* Device nodes carry no ownership metadata */
+   out->is_directory = (node->type == DEVFS_TYPE_DIR);
+   return SUCCESS;
+}
+
 /*
  * Initialization
  */
@@ -382,8 +559,9 @@ int DEVFS_Initialize(void)
       return SUCCESS;
    }
 
-   /* Clear device node table */
+   /* Clear device node table and the hash over it */
    memset(g_DevNodes, 0, sizeof(g_DevNodes));
+   memset(g_DevHash, 0, sizeof(g_DevHash));
    g_DevNodeCount = 0;
 
    /* Initialize the in-memory filesystem structure */
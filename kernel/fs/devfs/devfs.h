@@ -40,6 +40,12 @@ typedef enum
 typedef struct DEVFS_File DEVFS_File;
 typedef struct DEVFS_DeviceNode DEVFS_DeviceNode;
 
+/* Readiness bits reported by a device's poll op.  The values match the
+ * POSIX POLLIN/POLLOUT bits, so the descriptor layer forwards them to
+ * userspace without translation. */
+#define DEVFS_POLLIN 0x001u  /* A read would not block */
+#define DEVFS_POLLOUT 0x004u /* A write would not block */
+
 /* Device operation function pointers - drivers implement these */
 typedef struct DEVFS_DeviceOps
 {
@@ -49,6 +55,11 @@ typedef struct DEVFS_DeviceOps
                      const void *buffer);
    int (*ioctl)(DEVFS_DeviceNode *node, uint32_t cmd, void *arg);
    void (*close)(DEVFS_DeviceNode *node);
+
+   /* Readiness for the poll syscall: return DEVFS_POLLIN/DEVFS_POLLOUT
+    * as applicable.  NULL means the device never blocks, and readiness
+    * is inferred from which of read/write it implements. */
+   uint32_t (*poll)(DEVFS_DeviceNode *node);
 } DEVFS_DeviceOps;
 
 /* Device node - represents a registered device in devfs */
@@ -62,6 +73,17 @@ struct DEVFS_DeviceNode
    const DEVFS_DeviceOps *ops; /* Device-specific operations */
    void *private_data;         /* Driver-specific data pointer */
    bool in_use;                /* True if this node is allocated */
+
+   /* Lazy stub state (see DEVFS_RegisterLazyDevice): the backing module
+    * is loaded on first open and re-registers this node with real ops. */
+   bool lazy;                     /* True until the backing module resolves */
+   bool lazy_pending;             /* Loader kthread already spawned */
+   char lazy_module[32];          /* KMOD name of the backing module */
+   char lazy_path[DEVFS_PATHMAX]; /* Module image path on disk */
+
+   /* Chain link for the name hash table (devfs.c); maintained by
+    * register/unregister so lookups by name are O(1). */
+   struct DEVFS_DeviceNode *hash_next;
 };
 
 /* Open file handle for devfs */
@@ -113,6 +135,21 @@ DEVFS_DeviceNode *DEVFS_RegisterDevice(const char *name, DEVFS_DeviceType type,
                                        const DEVFS_DeviceOps *ops,
                                        void *private_data);
 
+/* Register a lazy stub: the node exists immediately but has no ops, and
+ * the first open spawns a kthread that loads the backing kernel module
+ * (KMOD_Insmod of module_name from module_path).  The module's init is
+ * expected to call DEVFS_RegisterDevice with the same name, which fills
+ * the stub in place; the blocked opener then proceeds with real ops.
+ * Drivers whose hardware may be absent register stubs so boots that
+ * never touch the device never pay the module load.
+ * @return           Pointer to the stub node, or NULL on failure
+ */
+DEVFS_DeviceNode *DEVFS_RegisterLazyDevice(const char *name,
+                                           DEVFS_DeviceType type,
+                                           uint32_t major, uint32_t minor,
+                                           const char *module_name,
+                                           const char *module_path);
+
 /* Unregister a device node from devfs.
  * @param node       Node to unregister (returned from DEVFS_RegisterDevice)
  * @return           DEVFS_OK on success, DEVFS_ENOENT if node not found
@@ -157,4 +194,10 @@ int DEVFS_Seek(DEVFS_File *file, uint32_t position);
 /* Get file size */
 uint32_t DEVFS_GetSize(DEVFS_File *file);
 
+/* Readiness mask (DEVFS_POLLIN/DEVFS_POLLOUT) for an open device */
+uint32_t DEVFS_Poll(DEVFS_File *file);
+
+/* Device-specific control; -ENODEV when the device has no ioctl op */
+int DEVFS_Ioctl(DEVFS_File *file, uint32_t cmd, void *arg);
+
 #endif
\ No newline at end of file
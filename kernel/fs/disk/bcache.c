@@ -0,0 +1,385 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "bcache.h"
+#include "disk.h"
+#include <crypto/crypto.h>
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <std/string.h>
+#include <stdbool.h>
+
+/* =========================================================================
+ * Sector block cache (LRU)
+ *
+ * Fixed pool of BCACHE_ENTRIES entries.  Lookup goes through a hash table
+ * keyed on (disk, lba); eviction picks the tail of a doubly linked LRU
+ * list.  Everything is allocated once at BCACHE_Initialize time so the
+ * hot path never touches the heap.
+ * ====================================================================== */
+
+typedef struct BCacheEntry
+{
+   DISK *disk;   /* NULL while the entry has never been filled */
+   uint32_t lba;
+   uint32_t crc; /* CRC32 of data, set on insert, checked on hit */
+   bool dirty;   /* Payload newer than the device copy */
+
+   struct BCacheEntry *hash_next;
+   struct BCacheEntry *lru_prev;
+   struct BCacheEntry *lru_next;
+
+   uint8_t data[BCACHE_SECTOR_SIZE];
+} BCacheEntry;
+
+#define BCACHE_HASH_BUCKETS 128
+
+static BCacheEntry *g_Entries = NULL;
+static BCacheEntry *g_HashTable[BCACHE_HASH_BUCKETS];
+static BCacheEntry *g_LruHead = NULL; /* Most recently used */
+static BCacheEntry *g_LruTail = NULL; /* Eviction candidate */
+
+static uint32_t g_Hits = 0;
+static uint32_t g_Misses = 0;
+static uint32_t g_DirtyCount = 0;
+static uint32_t g_CrcErrors = 0;
+
+/* Start a batched flush once this many sectors await write-back; keeps
+ * the deferred-write window bounded without a background thread. */
+#define BCACHE_DIRTY_HIGH 64
+
+/* Longest merged run a sorted flush writes in one device command; also
+ * sizes the staging buffer the run is assembled in. */
+#define BCACHE_FLUSH_RUN_MAX 32
+
+static uint8_t *g_FlushBuffer = NULL;
+
+/* Write one entry back to its device and clear its dirty mark. */
+static int bcache_writeback(BCacheEntry *e)
+{
+   if (!e->dirty || !e->disk) return 0;
+
+   int rc = DISK_RawWriteSectors(e->disk, e->lba, 1, e->data);
+   if (rc != SUCCESS) return -1;
+
+   e->dirty = false;
+   g_DirtyCount--;
+   return 0;
+}
+
+static inline uint32_t bcache_hash(DISK *disk, uint32_t lba)
+{
+   /* Mix the disk pointer with the LBA; consecutive sectors land in
+    * different buckets so sequential runs do not chain on one list. */
+   uint32_t h = (uint32_t)(uintptr_t)disk ^ (lba * 2654435761u);
+   return h % BCACHE_HASH_BUCKETS;
+}
+
+static void bcache_lru_unlink(BCacheEntry *e)
+{
+   if (e->lru_prev)
+      e->lru_prev->lru_next = e->lru_next;
+   else
+      g_LruHead = e->lru_next;
+
+   if (e->lru_next)
+      e->lru_next->lru_prev = e->lru_prev;
+   else
+      g_LruTail = e->lru_prev;
+
+   e->lru_prev = NULL;
+   e->lru_next = NULL;
+}
+
+static void bcache_lru_push_front(BCacheEntry *e)
+{
+   e->lru_prev = NULL;
+   e->lru_next = g_LruHead;
+   if (g_LruHead) g_LruHead->lru_prev = e;
+   g_LruHead = e;
+   if (!g_LruTail) g_LruTail = e;
+}
+
+static void bcache_hash_remove(BCacheEntry *e)
+{
+   if (!e->disk) return;
+
+   uint32_t bucket = bcache_hash(e->disk, e->lba);
+   BCacheEntry **link = &g_HashTable[bucket];
+   while (*link)
+   {
+      if (*link == e)
+      {
+         *link = e->hash_next;
+         e->hash_next = NULL;
+         return;
+      }
+      link = &(*link)->hash_next;
+   }
+}
+
+static BCacheEntry *bcache_find(DISK *disk, uint32_t lba)
+{
+   BCacheEntry *e = g_HashTable[bcache_hash(disk, lba)];
+   while (e)
+   {
+      if (e->disk == disk && e->lba == lba) return e;
+      e = e->hash_next;
+   }
+   return NULL;
+}
+
+void BCACHE_Initialize(void)
+{
+   g_Entries = (BCacheEntry *)kmalloc(sizeof(BCacheEntry) * BCACHE_ENTRIES);
+   if (!g_Entries)
+   {
+      /* Cache stays disabled; DISK_ReadSectors falls through to the
+       * device on every request. */
+      logfmt(LOG_ERROR, "[BCACHE] Allocation failed, cache disabled\n");
+      return;
+   }
+
+   memset(g_Entries, 0, sizeof(BCacheEntry) * BCACHE_ENTRIES);
+   memset(g_HashTable, 0, sizeof(g_HashTable));
+   g_LruHead = NULL;
+   g_LruTail = NULL;
+
+   /* All entries start empty on the LRU list, oldest first. */
+   for (int i = 0; i < BCACHE_ENTRIES; i++)
+      bcache_lru_push_front(&g_Entries[i]);
+
+   /* Staging buffer for merged write-back runs; without it the flush
+    * degrades to per-sector writes but stays correct. */
+   g_FlushBuffer = (uint8_t *)kmalloc(BCACHE_FLUSH_RUN_MAX *
+                                      BCACHE_SECTOR_SIZE);
+   if (!g_FlushBuffer)
+      logfmt(LOG_WARNING, "[BCACHE] No flush buffer, merged sync disabled\n");
+
+   logfmt(LOG_INFO, "[BCACHE] %u sector entries (%u KiB)\n",
+          (uint32_t)BCACHE_ENTRIES,
+          (uint32_t)(BCACHE_ENTRIES * BCACHE_SECTOR_SIZE / 1024));
+}
+
+int BCACHE_Lookup(DISK *disk, uint32_t lba, void *dataOut)
+{
+   if (!g_Entries) return -1;
+
+   BCacheEntry *e = bcache_find(disk, lba);
+   if (!e)
+   {
+      g_Misses++;
+      return -1;
+   }
+
+   /* Verify before handing the payload out: a mismatch means the entry
+    * was corrupted in memory, so drop it and fall back to the device. */
+   if (CRC32_Calculate(e->data, BCACHE_SECTOR_SIZE) != e->crc)
+   {
+      g_CrcErrors++;
+      logfmt(LOG_ERROR, "[BCACHE] crc mismatch lba=%u errors=%u\n", e->lba,
+             g_CrcErrors);
+      if (e->dirty)
+      {
+         e->dirty = false;
+         g_DirtyCount--;
+      }
+      bcache_hash_remove(e);
+      e->disk = NULL;
+      g_Misses++;
+      return -1;
+   }
+
+   memcpy(dataOut, e->data, BCACHE_SECTOR_SIZE);
+   if (e != g_LruHead)
+   {
+      bcache_lru_unlink(e);
+      bcache_lru_push_front(e);
+   }
+   g_Hits++;
+   return 0;
+}
+
+void BCACHE_Insert(DISK *disk, uint32_t lba, const void *data)
+{
+   if (!g_Entries) return;
+
+   BCacheEntry *e = bcache_find(disk, lba);
+   if (!e)
+   {
+      /* Evict the LRU tail and rebind it to the new sector.  A dirty
+       * victim is written back first so deferred data is never lost. */
+      e = g_LruTail;
+      if (e->dirty && bcache_writeback(e) < 0)
+      {
+         /* Device refused the write-back; drop the data rather than
+          * poison the new binding. */
+         e->dirty = false;
+         g_DirtyCount--;
+      }
+      bcache_lru_unlink(e);
+      bcache_hash_remove(e);
+
+      e->disk = disk;
+      e->lba = lba;
+
+      uint32_t bucket = bcache_hash(disk, lba);
+      e->hash_next = g_HashTable[bucket];
+      g_HashTable[bucket] = e;
+   }
+   else
+   {
+      bcache_lru_unlink(e);
+   }
+
+   memcpy(e->data, data, BCACHE_SECTOR_SIZE);
+   e->crc = CRC32_Calculate(e->data, BCACHE_SECTOR_SIZE);
+   bcache_lru_push_front(e);
+}
+
+int BCACHE_InsertDirty(DISK *disk, uint32_t lba, const void *data)
+{
+   if (!g_Entries) return -1;
+
+   BCACHE_Insert(disk, lba, data);
+
+   BCacheEntry *e = bcache_find(disk, lba);
+   if (!e) return -1;
+
+   if (!e->dirty)
+   {
+      e->dirty = true;
+      g_DirtyCount++;
+   }
+
+   if (g_DirtyCount >= BCACHE_DIRTY_HIGH) BCACHE_Sync();
+
+   return 0;
+}
+
+/* Order dirty entries into one ascending sweep: by device first so each
+ * disk sees a contiguous slice of the batch, then by LBA. */
+static bool bcache_flush_before(const BCacheEntry *a, const BCacheEntry *b)
+{
+   if (a->disk != b->disk) return (uintptr_t)a->disk < (uintptr_t)b->disk;
+   return a->lba < b->lba;
+}
+
+/* Write one sorted run of adjacent sectors on the same disk as a single
+ * device command.  Entries stay dirty when the device refuses the run,
+ * mirroring the per-sector failure behaviour. */
+static int bcache_flush_run(BCacheEntry **run, uint32_t count)
+{
+   for (uint32_t i = 0; i < count; i++)
+      memcpy(g_FlushBuffer + i * BCACHE_SECTOR_SIZE, run[i]->data,
+             BCACHE_SECTOR_SIZE);
+
+   if (DISK_RawWriteSectors(run[0]->disk, run[0]->lba, count,
+                            g_FlushBuffer) != SUCCESS)
+      return -1;
+
+   for (uint32_t i = 0; i < count; i++)
+   {
+      run[i]->dirty = false;
+      g_DirtyCount--;
+   }
+   return 0;
+}
+
+/* Flush every dirty entry, elevator style.
+ *
+ * The device path is synchronous, so the closest thing this tree has to
+ * an I/O request queue is the set of sectors awaiting write-back.
+ * Flushing them in pool order seeks back and forth across the platter;
+ * instead the batch is gathered, sorted by (device, LBA) into one
+ * ascending sweep, and adjacent sectors are merged into multi-sector
+ * device commands.  On rotational drives one sorted sweep with merged
+ * runs is worth a large multiple of the unsorted order.
+ */
+int BCACHE_Sync(void)
+{
+   if (!g_Entries || g_DirtyCount == 0) return SUCCESS;
+
+   BCacheEntry *batch[BCACHE_ENTRIES];
+   uint32_t n = 0;
+   for (int i = 0; i < BCACHE_ENTRIES; i++)
+   {
+      if (g_Entries[i].dirty) batch[n++] = &g_Entries[i];
+   }
+
+   /* Insertion sort: the batch is at most BCACHE_ENTRIES pointers and
+    * typically BCACHE_DIRTY_HIGH, far below where anything cleverer
+    * would pay for itself. */
+   for (uint32_t i = 1; i < n; i++)
+   {
+      BCacheEntry *key = batch[i];
+      uint32_t j = i;
+      while (j > 0 && bcache_flush_before(key, batch[j - 1]))
+      {
+         batch[j] = batch[j - 1];
+         j--;
+      }
+      batch[j] = key;
+   }
+
+   int rc = SUCCESS;
+   uint32_t i = 0;
+   while (i < n)
+   {
+      uint32_t count = 1;
+      if (g_FlushBuffer)
+      {
+         while (i + count < n && count < BCACHE_FLUSH_RUN_MAX &&
+                batch[i + count]->disk == batch[i]->disk &&
+                batch[i + count]->lba == batch[i]->lba + count)
+            count++;
+      }
+
+      if (count > 1)
+      {
+         if (bcache_flush_run(&batch[i], count) < 0) rc = -EIO;
+      }
+      else if (bcache_writeback(batch[i]) < 0)
+      {
+         rc = -EIO;
+      }
+      i += count;
+   }
+   return rc;
+}
+
+uint32_t BCACHE_DirtyCount(void) { return g_DirtyCount; }
+
+void BCACHE_Invalidate(DISK *disk, uint32_t lba, uint32_t sectors)
+{
+   if (!g_Entries) return;
+
+   for (uint32_t i = 0; i < sectors; i++)
+   {
+      BCacheEntry *e = bcache_find(disk, lba + i);
+      if (!e) continue;
+
+      bcache_hash_remove(e);
+      e->disk = NULL;
+      if (e->dirty)
+      {
+         e->dirty = false;
+         g_DirtyCount--;
+      }
+
+      /* Demote to eviction candidate. */
+      bcache_lru_unlink(e);
+      e->lru_prev = g_LruTail;
+      e->lru_next = NULL;
+      if (g_LruTail)
+         g_LruTail->lru_next = e;
+      else
+         g_LruHead = e;
+      g_LruTail = e;
+   }
+}
+
+void BCACHE_Stats(uint32_t *hitsOut, uint32_t *missesOut)
+{
+   if (hitsOut) *hitsOut = g_Hits;
+   if (missesOut) *missesOut = g_Misses;
+}
@@ -0,0 +1,58 @@
+#include <constants.h>
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+This is a local header file, and it is not allowed to directly include
+this file, so for external modules, include fs/fs.h instead.
+*/
+
+#ifndef BCACHE_H
+#define BCACHE_H
+
+#include "disk.h"
+#include <stdint.h>
+
+/* Sector-granular block cache sitting between DISK_ReadSectors and the
+ * low-level drivers.  Directory-heavy workloads re-read the same handful
+ * of FAT and directory sectors hundreds of times per second; serving them
+ * from memory avoids a full ATA/FDC round trip each time.
+ *
+ * Replacement policy is LRU over a fixed pool of BCACHE_ENTRIES sectors,
+ * looked up through a hash table keyed on (disk, lba).
+ */
+
+#define BCACHE_SECTOR_SIZE 512
+
+/* Cache footprint: entries * 512 bytes of payload (default 128 KiB). */
+#define BCACHE_ENTRIES 256
+
+void BCACHE_Initialize(void);
+
+/* Look a sector up in the cache.  Returns 0 and fills dataOut on a hit,
+ * -1 on a miss (caller reads the device and inserts via BCACHE_Insert). */
+int BCACHE_Lookup(DISK *disk, uint32_t lba, void *dataOut);
+
+/* Insert (or refresh) one sector's payload into the cache. */
+void BCACHE_Insert(DISK *disk, uint32_t lba, const void *data);
+
+/* Drop any cached copies of [lba, lba+sectors).  Dirty data in the range
+ * is discarded, not written back — invalidation means the on-disk state
+ * is the truth. */
+void BCACHE_Invalidate(DISK *disk, uint32_t lba, uint32_t sectors);
+
+/* Write-back: store one sector in the cache marked dirty.  The payload
+ * reaches the device on eviction, when the dirty high-water mark is hit,
+ * or on BCACHE_Sync.  Returns 0, or -1 when the cache is disabled and the
+ * caller must write through directly. */
+int BCACHE_InsertDirty(DISK *disk, uint32_t lba, const void *data);
+
+/* Flush every dirty sector to its device.  Backs the sync() syscall. */
+int BCACHE_Sync(void);
+
+/* Number of sectors currently awaiting write-back. */
+uint32_t BCACHE_DirtyCount(void);
+
+/* Hit/miss counters for diagnostics. */
+void BCACHE_Stats(uint32_t *hitsOut, uint32_t *missesOut);
+
+#endif
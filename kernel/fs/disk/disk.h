@@ -37,6 +37,21 @@ typedef struct DISK_Operations
 
 } DISK_Operations;
 
+/* Per-device I/O statistics, updated in DISK_ReadSectors and
+ * DISK_WriteSectors and mirrored per partition.  Cycle counts come
+ * from rdtsc and cover the full cache-or-device round trip, so cache
+ * changes show up directly in cycles-per-sector.  Snapshot readable
+ * as text from /dev/diskstats. */
+typedef struct
+{
+   uint64_t read_ops;
+   uint64_t write_ops;
+   uint64_t read_sectors;
+   uint64_t write_sectors;
+   uint64_t read_cycles;
+   uint64_t write_cycles;
+} DISK_IoStats;
+
 typedef struct
 {
    uint8_t id;   // bios drive number
@@ -48,15 +63,32 @@ typedef struct
    void *private;
    char brand[41]; // Model name (up to 40 chars + null)
    uint64_t size;  // Total size in bytes
+
+   DISK_IoStats stats;
 } DISK;
 
 int DISK_Initialize();
 int DISK_Scan();
 int DISK_GetDevfsIndex(); // Get volume index for devfs (-1 if not found)
-int DISK_ReadSectors(DISK *disk, uint32_t lba, uint8_t sectors,
+/* Sector counts are 32-bit so callers can hand down entire cluster runs;
+ * the drivers split them into per-command chunks as needed. */
+int DISK_ReadSectors(DISK *disk, uint32_t lba, uint32_t sectors,
                      void *lowerDataOut);
-int DISK_WriteSectors(DISK *disk, uint32_t lba, uint8_t sectors,
+/* Write-back: sectors land dirty in the block cache and are flushed on
+ * eviction, at the dirty high-water mark, or on DISK_Sync. */
+int DISK_WriteSectors(DISK *disk, uint32_t lba, uint32_t sectors,
                       const void *dataIn);
+/* Synchronous write straight to the device, bypassing the cache.  Used
+ * by the cache itself for write-back; most callers want the cached
+ * variant above. */
+int DISK_RawWriteSectors(DISK *disk, uint32_t lba, uint32_t sectors,
+                         const void *dataIn);
+/* Flush one device's volatile write cache (ATA FLUSH CACHE); no-op for
+ * write-through devices.  Barrier for re-enabling drive caching. */
+int DISK_Flush(DISK *disk);
+/* Flush all deferred writes to their devices, then issue a cache-flush
+ * barrier per device.  Backs the sync() syscall. */
+int DISK_Sync(void);
 
 /* Devfs device operations for raw disk access */
 struct DEVFS_DeviceNode;
@@ -81,14 +113,25 @@ typedef struct Partition
    uint32_t uuid;
    char label[12];
    bool isRootPartition;
+
+   /* Bumped by VFS_Write on every successful write to this partition;
+    * versions the per-handle size caches in VFS_File (see VFS_GetSize). */
+   uint32_t write_gen;
+
+   DISK_IoStats stats;
 } Partition;
 
 Partition **MBR_DetectPartition(DISK *disk, int *outCount);
 
-int Partition_ReadSectors(Partition *disk, uint32_t lba, uint8_t sectors,
+/* Fast path: partition list from the map stage-2 handed over in
+ * BOOT_Info.  NULL when no usable map exists - fall back to
+ * MBR_DetectPartition. */
+Partition **MBR_FromBootMap(DISK *disk, int *outCount);
+
+int Partition_ReadSectors(Partition *disk, uint32_t lba, uint32_t sectors,
                           void *lowDataOut);
 
-int Partition_WriteSectors(Partition *part, uint32_t lba, uint8_t sectors,
+int Partition_WriteSectors(Partition *part, uint32_t lba, uint32_t sectors,
                            const void *lowerDataIn);
 
 /* Devfs device operations for partition access */
@@ -32,6 +32,94 @@ typedef struct
 
 } __attribute__((packed)) MBR_Entry;
 
+/* Allocate one Partition, fill it in and register its devfs node
+ * (hda1, hda2, hdb1, ...).  Shared by the on-disk MBR parse and the
+ * bootloader-map fast path below. */
+static Partition *mbr_make_partition(DISK *disk, int index, uint8_t type,
+                                     uint32_t lbaStart, uint32_t sectorCount)
+{
+   Partition *part = (Partition *)kzalloc(sizeof(Partition));
+   if (!part) return NULL;
+
+   part->disk = disk;
+   part->partitionOffset = lbaStart;
+   part->partitionSize = sectorCount;
+   part->partitionType = type;
+
+   /* Register ATA partition in devfs: hda1, hda2, hdb1, etc. */
+   char devname[8];
+   /* disk->id is BIOS drive number (0x80, 0x81, ...) */
+   int disk_idx = (disk->id >= 0x80) ? (disk->id - 0x80) : 0;
+   devname[0] = 'h';
+   devname[1] = 'd';
+   devname[2] = 'a' + disk_idx;
+   devname[3] = '1' + index; /* partition number */
+   devname[4] = '\0';
+   uint32_t part_size = part->partitionSize * 512;
+   DEVFS_RegisterDevice(devname, DEVFS_TYPE_BLOCK, 3, disk_idx * 16 + index + 1,
+                        part_size, &partition_ops, part);
+
+   return part;
+}
+
+/**
+ * MBR_FromBootMap - build the partition list from the map stage-2
+ * already resolved (g_SysInfo->boot.partMap) instead of re-reading and
+ * re-parsing the MBR.  Returns NULL when no map was published or it has
+ * no usable entries for this disk; the caller then falls back to
+ * MBR_DetectPartition and its synchronous sector read.
+ */
+Partition **MBR_FromBootMap(DISK *disk, int *outCount)
+{
+   if (!outCount || !disk) return NULL;
+
+   *outCount = 0;
+
+   if (disk->type == DISK_TYPE_FLOPPY) return NULL;
+   if (g_SysInfo->boot.partMapCount == 0) return NULL;
+
+   Partition **list = NULL;
+   int count = 0;
+
+   for (uint32_t i = 0; i < g_SysInfo->boot.partMapCount && count < 4; i++)
+   {
+      const BOOT_PartMapEntry *entry = &g_SysInfo->boot.partMap[i];
+
+      if (entry->drive != disk->id) continue;
+
+      // FAT variants we support
+      if (entry->type != 0x04 && entry->type != 0x06 &&
+          entry->type != 0x0B && entry->type != 0x0C)
+         continue;
+
+      if (!list)
+      {
+         list = (Partition **)kzalloc(sizeof(Partition *) * 4);
+         if (!list) return NULL;
+      }
+
+      Partition *part = mbr_make_partition(disk, count, entry->type,
+                                           entry->lbaStart,
+                                           entry->sectorCount);
+      if (!part) continue;
+
+      list[count++] = part;
+   }
+
+   if (count == 0)
+   {
+      if (list) free(list);
+      return NULL;
+   }
+
+   logfmt(LOG_INFO,
+          "[MBR] Using bootloader partition map for disk 0x%x: %d partitions\n",
+          disk->id, count);
+
+   *outCount = count;
+   return list;
+}
+
 Partition **MBR_DetectPartition(DISK *disk, int *outCount)
 {
    if (!outCount || !disk) return NULL;
@@ -76,28 +164,11 @@ Partition **MBR_DetectPartition(DISK *disk, int *outCount)
          // FAT variants we support
          if (type == 0x04 || type == 0x06 || type == 0x0B || type == 0x0C)
          {
-            Partition *part = (Partition *)kzalloc(sizeof(Partition));
+            Partition *part =
+                mbr_make_partition(disk, count, type, *(uint32_t *)(entry + 8),
+                                   *(uint32_t *)(entry + 12));
             if (!part) continue;
 
-            part->disk = disk;
-            part->partitionOffset = *(uint32_t *)(entry + 8);
-            part->partitionSize = *(uint32_t *)(entry + 12);
-            part->partitionType = type;
-
-            /* Register ATA partition in devfs: hda1, hda2, hdb1, etc. */
-            char devname[8];
-            /* disk->id is BIOS drive number (0x80, 0x81, ...) */
-            int disk_idx = (disk->id >= 0x80) ? (disk->id - 0x80) : 0;
-            devname[0] = 'h';
-            devname[1] = 'd';
-            devname[2] = 'a' + disk_idx;
-            devname[3] = '1' + count; /* partition number */
-            devname[4] = '\0';
-            uint32_t part_size = part->partitionSize * 512;
-            DEVFS_RegisterDevice(devname, DEVFS_TYPE_BLOCK, 3,
-                                 disk_idx * 16 + count + 1, part_size,
-                                 &partition_ops, part);
-
             list[count++] = part;
          }
       }
@@ -7,7 +7,15 @@
 #include <std/stdio.h>
 #include <sys/sys.h>
 
-int Partition_ReadSectors(Partition *part, uint32_t lba, uint8_t sectors,
+/* Cycle counter for the per-partition I/O statistics (i686 only). */
+static inline uint64_t part_cycles(void)
+{
+   uint32_t lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((uint64_t)hi << 32) | lo;
+}
+
+int Partition_ReadSectors(Partition *part, uint32_t lba, uint32_t sectors,
                           void *lowerDataOut)
 {
    if (!part) return -EINVAL;
@@ -32,11 +40,19 @@ int Partition_ReadSectors(Partition *part, uint32_t lba, uint8_t sectors,
 
    if (!part->disk) return PARTITION_EDISK;
 
-   return DISK_ReadSectors(part->disk, lba + part->partitionOffset, sectors,
-                           lowerDataOut);
+   uint64_t start = part_cycles();
+   int rc = DISK_ReadSectors(part->disk, lba + part->partitionOffset, sectors,
+                             lowerDataOut);
+   if (rc == SUCCESS)
+   {
+      part->stats.read_ops++;
+      part->stats.read_sectors += sectors;
+      part->stats.read_cycles += part_cycles() - start;
+   }
+   return rc;
 }
 
-int Partition_WriteSectors(Partition *part, uint32_t lba, uint8_t sectors,
+int Partition_WriteSectors(Partition *part, uint32_t lba, uint32_t sectors,
                            const void *lowerDataIn)
 {
    if (!part) return -EINVAL;
@@ -57,8 +73,16 @@ int Partition_WriteSectors(Partition *part, uint32_t lba, uint8_t sectors,
 
    if (!part->disk) return PARTITION_EDISK;
 
-   return DISK_WriteSectors(part->disk, lba + part->partitionOffset, sectors,
-                            lowerDataIn);
+   uint64_t start = part_cycles();
+   int rc = DISK_WriteSectors(part->disk, lba + part->partitionOffset, sectors,
+                              lowerDataIn);
+   if (rc == SUCCESS)
+   {
+      part->stats.write_ops++;
+      part->stats.write_sectors += sectors;
+      part->stats.write_cycles += part_cycles() - start;
+   }
+   return rc;
 }
 
 /*
@@ -19,6 +19,17 @@
 #define MAX_FILE_HANDLES 10
 #define ROOT_DIRECTORY_HANDLE -1
 #define FAT_CACHE_SIZE 5
+#define FAT_READAHEAD_MIN 2  /* Clusters per prefetch when first armed */
+#define FAT_READAHEAD_MAX 16 /* Window ceiling while reads stay sequential */
+
+/* Byte budget for one prefetch trigger.  The window is counted in
+ * clusters, so on a 32-64 KB-cluster FAT32 volume the cluster ceiling
+ * alone would let a single trigger pull a megabyte; the byte cap keeps
+ * the latency of the triggering read bounded regardless of cluster
+ * size. */
+#define FAT_READAHEAD_MAX_BYTES (256u * 1024u)
+#define FAT_EXTENT_MAX 16    /* Contiguous-run slots per open file */
+#define FAT_DCACHE_SIZE 16   /* Path-lookup cache slots per volume */
 #define FAT_METADATA_PATH "/.vkmeta"
 #define FAT_METADATA_FLAG_VALID 0x01
 #define FAT_METADATA_FLAG_DELETED 0x02
@@ -33,6 +44,23 @@ typedef struct
    uint8_t _Reserved[5];
 } __attribute__((packed)) FAT_MetadataRecord;
 
+/* In-memory index over the append-only metadata sidecar: path hash ->
+ * latest record.  Chained buckets, nodes kmalloc'd per distinct path.
+ * Built lazily from one linear pass, then opens are pure memory
+ * lookups instead of a file scan per access check. */
+#define FAT_META_INDEX_BUCKETS 128u
+
+typedef struct FAT_MetaIndexEntry
+{
+   uint8_t Hash[SHA1_DIGEST_SIZE];
+   FAT_MetadataRecord Record;
+   struct FAT_MetaIndexEntry *Next;
+} FAT_MetaIndexEntry;
+
+/* Compact the sidecar once it holds this many records and at least
+ * half of them are superseded. */
+#define FAT_META_COMPACT_MIN 64u
+
 typedef struct
 {
    // extended boot record
@@ -80,6 +108,14 @@ typedef struct
    } ExtendedBootRecord;
 } __attribute__((packed)) FAT_BootSector;
 
+/* One run of contiguous clusters within a file's chain. */
+typedef struct
+{
+   uint32_t StartIndex;   /* Chain index of the first cluster in the run */
+   uint32_t StartCluster; /* Cluster number at StartIndex */
+   uint32_t Length;       /* Clusters in the run */
+} FAT_Extent;
+
 typedef struct
 {
    uint8_t Buffer[SECTOR_SIZE];
@@ -94,8 +130,47 @@ typedef struct
    uint32_t ParentCluster;
    bool ParentIsRoot;
 
+   /* Sequential read-ahead state.  Two back-to-back sequential FAT_Read
+    * calls arm the prefetcher; the window grows while the pattern holds
+    * and collapses on the first non-sequential access. */
+   uint32_t LastReadEnd;     /* Position right after the previous read */
+   uint32_t SeqStreak;       /* Consecutive sequential reads observed */
+   uint32_t PrefetchWindow;  /* Clusters fetched per prefetch trigger */
+   uint32_t PrefetchCluster; /* Last cluster already pulled into cache */
+
+   /* Lazily learned map of contiguous cluster runs, sorted by StartIndex.
+    * FAT_Seek binary-searches it to jump close to a target position
+    * instead of walking the whole chain from the first cluster.  Mostly
+    * contiguous files need one or two slots; the map simply stops
+    * learning when all slots are taken. */
+   FAT_Extent Extents[FAT_EXTENT_MAX];
+   uint32_t ExtentCount;
+
+   /* Directory-scan buffer (fat_dir_next_entry).  Entries are served out
+    * of this buffer, refilled FAT_DIRBUF_SIZE bytes at a time with one
+    * bulk FAT_Read, instead of one FAT_Read per 32-byte entry.
+    * Allocated lazily on the first scan through this handle. */
+   uint8_t *DirBuffer;
+   uint32_t DirBufferBytes; /* Valid bytes in DirBuffer */
+   uint32_t DirBufferPos;   /* Offset of the next unserved entry */
+   uint32_t DirBufferEnd;   /* File position right after the refill read */
+
 } FAT_FileData;
 
+/* One slot of the per-volume path-lookup (dentry) cache.  A negative slot
+ * remembers that the path did not exist, so repeated opens of a missing
+ * file skip the directory walk entirely. */
+typedef struct
+{
+   char Path[MAX_PATH_SIZE];
+   bool Valid;
+   bool Negative;
+   FAT_DirectoryEntry Entry;
+   uint32_t ParentCluster;
+   bool ParentIsRoot;
+   uint32_t LastUsed;
+} FAT_DirCacheEntry;
+
 /* ============================================================================
  * FAT_Instance — encapsulates ALL per-volume state.
  * Replaces the former static g_Data pointer and all g_* scalar globals.
@@ -122,6 +197,51 @@ struct FAT_Instance
    uint8_t FatCache[FAT_CACHE_SIZE * SECTOR_SIZE];
    uint32_t FatCachePos;
 
+   /* Whole-FAT in-memory copy.  Loaded once at mount so FAT_NextCluster is
+    * a plain memory read instead of one disk I/O per cluster step.  NULL
+    * when the table is too large or the allocation failed; the windowed
+    * FatCache above then remains the fallback path. */
+   uint8_t *FatTable;
+   uint8_t *FatDirty; /* One byte per FAT sector; nonzero = needs write-back */
+   uint32_t FatDirtyCount;
+   bool FatTableValid;
+
+   /* Free-cluster bitmap: bit set = cluster free.  Built once at mount,
+    * kept in sync by FAT_WriteFatEntry and rebuilt lazily after
+    * FAT_InvalidateCache.  FreeHint rotates past the last allocation so
+    * the search does not rescan the filled front of the volume.  NULL
+    * when the allocation failed; fat_alloc_cluster then falls back to
+    * the linear FAT-entry scan. */
+   uint8_t *FreeBitmap;
+   bool FreeBitmapValid;
+   uint32_t FreeHint;     /* Next cluster number to try (>= 2) */
+   uint32_t ClusterLimit; /* Exclusive upper bound on cluster numbers */
+
+   /* Persistent free-space summary (FAT32 FSInfo sector).  A clean
+    * summary lets mount adopt the free count and hint without scanning
+    * the FAT; the bitmap is then built lazily on the first allocation.
+    * The on-disk copy is marked dirty before the first FAT mutation and
+    * rewritten clean at every fat_table_flush persistence point, so
+    * only unclean shutdowns pay the mount-time scan. */
+   uint32_t FreeClusterCount; /* Free clusters; valid with FreeCountValid */
+   bool FreeCountValid;
+   bool FsinfoDirty; /* On-disk summary currently marked in-use */
+
+   /* Metadata sidecar index (see FAT_MetaIndexEntry).  Built lazily on
+    * the first access check; Disabled latches a build failure so every
+    * open does not retry a doomed allocation. */
+   FAT_MetaIndexEntry *MetaIndex[FAT_META_INDEX_BUCKETS];
+   bool MetaIndexValid;
+   bool MetaIndexDisabled;
+   uint32_t MetaRecordCount; /* Records currently in the sidecar file */
+   uint32_t MetaLiveCount;   /* Distinct paths (index entries) */
+
+   /* Path-lookup cache consulted by FAT_Open.  Learned from successful
+    * and failed walks, dropped wholesale whenever directory contents or
+    * entry metadata change — correctness over retention. */
+   FAT_DirCacheEntry DirCache[FAT_DCACHE_SIZE];
+   uint32_t DirCacheTick;
+
    /* Derived filesystem geometry (formerly g_* globals) */
    uint32_t DataSectionLba;
    uint8_t FatType; /* 12, 16, or 32 */
@@ -177,6 +297,9 @@ static inline FAT_Instance *fat_inst(const Partition *disk)
 /* Forward declarations for internal helpers */
 static uint32_t FAT_ClusterToLba(const FAT_Instance *inst, uint32_t cluster);
 static int FAT_ReadFat(FAT_Instance *inst, Partition *disk, size_t LBAIndex);
+static uint32_t FAT_NextCluster(FAT_Instance *inst, Partition *disk,
+                                uint32_t currentCluster);
+static void fat_fsinfo_store(FAT_Instance *inst, Partition *disk, bool dirty);
 
 static int FAT_ReadFat(FAT_Instance *inst, Partition *disk, size_t LBAIndex)
 {
@@ -185,16 +308,368 @@ static int FAT_ReadFat(FAT_Instance *inst, Partition *disk, size_t LBAIndex)
                                 FAT_CACHE_SIZE, inst->FatCache);
 }
 
+/* Volumes whose FAT exceeds this are served through the windowed FatCache
+ * instead of a whole-table copy (keeps huge FAT32 volumes from pinning
+ * megabytes of kernel heap). */
+#define FAT_TABLE_MAX_BYTES (1024u * 1024u)
+
+/* (Re)load the active FAT copy into inst->FatTable.  Called at mount time
+ * and again lazily after FAT_InvalidateCache.  Returns SUCCESS or -EIO;
+ * allocation failure silently leaves the table disabled. */
+static int fat_table_load(FAT_Instance *inst, Partition *disk)
+{
+   uint32_t bytes = inst->SectorsPerFat * SECTOR_SIZE;
+   if (bytes == 0 || bytes > FAT_TABLE_MAX_BYTES) return SUCCESS;
+
+   if (!inst->FatTable)
+   {
+      inst->FatTable = (uint8_t *)kmalloc(bytes);
+      if (!inst->FatTable) return SUCCESS;
+      inst->FatDirty = (uint8_t *)kmalloc(inst->SectorsPerFat);
+      if (!inst->FatDirty)
+      {
+         free(inst->FatTable);
+         inst->FatTable = NULL;
+         return SUCCESS;
+      }
+   }
+
+   for (uint32_t sector = 0; sector < inst->SectorsPerFat; sector += 8)
+   {
+      uint8_t run = (uint8_t)min(8u, inst->SectorsPerFat - sector);
+      if (Partition_ReadSectors(disk,
+                                inst->BS.BootSector.ReservedSectors + sector,
+                                run, inst->FatTable + sector * SECTOR_SIZE) < 0)
+      {
+         free(inst->FatTable);
+         free(inst->FatDirty);
+         inst->FatTable = NULL;
+         inst->FatDirty = NULL;
+         inst->FatTableValid = false;
+         return -EIO;
+      }
+   }
+
+   memset(inst->FatDirty, 0, inst->SectorsPerFat);
+   inst->FatDirtyCount = 0;
+   inst->FatTableValid = true;
+   return SUCCESS;
+}
+
+/* Write all dirty FAT table sectors back to every FAT copy on disk. */
+static int fat_table_flush(FAT_Instance *inst, Partition *disk)
+{
+   if (!inst->FatTable || !inst->FatTableValid || inst->FatDirtyCount == 0)
+      return SUCCESS;
+
+   for (uint32_t sector = 0; sector < inst->SectorsPerFat; sector++)
+   {
+      if (!inst->FatDirty[sector]) continue;
+
+      for (uint32_t fatIdx = 0; fatIdx < inst->BS.BootSector.FatCount; fatIdx++)
+      {
+         uint32_t lba = inst->BS.BootSector.ReservedSectors +
+                        fatIdx * inst->SectorsPerFat + sector;
+         if (Partition_WriteSectors(disk, lba, 1,
+                                    inst->FatTable + sector * SECTOR_SIZE) < 0)
+            return -EIO;
+      }
+      inst->FatDirty[sector] = 0;
+   }
+
+   inst->FatDirtyCount = 0;
+
+   /* The on-disk FAT is consistent again: persist the free-space
+    * summary clean so the next mount can skip the scan. */
+   fat_fsinfo_store(inst, disk, false);
+
+   return SUCCESS;
+}
+
+/* Ensure the in-memory FAT table is usable, reloading it if it was
+ * invalidated.  Returns SUCCESS when the table can be consulted. */
+static int fat_table_ensure(FAT_Instance *inst, Partition *disk)
+{
+   if (!inst->FatTable) return FAT_ESTATE;
+   if (!inst->FatTableValid)
+   {
+      if (fat_table_load(inst, disk) < 0 || !inst->FatTable) return FAT_ESTATE;
+   }
+   return SUCCESS;
+}
+
+/* Keep the free-cluster bitmap in step with a FAT entry write. */
+static inline void fat_free_bitmap_mark(FAT_Instance *inst, uint32_t cluster,
+                                        bool isFree)
+{
+   if (!inst->FreeBitmapValid || cluster < 2 || cluster >= inst->ClusterLimit)
+      return;
+
+   if (isFree)
+      inst->FreeBitmap[cluster / 8] |= (uint8_t)(1u << (cluster % 8));
+   else
+      inst->FreeBitmap[cluster / 8] &= (uint8_t)~(1u << (cluster % 8));
+}
+
+/* (Re)build the free-cluster bitmap from the FAT.  One pass at mount
+ * time (served from the in-memory table when present) replaces the
+ * per-allocation entry scans that used to grow with volume fill. */
+static void fat_free_bitmap_build(FAT_Instance *inst, Partition *disk)
+{
+   inst->FreeBitmapValid = false;
+   inst->ClusterLimit = (inst->TotalSectors - inst->DataSectionLba) /
+                        inst->BS.BootSector.SectorsPerCluster;
+   if (inst->ClusterLimit <= 2) return;
+
+   uint32_t bytes = (inst->ClusterLimit + 7) / 8;
+   if (!inst->FreeBitmap)
+   {
+      inst->FreeBitmap = (uint8_t *)kmalloc(bytes);
+      if (!inst->FreeBitmap) return; /* Linear-scan fallback stays in place */
+   }
+   memset(inst->FreeBitmap, 0, bytes);
+
+   uint32_t freeCount = 0;
+   for (uint32_t cluster = 2; cluster < inst->ClusterLimit; cluster++)
+   {
+      if (FAT_NextCluster(inst, disk, cluster) == 0)
+      {
+         inst->FreeBitmap[cluster / 8] |= (uint8_t)(1u << (cluster % 8));
+         freeCount++;
+      }
+   }
+
+   /* Keep a summary-provided hint when it is still in range. */
+   if (inst->FreeHint < 2 || inst->FreeHint >= inst->ClusterLimit)
+      inst->FreeHint = 2;
+   inst->FreeClusterCount = freeCount;
+   inst->FreeCountValid = true;
+   inst->FreeBitmapValid = true;
+}
+
+/* -------------------------------------------------------------------------
+ * Free-space summary (FAT32 FSInfo sector).
+ *
+ * Standard layout (lead/struct/trail signatures, free count at 488,
+ * next-free at 492) plus one byte of the reserved area used as a dirty
+ * flag: set before the first FAT mutation of a session, cleared when
+ * fat_table_flush persists the table.  A clean summary at mount gives
+ * the free count and allocation hint without reading the FAT.
+ * ---------------------------------------------------------------------- */
+
+#define FAT_FSINFO_LEAD_SIG 0x41615252u
+#define FAT_FSINFO_STRUCT_SIG 0x61417272u
+#define FAT_FSINFO_TRAIL_SIG 0xAA550000u
+#define FAT_FSINFO_DIRTY_OFF 8u /* Reserved-area byte we claim */
+#define FAT_FSINFO_STRUCT_OFF 484u
+#define FAT_FSINFO_FREE_OFF 488u
+#define FAT_FSINFO_NEXT_OFF 492u
+#define FAT_FSINFO_TRAIL_OFF 508u
+
+/* Partition-relative LBA of the FSInfo sector, or 0 when the volume has
+ * none (FAT12/16, or a bogus boot-sector field). */
+static uint32_t fat_fsinfo_lba(FAT_Instance *inst)
+{
+   if (inst->FatType != 32) return 0;
+
+   uint16_t sector = inst->BS.BootSector.ExtendedBootRecord.EBR32.FSInfoSector;
+   if (sector == 0 || sector == 0xFFFF ||
+       sector >= inst->BS.BootSector.ReservedSectors)
+      return 0;
+
+   return sector;
+}
+
+/* Adopt the on-disk summary.  Returns SUCCESS only when the signatures
+ * check out, the dirty flag is clear, and the values are in range; any
+ * failure means the caller scans the FAT as before. */
+static int fat_fsinfo_load(FAT_Instance *inst, Partition *disk)
+{
+   uint32_t lba = fat_fsinfo_lba(inst);
+   if (lba == 0) return FAT_ESTATE;
+
+   uint8_t sector[SECTOR_SIZE];
+   if (Partition_ReadSectors(disk, lba, 1, sector) < 0) return -EIO;
+
+   if (*(uint32_t *)(sector) != FAT_FSINFO_LEAD_SIG ||
+       *(uint32_t *)(sector + FAT_FSINFO_STRUCT_OFF) != FAT_FSINFO_STRUCT_SIG ||
+       *(uint32_t *)(sector + FAT_FSINFO_TRAIL_OFF) != FAT_FSINFO_TRAIL_SIG)
+      return FAT_ESTATE;
+
+   if (sector[FAT_FSINFO_DIRTY_OFF] != 0)
+   {
+      logfmt(LOG_WARNING,
+             "[FAT] FSInfo summary dirty (unclean shutdown); rescanning\n");
+      return FAT_ESTATE;
+   }
+
+   uint32_t freeCount = *(uint32_t *)(sector + FAT_FSINFO_FREE_OFF);
+   uint32_t nextFree = *(uint32_t *)(sector + FAT_FSINFO_NEXT_OFF);
+
+   if (freeCount > inst->ClusterLimit) return FAT_ESTATE;
+   if (nextFree < 2 || nextFree >= inst->ClusterLimit) return FAT_ESTATE;
+
+   inst->FreeClusterCount = freeCount;
+   inst->FreeCountValid = true;
+   inst->FreeHint = nextFree;
+   return SUCCESS;
+}
+
+/* Rewrite the on-disk summary.  `dirty` nonzero marks the volume
+ * in-use, so a crash before the clean rewrite invalidates the summary
+ * and the next mount rescans. */
+static void fat_fsinfo_store(FAT_Instance *inst, Partition *disk, bool dirty)
+{
+   uint32_t lba = fat_fsinfo_lba(inst);
+   if (lba == 0) return;
+
+   uint8_t sector[SECTOR_SIZE];
+   if (Partition_ReadSectors(disk, lba, 1, sector) < 0) return;
+
+   *(uint32_t *)(sector) = FAT_FSINFO_LEAD_SIG;
+   *(uint32_t *)(sector + FAT_FSINFO_STRUCT_OFF) = FAT_FSINFO_STRUCT_SIG;
+   *(uint32_t *)(sector + FAT_FSINFO_TRAIL_OFF) = FAT_FSINFO_TRAIL_SIG;
+   sector[FAT_FSINFO_DIRTY_OFF] = dirty ? 1 : 0;
+   *(uint32_t *)(sector + FAT_FSINFO_FREE_OFF) =
+       inst->FreeCountValid ? inst->FreeClusterCount : 0xFFFFFFFFu;
+   *(uint32_t *)(sector + FAT_FSINFO_NEXT_OFF) = inst->FreeHint;
+
+   if (Partition_WriteSectors(disk, lba, 1, sector) < 0) return;
+
+   inst->FsinfoDirty = dirty;
+}
+
+/* Keep the free-cluster count in step with a FAT entry transition. */
+static inline void fat_free_count_adjust(FAT_Instance *inst, uint32_t oldValue,
+                                         uint32_t newValue)
+{
+   if (!inst->FreeCountValid) return;
+
+   if (oldValue == 0 && newValue != 0)
+      inst->FreeClusterCount--;
+   else if (oldValue != 0 && newValue == 0)
+      inst->FreeClusterCount++;
+}
+
+/* Find a free cluster.  Pass the chain tail + 1 as `prefer` so file
+ * extensions land contiguously when possible; otherwise the search
+ * rotates from FreeHint through the bitmap, eight clusters per byte.
+ * Returns 0 when the volume is full.  The caller writes the FAT entry;
+ * FAT_WriteFatEntry clears the bitmap bit at that point. */
+static uint32_t fat_alloc_cluster(FAT_Instance *inst, Partition *disk,
+                                  uint32_t prefer)
+{
+   if (!inst->FreeBitmapValid) fat_free_bitmap_build(inst, disk);
+
+   if (inst->FreeBitmapValid)
+   {
+      if (prefer >= 2 && prefer < inst->ClusterLimit &&
+          ((inst->FreeBitmap[prefer / 8] >> (prefer % 8)) & 1u))
+      {
+         inst->FreeHint = prefer + 1;
+         return prefer;
+      }
+
+      uint32_t limit = inst->ClusterLimit;
+      uint32_t bytes = (limit + 7) / 8;
+      uint32_t start =
+          (inst->FreeHint >= 2 && inst->FreeHint < limit) ? inst->FreeHint : 2;
+      uint32_t startByte = start / 8;
+
+      /* i == bytes revisits the start byte so bits behind the hint are
+       * still found after a wrap. */
+      for (uint32_t i = 0; i <= bytes; i++)
+      {
+         uint32_t b = (startByte + i) % bytes;
+         uint8_t freeBits = inst->FreeBitmap[b];
+         while (freeBits)
+         {
+            uint32_t bit = (uint32_t)__builtin_ctz(freeBits);
+            freeBits &= (uint8_t)(freeBits - 1);
+
+            uint32_t cluster = b * 8 + bit;
+            if (cluster < 2 || cluster >= limit) continue;
+            if (i == 0 && cluster < start) continue;
+
+            inst->FreeHint = cluster + 1;
+            return cluster;
+         }
+      }
+      return 0;
+   }
+
+   /* No bitmap (allocation failed): the original linear entry scan. */
+   uint32_t limit = (inst->TotalSectors - inst->DataSectionLba) /
+                    inst->BS.BootSector.SectorsPerCluster;
+   for (uint32_t testCluster = 2; testCluster < limit; testCluster++)
+   {
+      if (FAT_NextCluster(inst, disk, testCluster) == 0) return testCluster;
+   }
+   return 0;
+}
+
+/* Find `count` contiguous free clusters, preferring a run anchored at
+ * `prefer` so file extensions stay sequential.  Returns the first
+ * cluster of the run or 0 when no contiguous run exists; callers then
+ * fall back to fat_alloc_cluster one cluster at a time.  Bits are
+ * cleared as the caller links the run through FAT_WriteFatEntry. */
+static uint32_t fat_alloc_run(FAT_Instance *inst, Partition *disk,
+                              uint32_t prefer, uint32_t count)
+{
+   if (count <= 1) return fat_alloc_cluster(inst, disk, prefer);
+
+   if (!inst->FreeBitmapValid) fat_free_bitmap_build(inst, disk);
+   if (!inst->FreeBitmapValid) return 0;
+
+   uint32_t limit = inst->ClusterLimit;
+   uint32_t anchored = (prefer >= 2 && prefer < limit) ? prefer : 2;
+
+   for (int attempt = 0; attempt < 2; attempt++)
+   {
+      uint32_t start = (attempt == 0) ? anchored : 2;
+      uint32_t run = 0;
+
+      for (uint32_t cluster = start; cluster < limit; cluster++)
+      {
+         if ((inst->FreeBitmap[cluster / 8] >> (cluster % 8)) & 1u)
+         {
+            if (++run == count)
+            {
+               inst->FreeHint = cluster + 1;
+               return cluster - count + 1;
+            }
+         }
+         else
+         {
+            /* The anchored pass only accepts a run starting exactly at
+             * `prefer`; any gap means it cannot, so rescan from 2. */
+            if (attempt == 0) break;
+            run = 0;
+         }
+      }
+   }
+
+   return 0;
+}
+
 static void FAT_Detect(FAT_Instance *inst)
 {
+   /* A zero 16-bit SectorsPerFat is definitive for FAT32 and must be
+    * checked before the cluster-count thresholds: large clusters shrink
+    * the cluster count, and a FAT32 volume formatted with 32-64 KB
+    * clusters can fall under the FAT12 threshold by count alone. */
+   if (inst->BS.BootSector.SectorsPerFat == 0)
+   {
+      inst->FatType = 32;
+      return;
+   }
+
    uint32_t dataClusters = (inst->TotalSectors - inst->DataSectionLba) /
                            inst->BS.BootSector.SectorsPerCluster;
    if (dataClusters < 0xFF5)
       inst->FatType = 12;
-   else if (inst->BS.BootSector.SectorsPerFat != 0)
-      inst->FatType = 16;
    else
-      inst->FatType = 32;
+      inst->FatType = 16;
 }
 
 FAT_Instance *FAT_Initialize(Partition *disk)
@@ -255,6 +730,26 @@ FAT_Instance *FAT_Initialize(Partition *disk)
       return NULL;
    }
 
+   /* Every buffer in this driver is SECTOR_SIZE bytes and all cluster
+    * I/O is sector-granular, so any power-of-two cluster size up to the
+    * 128-sector (64 KB) spec ceiling works without larger buffers; a
+    * non-512 sector size or an out-of-spec cluster does not. */
+   if (inst->BS.BootSector.BytesPerSector != SECTOR_SIZE)
+   {
+      logfmt(LOG_ERROR, "[FAT] Unsupported sector size %u (need %u)\n",
+             inst->BS.BootSector.BytesPerSector, SECTOR_SIZE);
+      free(inst);
+      return NULL;
+   }
+   uint8_t spcCheck = inst->BS.BootSector.SectorsPerCluster;
+   if ((spcCheck & (spcCheck - 1)) != 0 || spcCheck > 128)
+   {
+      logfmt(LOG_ERROR, "[FAT] Invalid cluster size (%u sectors)\n",
+             spcCheck);
+      free(inst);
+      return NULL;
+   }
+
    // Initialise FAT cache as invalid
    inst->FatCachePos = 0xFFFFFFFF;
 
@@ -368,6 +863,37 @@ FAT_Instance *FAT_Initialize(Partition *disk)
       inst->OpenedFiles[i].Truncated = false;
    }
 
+   /* Pull the whole active FAT into memory so cluster-chain traversal is
+    * served without disk I/O.  A failure here is not fatal — the windowed
+    * cache path still works. */
+   if (fat_table_load(inst, disk) == SUCCESS && inst->FatTable)
+   {
+      logfmt(LOG_INFO, "[FAT] In-memory FAT table: %u sectors (%u KiB)\n",
+             inst->SectorsPerFat, inst->SectorsPerFat * SECTOR_SIZE / 1024);
+   }
+
+   /* A clean on-disk summary supplies the free count and allocation
+    * hint, so the full-FAT scan (and the bitmap build) is deferred to
+    * the first allocation; dirty or absent summaries pay it here. */
+   inst->ClusterLimit = (inst->TotalSectors - inst->DataSectionLba) /
+                        inst->BS.BootSector.SectorsPerCluster;
+   if (fat_fsinfo_load(inst, disk) == SUCCESS)
+   {
+      logfmt(LOG_INFO,
+             "[FAT] FSInfo summary: free=%u hint=%u (mount scan skipped)\n",
+             inst->FreeClusterCount, inst->FreeHint);
+   }
+   else
+   {
+      fat_free_bitmap_build(inst, disk);
+      if (inst->FreeBitmapValid)
+      {
+         logfmt(LOG_INFO,
+                "[FAT] Free-cluster bitmap: %u clusters (%u bytes)\n",
+                inst->ClusterLimit, (inst->ClusterLimit + 7) / 8);
+      }
+   }
+
    return inst;
 }
 
@@ -390,6 +916,15 @@ static int FAT_WriteFatEntry(FAT_Instance *inst, Partition *disk,
       return -EINVAL;
    }
 
+   /* First mutation of this session: invalidate the on-disk summary so
+    * a crash before the next clean rewrite forces a rescan. */
+   if (!inst->FsinfoDirty) fat_fsinfo_store(inst, disk, true);
+
+   /* Old value feeds the free-count bookkeeping (a memory read while
+    * the in-memory table is loaded). */
+   uint32_t oldValue = 0;
+   if (inst->FreeCountValid) oldValue = FAT_NextCluster(inst, disk, cluster);
+
    uint32_t fatByteOffset;
    if (inst->FatType == 12)
       fatByteOffset = cluster * 3 / 2;
@@ -401,6 +936,51 @@ static int FAT_WriteFatEntry(FAT_Instance *inst, Partition *disk,
    uint32_t fatSectorOffset = fatByteOffset / SECTOR_SIZE;
    uint32_t fatByteOffsetInSector = fatByteOffset % SECTOR_SIZE;
 
+   /* Fast path: mutate the in-memory table and mark the covering sector(s)
+    * dirty.  fat_table_flush() writes them back to every FAT copy at the
+    * next persistence point (close / entry update / delete / truncate). */
+   if (fat_table_ensure(inst, disk) == SUCCESS)
+   {
+      if (inst->FatType == 12)
+      {
+         uint16_t raw = (uint16_t)(inst->FatTable[fatByteOffset] |
+                                   (inst->FatTable[fatByteOffset + 1] << 8));
+         if (cluster % 2 == 0)
+            raw = (raw & 0xF000) | (value & 0x0FFF);
+         else
+            raw = (raw & 0x000F) | ((value & 0x0FFF) << 4);
+         inst->FatTable[fatByteOffset] = (uint8_t)(raw & 0xFF);
+         inst->FatTable[fatByteOffset + 1] = (uint8_t)(raw >> 8);
+      }
+      else if (inst->FatType == 16)
+      {
+         *(uint16_t *)(inst->FatTable + fatByteOffset) = (uint16_t)value;
+      }
+      else // FAT32
+      {
+         uint32_t *entry = (uint32_t *)(inst->FatTable + fatByteOffset);
+         *entry = (*entry & 0xF0000000) | (value & 0x0FFFFFFF);
+      }
+
+      if (!inst->FatDirty[fatSectorOffset])
+      {
+         inst->FatDirty[fatSectorOffset] = 1;
+         inst->FatDirtyCount++;
+      }
+      if (inst->FatType == 12 && fatByteOffsetInSector == SECTOR_SIZE - 1 &&
+          !inst->FatDirty[fatSectorOffset + 1])
+      {
+         inst->FatDirty[fatSectorOffset + 1] = 1;
+         inst->FatDirtyCount++;
+      }
+
+      /* Keep the legacy window coherent in case a fallback read follows. */
+      inst->FatCachePos = 0xFFFFFFFF;
+      fat_free_bitmap_mark(inst, cluster, value == 0);
+      fat_free_count_adjust(inst, oldValue, value);
+      return SUCCESS;
+   }
+
    // Iterate over all FAT copies
    for (uint32_t fatIdx = 0; fatIdx < inst->BS.BootSector.FatCount; fatIdx++)
    {
@@ -490,9 +1070,75 @@ static int FAT_WriteFatEntry(FAT_Instance *inst, Partition *disk,
       if (inst->FatType == 12) inst->FatCachePos = 0xFFFFFFFF;
    }
 
+   fat_free_bitmap_mark(inst, cluster, value == 0);
+   fat_free_count_adjust(inst, oldValue, value);
    return SUCCESS;
 }
 
+/* -------------------------------------------------------------------------
+ * Path-lookup (dentry) cache.
+ *
+ * FAT_Open re-walks every path component with one directory scan each,
+ * which dominates open cost for paths opened over and over (shell
+ * startup, metadata file).  The cache maps a normalized absolute path to
+ * the directory entry the walk would have produced, plus the parent
+ * bookkeeping FAT_OpenEntry needs, and also remembers misses.
+ * ---------------------------------------------------------------------- */
+
+static void fat_dcache_purge(FAT_Instance *inst)
+{
+   for (int i = 0; i < FAT_DCACHE_SIZE; i++) inst->DirCache[i].Valid = false;
+}
+
+static FAT_DirCacheEntry *fat_dcache_find(FAT_Instance *inst, const char *path)
+{
+   for (int i = 0; i < FAT_DCACHE_SIZE; i++)
+   {
+      FAT_DirCacheEntry *c = &inst->DirCache[i];
+      if (c->Valid && strcmp(c->Path, path) == 0)
+      {
+         c->LastUsed = ++inst->DirCacheTick;
+         return c;
+      }
+   }
+   return NULL;
+}
+
+/* entry == NULL records a negative (path-does-not-exist) slot.  Replaces
+ * the least recently used slot when all are taken. */
+static void fat_dcache_store(FAT_Instance *inst, const char *path,
+                             const FAT_DirectoryEntry *entry,
+                             uint32_t parentCluster, bool parentIsRoot)
+{
+   if (strlen(path) >= MAX_PATH_SIZE) return;
+
+   FAT_DirCacheEntry *victim = &inst->DirCache[0];
+   for (int i = 0; i < FAT_DCACHE_SIZE; i++)
+   {
+      FAT_DirCacheEntry *c = &inst->DirCache[i];
+      if (c->Valid && strcmp(c->Path, path) == 0)
+      {
+         victim = c;
+         break;
+      }
+      if (!c->Valid)
+      {
+         victim = c;
+         break;
+      }
+      if (c->LastUsed < victim->LastUsed) victim = c;
+   }
+
+   strncpy(victim->Path, path, MAX_PATH_SIZE - 1);
+   victim->Path[MAX_PATH_SIZE - 1] = '\0';
+   victim->Negative = (entry == NULL);
+   if (entry) victim->Entry = *entry;
+   victim->ParentCluster = parentCluster;
+   victim->ParentIsRoot = parentIsRoot;
+   victim->LastUsed = ++inst->DirCacheTick;
+   victim->Valid = true;
+}
+
 static FAT_File *FAT_OpenEntry(FAT_Instance *inst, Partition *disk,
                                FAT_DirectoryEntry *entry, FAT_FileData *parent)
 {
@@ -550,6 +1196,19 @@ static FAT_File *FAT_OpenEntry(FAT_Instance *inst, Partition *disk,
    fd->CurrentCluster = fd->FirstCluster;
    fd->CurrentSectorInCluster = 0;
 
+   /* Fresh handle: read-ahead state starts disarmed, extent map empty. */
+   fd->LastReadEnd = 0;
+   fd->SeqStreak = 0;
+   fd->PrefetchWindow = FAT_READAHEAD_MIN;
+   fd->PrefetchCluster = 0;
+   fd->ExtentCount = 0;
+
+   /* A previous occupant's scan buffer may survive a forced close
+    * (FAT_InvalidateCache flips Opened without going through
+    * FAT_Close); keep the allocation but drop its contents. */
+   fd->DirBufferBytes = 0;
+   fd->DirBufferPos = 0;
+
    /* Skip the initial sector read only when the entry has no data cluster.
     * Directories frequently have Size=0 on FAT but still require reading their
     * first cluster for iteration. */
@@ -583,6 +1242,75 @@ static FAT_File *FAT_OpenEntry(FAT_Instance *inst, Partition *disk,
    return &fd->Public;
 }
 
+/* -------------------------------------------------------------------------
+ * Per-file extent map.
+ *
+ * Chain walks record every (index, cluster) pair they resolve; contiguous
+ * continuations extend the most recent run, breaks in contiguity append a
+ * new one.  Because walks always resume from a mapped point (or index 0),
+ * coverage stays gapless and sorted, which is what the binary search in
+ * fat_extent_lookup relies on.
+ * ---------------------------------------------------------------------- */
+
+static void fat_extent_record(FAT_FileData *fd, uint32_t index,
+                              uint32_t cluster)
+{
+   if (fd->ExtentCount > 0)
+   {
+      FAT_Extent *last = &fd->Extents[fd->ExtentCount - 1];
+      uint32_t end = last->StartIndex + last->Length;
+
+      if (index < end) return; /* Already mapped */
+      if (index == end && cluster == last->StartCluster + last->Length)
+      {
+         last->Length++;
+         return;
+      }
+      /* A gap means the map filled up earlier; stop learning so the
+       * sorted/gapless invariant holds. */
+      if (index > end) return;
+   }
+
+   if (fd->ExtentCount >= FAT_EXTENT_MAX) return;
+
+   FAT_Extent *e = &fd->Extents[fd->ExtentCount++];
+   e->StartIndex = index;
+   e->StartCluster = cluster;
+   e->Length = 1;
+}
+
+/* Find the furthest mapped chain position at or before targetIndex.
+ * Returns 0 and fills indexOut/clusterOut on a hit, -1 when the map is
+ * empty. */
+static int fat_extent_lookup(const FAT_FileData *fd, uint32_t targetIndex,
+                             uint32_t *indexOut, uint32_t *clusterOut)
+{
+   int lo = 0;
+   int hi = (int)fd->ExtentCount - 1;
+   int best = -1;
+
+   while (lo <= hi)
+   {
+      int mid = (lo + hi) / 2;
+      if (fd->Extents[mid].StartIndex <= targetIndex)
+      {
+         best = mid;
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid - 1;
+      }
+   }
+   if (best < 0) return -1;
+
+   const FAT_Extent *e = &fd->Extents[best];
+   uint32_t offset = min(targetIndex - e->StartIndex, e->Length - 1);
+   *indexOut = e->StartIndex + offset;
+   *clusterOut = e->StartCluster + offset;
+   return 0;
+}
+
 static uint32_t FAT_NextCluster(FAT_Instance *inst, Partition *disk,
                                 uint32_t currentCluster)
 {
@@ -595,6 +1323,29 @@ static uint32_t FAT_NextCluster(FAT_Instance *inst, Partition *disk,
    else /* FAT32 */
       fatIndex = currentCluster * 4;
 
+   /* Fast path: whole FAT resident in memory — no I/O, no windowing. */
+   if (fat_table_ensure(inst, disk) == SUCCESS)
+   {
+      uint32_t nextCluster;
+      if (inst->FatType == 12)
+      {
+         uint16_t raw = (uint16_t)(inst->FatTable[fatIndex] |
+                                   (inst->FatTable[fatIndex + 1] << 8));
+         nextCluster = (currentCluster % 2 == 0) ? (raw & 0x0fff) : (raw >> 4);
+         if (nextCluster >= 0xff8) nextCluster |= 0xfffff000;
+      }
+      else if (inst->FatType == 16)
+      {
+         nextCluster = *(uint16_t *)(inst->FatTable + fatIndex);
+         if (nextCluster >= 0xfff8) nextCluster |= 0xffff0000;
+      }
+      else /* FAT32 */
+      {
+         nextCluster = *(uint32_t *)(inst->FatTable + fatIndex) & 0x0FFFFFFF;
+      }
+      return nextCluster;
+   }
+
    uint32_t fatIndexSector = fatIndex / SECTOR_SIZE;
    if (fatIndexSector < inst->FatCachePos ||
        fatIndexSector >= inst->FatCachePos + FAT_CACHE_SIZE)
@@ -633,6 +1384,153 @@ static uint32_t FAT_NextCluster(FAT_Instance *inst, Partition *disk,
    return nextCluster;
 }
 
+static inline uint32_t fat_meta_bucket(const uint8_t *hash)
+{
+   uint32_t key = (uint32_t)hash[0] | ((uint32_t)hash[1] << 8) |
+                  ((uint32_t)hash[2] << 16) | ((uint32_t)hash[3] << 24);
+   return key & (FAT_META_INDEX_BUCKETS - 1);
+}
+
+static FAT_MetaIndexEntry *fat_meta_index_find(FAT_Instance *inst,
+                                               const uint8_t *hash)
+{
+   for (FAT_MetaIndexEntry *e = inst->MetaIndex[fat_meta_bucket(hash)]; e;
+        e = e->Next)
+   {
+      if (memcmp(e->Hash, hash, SHA1_DIGEST_SIZE) == 0) return e;
+   }
+   return NULL;
+}
+
+static void fat_meta_index_drop(FAT_Instance *inst)
+{
+   for (uint32_t b = 0; b < FAT_META_INDEX_BUCKETS; b++)
+   {
+      FAT_MetaIndexEntry *e = inst->MetaIndex[b];
+      while (e)
+      {
+         FAT_MetaIndexEntry *next = e->Next;
+         free(e);
+         e = next;
+      }
+      inst->MetaIndex[b] = NULL;
+   }
+   inst->MetaIndexValid = false;
+   inst->MetaLiveCount = 0;
+   inst->MetaRecordCount = 0;
+}
+
+/* Insert or overwrite the latest record for its path hash. */
+static int fat_meta_index_update(FAT_Instance *inst, const uint8_t *hash,
+                                 const FAT_MetadataRecord *rec)
+{
+   FAT_MetaIndexEntry *e = fat_meta_index_find(inst, hash);
+   if (e)
+   {
+      e->Record = *rec;
+      return SUCCESS;
+   }
+
+   e = (FAT_MetaIndexEntry *)kmalloc(sizeof(FAT_MetaIndexEntry));
+   if (!e) return -ENOMEM;
+
+   memcpy(e->Hash, hash, SHA1_DIGEST_SIZE);
+   e->Record = *rec;
+
+   uint32_t b = fat_meta_bucket(hash);
+   e->Next = inst->MetaIndex[b];
+   inst->MetaIndex[b] = e;
+   inst->MetaLiveCount++;
+   return SUCCESS;
+}
+
+/* Build the index with one linear pass over the sidecar; later records
+ * for the same path overwrite earlier ones, exactly like the scan the
+ * index replaces.  A missing sidecar yields a valid empty index. */
+static void fat_meta_index_ensure(FAT_Instance *inst, Partition *disk)
+{
+   if (inst->MetaIndexValid || inst->MetaIndexDisabled) return;
+
+   FAT_File *meta = FAT_Open(disk, FAT_METADATA_PATH);
+   if (!meta)
+   {
+      inst->MetaIndexValid = true;
+      return;
+   }
+
+   if (meta->Handle == ROOT_DIRECTORY_HANDLE || meta->IsDirectory ||
+       FAT_Seek(disk, meta, 0) < 0)
+   {
+      if (meta->Handle != ROOT_DIRECTORY_HANDLE) FAT_Close(meta);
+      return; /* Stays invalid; the linear scan keeps working */
+   }
+
+   FAT_MetadataRecord rec;
+   while (FAT_Read(disk, meta, sizeof(rec), &rec) == sizeof(rec))
+   {
+      inst->MetaRecordCount++;
+      if ((rec.Flags & FAT_METADATA_FLAG_VALID) == 0) continue;
+      if (fat_meta_index_update(inst, rec.Hash, &rec) < 0)
+      {
+         FAT_Close(meta);
+         fat_meta_index_drop(inst);
+         inst->MetaIndexDisabled = true;
+         logfmt(LOG_WARNING, "[FAT] metadata index disabled: nomem\n");
+         return;
+      }
+   }
+
+   FAT_Close(meta);
+   inst->MetaIndexValid = true;
+   logfmt(LOG_INFO, "[FAT] metadata index: records=%u paths=%u\n",
+          inst->MetaRecordCount, inst->MetaLiveCount);
+}
+
+/* Rewrite the sidecar with only the latest record per path once at
+ * least half the file is superseded history.  The first FAT_Write at
+ * position 0 auto-truncates, so the rewrite reuses the normal path. */
+static void fat_meta_maybe_compact(FAT_Instance *inst, Partition *disk)
+{
+   if (!inst->MetaIndexValid) return;
+   if (inst->MetaRecordCount < FAT_META_COMPACT_MIN) return;
+   if (inst->MetaRecordCount < inst->MetaLiveCount * 2) return;
+
+   FAT_File *meta = FAT_Open(disk, FAT_METADATA_PATH);
+   if (!meta) return;
+   if (meta->Handle == ROOT_DIRECTORY_HANDLE || meta->IsDirectory ||
+       FAT_Seek(disk, meta, 0) < 0)
+   {
+      if (meta->Handle != ROOT_DIRECTORY_HANDLE) FAT_Close(meta);
+      return;
+   }
+
+   uint32_t written = 0;
+   for (uint32_t b = 0; b < FAT_META_INDEX_BUCKETS; b++)
+   {
+      for (FAT_MetaIndexEntry *e = inst->MetaIndex[b]; e; e = e->Next)
+      {
+         if (FAT_Write(disk, meta, sizeof(e->Record), &e->Record) !=
+             sizeof(e->Record))
+         {
+            /* Partial rewrite: the file no longer matches the index.
+             * Drop the index; the next access rebuilds it from
+             * whatever survived on disk. */
+            FAT_Close(meta);
+            fat_meta_index_drop(inst);
+            logfmt(LOG_ERROR, "[FAT] metadata compaction failed at %u\n",
+                   written);
+            return;
+         }
+         written++;
+      }
+   }
+
+   FAT_Close(meta);
+   logfmt(LOG_INFO, "[FAT] metadata compacted: records=%u -> %u\n",
+          inst->MetaRecordCount, written);
+   inst->MetaRecordCount = written;
+}
+
 static int fat_metadata_append_record_full(Partition *disk, const char *path,
                                            uint16_t mode, uint32_t uid,
                                            uint32_t gid, uint8_t flags)
@@ -672,7 +1570,30 @@ static int fat_metadata_append_record_full(Partition *disk, const char *path,
 
    uint32_t written = FAT_Write(disk, meta, sizeof(record), &record);
    FAT_Close(meta);
-   return (written == sizeof(record)) ? SUCCESS : -EIO;
+   if (written != sizeof(record)) return -EIO;
+
+   /* Mirror the append into the index and compact the sidecar when
+    * superseded history dominates it. */
+   FAT_Instance *inst = fat_inst(disk);
+   if (inst)
+   {
+      fat_meta_index_ensure(inst, disk);
+      if (inst->MetaIndexValid)
+      {
+         inst->MetaRecordCount++;
+         if (fat_meta_index_update(inst, record.Hash, &record) < 0)
+         {
+            fat_meta_index_drop(inst);
+            inst->MetaIndexDisabled = true;
+         }
+         else
+         {
+            fat_meta_maybe_compact(inst, disk);
+         }
+      }
+   }
+
+   return SUCCESS;
 }
 
 static int fat_metadata_append_record(Partition *disk, const char *path,
@@ -697,6 +1618,21 @@ static int fat_metadata_lookup_latest(Partition *disk, const char *path,
    uint8_t hash[SHA1_DIGEST_SIZE];
    SHA1_Calculate(normalizedPath, strlen(normalizedPath), hash);
 
+   /* Fast path: serve the latest record straight from the index.  An
+    * index miss is authoritative - the path has no metadata. */
+   FAT_Instance *inst = fat_inst(disk);
+   if (inst)
+   {
+      fat_meta_index_ensure(inst, disk);
+      if (inst->MetaIndexValid)
+      {
+         FAT_MetaIndexEntry *e = fat_meta_index_find(inst, hash);
+         if (e && recordOut) *recordOut = e->Record;
+         if (foundOut) *foundOut = (e != NULL);
+         return SUCCESS;
+      }
+   }
+
    FAT_File *meta = FAT_Open(disk, FAT_METADATA_PATH);
    if (!meta)
    {
@@ -790,6 +1726,68 @@ static int fat_chown_path(Partition *disk, const char *path, uint32_t uid,
    return fat_metadata_append_record_full(disk, path, mode, uid, gid, 0);
 }
 
+/* Detect sequential consumption of a file and pull the next window of
+ * clusters through Partition_ReadSectors, which lands them in the block
+ * cache so the per-sector reads below become cache hits.  The FAT chain
+ * walk itself is free thanks to the in-memory FAT table. */
+static void fat_readahead(FAT_Instance *inst, Partition *disk,
+                          FAT_FileData *fd)
+{
+   if (fd->Public.IsDirectory) return;
+   if (fd->FirstCluster < 2) return;
+
+   if (fd->Public.Position == fd->LastReadEnd && fd->Public.Position != 0)
+   {
+      fd->SeqStreak++;
+   }
+   else
+   {
+      fd->SeqStreak = 1;
+      fd->PrefetchWindow = FAT_READAHEAD_MIN;
+      fd->PrefetchCluster = 0;
+   }
+
+   if (fd->SeqStreak < 2) return;
+
+   uint32_t eofMarker = (inst->FatType == 12)   ? 0xFF8
+                        : (inst->FatType == 16) ? 0xFFF8
+                                                : 0x0FFFFFF8;
+   uint32_t cluster = (fd->PrefetchCluster >= 2) ? fd->PrefetchCluster
+                                                 : fd->CurrentCluster;
+   if (cluster < 2 || cluster >= eofMarker) return;
+
+   uint32_t spc = inst->BS.BootSector.SectorsPerCluster;
+   uint8_t *scratch = (uint8_t *)kmalloc(spc * SECTOR_SIZE);
+   if (!scratch) return;
+
+   uint32_t window = (fd->PrefetchWindow >= FAT_READAHEAD_MIN)
+                         ? fd->PrefetchWindow
+                         : FAT_READAHEAD_MIN;
+
+   /* Large-cluster volumes hit the byte budget before the cluster
+    * ceiling; never pull more than FAT_READAHEAD_MAX_BYTES per trigger. */
+   uint32_t byteCap = FAT_READAHEAD_MAX_BYTES / (spc * SECTOR_SIZE);
+   if (byteCap == 0) byteCap = 1;
+   if (window > byteCap) window = byteCap;
+
+   for (uint32_t n = 0; n < window; n++)
+   {
+      uint32_t next = FAT_NextCluster(inst, disk, cluster);
+      if (next < 2 || next >= eofMarker) break;
+
+      if (Partition_ReadSectors(disk, FAT_ClusterToLba(inst, next), spc,
+                                scratch) < 0)
+         break;
+      cluster = next;
+   }
+   free(scratch);
+
+   fd->PrefetchCluster = cluster;
+
+   /* The pattern held for another call — widen the window. */
+   if (fd->PrefetchWindow < FAT_READAHEAD_MAX) fd->PrefetchWindow *= 2;
+}
+
 uint32_t FAT_Read(Partition *disk, FAT_File *file, uint32_t byteCount,
                   void *dataOut)
 {
@@ -844,6 +1842,97 @@ uint32_t FAT_Read(Partition *disk, FAT_File *file, uint32_t byteCount,
       }
    }
 
+   fat_readahead(inst, disk, fd);
+
+   /* Bulk fast path: with the position sector-aligned and at least one
+    * whole sector wanted, read sector runs straight into the caller's
+    * buffer instead of staging every sector through fd->Buffer.  Runs
+    * extend across physically contiguous clusters, so a large
+    * sequential read costs a handful of multi-sector requests and one
+    * copy per byte (cache hit) or none (device PIO into the buffer). */
+   if (fd->Public.Handle != ROOT_DIRECTORY_HANDLE &&
+       !fd->Public.IsDirectory && fd->Public.Size > 0)
+   {
+      uint32_t secPerClus = inst->BS.BootSector.SectorsPerCluster;
+      uint32_t clusterBytes = secPerClus * SECTOR_SIZE;
+      uint32_t eofMarker = (inst->FatType == 12)   ? 0xFF8
+                           : (inst->FatType == 16) ? 0xFFF8
+                                                   : 0x0FFFFFF8;
+      bool didBulk = false;
+
+      while (byteCount >= SECTOR_SIZE &&
+             fd->Public.Position % SECTOR_SIZE == 0 &&
+             fd->CurrentCluster >= 2 && fd->CurrentCluster < eofMarker)
+      {
+         uint32_t want = byteCount / SECTOR_SIZE;
+         uint32_t runStart = FAT_ClusterToLba(inst, fd->CurrentCluster) +
+                             fd->CurrentSectorInCluster;
+         uint32_t run = min(want, secPerClus - fd->CurrentSectorInCluster);
+
+         /* Extend the run across physically contiguous clusters. */
+         uint32_t tail = fd->CurrentCluster;
+         while (run < want)
+         {
+            uint32_t next = FAT_NextCluster(inst, disk, tail);
+            if (next != tail + 1) break;
+            tail = next;
+            run += min(want - run, secPerClus);
+         }
+
+         if (Partition_ReadSectors(disk, runStart, run, u8DataOut) < 0)
+         {
+            logfmt(LOG_ERROR, "[FAT] read error!\n");
+            fd->LastReadEnd = fd->Public.Position;
+            return u8DataOut - (uint8_t *)dataOut;
+         }
+
+         uint32_t idx = fd->Public.Position / clusterBytes;
+         u8DataOut += run * SECTOR_SIZE;
+         fd->Public.Position += run * SECTOR_SIZE;
+         byteCount -= run * SECTOR_SIZE;
+         didBulk = true;
+
+         /* Walk the chain state forward past the consumed sectors,
+          * learning extents along the way like the per-sector path. */
+         uint32_t sec = fd->CurrentSectorInCluster + run;
+         while (sec >= secPerClus)
+         {
+            sec -= secPerClus;
+            uint32_t next = FAT_NextCluster(inst, disk, fd->CurrentCluster);
+            if (next < 2 || next >= eofMarker)
+            {
+               fd->CurrentCluster = next;
+               if (byteCount > 0)
+               {
+                  /* Chain ended before Size said it would - treat as
+                   * EOF like the per-sector path does. */
+                  fd->Public.Size = fd->Public.Position;
+                  byteCount = 0;
+               }
+               break;
+            }
+            fd->CurrentCluster = next;
+            fat_extent_record(fd, ++idx, next);
+         }
+         fd->CurrentSectorInCluster = sec;
+      }
+
+      /* The per-sector path (and the next call) expect fd->Buffer to
+       * hold the sector covering Position - restore that invariant. */
+      if (didBulk && fd->CurrentCluster >= 2 && fd->CurrentCluster < eofMarker)
+      {
+         if (Partition_ReadSectors(disk,
+                                   FAT_ClusterToLba(inst, fd->CurrentCluster) +
+                                       fd->CurrentSectorInCluster,
+                                   1, fd->Buffer) < 0)
+         {
+            logfmt(LOG_ERROR, "[FAT] read error!\n");
+            fd->LastReadEnd = fd->Public.Position;
+            return u8DataOut - (uint8_t *)dataOut;
+         }
+      }
+   }
+
    uint32_t loop_counter = 0; // reset per read call
 
    while (byteCount > 0)
@@ -945,6 +2034,11 @@ uint32_t FAT_Read(Partition *disk, FAT_File *file, uint32_t byteCount,
                }
 
                fd->CurrentCluster = next;
+               fat_extent_record(fd,
+                                 fd->Public.Position /
+                                     (inst->BS.BootSector.SectorsPerCluster *
+                                      SECTOR_SIZE),
+                                 next);
             }
 
             // Check for end-of-chain based on FAT type
@@ -972,6 +2066,8 @@ uint32_t FAT_Read(Partition *disk, FAT_File *file, uint32_t byteCount,
       }
    }
 
+   fd->LastReadEnd = fd->Public.Position;
+
    return u8DataOut - (uint8_t *)dataOut;
 }
 
@@ -982,6 +2078,53 @@ int FAT_ReadEntry(Partition *disk, FAT_File *file, FAT_DirectoryEntry *dirEntry)
    return (bytes_read == sizeof(FAT_DirectoryEntry)) ? SUCCESS : -ENOENT;
 }
 
+/* Bytes pulled per directory-buffer refill.  At least one cluster on
+ * the common 1-8 sectors/cluster geometries; 128 entries per refill, so
+ * scanning a 1000-entry directory costs 8 bulk reads instead of 1000
+ * per-entry FAT_Read calls. */
+#define FAT_DIRBUF_SIZE 4096u
+
+/* Serve the next directory entry from the handle's scan buffer,
+ * refilling it with one bulk FAT_Read when it runs dry.  The buffer is
+ * only trusted while the handle's position still matches what the last
+ * refill left behind; if anyone moved the handle in between (FAT_Seek,
+ * a plain FAT_Read) the next call transparently refills from the new
+ * position.  Drop-in replacement for FAT_ReadEntry in scan loops. */
+static int fat_dir_next_entry(Partition *disk, FAT_File *dir,
+                              FAT_DirectoryEntry *entryOut)
+{
+   FAT_Instance *inst = (FAT_Instance *)dir->instance;
+   if (!inst) return -EINVAL;
+
+   FAT_FileData *fd = (dir->Handle == ROOT_DIRECTORY_HANDLE)
+                          ? &inst->RootDirectory
+                          : &inst->OpenedFiles[dir->Handle];
+
+   if (fd->DirBufferPos >= fd->DirBufferBytes ||
+       dir->Position != fd->DirBufferEnd)
+   {
+      if (!fd->DirBuffer)
+      {
+         fd->DirBuffer = kmalloc(FAT_DIRBUF_SIZE);
+         // No memory for the buffer: fall back to entry-at-a-time reads
+         if (!fd->DirBuffer) return FAT_ReadEntry(disk, dir, entryOut);
+      }
+
+      uint32_t got = FAT_Read(disk, dir, FAT_DIRBUF_SIZE, fd->DirBuffer);
+      got -= got % (uint32_t)sizeof(FAT_DirectoryEntry);
+      if (got == 0) return -ENOENT;
+
+      fd->DirBufferBytes = got;
+      fd->DirBufferPos = 0;
+      fd->DirBufferEnd = dir->Position;
+   }
+
+   memcpy(entryOut, fd->DirBuffer + fd->DirBufferPos,
+          sizeof(FAT_DirectoryEntry));
+   fd->DirBufferPos += sizeof(FAT_DirectoryEntry);
+   return SUCCESS;
+}
+
 void FAT_Close(FAT_File *file)
 {
    if (!file) return;
@@ -993,6 +2136,9 @@ void FAT_Close(FAT_File *file)
    {
       file->Position = 0;
       inst->RootDirectory.CurrentCluster = inst->RootDirectory.FirstCluster;
+      // The root handle is permanent; keep the buffer, drop its contents
+      inst->RootDirectory.DirBufferBytes = 0;
+      inst->RootDirectory.DirBufferPos = 0;
    }
    else
    {
@@ -1003,7 +2149,15 @@ void FAT_Close(FAT_File *file)
                 file->Handle);
          return;
       }
-      inst->OpenedFiles[file->Handle].Opened = false;
+      FAT_FileData *fd = &inst->OpenedFiles[file->Handle];
+      if (fd->DirBuffer)
+      {
+         free(fd->DirBuffer);
+         fd->DirBuffer = NULL;
+      }
+      fd->DirBufferBytes = 0;
+      fd->DirBufferPos = 0;
+      fd->Opened = false;
    }
 }
 
@@ -1052,7 +2206,7 @@ int FAT_FindFile(Partition *disk, FAT_File *file, const char *name,
          fatName[i + 8] = toupper(ext[i + 1]);
    }
 
-   while (FAT_ReadEntry(disk, file, &entry) == SUCCESS)
+   while (fat_dir_next_entry(disk, file, &entry) == SUCCESS)
    {
       // FAT end marker: empty entry means end of directory
       if (entry.Name[0] == 0x00) break;
@@ -1102,6 +2256,35 @@ FAT_File *FAT_Open(Partition *disk, const char *path)
       return &inst->RootDirectory.Public;
    }
 
+   /* Fast path: serve the lookup from the dentry cache.  A negative hit
+    * short-circuits the whole walk for paths known to be absent. */
+   FAT_DirCacheEntry *cached = fat_dcache_find(inst, normalizedPath);
+   if (cached)
+   {
+      if (cached->Negative)
+      {
+         free(normalizedPath);
+         free(name);
+         return NULL;
+      }
+
+      FAT_File *cachedOpen = FAT_OpenEntry(inst, disk, &cached->Entry, NULL);
+      if (cachedOpen)
+      {
+         if (cachedOpen->Handle != ROOT_DIRECTORY_HANDLE)
+         {
+            FAT_FileData *cfd = &inst->OpenedFiles[cachedOpen->Handle];
+            cfd->ParentCluster = cached->ParentCluster;
+            cfd->ParentIsRoot = cached->ParentIsRoot;
+         }
+         free(normalizedPath);
+         free(name);
+         return cachedOpen;
+      }
+      /* Cached open failed (out of handles / read error); fall back to
+       * the full walk below. */
+   }
+
    FAT_File *current = &inst->RootDirectory.Public;
    FAT_File *previous = NULL;
 
@@ -1149,6 +2332,11 @@ FAT_File *FAT_Open(Partition *disk, const char *path)
                                         ? &inst->RootDirectory
                                         : &inst->OpenedFiles[current->Handle];
 
+         if (isLast)
+            fat_dcache_store(inst, normalizedPath, &entry,
+                             parentData->FirstCluster,
+                             parentData == &inst->RootDirectory);
+
          previous = current;
          current = FAT_OpenEntry(inst, disk, &entry, parentData);
       }
@@ -1169,6 +2357,7 @@ FAT_File *FAT_Open(Partition *disk, const char *path)
             }
 
             logfmt(LOG_INFO, "[FAT] %s not found\n", name);
+            fat_dcache_store(inst, normalizedPath, NULL, 0, false);
             free(normalizedPath);
             free(name);
             return NULL;
@@ -1263,8 +2452,13 @@ int FAT_Seek(Partition *disk, FAT_File *file, uint32_t position)
          uint32_t clusterIndex = position / clusterBytes;
          uint32_t sectorInCluster = (position % clusterBytes) / bytesPerSector;
 
+         /* Resume the chain walk from the closest mapped point rather
+          * than the first cluster. */
+         uint32_t i = 0;
          uint32_t cluster = fd->FirstCluster;
-         for (uint32_t i = 0; i < clusterIndex; i++)
+         fat_extent_record(fd, 0, cluster);
+         fat_extent_lookup(fd, clusterIndex, &i, &cluster);
+         for (; i < clusterIndex; i++)
          {
             cluster = FAT_NextCluster(inst, disk, cluster);
             uint32_t eofMarker = 0xFFFFFFF8;
@@ -1273,6 +2467,7 @@ int FAT_Seek(Partition *disk, FAT_File *file, uint32_t position)
                fd->Public.Size = fd->Public.Position;
                return -EIO;
             }
+            fat_extent_record(fd, i + 1, cluster);
          }
 
          fd->CurrentCluster = cluster;
@@ -1335,9 +2530,12 @@ int FAT_Seek(Partition *disk, FAT_File *file, uint32_t position)
       uint32_t clusterIndex = position / clusterBytes;
       uint32_t sectorInCluster = (position % clusterBytes) / bytesPerSector;
 
-      // walk cluster chain clusterIndex times from first cluster
+      // walk cluster chain from the closest point the extent map resolves
+      uint32_t i = 0;
       uint32_t c = fd->FirstCluster;
-      for (uint32_t i = 0; i < clusterIndex; i++)
+      fat_extent_record(fd, 0, c);
+      fat_extent_lookup(fd, clusterIndex, &i, &c);
+      for (; i < clusterIndex; i++)
       {
          c = FAT_NextCluster(inst, disk, c);
          uint32_t eofMarker = (inst->FatType == 12)   ? 0xFF8
@@ -1351,6 +2549,7 @@ int FAT_Seek(Partition *disk, FAT_File *file, uint32_t position)
                    "[FAT] FAT_Seek: reached end of cluster chain\n");
             return -EIO;
          }
+         fat_extent_record(fd, i + 1, c);
       }
 
       fd->CurrentCluster = c;
@@ -1575,51 +2774,80 @@ uint32_t FAT_Write(Partition *disk, FAT_File *file, uint32_t byteCount,
 
             if (nextCluster >= eofMarker)
             {
-               // Allocate new cluster
-               uint32_t newCluster = 0;
-               uint32_t maxClusters =
-                   (inst->TotalSectors - inst->DataSectionLba) /
+               uint32_t eofVal = (inst->FatType == 12)   ? 0x0FFF
+                                 : (inst->FatType == 16) ? 0xFFFF
+                                                         : 0x0FFFFFFF;
+
+               /* Allocate every cluster the rest of this request needs
+                  in one go, preferring a contiguous extent right after
+                  the chain tail.  The run is linked once, so later
+                  sector advances walk the chain without revisiting the
+                  allocator, and the file comes out unfragmented. */
+               uint32_t bytesPerCluster =
+                   (uint32_t)SECTOR_SIZE *
                    inst->BS.BootSector.SectorsPerCluster;
+               uint32_t runLen =
+                   (byteCount + bytesPerCluster - 1) / bytesPerCluster;
+               uint32_t newCluster = 0;
 
-               for (uint32_t testCluster = 2; testCluster < maxClusters;
-                    testCluster++)
+               if (runLen > 1)
                {
-                  if (FAT_NextCluster(inst, disk, testCluster) == 0)
+                  uint32_t first = fat_alloc_run(
+                      inst, disk, fd->CurrentCluster + 1, runLen);
+                  if (first != 0)
                   {
-                     newCluster = testCluster;
-                     break;
+                     uint32_t prev = fd->CurrentCluster;
+                     int rc = 0;
+                     for (uint32_t i = 0; i < runLen && rc == 0; i++)
+                     {
+                        rc = FAT_WriteFatEntry(inst, disk, prev, first + i);
+                        prev = first + i;
+                     }
+                     if (rc == 0)
+                        rc = FAT_WriteFatEntry(inst, disk, prev, eofVal);
+                     if (rc < 0)
+                     {
+                        logfmt(LOG_ERROR, "[FAT] FAT_Write: FAT write error "
+                                          "linking cluster run\n");
+                        return bytesWritten;
+                     }
+                     newCluster = first;
                   }
                }
 
                if (newCluster == 0)
                {
-                  logfmt(LOG_ERROR,
-                         "[FAT] FAT_Write: no free clusters available\n");
-                  return bytesWritten;
-               }
+                  /* No contiguous run (or single cluster): the original
+                     one-at-a-time extension. */
+                  newCluster =
+                      fat_alloc_cluster(inst, disk, fd->CurrentCluster + 1);
 
-               uint32_t eofVal = (inst->FatType == 12)   ? 0x0FFF
-                                 : (inst->FatType == 16) ? 0xFFFF
-                                                         : 0x0FFFFFFF;
+                  if (newCluster == 0)
+                  {
+                     logfmt(LOG_ERROR,
+                            "[FAT] FAT_Write: no free clusters available\n");
+                     return bytesWritten;
+                  }
 
-               if (FAT_WriteFatEntry(inst, disk, fd->CurrentCluster,
-                                     newCluster) < 0 ||
-                   FAT_WriteFatEntry(inst, disk, newCluster, eofVal) < 0)
-               {
-                  logfmt(LOG_ERROR, "[FAT] FAT_Write: FAT write error "
-                                    "linking/marking cluster\n");
-                  return bytesWritten;
-               }
+                  if (FAT_WriteFatEntry(inst, disk, fd->CurrentCluster,
+                                        newCluster) < 0 ||
+                      FAT_WriteFatEntry(inst, disk, newCluster, eofVal) < 0)
+                  {
+                     logfmt(LOG_ERROR, "[FAT] FAT_Write: FAT write error "
+                                       "linking/marking cluster\n");
+                     return bytesWritten;
+                  }
 
-               // Verify the EOF was actually written
-               uint32_t verify = FAT_NextCluster(inst, disk, newCluster);
-               if (verify != eofVal)
-               {
-                  logfmt(LOG_ERROR,
-                         "[FAT] FAT_Write: ERROR: linked %u->%u, marked %u as "
-                         "EOF (0x%08x), but verify=0x%08x\n",
-                         fd->CurrentCluster, newCluster, newCluster, eofVal,
-                         verify);
+                  // Verify the EOF was actually written
+                  uint32_t verify = FAT_NextCluster(inst, disk, newCluster);
+                  if (verify != eofVal)
+                  {
+                     logfmt(LOG_ERROR,
+                            "[FAT] FAT_Write: ERROR: linked %u->%u, marked %u "
+                            "as EOF (0x%08x), but verify=0x%08x\n",
+                            fd->CurrentCluster, newCluster, newCluster, eofVal,
+                            verify);
+                  }
                }
 
                fd->CurrentCluster = newCluster;
@@ -1722,6 +2950,14 @@ int FAT_UpdateEntry(Partition *disk, FAT_File *file)
       inst->RootDirectory.CurrentSectorInCluster = 0;
    }
 
+   /* The directory entry is about to change on disk; any cached lookup
+    * of it would go stale. */
+   fat_dcache_purge(inst);
+
+   /* Persistence point: make sure any dirty in-memory FAT entries reach
+    * the disk before the directory entry that references them. */
+   if (fat_table_flush(inst, disk) < 0) return -EIO;
+
    // Determine where the parent directory starts
    bool parentIsRoot = fd->ParentIsRoot;
    uint32_t parentCluster = fd->ParentCluster;
@@ -1849,6 +3085,10 @@ FAT_File *FAT_Create(Partition *disk, const char *path, uint16_t mode)
    FAT_Instance *inst = fat_inst(disk);
    if (!inst) return NULL;
 
+   /* Creation changes the parent directory and supersedes any negative
+    * cache slot for this path. */
+   fat_dcache_purge(inst);
+
    char metadataPath[MAX_PATH_SIZE];
    fat_normalize_absolute_path(path, metadataPath, sizeof(metadataPath));
 
@@ -1930,25 +3170,8 @@ FAT_File *FAT_Create(Partition *disk, const char *path, uint16_t mode)
       return NULL;
    }
 
-   // Find first free cluster for the file
-   uint32_t firstFreeCluster = 0;
-   uint32_t maxClusters = (inst->TotalSectors - inst->DataSectionLba) /
-                          inst->BS.BootSector.SectorsPerCluster;
-
-   // Search all clusters (was previously limited to 1000 and could miss free
-   // space on larger images)
-   uint32_t maxSearchClusters = maxClusters;
-
-   for (uint32_t testCluster = 2; testCluster < maxSearchClusters;
-        testCluster++)
-   {
-      uint32_t nextClusterVal = FAT_NextCluster(inst, disk, testCluster);
-      if (nextClusterVal == 0)
-      {
-         firstFreeCluster = testCluster;
-         break;
-      }
-   }
+   // Allocate the file's first cluster (rotating hint, no linear scan)
+   uint32_t firstFreeCluster = fat_alloc_cluster(inst, disk, 0);
 
    if (firstFreeCluster == 0)
    {
@@ -2063,6 +3286,9 @@ int FAT_Delete(Partition *disk, const char *name)
    FAT_Instance *inst = fat_inst(disk);
    if (!inst) return FAT_EDISK;
 
+   /* The path (and its parent directory) are about to change. */
+   fat_dcache_purge(inst);
+
    // Normalize path and split into parent + basename
    if (name[0] == '/') name++;
 
@@ -2135,7 +3361,7 @@ int FAT_Delete(Partition *disk, const char *name)
       if (dir)
       {
          FAT_DirectoryEntry subEntry;
-         while (FAT_ReadEntry(disk, dir, &subEntry) == SUCCESS)
+         while (fat_dir_next_entry(disk, dir, &subEntry) == SUCCESS)
          {
             if ((subEntry.Attributes & 0x0F) == 0x0F ||
                 subEntry.Name[0] == 0x00 || (uint8_t)subEntry.Name[0] == 0xE5)
@@ -2204,6 +3430,10 @@ int FAT_Delete(Partition *disk, const char *name)
       }
    }
 
+   /* Persistence point: the freed chain must hit the disk before the
+    * directory entry is tombstoned below. */
+   fat_table_flush(inst, disk);
+
    // Mark directory entry as deleted within the parent directory
    FAT_FileData *parentData = (parentDir->Handle == ROOT_DIRECTORY_HANDLE)
                                   ? &inst->RootDirectory
@@ -2442,6 +3672,7 @@ int FAT_Truncate(Partition *disk, FAT_File *file)
    fd->Truncated = true; // Mark as truncated
    fd->CurrentSectorInCluster = 0;
    fd->CurrentCluster = fd->FirstCluster;
+   fd->ExtentCount = 0; // Chain was rewritten; drop the stale extent map
    memset(fd->Buffer, 0, SECTOR_SIZE);
 
    // Read the first cluster into buffer for potential writes
@@ -2454,6 +3685,10 @@ int FAT_Truncate(Partition *disk, FAT_File *file)
    }
 
    inst->FatCachePos = 0xFFFFFFFF;
+
+   /* Persistence point: push the freed chain to disk. */
+   if (fat_table_flush(inst, disk) < 0) return -EIO;
+
    logfmt(LOG_INFO,
           "[FAT] FAT_Truncate: truncate complete, file ready for writes\n");
    return SUCCESS;
@@ -2461,6 +3696,225 @@ int FAT_Truncate(Partition *disk, FAT_File *file)
 
 /* Invalidate the FAT cache - call after operations that may leave cache
  * inconsistent */
+/* -------------------------------------------------------------------------
+ * Defragmentation.
+ *
+ * Files created by FAT_Create and grown write-by-write end up with
+ * scattered chains once the volume has churned for a while, which
+ * defeats the extent map and the bulk-read fast path.  The helpers
+ * below report per-file fragmentation and relocate a chain into one
+ * contiguous run.  Relocation is an explicit, bounded maintenance pass
+ * driven through VFS_Fscntl — the FS deliberately has no background
+ * thread (see bcache.c), and handle state is not safe to touch from
+ * the idle task while a blocked process sits mid-operation.
+ * ------------------------------------------------------------------------- */
+
+/* Longest chain the maintenance pass will touch; bounds both the walk
+ * and the relocation copy (64 Ki clusters = 256 MiB at 4 KiB). */
+#define FAT_DEFRAG_MAX_CHAIN 65536u
+
+static FAT_FileData *fat_handle_data(FAT_Instance *inst, const FAT_File *file)
+{
+   if (file->Handle == ROOT_DIRECTORY_HANDLE) return &inst->RootDirectory;
+   if (file->Handle < 0 || file->Handle >= MAX_FILE_HANDLES) return NULL;
+   return &inst->OpenedFiles[file->Handle];
+}
+
+/* Walk a cluster chain counting clusters and contiguous runs.  A
+ * fragments count of 1 means the chain is already one straight run. */
+static int fat_chain_stats(FAT_Instance *inst, Partition *disk,
+                           uint32_t firstCluster, uint32_t *clustersOut,
+                           uint32_t *fragmentsOut)
+{
+   uint32_t eofMarker = (inst->FatType == 12)   ? 0xFF8
+                        : (inst->FatType == 16) ? 0xFFF8
+                                                : 0x0FFFFFF8;
+   uint32_t clusters = 0;
+   uint32_t fragments = 0;
+   uint32_t cluster = firstCluster;
+
+   while (cluster >= 2 && cluster < eofMarker)
+   {
+      if (++clusters > FAT_DEFRAG_MAX_CHAIN)
+      {
+         logfmt(LOG_ERROR,
+                "[FAT] chain stats: runaway chain from cluster %u\n",
+                firstCluster);
+         return -EIO;
+      }
+
+      uint32_t next = FAT_NextCluster(inst, disk, cluster);
+      if (next >= eofMarker)
+      {
+         fragments++;
+         break;
+      }
+      if (next < 2) return -EIO; // Broken chain
+      if (next != cluster + 1) fragments++;
+      cluster = next;
+   }
+
+   *clustersOut = clusters;
+   *fragmentsOut = fragments;
+   return SUCCESS;
+}
+
+/* Find `length` consecutive free clusters in the free bitmap.  Returns
+ * the first cluster of the run, or 0 when no such run exists (also
+ * when the bitmap could not be built — defrag is optional maintenance,
+ * so there is no linear-scan fallback here). */
+static uint32_t fat_find_free_run(FAT_Instance *inst, Partition *disk,
+                                  uint32_t length)
+{
+   if (!inst->FreeBitmapValid) fat_free_bitmap_build(inst, disk);
+   if (!inst->FreeBitmapValid || length == 0) return 0;
+
+   uint32_t run = 0;
+   uint32_t runStart = 0;
+   for (uint32_t cluster = 2; cluster < inst->ClusterLimit; cluster++)
+   {
+      if ((inst->FreeBitmap[cluster / 8] >> (cluster % 8)) & 1u)
+      {
+         if (run == 0) runStart = cluster;
+         if (++run == length) return runStart;
+      }
+      else
+      {
+         run = 0;
+      }
+   }
+   return 0;
+}
+
+/* Relocate a file's cluster chain into one contiguous run.  Ordered
+ * for crash safety: the data is copied and the new chain fully linked
+ * in the FAT before the directory entry flips to it, and the old chain
+ * is freed only afterwards — a crash at any point leaves the file
+ * readable through whichever chain the entry names. */
+static int fat_defrag_file(FAT_Instance *inst, Partition *disk, FAT_File *file)
+{
+   FAT_FileData *fd = fat_handle_data(inst, file);
+   if (!fd) return -EINVAL;
+
+   /* Moving a directory would orphan the '..' back-links of every
+    * child; not worth the complexity for a maintenance pass. */
+   if (file->IsDirectory) return -EINVAL;
+
+   uint32_t firstCluster = fd->FirstCluster;
+   if (firstCluster < 2) return SUCCESS; // Empty file, nothing to move
+
+   uint32_t clusters = 0;
+   uint32_t fragments = 0;
+   int rc = fat_chain_stats(inst, disk, firstCluster, &clusters, &fragments);
+   if (rc < 0) return rc;
+   if (fragments <= 1) return SUCCESS; // Already contiguous
+
+   uint32_t newStart = fat_find_free_run(inst, disk, clusters);
+   if (newStart == 0)
+   {
+      logfmt(LOG_WARNING,
+             "[FAT] defrag: no contiguous run of %u clusters free\n",
+             clusters);
+      return -EIO;
+   }
+
+   uint8_t *sector = kmalloc(SECTOR_SIZE);
+   if (!sector) return -ENOMEM;
+
+   uint32_t eofMarker = (inst->FatType == 12)   ? 0xFF8
+                        : (inst->FatType == 16) ? 0xFFF8
+                                                : 0x0FFFFFF8;
+   uint32_t eofVal = (inst->FatType == 12)   ? 0x0FFF
+                     : (inst->FatType == 16) ? 0xFFFF
+                                             : 0x0FFFFFFF;
+   uint32_t spc = inst->BS.BootSector.SectorsPerCluster;
+
+   /* Copy the data and link the new chain as we go. */
+   uint32_t cur = firstCluster;
+   uint32_t copied = 0;
+   for (uint32_t i = 0; i < clusters; i++, copied++)
+   {
+      uint32_t srcLba = FAT_ClusterToLba(inst, cur);
+      uint32_t dstLba = FAT_ClusterToLba(inst, newStart + i);
+      for (uint32_t s = 0; s < spc; s++)
+      {
+         if (Partition_ReadSectors(disk, srcLba + s, 1, sector) < 0 ||
+             Partition_WriteSectors(disk, dstLba + s, 1, sector) < 0)
+         {
+            logfmt(LOG_ERROR, "[FAT] defrag: copy failed at cluster %u\n",
+                   cur);
+            goto unwind;
+         }
+      }
+
+      uint32_t link = (i + 1 < clusters) ? newStart + i + 1 : eofVal;
+      if (FAT_WriteFatEntry(inst, disk, newStart + i, link) < 0) goto unwind;
+
+      if (i + 1 < clusters)
+      {
+         cur = FAT_NextCluster(inst, disk, cur);
+         if (cur < 2 || cur >= eofMarker)
+         {
+            logfmt(LOG_ERROR, "[FAT] defrag: chain ended early at %u/%u\n",
+                   i + 1, clusters);
+            goto unwind;
+         }
+      }
+   }
+   free(sector);
+   sector = NULL;
+
+   /* Persistence point: the new chain must be on disk before the
+    * directory entry can reference it. */
+   if (fat_table_flush(inst, disk) < 0) goto unwind;
+
+   /* Flip the directory entry to the new chain (flushes and purges the
+    * dcache itself), then retire the old one. */
+   fd->FirstCluster = newStart;
+   rc = FAT_UpdateEntry(disk, file);
+   if (rc < 0)
+   {
+      fd->FirstCluster = firstCluster;
+      goto unwind;
+   }
+
+   cur = firstCluster;
+   for (uint32_t i = 0; i < clusters && cur >= 2 && cur < eofMarker; i++)
+   {
+      uint32_t next = FAT_NextCluster(inst, disk, cur);
+      FAT_WriteFatEntry(inst, disk, cur, 0);
+      cur = next;
+   }
+   fat_table_flush(inst, disk);
+
+   /* Resync the handle onto the relocated chain. */
+   fd->CurrentCluster = newStart;
+   fd->CurrentSectorInCluster = 0;
+   fd->Public.Position = 0;
+   fd->ExtentCount = 0;
+   fd->LastReadEnd = 0;
+   fd->SeqStreak = 0;
+   fd->PrefetchCluster = 0;
+   FAT_Seek(disk, file, 0);
+
+   logfmt(LOG_INFO, "[FAT] defrag: clusters=%u fragments=%u newStart=%u\n",
+          clusters, fragments, newStart);
+   return SUCCESS;
+
+unwind:
+   /* Give the partially built run back; the file still lives on its
+    * old chain. */
+   if (sector) free(sector);
+   /* <= copied: the failing iteration may have linked its entry before
+    * bailing out; clearing an already-free cluster is harmless. */
+   for (uint32_t i = 0; i <= copied && i < clusters; i++)
+   {
+      FAT_WriteFatEntry(inst, disk, newStart + i, 0);
+   }
+   fat_table_flush(inst, disk);
+   return (rc < 0) ? rc : -EIO;
+}
+
 void FAT_InvalidateCache(FAT_Instance *inst)
 {
    if (!inst) return;
@@ -2468,6 +3922,23 @@ void FAT_InvalidateCache(FAT_Instance *inst)
    /* Invalidate FAT cache to force fresh reads */
    inst->FatCachePos = 0xFFFFFFFF;
 
+   /* Path lookups may also be stale. */
+   fat_dcache_purge(inst);
+
+   /* Drop the in-memory FAT table too; it is reloaded lazily on the next
+    * cluster-chain access.  Unflushed dirty entries are discarded on
+    * purpose — invalidation means the on-disk FAT is the truth. */
+   inst->FatTableValid = false;
+
+   /* The free bitmap mirrors the table; rebuild it lazily on the next
+    * allocation.  The running free count is derived from the same
+    * state, so it goes stale with it. */
+   inst->FreeBitmapValid = false;
+   inst->FreeCountValid = false;
+
+   /* Same for the metadata index: the sidecar on disk is the truth. */
+   fat_meta_index_drop(inst);
+
    /* Close opened file handles (except root directory which is always open) */
    for (int i = 0; i < MAX_FILE_HANDLES; i++)
    {
@@ -2498,6 +3969,7 @@ static VFS_File *fat_vfs_open(Partition *partition, const char *path)
    vf->fs_file = fat_file;
    vf->is_directory = fat_file->IsDirectory;
    vf->size = fat_file->Size;
+   vf->size_gen = partition->write_gen; /* Size is fresh as of now */
    return vf;
 }
 
@@ -2518,6 +3990,7 @@ static VFS_File *fat_vfs_create(Partition *partition, const char *path,
    vf->fs_file = fat_file;
    vf->is_directory = fat_file->IsDirectory;
    vf->size = fat_file->Size;
+   vf->size_gen = partition->write_gen; /* Size is fresh as of now */
    return vf;
 }
 
@@ -2579,7 +4052,7 @@ static int fat_vfs_readdir(Partition *partition, void *fs_file,
    if (!dir->IsDirectory) return -EINVAL;
 
    FAT_DirectoryEntry entry;
-   while (FAT_ReadEntry(partition, dir, &entry) == SUCCESS)
+   while (fat_dir_next_entry(partition, dir, &entry) == SUCCESS)
    {
       if (entry.Name[0] == 0x00) return -ENOENT;
       if ((uint8_t)entry.Name[0] == 0xE5) continue;
@@ -2597,6 +4070,54 @@ static int fat_vfs_readdir(Partition *partition, void *fs_file,
    return -ENOENT;
 }
 
+/* Maintenance commands: per-file fragmentation report and an explicit
+ * single-file defragment pass (see the defrag block above). */
+static int fat_vfs_fscntl(Partition *partition, const char *path, uint32_t cmd,
+                          void *arg)
+{
+   if (!partition || !partition->fs || !path) return -EINVAL;
+
+   FAT_Instance *inst = fat_inst(partition);
+   if (!inst) return -EINVAL;
+
+   FAT_File *file = FAT_Open(partition, path);
+   if (!file) return -ENOENT;
+
+   int rc;
+   switch (cmd)
+   {
+      case VFS_FSCNTL_FRAG_REPORT:
+      {
+         VFS_FragReport *report = (VFS_FragReport *)arg;
+         FAT_FileData *fd = fat_handle_data(inst, file);
+         if (!report || !fd)
+         {
+            rc = -EINVAL;
+            break;
+         }
+
+         report->clusters = 0;
+         report->fragments = 0;
+         rc = (fd->FirstCluster >= 2)
+                  ? fat_chain_stats(inst, partition, fd->FirstCluster,
+                                    &report->clusters, &report->fragments)
+                  : SUCCESS;
+         break;
+      }
+
+      case VFS_FSCNTL_DEFRAG:
+         rc = fat_defrag_file(inst, partition, file);
+         break;
+
+      default:
+         rc = -EINVAL;
+         break;
+   }
+
+   FAT_Close(file);
+   return rc;
+}
+
 static int fat_vfs_chmod(Partition *partition, const char *path, uint16_t mode)
 {
    return fat_chmod_path(partition, path, mode);
@@ -2608,6 +4129,61 @@ static int fat_vfs_chown(Partition *partition, const char *path, uint32_t uid,
    return fat_chown_path(partition, path, uid, gid);
 }
 
+/* Stat without the open/close round trip.  A warm dentry-cache hit
+ * answers size and type from memory, and mode/owner come from the
+ * metadata sidecar's in-memory index, so a repeated stat does zero
+ * disk I/O.  A cold path falls back to one directory walk, which
+ * primes the cache for the next call. */
+static int fat_vfs_stat(Partition *partition, const char *path,
+                        VFS_StatInfo *out)
+{
+   if (!partition || !path || !out) return -EINVAL;
+
+   FAT_Instance *inst = fat_inst(partition);
+   if (!inst) return -ENODEV;
+
+   memset(out, 0, sizeof(*out));
+   out->mode = 0755; /* Default when no metadata record exists */
+
+   const char *cursor = path;
+   while (*cursor == '/') cursor++;
+
+   if (*cursor == '\0')
+   {
+      out->is_directory = true;
+      return SUCCESS;
+   }
+
+   FAT_DirCacheEntry *cached = fat_dcache_find(inst, path);
+   if (cached)
+   {
+      if (cached->Negative) return -ENOENT;
+      out->size = cached->Entry.Size;
+      out->is_directory =
+          (cached->Entry.Attributes & FAT_ATTRIBUTE_DIRECTORY) != 0;
+   }
+   else
+   {
+      FAT_File *fd = FAT_Open(partition, path);
+      if (!fd) return -ENOENT;
+      out->size = fd->Size;
+      out->is_directory = fd->IsDirectory;
+      FAT_Close(fd);
+   }
+
+   FAT_MetadataRecord rec;
+   bool found = false;
+   if (fat_metadata_lookup_latest(partition, path, &rec, &found) == SUCCESS &&
+       found && !(rec.Flags & FAT_METADATA_FLAG_DELETED))
+   {
+      out->mode = rec.Mode;
+      out->uid = rec.Uid;
+      out->gid = rec.Gid;
+   }
+
+   return SUCCESS;
+}
+
 /* FAT operations structure - directly points to FAT functions */
 static const VFS_Operations fat_vfs_ops = {
     .open =
@@ -2623,7 +4199,9 @@ static const VFS_Operations fat_vfs_ops = {
     .delete = (int (*)(Partition *, const char *))FAT_Delete,
     .access = fat_vfs_access,
     .chmod = fat_vfs_chmod,
-    .chown = fat_vfs_chown};
+    .chown = fat_vfs_chown,
+    .fscntl = fat_vfs_fscntl,
+    .stat = fat_vfs_stat};
 
 /* Public function to get FAT VFS operations */
 const VFS_Operations *FAT_GetVFSOperations(void) { return &fat_vfs_ops; }
\ No newline at end of file
@@ -3,7 +3,10 @@
 #include "fd.h"
 #include <constants.h>
 #include <cpu/process.h>
+#include <cpu/timer.h>
+#include <hal/io.h>
 #include <fs/fs.h>
+#include <fs/pipe/pipe.h>
 #include <fs/vfs/vfs.h>
 #include <mem/mm_kernel.h>
 #include <std/stdio.h>
@@ -17,30 +20,92 @@ void FD_Retain(FileDescriptor *file)
    ++file->ref_count;
 }
 
+// Drop one reference to a descriptor; the last one closes the inode
+static void fd_release(FileDescriptor *file)
+{
+   if (!file) return;
+
+   if (file->ref_count > 0) --file->ref_count;
+   if (file->ref_count == 0)
+   {
+      if (file->pipe)
+         Pipe_ReleaseEnd((Pipe *)file->pipe, file->writable);
+      else if (file->inode)
+         VFS_Close((VFS_File *)file->inode);
+      free(file);
+   }
+}
+
+// Table lifecycle: fork shares the table and the first mutation in
+// either process copies it (FD_TableUnshare below)
+FdTable *FD_TableCreate(void)
+{
+   FdTable *table = (FdTable *)kzalloc(sizeof(FdTable));
+   if (table) table->ref_count = 1;
+   return table;
+}
+
+FdTable *FD_TableShare(FdTable *table)
+{
+   if (!table) return NULL;
+   ++table->ref_count;
+   return table;
+}
+
+// Called before any table mutation.  A private table (ref_count 1) is
+// mutated in place; a shared one is copied first, retaining each
+// descriptor so the open files themselves stay shared.
+int FD_TableUnshare(void *proc_ptr)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc || !proc->fd_table) return -1;
+   if (proc->fd_table->ref_count <= 1) return 0;
+
+   FdTable *copy = (FdTable *)kmalloc(sizeof(FdTable));
+   if (!copy)
+   {
+      logfmt(LOG_ERROR, "[fd] table unshare: kmalloc failed\n");
+      return -1; // ENOMEM
+   }
+
+   memcpy(copy, proc->fd_table, sizeof(FdTable));
+   copy->ref_count = 1;
+   for (int fd = 0; fd < FD_TABLE_SIZE; ++fd)
+   {
+      FD_Retain(copy->entries[fd]);
+   }
+
+   --proc->fd_table->ref_count;
+   proc->fd_table = copy;
+   return 0;
+}
+
 // Helper: Get file descriptor from process
 FileDescriptor *FD_Get(void *proc_ptr, int fd)
 {
    Process *proc = (Process *)proc_ptr;
 
-   if (!proc || fd < 0 || fd >= FD_TABLE_SIZE) return NULL;
+   if (!proc || !proc->fd_table || fd < 0 || fd >= FD_TABLE_SIZE) return NULL;
 
-   return proc->fd_table[fd];
+   return proc->fd_table->entries[fd];
 }
 
 // Helper: Find first free file descriptor
+// Find-first-zero on the per-process bitmap; ctz returns the lowest
+// free slot, which preserves POSIX lowest-fd semantics for dup later
 int FD_FindFree(void *proc_ptr)
 {
    Process *proc = (Process *)proc_ptr;
 
-   if (!proc) return -1;
+   if (!proc || !proc->fd_table) return -1;
 
    // Reserve 0, 1, 2 for stdin, stdout, stderr
-   for (int i = 3; i < FD_TABLE_SIZE; i++)
-   {
-      if (proc->fd_table[i] == NULL) return i;
-   }
+   uint32_t freebits =
+       ~proc->fd_table->bitmap & (((1u << FD_TABLE_SIZE) - 1u) & ~7u);
+   if (!freebits) return -1; // EMFILE (too many open files)
 
-   return -1; // EMFILE (too many open files)
+   return (int)__builtin_ctz(freebits);
 }
 
 // Open a file and return file descriptor
@@ -72,13 +137,11 @@ int FD_Open(void *proc_ptr, const char *path, int flags, uint16_t mode)
 
    // Set initial state
    file->offset = 0;
+   file->pipe = NULL;
    file->flags = flags;
    file->readable = (flags & O_WRONLY) == 0;
    file->writable = (flags & (O_WRONLY | O_RDWR)) != 0;
 
-   // Handle O_APPEND: seek to end
-   if (flags & O_APPEND) file->offset = 0xFFFFFFFFu; // Marker for "append mode"
-
    // Open via VFS (resolves partition internally)
    file->inode = VFS_Open(path);
    if (file->inode)
@@ -130,10 +193,21 @@ int FD_Open(void *proc_ptr, const char *path, int flags, uint16_t mode)
       return -ENOENT;
    }
 
+   // O_APPEND: start at the end; FD_Write re-snaps to the end before
+   // every write anyway, this just keeps the offset honest for readers
+   if (flags & O_APPEND) file->offset = VFS_GetSize((VFS_File *)file->inode);
+
    file->ref_count = 1;
 
-   // Store in process FD table
-   proc->fd_table[fd] = file;
+   // Store in process FD table (copying it first if fork shares it)
+   if (FD_TableUnshare(proc) < 0)
+   {
+      if (file->inode) VFS_Close((VFS_File *)file->inode);
+      free(file);
+      return -1; // ENOMEM
+   }
+   proc->fd_table->entries[fd] = file;
+   proc->fd_table->bitmap |= (1u << fd);
    logfmt(LOG_INFO, "[fd] opened: fd=%d, path=%s\n", fd, path);
 
    return fd;
@@ -149,20 +223,137 @@ int FD_Close(void *proc_ptr, int fd)
    FileDescriptor *file = FD_Get(proc, fd);
    if (!file) return -1; // EBADF (bad file descriptor)
 
-   proc->fd_table[fd] = NULL;
+   if (FD_TableUnshare(proc) < 0) return -1; // ENOMEM
 
-   if (file->ref_count > 0) --file->ref_count;
-   if (file->ref_count == 0)
+   proc->fd_table->entries[fd] = NULL;
+   proc->fd_table->bitmap &= ~(1u << fd);
+
+   fd_release(file);
+
+   logfmt(LOG_INFO, "[fd] closed: fd=%d\n", fd);
+   return 0;
+}
+
+// Duplicate oldfd into the lowest free slot (POSIX dup)
+int FD_Dup(void *proc_ptr, int oldfd)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   FileDescriptor *file = FD_Get(proc, oldfd);
+   if (!file) return -EBADF;
+
+   int newfd = FD_FindFree(proc);
+   if (newfd == -1) return -EMFILE;
+
+   if (FD_TableUnshare(proc) < 0) return -ENOMEM;
+
+   FD_Retain(file);
+   proc->fd_table->entries[newfd] = file;
+   proc->fd_table->bitmap |= (1u << newfd);
+
+   logfmt(LOG_INFO, "[fd] dup: oldfd=%d newfd=%d\n", oldfd, newfd);
+   return newfd;
+}
+
+// Duplicate oldfd onto newfd, closing whatever newfd held (POSIX dup2)
+int FD_Dup2(void *proc_ptr, int oldfd, int newfd)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   FileDescriptor *file = FD_Get(proc, oldfd);
+   if (!file) return -EBADF;
+   if (newfd < 0 || newfd >= FD_TABLE_SIZE) return -EBADF;
+   if (newfd == oldfd) return newfd;
+
+   if (FD_TableUnshare(proc) < 0) return -ENOMEM;
+
+   FileDescriptor *old = proc->fd_table->entries[newfd];
+   FD_Retain(file);
+   proc->fd_table->entries[newfd] = file;
+   proc->fd_table->bitmap |= (1u << newfd);
+   fd_release(old); /* After the retain, in case old == file's sibling */
+
+   logfmt(LOG_INFO, "[fd] dup2: oldfd=%d newfd=%d\n", oldfd, newfd);
+   return newfd;
+}
+
+// Helper: build one end of a pipe (inode stays NULL, VFS is bypassed)
+static FileDescriptor *fd_pipe_end(Pipe *pipe, bool write_end)
+{
+   FileDescriptor *file = (FileDescriptor *)kmalloc(sizeof(FileDescriptor));
+   if (!file) return NULL;
+
+   strncpy(file->path, "pipe:", 255);
+   file->path[255] = '\0';
+   file->offset = 0;
+   file->readable = !write_end;
+   file->writable = write_end;
+   file->inode = NULL;
+   file->pipe = pipe;
+   file->flags = write_end ? O_WRONLY : O_RDONLY;
+   file->ref_count = 1;
+   return file;
+}
+
+// Create an anonymous pipe: fds[0] reads, fds[1] writes
+int FD_Pipe(void *proc_ptr, int fds[2])
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc || !fds) return -EINVAL;
+
+   if (FD_TableUnshare(proc) < 0) return -ENOMEM;
+
+   // Claim two slots; FD_FindFree does not mark the bitmap, so set the
+   // first bit before asking for the second
+   int rfd = FD_FindFree(proc);
+   if (rfd == -1) return -EMFILE;
+   proc->fd_table->bitmap |= (1u << rfd);
+   int wfd = FD_FindFree(proc);
+   if (wfd == -1)
    {
-      if (file->inode) VFS_Close((VFS_File *)file->inode);
-      free(file);
+      proc->fd_table->bitmap &= ~(1u << rfd);
+      return -EMFILE;
    }
 
-   logfmt(LOG_INFO, "[fd] closed: fd=%d\n", fd);
+   Pipe *pipe = Pipe_Create();
+   if (!pipe)
+   {
+      proc->fd_table->bitmap &= ~(1u << rfd);
+      return -ENOMEM;
+   }
+
+   FileDescriptor *rend = fd_pipe_end(pipe, false);
+   FileDescriptor *wend = fd_pipe_end(pipe, true);
+   if (!rend || !wend)
+   {
+      if (rend) free(rend);
+      if (wend) free(wend);
+      Pipe_ReleaseEnd(pipe, false);
+      Pipe_ReleaseEnd(pipe, true);
+      proc->fd_table->bitmap &= ~(1u << rfd);
+      return -ENOMEM;
+   }
+
+   proc->fd_table->entries[rfd] = rend;
+   proc->fd_table->entries[wfd] = wend;
+   proc->fd_table->bitmap |= (1u << wfd);
+
+   fds[0] = rfd;
+   fds[1] = wfd;
+   logfmt(LOG_INFO, "[fd] pipe: readfd=%d writefd=%d\n", rfd, wfd);
    return 0;
 }
 
 // Read from file descriptor
+/* Devfs character streams (/dev/zero, /dev/null, ...) have no seekable
+ * cursor worth aligning; skipping the per-call VFS_Seek keeps their
+ * read/write path at a single dispatch into the device handler. */
+static bool fd_is_stream(const FileDescriptor *file)
+{
+   return ((const VFS_File *)file->inode)->type == DEVFS;
+}
+
 int FD_Read(void *proc_ptr, int fd, void *buf, uint32_t count)
 {
    Process *proc = (Process *)proc_ptr;
@@ -174,8 +365,25 @@ int FD_Read(void *proc_ptr, int fd, void *buf, uint32_t count)
 
    if (!file->readable) return -1; // EACCES (permission denied)
 
+   // Pipe ends bypass the VFS; the ring transport blocks as needed
+   if (file->pipe)
+   {
+      Pipe *pipe = (Pipe *)file->pipe;
+      if ((file->flags & O_NONBLOCK) && pipe->count == 0 && pipe->writers > 0)
+         return -EAGAIN;
+      return Pipe_Read(pipe, buf, count);
+   }
+
+   // O_NONBLOCK on a device: bail out before the handler can block
+   if ((file->flags & O_NONBLOCK) && fd_is_stream(file) &&
+       !(DEVFS_Poll((DEVFS_File *)((VFS_File *)file->inode)->fs_file) &
+         DEVFS_POLLIN))
+      return -EAGAIN;
+
    // Align filesystem cursor to requested offset if needed
-   if (VFS_Seek((VFS_File *)file->inode, file->offset) < 0) return -1;
+   if (!fd_is_stream(file) &&
+       VFS_Seek((VFS_File *)file->inode, file->offset) < 0)
+      return -1;
 
    // Read from filesystem
    uint32_t bytes_read = VFS_Read((VFS_File *)file->inode, count, buf);
@@ -194,8 +402,8 @@ int FD_Write(void *proc_ptr, int fd, const void *buf, uint32_t count)
    FileDescriptor *file = FD_Get(proc, fd);
    if (!file) return -1; // EBADF
 
-   // Handle stdout/stderr: write to TTY
-   if (fd == 1 || fd == 2)
+   // Handle stdout/stderr: write to TTY (unless a pipe was dup2'd here)
+   if ((fd == 1 || fd == 2) && !file->pipe)
    {
       TTY_Device *dev = TTY_GetDevice();
       if (dev) TTY_Write(dev, buf, count);
@@ -204,8 +412,30 @@ int FD_Write(void *proc_ptr, int fd, const void *buf, uint32_t count)
 
    if (!file->writable) return -1; // EACCES
 
+   if (file->pipe)
+   {
+      Pipe *pipe = (Pipe *)file->pipe;
+      if ((file->flags & O_NONBLOCK) && pipe->count == PIPE_BUF_SIZE &&
+          pipe->readers > 0)
+         return -EAGAIN;
+      return Pipe_Write(pipe, buf, count);
+   }
+
+   if ((file->flags & O_NONBLOCK) && fd_is_stream(file) &&
+       !(DEVFS_Poll((DEVFS_File *)((VFS_File *)file->inode)->fs_file) &
+         DEVFS_POLLOUT))
+      return -EAGAIN;
+
+   // O_APPEND: every write lands at the current end of file regardless
+   // of intervening seeks (POSIX append semantics).  VFS_GetSize serves
+   // this from the size cache, so no filesystem work per write.
+   if (file->flags & O_APPEND)
+      file->offset = VFS_GetSize((VFS_File *)file->inode);
+
    // Align filesystem cursor to requested offset if needed
-   if (VFS_Seek((VFS_File *)file->inode, file->offset) < 0) return -1;
+   if (!fd_is_stream(file) &&
+       VFS_Seek((VFS_File *)file->inode, file->offset) < 0)
+      return -1;
 
    // Write to filesystem
    uint32_t bytes_written = VFS_Write((VFS_File *)file->inode, count, buf);
@@ -214,6 +444,125 @@ int FD_Write(void *proc_ptr, int fd, const void *buf, uint32_t count)
    return bytes_written;
 }
 
+// Read into multiple segments with one descriptor lookup and one seek.
+// VFS_Read copies each cluster straight into the segment being filled,
+// so no intermediate coalescing buffer is needed.
+int FD_Readv(void *proc_ptr, int fd, const FD_IoVec *iov, int iovcnt)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc || !iov || iovcnt <= 0 || iovcnt > FD_IOV_MAX) return -1; // EINVAL
+
+   FileDescriptor *file = FD_Get(proc, fd);
+   if (!file) return -1; // EBADF
+
+   if (!file->readable) return -1; // EACCES
+
+   if (file->pipe)
+   {
+      uint32_t piped = 0;
+      for (int i = 0; i < iovcnt; i++)
+      {
+         if (iov[i].iov_len == 0) continue;
+         if (!iov[i].iov_base) return -1; // EINVAL
+
+         int n = Pipe_Read((Pipe *)file->pipe, iov[i].iov_base, iov[i].iov_len);
+         if (n < 0) return (piped > 0) ? (int)piped : n;
+         piped += (uint32_t)n;
+         if ((uint32_t)n < iov[i].iov_len) break; // drained or EOF
+      }
+      return (int)piped;
+   }
+
+   if (!fd_is_stream(file) &&
+       VFS_Seek((VFS_File *)file->inode, file->offset) < 0)
+      return -1;
+
+   uint32_t total = 0;
+   for (int i = 0; i < iovcnt; i++)
+   {
+      if (iov[i].iov_len == 0) continue;
+      if (!iov[i].iov_base) return -1; // EINVAL
+
+      uint32_t n =
+          VFS_Read((VFS_File *)file->inode, iov[i].iov_len, iov[i].iov_base);
+      total += n;
+      if (n < iov[i].iov_len) break; // short read: end of file
+   }
+
+   file->offset += total;
+   return (int)total;
+}
+
+// Write multiple segments with one descriptor lookup and one seek
+int FD_Writev(void *proc_ptr, int fd, const FD_IoVec *iov, int iovcnt)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc || !iov || iovcnt <= 0 || iovcnt > FD_IOV_MAX) return -1; // EINVAL
+
+   FileDescriptor *file = FD_Get(proc, fd);
+   if (!file) return -1; // EBADF
+
+   // Handle stdout/stderr: write each segment to the TTY in order
+   // (unless a pipe was dup2'd here)
+   if ((fd == 1 || fd == 2) && !file->pipe)
+   {
+      TTY_Device *dev = TTY_GetDevice();
+      uint32_t total = 0;
+      for (int i = 0; i < iovcnt; i++)
+      {
+         if (iov[i].iov_len == 0) continue;
+         if (!iov[i].iov_base) return -1; // EINVAL
+         if (dev) TTY_Write(dev, iov[i].iov_base, iov[i].iov_len);
+         total += iov[i].iov_len;
+      }
+      return (int)total;
+   }
+
+   if (!file->writable) return -1; // EACCES
+
+   if (file->pipe)
+   {
+      uint32_t piped = 0;
+      for (int i = 0; i < iovcnt; i++)
+      {
+         if (iov[i].iov_len == 0) continue;
+         if (!iov[i].iov_base) return -1; // EINVAL
+
+         int n =
+             Pipe_Write((Pipe *)file->pipe, iov[i].iov_base, iov[i].iov_len);
+         if (n < 0) return (piped > 0) ? (int)piped : n;
+         piped += (uint32_t)n;
+         if ((uint32_t)n < iov[i].iov_len) break; // broken pipe mid-write
+      }
+      return (int)piped;
+   }
+
+   // O_APPEND: snap to the current end of file before the burst
+   if (file->flags & O_APPEND)
+      file->offset = VFS_GetSize((VFS_File *)file->inode);
+
+   if (!fd_is_stream(file) &&
+       VFS_Seek((VFS_File *)file->inode, file->offset) < 0)
+      return -1;
+
+   uint32_t total = 0;
+   for (int i = 0; i < iovcnt; i++)
+   {
+      if (iov[i].iov_len == 0) continue;
+      if (!iov[i].iov_base) return -1; // EINVAL
+
+      uint32_t n =
+          VFS_Write((VFS_File *)file->inode, iov[i].iov_len, iov[i].iov_base);
+      total += n;
+      if (n < iov[i].iov_len) break; // short write: out of space
+   }
+
+   file->offset += total;
+   return (int)total;
+}
+
 // Seek within a file
 int FD_Lseek(void *proc_ptr, int fd, int32_t offset, int whence)
 {
@@ -224,6 +573,8 @@ int FD_Lseek(void *proc_ptr, int fd, int32_t offset, int whence)
    FileDescriptor *file = FD_Get(proc, fd);
    if (!file) return -1; // EBADF
 
+   if (file->pipe) return -1; // ESPIPE (pipes have no cursor)
+
    // whence: 0=SEEK_SET, 1=SEEK_CUR, 2=SEEK_END
    switch (whence)
    {
@@ -234,9 +585,10 @@ int FD_Lseek(void *proc_ptr, int fd, int32_t offset, int whence)
       file->offset += offset;
       break;
    case 2: // SEEK_END
-      // Would need FAT_GetFileSize() to implement properly
-      logfmt(LOG_WARNING, "[fd] seek: SEEK_END not yet implemented\n");
-      return -1;
+      // VFS_GetSize serves this from the per-handle size cache, so the
+      // seek-to-end-before-append pattern costs no filesystem work
+      file->offset = VFS_GetSize((VFS_File *)file->inode) + offset;
+      break;
    default:
       return -1; // EINVAL
    }
@@ -247,15 +599,168 @@ int FD_Lseek(void *proc_ptr, int fd, int32_t offset, int whence)
    return file->offset;
 }
 
-// Close all file descriptors for a process
+// Readiness of one descriptor against its requested event set
+static short fd_poll_events(FileDescriptor *file, short events)
+{
+   short revents = 0;
+
+   if (file->pipe)
+   {
+      Pipe *pipe = (Pipe *)file->pipe;
+      if (file->readable)
+      {
+         if (pipe->count > 0) revents |= POLLIN;
+         if (pipe->writers == 0) revents |= POLLHUP;
+      }
+      if (file->writable)
+      {
+         if (pipe->readers == 0)
+            revents |= POLLERR;
+         else if (pipe->count < PIPE_BUF_SIZE)
+            revents |= POLLOUT;
+      }
+   }
+   else if (fd_is_stream(file))
+   {
+      // DEVFS_POLLIN/DEVFS_POLLOUT share the POLLIN/POLLOUT values,
+      // so the device mask passes through untranslated
+      revents = (short)DEVFS_Poll(
+          (DEVFS_File *)((VFS_File *)file->inode)->fs_file);
+   }
+   else
+   {
+      // Regular files never block
+      revents = POLLIN | POLLOUT;
+   }
+
+   return revents & (events | POLLERR | POLLHUP);
+}
+
+// Wait for readiness on several descriptors at once
+int FD_Poll(void *proc_ptr, FD_PollFd *fds, uint32_t nfds, int timeout_ms)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc || !fds || nfds == 0 || nfds > FD_POLL_MAX) return -EINVAL;
+
+   uint64_t deadline = 0;
+   if (timeout_ms > 0)
+      deadline = Timer_GetMonotonicNs() + (uint64_t)timeout_ms * 1000000ull;
+
+   for (;;)
+   {
+      int ready = 0;
+      for (uint32_t i = 0; i < nfds; i++)
+      {
+         FileDescriptor *file = FD_Get(proc, fds[i].fd);
+         if (!file)
+         {
+            fds[i].revents = POLLNVAL;
+            ready++;
+            continue;
+         }
+
+         fds[i].revents = fd_poll_events(file, fds[i].events);
+         if (fds[i].revents) ready++;
+      }
+
+      if (ready > 0 || timeout_ms == 0) return ready;
+      if (timeout_ms > 0 && Timer_GetMonotonicNs() >= deadline) return 0;
+
+      // Same wait the TTY read path uses: halt until the next
+      // interrupt, then rescan.  Device state only changes from
+      // interrupt context, so the timer tick bounds any re-check gap.
+      if (!g_HalIoOperations || !g_HalIoOperations->EnableInterrupts ||
+          !g_HalIoOperations->DisableInterrupts || !g_HalIoOperations->iowait)
+      {
+         return 0;
+      }
+
+      uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+      if (!interrupts_were_enabled)
+      {
+         g_HalIoOperations->DisableInterrupts();
+      }
+   }
+}
+
+// Bulk directory listing: one syscall drains as many entries as fit in
+// the caller's buffer.  The per-entry VFS_ReadDir calls are cheap here
+// because the FAT cursor reads whole clusters and serves successive
+// entries from that buffer, so the syscall boundary was the real cost.
+int FD_GetDents(void *proc_ptr, int fd, void *buf, uint32_t count)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc || !buf) return -EINVAL;
+
+   FileDescriptor *file = FD_Get(proc, fd);
+   if (!file) return -EBADF;
+   if (file->pipe || !file->inode) return -ENOTDIR;
+
+   VFS_File *dir = (VFS_File *)file->inode;
+   if (!dir->is_directory) return -ENOTDIR;
+
+   FD_Dirent *out = (FD_Dirent *)buf;
+   uint32_t capacity = count / sizeof(FD_Dirent);
+   uint32_t filled = 0;
+
+   VFS_DirEntry entry;
+   while (filled < capacity)
+   {
+      if (VFS_ReadDir(dir, &entry) < 0) break; // End of directory
+
+      memcpy(out[filled].d_name, entry.name, sizeof(out[filled].d_name));
+      out[filled].d_size = entry.size;
+      out[filled].d_isdir = entry.is_directory ? 1 : 0;
+      filled++;
+   }
+
+   return (int)(filled * sizeof(FD_Dirent));
+}
+
+// Device control on a devfs-backed descriptor.  The TTY flag ioctls
+// ride this path (e.g. clearing TTY_FLAG_ICANON for raw keystroke
+// delivery); regular files and pipes have nothing to control.
+int FD_Ioctl(void *proc_ptr, int fd, uint32_t cmd, void *arg)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc) return -EINVAL;
+
+   FileDescriptor *file = FD_Get(proc, fd);
+   if (!file) return -EBADF;
+
+   if (file->pipe || !file->inode || !fd_is_stream(file)) return -ENODEV;
+
+   return DEVFS_Ioctl((DEVFS_File *)((VFS_File *)file->inode)->fs_file, cmd,
+                      arg);
+}
+
+// Drop the process's reference to its descriptor table.  Fork
+// siblings may still share it; the last reference closes the open
+// descriptors (walking only the set bits) and frees the table.
 void FD_CloseAll(void *proc_ptr)
 {
    Process *proc = (Process *)proc_ptr;
 
-   if (!proc) return;
+   if (!proc || !proc->fd_table) return;
 
-   for (int i = 0; i < FD_TABLE_SIZE; i++)
+   FdTable *table = proc->fd_table;
+   proc->fd_table = NULL;
+
+   if (table->ref_count > 0) --table->ref_count;
+   if (table->ref_count > 0) return;
+
+   uint32_t bits = table->bitmap;
+   while (bits)
    {
-      if (proc->fd_table[i] != NULL) FD_Close(proc, i);
+      int fd = __builtin_ctz(bits);
+      bits &= bits - 1;
+      fd_release(table->entries[fd]);
+      table->entries[fd] = NULL;
    }
+
+   free(table);
 }
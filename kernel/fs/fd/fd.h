@@ -18,6 +18,44 @@ this file, so for external modules, include fs/fs.h instead.
 #define O_APPEND 0x0400
 #define O_CREAT 0x0040
 #define O_TRUNC 0x0200
+#define O_NONBLOCK 0x0800
+
+/* One scatter-gather segment (layout matches the userspace iovec). */
+typedef struct
+{
+   void *iov_base;
+   uint32_t iov_len;
+} FD_IoVec;
+
+/* Maximum segments accepted per readv/writev call */
+#define FD_IOV_MAX 16
+
+/* Poll event bits (POSIX values, shared verbatim with userspace) */
+#define POLLIN 0x001
+#define POLLOUT 0x004
+#define POLLERR 0x008
+#define POLLHUP 0x010
+#define POLLNVAL 0x020
+
+/* One polled descriptor (layout matches the userspace pollfd) */
+typedef struct
+{
+   int fd;
+   short events;  /* Requested: POLLIN/POLLOUT */
+   short revents; /* Returned: requested bits plus ERR/HUP/NVAL */
+} FD_PollFd;
+
+/* Maximum descriptors accepted per poll call */
+#define FD_POLL_MAX 16
+
+/* One record returned by FD_GetDents (layout matches the userspace
+ * dirent; the name length mirrors VFS_DirEntry) */
+typedef struct
+{
+   uint32_t d_size; /* File size in bytes */
+   uint8_t d_isdir; /* 1 for directories */
+   char d_name[32]; /* NUL-terminated entry name */
+} FD_Dirent;
 
 typedef struct
 {
@@ -26,21 +64,63 @@ typedef struct
    bool readable;
    bool writable;
    void *inode;
+   void *pipe; /* Pipe* when this is a pipe end (inode stays NULL) */
    uint32_t flags;
    uint32_t ref_count;
 } FileDescriptor;
 
+/* Per-process descriptor table.  fork shares the table by reference
+ * and the first mutation (open/close/dup) in either process copies it
+ * lazily, so fork+exec pipelines never pay for a duplicate.  The
+ * FileDescriptor objects stay shared across a copy - offsets keep
+ * POSIX shared-open-file semantics. */
+typedef struct
+{
+   uint32_t ref_count; /* processes referencing this table */
+   uint32_t bitmap;    /* bit n set while entries[n] is in use */
+   FileDescriptor *entries[FD_TABLE_SIZE];
+} FdTable;
+
 // Core FD operations
 int FD_Open(void *proc, const char *path, int flags, uint16_t mode);
 int FD_Close(void *proc, int fd);
 int FD_Read(void *proc, int fd, void *buf, uint32_t count);
 int FD_Write(void *proc, int fd, const void *buf, uint32_t count);
+
+// Scatter-gather variants: one lookup/permission check/seek per call,
+// then each segment streams from the filesystem cursor in order
+int FD_Readv(void *proc, int fd, const FD_IoVec *iov, int iovcnt);
+int FD_Writev(void *proc, int fd, const FD_IoVec *iov, int iovcnt);
 int FD_Lseek(void *proc, int fd, int32_t offset, int whence);
 
+// Wait for readiness on several descriptors at once.  timeout_ms < 0
+// blocks until an event, 0 polls once, > 0 bounds the wait.  Returns
+// the number of descriptors with nonzero revents.
+int FD_Poll(void *proc, FD_PollFd *fds, uint32_t nfds, int timeout_ms);
+
+// Device control on a devfs-backed descriptor (e.g. TTY_IOCTL_SETFLAGS
+// to drop into raw mode); -ENODEV for anything else
+int FD_Ioctl(void *proc, int fd, uint32_t cmd, void *arg);
+
+// Fill buf with as many FD_Dirent records as fit; returns the number
+// of bytes written (0 at end of directory)
+int FD_GetDents(void *proc, int fd, void *buf, uint32_t count);
+int FD_Dup(void *proc, int oldfd);
+int FD_Dup2(void *proc, int oldfd, int newfd);
+
+// Create an anonymous pipe; fds[0] receives the read end, fds[1] the
+// write end (fs/pipe/pipe.c provides the ring-buffer transport)
+int FD_Pipe(void *proc, int fds[2]);
+
 // Helper functions
 FileDescriptor *FD_Get(void *proc, int fd);
 int FD_FindFree(void *proc);
 void FD_CloseAll(void *proc);
 void FD_Retain(FileDescriptor *file);
 
+// Table lifecycle (lazy copy-on-write sharing across fork)
+FdTable *FD_TableCreate(void);
+FdTable *FD_TableShare(FdTable *table);
+int FD_TableUnshare(void *proc);
+
 #endif
\ No newline at end of file
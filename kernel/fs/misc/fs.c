@@ -3,6 +3,7 @@
 #include <fs/devfs/devfs.h>
 #include <fs/fat/fat.h>
 #include <fs/fs.h>
+#include <fs/tmpfs/tmpfs.h>
 #include <fs/vfs/vfs.h>
 #include <mem/mm_kernel.h>
 #include <std/stdio.h>
@@ -32,6 +33,29 @@ static int InitializeDevfs(void)
    return SUCCESS;
 }
 
+/**
+ * Initialize the RAM-backed tmpfs on its reserved volume slot and
+ * mount it at /tmp, so scratch files never reach a disk driver.
+ */
+static int InitializeTmpfs(void)
+{
+   int rc = TMPFS_Initialize();
+   if (rc < 0)
+   {
+      logfmt(LOG_ERROR, "[FS] Failed to initialize tmpfs\n");
+      return rc;
+   }
+
+   /* Mount tmpfs at /tmp */
+   Partition *tmpfs_part = TMPFS_GetPartition();
+   if (tmpfs_part)
+   {
+      FS_Mount(tmpfs_part, "/tmp");
+   }
+
+   return SUCCESS;
+}
+
 /**
  * Initialize storage system: scan and initialize all disks
  *
@@ -48,6 +72,11 @@ int FS_Initialize(void)
    int rc = InitializeDevfs();
    if (rc < 0) return rc;
 
+   /* Tmpfs only needs the PMM, which is up well before FS_Initialize;
+    * mounting it here keeps /tmp available as early as /dev. */
+   rc = InitializeTmpfs();
+   if (rc < 0) return rc;
+
    /* Call DISK_Initialize to scan and populate all volumes.
     * This will also trigger drivers to register their devices
     * in devfs during the scan process. */
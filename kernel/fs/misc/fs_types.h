@@ -16,6 +16,7 @@ typedef enum FilesystemType
    FAT32 = 3,
    EXT2 = 4,
    DEVFS = 5,
+   TMPFS = 6,
 } FilesystemType;
 
 #endif
@@ -1,11 +1,18 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include <arch/i686/drivers/serial.h>
+#include <cpu/lockstat.h>
+#include <cpu/profile.h>
 #include <drivers/tty/tty.h>
+#include <hal/irq.h>
 #include <fs/devfs/devfs.h>
 #include <mem/mm_kernel.h>
+#include <std/klog.h>
 #include <std/stdio.h>
 #include <std/string.h>
+#include <std/trace.h>
 #include <stddef.h>
+#include <syscall/syscall.h>
 
 /*
  * Standard device implementations for devfs
@@ -29,7 +36,7 @@ static uint32_t null_write(DEVFS_DeviceNode *node, uint32_t offset,
    (void)node;
    (void)offset;
    (void)buffer;
-   return size; /* Accept all writes */
+   return size; /* Accept all writes without touching the buffer */
 }
 
 const DEVFS_DeviceOps null_ops = {
@@ -43,6 +50,10 @@ static uint32_t zero_read(DEVFS_DeviceNode *node, uint32_t offset,
    (void)offset;
    if (buffer && size > 0)
    {
+      /* One memset over the caller's buffer, no staging.  memset
+       * resolves to the SSE fill (mem/memory.c) on capable CPUs, which
+       * already streams in cache-line-wide stores - a single wide call
+       * beats any page-sized chunking loop here. */
       memset(buffer, 0, size);
    }
    return size;
@@ -68,11 +79,122 @@ static uint32_t full_write(DEVFS_DeviceNode *node, uint32_t offset,
 const DEVFS_DeviceOps full_ops = {
     .read = zero_read, .write = full_write, .ioctl = NULL, .close = NULL};
 
+/* /dev/kmsg - the kernel log ring. The file offset is a klog byte
+ * sequence number, so sequential reads follow the log and a reader that
+ * fell behind a full ring is advanced past the lost bytes. Writes are
+ * injected into the log. */
+static uint32_t kmsg_read(DEVFS_DeviceNode *node, uint32_t offset,
+                          uint32_t size, void *buffer)
+{
+   (void)node;
+   return KLOG_ReadAt(offset, size, buffer);
+}
+
+static uint32_t kmsg_write(DEVFS_DeviceNode *node, uint32_t offset,
+                           uint32_t size, const void *buffer)
+{
+   (void)node;
+   (void)offset; /* The log only appends */
+   KLOG_Write(buffer, size);
+   return size;
+}
+
+const DEVFS_DeviceOps kmsg_ops = {
+    .read = kmsg_read, .write = kmsg_write, .ioctl = NULL, .close = NULL};
+
+/* /dev/trace - tracepoint ring buffers as fixed-width text lines.
+ * Enable/disable of individual sites goes through the tracectl
+ * syscall; the node itself is read-only. */
+static uint32_t trace_read(DEVFS_DeviceNode *node, uint32_t offset,
+                           uint32_t size, void *buffer)
+{
+   (void)node;
+   return Trace_Read(offset, size, buffer);
+}
+
+const DEVFS_DeviceOps trace_ops = {
+    .read = trace_read, .write = NULL, .ioctl = NULL, .close = NULL};
+
+/* /dev/kstat - per-syscall call counts and cycle totals, populated
+ * when the kernel is booted with the syscall_prof flag. */
+static uint32_t kstat_read(DEVFS_DeviceNode *node, uint32_t offset,
+                           uint32_t size, void *buffer)
+{
+   (void)node;
+   return Syscall_ProfileRead(offset, size, buffer);
+}
+
+const DEVFS_DeviceOps kstat_ops = {
+    .read = kstat_read, .write = NULL, .ioctl = NULL, .close = NULL};
+
+/* /dev/heapstat - counters from the incremental heap integrity sweep
+ * plus the free()-time canary checks. */
+static uint32_t heapstat_read(DEVFS_DeviceNode *node, uint32_t offset,
+                              uint32_t size, void *buffer)
+{
+   (void)node;
+   return Heap_StatsRead(offset, size, buffer);
+}
+
+const DEVFS_DeviceOps heapstat_ops = {
+    .read = heapstat_read, .write = NULL, .ioctl = NULL, .close = NULL};
+
+/* /dev/irqstat - per-vector IRQ dispatch counts, cycle totals and
+ * latency histograms, measured unconditionally in the dispatch path. */
+static uint32_t irqstat_read(DEVFS_DeviceNode *node, uint32_t offset,
+                             uint32_t size, void *buffer)
+{
+   (void)node;
+   return i686_IRQ_StatsRead(offset, size, buffer);
+}
+
+const DEVFS_DeviceOps irqstat_ops = {
+    .read = irqstat_read, .write = NULL, .ioctl = NULL, .close = NULL};
+
+/* /dev/profile - EIP samples from the timer interrupt, populated when
+ * the kernel is booted with the profile flag.  Post-process with
+ * scripts/profile_symbolize.py. */
+static uint32_t profile_read(DEVFS_DeviceNode *node, uint32_t offset,
+                             uint32_t size, void *buffer)
+{
+   (void)node;
+   return Profile_Read(offset, size, buffer);
+}
+
+const DEVFS_DeviceOps profile_ops = {
+    .read = profile_read, .write = NULL, .ioctl = NULL, .close = NULL};
+
+/* /dev/lockstat - acquisition, spin and hold-cycle counters of every
+ * spinlock registered with Lockstat_Register. */
+static uint32_t lockstat_read(DEVFS_DeviceNode *node, uint32_t offset,
+                              uint32_t size, void *buffer)
+{
+   (void)node;
+   return Lockstat_Read(offset, size, buffer);
+}
+
+const DEVFS_DeviceOps lockstat_ops = {
+    .read = lockstat_read, .write = NULL, .ioctl = NULL, .close = NULL};
+
+/* /dev/ttyS0 - COM1 serial port.  Writes hand whole buffers to the
+ * interrupt-driven TX ring in one call; no per-byte polling. */
+static uint32_t serial_write(DEVFS_DeviceNode *node, uint32_t offset,
+                             uint32_t size, const void *buffer)
+{
+   (void)node;
+   (void)offset;
+   return i686_Serial_Write(buffer, size);
+}
+
+const DEVFS_DeviceOps serial_ops = {
+    .read = NULL, .write = serial_write, .ioctl = NULL, .close = NULL};
+
 /* TTY device operations - use external functions from tty.c */
 static const DEVFS_DeviceOps tty_ops = {.read = TTY_DevfsRead,
                                         .write = TTY_DevfsWrite,
                                         .ioctl = TTY_DevfsIoctl,
-                                        .close = NULL};
+                                        .close = NULL,
+                                        .poll = TTY_DevfsPoll};
 
 void register_standard_devices(void)
 {
@@ -85,6 +207,34 @@ void register_standard_devices(void)
    /* Register /dev/full */
    DEVFS_RegisterDevice("full", DEVFS_TYPE_CHAR, 1, 7, 0, &full_ops, NULL);
 
+   /* Register /dev/kmsg - kernel log ring buffer */
+   DEVFS_RegisterDevice("kmsg", DEVFS_TYPE_CHAR, 1, 11, 0, &kmsg_ops, NULL);
+
+   /* Register /dev/trace - tracepoint ring buffers */
+   DEVFS_RegisterDevice("trace", DEVFS_TYPE_CHAR, 1, 15, 0, &trace_ops, NULL);
+
+   /* Register /dev/kstat - syscall profiling table */
+   DEVFS_RegisterDevice("kstat", DEVFS_TYPE_CHAR, 1, 16, 0, &kstat_ops, NULL);
+
+   /* Register /dev/profile - timer-interrupt EIP samples */
+   DEVFS_RegisterDevice("profile", DEVFS_TYPE_CHAR, 1, 17, 0, &profile_ops,
+                        NULL);
+
+   /* Register /dev/lockstat - spinlock contention counters */
+   DEVFS_RegisterDevice("lockstat", DEVFS_TYPE_CHAR, 1, 19, 0, &lockstat_ops,
+                        NULL);
+
+   /* Register /dev/irqstat - IRQ dispatch latency table */
+   DEVFS_RegisterDevice("irqstat", DEVFS_TYPE_CHAR, 1, 18, 0, &irqstat_ops,
+                        NULL);
+
+   /* Register /dev/heapstat - heap integrity sweep counters */
+   DEVFS_RegisterDevice("heapstat", DEVFS_TYPE_CHAR, 1, 20, 0, &heapstat_ops,
+                        NULL);
+
+   /* Register /dev/ttyS0 - COM1 serial port (batched, non-blocking TX) */
+   DEVFS_RegisterDevice("ttyS0", DEVFS_TYPE_CHAR, 4, 64, 0, &serial_ops, NULL);
+
    /* Register /dev/tty - controlling terminal (uses active TTY) */
    DEVFS_RegisterDevice("tty", DEVFS_TYPE_CHAR, 5, 0, 0, &tty_ops, NULL);
 
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "pipe.h"
+#include <cpu/process.h>
+#include <hal/io.h>
+#include <mem/mm_kernel.h>
+#include <std/minmax.h>
+#include <std/stdio.h>
+
+/*
+ * Anonymous pipe transport
+ *
+ * A fixed-size ring buffer moved with memcpy in at most two chunks per
+ * transfer (one when the range does not wrap).  Blocking follows the
+ * ATA driver's pattern: block on the channel, re-check the condition
+ * before the switch happens in case the peer already woke us, then
+ * hlt until the next interrupt lets the scheduler run someone else.
+ */
+
+/* Sleep one beat on a wait channel (see ata_channel_acquire).  The
+ * caller re-evaluates its condition after every return. */
+static void pipe_wait(void *channel, bool ready)
+{
+   Process *cur = Process_GetCurrent();
+   if (cur)
+   {
+      Process_BlockOn(cur, channel);
+      /* Re-check before the switch happens; the peer may already have
+       * made progress and issued the wake. */
+      if (ready) Process_Unblock(cur);
+   }
+
+   uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+   g_HalIoOperations->iowait();
+   if (!interrupts_were_enabled) g_HalIoOperations->DisableInterrupts();
+}
+
+Pipe *Pipe_Create(void)
+{
+   Pipe *pipe = (Pipe *)kzalloc(sizeof(Pipe));
+   if (!pipe) return NULL;
+
+   pipe->buffer = (uint8_t *)kmalloc(PIPE_BUF_SIZE);
+   if (!pipe->buffer)
+   {
+      free(pipe);
+      return NULL;
+   }
+
+   pipe->readers = 1;
+   pipe->writers = 1;
+   return pipe;
+}
+
+void Pipe_ReleaseEnd(Pipe *pipe, bool write_end)
+{
+   if (!pipe) return;
+
+   if (write_end)
+   {
+      if (pipe->writers > 0) pipe->writers--;
+   }
+   else
+   {
+      if (pipe->readers > 0) pipe->readers--;
+   }
+
+   /* A blocked peer must notice the EOF / broken-pipe condition. */
+   Process_WakeByChannel((void *)&pipe->head);
+   Process_WakeByChannel((void *)&pipe->tail);
+
+   if (pipe->readers == 0 && pipe->writers == 0)
+   {
+      free(pipe->buffer);
+      free(pipe);
+   }
+}
+
+int Pipe_Read(Pipe *pipe, void *buf, uint32_t count)
+{
+   if (!pipe || !buf) return -EINVAL;
+   if (count == 0) return 0;
+
+   /* Block until data arrives or every writer is gone (EOF). */
+   while (pipe->count == 0)
+   {
+      if (pipe->writers == 0) return 0;
+      pipe_wait((void *)&pipe->head,
+                pipe->count > 0 || pipe->writers == 0);
+   }
+
+   uint32_t n = min(count, pipe->count);
+   uint8_t *out = (uint8_t *)buf;
+   uint32_t done = 0;
+   while (done < n)
+   {
+      uint32_t chunk = min(n - done, PIPE_BUF_SIZE - pipe->head);
+      memcpy(out + done, pipe->buffer + pipe->head, chunk);
+      pipe->head = (pipe->head + chunk) % PIPE_BUF_SIZE;
+      done += chunk;
+   }
+   pipe->count -= n;
+
+   Process_WakeByChannel((void *)&pipe->tail);
+   return (int)n;
+}
+
+int Pipe_Write(Pipe *pipe, const void *buf, uint32_t count)
+{
+   if (!pipe || !buf) return -EINVAL;
+
+   const uint8_t *in = (const uint8_t *)buf;
+   uint32_t done = 0;
+   while (done < count)
+   {
+      if (pipe->readers == 0)
+      {
+         logfmt(LOG_WARNING, "[PIPE] write on broken pipe\n");
+         return (done > 0) ? (int)done : -EIO;
+      }
+
+      if (pipe->count == PIPE_BUF_SIZE)
+      {
+         pipe_wait((void *)&pipe->tail,
+                   pipe->count < PIPE_BUF_SIZE || pipe->readers == 0);
+         continue;
+      }
+
+      uint32_t space = PIPE_BUF_SIZE - pipe->count;
+      uint32_t n = min(space, count - done);
+      uint32_t written = 0;
+      while (written < n)
+      {
+         uint32_t chunk = min(n - written, PIPE_BUF_SIZE - pipe->tail);
+         memcpy(pipe->buffer + pipe->tail, in + done + written, chunk);
+         pipe->tail = (pipe->tail + chunk) % PIPE_BUF_SIZE;
+         written += chunk;
+      }
+      pipe->count += n;
+      done += n;
+
+      Process_WakeByChannel((void *)&pipe->head);
+   }
+
+   return (int)done;
+}
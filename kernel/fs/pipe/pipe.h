@@ -0,0 +1,51 @@
+#include <constants.h>
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+This is a local header file, and it is not allowed to directly include
+this file, so for external modules, include fs/fs.h instead.
+*/
+
+#ifndef PIPE_H
+#define PIPE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Ring capacity of an anonymous pipe */
+#define PIPE_BUF_SIZE 4096u
+
+/* Anonymous pipe: a kernel ring buffer with one read end and one write
+ * end, plugged into the descriptor layer by FD_Pipe.  Readers block on
+ * &head and writers on &tail (Process_BlockOn/Process_WakeByChannel),
+ * so each wake only disturbs the side that can make progress.  The
+ * readers/writers counts track live descriptor objects per end; the
+ * pipe frees itself when both drop to zero. */
+typedef struct Pipe
+{
+   uint8_t *buffer;
+   uint32_t head;    /* Next byte to read */
+   uint32_t tail;    /* Next byte to write */
+   uint32_t count;   /* Bytes currently in the ring */
+   uint32_t readers; /* Live read-end descriptors */
+   uint32_t writers; /* Live write-end descriptors */
+} Pipe;
+
+/* Allocate a pipe with one reference on each end (for the two
+ * descriptors FD_Pipe installs).  Returns NULL on allocation failure. */
+Pipe *Pipe_Create(void);
+
+/* Drop one end's reference, waking both sides so a blocked peer sees
+ * EOF or a broken pipe.  Frees the pipe when both ends are gone. */
+void Pipe_ReleaseEnd(Pipe *pipe, bool write_end);
+
+/* Read up to count bytes.  Blocks while the ring is empty and writers
+ * remain; returns 0 (EOF) once the ring drains with no writer left. */
+int Pipe_Read(Pipe *pipe, void *buf, uint32_t count);
+
+/* Write count bytes, blocking while the ring is full and readers
+ * remain.  Returns the bytes written, which is short only when the
+ * last reader disappears mid-write (-EIO if nothing was written). */
+int Pipe_Write(Pipe *pipe, const void *buf, uint32_t count);
+
+#endif
@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "tmpfs.h"
+#include <fs/vfs/vfs.h>
+#include <mem/mm_kernel.h>
+#include <std/minmax.h>
+#include <std/stdio.h>
+#include <std/string.h>
+#include <stddef.h>
+#include <sys/sys.h>
+
+/*
+ * RAM-backed scratch filesystem (tmpfs)
+ *
+ * A flat namespace of files whose data lives in physical page frames,
+ * organized as a short extent list of contiguous runs allocated with
+ * PMM_AllocateContiguous.  Frames sit in the identity-mapped kernel
+ * window, so reads and writes are straight memcpy calls - nothing in
+ * here ever touches a disk driver.  Like devfs, the filesystem exists
+ * entirely in memory on a reserved volume slot (TMPFS_VOLUME) and is
+ * mounted at /tmp by FS_Initialize.
+ */
+
+/* One contiguous run of page frames backing part of a file. */
+typedef struct
+{
+   uint32_t base;  /* Physical address of the first frame */
+   uint32_t order; /* PMM order: the run spans 1 << order frames */
+} TmpfsExtent;
+
+typedef struct
+{
+   char name[TMPFS_NAMEMAX];
+   bool in_use;
+   uint32_t size;     /* Bytes written */
+   uint32_t capacity; /* Bytes backed by the extents */
+   uint16_t mode;
+   TmpfsExtent extents[TMPFS_MAXEXTENTS];
+   uint32_t extent_count;
+} TmpfsNode;
+
+/* Open file handle.  node == NULL marks the root-directory handle,
+ * whose position doubles as the readdir slot cursor. */
+typedef struct
+{
+   TmpfsNode *node;
+   uint32_t position;
+} TmpfsFile;
+
+static TmpfsNode g_TmpfsNodes[TMPFS_MAXFILES];
+static bool g_TmpfsInitialized = false;
+
+/* Tmpfs partition and filesystem structures (in-memory) */
+static Partition g_TmpfsPartition;
+static Filesystem g_TmpfsFilesystem;
+
+/*
+ * Helper functions
+ */
+
+/* Normalize a tmpfs path - strip leading slashes.  The namespace is
+ * flat, so any further '/' makes the path invalid. */
+static const char *tmpfs_normalize_path(const char *path)
+{
+   if (!path) return NULL;
+   while (*path == '/') path++;
+   if (strchr(path, '/')) return NULL;
+   return path;
+}
+
+static TmpfsNode *tmpfs_find(const char *name)
+{
+   for (uint32_t i = 0; i < TMPFS_MAXFILES; i++)
+   {
+      if (g_TmpfsNodes[i].in_use &&
+          strncmp(g_TmpfsNodes[i].name, name, TMPFS_NAMEMAX) == 0)
+      {
+         return &g_TmpfsNodes[i];
+      }
+   }
+   return NULL;
+}
+
+static void tmpfs_free_extents(TmpfsNode *node)
+{
+   for (uint32_t i = 0; i < node->extent_count; i++)
+   {
+      PMM_FreeContiguous(node->extents[i].base, node->extents[i].order);
+   }
+   node->extent_count = 0;
+   node->capacity = 0;
+   node->size = 0;
+}
+
+/* Grow a file's backing until it covers at least minCapacity bytes.
+ * Runs double in size with each extent (capped at 32 frames), so large
+ * files stay contiguous and the extent table stays short; when a big
+ * run is not available the order backs off down to single frames. */
+static int tmpfs_grow(TmpfsNode *node, uint32_t minCapacity)
+{
+   while (node->capacity < minCapacity)
+   {
+      if (node->extent_count >= TMPFS_MAXEXTENTS)
+      {
+         logfmt(LOG_WARNING, "[TMPFS] '%s': extent table full at %u bytes\n",
+                node->name, node->capacity);
+         return -ENOMEM;
+      }
+
+      uint32_t order = min(node->extent_count, 5u);
+      uint32_t base = 0;
+      while (1)
+      {
+         base = PMM_AllocateContiguous(order);
+         if (base != 0 || order == 0) break;
+         order--;
+      }
+      if (base == 0) return -ENOMEM;
+
+      node->extents[node->extent_count].base = base;
+      node->extents[node->extent_count].order = order;
+      node->extent_count++;
+      node->capacity += (PAGE_SIZE << order);
+   }
+   return SUCCESS;
+}
+
+/* Copy bytes between a caller buffer and the extent list starting at
+ * the given file offset.  The offset range must already be backed. */
+static void tmpfs_copy(TmpfsNode *node, uint32_t offset, uint32_t count,
+                       void *out, const void *in)
+{
+   uint32_t extent = 0;
+   uint32_t extentBytes = PAGE_SIZE << node->extents[0].order;
+
+   while (offset >= extentBytes)
+   {
+      offset -= extentBytes;
+      extent++;
+      extentBytes = PAGE_SIZE << node->extents[extent].order;
+   }
+
+   while (count > 0)
+   {
+      uint32_t chunk = min(count, extentBytes - offset);
+      uint8_t *frame = (uint8_t *)node->extents[extent].base + offset;
+
+      if (out)
+         memcpy((uint8_t *)out, frame, chunk);
+      else
+         memcpy(frame, (const uint8_t *)in, chunk);
+
+      if (out) out = (uint8_t *)out + chunk;
+      if (in) in = (const uint8_t *)in + chunk;
+      count -= chunk;
+      offset = 0;
+      extent++;
+      if (count > 0) extentBytes = PAGE_SIZE << node->extents[extent].order;
+   }
+}
+
+/*
+ * Core file operations
+ */
+
+static TmpfsFile *tmpfs_open_node(TmpfsNode *node)
+{
+   TmpfsFile *file = kmalloc(sizeof(TmpfsFile));
+   if (!file) return NULL;
+
+   file->node = node;
+   file->position = 0;
+   return file;
+}
+
+static uint32_t tmpfs_read(TmpfsFile *file, uint32_t byteCount, void *dataOut)
+{
+   TmpfsNode *node = file->node;
+   if (!node || file->position >= node->size) return 0;
+
+   uint32_t count = min(byteCount, node->size - file->position);
+   if (count == 0) return 0;
+
+   tmpfs_copy(node, file->position, count, dataOut, NULL);
+   file->position += count;
+   return count;
+}
+
+static uint32_t tmpfs_write(TmpfsFile *file, uint32_t byteCount,
+                            const void *dataIn)
+{
+   TmpfsNode *node = file->node;
+   if (!node) return 0;
+
+   uint32_t end = file->position + byteCount;
+   if (end < file->position) return 0; // Wrapped past 4 GiB
+
+   if (tmpfs_grow(node, end) < 0)
+   {
+      /* Partial write up to the backed capacity */
+      if (node->capacity <= file->position) return 0;
+      byteCount = node->capacity - file->position;
+      end = node->capacity;
+   }
+
+   /* A sparse seek past the current size would leave a gap of stale
+    * frame contents; zero it before exposing it. */
+   if (file->position > node->size)
+   {
+      uint32_t gap = file->position - node->size;
+      uint8_t zero[64];
+      memset(zero, 0, sizeof(zero));
+      uint32_t at = node->size;
+      while (gap > 0)
+      {
+         uint32_t chunk = min(gap, (uint32_t)sizeof(zero));
+         tmpfs_copy(node, at, chunk, NULL, zero);
+         at += chunk;
+         gap -= chunk;
+      }
+   }
+
+   tmpfs_copy(node, file->position, byteCount, NULL, dataIn);
+   file->position = end;
+   if (end > node->size) node->size = end;
+   return byteCount;
+}
+
+/*
+ * VFS operation wrappers
+ */
+
+static VFS_File *tmpfs_make_vfs_file(Partition *partition, TmpfsFile *tf,
+                                     bool isDirectory)
+{
+   VFS_File *vf = kmalloc(sizeof(VFS_File));
+   if (!vf)
+   {
+      free(tf);
+      return NULL;
+   }
+
+   memset(vf, 0, sizeof(VFS_File));
+   vf->partition = partition;
+   vf->type = TMPFS;
+   vf->fs_file = tf;
+   vf->is_directory = isDirectory;
+   vf->size = (tf->node) ? tf->node->size : 0;
+   vf->size_gen = partition->write_gen; /* Size is fresh as of now */
+   return vf;
+}
+
+static VFS_File *tmpfs_vfs_open(Partition *partition, const char *path)
+{
+   const char *name = tmpfs_normalize_path(path);
+   if (!name) return NULL;
+
+   TmpfsNode *node = NULL;
+   bool isDirectory = (*name == '\0'); // Root directory listing
+   if (!isDirectory)
+   {
+      node = tmpfs_find(name);
+      if (!node) return NULL;
+   }
+
+   TmpfsFile *tf = tmpfs_open_node(node);
+   if (!tf) return NULL;
+
+   return tmpfs_make_vfs_file(partition, tf, isDirectory);
+}
+
+static VFS_File *tmpfs_vfs_create(Partition *partition, const char *path,
+                                  uint16_t mode)
+{
+   const char *name = tmpfs_normalize_path(path);
+   if (!name || *name == '\0' || strlen(name) >= TMPFS_NAMEMAX) return NULL;
+
+   TmpfsNode *node = tmpfs_find(name);
+   if (node)
+   {
+      /* Re-creating an existing scratch file truncates it */
+      tmpfs_free_extents(node);
+   }
+   else
+   {
+      for (uint32_t i = 0; i < TMPFS_MAXFILES && !node; i++)
+      {
+         if (!g_TmpfsNodes[i].in_use) node = &g_TmpfsNodes[i];
+      }
+      if (!node)
+      {
+         logfmt(LOG_ERROR, "[TMPFS] Create: file table full\n");
+         return NULL;
+      }
+
+      memset(node, 0, sizeof(TmpfsNode));
+      strncpy(node->name, name, TMPFS_NAMEMAX - 1);
+      node->name[TMPFS_NAMEMAX - 1] = '\0';
+      node->in_use = true;
+   }
+   node->mode = mode;
+
+   TmpfsFile *tf = tmpfs_open_node(node);
+   if (!tf) return NULL;
+
+   return tmpfs_make_vfs_file(partition, tf, false);
+}
+
+static uint32_t tmpfs_vfs_read(Partition *partition, void *fs_file,
+                               uint32_t byteCount, void *dataOut)
+{
+   (void)partition;
+   if (!fs_file || !dataOut || byteCount == 0) return 0;
+
+   return tmpfs_read((TmpfsFile *)fs_file, byteCount, dataOut);
+}
+
+static uint32_t tmpfs_vfs_write(Partition *partition, void *fs_file,
+                                uint32_t byteCount, const void *dataIn)
+{
+   (void)partition;
+   if (!fs_file || !dataIn || byteCount == 0) return 0;
+
+   return tmpfs_write((TmpfsFile *)fs_file, byteCount, dataIn);
+}
+
+static int tmpfs_vfs_seek(Partition *partition, void *fs_file, uint32_t pos)
+{
+   (void)partition;
+   if (!fs_file) return -EINVAL;
+
+   ((TmpfsFile *)fs_file)->position = pos;
+   return SUCCESS;
+}
+
+static void tmpfs_vfs_close(void *fs_file)
+{
+   /* Data persists until the file is deleted; only the handle goes. */
+   if (fs_file) free(fs_file);
+}
+
+static uint32_t tmpfs_vfs_get_size(void *fs_file)
+{
+   if (!fs_file) return 0;
+
+   TmpfsFile *tf = (TmpfsFile *)fs_file;
+   return (tf->node) ? tf->node->size : 0;
+}
+
+static int tmpfs_vfs_delete(Partition *partition, const char *path)
+{
+   (void)partition;
+
+   const char *name = tmpfs_normalize_path(path);
+   if (!name || *name == '\0') return -EINVAL;
+
+   TmpfsNode *node = tmpfs_find(name);
+   if (!node) return -ENOENT;
+
+   tmpfs_free_extents(node);
+   memset(node, 0, sizeof(TmpfsNode));
+   return SUCCESS;
+}
+
+static int tmpfs_vfs_readdir(Partition *partition, void *fs_file,
+                             VFS_DirEntry *entryOut)
+{
+   (void)partition;
+   if (!fs_file || !entryOut) return -EINVAL;
+
+   TmpfsFile *tf = (TmpfsFile *)fs_file;
+   if (tf->node) return -EINVAL; // Not the root-directory handle
+
+   while (tf->position < TMPFS_MAXFILES)
+   {
+      TmpfsNode *node = &g_TmpfsNodes[tf->position++];
+      if (!node->in_use) continue;
+
+      strncpy(entryOut->name, node->name, sizeof(entryOut->name) - 1);
+      entryOut->name[sizeof(entryOut->name) - 1] = '\0';
+      entryOut->is_directory = false;
+      entryOut->size = node->size;
+      return SUCCESS;
+   }
+
+   return -ENOENT;
+}
+
+static int tmpfs_vfs_chmod(Partition *partition, const char *path,
+                           uint16_t mode)
+{
+   (void)partition;
+
+   const char *name = tmpfs_normalize_path(path);
+   if (!name || *name == '\0') return -EINVAL;
+
+   TmpfsNode *node = tmpfs_find(name);
+   if (!node) return -ENOENT;
+
+   node->mode = mode;
+   return SUCCESS;
+}
+
+/* VFS operations table */
+static const VFS_Operations tmpfs_ops = {.open = tmpfs_vfs_open,
+                                         .create = tmpfs_vfs_create,
+                                         .readdir = tmpfs_vfs_readdir,
+                                         .read = tmpfs_vfs_read,
+                                         .write = tmpfs_vfs_write,
+                                         .seek = tmpfs_vfs_seek,
+                                         .close = tmpfs_vfs_close,
+                                         .get_size = tmpfs_vfs_get_size,
+                                         .delete = tmpfs_vfs_delete,
+                                         .chmod = tmpfs_vfs_chmod};
+
+const VFS_Operations *TMPFS_GetVFSOperations(void) { return &tmpfs_ops; }
+
+Partition *TMPFS_GetPartition(void)
+{
+   return g_TmpfsInitialized ? &g_TmpfsPartition : NULL;
+}
+
+int TMPFS_Initialize(void)
+{
+   if (g_TmpfsInitialized)
+   {
+      logfmt(LOG_WARNING, "[TMPFS] Already initialized\n");
+      return SUCCESS;
+   }
+
+   memset(g_TmpfsNodes, 0, sizeof(g_TmpfsNodes));
+
+   /* Initialize the in-memory filesystem structure */
+   memset(&g_TmpfsFilesystem, 0, sizeof(Filesystem));
+   g_TmpfsFilesystem.type = TMPFS;
+   g_TmpfsFilesystem.ops = &tmpfs_ops;
+   g_TmpfsFilesystem.mounted = 0;
+   g_TmpfsFilesystem.read_only = 0;
+   g_TmpfsFilesystem.block_size = PAGE_SIZE;
+
+   /* Initialize the in-memory partition structure */
+   memset(&g_TmpfsPartition, 0, sizeof(Partition));
+   g_TmpfsPartition.disk = NULL; /* No backing disk */
+   g_TmpfsPartition.fs = &g_TmpfsFilesystem;
+   g_TmpfsPartition.uuid = 0x7E307E30; /* Marker UUID for tmpfs */
+   strncpy(g_TmpfsPartition.label, "tmpfs", sizeof(g_TmpfsPartition.label) - 1);
+   g_TmpfsPartition.isRootPartition = false;
+
+   /* Place tmpfs partition in its reserved volume slot */
+   g_SysInfo->volume[TMPFS_VOLUME] = g_TmpfsPartition;
+   g_SysInfo->volume[TMPFS_VOLUME].fs = &g_TmpfsFilesystem;
+
+   g_TmpfsInitialized = true;
+   logfmt(LOG_INFO, "[TMPFS] Initialized on volume[%d]\n", TMPFS_VOLUME);
+
+   return SUCCESS;
+}
@@ -0,0 +1,43 @@
+#include <constants.h>
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+This is a local header file, and it is not allowed to directly include
+this file, so for external modules, include fs/fs.h instead.
+To interact with the filesystem, use the VFS interface defined in fs/fs.h.
+*/
+
+#ifndef TMPFS_H
+#define TMPFS_H
+
+#include <fs/fs.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Reserved volume slot for tmpfs (devfs owns DEVFS_VOLUME = 30) */
+#define TMPFS_VOLUME 29
+
+/* Maximum number of files in the (flat) tmpfs namespace */
+#define TMPFS_MAXFILES 64
+
+/* Maximum file name length, including the terminator */
+#define TMPFS_NAMEMAX 64
+
+/* Maximum contiguous-frame extents per file */
+#define TMPFS_MAXEXTENTS 16
+
+/* Initialize tmpfs on its reserved volume slot.  FS_Initialize mounts
+ * the returned partition at /tmp. */
+int TMPFS_Initialize(void);
+
+/* The in-memory partition tmpfs lives on (NULL before initialization) */
+Partition *TMPFS_GetPartition(void);
+
+/* VFS Integration */
+struct VFS_Operations;
+typedef struct VFS_Operations VFS_Operations;
+
+/* Get VFS operations structure for tmpfs */
+const VFS_Operations *TMPFS_GetVFSOperations(void);
+
+#endif
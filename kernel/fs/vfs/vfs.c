@@ -2,9 +2,11 @@
 
 #include "vfs.h"
 
+#include <cpu/execcache.h>
 #include <fs/devfs/devfs.h>
 #include <fs/fat/fat.h>
 #include <fs/fs.h>
+#include <fs/tmpfs/tmpfs.h>
 #include <mem/mm_kernel.h>
 #include <std/stdio.h>
 #include <std/string.h>
@@ -25,6 +27,8 @@ static const VFS_Operations *get_fs_operations(FilesystemType type)
       return FAT_GetVFSOperations();
    case DEVFS:
       return DEVFS_GetVFSOperations();
+   case TMPFS:
+      return TMPFS_GetVFSOperations();
    default:
       return NULL;
    }
@@ -152,8 +156,10 @@ int FS_Mount(Partition *volume, const char *location)
       return -1;
    }
 
-   /* Allow NULL disk for in-memory filesystems like devfs */
-   if (!volume->disk && (!volume->fs || volume->fs->type != DEVFS))
+   /* Allow NULL disk for in-memory filesystems like devfs and tmpfs */
+   if (!volume->disk &&
+       (!volume->fs ||
+        (volume->fs->type != DEVFS && volume->fs->type != TMPFS)))
    {
       logfmt(LOG_ERROR, "Invalid volume for mount (no disk)\n");
       return -1;
@@ -353,6 +359,10 @@ int VFS_Delete(const char *path)
 
    int result = part->fs->ops->delete(part, relative);
    free(relative);
+
+   /* A deleted binary must not be served from the exec cache. */
+   if (result == SUCCESS) ExecCache_Invalidate(path);
+
    return result;
 }
 
@@ -386,6 +396,32 @@ int VFS_Access(const char *path, uint32_t uid, uint32_t gid, uint8_t accessMask)
    return result;
 }
 
+int VFS_Stat(const char *path, VFS_StatInfo *out)
+{
+   if (!out) return -EINVAL;
+
+   Partition *part = NULL;
+   char *relative = kmalloc(VFS_MAX_PATH);
+   if (!relative) return -EIO;
+
+   int rc = vfs_resolve_path(path, &part, relative, VFS_MAX_PATH);
+   if (rc < 0)
+   {
+      free(relative);
+      return rc;
+   }
+
+   if (!part || !part->fs || !part->fs->ops || !part->fs->ops->stat)
+   {
+      free(relative);
+      return VFS_ENOTSUP;
+   }
+
+   int result = part->fs->ops->stat(part, relative, out);
+   free(relative);
+   return result;
+}
+
 int VFS_Chmod(const char *path, uint16_t mode)
 {
    Partition *part = NULL;
@@ -434,6 +470,30 @@ int VFS_Chown(const char *path, uint32_t uid, uint32_t gid)
    return result;
 }
 
+int VFS_Fscntl(const char *path, uint32_t cmd, void *arg)
+{
+   Partition *part = NULL;
+   char *relative = kmalloc(VFS_MAX_PATH);
+   if (!relative) return -EIO;
+
+   int rc = vfs_resolve_path(path, &part, relative, VFS_MAX_PATH);
+   if (rc < 0)
+   {
+      free(relative);
+      return rc;
+   }
+
+   if (!part || !part->fs || !part->fs->ops || !part->fs->ops->fscntl)
+   {
+      free(relative);
+      return VFS_ENOTSUP;
+   }
+
+   int result = part->fs->ops->fscntl(part, relative, cmd, arg);
+   free(relative);
+   return result;
+}
+
 uint32_t VFS_Read(VFS_File *file, uint32_t byteCount, void *dataOut)
 {
    if (!file || !dataOut || byteCount == 0) return 0;
@@ -453,8 +513,21 @@ uint32_t VFS_Write(VFS_File *file, uint32_t byteCount, const void *dataIn)
        !file->partition->fs->ops->write)
       return 0;
 
-   return file->partition->fs->ops->write(file->partition, file->fs_file,
-                                          byteCount, dataIn);
+   uint32_t written = file->partition->fs->ops->write(
+       file->partition, file->fs_file, byteCount, dataIn);
+
+   if (written > 0)
+   {
+      /* Invalidate every other handle's cached size on this partition
+       * and refresh our own, so back-to-back append bursts never leave
+       * the size cache behind. */
+      file->partition->write_gen++;
+      if (file->partition->fs->ops->get_size)
+         file->size = file->partition->fs->ops->get_size(file->fs_file);
+      file->size_gen = file->partition->write_gen;
+   }
+
+   return written;
 }
 
 int VFS_Seek(VFS_File *file, uint32_t position)
@@ -509,7 +582,14 @@ uint32_t VFS_GetSize(VFS_File *file)
        !file->partition->fs->ops->get_size)
       return file->size; /* Fallback to cached size */
 
-   return file->partition->fs->ops->get_size(file->fs_file);
+   /* The cached size is good as long as nothing was written to the
+    * partition since it was taken - the common lseek(SEEK_END)/stat
+    * burst then costs two loads and a compare. */
+   if (file->size_gen == file->partition->write_gen) return file->size;
+
+   file->size = file->partition->fs->ops->get_size(file->fs_file);
+   file->size_gen = file->partition->write_gen;
+   return file->size;
 }
 
 void VFS_SelfTest(void)
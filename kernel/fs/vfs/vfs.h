@@ -31,6 +31,18 @@ typedef struct Partition Partition;
 #define VFS_ENOTSUP (-5)
 #define VFS_EOF (-6)
 
+/* File metadata returned by VFS_Stat.  Served from the filesystem's
+ * caches (dentry cache, metadata index) where warm, so a repeated stat
+ * costs no disk I/O. */
+typedef struct
+{
+   uint32_t size;     /* Size in bytes (0 for directories) */
+   uint16_t mode;     /* Permission bits (rwxrwxrwx) */
+   uint32_t uid;      /* Owner user id */
+   uint32_t gid;      /* Owner group id */
+   bool is_directory; /* Directory flag */
+} VFS_StatInfo;
+
 /* VFS operations structure - Linux-style function pointers */
 typedef struct VFS_Operations
 {
@@ -50,15 +62,32 @@ typedef struct VFS_Operations
    int (*chmod)(Partition *partition, const char *path, uint16_t mode);
    int (*chown)(Partition *partition, const char *path, uint32_t uid,
                 uint32_t gid);
+   int (*fscntl)(Partition *partition, const char *path, uint32_t cmd,
+                 void *arg);
+   int (*stat)(Partition *partition, const char *path, VFS_StatInfo *out);
 } VFS_Operations;
 
+/* Filesystem maintenance/control commands (VFS_Fscntl).  Filesystems
+ * that implement none of them simply leave ops->fscntl NULL. */
+#define VFS_FSCNTL_FRAG_REPORT 1u /* arg: VFS_FragReport* */
+#define VFS_FSCNTL_DEFRAG 2u      /* arg: unused */
+
+typedef struct
+{
+   uint32_t clusters;  /* Allocation units in the file's chain */
+   uint32_t fragments; /* Contiguous runs; 1 means fully contiguous */
+} VFS_FragReport;
+
 typedef struct VFS_File
 {
    Partition *partition; /* Resolved partition for this open file */
    FilesystemType type;  /* Filesystem implementation backing this node */
    void *fs_file;        /* Opaque FS-specific handle (e.g., FAT_File *) */
    bool is_directory;    /* Cached directory flag for quick checks */
-   uint32_t size;        /* Size in bytes if known (0 for dirs/unknown) */
+   uint32_t size;        /* Cached size in bytes (0 for dirs/unknown) */
+   uint32_t size_gen;    /* partition->write_gen when `size` was cached;
+                            a mismatch means another handle may have
+                            grown the file and the cache is stale */
 } VFS_File;
 
 typedef struct VFS_DirEntry
@@ -86,6 +115,8 @@ int VFS_Access(const char *path, uint32_t uid, uint32_t gid,
                uint8_t accessMask);
 int VFS_Chmod(const char *path, uint16_t mode);
 int VFS_Chown(const char *path, uint32_t uid, uint32_t gid);
+int VFS_Fscntl(const char *path, uint32_t cmd, void *arg);
+int VFS_Stat(const char *path, VFS_StatInfo *out);
 
 uint32_t VFS_GetSize(VFS_File *file);
 
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef HAL_FPU_H
+#define HAL_FPU_H
+
+#if defined(I686)
+#include <arch/i686/cpu/fpu.h>
+#define HAL_ARCH_FPU_Initialize i686_FPU_Initialize
+#define HAL_ARCH_FPU_Flush i686_FPU_Flush
+#define HAL_ARCH_FPU_Discard i686_FPU_Discard
+#else
+#error "Unsupported architecture for HAL FPU"
+#endif
+
+typedef struct HAL_FpuOperations
+{
+   /* Write the lazy owner's live FPU/SSE registers back to its PCB
+    * buffer (fork copies the buffer to the child). */
+   void (*Flush)(void);
+   /* Drop ownership without saving (exec discards the old image). */
+   void (*Discard)(void);
+} HAL_FpuOperations;
+
+extern const HAL_FpuOperations *g_HalFpuOperations;
+
+#endif
@@ -1,15 +1,20 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "hal.h"
+#include "fpu.h"
 #include "io.h"
 #include "irq.h"
 #include "mem.h"
 #include "scheduler.h"
+#include "signal.h"
 #include "stack.h"
 #include "syscall.h"
 #include "tss.h"
 #include "video.h"
+#include <cpu/timer.h>
+#include <std/compiler.h>
 
+#ifndef HAL_STATIC
 const HAL_IoOperations *g_HalIoOperations = &(HAL_IoOperations){
     .outb = HAL_ARCH_outb,
     .outw = HAL_ARCH_outw,
@@ -24,18 +29,27 @@ const HAL_IoOperations *g_HalIoOperations = &(HAL_IoOperations){
     .Panic = HAL_ARCH_Panic,
     .Reboot = HAL_ARCH_Reboot,
 };
+#endif /* !HAL_STATIC */
 
+#ifndef HAL_STATIC
 const HAL_VideoOperations *g_HalVideoOperations = &(HAL_VideoOperations){
     .PutChar = HAL_ARCH_Video_PutChar,
+    .WriteStream = HAL_ARCH_Video_WriteStream,
     .Clear = HAL_ARCH_Video_Clear,
     .SetCursor = HAL_ARCH_Video_SetCursor,
     .GetCursor = HAL_ARCH_Video_GetCursor,
+    .Scrollback = HAL_ARCH_Video_Scrollback,
+    .SaveText = HAL_ARCH_Video_SaveText,
+    .RestoreText = HAL_ARCH_Video_RestoreText,
 };
+#endif /* !HAL_STATIC */
 
+#ifndef HAL_STATIC
 const HAL_IrqOperations *g_HalIrqOperations = &(HAL_IrqOperations){
     .RegisterHandler = HAL_ARCH_IRQ_RegisterHandler,
     .Unmask = HAL_ARCH_IRQ_Unmask,
 };
+#endif /* !HAL_STATIC */
 
 const HAL_PagingOperations *g_HalPagingOperations = &(HAL_PagingOperations){
     .Initialize = HAL_ARCH_Paging_Initialize,
@@ -44,9 +58,13 @@ const HAL_PagingOperations *g_HalPagingOperations = &(HAL_PagingOperations){
     .DestroyPageDirectory = HAL_ARCH_Paging_DestroyPageDirectory,
     .MapPage = HAL_ARCH_Paging_MapPage,
     .UnmapPage = HAL_ARCH_Paging_UnmapPage,
+    .MapRange = HAL_ARCH_Paging_MapRange,
+    .UnmapRange = HAL_ARCH_Paging_UnmapRange,
     .GetPhysicalAddress = HAL_ARCH_Paging_GetPhysicalAddress,
     .IsPageMapped = HAL_ARCH_Paging_IsPageMapped,
+    .GetPageFlags = HAL_ARCH_Paging_GetPageFlags,
     .PageFaultHandler = HAL_ARCH_Paging_PageFaultHandler,
+    .ScanIdlePages = HAL_ARCH_Paging_ScanIdlePages,
     .InvalidateTlbEntry = HAL_ARCH_Paging_InvalidateTlbEntry,
     .FlushTlb = HAL_ARCH_Paging_FlushTlb,
     .SwitchPageDirectory = HAL_ARCH_Paging_SwitchPageDirectory,
@@ -66,10 +84,24 @@ const HAL_StackOperations *g_HalStackOperations = &(HAL_StackOperations){
     .SetupProcess = HAL_ARCH_Stack_SetupProcess,
 };
 
+const HAL_FpuOperations *g_HalFpuOperations = &(HAL_FpuOperations){
+    .Flush = HAL_ARCH_FPU_Flush,
+    .Discard = HAL_ARCH_FPU_Discard,
+};
+
+#ifndef HAL_STATIC
 const HAL_SchedulerOperations *g_HalSchedulerOperations =
     &(HAL_SchedulerOperations){
         .ContextSwitch = HAL_ARCH_Scheduler_ContextSwitch,
     };
+#endif /* !HAL_STATIC */
+
+#ifndef HAL_STATIC
+const HAL_SignalOperations *g_HalSignalOperations = &(HAL_SignalOperations){
+    .SetupFrames = HAL_ARCH_Signal_SetupFrames,
+    .Sigreturn = HAL_ARCH_Signal_Sigreturn,
+};
+#endif /* !HAL_STATIC */
 
 const HAL_SyscallOperations *g_HalSyscallOperations = &(HAL_SyscallOperations){
     .Handler = HAL_ARCH_Syscall_Handler,
@@ -81,7 +113,7 @@ const HAL_TssOperations *g_HalTssOperations = &(HAL_TssOperations){
     .GetKernelStack = HAL_ARCH_TSS_GetKernelStack,
 };
 
-void HAL_Initialize()
+KCOLD void HAL_Initialize()
 {
 #if defined(I686)
    i686_GDT_Initialize();
@@ -90,11 +122,21 @@ void HAL_Initialize()
    i686_ISR_Initialize();
    i686_IRQ_Initialize();
    i686_PS2_Initialize();
+   i686_Serial_Initialize();
 
    i686_IRQ_RegisterHandler(0, i686_i8253_TimerHandler);
    i686_i8253_Initialize(1000); // Set PIT to 1kHz (reasonable for OS timer)
 
+   /* Calibrate the TSC against PIT channel 2 (one-shot, leaves the
+    * scheduler tick alone) and hand the result to the monotonic clock. */
+   Timer_SetTscFrequency(i686_i8253_CalibrateTsc());
+
    i686_ISR_RegisterHandler(0x80, i686_Syscall_IRQ);
+   i686_ISR_RegisterHandler(14, i686_Paging_PageFaultIsr);
+
+   /* Lazy FPU/SSE switching: registers the #NM handler and arms
+    * CR0.TS.  After the ISR table is live, before anything runs. */
+   HAL_ARCH_FPU_Initialize();
 
    /* Initialise VGA cursor shape (blinking underline) */
    i686_VGA_Initialize();
@@ -13,6 +13,7 @@
 #include <arch/i686/cpu/isr.h>
 
 #include <arch/i686/drivers/ps2.h>
+#include <arch/i686/drivers/serial.h>
 #include <arch/i686/syscall/syscall.h>
 
 #include <arch/i686/video/vga.h>
@@ -41,6 +41,30 @@ typedef struct HAL_IoOperations
    void (*Panic)();
 } HAL_IoOperations;
 
+/* Single-architecture builds (HAL_STATIC, on by default from SConstruct)
+   bind the table at compile time: each translation unit sees a static
+   const instance, so the compiler resolves ->op() to direct calls on
+   the port-I/O and interrupt-masking hot paths.  Without HAL_STATIC the
+   indirection stays a runtime pointer populated in hal/hal.c. */
+#ifdef HAL_STATIC
+static const HAL_IoOperations HAL_IoOperationsStatic = {
+    .outb = HAL_ARCH_outb,
+    .outw = HAL_ARCH_outw,
+    .outl = HAL_ARCH_outl,
+    .inb = HAL_ARCH_inb,
+    .inw = HAL_ARCH_inw,
+    .inl = HAL_ARCH_inl,
+    .EnableInterrupts = HAL_ARCH_EnableInterrupts,
+    .DisableInterrupts = HAL_ARCH_DisableInterrupts,
+    .iowait = HAL_ARCH_iowait,
+    .Halt = HAL_ARCH_Halt,
+    .Panic = HAL_ARCH_Panic,
+    .Reboot = HAL_ARCH_Reboot,
+};
+static const HAL_IoOperations *const g_HalIoOperations
+    __attribute__((unused)) = &HAL_IoOperationsStatic;
+#else
 extern const HAL_IoOperations *g_HalIoOperations;
+#endif
 
 #endif
\ No newline at end of file
@@ -21,6 +21,16 @@ typedef struct HAL_IrqOperations
    void (*Unmask)(int irq);
 } HAL_IrqOperations;
 
+/* Compile-time binding for single-architecture builds; see hal/io.h. */
+#ifdef HAL_STATIC
+static const HAL_IrqOperations HAL_IrqOperationsStatic = {
+    .RegisterHandler = HAL_ARCH_IRQ_RegisterHandler,
+    .Unmask = HAL_ARCH_IRQ_Unmask,
+};
+static const HAL_IrqOperations *const g_HalIrqOperations
+    __attribute__((unused)) = &HAL_IrqOperationsStatic;
+#else
 extern const HAL_IrqOperations *g_HalIrqOperations;
+#endif
 
 #endif
\ No newline at end of file
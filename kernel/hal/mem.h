@@ -26,6 +26,7 @@
 #define HAL_PAGE_PRESENT 0x001
 #define HAL_PAGE_RW 0x002
 #define HAL_PAGE_USER 0x004
+#define HAL_PAGE_COW 0x200
 
 /* Paging operations abstraction */
 #define HAL_ARCH_Paging_Initialize i686_Paging_Initialize
@@ -34,9 +35,13 @@
 #define HAL_ARCH_Paging_DestroyPageDirectory i686_Paging_DestroyPageDirectory
 #define HAL_ARCH_Paging_MapPage i686_Paging_MapPage
 #define HAL_ARCH_Paging_UnmapPage i686_Paging_UnmapPage
+#define HAL_ARCH_Paging_MapRange i686_Paging_MapRange
+#define HAL_ARCH_Paging_UnmapRange i686_Paging_UnmapRange
 #define HAL_ARCH_Paging_GetPhysicalAddress i686_Paging_GetPhysicalAddress
 #define HAL_ARCH_Paging_IsPageMapped i686_Paging_IsPageMapped
+#define HAL_ARCH_Paging_GetPageFlags i686_Paging_GetPageFlags
 #define HAL_ARCH_Paging_PageFaultHandler i686_Paging_PageFaultHandler
+#define HAL_ARCH_Paging_ScanIdlePages i686_Paging_ScanIdlePages
 #define HAL_ARCH_Paging_InvalidateTlbEntry i686_Paging_InvalidateTlbEntry
 #define HAL_ARCH_Paging_FlushTlb i686_Paging_FlushTlb
 #define HAL_ARCH_Paging_SwitchPageDirectory i686_Paging_SwitchPageDirectory
@@ -68,9 +73,15 @@ typedef struct HAL_PagingOperations
    int (*MapPage)(void *page_dir, uint32_t vaddr, uint32_t paddr,
                   uint32_t flags);
    int (*UnmapPage)(void *page_dir, uint32_t vaddr);
+   int (*MapRange)(void *page_dir, uint32_t vaddr, uint32_t paddr,
+                   uint32_t page_count, uint32_t flags);
+   int (*UnmapRange)(void *page_dir, uint32_t vaddr, uint32_t page_count);
    uint32_t (*GetPhysicalAddress)(void *page_dir, uint32_t vaddr);
    int (*IsPageMapped)(void *page_dir, uint32_t vaddr);
+   uint32_t (*GetPageFlags)(void *page_dir, uint32_t vaddr);
    void (*PageFaultHandler)(uint32_t fault_address, uint32_t error_code);
+   uint32_t (*ScanIdlePages)(void *page_dir, uint32_t start, uint32_t end,
+                             uint32_t max_out);
    void (*InvalidateTlbEntry)(uint32_t vaddr);
    void (*FlushTlb)(void);
    void (*SwitchPageDirectory)(void *page_dir);
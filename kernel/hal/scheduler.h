@@ -15,6 +15,15 @@ typedef struct HAL_SchedulerOperations
    void (*ContextSwitch)(void);
 } HAL_SchedulerOperations;
 
+/* Compile-time binding for single-architecture builds; see hal/io.h. */
+#ifdef HAL_STATIC
+static const HAL_SchedulerOperations HAL_SchedulerOperationsStatic = {
+    .ContextSwitch = HAL_ARCH_Scheduler_ContextSwitch,
+};
+static const HAL_SchedulerOperations *const g_HalSchedulerOperations
+    __attribute__((unused)) = &HAL_SchedulerOperationsStatic;
+#else
 extern const HAL_SchedulerOperations *g_HalSchedulerOperations;
+#endif
 
 #endif
\ No newline at end of file
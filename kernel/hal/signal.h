@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef HAL_SIGNAL_H
+#define HAL_SIGNAL_H
+
+#include <stdint.h>
+
+#if defined(I686)
+#include <arch/i686/signal/sigframe.h>
+#define HAL_ARCH_Signal_SetupFrames i686_Signal_SetupFrames
+#define HAL_ARCH_Signal_Sigreturn i686_Signal_Sigreturn
+#else
+#error "Unsupported architecture for HAL signal"
+#endif
+
+struct Process;
+
+typedef struct HAL_SignalOperations
+{
+   /* Stack one user frame per deliverable caught signal and point the
+    * trap frame at the first handler (see arch sigframe.c). */
+   int (*SetupFrames)(struct Process *proc, Registers *regs);
+   /* Restore the context saved by SetupFrames when a handler returns. */
+   intptr_t (*Sigreturn)(struct Process *proc, Registers *regs);
+} HAL_SignalOperations;
+
+/* Compile-time binding for single-architecture builds; see hal/io.h. */
+#ifdef HAL_STATIC
+static const HAL_SignalOperations HAL_SignalOperationsStatic = {
+    .SetupFrames = HAL_ARCH_Signal_SetupFrames,
+    .Sigreturn = HAL_ARCH_Signal_Sigreturn,
+};
+static const HAL_SignalOperations *const g_HalSignalOperations
+    __attribute__((unused)) = &HAL_SignalOperationsStatic;
+#else
+extern const HAL_SignalOperations *g_HalSignalOperations;
+#endif
+
+#endif
@@ -21,9 +21,13 @@
 #if defined(I686)
 #include <arch/i686/video/vga.h>
 #define HAL_ARCH_Video_PutChar i686_VGA_PutChar
+#define HAL_ARCH_Video_WriteStream i686_VGA_WriteStream
 #define HAL_ARCH_Video_Clear i686_VGA_Clear
 #define HAL_ARCH_Video_SetCursor i686_VGA_SetCursor
 #define HAL_ARCH_Video_GetCursor i686_VGA_GetCursor
+#define HAL_ARCH_Video_Scrollback i686_VGA_Scrollback
+#define HAL_ARCH_Video_SaveText i686_VGA_SaveText
+#define HAL_ARCH_Video_RestoreText i686_VGA_RestoreText
 #define HAL_ARCH_Video_SetDisplaySize i686_VGA_SetDisplaySize
 #else
 #error "Unsupported architecture for HAL Video"
@@ -34,6 +38,11 @@ typedef struct HAL_VideoOperations
    /* Write one character to grid cell (x, y) with the given colour byte. */
    void (*PutChar)(char c, uint8_t color, int x, int y);
 
+   /* Run a whole buffer through the backend's stream parser, presenting
+    * the surface and moving the cursor once at the end instead of per
+    * character. */
+   void (*WriteStream)(const char *data, uint32_t len, uint8_t color);
+
    /* Fill the entire visible surface with the given background colour. */
    void (*Clear)(uint8_t color);
 
@@ -42,8 +51,34 @@ typedef struct HAL_VideoOperations
 
    /* Read current text cursor location. */
    void (*GetCursor)(int *x, int *y);
+
+   /* Page the view over the scrollback ring: dir > 0 toward older
+    * output, dir < 0 toward live, 0 jumps back to the live screen. */
+   void (*Scrollback)(int dir);
+
+   /* Snapshot the visible text cells into a caller-owned cols×rows
+    * image / repaint the screen from such an image with one present.
+    * Used by the TTY layer for virtual-console switching. */
+   void (*SaveText)(uint16_t *cells, int cols, int rows);
+   void (*RestoreText)(const uint16_t *cells, int cols, int rows);
 } HAL_VideoOperations;
 
+/* Compile-time binding for single-architecture builds; see hal/io.h. */
+#ifdef HAL_STATIC
+static const HAL_VideoOperations HAL_VideoOperationsStatic = {
+    .PutChar = HAL_ARCH_Video_PutChar,
+    .WriteStream = HAL_ARCH_Video_WriteStream,
+    .Clear = HAL_ARCH_Video_Clear,
+    .SetCursor = HAL_ARCH_Video_SetCursor,
+    .GetCursor = HAL_ARCH_Video_GetCursor,
+    .Scrollback = HAL_ARCH_Video_Scrollback,
+    .SaveText = HAL_ARCH_Video_SaveText,
+    .RestoreText = HAL_ARCH_Video_RestoreText,
+};
+static const HAL_VideoOperations *const g_HalVideoOperations
+    __attribute__((unused)) = &HAL_VideoOperationsStatic;
+#else
 extern const HAL_VideoOperations *g_HalVideoOperations;
+#endif
 
 #endif /* HAL_VIDEO_H */
@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/* Boot-time microbenchmark suite, compiled in when the tree is built
+ * with BuildBench=yes (which defines BENCH).  Each suite prints one
+ * machine-parsable logfmt line per data point so a serial capture can
+ * be diffed across releases to catch performance regressions.
+ *
+ * Cycle counts are raw rdtsc totals for the whole loop; divide by the
+ * printed iteration count offline.  The kernel avoids runtime 64-bit
+ * division, so no averages are computed here. */
+
+#ifdef BENCH
+
+#include <cpu/process.h>
+#include <cpu/scheduler.h>
+#include <cpu/timer.h>
+#include <fs/fs.h>
+#include <mem/mm_kernel.h>
+#include <std/klog.h>
+#include <std/stdio.h>
+#include <stdint.h>
+
+void Bench_Run(void);
+
+/* i686 only; reading the TSC needs no serializing fence for the
+ * coarse whole-loop measurements taken here. */
+static inline uint64_t bench_rdtsc(void)
+{
+   uint32_t lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((uint64_t)hi << 32) | lo;
+}
+
+/* kmalloc/free pair cost across the size classes the slab and the
+ * large-block bins serve. */
+static void bench_kmalloc(void)
+{
+   static const uint32_t sizes[] = {16, 64, 256, 1024, 4096};
+   const uint32_t iters = 4096;
+
+   for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+   {
+      uint64_t start = bench_rdtsc();
+      for (uint32_t i = 0; i < iters; i++)
+      {
+         void *p = kmalloc(sizes[s]);
+         if (!p)
+         {
+            logfmt(LOG_WARNING, "[BENCH] suite=kmalloc size=%u skip=nomem\n",
+                   sizes[s]);
+            return;
+         }
+         free(p);
+      }
+      uint64_t cycles = bench_rdtsc() - start;
+
+      logfmt(LOG_INFO, "[BENCH] suite=kmalloc size=%u iters=%u cycles=%llu\n",
+             sizes[s], iters, cycles);
+   }
+}
+
+/* memcpy bandwidth ladder: each rung copies the same 4 MiB total so
+ * the cycle counts are directly comparable across sizes. */
+static void bench_memcpy(void)
+{
+   static const uint32_t sizes[] = {64, 256, 1024, 4096, 16384, 65536};
+   const uint32_t total = 4u << 20;
+
+   uint8_t *src = kmalloc(65536);
+   uint8_t *dst = kmalloc(65536);
+   if (!src || !dst)
+   {
+      logfmt(LOG_WARNING, "[BENCH] suite=memcpy skip=nomem\n");
+      if (src) free(src);
+      if (dst) free(dst);
+      return;
+   }
+
+   for (uint32_t i = 0; i < 65536; i++)
+   {
+      src[i] = (uint8_t)(i * 31u);
+   }
+
+   for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+   {
+      uint32_t iters = total / sizes[s];
+
+      uint64_t start = bench_rdtsc();
+      for (uint32_t i = 0; i < iters; i++)
+      {
+         memcpy(dst, src, sizes[s]);
+      }
+      uint64_t cycles = bench_rdtsc() - start;
+
+      logfmt(LOG_INFO,
+             "[BENCH] suite=memcpy size=%u iters=%u bytes=%u cycles=%llu\n",
+             sizes[s], iters, total, cycles);
+   }
+
+   free(src);
+   free(dst);
+}
+
+/* FAT open and sequential-read throughput.  The workload file is
+ * generated on the mounted root at bench time rather than baked into
+ * the image, so the suite runs on any disk the kernel boots from. */
+static void bench_fat(void)
+{
+   const char *path = "/test/bench.dat";
+   const uint32_t chunk = 4096;
+   const uint32_t file_size = 64u * 1024;
+
+   uint8_t *buf = kmalloc(chunk);
+   if (!buf)
+   {
+      logfmt(LOG_WARNING, "[BENCH] suite=fat skip=nomem\n");
+      return;
+   }
+
+   VFS_File *file = VFS_Open(path);
+   if (!file) file = VFS_Create(path, 0);
+   if (!file)
+   {
+      logfmt(LOG_WARNING, "[BENCH] suite=fat skip=create\n");
+      free(buf);
+      return;
+   }
+
+   for (uint32_t i = 0; i < chunk; i++)
+   {
+      buf[i] = (uint8_t)(i * 7u);
+   }
+   if (VFS_GetSize(file) < file_size)
+   {
+      for (uint32_t written = 0; written < file_size; written += chunk)
+      {
+         if (VFS_Write(file, chunk, buf) != chunk)
+         {
+            logfmt(LOG_WARNING, "[BENCH] suite=fat skip=write\n");
+            VFS_Close(file);
+            free(buf);
+            return;
+         }
+      }
+   }
+   VFS_Close(file);
+
+   /* Open/close cost (path walk + directory lookup) */
+   const uint32_t open_iters = 64;
+   uint64_t start = bench_rdtsc();
+   for (uint32_t i = 0; i < open_iters; i++)
+   {
+      file = VFS_Open(path);
+      if (!file)
+      {
+         logfmt(LOG_WARNING, "[BENCH] suite=fatopen skip=open\n");
+         free(buf);
+         return;
+      }
+      VFS_Close(file);
+   }
+   uint64_t cycles = bench_rdtsc() - start;
+   logfmt(LOG_INFO, "[BENCH] suite=fatopen iters=%u cycles=%llu\n", open_iters,
+          cycles);
+
+   /* Sequential read throughput, several passes so the block cache
+    * steady state dominates over the first-pass disk fetch. */
+   const uint32_t read_passes = 4;
+   uint32_t bytes = 0;
+   uint64_t tick_start = Timer_GetTicks();
+   start = bench_rdtsc();
+   for (uint32_t pass = 0; pass < read_passes; pass++)
+   {
+      file = VFS_Open(path);
+      if (!file)
+      {
+         logfmt(LOG_WARNING, "[BENCH] suite=fatread skip=open\n");
+         free(buf);
+         return;
+      }
+      uint32_t got;
+      while ((got = VFS_Read(file, chunk, buf)) > 0)
+      {
+         bytes += got;
+      }
+      VFS_Close(file);
+   }
+   cycles = bench_rdtsc() - start;
+   uint32_t ticks = (uint32_t)(Timer_GetTicks() - tick_start);
+   logfmt(LOG_INFO,
+          "[BENCH] suite=fatread passes=%u bytes=%u cycles=%llu ticks=%u\n",
+          read_passes, bytes, cycles, ticks);
+
+   free(buf);
+}
+
+/* Scheduler pick cost.  No user context exists this early, so this
+ * times the decision path Scheduler_Schedule owns (class bitmaps,
+ * round-robin slot scan, Process_SetCurrent) rather than a full
+ * user-mode round-trip. */
+static void bench_sched(void)
+{
+   const uint32_t iters = 4096;
+   Process *saved = Process_GetCurrent();
+
+   uint64_t start = bench_rdtsc();
+   for (uint32_t i = 0; i < iters; i++)
+   {
+      Scheduler_Schedule();
+   }
+   uint64_t cycles = bench_rdtsc() - start;
+
+   /* Undo the picks: put whatever was selected back to READY and
+    * restore the caller as the current process. */
+   Process *picked = Process_GetCurrent();
+   if (picked && picked != saved)
+   {
+      picked->state = STATE_READY;
+   }
+   Process_SetCurrent(saved);
+   if (saved)
+   {
+      saved->state = STATE_RUNNING;
+   }
+
+   logfmt(LOG_INFO, "[BENCH] suite=sched iters=%u cycles=%llu\n", iters,
+          cycles);
+}
+
+void Bench_Run(void)
+{
+   logfmt(LOG_INFO, "[BENCH] begin version=%s\n", OS_VERSION);
+
+   bench_kmalloc();
+   bench_memcpy();
+   bench_fat();
+   bench_sched();
+
+   logfmt(LOG_INFO, "[BENCH] done\n");
+   KLOG_Drain(); /* Push the results out before the handoff to init */
+}
+
+#endif /* BENCH */
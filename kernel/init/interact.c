@@ -4,8 +4,10 @@
 #include <fs/fs.h>
 #include <hal/io.h>
 #include <mem/mm_kernel.h>
+#include <std/klog.h>
 #include <std/stdio.h>
 #include <std/string.h>
+#include <sys/pgo.h>
 
 void interact(void)
 {
@@ -32,6 +34,7 @@ void interact(void)
          else if (strcmp(buf, "shutdown") == 0)
          {
             printf("Shutting down...\n");
+            PGO_Dump(); /* No-op unless this is a Pgo=gen kernel */
             g_HalIoOperations->DisableInterrupts();
             g_HalIoOperations->Halt();
             break;
@@ -127,6 +130,43 @@ void interact(void)
             }
             printf("\n");
          }
+         else if (strncmp(buf, "frag ", 5) == 0)
+         {
+            char *path = buf + 4;
+            while (*path == ' ') path++;
+
+            VFS_FragReport report;
+            int rc = VFS_Fscntl(path, VFS_FSCNTL_FRAG_REPORT, &report);
+            if (rc == SUCCESS)
+            {
+               printf("%s: %u clusters in %u fragment%s%s\n", path,
+                      report.clusters, report.fragments,
+                      report.fragments == 1 ? "" : "s",
+                      report.fragments <= 1 ? " (contiguous)" : "");
+            }
+            else
+            {
+               printf("Error: fragmentation report for '%s' failed (%d)\n",
+                      path, rc);
+            }
+            printf("\n");
+         }
+         else if (strncmp(buf, "defrag ", 7) == 0)
+         {
+            char *path = buf + 6;
+            while (*path == ' ') path++;
+
+            int rc = VFS_Fscntl(path, VFS_FSCNTL_DEFRAG, NULL);
+            if (rc == SUCCESS)
+            {
+               printf("defragmented '%s'\n", path);
+            }
+            else
+            {
+               printf("Error: defragment of '%s' failed (%d)\n", path, rc);
+            }
+            printf("\n");
+         }
          else
          {
             printf("You typed: %s\n", buf);
@@ -136,7 +176,13 @@ void interact(void)
       }
       else
       {
-         /* Wait for interrupt/input */
+         /* TTY_Read blocks on the keyboard wake channel in process
+            context, so this branch only runs pre-scheduler or without
+            a tty: catch the console up on the log ring, zero a few
+            frames for the pre-zeroed queue, then wait for an
+            interrupt. */
+         KLOG_Drain();
+         PMM_ZeroPendingPages();
          uint8_t interrupts_were_enabled =
              g_HalIoOperations->EnableInterrupts();
          g_HalIoOperations->iowait();
@@ -1,10 +1,18 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <cpu/cpu.h>
+#include <cpu/execcache.h>
+#include <cpu/kinfo.h>
+#include <cpu/kstack.h>
+#include <cpu/kthread.h>
 #include <cpu/process.h>
+#include <cpu/profile.h>
+#include <cpu/softirq.h>
+#include <cpu/timer.h>
 #include <crypto/crypto.h>
 #include <drivers/ata/ata.h>
 #include <drivers/keyboard/keyboard.h>
+#include <drivers/net/rtl8139.h>
 #include <drivers/tty/tty.h>
 #include <fs/devfs/devfs.h>
 #include <fs/fd/fd.h>
@@ -15,9 +23,12 @@
 #include <hal/scheduler.h>
 #include <hal/video.h>
 #include <mem/mm_kernel.h>
+#include <net/net.h>
+#include <std/klog.h>
 #include <std/stdio.h>
 #include <std/string.h>
 #include <stdint.h>
+#include <syscall/syscall.h>
 #include <sys/cmdline.h>
 #include <sys/elf.h>
 #include <sys/kmod/kmod.h>
@@ -26,12 +37,109 @@
 
 extern int Init_MountRoot(void);
 extern void interact();
+#ifdef BENCH
+extern void Bench_Run(void);
+#endif
 static void __attribute__((unused, noreturn)) fallback(void);
 
 extern uint8_t __bss_start;
 extern uint8_t __end;
 extern void _init();
 
+/* -------------------------------------------------------------------------
+ * Deferred boot stages
+ *
+ * Context switching here is cooperative (a thread runs until it blocks
+ * or yields), so boot stages cannot truly overlap before the scheduler
+ * takes over.  What can move off the critical path is everything the
+ * first user process does not need: self-tests, the NIC, and the module
+ * manifest (device opens fall back to devfs lazy loading while modules
+ * are still coming up).  Those run as an ordered stage table on an
+ * "initlate" kthread that competes with the shell once start() performs
+ * its terminal context switch; the listed order is the dependency
+ * order, and everything each stage needs from the synchronous spine
+ * (mounted root, devfs, KMOD) is already up when the thread is created.
+ * ---------------------------------------------------------------------- */
+
+static void init_stage_net(void)
+{
+   RTL8139_Initialize(); /* Registers /dev/net0 when a NIC is present */
+   Net_Initialize();     /* UDP/IP over the NIC (ip=/gw= boot flags) */
+}
+
+static void init_stage_modules(void)
+{
+   /* Precomputed load order from the image build; absent manifest is fine */
+   KMOD_LoadManifest("/usr/lib/kmod.order");
+}
+
+/* Warm the exec cache with the preload= binaries so the first command
+ * after boot skips its cold FAT reads.  Runs before the self-tests:
+ * the whole point is winning the race against the user's first exec. */
+static void init_stage_preload(void)
+{
+   const char *list = CmdLine_GetString(CMDLINE_OPT_PRELOAD);
+   if (!list || !list[0]) return;
+
+   /* Comma-separated paths; copied out so the stored value is never
+    * mutated. */
+   char path[PROCESS_EXEC_PATH_MAX];
+   while (*list)
+   {
+      uint32_t len = 0;
+      while (list[len] && list[len] != ',') len++;
+
+      if (len > 0 && len < sizeof(path))
+      {
+         memcpy(path, list, len);
+         path[len] = '\0';
+
+         int pages = Process_PreloadBinary(path);
+         if (pages < 0)
+         {
+            logfmt(LOG_WARNING, "[INIT] preload: %s failed (%d)\n", path,
+                   pages);
+         }
+         else
+         {
+            logfmt(LOG_INFO, "[INIT] preload: %s (%d pages cached)\n", path,
+                   pages);
+         }
+      }
+
+      list += len;
+      if (*list == ',') list++;
+   }
+}
+
+typedef struct
+{
+   const char *name;
+   void (*fn)(void);
+} InitLateStage;
+
+static const InitLateStage s_InitLateStages[] = {
+    {"preload", init_stage_preload},
+    {"crypto-selftest", Crypto_SelfTest},
+    {"vfs-selftest", VFS_SelfTest},
+    {"net", init_stage_net},
+    {"modules", init_stage_modules},
+    {"proc-selftest", Process_SelfTest},
+};
+
+static void init_late_thread(void *arg)
+{
+   (void)arg;
+
+   for (uint32_t i = 0; i < sizeof(s_InitLateStages) / sizeof(InitLateStage);
+        ++i)
+   {
+      s_InitLateStages[i].fn();
+      logfmt(LOG_INFO, "[INIT] late stage '%s' done (t=%u ms)\n",
+             s_InitLateStages[i].name, (uint32_t)system_ticks);
+   }
+}
+
 void hold(int sec)
 {
    uint32_t last_uptime = 0;
@@ -49,6 +157,7 @@ void hold(int sec)
 
       /* Idle efficiently until next interrupt: enable interrupts, HLT,
          then disable again. Matches i686 PS/2 idle usage. */
+      KLOG_Drain();
       uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
       g_HalIoOperations->iowait();
       if (!interrupts_were_enabled)
@@ -80,9 +189,21 @@ void __attribute__((noreturn)) start(BOOT_Info *boot)
    TTY_Initialize();
    SYS_Initialize();
    CPU_Initialize();
+   KInfo_Initialize(); /* Before the first tick publishes into it */
+   Timer_Initialize(); /* Before HAL_Initialize unmasks the timer IRQ */
    HAL_Initialize();
+
+   /* From here on idle paths drain the log ring, so logfmt can defer
+    * console output; the disk scan and FS bring-up below log heavily. */
+   KLOG_EnableBuffering();
+
    CmdLine_Initialize();
-   Crypto_SelfTest();
+   Syscall_ProfileInitialize(); /* Reads the syscall_prof boot flag */
+   Profile_Initialize();        /* Reads the profile boot flag */
+   i686_IRQ_StatsInitialize();  /* Reads the irq_warn boot flag */
+   Softirq_Initialize();        /* Registers the ring lock for lockstat */
+   KStack_Initialize();         /* Registers the stack-pool lock */
+   ExecCache_Initialize();      /* Registers the exec-cache lock */
 
    if (FS_Initialize() < 0)
    {
@@ -92,7 +213,6 @@ void __attribute__((noreturn)) start(BOOT_Info *boot)
    {
       goto end;
    }
-   VFS_SelfTest();
    Keyboard_Initialize();
 
    if (KMOD_Initialize() < 0)
@@ -103,7 +223,15 @@ void __attribute__((noreturn)) start(BOOT_Info *boot)
 
    SYS_Finalize();
 
-   Process_SelfTest();
+   PMM_StartZeroThread(); /* Background frame zeroing off the idle loop */
+
+   /* Everything the first user process does not need runs after the
+    * scheduler handoff; see the stage table above. */
+   KThread_Create("initlate", init_late_thread, NULL);
+
+#ifdef BENCH
+   Bench_Run(); /* Timed suites; results go out as [BENCH] logfmt lines */
+#endif
 
    Process *shell_proc = ELF_LoadProcess("/usr/bin/selftest", false);
    if (!shell_proc)
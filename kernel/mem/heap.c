@@ -24,6 +24,62 @@ typedef struct
 } HeapBlockHeader;
 
 #define HEAP_CANARY 0xDEADBEEF
+/* canary_before while a block sits on a recycling bin; catches double
+ * frees and lets the integrity walk tell live and free blocks apart. */
+#define HEAP_CANARY_FREE 0xFEEDBEEF
+
+/* Segregated recycling bins for large blocks.
+ *
+ * Requests above the slab size classes come from the bump region below,
+ * which never reclaims on its own.  free() parks such blocks here by
+ * power-of-two size (bin 0 holds 4-8 KiB, the last bin everything from
+ * 512 KiB up) and kmalloc pops them back out in O(1), so FAT-heavy
+ * workloads recycling cluster buffers stop growing the bump pointer.
+ * Blocks are recycled whole - the header keeps the original size, so a
+ * block always returns to the same bin and no splitting or coalescing
+ * is needed. */
+#define HEAP_BIN_COUNT 8
+#define HEAP_BIN_SHIFT 12 /* bin 0 starts at 4 KiB */
+
+typedef struct FreeLargeBlock
+{
+   struct FreeLargeBlock *next;
+} FreeLargeBlock;
+
+static FreeLargeBlock *g_LargeBins[HEAP_BIN_COUNT];
+static uint32_t g_LargeBinCount[HEAP_BIN_COUNT];
+
+/* Incremental integrity scan.  heap_check_integrity walks every block
+ * in one go, which is too expensive to leave enabled in production;
+ * Heap_CheckIncremental instead validates a bounded batch per call and
+ * resumes from a cursor, so the idle loop can sweep the whole heap a
+ * slice at a time.  Corruption is counted rather than fatal - free()
+ * already refuses to recycle a block with a bad canary, and the
+ * counters surface through /dev/heapstat. */
+#define HEAP_CHECK_BATCH 32u
+
+static uintptr_t g_HeapCheckCursor = 0;
+
+static struct
+{
+   uint32_t passes;          /* complete sweeps of the bump region */
+   uint32_t blocks_checked;  /* headers validated, cumulative */
+   uint32_t corruptions;     /* bad canaries found by the sweep */
+   uint32_t free_bad_canary; /* free() rejects: canary overwritten */
+   uint32_t double_frees;    /* free() rejects: block already binned */
+   uint32_t last_corrupt;    /* header address of the last bad block */
+} g_HeapStat;
+
+/* Bin a block of `size` bytes belongs to, or -1 below the 4 KiB floor. */
+static int heap_bin_index(size_t size)
+{
+   if (size < ((size_t)1 << HEAP_BIN_SHIFT)) return -1;
+   int bin = 0;
+   while (bin + 1 < HEAP_BIN_COUNT &&
+          size >= ((size_t)1 << (HEAP_BIN_SHIFT + bin + 1)))
+      bin++;
+   return bin;
+}
 
 int Heap_ProcessInitialize(Process *proc, uint32_t heap_start_va)
 {
@@ -32,25 +88,14 @@ int Heap_ProcessInitialize(Process *proc, uint32_t heap_start_va)
    proc->heap_start = heap_start_va;
    proc->heap_end = heap_start_va;
 
-   // Allocate initial heap page
-   uint32_t phys = PMM_AllocatePhysicalPage();
-   if (phys == 0)
+   // The initial page, like brk growth, is the shared zero page mapped
+   // copy-on-write; a frame is only committed when the process writes.
+   if (Heap_ProcessBrk(proc, (void *)(heap_start_va + PAGE_SIZE)) < 0)
    {
-      logfmt(LOG_ERROR,
-             "[MEM] Heap_Initialize: PMM_AllocatePhysicalPage failed\n");
-      return -1;
-   }
-
-   // Map to process page directory
-   if (g_HalPagingOperations->MapPage(proc->page_directory, heap_start_va, phys,
-                                      0x007) < 0)
-   { // RW, Present
       logfmt(LOG_ERROR, "[MEM] Heap_Initialize: map_page failed\n");
-      PMM_FreePhysicalPage(phys);
       return -1;
    }
 
-   proc->heap_end = heap_start_va + PAGE_SIZE;
    return 0;
 }
 
@@ -66,14 +111,30 @@ int Heap_ProcessBrk(Process *proc, void *addr)
    {
       uint32_t pages_needed =
           (target - proc->heap_end + PAGE_SIZE - 1) / PAGE_SIZE;
+      uint32_t zero_page = PMM_GetZeroPage();
       for (uint32_t i = 0; i < pages_needed; ++i)
       {
          uint32_t va = proc->heap_end + (i * PAGE_SIZE);
-         uint32_t phys = PMM_AllocatePhysicalPage();
+
+         if (zero_page)
+         {
+            /* Map the shared zero page copy-on-write: sbrk growth pays
+               no frame allocation or clear until the first write. */
+            if (g_HalPagingOperations->MapPage(
+                    proc->page_directory, va, zero_page,
+                    HAL_PAGE_PRESENT | HAL_PAGE_USER | HAL_PAGE_COW) < 0)
+            {
+               logfmt(LOG_ERROR, "[MEM] brk: map_page failed at 0x%08x\n", va);
+               return -1;
+            }
+            continue;
+         }
+
+         uint32_t phys = PMM_AllocateZeroedPage();
          if (phys == 0)
          {
             logfmt(LOG_ERROR,
-                   "[MEM] brk: PMM_AllocatePhysicalPage failed at page "
+                   "[MEM] brk: PMM_AllocateZeroedPage failed at page "
                    "%u/%u\n",
                    i, pages_needed);
             return -1;
@@ -142,10 +203,53 @@ void Heap_Initialize(void)
           (uint32_t)((heap_end - heap_start) / (1024 * 1024)));
 }
 
+/* Pop a recycled block that fits `size`, or NULL.  Starts at the first
+ * bin whose floor covers the request, so the head block of any lower
+ * bin is guaranteed big enough; only the open-ended top bin ever walks
+ * past its head. */
+static void *heap_large_alloc(size_t size)
+{
+   int bin = 0;
+   while (bin < HEAP_BIN_COUNT - 1 &&
+          ((size_t)1 << (HEAP_BIN_SHIFT + bin)) < size)
+      bin++;
+
+   for (; bin < HEAP_BIN_COUNT; bin++)
+   {
+      FreeLargeBlock **link = &g_LargeBins[bin];
+      while (*link)
+      {
+         FreeLargeBlock *blk = *link;
+         HeapBlockHeader *header =
+             (HeapBlockHeader *)((uint8_t *)blk - sizeof(HeapBlockHeader));
+         if (header->size >= size)
+         {
+            *link = blk->next;
+            g_LargeBinCount[bin]--;
+            header->canary_before = HEAP_CANARY;
+            return (void *)blk;
+         }
+         link = &blk->next;
+      }
+   }
+   return NULL;
+}
+
 void *kmalloc(size_t size)
 {
    if (size == 0) return NULL;
 
+   /* Small requests come from the slab size classes so free() can
+      actually recycle them; larger ones try the recycling bins before
+      growing the bump region below. */
+   if (heap_ptr != 0)
+   {
+      void *obj = Slab_AllocSized(size);
+      if (obj) return obj;
+      obj = heap_large_alloc(size);
+      if (obj) return obj;
+   }
+
    /* Allocate extra space for header with canaries */
    size_t total = size + sizeof(HeapBlockHeader);
    uintptr_t cur = align_up(heap_ptr, 8);
@@ -198,7 +302,9 @@ void heap_check_integrity(void)
    {
       HeapBlockHeader *h = (HeapBlockHeader *)cur;
 
-      if (h->canary_before != HEAP_CANARY || h->canary_after != HEAP_CANARY)
+      if ((h->canary_before != HEAP_CANARY &&
+           h->canary_before != HEAP_CANARY_FREE) ||
+          h->canary_after != HEAP_CANARY)
       {
          logfmt(LOG_ERROR,
                 "[MEM] CORRUPTION at 0x%08x! Block size=%u "
@@ -220,10 +326,128 @@ void heap_check_integrity(void)
           block_count);
 }
 
+void Heap_CheckIncremental(void)
+{
+   if (heap_ptr == 0) return;
+   if (g_HeapCheckCursor < heap_start || g_HeapCheckCursor >= heap_ptr)
+      g_HeapCheckCursor = heap_start;
+
+   uintptr_t cur = g_HeapCheckCursor;
+   for (uint32_t n = 0; n < HEAP_CHECK_BATCH && cur < heap_ptr; n++)
+   {
+      HeapBlockHeader *h = (HeapBlockHeader *)cur;
+
+      if ((h->canary_before != HEAP_CANARY &&
+           h->canary_before != HEAP_CANARY_FREE) ||
+          h->canary_after != HEAP_CANARY)
+      {
+         g_HeapStat.corruptions++;
+         if ((uint32_t)cur != g_HeapStat.last_corrupt)
+            logfmt(LOG_ERROR,
+                   "[MEM] heap sweep: corruption at 0x%08x size=%u "
+                   "canary_before=0x%08x canary_after=0x%08x\n",
+                   (uint32_t)cur, (uint32_t)h->size, h->canary_before,
+                   h->canary_after);
+         g_HeapStat.last_corrupt = (uint32_t)cur;
+
+         /* The size field cannot be trusted past a bad header, so the
+          * walk cannot step over it; restart from the bottom. */
+         cur = heap_ptr;
+         break;
+      }
+
+      g_HeapStat.blocks_checked++;
+      cur += sizeof(HeapBlockHeader) + h->size;
+   }
+
+   if (cur >= heap_ptr)
+   {
+      g_HeapStat.passes++;
+      cur = heap_start;
+   }
+   g_HeapCheckCursor = cur;
+}
+
+/* Text renderer behind /dev/heapstat (same shape as Lockstat_Read). */
+uint32_t Heap_StatsRead(uint32_t offset, uint32_t size, void *buffer)
+{
+   static char text[512];
+
+   int n = snprintf(text, sizeof(text),
+                    "sweep passes=%u blocks_checked=%u corruptions=%u "
+                    "last_corrupt=0x%08x\n"
+                    "free bad_canary=%u double_frees=%u\n"
+                    "bump used=%u total=%u\n",
+                    g_HeapStat.passes, g_HeapStat.blocks_checked,
+                    g_HeapStat.corruptions, g_HeapStat.last_corrupt,
+                    g_HeapStat.free_bad_canary, g_HeapStat.double_frees,
+                    (uint32_t)(heap_ptr - heap_start),
+                    (uint32_t)(heap_end - heap_start));
+   if (n < 0) return 0;
+
+   uint32_t len = (uint32_t)n;
+   if (len >= sizeof(text)) len = sizeof(text) - 1;
+   if (offset >= len) return 0;
+
+   uint32_t avail = len - offset;
+   if (avail > size) avail = size;
+   memcpy((uint8_t *)buffer, text + offset, avail);
+
+   return avail;
+}
+
+void Heap_DumpStats(void)
+{
+   for (int bin = 0; bin < HEAP_BIN_COUNT; ++bin)
+   {
+      if (g_LargeBinCount[bin] == 0) continue;
+      logfmt(LOG_INFO, "[MEM] heap bin %u (>=%u KiB): %u free\n", bin,
+             1u << (HEAP_BIN_SHIFT + bin - 10), g_LargeBinCount[bin]);
+   }
+   Slab_DumpCaches();
+}
+
 void free(void *ptr)
 {
-   /* No-op: bump allocator does not reclaim memory. */
-   (void)ptr;
+   if (!ptr) return;
+
+   /* Slab objects go back on their cache's free list for reuse. */
+   if (Slab_Release(ptr) == SUCCESS) return;
+
+   /* Bump blocks big enough for a recycling bin are parked whole;
+      anything else (small slab-fallback blocks, foreign pointers) is
+      left alone as before. */
+   uintptr_t addr = (uintptr_t)ptr;
+   if (addr < heap_start + sizeof(HeapBlockHeader) || addr >= heap_ptr) return;
+
+   HeapBlockHeader *header =
+       (HeapBlockHeader *)(addr - sizeof(HeapBlockHeader));
+   if (header->canary_after != HEAP_CANARY)
+   {
+      g_HeapStat.free_bad_canary++;
+      return;
+   }
+   if (header->canary_before == HEAP_CANARY_FREE)
+   {
+      g_HeapStat.double_frees++;
+      logfmt(LOG_WARNING, "[MEM] heap: double free at 0x%08x, ignoring\n",
+             (uint32_t)addr);
+      return;
+   }
+   if (header->canary_before != HEAP_CANARY)
+   {
+      g_HeapStat.free_bad_canary++;
+      return;
+   }
+
+   int bin = heap_bin_index(header->size);
+   if (bin < 0) return;
+
+   header->canary_before = HEAP_CANARY_FREE;
+   FreeLargeBlock *blk = (FreeLargeBlock *)ptr;
+   blk->next = g_LargeBins[bin];
+   g_LargeBins[bin] = blk;
+   g_LargeBinCount[bin]++;
 }
 
 void *calloc(size_t nmemb, size_t size)
@@ -232,6 +456,15 @@ void *calloc(size_t nmemb, size_t size)
    return kzalloc(total);
 }
 
+/* realloc with in-place growth.
+ *
+ * This heap has no coalescing free list, but two in-place cases still
+ * cover the common doubling pattern: the capacity behind the pointer
+ * (slab class or recycled bin block) often already exceeds the
+ * request, and a bump-region block that is the most recent allocation
+ * can absorb the free tail by just advancing the bump pointer.  Only
+ * when neither applies does the data move - and then it copies the old
+ * payload, not the new size, and releases the old block. */
 void *realloc(void *ptr, size_t size)
 {
    if (!ptr) return kmalloc(size);
@@ -241,9 +474,44 @@ void *realloc(void *ptr, size_t size)
       return NULL;
    }
 
+   /* Capacity behind ptr: slab objects carry a tagged header, live
+      bump blocks a HeapBlockHeader with intact canaries.  Foreign
+      pointers leave old_size at 0. */
+   size_t old_size = Slab_UsableSize(ptr);
+   HeapBlockHeader *header = NULL;
+   uintptr_t addr = (uintptr_t)ptr;
+
+   if (old_size == 0 && addr >= heap_start + sizeof(HeapBlockHeader) &&
+       addr < heap_ptr)
+   {
+      HeapBlockHeader *h =
+          (HeapBlockHeader *)(addr - sizeof(HeapBlockHeader));
+      if (h->canary_before == HEAP_CANARY && h->canary_after == HEAP_CANARY)
+      {
+         header = h;
+         old_size = h->size;
+      }
+   }
+
+   if (old_size >= size) return ptr;
+
+   /* The final bump block owns all free space after it; grow in place
+      instead of copying the world on every doubling. */
+   if (header && addr + header->size == heap_ptr)
+   {
+      uintptr_t avail = (heap_end - addr) + 1;
+      if (size <= avail)
+      {
+         header->size = size;
+         heap_ptr = addr + size;
+         return ptr;
+      }
+   }
+
    void *n = kmalloc(size);
    if (!n) return NULL;
-   memcpy(n, ptr, size);
+   memcpy(n, ptr, old_size ? old_size : size);
+   if (old_size) free(ptr);
    return n;
 }
 
@@ -307,7 +575,16 @@ void Heap_SelfTest(void)
    int brk_ok = (brk1 != (void *)-1);
    brk(brk0);
 
+   /* A freed large block must come back from its recycling bin. */
+   void *big = kmalloc(8192);
+   free(big);
+   void *big2 = kmalloc(8192);
+   int recycle_ok = (big != NULL && big2 == big);
+   free(big2);
+
    logfmt(LOG_INFO,
-          "[MEM] test kmalloc/realloc copy=%s, calloc zero=%s, sbrk=%s\n",
-          ok ? "OK" : "FAIL", zeroed ? "OK" : "FAIL", brk_ok ? "OK" : "FAIL");
+          "[MEM] test kmalloc/realloc copy=%s, calloc zero=%s, sbrk=%s, "
+          "recycle=%s\n",
+          ok ? "OK" : "FAIL", zeroed ? "OK" : "FAIL", brk_ok ? "OK" : "FAIL",
+          recycle_ok ? "OK" : "FAIL");
 }
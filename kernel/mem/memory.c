@@ -40,15 +40,28 @@ void mem_fault_handler(void *addr, size_t len, int code)
  * here we provide small C wrappers that forward to those symbols.
  */
 extern void *memcpy_asm(void *dst, const void *src, size_t num);
+extern void *memset_asm(void *ptr, int value, size_t num);
+
+/* SSE variants (arch/i686/mem/memory_sse.S): 16-byte moves with
+ * non-temporal stores for page-sized copies.  Selected once at
+ * MEM_Initialize when CPUID reports SSE; until then the rep-string
+ * routines above are the safe default. */
+#define CPU_FEATURE_SSE 0x02000000u // CPUID.1:EDX bit 25
+extern void enable_sse(void);
+extern void *memcpy_sse(void *dst, const void *src, size_t num);
+extern void *memset_sse(void *ptr, int value, size_t num);
+
+static void *(*memcpy_impl)(void *, const void *, size_t) = memcpy_asm;
+static void *(*memset_impl)(void *, int, size_t) = memset_asm;
+
 void *memcpy(void *dst, const void *src, size_t num)
 {
-   return memcpy_asm(dst, src, num);
+   return memcpy_impl(dst, src, num);
 }
 
-extern void *memset_asm(void *ptr, int value, size_t num);
 void *memset(void *ptr, int value, size_t num)
 {
-   return memset_asm(ptr, value, num);
+   return memset_impl(ptr, value, num);
 }
 
 extern int memcmp_asm(const void *ptr1, const void *ptr2, size_t num);
@@ -94,9 +107,136 @@ void *memmove(void *dest, const void *src, size_t n)
    return dest;
 }
 
+/* Validated user-memory copies (copy_from_user / copy_to_user)
+ *
+ * The whole range is checked once against the user address-space
+ * bounds - no per-byte or per-page cost - and the data then streams
+ * through one rep-string copy.  Demand-paged and copy-on-write pages
+ * fault in transparently underneath (CR0.WP keeps supervisor writes
+ * honest), so presence is not checked up front; a fault on a genuinely
+ * unmapped address is recovered through the fixup hook the page-fault
+ * ISR consults (mem_user_fault_fixup) and surfaces as -EFAULT instead
+ * of taking the kernel down.
+ */
+
+static volatile uint32_t s_UserGuardStart = 0;
+static volatile uint32_t s_UserGuardResume = 0;
+
+uint32_t mem_user_fault_fixup(uint32_t eip)
+{
+   if (s_UserGuardResume != 0 && eip >= s_UserGuardStart &&
+       eip < s_UserGuardResume)
+   {
+      uint32_t resume = s_UserGuardResume;
+      s_UserGuardResume = 0;
+      return resume;
+   }
+   return 0;
+}
+
+/* One guarded rep-string copy; returns the bytes left uncopied (0 on
+ * full success).  The faulting instruction must live in this frame -
+ * the fixup redirects EIP without touching ESP, and rep movs pushes
+ * nothing - so the loops are inline asm rather than a memcpy call. */
+static uint32_t user_copy_guarded(void *dst, const void *src, uint32_t count)
+{
+   uint8_t *d = (uint8_t *)dst;
+   const uint8_t *s = (const uint8_t *)src;
+   uint32_t left = count >> 2; /* whole words first */
+
+   __asm__ __volatile__("movl $1f, %[start]\n\t"
+                        "movl $2f, %[resume]\n\t"
+                        "cld\n"
+                        "1: rep movsl\n"
+                        "2: movl $0, %[resume]"
+                        : [start] "=m"(s_UserGuardStart),
+                          [resume] "=m"(s_UserGuardResume), "+S"(s),
+                          "+D"(d), "+c"(left)
+                        :
+                        : "memory", "cc");
+   if (left) return (left << 2) + (count & 3u);
+
+   left = count & 3u;
+   __asm__ __volatile__("movl $1f, %[start]\n\t"
+                        "movl $2f, %[resume]\n\t"
+                        "1: rep movsb\n"
+                        "2: movl $0, %[resume]"
+                        : [start] "=m"(s_UserGuardStart),
+                          [resume] "=m"(s_UserGuardResume), "+S"(s),
+                          "+D"(d), "+c"(left)
+                        :
+                        : "memory", "cc");
+   return left;
+}
+
+int user_range_ok(const void *uaddr, size_t count)
+{
+   uint32_t start = (uint32_t)uaddr;
+
+   if (count == 0) return SUCCESS;
+
+   /* Three comparisons cover any size.  Everything a process can
+      legitimately own (code, heap, mmap window, stack) sits between
+      USER_CODE_START and USER_SPACE_END; the floor also rejects NULL
+      and the kernel's low identity window, the ceiling rejects kernel
+      space proper, and the last test catches wrapping ranges. */
+   if (start < USER_CODE_START) return -EFAULT;
+   if (start >= USER_SPACE_END) return -EFAULT;
+   if (count > (uint32_t)USER_SPACE_END - start) return -EFAULT;
+   return SUCCESS;
+}
+
+int copy_from_user(void *dst, const void *user_src, size_t count)
+{
+   if (user_range_ok(user_src, count) != SUCCESS) return -EFAULT;
+   if (user_copy_guarded(dst, user_src, count) != 0) return -EFAULT;
+   return SUCCESS;
+}
+
+int copy_to_user(void *user_dst, const void *src, size_t count)
+{
+   if (user_range_ok(user_dst, count) != SUCCESS) return -EFAULT;
+   if (user_copy_guarded(user_dst, src, count) != 0) return -EFAULT;
+   return SUCCESS;
+}
+
+/* Zero-byte detection for word-at-a-time scanning (same trick as the
+ * string routines in std/string.c). */
+#define WORD_ONES 0x01010101u
+#define WORD_HIGHS 0x80808080u
+#define WORD_HAS_ZERO(w) ((((w) - WORD_ONES) & ~(w)) & WORD_HIGHS)
+
 int strncmp(const char *s1, const char *s2, size_t n)
 {
    if (n == 0) return (0);
+
+   /* Word stepping needs both strings at the same misalignment; walk
+      bytes up to a 4-byte boundary, then compare a word at a time until
+      a difference, a terminator or the tail.  Short strings never reach
+      the word loop. */
+   if (((uintptr_t)s1 & 3u) == ((uintptr_t)s2 & 3u))
+   {
+      while (n > 0 && ((uintptr_t)s1 & 3u) != 0)
+      {
+         if (*s1 != *s2 || *s1 == '\0')
+            return (*(const unsigned char *)s1 - *(const unsigned char *)s2);
+         s1++;
+         s2++;
+         n--;
+      }
+
+      while (n >= 4)
+      {
+         uint32_t w = *(const uint32_t *)s1;
+         if (w != *(const uint32_t *)s2 || WORD_HAS_ZERO(w)) break;
+         s1 += 4;
+         s2 += 4;
+         n -= 4;
+      }
+
+      if (n == 0) return (0);
+   }
+
    do
    {
       if (*s1 != *s2++)
@@ -168,18 +308,75 @@ static uint32_t PollTotalMemory(void)
    return defaultMem;
 }
 
+/**
+ * ReserveMemoryHoles
+ *
+ * PMM_Initialize models physical memory as one contiguous range up to
+ * the high mark PollTotalMemory found, but the BIOS map usually has
+ * non-usable regions below that mark (ACPI tables, the EBDA, holes
+ * between banks).  Walk the BOOT_MemMapEntry table again and pin every
+ * region not reported as type-1 RAM so the allocator never hands those
+ * frames out, while the usable memory above a hole stays available.
+ */
+static void ReserveMemoryHoles(uint32_t total_memory)
+{
+   uint32_t mapAddr = g_SysInfo->boot.memMapAddr;
+   uint32_t mapLength = g_SysInfo->boot.memMapLength;
+   if (mapAddr < 0x1000 || mapLength == 0) return;
+
+   BOOT_MemMapEntry *entry = (BOOT_MemMapEntry *)mapAddr;
+   BOOT_MemMapEntry *mapEnd = (BOOT_MemMapEntry *)(mapAddr + mapLength);
+   uint32_t reserved_kib = 0;
+
+   while (entry < mapEnd)
+   {
+      if (entry->type != 1 && entry->baseAddr < total_memory)
+      {
+         uint64_t regionEnd = entry->baseAddr + entry->length;
+         if (regionEnd > total_memory) regionEnd = total_memory;
+
+         /* Round outward to whole pages: a page partially covered by a
+            reserved region must not be handed out either. */
+         uint32_t base = (uint32_t)entry->baseAddr & ~(PAGE_SIZE - 1u);
+         uint32_t length = (uint32_t)(regionEnd - base);
+
+         PMM_ReserveRegion(base, length);
+         reserved_kib += length / 1024;
+      }
+      /* Advance by (entry->size + sizeof(entry->size)) per spec. */
+      entry = (BOOT_MemMapEntry *)((uint32_t)entry + entry->size +
+                                   sizeof(entry->size));
+   }
+
+   if (reserved_kib > 0)
+      logfmt(LOG_INFO, "[MEM] %u KiB firmware-reserved below high mark\n",
+             reserved_kib);
+}
+
 void MEM_Initialize(void)
 {
    /* Derive total memory from g_SysInfo->boot (bootloader-agnostic) */
    uint32_t total_memory = PollTotalMemory();
 
+   /* Pick the widest copy/fill routines the CPU supports before the
+      allocators start exercising them. */
+   if (get_cpu_features() & CPU_FEATURE_SSE)
+   {
+      enable_sse();
+      memcpy_impl = memcpy_sse;
+      memset_impl = memset_sse;
+      logfmt(LOG_INFO, "[MEM] SSE memcpy/memset selected\n");
+   }
+
    Heap_Initialize();
    Heap_SelfTest();
+   Slab_SelfTest();
    Stack_Initialize();
    Stack_SelfTest();
 
    // Initialize physical memory manager before paging so page tables can use it
    PMM_Initialize(total_memory);
+   ReserveMemoryHoles(total_memory);
    PMM_SelfTest();
 
    // Paging after PMM so alloc_frame can use real frames
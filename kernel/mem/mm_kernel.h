@@ -38,6 +38,22 @@ int strncmp(const char *s1, const char *s2, size_t n);
 
 void *SegmentOffsetToLinear(void *addr);
 
+/* Validated user-memory access
+ *
+ * user_range_ok checks a whole range against the user address-space
+ * bounds in O(1); the copies validate once, then stream with one
+ * rep-string copy.  A fault mid-copy (genuinely unmapped address) is
+ * recovered via mem_user_fault_fixup and reported as -EFAULT; COW and
+ * demand-paged ranges fault in transparently.  SUCCESS or -EFAULT.
+ */
+int user_range_ok(const void *uaddr, size_t count);
+int copy_from_user(void *dst, const void *user_src, size_t count);
+int copy_to_user(void *user_dst, const void *src, size_t count);
+
+/* Page-fault ISR hook: the in-copy recovery address when eip faulted
+ * inside a guarded user copy, or 0. */
+uint32_t mem_user_fault_fixup(uint32_t eip);
+
 void MEM_Initialize(void); /* Reads boot params from g_SysInfo->boot */
 
 /* Heap / allocator initialization */
@@ -64,6 +80,71 @@ int PMM_IsInitialized(void);
 /* Self-test helper */
 void Heap_SelfTest(void);
 
+/* Log occupancy of the large-block recycling bins and slab caches */
+void Heap_DumpStats(void);
+
+/* Bounded integrity sweep (a batch of blocks per call, cursor resumes);
+ * the idle loop calls this so detection stays on in production. */
+void Heap_CheckIncremental(void);
+
+/* Corruption counters rendered as text through /dev/heapstat */
+uint32_t Heap_StatsRead(uint32_t offset, uint32_t size, void *buffer);
+
+/* Slab allocator - O(1) caches for fixed-size kernel objects
+ *
+ * A cache hands out objects of one size from a free list and takes them
+ * back in O(1).  kmalloc routes small requests through internal
+ * size-class caches (free() returns those objects for reuse); larger or
+ * odd sizes fall back to the plain heap.
+ */
+typedef struct SlabCache SlabCache;
+
+/* Create a dedicated cache for one object type (name is for logging) */
+SlabCache *Slab_CreateCache(const char *name, uint32_t object_size);
+
+/* O(1) allocate/release from a dedicated cache */
+void *Slab_Alloc(SlabCache *cache);
+void Slab_Free(SlabCache *cache, void *obj);
+
+/* Size-class entry points used by kmalloc/free
+ * Slab_AllocSized returns NULL when the size has no class (caller falls
+ * back); Slab_Release returns SUCCESS when ptr was a slab object
+ */
+void *Slab_AllocSized(size_t size);
+int Slab_Release(void *ptr);
+
+/* Payload capacity behind a slab pointer, or 0 when ptr is not a live
+ * slab object.  realloc uses this to size copies and stay in place.
+ */
+size_t Slab_UsableSize(const void *ptr);
+
+/* Log per-cache occupancy (used by Heap_DumpStats) */
+void Slab_DumpCaches(void);
+
+/* Self-test helper */
+void Slab_SelfTest(void);
+
+/* IRQ pools - lock-free fixed-size object caches for interrupt context
+ *
+ * A pool fronts a dedicated cache with single-producer/single-consumer
+ * rings so Slab_AllocIrq/Slab_FreeIrq are safe with interrupts
+ * disabled.  The idle loop restocks pools from process context; an
+ * empty pool returns NULL rather than touching the slab free lists.
+ */
+typedef struct SlabIrqPool SlabIrqPool;
+
+/* Create and pre-stock a pool (process context only) */
+SlabIrqPool *Slab_CreateIrqPool(const char *name, uint32_t object_size);
+
+/* IRQ-safe allocate/release; objects freed here are recycled by the
+ * next refill pass */
+void *Slab_AllocIrq(SlabIrqPool *pool);
+void Slab_FreeIrq(SlabIrqPool *pool, void *ptr);
+
+/* Top up every pool from its backing cache; called from the idle loop
+ */
+void Slab_RefillIrqPools(void);
+
 /* Physical Memory Manager (PMM) - Kernel level
  *
  * Tracks allocation of physical page frames.
@@ -76,6 +157,12 @@ void Heap_SelfTest(void);
  */
 void PMM_Initialize(uint32_t total_mem_bytes);
 
+/* Mark [addr, addr+length) unusable (firmware-reserved region or hole
+ * in the memory map).  Call between PMM_Initialize and the first
+ * allocation; the pages are pinned and never re-enter circulation.
+ */
+void PMM_ReserveRegion(uint32_t addr, uint32_t length);
+
 /* Allocate a single 4K physical page frame
  * Returns physical address, or 0 on failure
  */
@@ -83,9 +170,115 @@ uint32_t PMM_AllocatePhysicalPage(void);
 
 /* Free a previously allocated physical page
  * addr should be page-aligned (4K)
+ * Drops one reference; the frame is released once the last holder frees it
  */
 void PMM_FreePhysicalPage(uint32_t addr);
 
+/* Free a batch of frames collected during an address-space walk - one
+ * call per batch on the teardown path instead of one per frame.
+ * Reference semantics per frame match PMM_FreePhysicalPage.
+ */
+void PMM_FreePageArray(const uint32_t *pages, uint32_t count);
+
+/* Add a reference to an allocated physical page
+ * Used when copy-on-write fork shares one frame between address spaces
+ */
+void PMM_RetainPhysicalPage(uint32_t addr);
+
+/* Get the reference count of a page (0 if free, 1 if exclusively owned)
+ */
+uint32_t PMM_GetPageRefCount(uint32_t addr);
+
+/* The shared, pinned page of zeros that anonymous user memory maps
+ * copy-on-write.  Returns 0 before PMM_Initialize
+ */
+uint32_t PMM_GetZeroPage(void);
+
+/* Allocate a zeroed physical page, preferring a frame pre-zeroed at
+ * idle time over a synchronous memset
+ */
+uint32_t PMM_AllocateZeroedPage(void);
+
+/* Zero a small batch of free frames and park them for
+ * PMM_AllocateZeroedPage.  Runs on the kzero kernel thread.
+ */
+void PMM_ZeroPendingPages(void);
+
+/* Spawn the kzero background thread; call once the scheduler and FS
+ * are up. */
+void PMM_StartZeroThread(void);
+
+/* Atomic-context page reserve: pop a pre-allocated frame from IRQ
+ * context (the normal path is not IRQ-safe).  Returns 0 when the
+ * reserve is exhausted; callers must tolerate failure.
+ */
+uint32_t PMM_AllocatePageAtomic(void);
+
+/* Return a frame from IRQ context; it parks on a ring until the next
+ * replenish pass hands it back to the allocator.
+ */
+void PMM_FreePageAtomic(uint32_t addr);
+
+/* Restock the atomic reserve and drain IRQ-freed frames; called from
+ * the idle loop (process context only).
+ */
+void PMM_ReplenishAtomicReserve(void);
+
+/* Memory-pressure shrinkers
+ *
+ * Caches holding physical frames register a callback with a relative
+ * cost (lower = cheaper to evict).  When an allocation would otherwise
+ * fail, or the idle loop sees free memory below the low watermark, the
+ * callbacks run cheapest-first; each returns the number of frames it
+ * released.  Callbacks run in process context.
+ */
+typedef uint32_t (*PMM_ShrinkerFn)(uint32_t pages_wanted);
+
+int PMM_RegisterShrinker(const char *name, PMM_ShrinkerFn fn, uint32_t cost);
+
+/* Run the shrinkers when free memory sits below the watermark; called
+ * from the idle loop (process context only).
+ */
+void PMM_ShrinkIfLow(void);
+
+/* Compressed in-RAM page store (zstore) - zram-style stand-in for swap
+ *
+ * The idle loop ages process heaps with the hardware accessed bit and
+ * compresses pages idle through two passes into heap-backed slots,
+ * freeing their frames; the page-fault path decompresses them back on
+ * the next touch.  See zstore.c for the concurrency rules.
+ */
+
+/* Compress one page in; returns the slot index, -ENOMEM when the store
+ * is full, -EINVAL when the page is not worth compressing. */
+int ZStore_Save(void *page_dir, uint32_t vaddr, const void *page);
+
+/* Decompress a slot into page_out and release it; the directory and
+ * address must match what was saved. */
+int ZStore_Fetch(uint32_t slot, void *page_dir, uint32_t vaddr,
+                 void *page_out);
+
+/* Fault every compressed page of one directory back into frames; fork
+ * needs this before its COW walk. */
+int ZStore_RestoreDirectory(void *page_dir);
+
+/* Release every slot owned by a dying address space. */
+void ZStore_DropDirectory(void *page_dir);
+
+/* Age one process's heap; called from the idle loop (process context).
+ */
+void ZStore_BackgroundScan(void);
+
+/* Allocate 2^order physically contiguous pages, aligned to the run size
+ * (for DMA buffers).  Returns the physical address of the first page,
+ * or 0 on failure.  Max order is 10 (4 MiB)
+ */
+uint32_t PMM_AllocateContiguous(uint32_t order);
+
+/* Free a contiguous run previously allocated with PMM_AllocateContiguous
+ */
+void PMM_FreeContiguous(uint32_t addr, uint32_t order);
+
 /* Check if a physical page is free
  */
 int PMM_IsPhysicalPageFree(uint32_t addr);
@@ -23,15 +23,42 @@ int PMM_IsInitialized(void);
  */
 
 /* Allocate and map virtual memory in a page directory.
- * If next_vaddr_state is NULL, uses the kernel allocator bump pointer.
+ * Placement is first-fit over the directory's VMA region list, so freed
+ * ranges are reused.  next_vaddr_state is a legacy parameter and ignored.
  */
 void *VMM_AllocateInDir(void *page_dir, uint32_t *next_vaddr_state,
                         uint32_t size, uint32_t flags);
 
+/* Reserve a virtual range in a page directory without mapping pages.
+ * The range is recorded in the VMA region list so later allocations
+ * avoid it; pages are expected to be faulted in on demand.  Release
+ * with VMM_FreeInDir (unfaulted pages are skipped).
+ */
+void *VMM_ReserveInDir(void *page_dir, uint32_t size, uint32_t flags);
+
+/* Record an externally chosen virtual range in a directory's region
+ * list (e.g. a fork-inherited mapping).  Fails with -EINVAL when the
+ * range overlaps an existing region.
+ */
+int VMM_ReserveRangeInDir(void *page_dir, uint32_t vaddr, uint32_t size,
+                          uint32_t flags);
+
 /* Free previously allocated virtual memory in a page directory
  */
 void VMM_FreeInDir(void *page_dir, void *vaddr, uint32_t size);
 
+/* Look up the VMA region containing vaddr in a page directory.
+ * Fills the optional out parameters and returns SUCCESS, or -EINVAL if
+ * the address falls in a gap (or the directory has no region list).
+ */
+int VMM_FindRegion(void *page_dir, uint32_t vaddr, uint32_t *start_out,
+                   uint32_t *end_out, uint32_t *flags_out);
+
+/* Release the VMA region list tracked for a page directory.
+ * Call on process teardown after the mappings themselves are gone.
+ */
+void VMM_DestroySpace(void *page_dir);
+
 /* Map existing physical memory in a page directory
  */
 int VMM_MapInDir(void *page_dir, uint32_t vaddr, uint32_t paddr, uint32_t size,
@@ -45,6 +72,17 @@ int VMM_UnmapInDir(void *page_dir, uint32_t vaddr, uint32_t size);
  */
 uint32_t VMM_GetPhysInDir(void *page_dir, uint32_t vaddr);
 
+/* Shared memory segments (mem/shm.c): frames held by a global registry
+ * and mapped into multiple process directories with PMM refcounts.
+ *
+ * SHM_Create returns a segment id, or the existing id when the key is
+ * already registered.  SHM_Attach maps the segment into the calling
+ * process and returns the virtual address; detach is a plain munmap of
+ * that range (or implicit at process exit).
+ */
+int SHM_Create(int32_t key, uint32_t size);
+intptr_t SHM_Attach(void *proc, int id);
+
 /* Stack Management - Process level */
 
 /**
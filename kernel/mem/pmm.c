@@ -2,6 +2,7 @@
 
 #include "mm_kernel.h"
 #include "mm_proc.h"
+#include <cpu/kthread.h>
 #include <std/stdio.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -17,6 +18,66 @@ static uint32_t total_pages = 0;
 static uint32_t allocated_count = 0;
 static int pmm_initialized = 0;
 
+/* Per-frame reference counts for pages shared by copy-on-write fork.
+ * Covers the first 256 MiB (matching the early allocator's guard in
+ * paging.c); frames above that are treated as exclusively owned.
+ * A count saturated at 255 pins the frame forever.
+ */
+#define REFCOUNT_MAX_PAGES ((256 * 1024 * 1024) / PAGE_SIZE)
+static uint8_t page_refcount[REFCOUNT_MAX_PAGES];
+
+/* O(1) free-page stack: recently freed frames are handed out again
+ * before the bitmap is consulted, so the single-page hot path (fork,
+ * exec, VMM_Allocate) stops scanning from index 0 every call.  Entries
+ * can go stale when PMM_AllocateContiguous claims a stacked frame, so
+ * pops re-check the bitmap.  scan_hint makes the fallback scan next-fit
+ * instead of restarting at the bottom of memory.
+ */
+#define FREE_STACK_CAPACITY 8192
+static uint32_t free_stack[FREE_STACK_CAPACITY];
+static uint32_t free_stack_top = 0;
+static uint32_t scan_hint = 0;
+
+/* Lazy zeroing.  zero_page is a single pinned frame of zeros that
+ * anonymous user memory maps copy-on-write, so sbrk growth stops paying
+ * a synchronous clear per page.  zero_stack parks frames that the
+ * kzero thread zeroed in the background (PMM_ZeroPendingPages);
+ * PMM_AllocateZeroedPage pops them and only memsets when the queue is
+ * empty.
+ */
+#define ZERO_STACK_CAPACITY 64
+#define ZERO_BATCH 8
+#define ZERO_FREE_RESERVE 1024
+static uint32_t zero_page = 0;
+static uint32_t zero_stack[ZERO_STACK_CAPACITY];
+static uint32_t zero_stack_top = 0;
+
+/* Atomic-context page reserve.  Interrupt handlers cannot take the
+ * normal allocation path: the bitmap and free-stack updates are plain
+ * read-modify-writes, so an IRQ landing in the middle of a process-
+ * context allocation would corrupt them.  Instead the idle loop keeps
+ * this ring stocked from process context and IRQ code only pops from
+ * it.  Both rings are single-producer/single-consumer (the same scheme
+ * as the keyboard scancode queue): the replenisher owns one index of
+ * each, IRQ context owns the other, so no locking is needed.  Frames
+ * freed in IRQ context park on the return ring until the replenisher
+ * hands them back to the allocator.
+ */
+#define ATOMIC_RESERVE_CAPACITY 32u /* power of two */
+#define ATOMIC_RESERVE_MASK (ATOMIC_RESERVE_CAPACITY - 1)
+#define ATOMIC_RESERVE_LOW (ATOMIC_RESERVE_CAPACITY / 2)
+
+static volatile uint32_t atomic_ring[ATOMIC_RESERVE_CAPACITY];
+static volatile uint32_t atomic_head = 0; /* replenisher writes */
+static volatile uint32_t atomic_tail = 0; /* IRQ consumer writes */
+
+static volatile uint32_t atomic_return_ring[ATOMIC_RESERVE_CAPACITY];
+static volatile uint32_t atomic_return_head = 0; /* IRQ producer writes */
+static volatile uint32_t atomic_return_tail = 0; /* replenisher writes */
+
+static uint32_t atomic_failures = 0; /* pops from an empty reserve */
+static uint32_t atomic_lost = 0;     /* frees dropped on a full return ring */
+
 static void bitmap_set(uint32_t page_idx)
 {
    uint32_t byte_idx = page_idx / BITS_PER_BYTE;
@@ -74,41 +135,418 @@ void PMM_Initialize(uint32_t total_mem_bytes)
       bitmap_set(i);
    }
 
+   free_stack_top = 0;
+   scan_hint = reserved_pages < total_pages ? reserved_pages : 0;
+   zero_stack_top = 0;
+   atomic_head = atomic_tail = 0;
+   atomic_return_head = atomic_return_tail = 0;
+
+   /* The shared zero page: zeroed once, pinned forever (a saturated
+      refcount never drops, so frees of COW references are no-ops). */
+   zero_page = PMM_AllocatePhysicalPage();
+   if (zero_page)
+   {
+      memset((void *)zero_page, 0, PAGE_SIZE);
+      page_refcount[zero_page / PAGE_SIZE] = 255;
+   }
+
    logfmt(LOG_INFO, "[MEM] init: total=%u pages, reserved=%u, free=%u\n",
           total_pages, reserved_pages, total_pages - allocated_count);
 }
 
+void PMM_ReserveRegion(uint32_t addr, uint32_t length)
+{
+   if (!page_bitmap || length == 0) return;
+
+   uint32_t first = addr / PAGE_SIZE;
+   uint64_t end = (uint64_t)addr + length;
+
+   for (uint32_t i = first;
+        i < total_pages && ((uint64_t)i * PAGE_SIZE) < end; ++i)
+   {
+      if (!bitmap_is_set(i)) bitmap_set(i);
+      /* Pin: a saturated refcount never drops, so a stray free can
+         never put a firmware region back into circulation. */
+      if (i < REFCOUNT_MAX_PAGES) page_refcount[i] = 255;
+   }
+}
+
+/* =========================================================================
+ * Memory-pressure shrinkers
+ *
+ * Kernel caches that hold physical frames (exec cache, zeroed-page
+ * stock, ...) register a callback with a relative cost; when an
+ * allocation would otherwise fail, or the idle loop finds free memory
+ * below the low watermark, the callbacks are asked - cheapest first -
+ * to give frames back before the allocator reports failure.  Callbacks
+ * run in process context and return the number of frames released.
+ * ====================================================================== */
+
+#define PMM_MAX_SHRINKERS 8
+#define PMM_LOW_WATERMARK 256u /* pages: shrink below 1 MiB free */
+
+typedef struct
+{
+   const char *name;
+   PMM_ShrinkerFn fn;
+   uint32_t cost;
+   uint32_t released; /* lifetime frames returned, for diagnostics */
+   bool used;
+} PmmShrinker;
+
+static PmmShrinker g_Shrinkers[PMM_MAX_SHRINKERS];
+static bool g_ShrinkActive = false; /* shrinkers may free/allocate */
+
+static void pmm_free_frame(uint32_t addr); /* Defined with the free path */
+
+int PMM_RegisterShrinker(const char *name, PMM_ShrinkerFn fn, uint32_t cost)
+{
+   if (!fn) return -EINVAL;
+
+   for (int i = 0; i < PMM_MAX_SHRINKERS; i++)
+   {
+      if (g_Shrinkers[i].used) continue;
+
+      g_Shrinkers[i].name = name;
+      g_Shrinkers[i].fn = fn;
+      g_Shrinkers[i].cost = cost;
+      g_Shrinkers[i].released = 0;
+      g_Shrinkers[i].used = true;
+      return SUCCESS;
+   }
+   return -ENOMEM;
+}
+
+static uint32_t pmm_shrink(uint32_t pages_wanted)
+{
+   if (g_ShrinkActive) return 0;
+   g_ShrinkActive = true;
+
+   uint32_t released = 0;
+
+   /* The zeroed-page stock is the cheapest source of all: the frames
+      are already sitting in this file. */
+   while (released < pages_wanted && zero_stack_top > 0)
+   {
+      pmm_free_frame(zero_stack[--zero_stack_top]);
+      released++;
+   }
+
+   /* Then the registered caches, cheapest cost first, each at most
+      once per pass. */
+   bool visited[PMM_MAX_SHRINKERS] = {false};
+   while (released < pages_wanted)
+   {
+      int best = -1;
+      for (int i = 0; i < PMM_MAX_SHRINKERS; i++)
+      {
+         if (!g_Shrinkers[i].used || visited[i]) continue;
+         if (best < 0 || g_Shrinkers[i].cost < g_Shrinkers[best].cost)
+            best = i;
+      }
+      if (best < 0) break;
+
+      visited[best] = true;
+      uint32_t got = g_Shrinkers[best].fn(pages_wanted - released);
+      g_Shrinkers[best].released += got;
+      released += got;
+   }
+
+   g_ShrinkActive = false;
+   return released;
+}
+
+void PMM_ShrinkIfLow(void)
+{
+   if (!page_bitmap) return;
+
+   uint32_t free_pages = total_pages - allocated_count;
+   if (free_pages >= PMM_LOW_WATERMARK) return;
+
+   pmm_shrink(PMM_LOW_WATERMARK - free_pages);
+}
+
 int PMM_IsInitialized(void) { return pmm_initialized; }
 
-uint32_t PMM_AllocatePhysicalPage(void)
+static uint32_t pmm_alloc_once(void)
 {
-   if (!page_bitmap) return 0;
+   // Fast path: pop a recently freed frame (skipping stale entries)
+   while (free_stack_top > 0)
+   {
+      uint32_t i = free_stack[--free_stack_top];
+      if (!bitmap_is_set(i))
+      {
+         bitmap_set(i);
+         if (i < REFCOUNT_MAX_PAGES) page_refcount[i] = 1;
+         return i * PAGE_SIZE;
+      }
+   }
 
-   // Simple linear search for a free page
-   for (uint32_t i = 0; i < total_pages; ++i)
+   // Slow path: next-fit scan from the last successful position
+   for (uint32_t n = 0; n < total_pages; ++n)
    {
+      uint32_t i = scan_hint + n;
+      if (i >= total_pages) i -= total_pages;
       if (!bitmap_is_set(i))
       {
          bitmap_set(i);
+         if (i < REFCOUNT_MAX_PAGES) page_refcount[i] = 1;
+         scan_hint = (i + 1 < total_pages) ? i + 1 : 0;
          return i * PAGE_SIZE;
       }
    }
 
+   return 0;
+}
+
+uint32_t PMM_AllocatePhysicalPage(void)
+{
+   if (!page_bitmap) return 0;
+
+   uint32_t addr = pmm_alloc_once();
+   if (addr) return addr;
+
+   /* Last resort: ask the caches to give frames back, then retry once
+      before reporting exhaustion. */
+   if (pmm_shrink(1) > 0)
+   {
+      addr = pmm_alloc_once();
+      if (addr) return addr;
+   }
+
    logfmt(LOG_ERROR, "[MEM] PMM_AllocatePhysicalPage: out of memory\n");
    return 0;
 }
 
+/* Core of the free path; the caller has checked that the PMM is up. */
+static void pmm_free_frame(uint32_t addr)
+{
+   if ((addr % PAGE_SIZE) != 0) return;
+
+   uint32_t page_idx = addr / PAGE_SIZE;
+   if (page_idx >= total_pages) return;
+
+   if (!bitmap_is_set(page_idx)) return;
+
+   if (page_idx < REFCOUNT_MAX_PAGES && page_refcount[page_idx] > 1)
+   {
+      // Saturated counts pin the frame; see PMM_RetainPhysicalPage.
+      if (page_refcount[page_idx] < 255) page_refcount[page_idx]--;
+      return;
+   }
+
+   if (page_idx < REFCOUNT_MAX_PAGES) page_refcount[page_idx] = 0;
+   bitmap_clear(page_idx);
+
+   if (free_stack_top < FREE_STACK_CAPACITY)
+   {
+      free_stack[free_stack_top++] = page_idx;
+   }
+}
+
 void PMM_FreePhysicalPage(uint32_t addr)
+{
+   if (!page_bitmap) return;
+   pmm_free_frame(addr);
+}
+
+void PMM_FreePageArray(const uint32_t *pages, uint32_t count)
+{
+   if (!page_bitmap || !pages) return;
+
+   for (uint32_t i = 0; i < count; i++) pmm_free_frame(pages[i]);
+}
+
+uint32_t PMM_AllocateContiguous(uint32_t order)
+{
+   if (!page_bitmap || order > 10) return 0;
+
+   uint32_t count = 1u << order;
+
+   // Scan naturally aligned runs, buddy-style, so DMA buffers come out
+   // aligned to their own size.
+   for (uint32_t start = 0; start + count <= total_pages; start += count)
+   {
+      uint32_t run = 0;
+      while (run < count && !bitmap_is_set(start + run)) ++run;
+      if (run < count) continue;
+
+      for (uint32_t i = 0; i < count; ++i)
+      {
+         bitmap_set(start + i);
+         if (start + i < REFCOUNT_MAX_PAGES) page_refcount[start + i] = 1;
+      }
+      return start * PAGE_SIZE;
+   }
+
+   logfmt(LOG_ERROR, "[MEM] PMM_AllocateContiguous: no run of %u pages\n",
+          count);
+   return 0;
+}
+
+void PMM_FreeContiguous(uint32_t addr, uint32_t order)
+{
+   if (order > 10) return;
+
+   uint32_t count = 1u << order;
+   for (uint32_t i = 0; i < count; ++i)
+   {
+      PMM_FreePhysicalPage(addr + (i * PAGE_SIZE));
+   }
+}
+
+uint32_t PMM_GetZeroPage(void) { return zero_page; }
+
+/* The background zeroing thread; NULL until PMM_StartZeroThread.  It
+ * parks itself once the stack is replenished and consumers wake it
+ * when the stock runs low. */
+static Process *zero_thread = NULL;
+
+static void pmm_zero_worker(void *arg)
+{
+   (void)arg;
+   for (;;)
+   {
+      PMM_ZeroPendingPages();
+      KThread_Park();
+   }
+}
+
+void PMM_StartZeroThread(void)
+{
+   zero_thread = KThread_Create("kzero", pmm_zero_worker, NULL);
+}
+
+uint32_t PMM_AllocateZeroedPage(void)
+{
+   // Fast path: a frame zeroed in the background
+   if (zero_stack_top > 0)
+   {
+      uint32_t addr = zero_stack[--zero_stack_top];
+      if (zero_thread && zero_stack_top < ZERO_STACK_CAPACITY / 4)
+      {
+         KThread_Wake(zero_thread);
+      }
+      return addr;
+   }
+
+   if (zero_thread) KThread_Wake(zero_thread);
+
+   uint32_t addr = PMM_AllocatePhysicalPage();
+   if (addr == 0) return 0;
+
+   // Frames live in the identity-mapped window, so clear them directly.
+   memset((void *)addr, 0, PAGE_SIZE);
+   return addr;
+}
+
+void PMM_ZeroPendingPages(void)
+{
+   if (!page_bitmap) return;
+
+   // Bound the work per call; this runs from the idle path and should
+   // never hoard memory when it is getting tight.
+   for (uint32_t n = 0; n < ZERO_BATCH; ++n)
+   {
+      if (zero_stack_top >= ZERO_STACK_CAPACITY) return;
+      if (PMM_FreePages() < ZERO_FREE_RESERVE) return;
+
+      uint32_t addr = PMM_AllocatePhysicalPage();
+      if (addr == 0) return;
+
+      memset((void *)addr, 0, PAGE_SIZE);
+      zero_stack[zero_stack_top++] = addr;
+   }
+}
+
+uint32_t PMM_AllocatePageAtomic(void)
+{
+   if (atomic_tail == atomic_head)
+   {
+      atomic_failures++;
+      return 0;
+   }
+
+   uint32_t addr = atomic_ring[atomic_tail & ATOMIC_RESERVE_MASK];
+   atomic_tail++;
+   return addr;
+}
+
+void PMM_FreePageAtomic(uint32_t addr)
+{
+   if (addr == 0 || (addr % PAGE_SIZE) != 0) return;
+
+   if (atomic_return_head - atomic_return_tail >= ATOMIC_RESERVE_CAPACITY)
+   {
+      /* Leaking one frame beats corrupting the bitmap from IRQ
+         context; the counter shows up if this ever happens. */
+      atomic_lost++;
+      return;
+   }
+
+   atomic_return_ring[atomic_return_head & ATOMIC_RESERVE_MASK] = addr;
+   atomic_return_head++;
+}
+
+void PMM_ReplenishAtomicReserve(void)
+{
+   if (!page_bitmap) return;
+
+   /* Hand frames freed in IRQ context back to the allocator first. */
+   while (atomic_return_tail != atomic_return_head)
+   {
+      uint32_t addr =
+          atomic_return_ring[atomic_return_tail & ATOMIC_RESERVE_MASK];
+      atomic_return_tail++;
+      PMM_FreePhysicalPage(addr);
+   }
+
+   /* Only top up once the stock drops below the watermark, and never
+      at the expense of the zero thread's free-page reserve. */
+   if (atomic_head - atomic_tail >= ATOMIC_RESERVE_LOW) return;
+
+   while (atomic_head - atomic_tail < ATOMIC_RESERVE_CAPACITY)
+   {
+      if (PMM_FreePages() < ZERO_FREE_RESERVE) return;
+
+      uint32_t addr = PMM_AllocatePhysicalPage();
+      if (addr == 0) return;
+
+      atomic_ring[atomic_head & ATOMIC_RESERVE_MASK] = addr;
+      atomic_head++;
+   }
+}
+
+void PMM_RetainPhysicalPage(uint32_t addr)
 {
    if (!page_bitmap || (addr % PAGE_SIZE) != 0) return;
 
    uint32_t page_idx = addr / PAGE_SIZE;
-   if (page_idx >= total_pages) return;
+   if (page_idx >= total_pages || !bitmap_is_set(page_idx)) return;
 
-   if (bitmap_is_set(page_idx))
+   if (page_idx >= REFCOUNT_MAX_PAGES)
    {
-      bitmap_clear(page_idx);
+      logfmt(LOG_WARNING, "[MEM] retain: page 0x%08x not tracked\n", addr);
+      return;
    }
+
+   /* A saturated count pins the frame (e.g. the shared zero page);
+      further retains and frees are deliberate no-ops. */
+   if (page_refcount[page_idx] < 255) page_refcount[page_idx]++;
+}
+
+uint32_t PMM_GetPageRefCount(uint32_t addr)
+{
+   if (!page_bitmap || (addr % PAGE_SIZE) != 0) return 0;
+
+   uint32_t page_idx = addr / PAGE_SIZE;
+   if (page_idx >= total_pages || !bitmap_is_set(page_idx)) return 0;
+
+   // Untracked or pre-refcount frames count as exclusively owned.
+   if (page_idx >= REFCOUNT_MAX_PAGES || page_refcount[page_idx] == 0)
+      return 1;
+
+   return page_refcount[page_idx];
 }
 
 int PMM_IsPhysicalPageFree(uint32_t addr)
@@ -172,6 +610,16 @@ void PMM_SelfTest(void)
       return;
    }
 
+   // Contiguous run: 4 pages, aligned to the run size
+   uint32_t run = PMM_AllocateContiguous(2);
+   if (!run || (run % (4 * PAGE_SIZE)) || PMM_IsPhysicalPageFree(run) ||
+       PMM_IsPhysicalPageFree(run + 3 * PAGE_SIZE))
+   {
+      logfmt(LOG_ERROR, "[MEM] self-test: FAIL (contiguous alloc)\n");
+      return;
+   }
+   PMM_FreeContiguous(run, 2);
+
    logfmt(LOG_INFO,
           "[MEM] self-test: PASS (allocated %u, freed, reallocated)\n", p1);
 }
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+ * Shared memory segments.
+ *
+ * A segment is a set of physical frames held by a global registry and
+ * mapped into any number of process directories.  The PMM's per-frame
+ * reference counts do the bookkeeping: the registry holds one reference
+ * from creation and every attach retains one more, so a detach (munmap
+ * or process exit) runs through the ordinary VMM_FreeInDir path and
+ * only drops that process's reference.  Producer/consumer pairs get a
+ * common buffer at memory speed instead of round-tripping through the
+ * filesystem.
+ */
+
+#include <constants.h>
+#include <cpu/process.h>
+#include <hal/mem.h>
+#include <mem/mm_kernel.h>
+#include <mem/mm_proc.h>
+#include <std/stdio.h>
+
+#define SHM_MAX_SEGMENTS 16
+#define SHM_MAX_PAGES 256 /* 1 MiB ceiling per segment */
+
+typedef struct
+{
+   bool used;
+   int32_t key;         /* Caller-chosen rendezvous identifier */
+   uint32_t page_count; /* Frames backing the segment */
+   uint32_t attaches;   /* Live process mappings */
+   uint32_t frames[SHM_MAX_PAGES];
+} ShmSegment;
+
+static ShmSegment g_Segments[SHM_MAX_SEGMENTS];
+
+// Create a segment, or return the existing one when the key is already
+// registered (shmget-style rendezvous: both daemons call create and the
+// second one finds the first one's segment)
+int SHM_Create(int32_t key, uint32_t size)
+{
+   if (size == 0) return -EINVAL;
+
+   uint32_t pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+   if (pages > SHM_MAX_PAGES) return -EINVAL;
+
+   int free_id = -1;
+   for (int id = 0; id < SHM_MAX_SEGMENTS; ++id)
+   {
+      if (!g_Segments[id].used)
+      {
+         if (free_id < 0) free_id = id;
+         continue;
+      }
+      if (g_Segments[id].key != key) continue;
+
+      // Existing segment: the size must fit inside it
+      if (pages > g_Segments[id].page_count) return -EINVAL;
+      return id;
+   }
+
+   if (free_id < 0) return -ENOMEM;
+
+   ShmSegment *seg = &g_Segments[free_id];
+   seg->page_count = 0;
+   for (uint32_t i = 0; i < pages; ++i)
+   {
+      uint32_t phys = PMM_AllocateZeroedPage();
+      if (phys == 0)
+      {
+         while (seg->page_count > 0)
+            PMM_FreePhysicalPage(seg->frames[--seg->page_count]);
+         return -ENOMEM;
+      }
+      seg->frames[seg->page_count++] = phys;
+   }
+
+   seg->key = key;
+   seg->attaches = 0;
+   seg->used = true;
+
+   logfmt(LOG_INFO, "[SHM] create: id=%d key=%d pages=%u\n", free_id, key,
+          pages);
+   return free_id;
+}
+
+// Map a segment into the calling process; returns the virtual address.
+// The mapping is recorded like an anonymous mmap region, so munmap and
+// exit-time cleanup release it through the existing paths.
+intptr_t SHM_Attach(void *proc_ptr, int id)
+{
+   Process *proc = (Process *)proc_ptr;
+
+   if (!proc || !proc->page_directory) return -EINVAL;
+   if (id < 0 || id >= SHM_MAX_SEGMENTS || !g_Segments[id].used)
+      return -EINVAL;
+
+   ShmSegment *seg = &g_Segments[id];
+   uint32_t length = seg->page_count * PAGE_SIZE;
+   uint32_t page_flags = HAL_PAGE_USER | HAL_PAGE_RW;
+
+   ProcessMapping *m = NULL;
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      if (!proc->mappings[i].used)
+      {
+         m = &proc->mappings[i];
+         break;
+      }
+   }
+   if (!m) return -ENOMEM;
+
+   void *va = VMM_ReserveInDir(proc->page_directory, length, page_flags);
+   if (!va) return -ENOMEM;
+
+   // The frames are not physically contiguous, so each page is mapped
+   // individually; a retain per page balances the free on detach
+   for (uint32_t i = 0; i < seg->page_count; ++i)
+   {
+      uint32_t page_va = (uint32_t)va + i * PAGE_SIZE;
+      if (VMM_MapInDir(proc->page_directory, page_va, seg->frames[i],
+                       PAGE_SIZE, page_flags) < 0)
+      {
+         // Drops the retains taken for the pages mapped so far, unmaps
+         // them and returns the reserved range in one pass
+         VMM_FreeInDir(proc->page_directory, va, length);
+         return -ENOMEM;
+      }
+      PMM_RetainPhysicalPage(seg->frames[i]);
+   }
+
+   m->start = (uint32_t)va;
+   m->length = length;
+   m->page_flags = page_flags | HAL_PAGE_PRESENT;
+   m->file_backed = false;
+   m->file = NULL;
+   m->path[0] = '\0';
+   m->used = true;
+
+   seg->attaches++;
+   logfmt(LOG_INFO, "[SHM] attach: id=%d pid=%u vaddr=0x%08x\n", id,
+          proc->pid, (uint32_t)va);
+   return (intptr_t)va;
+}
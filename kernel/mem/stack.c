@@ -87,15 +87,44 @@ int Stack_ProcessInitialize(Process *proc, uint32_t stack_top_va, size_t size)
    uint32_t stack_bottom_va = stack_top_va - size;
    uint32_t pages_needed = size / PAGE_SIZE;
 
-   // Allocate and map pages
+   // Map the stack copy-on-write onto the shared zero page: a fresh
+   // process only commits frames for the stack pages it actually
+   // touches, and every byte reads back as zero.
+   uint32_t zero_page = PMM_GetZeroPage();
+
    for (uint32_t i = 0; i < pages_needed; ++i)
    {
       uint32_t va = stack_bottom_va + (i * PAGE_SIZE);
-      uint32_t phys = PMM_AllocatePhysicalPage();
+
+      if (zero_page)
+      {
+         if (g_HalPagingOperations->MapPage(proc->page_directory, va,
+                                            zero_page,
+                                            HAL_PAGE_PRESENT | HAL_PAGE_USER |
+                                                HAL_PAGE_COW) < 0)
+         {
+            logfmt(LOG_ERROR, "[MEM] map_page failed for stack at 0x%08x\n",
+                   va);
+            for (uint32_t j = 0; j < i; ++j)
+            {
+               uint32_t va_cleanup = stack_bottom_va + (j * PAGE_SIZE);
+               uint32_t phys_cleanup =
+                   g_HalPagingOperations->GetPhysicalAddress(
+                       proc->page_directory, va_cleanup);
+               g_HalPagingOperations->UnmapPage(proc->page_directory,
+                                                va_cleanup);
+               if (phys_cleanup) PMM_FreePhysicalPage(phys_cleanup);
+            }
+            return -1;
+         }
+         continue;
+      }
+
+      uint32_t phys = PMM_AllocateZeroedPage();
 
       if (phys == 0)
       {
-         logfmt(LOG_ERROR, "[MEM] PMM_AllocatePhysicalPage failed\n");
+         logfmt(LOG_ERROR, "[MEM] PMM_AllocateZeroedPage failed\n");
          // Cleanup already mapped pages
          for (uint32_t j = 0; j < i; ++j)
          {
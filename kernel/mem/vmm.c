@@ -12,10 +12,180 @@
 #define PAGE_ALIGN_UP(v) (((v) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
 
 static void *kernel_page_dir = NULL;
-static uint32_t kernel_next_vaddr =
-    HAL_ARCH_BASE; // Use arch-specific kernel base
 static uint32_t kernel_vaddr_limit = 0xFFFFFFFFu;
 
+/* Per-directory VMA region lists
+ *
+ * Allocated virtual ranges are tracked as a sorted, non-overlapping
+ * list of regions per page directory; anything between regions is free.
+ * Allocation is first-fit over the gaps, so freed ranges are reused
+ * instead of leaking address space the way the old bump pointer did,
+ * and removing a region coalesces its neighbours' gap for free.  The
+ * list also answers range queries (VMM_FindRegion), the groundwork for
+ * mmap.
+ */
+typedef struct VMA_Region
+{
+   uint32_t start; /* inclusive, page-aligned */
+   uint32_t end;   /* exclusive, page-aligned */
+   uint32_t flags;
+   struct VMA_Region *next;
+} VMA_Region;
+
+typedef struct
+{
+   void *page_dir;
+   VMA_Region *regions; /* sorted by start */
+   uint32_t window_start;
+   uint32_t window_end;
+   bool used;
+} VMA_Space;
+
+/* User allocations go between the heap growth area and the stack. */
+#define VMM_USER_WINDOW_START 0x40000000u
+#define VMM_USER_WINDOW_END 0xB0000000u
+
+#define VMA_MAX_SPACES 16
+
+static VMA_Space g_KernelSpace;
+static VMA_Space g_UserSpaces[VMA_MAX_SPACES];
+
+static VMA_Space *vma_space_for(void *page_dir, bool create)
+{
+   if (page_dir == kernel_page_dir) return &g_KernelSpace;
+
+   VMA_Space *slot = NULL;
+   for (int i = 0; i < VMA_MAX_SPACES; ++i)
+   {
+      if (g_UserSpaces[i].used && g_UserSpaces[i].page_dir == page_dir)
+      {
+         return &g_UserSpaces[i];
+      }
+      if (!g_UserSpaces[i].used && !slot) slot = &g_UserSpaces[i];
+   }
+
+   if (!create) return NULL;
+   if (!slot)
+   {
+      logfmt(LOG_WARNING, "[MEM] VMM: out of VMA space slots\n");
+      return NULL;
+   }
+
+   slot->page_dir = page_dir;
+   slot->regions = NULL;
+   slot->window_start = VMM_USER_WINDOW_START;
+   slot->window_end = VMM_USER_WINDOW_END;
+   slot->used = true;
+   return slot;
+}
+
+/* First-fit scan of the gaps between regions. Returns 0 when the window
+ * has no gap of the requested size. */
+static uint32_t vma_find_gap(VMA_Space *space, uint32_t size)
+{
+   uint32_t candidate = space->window_start;
+
+   for (VMA_Region *r = space->regions; r; r = r->next)
+   {
+      if (r->start >= candidate && r->start - candidate >= size)
+      {
+         return candidate;
+      }
+      if (r->end > candidate) candidate = r->end;
+   }
+
+   if (candidate < space->window_end && space->window_end - candidate >= size)
+   {
+      return candidate;
+   }
+   return 0;
+}
+
+static int vma_insert(VMA_Space *space, uint32_t start, uint32_t end,
+                      uint32_t flags)
+{
+   VMA_Region **link = &space->regions;
+   while (*link && (*link)->start < start) link = &(*link)->next;
+
+   /* Extend the predecessor instead of adding a node when contiguous
+      with matching flags. */
+   if (link != &space->regions)
+   {
+      VMA_Region *prev = space->regions;
+      while (prev->next != *link) prev = prev->next;
+      if (prev->end == start && prev->flags == flags)
+      {
+         prev->end = end;
+         return SUCCESS;
+      }
+   }
+
+   VMA_Region *region = (VMA_Region *)kmalloc(sizeof(VMA_Region));
+   if (!region) return -1;
+
+   region->start = start;
+   region->end = end;
+   region->flags = flags;
+   region->next = *link;
+   *link = region;
+   return SUCCESS;
+}
+
+/* Remove [start, end) from the region list, trimming or splitting
+ * regions that partially overlap. */
+static void vma_remove(VMA_Space *space, uint32_t start, uint32_t end)
+{
+   VMA_Region **link = &space->regions;
+   while (*link)
+   {
+      VMA_Region *r = *link;
+
+      if (r->end <= start || r->start >= end)
+      {
+         link = &r->next;
+         continue;
+      }
+
+      if (r->start >= start && r->end <= end)
+      {
+         *link = r->next;
+         free(r);
+         continue;
+      }
+
+      if (r->start < start && r->end > end)
+      {
+         /* Freeing the middle: keep the head, split off the tail. */
+         VMA_Region *tail = (VMA_Region *)kmalloc(sizeof(VMA_Region));
+         if (tail)
+         {
+            tail->start = end;
+            tail->end = r->end;
+            tail->flags = r->flags;
+            tail->next = r->next;
+            r->next = tail;
+         }
+         else
+         {
+            logfmt(LOG_WARNING,
+                   "[MEM] VMM: region split failed, tail range dropped\n");
+         }
+         r->end = start;
+         return;
+      }
+
+      if (r->start < start)
+      {
+         r->end = start;
+      }
+      else
+      {
+         r->start = end;
+      }
+      link = &r->next;
+   }
+}
+
 void VMM_Initialize(void)
 {
    // Get the kernel page directory from paging subsystem
@@ -28,8 +198,8 @@ void VMM_Initialize(void)
    }
 
    /* Derive a runtime kernel virtual allocation ceiling from detected RAM.
-    * This avoids hardcoding a fixed top while still constraining the bump
-    * allocator to a realistic window above HAL_ARCH_BASE. */
+    * This avoids hardcoding a fixed top while still constraining the
+    * kernel VMA window to a realistic span above HAL_ARCH_BASE. */
    uint32_t total_phys = PMM_TotalMemory();
    if (total_phys > 0)
    {
@@ -44,6 +214,19 @@ void VMM_Initialize(void)
       }
    }
 
+   /* The top 4 MiB belong to the recursive page-directory self-map;
+    * never hand them out as kernel allocations. */
+   if (kernel_vaddr_limit > KERNEL_RECURSIVE_BASE)
+   {
+      kernel_vaddr_limit = KERNEL_RECURSIVE_BASE;
+   }
+
+   g_KernelSpace.page_dir = kernel_page_dir;
+   g_KernelSpace.regions = NULL;
+   g_KernelSpace.window_start = HAL_ARCH_BASE;
+   g_KernelSpace.window_end = kernel_vaddr_limit;
+   g_KernelSpace.used = true;
+
    logfmt(LOG_INFO, "[MEM] initialized with kernel page dir at 0x%08x\n",
           (uint32_t)kernel_page_dir);
 }
@@ -57,35 +240,49 @@ void *VMM_AllocateInDir(void *page_dir, uint32_t *next_vaddr_state,
    uint32_t aligned_size = PAGE_ALIGN_UP(size);
    uint32_t num_pages = aligned_size / PAGE_SIZE;
 
-   // Choose bump pointer: per-dir state or kernel default
-   uint32_t *bump = next_vaddr_state ? next_vaddr_state : &kernel_next_vaddr;
-   uint32_t limit =
-       (bump == &kernel_next_vaddr) ? kernel_vaddr_limit : HAL_ARCH_BASE;
+   /* The per-directory region list supersedes the old bump-pointer
+      state; the parameter is kept so callers don't churn. */
+   (void)next_vaddr_state;
 
-   // Kernel allocator must never start below kernel virtual base.
-   if (bump == &kernel_next_vaddr && *bump < HAL_ARCH_BASE)
-   {
-      *bump = HAL_ARCH_BASE;
-   }
+   VMA_Space *space = vma_space_for(page_dir, true);
+   if (!space) return NULL;
 
-   uint32_t next = *bump + aligned_size;
-
-   // Detect 32-bit wraparound and enforce virtual window limit.
-   if (next < *bump || next > limit)
+   uint32_t vaddr = vma_find_gap(space, aligned_size);
+   if (vaddr == 0)
    {
       logfmt(LOG_ERROR,
              "[MEM] VMM_Allocate: virtual address space exhausted\n");
       return NULL;
    }
 
-   uint32_t vaddr = *bump;
-   *bump = next;
+   /* User-space allocations map the shared zero page copy-on-write:
+      no frame is committed until the process actually writes, and reads
+      of untouched pages all hit one cache-warm frame.  Kernel
+      allocations are written immediately, so they take pre-zeroed
+      frames instead of paying a COW fault per page. */
+   uint32_t zero_page = (space != &g_KernelSpace) ? PMM_GetZeroPage() : 0;
 
-   // Allocate and map physical pages
    uint32_t mapped_pages = 0;
    for (uint32_t i = 0; i < num_pages; ++i)
    {
-      uint32_t paddr = PMM_AllocatePhysicalPage();
+      uint32_t va = vaddr + (i * PAGE_SIZE);
+
+      if (zero_page)
+      {
+         uint32_t pte_flags = (flags & ~HAL_PAGE_RW) | HAL_PAGE_PRESENT;
+         if (flags & HAL_PAGE_RW) pte_flags |= HAL_PAGE_COW;
+         if (g_HalPagingOperations->MapPage(page_dir, va, zero_page,
+                                            pte_flags) < 0)
+         {
+            logfmt(LOG_ERROR,
+                   "[MEM] VMM_Allocate: failed to map page at 0x%08x\n", va);
+            goto fail_cleanup;
+         }
+         mapped_pages++;
+         continue;
+      }
+
+      uint32_t paddr = PMM_AllocateZeroedPage();
       if (paddr == 0)
       {
          logfmt(LOG_ERROR,
@@ -94,7 +291,6 @@ void *VMM_AllocateInDir(void *page_dir, uint32_t *next_vaddr_state,
          goto fail_cleanup;
       }
 
-      uint32_t va = vaddr + (i * PAGE_SIZE);
       if (g_HalPagingOperations->MapPage(page_dir, va, paddr,
                                          flags | HAL_PAGE_PRESENT) < 0)
       {
@@ -103,15 +299,15 @@ void *VMM_AllocateInDir(void *page_dir, uint32_t *next_vaddr_state,
          PMM_FreePhysicalPage(paddr);
          goto fail_cleanup;
       }
-
-      // Zero-fill only if we're in the same active address space
-      if (g_HalPagingOperations->GetCurrentPageDirectory() == page_dir)
-      {
-         memset((void *)va, 0, PAGE_SIZE);
-      }
       mapped_pages++;
    }
 
+   if (vma_insert(space, vaddr, vaddr + aligned_size, flags) < 0)
+   {
+      logfmt(LOG_ERROR, "[MEM] VMM_Allocate: failed to record region\n");
+      goto fail_cleanup;
+   }
+
    return (void *)vaddr;
 
 fail_cleanup:
@@ -120,15 +316,59 @@ fail_cleanup:
       uint32_t va_cleanup = vaddr + (j * PAGE_SIZE);
       uint32_t pa_cleanup =
           g_HalPagingOperations->GetPhysicalAddress(page_dir, va_cleanup);
-      g_HalPagingOperations->UnmapPage(page_dir, va_cleanup);
       if (pa_cleanup) PMM_FreePhysicalPage(pa_cleanup);
    }
+   g_HalPagingOperations->UnmapRange(page_dir, vaddr, mapped_pages);
    return NULL;
 }
 
+void *VMM_ReserveInDir(void *page_dir, uint32_t size, uint32_t flags)
+{
+   if (size == 0) return NULL;
+
+   uint32_t aligned_size = PAGE_ALIGN_UP(size);
+
+   VMA_Space *space = vma_space_for(page_dir, true);
+   if (!space) return NULL;
+
+   uint32_t vaddr = vma_find_gap(space, aligned_size);
+   if (vaddr == 0)
+   {
+      logfmt(LOG_ERROR,
+             "[MEM] VMM_Reserve: virtual address space exhausted\n");
+      return NULL;
+   }
+
+   if (vma_insert(space, vaddr, vaddr + aligned_size, flags) < 0) return NULL;
+
+   return (void *)vaddr;
+}
+
+int VMM_ReserveRangeInDir(void *page_dir, uint32_t vaddr, uint32_t size,
+                          uint32_t flags)
+{
+   if (size == 0) return -EINVAL;
+
+   uint32_t aligned_size = PAGE_ALIGN_UP(size);
+
+   VMA_Space *space = vma_space_for(page_dir, true);
+   if (!space) return -ENOMEM;
+
+   for (VMA_Region *r = space->regions; r; r = r->next)
+   {
+      if (vaddr < r->end && vaddr + aligned_size > r->start) return -EINVAL;
+   }
+
+   if (vma_insert(space, vaddr, vaddr + aligned_size, flags) < 0)
+   {
+      return -ENOMEM;
+   }
+   return SUCCESS;
+}
+
 void *VMM_Allocate(uint32_t size, uint32_t flags)
 {
-   return VMM_AllocateInDir(kernel_page_dir, &kernel_next_vaddr, size, flags);
+   return VMM_AllocateInDir(kernel_page_dir, NULL, size, flags);
 }
 
 void VMM_FreeInDir(void *page_dir, void *vaddr, uint32_t size)
@@ -139,19 +379,20 @@ void VMM_FreeInDir(void *page_dir, void *vaddr, uint32_t size)
    uint32_t aligned_size = PAGE_ALIGN_UP(size);
    uint32_t num_pages = aligned_size / PAGE_SIZE;
 
-   // Unmap and free each page
+   // Free the backing frames, then drop all the mappings in one pass so
+   // the TLB is invalidated once instead of per page.
    for (uint32_t i = 0; i < num_pages; ++i)
    {
       uint32_t page_va = va + (i * PAGE_SIZE);
       uint32_t page_pa =
           g_HalPagingOperations->GetPhysicalAddress(page_dir, page_va);
 
-      if (page_pa != 0)
-      {
-         g_HalPagingOperations->UnmapPage(page_dir, page_va);
-         PMM_FreePhysicalPage(page_pa);
-      }
+      if (page_pa != 0) PMM_FreePhysicalPage(page_pa);
    }
+   g_HalPagingOperations->UnmapRange(page_dir, va, num_pages);
+
+   VMA_Space *space = vma_space_for(page_dir, false);
+   if (space) vma_remove(space, va, va + aligned_size);
 }
 
 void VMM_Free(void *vaddr, uint32_t size)
@@ -167,31 +408,17 @@ int VMM_MapInDir(void *page_dir, uint32_t vaddr, uint32_t paddr, uint32_t size,
    uint32_t aligned_size = PAGE_ALIGN_UP(size);
    uint32_t num_pages = aligned_size / PAGE_SIZE;
 
-   uint32_t mapped_pages = 0;
-   for (uint32_t i = 0; i < num_pages; ++i)
+   // MapRange installs every PTE first and invalidates once at the end
+   // (it rolls its own partial work back on failure).
+   if (g_HalPagingOperations->MapRange(page_dir, vaddr, paddr, num_pages,
+                                       flags | HAL_PAGE_PRESENT) < 0)
    {
-      uint32_t va = vaddr + (i * PAGE_SIZE);
-      uint32_t pa = paddr + (i * PAGE_SIZE);
-
-      if (g_HalPagingOperations->MapPage(page_dir, va, pa,
-                                         flags | HAL_PAGE_PRESENT) < 0)
-      {
-         logfmt(LOG_ERROR, "[MEM] VMM_Map: failed at offset 0x%x\n",
-                i * PAGE_SIZE);
-         goto rollback;
-      }
-      mapped_pages++;
+      logfmt(LOG_ERROR, "[MEM] VMM_Map: failed to map %u pages at 0x%08x\n",
+             num_pages, vaddr);
+      return VMM_EMAP;
    }
 
    return SUCCESS;
-
-rollback:
-   for (uint32_t j = 0; j < mapped_pages; ++j)
-   {
-      uint32_t va_cleanup = vaddr + (j * PAGE_SIZE);
-      g_HalPagingOperations->UnmapPage(page_dir, va_cleanup);
-   }
-   return VMM_EMAP;
 }
 
 int VMM_Map(uint32_t vaddr, uint32_t paddr, uint32_t size, uint32_t flags)
@@ -206,13 +433,7 @@ int VMM_UnmapInDir(void *page_dir, uint32_t vaddr, uint32_t size)
    uint32_t aligned_size = PAGE_ALIGN_UP(size);
    uint32_t num_pages = aligned_size / PAGE_SIZE;
 
-   for (uint32_t i = 0; i < num_pages; ++i)
-   {
-      uint32_t va = vaddr + (i * PAGE_SIZE);
-      g_HalPagingOperations->UnmapPage(page_dir, va);
-   }
-
-   return SUCCESS;
+   return g_HalPagingOperations->UnmapRange(page_dir, vaddr, num_pages);
 }
 
 int VMM_Unmap(uint32_t vaddr, uint32_t size)
@@ -230,6 +451,45 @@ uint32_t VMM_GetPhys(uint32_t vaddr)
    return VMM_GetPhysInDir(kernel_page_dir, vaddr);
 }
 
+int VMM_FindRegion(void *page_dir, uint32_t vaddr, uint32_t *start_out,
+                   uint32_t *end_out, uint32_t *flags_out)
+{
+   VMA_Space *space = vma_space_for(page_dir, false);
+   if (!space) return -EINVAL;
+
+   for (VMA_Region *r = space->regions; r; r = r->next)
+   {
+      if (r->start > vaddr) break;
+      if (vaddr < r->end)
+      {
+         if (start_out) *start_out = r->start;
+         if (end_out) *end_out = r->end;
+         if (flags_out) *flags_out = r->flags;
+         return SUCCESS;
+      }
+   }
+
+   return -EINVAL;
+}
+
+void VMM_DestroySpace(void *page_dir)
+{
+   VMA_Space *space = vma_space_for(page_dir, false);
+   if (!space || space == &g_KernelSpace) return;
+
+   VMA_Region *r = space->regions;
+   while (r)
+   {
+      VMA_Region *next = r->next;
+      free(r);
+      r = next;
+   }
+
+   space->regions = NULL;
+   space->page_dir = NULL;
+   space->used = false;
+}
+
 void *VMM_GetPageDirectory(void) { return kernel_page_dir; }
 
 void VMM_SelfTest(void)
@@ -282,5 +542,14 @@ void VMM_SelfTest(void)
       return;
    }
 
+   // Re-allocating the freed size must reuse the gap first-fit left behind
+   void *v3 = VMM_Allocate(PAGE_SIZE, VMM_DEFAULT);
+   if (v3 != v1)
+   {
+      logfmt(LOG_ERROR, "[MEM] self-test: FAIL (freed range not reused)\n");
+      return;
+   }
+   VMM_Free(v3, PAGE_SIZE);
+
    logfmt(LOG_INFO, "[MEM] self-test: PASS (alloc/map/write/read/free)\n");
 }
@@ -0,0 +1,321 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/*
+ * Compressed in-RAM store for cold anonymous pages.
+ *
+ * There is no swap device, so sbrk heap stays frame-for-frame resident
+ * until process exit; long-lived daemons end up pinning pages they have
+ * not touched in minutes.  The idle loop ages one process's heap per
+ * pass with the hardware accessed bit (i686_Paging_ScanIdlePages); a
+ * page idle through two consecutive passes is compressed into a
+ * heap-backed slot here and its frame handed back to the PMM.  The
+ * page-fault path decompresses it on the next touch, so the cost of a
+ * wrong guess is one fault plus a 4 KiB decompress instead of a disk
+ * round trip.
+ *
+ * Concurrency: the scan runs with interrupts disabled and the fetch
+ * runs in the page-fault handler, so the two never interleave; the
+ * remaining entry points run in process context where nothing else can
+ * touch the table concurrently on this single-CPU kernel.
+ */
+
+#include <constants.h>
+#include <cpu/process.h>
+#include <cpu/scheduler.h>
+#include <hal/io.h>
+#include <hal/mem.h>
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <std/string.h>
+
+/* LZJB-family compressor: byte-oriented LZ with 10-bit offsets, 6-bit
+ * match lengths and one copymap bit per item.  Ratios trail LZ4 a
+ * little, but it is dependency-free, the working set is one small hash
+ * table, and the decompressor below never reads past its input. */
+#define ZSTORE_MATCH_BITS 6
+#define ZSTORE_MATCH_MIN 3
+#define ZSTORE_MATCH_MAX ((1u << ZSTORE_MATCH_BITS) + (ZSTORE_MATCH_MIN - 1))
+#define ZSTORE_OFFSET_MASK ((1u << (16 - ZSTORE_MATCH_BITS)) - 1)
+#define ZSTORE_LEMPEL_SIZE 1024
+
+#define ZSTORE_MAX_ENTRIES 512
+
+/* A page must compress to under 7/8 of its size to be worth storing;
+ * below that the slot bookkeeping eats the savings. */
+#define ZSTORE_COMPRESS_CAP (PAGE_SIZE - PAGE_SIZE / 8)
+
+typedef struct
+{
+   bool used;
+   void *page_dir; /* Owning address space */
+   uint32_t vaddr; /* Page base in that space */
+   uint16_t size;  /* Compressed payload bytes */
+   uint8_t *data;  /* kmalloc'd payload */
+} ZStoreEntry;
+
+static ZStoreEntry g_ZStore[ZSTORE_MAX_ENTRIES];
+static uint32_t g_ZStoreUsed;
+
+static uint16_t g_Lempel[ZSTORE_LEMPEL_SIZE];
+static uint8_t g_CompressScratch[PAGE_SIZE];
+
+/* Lifetime traffic counters (debugger-visible) */
+static uint32_t g_ZStoreSaved;
+static uint32_t g_ZStoreFetched;
+
+/* Compress len bytes of src into dst.  Returns the compressed size, or
+ * cap when the output would not fit (caller keeps the raw page). */
+static uint32_t zstore_compress(const uint8_t *src, uint32_t len,
+                                uint8_t *dst, uint32_t cap)
+{
+   uint32_t s = 0, d = 0;
+   uint32_t copymask = 0x80; /* forces a fresh copymap byte first */
+   uint32_t copymap = 0;
+
+   while (s < len)
+   {
+      copymask <<= 1;
+      if (copymask == 0x100)
+      {
+         if (d >= cap) return cap;
+         copymask = 1;
+         copymap = d;
+         dst[d++] = 0;
+      }
+
+      if (s + ZSTORE_MATCH_MAX > len)
+      {
+         /* Too close to the end for a full-length match compare. */
+         if (d >= cap) return cap;
+         dst[d++] = src[s++];
+         continue;
+      }
+
+      uint32_t hash = ((uint32_t)src[s] << 16) +
+                      ((uint32_t)src[s + 1] << 8) + src[s + 2];
+      hash += hash >> 9;
+      hash += hash >> 5;
+      uint16_t *hp = &g_Lempel[hash & (ZSTORE_LEMPEL_SIZE - 1)];
+      uint32_t offset = (s - *hp) & ZSTORE_OFFSET_MASK;
+      uint32_t cpy = s - offset;
+      *hp = (uint16_t)s;
+
+      if (offset != 0 && cpy < s && src[cpy] == src[s] &&
+          src[cpy + 1] == src[s + 1] && src[cpy + 2] == src[s + 2])
+      {
+         if (d + 2 > cap) return cap;
+         dst[copymap] |= copymask;
+         uint32_t mlen;
+         for (mlen = ZSTORE_MATCH_MIN; mlen < ZSTORE_MATCH_MAX; mlen++)
+         {
+            if (src[s + mlen] != src[cpy + mlen]) break;
+         }
+         dst[d++] = (uint8_t)(((mlen - ZSTORE_MATCH_MIN)
+                               << (8 - ZSTORE_MATCH_BITS)) |
+                              (offset >> 8));
+         dst[d++] = (uint8_t)offset;
+         s += mlen;
+      }
+      else
+      {
+         if (d >= cap) return cap;
+         dst[d++] = src[s++];
+      }
+   }
+
+   return d;
+}
+
+/* Decompress exactly cap bytes into dst.  Every read and write is
+ * bounds-checked: a corrupted payload yields -EINVAL, never a stray
+ * store.  Returns SUCCESS when dst was filled completely. */
+static int zstore_decompress(const uint8_t *src, uint32_t len, uint8_t *dst,
+                             uint32_t cap)
+{
+   uint32_t s = 0, d = 0;
+   uint32_t copymask = 0x80;
+   uint8_t copymap = 0;
+
+   while (s < len)
+   {
+      copymask <<= 1;
+      if (copymask == 0x100)
+      {
+         copymask = 1;
+         copymap = src[s++];
+         if (s >= len) break;
+      }
+
+      if (copymap & copymask)
+      {
+         if (s + 2 > len) return -EINVAL;
+         uint32_t mlen =
+             (src[s] >> (8 - ZSTORE_MATCH_BITS)) + ZSTORE_MATCH_MIN;
+         uint32_t offset = (((uint32_t)src[s] << 8) | src[s + 1]) &
+                           ZSTORE_OFFSET_MASK;
+         s += 2;
+         if (offset == 0 || offset > d || d + mlen > cap) return -EINVAL;
+         for (uint32_t i = 0; i < mlen; i++)
+         {
+            dst[d] = dst[d - offset];
+            d++;
+         }
+      }
+      else
+      {
+         if (d >= cap) return -EINVAL;
+         dst[d++] = src[s++];
+      }
+   }
+
+   return d == cap ? SUCCESS : -EINVAL;
+}
+
+/* Compress one page into a free slot.  Returns the slot index, -ENOMEM
+ * when the store (or the heap) is full, or -EINVAL when the page does
+ * not compress well enough to be worth holding. */
+int ZStore_Save(void *page_dir, uint32_t vaddr, const void *page)
+{
+   if (g_ZStoreUsed >= ZSTORE_MAX_ENTRIES) return -ENOMEM;
+
+   memset(g_Lempel, 0, sizeof(g_Lempel));
+   uint32_t size = zstore_compress(page, PAGE_SIZE, g_CompressScratch,
+                                   ZSTORE_COMPRESS_CAP);
+   if (size >= ZSTORE_COMPRESS_CAP) return -EINVAL;
+
+   uint32_t slot;
+   for (slot = 0; slot < ZSTORE_MAX_ENTRIES; slot++)
+   {
+      if (!g_ZStore[slot].used) break;
+   }
+   if (slot == ZSTORE_MAX_ENTRIES) return -ENOMEM;
+
+   uint8_t *data = kmalloc(size);
+   if (!data) return -ENOMEM;
+   memcpy(data, g_CompressScratch, size);
+
+   g_ZStore[slot].used = true;
+   g_ZStore[slot].page_dir = page_dir;
+   g_ZStore[slot].vaddr = vaddr;
+   g_ZStore[slot].size = (uint16_t)size;
+   g_ZStore[slot].data = data;
+   g_ZStoreUsed++;
+   g_ZStoreSaved++;
+
+   return (int)slot;
+}
+
+static void zstore_release_slot(ZStoreEntry *entry)
+{
+   free(entry->data);
+   entry->data = NULL;
+   entry->used = false;
+   g_ZStoreUsed--;
+}
+
+/* Decompress a slot back into page_out and release it.  The directory
+ * and address must match what was saved; a swapped PTE pointing at a
+ * slot someone else owns means table corruption, so reject it. */
+int ZStore_Fetch(uint32_t slot, void *page_dir, uint32_t vaddr,
+                 void *page_out)
+{
+   if (slot >= ZSTORE_MAX_ENTRIES) return -EINVAL;
+
+   ZStoreEntry *entry = &g_ZStore[slot];
+   if (!entry->used || entry->page_dir != page_dir || entry->vaddr != vaddr)
+   {
+      logfmt(LOG_ERROR, "[ZSTORE] stale slot %u for page 0x%08x\n", slot,
+             vaddr);
+      return -EINVAL;
+   }
+
+   if (zstore_decompress(entry->data, entry->size, page_out, PAGE_SIZE) !=
+       SUCCESS)
+   {
+      logfmt(LOG_ERROR, "[ZSTORE] corrupt payload in slot %u\n", slot);
+      zstore_release_slot(entry);
+      return -EINVAL;
+   }
+
+   zstore_release_slot(entry);
+   g_ZStoreFetched++;
+   return SUCCESS;
+}
+
+/* Pull every compressed page of one directory back into frames; fork
+ * calls this before its COW walk, because a swapped PTE carries a slot
+ * private to the parent's directory and cannot be shared. */
+int ZStore_RestoreDirectory(void *page_dir)
+{
+   for (uint32_t slot = 0; slot < ZSTORE_MAX_ENTRIES; slot++)
+   {
+      ZStoreEntry *entry = &g_ZStore[slot];
+      if (!entry->used || entry->page_dir != page_dir) continue;
+
+      uint32_t phys = PMM_AllocatePhysicalPage();
+      if (phys == 0) return -ENOMEM;
+
+      if (zstore_decompress(entry->data, entry->size, (uint8_t *)phys,
+                            PAGE_SIZE) != SUCCESS)
+      {
+         logfmt(LOG_ERROR, "[ZSTORE] corrupt payload in slot %u\n", slot);
+         PMM_FreePhysicalPage(phys);
+         zstore_release_slot(entry);
+         continue;
+      }
+
+      g_HalPagingOperations->MapPage(page_dir, entry->vaddr, phys,
+                                     HAL_PAGE_PRESENT | HAL_PAGE_RW |
+                                         HAL_PAGE_USER);
+      zstore_release_slot(entry);
+      g_ZStoreFetched++;
+   }
+
+   return SUCCESS;
+}
+
+/* Drop every slot owned by a dying address space (process teardown;
+ * the swapped PTEs go away with the directory). */
+void ZStore_DropDirectory(void *page_dir)
+{
+   for (uint32_t slot = 0; slot < ZSTORE_MAX_ENTRIES; slot++)
+   {
+      ZStoreEntry *entry = &g_ZStore[slot];
+      if (entry->used && entry->page_dir == page_dir)
+      {
+         zstore_release_slot(entry);
+      }
+   }
+}
+
+/* One aging pass over one process's heap per call; the idle loop
+ * drives this.  A rotating cursor spreads the passes across processes,
+ * and the per-call compression budget keeps the interrupts-off window
+ * inside the scan short. */
+#define ZSTORE_SCAN_MAX_OUT 16
+
+static uint32_t g_ZStoreScanCursor;
+
+void ZStore_BackgroundScan(void)
+{
+   if (g_ZStoreUsed >= ZSTORE_MAX_ENTRIES) return;
+
+   /* Interrupts off across pick-and-scan so the chosen process cannot
+    * exit (or fork) between the lookup and the walk. */
+   g_HalIoOperations->DisableInterrupts();
+
+   uint32_t count = Scheduler_GetProcessCount();
+   for (uint32_t i = 0; i < count; i++)
+   {
+      Process *proc = Scheduler_GetProcessAt(g_ZStoreScanCursor++ % count);
+      if (!proc || proc->kernel_mode) continue;
+      if (!proc->heap_start || proc->heap_end <= proc->heap_start) continue;
+
+      g_HalPagingOperations->ScanIdlePages(proc->page_directory,
+                                           proc->heap_start, proc->heap_end,
+                                           ZSTORE_SCAN_MAX_OUT);
+      break;
+   }
+
+   g_HalIoOperations->EnableInterrupts();
+}
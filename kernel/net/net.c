@@ -0,0 +1,524 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "net.h"
+#include <constants.h>
+#include <cpu/lockstat.h>
+#include <cpu/process.h>
+#include <cpu/spinlock.h>
+#include <cpu/timer.h>
+#include <drivers/net/rtl8139.h>
+#include <hal/io.h>
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <std/string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/cmdline.h>
+
+/* =========================================================================
+ * Minimal IPv4/UDP over the RTL8139
+ *
+ * Everything is sized at init and recycled: received datagrams land in
+ * a fixed pool of packet buffers (allocated once, KMOD-style), and
+ * outgoing frames are built header-first directly inside the NIC's
+ * transmit descriptor buffer, so a user payload is copied exactly once
+ * in each direction.  No heap allocation happens per packet.
+ *
+ * Scope is deliberately small: static /24 addressing from the command
+ * line (ip=/gw=), ARP with a small cache, UDP with implicit port
+ * binding on first receive.  No TCP, no fragmentation, no routing
+ * beyond "on-link or via the gateway".
+ * ====================================================================== */
+
+#define ETH_TYPE_IP 0x0800
+#define ETH_TYPE_ARP 0x0806
+#define ETH_ALEN 6
+
+#define IP_PROTO_UDP 17
+#define NET_NETMASK 0xFFFFFF00u /* Static /24 */
+
+typedef struct
+{
+   uint8_t dest[ETH_ALEN];
+   uint8_t src[ETH_ALEN];
+   uint16_t type;
+} __attribute__((packed)) eth_header_t;
+
+typedef struct
+{
+   uint16_t hw_type;
+   uint16_t proto_type;
+   uint8_t hw_len;
+   uint8_t proto_len;
+   uint16_t opcode; /* 1 = request, 2 = reply */
+   uint8_t sender_mac[ETH_ALEN];
+   uint32_t sender_ip;
+   uint8_t target_mac[ETH_ALEN];
+   uint32_t target_ip;
+} __attribute__((packed)) arp_packet_t;
+
+typedef struct
+{
+   uint8_t version_ihl; /* 0x45: IPv4, 20-byte header */
+   uint8_t tos;
+   uint16_t total_length;
+   uint16_t id;
+   uint16_t flags_fragment;
+   uint8_t ttl;
+   uint8_t protocol;
+   uint16_t checksum;
+   uint32_t src_ip;
+   uint32_t dest_ip;
+} __attribute__((packed)) ip_header_t;
+
+typedef struct
+{
+   uint16_t src_port;
+   uint16_t dest_port;
+   uint16_t length;
+   uint16_t checksum; /* 0 = not computed (legal for IPv4 UDP) */
+} __attribute__((packed)) udp_header_t;
+
+/* Packet buffer pool ---------------------------------------------------- */
+
+/* One buffer holds the receive metadata plus a maximal UDP payload.
+ * The pool is carved from a single allocation at init and indices are
+ * recycled through a free stack - the data path never touches the
+ * heap. */
+#define NET_NBUF_COUNT 64u
+
+typedef struct
+{
+   uint32_t src_ip;
+   uint16_t src_port;
+   uint16_t len;
+   uint8_t data[NET_UDP_PAYLOAD_MAX];
+} NetNbuf;
+
+static NetNbuf *g_NbufPool = NULL;
+static uint16_t g_NbufFree[NET_NBUF_COUNT]; /* Stack of free indices */
+static uint32_t g_NbufFreeCount = 0;
+static uint32_t g_NbufExhausted = 0; /* Datagrams dropped, pool empty */
+
+/* The IRQ tap allocates and the receive syscall frees, so pool and
+ * queue mutation is fenced IRQ-safe. */
+static Spinlock g_NetLock = SPINLOCK_INIT;
+
+/* ARP ------------------------------------------------------------------- */
+
+#define NET_ARP_ENTRIES 16u
+#define NET_ARP_TIMEOUT_NS 1000000000ull /* 1 s resolve deadline */
+
+typedef struct
+{
+   uint32_t ip; /* 0 = slot free */
+   uint8_t mac[ETH_ALEN];
+} ArpEntry;
+
+static ArpEntry g_ArpCache[NET_ARP_ENTRIES];
+static uint32_t g_ArpNext = 0; /* Round-robin replacement */
+
+/* UDP port bindings ----------------------------------------------------- */
+
+#define NET_UDP_PORTS 8u
+#define NET_SOCK_QUEUE 16u
+
+typedef struct
+{
+   uint16_t port; /* 0 = slot free */
+   uint16_t queue[NET_SOCK_QUEUE]; /* nbuf indices, ring order */
+   uint32_t head;
+   uint32_t tail;
+   volatile uint32_t count;
+} UdpBinding;
+
+static UdpBinding g_UdpPorts[NET_UDP_PORTS];
+
+/* Interface configuration ----------------------------------------------- */
+
+static bool g_NetUp = false;
+static uint8_t g_NetMac[ETH_ALEN];
+static uint32_t g_NetIp = 0;      /* Host byte order */
+static uint32_t g_NetGateway = 0; /* Host byte order */
+static uint16_t g_IpId = 0;
+
+/* Byte order helpers: i686 is little-endian, the wire is big-endian. */
+static inline uint16_t htons16(uint16_t v)
+{
+   return (uint16_t)((v << 8) | (v >> 8));
+}
+static inline uint16_t ntohs16(uint16_t v) { return htons16(v); }
+static inline uint32_t htonl32(uint32_t v)
+{
+   return (v << 24) | ((v & 0xFF00) << 8) | ((v >> 8) & 0xFF00) | (v >> 24);
+}
+static inline uint32_t ntohl32(uint32_t v) { return htonl32(v); }
+
+/* RFC 1071 checksum over the IP header. */
+static uint16_t ip_checksum(const void *data, uint32_t len)
+{
+   const uint8_t *p = (const uint8_t *)data;
+   uint32_t sum = 0;
+   while (len > 1)
+   {
+      sum += (uint32_t)((p[0] << 8) | p[1]);
+      p += 2;
+      len -= 2;
+   }
+   if (len) sum += (uint32_t)(p[0] << 8);
+   while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+   return htons16((uint16_t)~sum);
+}
+
+/* "a.b.c.d" to host byte order; `def` when absent or malformed. */
+static uint32_t parse_ipv4(const char *str, uint32_t def)
+{
+   if (!str) return def;
+
+   uint32_t ip = 0;
+   for (int octet = 0; octet < 4; octet++)
+   {
+      uint32_t val = 0;
+      int digits = 0;
+      while (*str >= '0' && *str <= '9' && digits < 3)
+      {
+         val = val * 10 + (uint32_t)(*str - '0');
+         str++;
+         digits++;
+      }
+      if (!digits || val > 255) return def;
+      ip = (ip << 8) | val;
+      if (octet < 3)
+      {
+         if (*str != '.') return def;
+         str++;
+      }
+   }
+   return ip;
+}
+
+/* nbuf pool (call with g_NetLock held) ---------------------------------- */
+
+static int nbuf_alloc(void)
+{
+   if (g_NbufFreeCount == 0) return -1;
+   return g_NbufFree[--g_NbufFreeCount];
+}
+
+static void nbuf_release(int idx)
+{
+   g_NbufFree[g_NbufFreeCount++] = (uint16_t)idx;
+}
+
+/* ARP ------------------------------------------------------------------- */
+
+static bool arp_lookup(uint32_t ip, uint8_t mac[ETH_ALEN])
+{
+   for (uint32_t i = 0; i < NET_ARP_ENTRIES; i++)
+   {
+      if (g_ArpCache[i].ip == ip)
+      {
+         memcpy(mac, g_ArpCache[i].mac, ETH_ALEN);
+         return true;
+      }
+   }
+   return false;
+}
+
+static void arp_insert(uint32_t ip, const uint8_t mac[ETH_ALEN])
+{
+   for (uint32_t i = 0; i < NET_ARP_ENTRIES; i++)
+   {
+      if (g_ArpCache[i].ip == ip)
+      {
+         memcpy(g_ArpCache[i].mac, mac, ETH_ALEN);
+         return;
+      }
+   }
+   g_ArpCache[g_ArpNext].ip = ip;
+   memcpy(g_ArpCache[g_ArpNext].mac, mac, ETH_ALEN);
+   g_ArpNext = (g_ArpNext + 1) % NET_ARP_ENTRIES;
+}
+
+/* Build and send one ARP packet straight in the descriptor buffer. */
+static void arp_send(uint16_t opcode, uint32_t target_ip,
+                     const uint8_t target_mac[ETH_ALEN])
+{
+   uint8_t *frame = RTL8139_TxAcquire();
+   if (!frame) return;
+
+   eth_header_t *eth = (eth_header_t *)frame;
+   memcpy(eth->dest, target_mac, ETH_ALEN);
+   memcpy(eth->src, g_NetMac, ETH_ALEN);
+   eth->type = htons16(ETH_TYPE_ARP);
+
+   arp_packet_t *arp = (arp_packet_t *)(frame + sizeof(eth_header_t));
+   arp->hw_type = htons16(1); /* Ethernet */
+   arp->proto_type = htons16(ETH_TYPE_IP);
+   arp->hw_len = ETH_ALEN;
+   arp->proto_len = 4;
+   arp->opcode = htons16(opcode);
+   memcpy(arp->sender_mac, g_NetMac, ETH_ALEN);
+   arp->sender_ip = htonl32(g_NetIp);
+   memcpy(arp->target_mac, target_mac, ETH_ALEN);
+   arp->target_ip = htonl32(target_ip);
+
+   RTL8139_TxSubmit(sizeof(eth_header_t) + sizeof(arp_packet_t));
+}
+
+/* Resolve `ip` to a MAC, asking on the wire on a cold cache.  Same
+ * bounded halt-until-interrupt wait as FD_Poll. */
+static int arp_resolve(uint32_t ip, uint8_t mac[ETH_ALEN])
+{
+   static const uint8_t broadcast[ETH_ALEN] = {0xFF, 0xFF, 0xFF,
+                                               0xFF, 0xFF, 0xFF};
+   if (arp_lookup(ip, mac)) return SUCCESS;
+
+   arp_send(1, ip, broadcast);
+
+   uint64_t deadline = Timer_GetMonotonicNs() + NET_ARP_TIMEOUT_NS;
+   while (!arp_lookup(ip, mac))
+   {
+      if (Timer_GetMonotonicNs() >= deadline) return -ENODEV;
+      uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+      if (!interrupts_were_enabled)
+      {
+         g_HalIoOperations->DisableInterrupts();
+      }
+   }
+   return SUCCESS;
+}
+
+/* Receive path (runs in the NIC's IRQ drain) ---------------------------- */
+
+static void arp_input(const uint8_t *frame, uint32_t len)
+{
+   if (len < sizeof(eth_header_t) + sizeof(arp_packet_t)) return;
+
+   const arp_packet_t *arp =
+       (const arp_packet_t *)(frame + sizeof(eth_header_t));
+   if (ntohs16(arp->proto_type) != ETH_TYPE_IP) return;
+
+   /* Every ARP packet teaches us the sender's mapping. */
+   arp_insert(ntohl32(arp->sender_ip), arp->sender_mac);
+
+   if (ntohs16(arp->opcode) == 1 && ntohl32(arp->target_ip) == g_NetIp)
+      arp_send(2, ntohl32(arp->sender_ip), arp->sender_mac);
+}
+
+static bool udp_input(const uint8_t *frame, uint32_t len)
+{
+   if (len < sizeof(eth_header_t) + sizeof(ip_header_t) +
+                 sizeof(udp_header_t))
+      return false;
+
+   const ip_header_t *ip =
+       (const ip_header_t *)(frame + sizeof(eth_header_t));
+   if (ip->version_ihl != 0x45) return false; /* Options unsupported */
+   if (ip->protocol != IP_PROTO_UDP) return false;
+
+   uint32_t dest = ntohl32(ip->dest_ip);
+   if (dest != g_NetIp && dest != 0xFFFFFFFFu &&
+       dest != (g_NetIp | ~NET_NETMASK))
+      return false;
+
+   const udp_header_t *udp = (const udp_header_t *)((const uint8_t *)ip +
+                                                    sizeof(ip_header_t));
+   uint16_t port = ntohs16(udp->dest_port);
+   uint32_t payload_len = ntohs16(udp->length);
+   if (payload_len < sizeof(udp_header_t)) return false;
+   payload_len -= sizeof(udp_header_t);
+   if (payload_len > NET_UDP_PAYLOAD_MAX) return false;
+
+   UdpBinding *bind = NULL;
+   for (uint32_t i = 0; i < NET_UDP_PORTS; i++)
+   {
+      if (g_UdpPorts[i].port == port)
+      {
+         bind = &g_UdpPorts[i];
+         break;
+      }
+   }
+   if (!bind) return false; /* Nobody listening; leave it to /dev/net0 */
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_NetLock);
+   int idx = -1;
+   if (bind->count < NET_SOCK_QUEUE) idx = nbuf_alloc();
+   if (idx >= 0)
+   {
+      NetNbuf *nbuf = &g_NbufPool[idx];
+      nbuf->src_ip = ntohl32(ip->src_ip);
+      nbuf->src_port = ntohs16(udp->src_port);
+      nbuf->len = (uint16_t)payload_len;
+      memcpy(nbuf->data, (const uint8_t *)udp + sizeof(udp_header_t),
+             payload_len);
+
+      bind->queue[bind->head] = (uint16_t)idx;
+      bind->head = (bind->head + 1) % NET_SOCK_QUEUE;
+      bind->count++;
+   }
+   else
+   {
+      g_NbufExhausted++;
+   }
+   Spinlock_ReleaseIrqRestore(&g_NetLock, interrupts_were_enabled);
+
+   if (idx >= 0) Process_WakeByChannel(bind);
+   return true;
+}
+
+static bool net_rx_tap(const uint8_t *frame, uint32_t len)
+{
+   if (len < sizeof(eth_header_t)) return false;
+
+   uint16_t type = ntohs16(((const eth_header_t *)frame)->type);
+   if (type == ETH_TYPE_ARP)
+   {
+      arp_input(frame, len);
+      return true;
+   }
+   if (type == ETH_TYPE_IP) return udp_input(frame, len);
+   return false;
+}
+
+/* Send / receive -------------------------------------------------------- */
+
+int Net_UdpSend(uint32_t dest_ip, uint16_t dest_port, uint16_t src_port,
+                const void *payload, uint32_t len)
+{
+   static const uint8_t broadcast[ETH_ALEN] = {0xFF, 0xFF, 0xFF,
+                                               0xFF, 0xFF, 0xFF};
+   if (!g_NetUp) return -ENODEV;
+   if (!payload || len == 0 || len > NET_UDP_PAYLOAD_MAX) return -EINVAL;
+
+   /* On-link hosts are ARPed directly, everything else goes through
+    * the gateway; broadcasts skip resolution. */
+   uint8_t dest_mac[ETH_ALEN];
+   if (dest_ip == 0xFFFFFFFFu || dest_ip == (g_NetIp | ~NET_NETMASK))
+   {
+      memcpy(dest_mac, broadcast, ETH_ALEN);
+   }
+   else
+   {
+      uint32_t hop = ((dest_ip & NET_NETMASK) == (g_NetIp & NET_NETMASK))
+                         ? dest_ip
+                         : g_NetGateway;
+      int rc = arp_resolve(hop, dest_mac);
+      if (rc < 0) return rc;
+   }
+
+   uint8_t *frame = RTL8139_TxAcquire();
+   if (!frame) return -ENODEV;
+
+   /* Headers in place, then the single payload copy. */
+   eth_header_t *eth = (eth_header_t *)frame;
+   memcpy(eth->dest, dest_mac, ETH_ALEN);
+   memcpy(eth->src, g_NetMac, ETH_ALEN);
+   eth->type = htons16(ETH_TYPE_IP);
+
+   ip_header_t *ip = (ip_header_t *)(frame + sizeof(eth_header_t));
+   ip->version_ihl = 0x45;
+   ip->tos = 0;
+   ip->total_length =
+       htons16((uint16_t)(sizeof(ip_header_t) + sizeof(udp_header_t) + len));
+   ip->id = htons16(g_IpId++);
+   ip->flags_fragment = htons16(0x4000); /* Don't fragment */
+   ip->ttl = 64;
+   ip->protocol = IP_PROTO_UDP;
+   ip->checksum = 0;
+   ip->src_ip = htonl32(g_NetIp);
+   ip->dest_ip = htonl32(dest_ip);
+   ip->checksum = ip_checksum(ip, sizeof(ip_header_t));
+
+   udp_header_t *udp = (udp_header_t *)((uint8_t *)ip + sizeof(ip_header_t));
+   udp->src_port = htons16(src_port);
+   udp->dest_port = htons16(dest_port);
+   udp->length = htons16((uint16_t)(sizeof(udp_header_t) + len));
+   udp->checksum = 0; /* Optional for IPv4 */
+
+   memcpy((uint8_t *)udp + sizeof(udp_header_t), payload, len);
+
+   RTL8139_TxSubmit((uint32_t)(sizeof(eth_header_t) + sizeof(ip_header_t) +
+                               sizeof(udp_header_t) + len));
+   return (int)len;
+}
+
+int Net_UdpRecv(uint16_t port, void *buf, uint32_t len, uint32_t *src_ip,
+                uint16_t *src_port)
+{
+   if (!g_NetUp) return -ENODEV;
+   if (!buf || len == 0 || port == 0) return -EINVAL;
+
+   /* Implicit bind: find the port's slot, or claim a free one. */
+   UdpBinding *bind = NULL;
+   for (uint32_t i = 0; i < NET_UDP_PORTS && !bind; i++)
+      if (g_UdpPorts[i].port == port) bind = &g_UdpPorts[i];
+   for (uint32_t i = 0; i < NET_UDP_PORTS && !bind; i++)
+      if (g_UdpPorts[i].port == 0)
+      {
+         g_UdpPorts[i].port = port;
+         bind = &g_UdpPorts[i];
+      }
+   if (!bind) return -ENOMEM;
+
+   while (bind->count == 0)
+   {
+      uint8_t interrupts_were_enabled = g_HalIoOperations->EnableInterrupts();
+      g_HalIoOperations->iowait();
+      if (!interrupts_were_enabled)
+      {
+         g_HalIoOperations->DisableInterrupts();
+      }
+   }
+
+   uint8_t interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_NetLock);
+   int idx = bind->queue[bind->tail];
+   bind->tail = (bind->tail + 1) % NET_SOCK_QUEUE;
+   bind->count--;
+   Spinlock_ReleaseIrqRestore(&g_NetLock, interrupts_were_enabled);
+
+   NetNbuf *nbuf = &g_NbufPool[idx];
+   uint32_t copied = nbuf->len;
+   if (copied > len) copied = len;
+   memcpy(buf, nbuf->data, copied);
+   if (src_ip) *src_ip = nbuf->src_ip;
+   if (src_port) *src_port = nbuf->src_port;
+
+   interrupts_were_enabled = Spinlock_AcquireIrqSave(&g_NetLock);
+   nbuf_release(idx);
+   Spinlock_ReleaseIrqRestore(&g_NetLock, interrupts_were_enabled);
+
+   return (int)copied;
+}
+
+void Net_Initialize(void)
+{
+   if (RTL8139_GetMac(g_NetMac) < 0) return; /* No NIC, no stack */
+
+   g_NbufPool = (NetNbuf *)kmalloc(NET_NBUF_COUNT * sizeof(NetNbuf));
+   if (!g_NbufPool)
+   {
+      logfmt(LOG_ERROR, "[NET] no memory for packet buffer pool\n");
+      return;
+   }
+   for (uint32_t i = 0; i < NET_NBUF_COUNT; i++)
+      g_NbufFree[i] = (uint16_t)(NET_NBUF_COUNT - 1 - i);
+   g_NbufFreeCount = NET_NBUF_COUNT;
+
+   /* Static configuration; defaults match QEMU's user-mode network. */
+   g_NetIp = parse_ipv4(CmdLine_GetString(CMDLINE_OPT_IP), 0x0A00020Fu);
+   g_NetGateway = parse_ipv4(CmdLine_GetString(CMDLINE_OPT_GW), 0x0A000202u);
+
+   Lockstat_Register(&g_NetLock, "net");
+   RTL8139_SetRxHandler(net_rx_tap);
+   g_NetUp = true;
+
+   logfmt(LOG_INFO, "[NET] udp/ip up, ip=%u.%u.%u.%u gw=%u.%u.%u.%u "
+                    "nbufs=%u\n",
+          (g_NetIp >> 24) & 0xFF, (g_NetIp >> 16) & 0xFF,
+          (g_NetIp >> 8) & 0xFF, g_NetIp & 0xFF, (g_NetGateway >> 24) & 0xFF,
+          (g_NetGateway >> 16) & 0xFF, (g_NetGateway >> 8) & 0xFF,
+          g_NetGateway & 0xFF, NET_NBUF_COUNT);
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef NET_H
+#define NET_H
+
+#include <stdint.h>
+
+/* Largest UDP payload per datagram: Ethernet MTU minus IP and UDP
+ * headers.  No fragmentation - telemetry datagrams are small. */
+#define NET_UDP_PAYLOAD_MAX 1472
+
+/* Bring the IPv4/UDP stack up over the RTL8139: allocate the packet
+ * buffer pool once, read ip=/gw= from the command line (QEMU slirp
+ * defaults when absent) and install the receive tap.  A no-op without
+ * a NIC. */
+void Net_Initialize(void);
+
+/* Send one UDP datagram.  The frame is built in place in the NIC's
+ * transmit descriptor buffer, so the payload is copied exactly once.
+ * Blocks briefly for ARP resolution on a cold cache; returns the
+ * payload length sent or a negative errno. */
+int Net_UdpSend(uint32_t dest_ip, uint16_t dest_port, uint16_t src_port,
+                const void *payload, uint32_t len);
+
+/* Receive one UDP datagram addressed to `port` (first call binds the
+ * port).  Blocks until a datagram arrives; the payload is copied once
+ * from the pooled buffer into `buf` (truncated to `len`).  Source
+ * address and port are returned through the out parameters when
+ * non-NULL.  Returns the payload length or a negative errno. */
+int Net_UdpRecv(uint16_t port, void *buf, uint32_t len, uint32_t *src_ip,
+                uint16_t *src_port);
+
+#endif
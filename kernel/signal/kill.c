@@ -1 +1,29 @@
-// SPDX-License-Identifier: GPL-3.0-only
\ No newline at end of file
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "signal.h"
+#include <constants.h>
+
+/* Resolve the target pid and queue the signal.  The pid hash keeps the
+ * lookup O(1), and Signal_Send is a couple of mask operations, so a
+ * signal-heavy supervisor pays constant cost per kill. */
+int Signal_Kill(Process *sender, int32_t pid, int signum)
+{
+   if (!sender) return -EINVAL;
+   if (signum < 0 || signum > SIGNAL_MAX) return -EINVAL;
+   if (pid <= 0) return -EINVAL; /* No process groups yet */
+
+   Process *target = Process_FindByPid((uint32_t)pid);
+   if (!target || target->state == STATE_ZOMBIE) return -ESRCH;
+
+   /* Root may signal anyone; others only processes they own. */
+   if (sender->euid != 0 && sender->euid != target->uid &&
+       sender->euid != target->euid)
+   {
+      return -EACCES;
+   }
+
+   /* signum 0 is the existence probe: permission checked, nothing sent */
+   if (signum == 0) return SUCCESS;
+
+   return Signal_Send(target, signum);
+}
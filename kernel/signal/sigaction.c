@@ -1 +1,26 @@
-// SPDX-License-Identifier: GPL-3.0-only
\ No newline at end of file
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "signal.h"
+#include <constants.h>
+
+/* Install a handler disposition for one signal.  SIGKILL and SIGSTOP
+ * keep their default action no matter what the caller asks for. */
+int Signal_SetAction(Process *proc, int signum, uintptr_t handler,
+                     uintptr_t *old_handler)
+{
+   if (!proc) return -EINVAL;
+   if (signum < 1 || signum > SIGNAL_MAX) return -EINVAL;
+   if ((SIGNAL_BIT(signum) & SIGNAL_UNBLOCKABLE) != 0) return -EINVAL;
+
+   if (old_handler) *old_handler = proc->signal_handlers[signum - 1];
+   proc->signal_handlers[signum - 1] = handler;
+
+   /* Ignoring a signal discards any pending instance of it. */
+   if (handler == SIG_IGN)
+   {
+      proc->signal_pending &= ~SIGNAL_BIT(signum);
+      Signal_UpdateDeliverable(proc);
+   }
+
+   return SUCCESS;
+}
@@ -1 +1,118 @@
-// SPDX-License-Identifier: GPL-3.0-only
\ No newline at end of file
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "signal.h"
+#include <constants.h>
+#include <hal/scheduler.h>
+#include <std/stdio.h>
+#include <sys/sys.h>
+
+/* Signals whose default action is to ignore rather than terminate. */
+#define SIGNAL_DEFAULT_IGNORE (SIGNAL_BIT(SIGCHLD) | SIGNAL_BIT(SIGCONT))
+
+void Signal_UpdateDeliverable(Process *proc)
+{
+   if (!proc) return;
+
+   proc->signal_deliverable =
+       (proc->signal_pending & ~proc->signal_mask) != 0;
+}
+
+int Signal_Send(Process *proc, int signum)
+{
+   if (!proc) return -EINVAL;
+   if (signum < 1 || signum > SIGNAL_MAX) return -EINVAL;
+
+   uint32_t bit = SIGNAL_BIT(signum);
+
+   /* Drop signals that could never be observed: an explicitly ignored
+    * signal, or a default-ignored one with no handler installed. */
+   uintptr_t handler = proc->signal_handlers[signum - 1];
+   if (handler == SIG_IGN && (bit & SIGNAL_UNBLOCKABLE) == 0) return SUCCESS;
+   if (handler == SIG_DFL && (bit & SIGNAL_DEFAULT_IGNORE) != 0)
+      return SUCCESS;
+
+   proc->signal_pending |= bit;
+   Signal_UpdateDeliverable(proc);
+
+   /* Kick a target sleeping in the kernel so it reaches its syscall
+    * return path (and therefore the deliverable check) promptly. */
+   if (proc->signal_deliverable && proc->state == STATE_BLOCKED)
+   {
+      Process_Unblock(proc);
+   }
+
+   return SUCCESS;
+}
+
+void Signal_DeliverPending(Process *proc, Registers *regs)
+{
+   if (!proc) return;
+
+   uint32_t deliverable = proc->signal_pending & ~proc->signal_mask;
+   bool caught = false;
+
+   while (deliverable != 0)
+   {
+      /* Lowest pending signal number first - find-first-set dispatch */
+      int signum = __builtin_ctz(deliverable) + 1;
+      uint32_t bit = SIGNAL_BIT(signum);
+
+      deliverable &= ~bit;
+
+      uintptr_t handler = proc->signal_handlers[signum - 1];
+      if (handler == SIG_IGN)
+      {
+         proc->signal_pending &= ~bit;
+         continue;
+      }
+
+      /* Caught signals are left pending here; the arch frame builder
+       * below consumes the whole batch in one pass. */
+      if (handler != SIG_DFL)
+      {
+         caught = true;
+         continue;
+      }
+
+      /* Default-ignored signals were dropped at send time, which
+       * leaves terminate as the only remaining default action - and a
+       * fatal signal overrides any handlers queued beside it. */
+      proc->signal_pending &= ~bit;
+      logfmt(LOG_INFO, "[SIGNAL] pid=%u signum=%d action=terminate\n",
+             proc->pid, signum);
+      Signal_UpdateDeliverable(proc);
+      Process_Exit(proc, 128 + signum);
+
+      /* Never return to user mode as a zombie. */
+      if (proc == Process_GetCurrent() && g_HalSchedulerOperations &&
+          g_HalSchedulerOperations->ContextSwitch)
+      {
+         g_HalSchedulerOperations->ContextSwitch();
+      }
+      return;
+   }
+
+   /* One frame-building pass covers every caught signal: the handlers
+    * are chained on the user stack so the batch costs a single kernel
+    * exit (see arch sigframe.c).  Without a trap frame (kernel-internal
+    * caller) the signals simply stay pending for the next return. */
+   if (caught && regs && g_HalSignalOperations &&
+       g_HalSignalOperations->SetupFrames)
+   {
+      if (g_HalSignalOperations->SetupFrames(proc, regs) < 0)
+      {
+         /* Unwritable user stack: nowhere to run a handler. */
+         logfmt(LOG_ERROR,
+                "[SIGNAL] pid=%u bad user stack, terminating\n", proc->pid);
+         Process_Exit(proc, 128 + SIGSEGV);
+         if (proc == Process_GetCurrent() && g_HalSchedulerOperations &&
+             g_HalSchedulerOperations->ContextSwitch)
+         {
+            g_HalSchedulerOperations->ContextSwitch();
+         }
+         return;
+      }
+   }
+
+   Signal_UpdateDeliverable(proc);
+}
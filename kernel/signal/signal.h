@@ -3,4 +3,67 @@
 #ifndef SIGNAL_H
 #define SIGNAL_H
 
-#endif
\ No newline at end of file
+#include <cpu/process.h>
+#include <hal/signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Signal numbers (classic UNIX numbering, 1-based) */
+#define SIGHUP 1
+#define SIGINT 2
+#define SIGQUIT 3
+#define SIGILL 4
+#define SIGABRT 6
+#define SIGFPE 8
+#define SIGKILL 9
+#define SIGUSR1 10
+#define SIGSEGV 11
+#define SIGUSR2 12
+#define SIGPIPE 13
+#define SIGALRM 14
+#define SIGTERM 15
+#define SIGCHLD 17
+#define SIGCONT 18
+#define SIGSTOP 19
+
+#define SIGNAL_MAX 32
+
+/* Pending and blocked sets are plain 32-bit masks: signal n occupies
+ * bit n-1, so membership tests, send and dispatch are single mask
+ * operations with find-first-set picking the lowest pending number. */
+#define SIGNAL_BIT(n) (1u << ((n) - 1))
+
+/* SIGKILL and SIGSTOP can be neither blocked nor ignored. */
+#define SIGNAL_UNBLOCKABLE (SIGNAL_BIT(SIGKILL) | SIGNAL_BIT(SIGSTOP))
+
+/* Handler dispositions stored in Process.signal_handlers */
+#define SIG_DFL ((uintptr_t)0)
+#define SIG_IGN ((uintptr_t)1)
+
+/* sigprocmask operations */
+#define SIG_BLOCK 0
+#define SIG_UNBLOCK 1
+#define SIG_SETMASK 2
+
+/* Queue a signal for a process: sets the pending bit, refreshes the
+ * fast-path flag and wakes the target if it is blocked in the kernel. */
+int Signal_Send(Process *proc, int signum);
+
+/* Act on every deliverable pending signal in one pass.  Called from
+ * the syscall return path when Process.signal_deliverable is set; the
+ * flag makes the signal-free return cost a single test.  regs is the
+ * trap frame about to be restored - caught signals get user frames
+ * stacked onto it so the whole batch runs off a single kernel exit. */
+void Signal_DeliverPending(Process *proc, Registers *regs);
+
+/* Recompute Process.signal_deliverable after a mask or pending-set
+ * change.  Cheap enough to call from every mutation site. */
+void Signal_UpdateDeliverable(Process *proc);
+
+/* Syscall back-ends (kill.c, sigaction.c, sigprocmask.c) */
+int Signal_Kill(Process *sender, int32_t pid, int signum);
+int Signal_SetAction(Process *proc, int signum, uintptr_t handler,
+                     uintptr_t *old_handler);
+int Signal_SetMask(Process *proc, int how, uint32_t set, uint32_t *old_set);
+
+#endif
@@ -1 +1,34 @@
-// SPDX-License-Identifier: GPL-3.0-only
\ No newline at end of file
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "signal.h"
+#include <constants.h>
+
+/* Adjust the blocked-signal mask.  SIGKILL and SIGSTOP are stripped
+ * from every new mask, and the fast-path flag is refreshed so signals
+ * unblocked here get picked up on the next return to user mode. */
+int Signal_SetMask(Process *proc, int how, uint32_t set, uint32_t *old_set)
+{
+   if (!proc) return -EINVAL;
+
+   if (old_set) *old_set = proc->signal_mask;
+
+   switch (how)
+   {
+   case SIG_BLOCK:
+      proc->signal_mask |= set;
+      break;
+   case SIG_UNBLOCK:
+      proc->signal_mask &= ~set;
+      break;
+   case SIG_SETMASK:
+      proc->signal_mask = set;
+      break;
+   default:
+      return -EINVAL;
+   }
+
+   proc->signal_mask &= ~SIGNAL_UNBLOCKABLE;
+   Signal_UpdateDeliverable(proc);
+
+   return SUCCESS;
+}
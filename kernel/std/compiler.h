@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+/* Code-layout attributes.
+ *
+ * KCOLD places a function in .text.unlikely and optimizes it for size;
+ * linker.ld gathers those sections into one block at the front of
+ * .text, away from the hot loops, so initialization code and error
+ * reporting stop sharing icache lines with the paths that run every
+ * tick.  KHOT pins a function into the .text.hot group that leads the
+ * hot region; use it sparingly — the profiler-driven ordering
+ * (scripts/profile_symbolize.py --layout) covers everything between
+ * the two extremes with measured data instead of guesses.
+ */
+
+#define KHOT __attribute__((hot))
+#define KCOLD __attribute__((cold))
@@ -3,5 +3,84 @@
 #pragma once
 #include <stdint.h>
 
-int islower(char chr);
-char toupper(char chr);
+/*
+ * Table-driven character classification: one load and one mask per
+ * test, instead of the comparison chains that used to back path
+ * normalization, cmdline tokenizing and FAT 8.3 case folding.  Both
+ * tables live in ctype.c; indexing goes through an unsigned char so
+ * negative char values cannot reach outside the table.
+ */
+
+#define CT_UPPER 0x01
+#define CT_LOWER 0x02
+#define CT_DIGIT 0x04
+#define CT_SPACE 0x08 /* ' ', \t, \n, \v, \f, \r */
+#define CT_XDIGIT 0x10
+#define CT_PUNCT 0x20
+#define CT_CTRL 0x40
+
+extern const uint8_t g_CtypeClass[256];
+extern const uint8_t g_CtypeUpper[256];
+
+static inline int isupper(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & CT_UPPER;
+}
+
+static inline int islower(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & CT_LOWER;
+}
+
+static inline int isalpha(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & (CT_UPPER | CT_LOWER);
+}
+
+static inline int isdigit(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & CT_DIGIT;
+}
+
+static inline int isxdigit(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & CT_XDIGIT;
+}
+
+static inline int isalnum(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & (CT_UPPER | CT_LOWER | CT_DIGIT);
+}
+
+static inline int isspace(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & CT_SPACE;
+}
+
+static inline int ispunct(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & CT_PUNCT;
+}
+
+static inline int iscntrl(char chr)
+{
+   return g_CtypeClass[(uint8_t)chr] & CT_CTRL;
+}
+
+static inline int isprint(char chr)
+{
+   return chr == ' ' || (g_CtypeClass[(uint8_t)chr] &
+                         (CT_UPPER | CT_LOWER | CT_DIGIT | CT_PUNCT));
+}
+
+/* Case folding through the combined table: the hot FAT directory scans
+   fold every name byte, so this must stay a single load. */
+static inline char toupper(char chr)
+{
+   return (char)g_CtypeUpper[(uint8_t)chr];
+}
+
+static inline char tolower(char chr)
+{
+   return isupper(chr) ? (char)(chr - 'A' + 'a') : chr;
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "klog.h"
+#include <mem/mm_kernel.h>
+#include <std/minmax.h>
+#include <std/stdio.h>
+
+/* Ring size must be a power of two so sequence numbers index with a
+ * mask; 16 KiB keeps a few hundred boot lines around for /dev/kmsg. */
+#define KLOG_BUF_SIZE 16384u
+#define KLOG_MASK (KLOG_BUF_SIZE - 1)
+
+static char klog_buf[KLOG_BUF_SIZE];
+static uint32_t klog_head = 0;    /* Sequence number of the next write */
+static uint32_t klog_drained = 0; /* Everything below this hit the console */
+static int klog_buffered = 0;
+
+void KLOG_Write(const char *data, uint32_t len)
+{
+   if (!data || len == 0) return;
+
+   /* A write larger than the ring only keeps its tail. */
+   if (len > KLOG_BUF_SIZE)
+   {
+      data += len - KLOG_BUF_SIZE;
+      len = KLOG_BUF_SIZE;
+   }
+
+   uint32_t pos = klog_head & KLOG_MASK;
+   uint32_t first = min(len, KLOG_BUF_SIZE - pos);
+   memcpy(klog_buf + pos, data, first);
+   if (first < len) memcpy(klog_buf, data + first, len - first);
+   klog_head += len;
+
+   /* Anything the write just overran is lost to the console too. */
+   if (klog_head - klog_drained > KLOG_BUF_SIZE)
+      klog_drained = klog_head - KLOG_BUF_SIZE;
+
+   if (!klog_buffered) KLOG_Drain();
+}
+
+void KLOG_EnableBuffering(void) { klog_buffered = 1; }
+
+void KLOG_Drain(void)
+{
+   /* Snapshot the head so a log written from an interrupt while we are
+    * draining is picked up by the next drain instead of looping here. */
+   uint32_t head = klog_head;
+   while (klog_drained != head)
+   {
+      putc(klog_buf[klog_drained & KLOG_MASK]);
+      klog_drained++;
+   }
+}
+
+uint32_t KLOG_ReadAt(uint32_t seq, uint32_t size, void *buffer)
+{
+   if (!buffer || size == 0) return 0;
+
+   uint32_t oldest =
+       (klog_head > KLOG_BUF_SIZE) ? klog_head - KLOG_BUF_SIZE : 0;
+   if (seq < oldest) seq = oldest; /* Overwritten; skip the lost bytes */
+   if (seq >= klog_head) return 0;
+
+   uint32_t len = min(size, klog_head - seq);
+   uint32_t pos = seq & KLOG_MASK;
+   uint32_t first = min(len, KLOG_BUF_SIZE - pos);
+   memcpy(buffer, klog_buf + pos, first);
+   if (first < len) memcpy((char *)buffer + first, klog_buf, len - first);
+
+   return len;
+}
+
+uint32_t KLOG_Sequence(void) { return klog_head; }
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Kernel log ring buffer.
+ *
+ * logfmt appends formatted lines here instead of pushing every character
+ * through the console synchronously; the console is caught up from the
+ * idle paths (and immediately on LOG_ERROR/LOG_FATAL), so a burst of
+ * LOG_INFO lines in a hot path costs a memcpy, not a screen update.
+ *
+ * Positions are byte sequence numbers that only ever grow: the head is
+ * the total number of bytes ever logged, and a reader holding an old
+ * sequence number is transparently advanced past anything the ring has
+ * already overwritten.  /dev/kmsg exposes the ring through these
+ * sequence numbers as its file offset. */
+
+/* Append bytes to the ring, dropping the oldest data when full.  Until
+ * KLOG_EnableBuffering is called the data is also drained to the
+ * console immediately, preserving early-boot output ordering. */
+void KLOG_Write(const char *data, uint32_t len);
+
+/* Switch from write-through to deferred draining.  Call once a drain
+ * path (the idle task) is guaranteed to run. */
+void KLOG_EnableBuffering(void);
+
+/* Push everything not yet shown to the console.  Cheap when there is
+ * nothing pending; called from the idle paths and on error logs. */
+void KLOG_Drain(void);
+
+/* Copy up to size bytes starting at byte sequence number seq into
+ * buffer.  Returns the number of bytes copied (0 at the head). */
+uint32_t KLOG_ReadAt(uint32_t seq, uint32_t size, void *buffer);
+
+/* Current head sequence number (total bytes ever logged). */
+uint32_t KLOG_Sequence(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Intrusive containers shared by the kernel's O(1) lookup structures.
+ *
+ * The node lives inside the element (no allocation on insert/remove),
+ * and KLIST_ENTRY / KHASH_ENTRY recover the element from its node.
+ * Subsystems that outgrow a linear scan (scheduler slots, devfs nodes,
+ * mount table, module registry) should build on these instead of
+ * growing another bespoke link structure.
+ */
+
+/* -------------------------------------------------------------------------
+ * Doubly-linked list with a sentinel head: empty means head points at
+ * itself, so push/remove never branch on NULL.
+ * ---------------------------------------------------------------------- */
+
+typedef struct KListNode
+{
+   struct KListNode *prev;
+   struct KListNode *next;
+} KListNode;
+
+static inline void KList_Init(KListNode *head)
+{
+   head->prev = head;
+   head->next = head;
+}
+
+static inline int KList_IsEmpty(const KListNode *head)
+{
+   return head->next == head;
+}
+
+static inline void klist_insert_between(KListNode *node, KListNode *prev,
+                                        KListNode *next)
+{
+   node->prev = prev;
+   node->next = next;
+   prev->next = node;
+   next->prev = node;
+}
+
+static inline void KList_PushFront(KListNode *head, KListNode *node)
+{
+   klist_insert_between(node, head, head->next);
+}
+
+static inline void KList_PushBack(KListNode *head, KListNode *node)
+{
+   klist_insert_between(node, head->prev, head);
+}
+
+/* Unlink a node; the node is reinitialised so a double remove is a
+   harmless no-op rather than list corruption. */
+static inline void KList_Remove(KListNode *node)
+{
+   node->prev->next = node->next;
+   node->next->prev = node->prev;
+   KList_Init(node);
+}
+
+static inline KListNode *KList_PopFront(KListNode *head)
+{
+   if (KList_IsEmpty(head)) return NULL;
+   KListNode *node = head->next;
+   KList_Remove(node);
+   return node;
+}
+
+/* Recover the element holding `node` as its `member` field. */
+#define KLIST_ENTRY(node, type, member)                                        \
+   ((type *)((uint8_t *)(node)-offsetof(type, member)))
+
+#define KLIST_FOR_EACH(pos, head)                                              \
+   for ((pos) = (head)->next; (pos) != (head); (pos) = (pos)->next)
+
+/* Safe against removal of `pos` inside the body. */
+#define KLIST_FOR_EACH_SAFE(pos, tmp, head)                                    \
+   for ((pos) = (head)->next, (tmp) = (pos)->next; (pos) != (head);            \
+        (pos) = (tmp), (tmp) = (pos)->next)
+
+/* -------------------------------------------------------------------------
+ * Chained hash table.  The caller owns the bucket array (a plain
+ * KHashNode* array sized to a power of two) and the hash function;
+ * chains are singly linked since removal walks the bucket anyway.
+ * ---------------------------------------------------------------------- */
+
+typedef struct KHashNode
+{
+   struct KHashNode *next;
+} KHashNode;
+
+static inline void KHash_Insert(KHashNode **bucket, KHashNode *node)
+{
+   node->next = *bucket;
+   *bucket = node;
+}
+
+static inline void KHash_Remove(KHashNode **bucket, KHashNode *node)
+{
+   KHashNode **link = bucket;
+   while (*link && *link != node) link = &(*link)->next;
+   if (*link)
+   {
+      *link = node->next;
+      node->next = NULL;
+   }
+}
+
+#define KHASH_ENTRY(node, type, member)                                        \
+   ((type *)((uint8_t *)(node)-offsetof(type, member)))
+
+#define KHASH_FOR_EACH(pos, bucket)                                            \
+   for ((pos) = (bucket); (pos); (pos) = (pos)->next)
+
+/* Fibonacci mix for integer keys; callers mask with (buckets - 1). */
+static inline uint32_t KHash_U32(uint32_t key) { return key * 2654435761u; }
+
+/* FNV-1a for short strings (device and module names). */
+static inline uint32_t KHash_String(const char *s)
+{
+   uint32_t h = 2166136261u;
+   while (*s)
+   {
+      h ^= (uint8_t)*s++;
+      h *= 16777619u;
+   }
+   return h;
+}
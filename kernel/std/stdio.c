@@ -4,21 +4,19 @@
 #include <hal/io.h>
 
 #include <mem/mm_kernel.h>
+#include <std/klog.h>
 #include <stdarg.h>
 #include <stdbool.h>
 
 #include <drivers/tty/tty.h>
 
-/* Simple getchar that reads from the active TTY input stream. */
+/* Move the console cursor.  Routed through the TTY so the backend can
+ * batch the CRTC programming with its next present instead of poking
+ * the registers directly (which also ignored the scroll window). */
 void setcursor(int x, int y)
 {
-   if (x < 0) x = 0;
-   if (y < 0) y = 0;
-   uint16_t pos = (uint16_t)(y * 80 + x);
-   g_HalIoOperations->outb(0x3D4, 0x0F);
-   g_HalIoOperations->outb(0x3D5, (uint8_t)(pos & 0xFF));
-   g_HalIoOperations->outb(0x3D4, 0x0E);
-   g_HalIoOperations->outb(0x3D5, (uint8_t)((pos >> 8) & 0xFF));
+   TTY_Device *tty = TTY_GetDevice();
+   if (tty) TTY_SetCursor(tty, x, y);
 }
 
 int getchar(void)
@@ -37,13 +35,89 @@ void putc(char c)
    if (tty) TTY_WriteChar(tty, c);
 }
 
+/* Where formatted output goes: the console for printf, the log line
+ * buffer while logfmt_impl is formatting.  Swapped around the emitter
+ * call so the printf machinery below needs no duplication. */
+static void log_char_sink(char c);
+static void (*g_CharSink)(char) = putc;
+
+/* One logfmt line is staged here and pushed to the klog ring in a
+ * single KLOG_Write, so logging in a hot path costs a memcpy rather
+ * than a synchronous screen update per character. */
+static char g_LogLine[512];
+static uint32_t g_LogLineLen = 0;
+
+static void log_char_sink(char c)
+{
+   g_LogLine[g_LogLineLen++] = c;
+   if (g_LogLineLen == sizeof(g_LogLine))
+   {
+      KLOG_Write(g_LogLine, g_LogLineLen);
+      g_LogLineLen = 0;
+   }
+}
+
+/* Bounded in-memory sink for vsnprintf: writes land in the caller's
+ * buffer, overflow is counted but discarded so the return value still
+ * reports the full formatted length. */
+static char *g_BufSinkPtr;
+static size_t g_BufSinkCap;   /* writable bytes, NUL excluded */
+static size_t g_BufSinkTotal; /* chars that would have been written */
+
+static void buf_char_sink(char c)
+{
+   if (g_BufSinkTotal < g_BufSinkCap) g_BufSinkPtr[g_BufSinkTotal] = c;
+   g_BufSinkTotal++;
+}
+
 void puts(const char *str)
 {
-   for (int i = 0; str[i]; i++) putc(str[i]);
+   for (int i = 0; str[i]; i++) g_CharSink(str[i]);
 }
 
 const char g_HexChars[] = "0123456789abcdef";
 
+/* All two-digit pairs 00..99; one lookup yields two decimal digits, so
+ * the base-10 loop below does one division by 100 per pair instead of a
+ * divide and a modulo per digit. */
+static const char g_Digits100[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Emit the decimal digits of a 32-bit value, least significant first.
+ * The divisor is a constant, so the compiler strength-reduces the
+ * divisions to reciprocal multiplies — no libgcc call on i686. */
+static int format_dec32(char *buffer, uint32_t n)
+{
+   int pos = 0;
+
+   while (n >= 100)
+   {
+      uint32_t pair = n % 100;
+      n /= 100;
+      buffer[pos++] = g_Digits100[pair * 2 + 1];
+      buffer[pos++] = g_Digits100[pair * 2];
+   }
+   if (n >= 10)
+   {
+      buffer[pos++] = g_Digits100[n * 2 + 1];
+      buffer[pos++] = g_Digits100[n * 2];
+   }
+   else
+   {
+      buffer[pos++] = (char)('0' + n);
+   }
+   return pos;
+}
+
 void printf_unsigned(unsigned long long number, int radix, int width,
                      bool zero_pad)
 {
@@ -54,12 +128,57 @@ void printf_unsigned(unsigned long long number, int radix, int width,
    if (width > 31) width = 31;
 
    // convert number to ASCII
-   do
+   if (radix == 10)
    {
-      unsigned long long rem = number % radix;
-      number /= radix;
-      buffer[pos++] = g_HexChars[rem];
-   } while (number > 0 && pos < 31);
+      /* Peel 64-bit values down nine zero-padded digits at a time, so
+       * a full-range number costs two libgcc divisions instead of
+       * twenty; everything that fits in 32 bits avoids libgcc
+       * entirely. */
+      while (number > 0xFFFFFFFFull)
+      {
+         uint32_t low = (uint32_t)(number % 1000000000ull);
+         number /= 1000000000ull;
+
+         int chunk = format_dec32(buffer + pos, low);
+         pos += chunk;
+         while (chunk < 9)
+         {
+            buffer[pos++] = '0';
+            chunk++;
+         }
+      }
+      pos += format_dec32(buffer + pos, (uint32_t)number);
+   }
+   else if (radix == 16)
+   {
+      /* Shift/mask into the hex table — no division at all. */
+      uint32_t low = (uint32_t)number;
+      if (number <= 0xFFFFFFFFull)
+      {
+         do
+         {
+            buffer[pos++] = g_HexChars[low & 0xF];
+            low >>= 4;
+         } while (low);
+      }
+      else
+      {
+         do
+         {
+            buffer[pos++] = g_HexChars[(uint32_t)number & 0xF];
+            number >>= 4;
+         } while (number);
+      }
+   }
+   else
+   {
+      do
+      {
+         unsigned long long rem = number % radix;
+         number /= radix;
+         buffer[pos++] = g_HexChars[rem];
+      } while (number > 0 && pos < 31);
+   }
 
    // pad with zeros or spaces if needed
    while (pos < width)
@@ -68,14 +187,14 @@ void printf_unsigned(unsigned long long number, int radix, int width,
    }
 
    // print number in reverse order
-   while (--pos >= 0) putc(buffer[pos]);
+   while (--pos >= 0) g_CharSink(buffer[pos]);
 }
 
 void printf_signed(long long number, int radix, int width, bool zero_pad)
 {
    if (number < 0)
    {
-      putc('-');
+      g_CharSink('-');
       printf_unsigned(-number, radix, (width > 0 ? width - 1 : 0), zero_pad);
    }
    else
@@ -112,11 +231,43 @@ void printf(const char *fmt, ...)
 {
    va_list args;
    va_start(args, fmt);
-   printf_vimpl(fmt, args);
+   vprintf(fmt, args);
    va_end(args);
 }
 
-void vprintf(const char *fmt, va_list args) { printf_vimpl(fmt, args); }
+/* Console printf formats the whole string into a line buffer first and
+ * hands it to the TTY as one batched write, so the display backend
+ * presents once per call instead of once per character. */
+static char g_PrintLine[512];
+
+void vprintf(const char *fmt, va_list args)
+{
+   /* While a sink redirect is active (logfmt staging a line, vsnprintf
+      filling a caller buffer) keep emitting through it directly. */
+   if (g_CharSink != putc)
+   {
+      printf_vimpl(fmt, args);
+      return;
+   }
+
+   va_list copy;
+   va_copy(copy, args);
+   int len = vsnprintf(g_PrintLine, sizeof(g_PrintLine), fmt, copy);
+   va_end(copy);
+
+   if (len >= (int)sizeof(g_PrintLine))
+   {
+      /* Oversized output: fall back to unbuffered emission rather than
+         truncating. */
+      printf_vimpl(fmt, args);
+      return;
+   }
+
+   for (int i = 0; i < len; i++) g_HalIoOperations->outb(0xe9, g_PrintLine[i]);
+
+   TTY_Device *tty = TTY_GetDevice();
+   if (tty) TTY_WriteBuffer(tty, g_PrintLine, (size_t)len);
+}
 
 static void printf_vimpl(const char *fmt, va_list args)
 {
@@ -141,7 +292,7 @@ static void printf_vimpl(const char *fmt, va_list args)
             zero_pad = false;
             break;
          default:
-            putc(*fmt);
+            g_CharSink(*fmt);
             break;
          }
          break;
@@ -201,15 +352,18 @@ static void printf_vimpl(const char *fmt, va_list args)
          switch (*fmt)
          {
          case 'c':
-            putc((char)va_arg(args, int));
+            g_CharSink((char)va_arg(args, int));
             break;
 
          case 's':
-            puts(va_arg(args, const char *));
+         {
+            const char *s = va_arg(args, const char *);
+            puts(s ? s : "(null)");
             break;
+         }
 
          case '%':
-            putc('%');
+            g_CharSink('%');
             break;
 
          case 'd':
@@ -307,15 +461,76 @@ static void printf_vimpl(const char *fmt, va_list args)
 
 void LOG_DisableInfo(void) { g_LogEmitters[LOG_INFO] = log_emit_info_disabled; }
 
+/* Millisecond tick counter; declared here rather than pulling the arch
+ * timer header into std. */
+extern volatile uint64_t system_ticks;
+
+/* Bucket refill: up to LOGRATE_BURST lines per callsite per window. */
+#define LOGRATE_BURST 10u
+#define LOGRATE_WINDOW_MS 1000u
+
+int logfmt_ratecheck(LogRateState *state, LogType logtype)
+{
+   if (logtype == LOG_FATAL) return 1;
+
+   uint32_t now = (uint32_t)system_ticks;
+
+   if (!state->primed)
+   {
+      state->primed = 1;
+      state->tokens = LOGRATE_BURST;
+      state->window_start = now;
+   }
+
+   if (now - state->window_start >= LOGRATE_WINDOW_MS)
+   {
+      state->window_start = now;
+      state->tokens = LOGRATE_BURST;
+      if (state->suppressed)
+      {
+         logfmt_impl(LOG_WARNING,
+                     "[LOG] rate limit: %u messages suppressed from this "
+                     "callsite\n",
+                     state->suppressed);
+         state->suppressed = 0;
+      }
+   }
+
+   if (state->tokens == 0)
+   {
+      state->suppressed++;
+      return 0;
+   }
+
+   state->tokens--;
+   return 1;
+}
+
 void logfmt_impl(LogType logtype, const char *fmt, ...)
 {
    uint32_t emitter_index = (uint32_t)logtype;
    if (emitter_index > LOG_FATAL) emitter_index = 4;
 
+   /* Format into the line buffer instead of the console, then hand the
+    * whole line to the klog ring at once. */
+   g_LogLineLen = 0;
+   g_CharSink = log_char_sink;
+
    va_list args;
    va_start(args, fmt);
    g_LogEmitters[emitter_index](fmt, args);
    va_end(args);
+
+   g_CharSink = putc;
+   if (g_LogLineLen > 0)
+   {
+      KLOG_Write(g_LogLine, g_LogLineLen);
+      g_LogLineLen = 0;
+   }
+
+   /* Problems should reach the screen now, not at the next idle pass;
+    * draining is FIFO so the preceding backlog comes out with them. */
+   if (logtype == LOG_ERROR || logtype == LOG_FATAL) KLOG_Drain();
 }
 
 static void log_emit_info(const char *fmt, va_list args)
@@ -380,139 +595,26 @@ int snprintf(char *buffer, size_t buf_size, const char *format, ...)
    return result;
 }
 
+/* Formats straight into the caller's buffer by pointing the char sink at
+ * it and running the same emitter printf uses, so both share one set of
+ * format specifiers (width, zero-pad and h/l/ll included).  Returns the
+ * full formatted length even when the buffer was too small. */
 int vsnprintf(char *buffer, size_t buf_size, const char *format, va_list ap)
 {
-   size_t out_idx = 0;    /* next write position in buffer (0..buf_size-1) */
-   size_t would_have = 0; /* total chars that would have been written */
-
-/* helper to emit a single char */
-#define EMIT_CH(c)                                                             \
-   do                                                                          \
-   {                                                                           \
-      if (out_idx + 1 < buf_size) buffer[out_idx++] = (c);                     \
-      would_have++;                                                            \
-   } while (0)
-
-/* helper to emit a whole string */
-#define EMIT_STR(s)                                                            \
-   do                                                                          \
-   {                                                                           \
-      const char *_p = (s);                                                    \
-      while (*_p)                                                              \
-      {                                                                        \
-         EMIT_CH(*_p);                                                         \
-         _p++;                                                                 \
-      }                                                                        \
-   } while (0)
-
-   const char *p = format;
-   while (*p)
-   {
-      if (*p != '%')
-      {
-         EMIT_CH(*p);
-         p++;
-         continue;
-      }
-      /* handle % */
-      p++;
-      if (*p == '%')
-      {
-         EMIT_CH('%');
-         p++;
-         continue;
-      }
+   void (*saved_sink)(char) = g_CharSink;
 
-      /* No length modifiers supported here; keep it small for kernel */
-      char spec = *p++;
-      if (!spec) break;
-      if (spec == 'c')
-      {
-         int ch = va_arg(ap, int);
-         EMIT_CH((char)ch);
-      }
-      else if (spec == 's')
-      {
-         const char *s = va_arg(ap, const char *);
-         if (!s) s = "(null)";
-         EMIT_STR(s);
-      }
-      else if (spec == 'd' || spec == 'i')
-      {
-         long long val = va_arg(ap, int);
-         if (val < 0)
-         {
-            EMIT_CH('-');
-            val = -val;
-         }
-         /* unsigned print */
-         char tmp[32];
-         int t = 0;
-         if (val == 0) tmp[t++] = '0';
-         while (val > 0 && t < (int)sizeof(tmp))
-         {
-            tmp[t++] = '0' + (val % 10);
-            val /= 10;
-         }
-         while (t--) EMIT_CH(tmp[t]);
-      }
-      else if (spec == 'u')
-      {
-         unsigned long long val = va_arg(ap, unsigned int);
-         char tmp[32];
-         int t = 0;
-         if (val == 0) tmp[t++] = '0';
-         while (val > 0 && t < (int)sizeof(tmp))
-         {
-            tmp[t++] = '0' + (val % 10);
-            val /= 10;
-         }
-         while (t--) EMIT_CH(tmp[t]);
-      }
-      else if (spec == 'x' || spec == 'X' || spec == 'p')
-      {
-         unsigned long long val = va_arg(ap, unsigned long long);
-         char tmp[32];
-         int t = 0;
-         const char *hex =
-             (spec == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
-         if (val == 0) tmp[t++] = '0';
-         while (val > 0 && t < (int)sizeof(tmp))
-         {
-            tmp[t++] = hex[val & 0xF];
-            val >>= 4;
-         }
-         while (t--) EMIT_CH(tmp[t]);
-      }
-      else if (spec == 'o')
-      {
-         unsigned long long val = va_arg(ap, unsigned int);
-         char tmp[32];
-         int t = 0;
-         if (val == 0) tmp[t++] = '0';
-         while (val > 0 && t < (int)sizeof(tmp))
-         {
-            tmp[t++] = '0' + (val & 7);
-            val >>= 3;
-         }
-         while (t--) EMIT_CH(tmp[t]);
-      }
-      else
-      {
-         /* unsupported specifier: emit it literally */
-         EMIT_CH('%');
-         EMIT_CH(spec);
-      }
-   }
+   g_BufSinkPtr = buffer;
+   g_BufSinkCap = (buf_size > 0) ? buf_size - 1 : 0;
+   g_BufSinkTotal = 0;
+   g_CharSink = buf_char_sink;
+
+   printf_vimpl(format, ap);
+
+   g_CharSink = saved_sink;
 
-   /* NUL-terminate if there's space */
    if (buf_size > 0)
-   {
-      if (out_idx < buf_size)
-         buffer[out_idx] = '\0';
-      else
-         buffer[buf_size - 1] = '\0';
-   }
+      buffer[(g_BufSinkTotal < g_BufSinkCap) ? g_BufSinkTotal : g_BufSinkCap] =
+          '\0';
 
-   return (int)would_have;
+   return (int)g_BufSinkTotal;
 }
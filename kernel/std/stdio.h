@@ -25,8 +25,29 @@ extern "C"
    void vprintf(const char *fmt, va_list args);
    void logfmt_impl(LogType logtype, const char *fmt, ...);
    void LOG_DisableInfo(void);
+
+   /* Per-callsite token bucket: each logfmt expansion carries its own
+    * static state, so a driver looping on one warning burns only its
+    * own bucket while every other message keeps flowing.  When a
+    * starved site gets tokens back, a summary line reports how many
+    * emissions were swallowed.  LOG_FATAL is never limited. */
+   typedef struct
+   {
+      uint8_t primed;        /* Bucket filled on first use */
+      uint32_t tokens;       /* Emissions left in this window */
+      uint32_t window_start; /* Tick when the window opened */
+      uint32_t suppressed;   /* Swallowed since the last summary */
+   } LogRateState;
+
+   int logfmt_ratecheck(LogRateState *state, LogType logtype);
 /* logfmt expands to printf with prefix and ANSI colors, reset at end */
-#define logfmt(logtype, fmt, ...) logfmt_impl((logtype), (fmt), ##__VA_ARGS__)
+#define logfmt(logtype, fmt, ...)                                              \
+   do                                                                          \
+   {                                                                           \
+      static LogRateState s_LogRateState;                                      \
+      if (logfmt_ratecheck(&s_LogRateState, (logtype)))                        \
+         logfmt_impl((logtype), (fmt), ##__VA_ARGS__);                         \
+   } while (0)
    void print_buffer(const char *msg, const void *buffer, uint32_t count);
    void setcursor(int x, int y);
    /* Read one byte from TTY input stream. Returns -1 if no data. */
@@ -4,6 +4,16 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/* Word-at-a-time scanning: (w - 0x01010101) & ~w & 0x80808080 is nonzero
+ * exactly when a 32-bit word w contains a zero byte.  The hot routines
+ * below walk bytes up to a 4-byte boundary and then step a word at a
+ * time; short strings never reach the word loop, so they cost the same
+ * as the plain byte versions. */
+#define WORD_ONES 0x01010101u
+#define WORD_HIGHS 0x80808080u
+#define WORD_HAS_ZERO(w) ((((w) - WORD_ONES) & ~(w)) & WORD_HIGHS)
+#define WORD_ALIGNED(p) (((uintptr_t)(p) & 3u) == 0)
+
 const char *strchr(const char *str, char chr)
 {
    if (str == NULL) return NULL;
@@ -30,6 +40,25 @@ char *strcpy(char *dst, const char *src)
       return dst;
    }
 
+   /* Word copies need src and dst at the same misalignment; path and
+      symbol strings usually are.  Otherwise fall through byte-wise. */
+   if (((uintptr_t)dst & 3u) == ((uintptr_t)src & 3u))
+   {
+      while (!WORD_ALIGNED(src) && *src)
+      {
+         *dst++ = *src++;
+      }
+
+      while (WORD_ALIGNED(src))
+      {
+         uint32_t w = *(const uint32_t *)src;
+         if (WORD_HAS_ZERO(w)) break;
+         *(uint32_t *)dst = w;
+         src += 4;
+         dst += 4;
+      }
+   }
+
    while (*src)
    {
       *dst = *src;
@@ -43,14 +72,25 @@ char *strcpy(char *dst, const char *src)
 
 unsigned strlen(const char *str)
 {
-   unsigned len = 0;
-   while (*str)
+   const char *s = str;
+
+   while (!WORD_ALIGNED(s))
    {
-      ++len;
-      ++str;
+      if (*s == '\0') return (unsigned)(s - str);
+      ++s;
+   }
+
+   while (!WORD_HAS_ZERO(*(const uint32_t *)s))
+   {
+      s += 4;
    }
 
-   return len;
+   while (*s)
+   {
+      ++s;
+   }
+
+   return (unsigned)(s - str);
 }
 
 int str_eq(const char *a, const char *b)
@@ -107,6 +147,26 @@ int strcmp(const char *a, const char *b)
    if (a == NULL) return -1;
    if (b == NULL) return 1;
 
+   if (((uintptr_t)a & 3u) == ((uintptr_t)b & 3u))
+   {
+      while (!WORD_ALIGNED(a))
+      {
+         if (*a != *b || *a == '\0') goto tail;
+         ++a;
+         ++b;
+      }
+
+      /* Step whole words while they match and contain no terminator;
+         the differing or final word is re-examined byte-wise below. */
+      while (WORD_ALIGNED(a))
+      {
+         uint32_t wa = *(const uint32_t *)a;
+         if (wa != *(const uint32_t *)b || WORD_HAS_ZERO(wa)) break;
+         a += 4;
+         b += 4;
+      }
+   }
+
    while (*a && *b)
    {
       if (*a < *b) return -1;
@@ -115,6 +175,7 @@ int strcmp(const char *a, const char *b)
       ++b;
    }
 
+tail:
    if (*a == *b) return 0;
    return (*a < *b) ? -1 : 1;
 }
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/*
+ * Static tracepoints for hot paths.
+ *
+ * A site compiled in but disabled costs one global load and a mask
+ * test, so tracepoints can live in the scheduler, the syscall
+ * dispatcher and the disk path without distorting the timings they
+ * measure (unlike logfmt, which formats and copies on every call).
+ * Each event records the TSC and one argument into its own ring
+ * buffer; /dev/trace renders the rings as fixed-width text lines and
+ * the tracectl syscall flips sites on and off at runtime.  Everything
+ * is off by default.
+ */
+
+typedef enum
+{
+   TRACE_EV_SCHED = 0,      /* arg: pid picked to run */
+   TRACE_EV_SYSCALL = 1,    /* arg: syscall number */
+   TRACE_EV_DISK_READ = 2,  /* arg: sectors in the request */
+   TRACE_EV_PAGE_FAULT = 3, /* arg: faulting address */
+   TRACE_EV_COUNT
+} TraceEvent;
+
+/* Records per event ring; power of two so the index wraps by mask. */
+#define TRACE_RING_SIZE 256
+
+typedef struct
+{
+   uint64_t tsc; /* rdtsc at the tracepoint */
+   uint32_t seq; /* Monotonic per-event sequence number */
+   uint32_t arg; /* Event-specific payload */
+} TraceRecord;
+
+/* Per-site enable bits (bit n for event n).  Global so the macro's
+ * disabled-path test inlines to a load and a branch. */
+extern uint32_t g_TraceEnableMask;
+
+#define TRACE_EVENT(id, arg)                                                   \
+   do                                                                          \
+   {                                                                           \
+      if (g_TraceEnableMask & (1u << (id)))                                    \
+         Trace_Record((id), (uint32_t)(arg));                                  \
+   } while (0)
+
+void Trace_Record(TraceEvent id, uint32_t arg);
+void Trace_SetMask(uint32_t mask);
+uint32_t Trace_GetMask(void);
+
+/* Render the rings as fixed-width text into buffer (devfs read).
+ * Offset and size are in bytes; every record formats to the same line
+ * length, so byte offsets map straight onto records. */
+uint32_t Trace_Read(uint32_t offset, uint32_t size, void *buffer);
+
+#endif
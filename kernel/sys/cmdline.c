@@ -14,6 +14,7 @@
 
 #include "cmdline.h"
 #include <mem/mm_kernel.h>
+#include <std/ctype.h>
 #include <std/stdio.h>
 #include <std/string.h>
 #include <sys/sys.h>
@@ -29,6 +30,27 @@
 BOOT_Params s_params_table;
 static int s_parsed = 0; /* 0 = not yet parsed */
 
+/* Typed option table, filled once after the textual parse.  Indexed by
+ * CmdLineOpt so runtime queries never re-scan boot_params. */
+typedef struct
+{
+   const char *key;   /* Command-line key this slot binds to */
+   bool present;      /* Key appeared on the command line */
+   uint32_t u32;      /* Decimal value (0 when absent/unparsable) */
+   const char *value; /* Heap value string (NULL when absent) */
+} CmdLineSlot;
+
+static CmdLineSlot s_options[CMDLINE_OPT_COUNT] = {
+   [CMDLINE_OPT_ROOT] = {.key = "root"},
+   [CMDLINE_OPT_IRQ_WARN] = {.key = "irq_warn"},
+   [CMDLINE_OPT_SYSCALL_PROF] = {.key = "syscall_prof"},
+   [CMDLINE_OPT_PROFILE] = {.key = "profile"},
+   [CMDLINE_OPT_FDC_MOTOR_MS] = {.key = "fdc_motor_ms"},
+   [CMDLINE_OPT_IP] = {.key = "ip"},
+   [CMDLINE_OPT_GW] = {.key = "gw"},
+   [CMDLINE_OPT_PRELOAD] = {.key = "preload"},
+};
+
 /* -------------------------------------------------------------------------
  * Internal helpers
  * ---------------------------------------------------------------------- */
@@ -49,12 +71,12 @@ static const char *next_token(const char *src, char *keyOut, size_t keyMax,
                               char *valOut, size_t valMax)
 {
    /* Skip leading whitespace */
-   while (*src == ' ') src++;
+   while (isspace(*src)) src++;
    if (!*src) return NULL;
 
    /* -- Copy key: stop at '=' or space ---------------------------------- */
    size_t ki = 0;
-   while (*src && *src != ' ' && *src != '=' && ki + 1 < keyMax)
+   while (*src && !isspace(*src) && *src != '=' && ki + 1 < keyMax)
       keyOut[ki++] = *src++;
    keyOut[ki] = '\0';
 
@@ -64,16 +86,48 @@ static const char *next_token(const char *src, char *keyOut, size_t keyMax,
    {
       src++; /* consume '=' */
       size_t vi = 0;
-      while (*src && *src != ' ' && vi + 1 < valMax) valOut[vi++] = *src++;
+      while (*src && !isspace(*src) && vi + 1 < valMax) valOut[vi++] = *src++;
       valOut[vi] = '\0';
    }
 
    /* Skip trailing whitespace so the next call starts cleanly */
-   while (*src == ' ') src++;
+   while (isspace(*src)) src++;
 
    return src; /* may point to '\0' — caller checks *src */
 }
 
+/*
+ * resolve_options — bind each known option to its parsed argument.
+ *
+ * One pass of string comparisons at boot; afterwards CmdLine_GetBool and
+ * friends are plain array reads.  The first occurrence of a key wins,
+ * matching the lookup loops this table replaces.
+ */
+static void resolve_options(void)
+{
+   for (int opt = 0; opt < CMDLINE_OPT_COUNT; opt++)
+   {
+      for (uint32_t i = 0; i < s_params_table.count; i++)
+      {
+         if (strcmp(s_params_table.args[i].key, s_options[opt].key) != 0)
+         {
+            continue;
+         }
+
+         s_options[opt].present = true;
+         s_options[opt].value = s_params_table.args[i].value;
+
+         /* Plain decimal; anything unparsable leaves the value 0 so
+          * callers fall back to their default. */
+         const char *v = s_params_table.args[i].value;
+         uint32_t n = 0;
+         while (*v >= '0' && *v <= '9') n = n * 10 + (uint32_t)(*v++ - '0');
+         s_options[opt].u32 = (*v == '\0') ? n : 0;
+         break;
+      }
+   }
+}
+
 /* -------------------------------------------------------------------------
  * Public functions
  * ---------------------------------------------------------------------- */
@@ -138,6 +192,7 @@ void CmdLine_Initialize(void)
    }
 
    g_SysInfo->boot_params = s_params_table;
+   resolve_options();
 
    logfmt(LOG_INFO, "[CMDLINE] Parsed %u arguments from bootloader\n",
           s_params_table.count);
@@ -157,3 +212,21 @@ void CmdLine_Initialize(void)
 
    s_parsed = 1;
 }
+
+bool CmdLine_GetBool(CmdLineOpt opt)
+{
+   if (opt >= CMDLINE_OPT_COUNT) return false;
+   return s_options[opt].present;
+}
+
+uint32_t CmdLine_GetU32(CmdLineOpt opt, uint32_t def)
+{
+   if (opt >= CMDLINE_OPT_COUNT || !s_options[opt].present) return def;
+   return s_options[opt].u32 ? s_options[opt].u32 : def;
+}
+
+const char *CmdLine_GetString(CmdLineOpt opt)
+{
+   if (opt >= CMDLINE_OPT_COUNT || !s_options[opt].present) return NULL;
+   return s_options[opt].value;
+}
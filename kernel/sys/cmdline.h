@@ -3,11 +3,38 @@
 #ifndef CMDLINE_H
 #define CMDLINE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <sys/sys.h>
 
+/* Known command-line options, resolved to a typed table once during
+ * CmdLine_Initialize so queries are array indexing rather than repeated
+ * string comparisons over boot_params. */
+typedef enum
+{
+   CMDLINE_OPT_ROOT = 0,     /* root=<spec> */
+   CMDLINE_OPT_IRQ_WARN,     /* irq_warn=<cycles> */
+   CMDLINE_OPT_SYSCALL_PROF, /* syscall_prof */
+   CMDLINE_OPT_PROFILE,      /* profile */
+   CMDLINE_OPT_FDC_MOTOR_MS, /* fdc_motor_ms=<ms> */
+   CMDLINE_OPT_IP,           /* ip=<a.b.c.d> static address */
+   CMDLINE_OPT_GW,           /* gw=<a.b.c.d> default gateway */
+   CMDLINE_OPT_PRELOAD,      /* preload=<path>[,<path>...] exec-cache warmup */
+   CMDLINE_OPT_COUNT
+} CmdLineOpt;
+
 /* Parse the command line from g_SysInfo->boot.commandLine into s_params_table
  */
 void CmdLine_Initialize(void);
 
+/* true when the option appeared on the command line (with or without a
+ * value). */
+bool CmdLine_GetBool(CmdLineOpt opt);
+
+/* Decimal value of the option, or `def` when absent or unparsable. */
+uint32_t CmdLine_GetU32(CmdLineOpt opt, uint32_t def);
+
+/* Value string of the option, or NULL when absent. */
+const char *CmdLine_GetString(CmdLineOpt opt);
+
 #endif
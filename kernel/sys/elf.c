@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 #include "elf.h"
 #include <constants.h>
+#include <cpu/execcache.h>
 #include <cpu/process.h>
 #include <hal/mem.h>
 #include <mem/mm_kernel.h>
@@ -18,6 +19,7 @@
 #define ELFCLASS32 1
 #define ELFDATA2LSB 1
 #define EM_386 3
+#define PT_LOAD 1
 
 static int setup_initial_user_stack(Process *proc, const char *filename)
 {
@@ -74,6 +76,55 @@ static int setup_initial_user_stack(Process *proc, const char *filename)
    return 0;
 }
 
+int ELF_ReadHeader(VFS_File *file, Elf32_Ehdr *ehdr)
+{
+   if (VFS_Seek(file, 0) < 0) return -1;
+
+   if (VFS_Read(file, sizeof(*ehdr), ehdr) != sizeof(*ehdr)) return -1;
+
+   if (ehdr->e_ident[EI_MAG0] != ELFMAG0 || ehdr->e_ident[EI_MAG1] != ELFMAG1 ||
+       ehdr->e_ident[EI_MAG2] != ELFMAG2 || ehdr->e_ident[EI_MAG3] != ELFMAG3)
+   {
+      return -1;
+   }
+
+   if (ehdr->e_ident[4] != ELFCLASS32 || ehdr->e_ident[5] != ELFDATA2LSB)
+   {
+      return -1;
+   }
+
+   if (ehdr->e_machine != EM_386) return -1;
+
+   return 0;
+}
+
+int ELF_RecordSegments(VFS_File *file, Process *proc, const Elf32_Ehdr *ehdr)
+{
+   Elf32_Phdr phdr;
+
+   proc->segment_count = 0;
+
+   for (uint16_t i = 0; i < ehdr->e_phnum; ++i)
+   {
+      uint32_t phoff = ehdr->e_phoff + (i * ehdr->e_phentsize);
+      if (VFS_Seek(file, phoff) < 0) return -1;
+      if (VFS_Read(file, sizeof(phdr), &phdr) != sizeof(phdr)) return -1;
+
+      if (phdr.p_type != PT_LOAD) continue;
+      if (phdr.p_memsz == 0) continue;
+
+      if (proc->segment_count >= PROCESS_MAX_SEGMENTS) return -1;
+
+      ProcessSegment *seg = &proc->segments[proc->segment_count++];
+      seg->vaddr = phdr.p_vaddr;
+      seg->memsz = phdr.p_memsz;
+      seg->filesz = phdr.p_filesz;
+      seg->file_offset = phdr.p_offset;
+   }
+
+   return 0;
+}
+
 int ELF_Load(VFS_File *file, void **entryOut)
 {
    // read ELF header
@@ -161,7 +212,6 @@ int ELF_Load(VFS_File *file, void **entryOut)
       memcpy(&phdr, ph_buf, sizeof(phdr));
       free(ph_buf);
 
-      const uint32_t PT_LOAD = 1;
       if (phdr.p_type != PT_LOAD) continue;
 
       // determine destination address (prefer physical p_paddr if provided)
@@ -212,7 +262,8 @@ int ELF_Load(VFS_File *file, void **entryOut)
 Process *ELF_LoadProcess(const char *filename, bool kernel_mode)
 {
    if (!filename) return NULL;
-   // Open ELF file from filesystem
+   if (strlen(filename) >= PROCESS_EXEC_PATH_MAX) return NULL;
+
    VFS_File *file = VFS_Open(filename);
    if (!file)
    {
@@ -221,199 +272,58 @@ Process *ELF_LoadProcess(const char *filename, bool kernel_mode)
       return NULL;
    }
 
-   // Read ELF header
-   if (VFS_Seek(file, 0) < 0)
-   {
-      logfmt(LOG_ERROR, "[ELF] LoadProcess: seek header failed\n");
-      VFS_Close(file);
-      return NULL;
-   }
+   /* Same parsed-form cache and demand-paged segment path as
+    * Process_Execute: a hit replaces the header and program header
+    * reads, and segment pages are faulted in (from cached frames when
+    * warm) by Process_HandlePageFault instead of being read eagerly in
+    * sector-sized chunks here. */
+   uint32_t cached_entry = 0;
+   ProcessSegment cached_segments[PROCESS_MAX_SEGMENTS];
+   uint32_t cached_segment_count = 0;
+   bool from_cache =
+       ExecCache_Lookup(filename, file->partition, file->partition->write_gen,
+                        VFS_GetSize(file), &cached_entry, cached_segments,
+                        &cached_segment_count) == SUCCESS;
 
    Elf32_Ehdr ehdr;
-   void *hdr_buf = kmalloc(sizeof(ehdr));
-   if (!hdr_buf)
+   if (!from_cache && ELF_ReadHeader(file, &ehdr) < 0)
    {
-      logfmt(LOG_ERROR, "[ELF] LoadProcess: read header failed\n");
+      logfmt(LOG_ERROR, "[ELF] LoadProcess: bad or unreadable header in %s\n",
+             filename);
       VFS_Close(file);
       return NULL;
    }
 
-   uint32_t read_bytes = VFS_Read(file, sizeof(ehdr), (uint8_t *)hdr_buf);
-   if (read_bytes != sizeof(ehdr))
+   Process *proc =
+       Process_Create(from_cache ? cached_entry : ehdr.e_entry, kernel_mode);
+   if (!proc)
    {
-      logfmt(LOG_ERROR, "[ELF] LoadProcess: read header failed\n");
-      free(hdr_buf);
+      logfmt(LOG_ERROR, "[ELF] LoadProcess: Process_Create failed\n");
       VFS_Close(file);
       return NULL;
    }
 
-   memcpy(&ehdr, hdr_buf, sizeof(ehdr));
-   free(hdr_buf);
-   // Validate magic
-   if (ehdr.e_ident[EI_MAG0] != ELFMAG0 || ehdr.e_ident[EI_MAG1] != ELFMAG1 ||
-       ehdr.e_ident[EI_MAG2] != ELFMAG2 || ehdr.e_ident[EI_MAG3] != ELFMAG3)
+   if (from_cache)
    {
-      logfmt(LOG_ERROR, "[ELF] LoadProcess: bad magic\n");
-      VFS_Close(file);
-      return NULL;
+      memcpy(proc->segments, cached_segments, sizeof(proc->segments));
+      proc->segment_count = cached_segment_count;
    }
-   // Create process with ELF entry point
-   Process *proc = Process_Create(ehdr.e_entry, kernel_mode);
-   if (!proc)
+   else if (ELF_RecordSegments(file, proc, &ehdr) != 0)
    {
-      logfmt(LOG_ERROR, "[ELF] LoadProcess: Process_Create failed\n");
+      logfmt(LOG_ERROR, "[ELF] LoadProcess: bad program headers in %s\n",
+             filename);
+      Process_Destroy(proc);
       VFS_Close(file);
       return NULL;
    }
-
-   // Save kernel page directory at the start - we'll need to restore it
-   void *kernel_pdir = g_HalPagingOperations->GetCurrentPageDirectory();
-
-   // Load each program header (PT_LOAD segments)
-   Elf32_Phdr phdr;
-   for (uint16_t i = 0; i < ehdr.e_phnum; ++i)
+   else
    {
-      uint32_t phoff = ehdr.e_phoff + i * ehdr.e_phentsize;
-      if (VFS_Seek(file, phoff) < 0)
-      {
-         logfmt(LOG_ERROR, "[ELF] LoadProcess: seek phdr %u failed\n", i);
-         Process_Destroy(proc);
-         VFS_Close(file);
-         return NULL;
-      }
-
-      void *ph_buf = kmalloc(sizeof(phdr));
-      if (!ph_buf)
-      {
-         logfmt(LOG_ERROR, "[ELF] LoadProcess: read phdr %u failed\n", i);
-         Process_Destroy(proc);
-         VFS_Close(file);
-         return NULL;
-      }
-
-      uint32_t ph_read = VFS_Read(file, sizeof(phdr), (uint8_t *)ph_buf);
-      if (ph_read != sizeof(phdr))
-      {
-         logfmt(LOG_ERROR, "[ELF] LoadProcess: read phdr %u failed (got %u)\n",
-                i, ph_read);
-         free(ph_buf);
-         Process_Destroy(proc);
-         VFS_Close(file);
-         return NULL;
-      }
-
-      memcpy(&phdr, ph_buf, sizeof(phdr));
-      free(ph_buf);
-
-      // Only load PT_LOAD segments
-      const uint32_t PT_LOAD = 1;
-      if (phdr.p_type != PT_LOAD) continue;
-
-      uint32_t vaddr = phdr.p_vaddr;
-      uint32_t memsz = phdr.p_memsz;
-      uint32_t filesz = phdr.p_filesz;
-
-      // Calculate page-aligned start and total pages needed
-      uint32_t vaddr_aligned = vaddr & ~0xFFFu; // Align down to page boundary
-      uint32_t vaddr_end = vaddr + memsz;       // End address (exclusive)
-      uint32_t pages_needed = (vaddr_end - vaddr_aligned + 4095) / 4096;
-
-      for (uint32_t j = 0; j < pages_needed; ++j)
-      {
-         uint32_t page_va = vaddr_aligned + (j * 4096);
-         uint32_t phys = PMM_AllocatePhysicalPage();
-         if (phys == 0)
-         {
-            logfmt(LOG_ERROR,
-                   "[ELF] LoadProcess: PMM_AllocatePhysicalPage failed\n");
-            Process_Destroy(proc);
-            VFS_Close(file);
-            return NULL;
-         }
-
-         // Map page into process's page directory (user mode, read+write)
-         if (g_HalPagingOperations->MapPage(proc->page_directory, page_va, phys,
-                                            HAL_PAGE_PRESENT | HAL_PAGE_RW |
-                                                HAL_PAGE_USER) < 0)
-         {
-            logfmt(LOG_ERROR,
-                   "[ELF] LoadProcess: HAL_Paging_MapPage failed at 0x%08x\n",
-                   page_va);
-            PMM_FreePhysicalPage(phys);
-            Process_Destroy(proc);
-            VFS_Close(file);
-            return NULL;
-         }
-      }
-
-      // Read segment data from file and copy to process memory
-      if (VFS_Seek(file, phdr.p_offset) < 0)
-      {
-         logfmt(LOG_ERROR, "[ELF] LoadProcess: seek segment data failed\n");
-         Process_Destroy(proc);
-         VFS_Close(file);
-         return NULL;
-      }
-
-      // Read file data into kernel buffer (while still in kernel page
-      // directory). Use a heap bounce buffer to avoid stack overwrite if the
-      // driver returns more than requested.
-      const uint32_t CHUNK = 512;
-      uint8_t *buffer = (uint8_t *)kmalloc(CHUNK);
-      if (!buffer)
-      {
-         logfmt(LOG_ERROR, "[ELF] LoadProcess: alloc buffer failed\n");
-         Process_Destroy(proc);
-         VFS_Close(file);
-         return NULL;
-      }
-
-      uint32_t remaining = filesz;
-      uint32_t offset = 0;
-
-      while (remaining > 0)
-      {
-         uint32_t chunk = remaining < CHUNK ? remaining : CHUNK;
-         uint32_t bytes_read = VFS_Read(file, chunk, buffer);
-         if (bytes_read == 0 || bytes_read > chunk)
-         {
-            logfmt(LOG_ERROR, "[ELF] LoadProcess: VFS_Read failed\n");
-            free(buffer);
-            Process_Destroy(proc);
-            VFS_Close(file);
-            return NULL;
-         }
-
-         // Temporarily switch to process page directory to write to its memory
-         void *old_pdir = g_HalPagingOperations->GetCurrentPageDirectory();
-         g_HalPagingOperations->SwitchPageDirectory(proc->page_directory);
-
-         // Copy to process memory
-         memcpy((void *)(vaddr + offset), buffer, bytes_read);
-
-         // Immediately restore kernel page directory
-         g_HalPagingOperations->SwitchPageDirectory(old_pdir);
-
-         offset += bytes_read;
-         remaining -= bytes_read;
-      }
-
-      free(buffer);
-
-      // Zero out BSS (memsz > filesz)
-      if (memsz > filesz)
-      {
-         // Temporarily switch to process page directory for BSS zeroing
-         void *old_pdir = g_HalPagingOperations->GetCurrentPageDirectory();
-         g_HalPagingOperations->SwitchPageDirectory(proc->page_directory);
-
-         memset((void *)(vaddr + filesz), 0, memsz - filesz);
-
-         // Restore kernel page directory
-         g_HalPagingOperations->SwitchPageDirectory(old_pdir);
-      }
+      ExecCache_Insert(filename, file->partition, file->partition->write_gen,
+                       VFS_GetSize(file), ehdr.e_entry, proc->segments,
+                       proc->segment_count);
    }
 
+   memcpy(proc->exec_path, filename, strlen(filename) + 1);
    VFS_Close(file);
 
    if (setup_initial_user_stack(proc, filename) != 0)
@@ -423,13 +333,8 @@ Process *ELF_LoadProcess(const char *filename, bool kernel_mode)
       return NULL;
    }
 
-   logfmt(LOG_INFO,
-          "[ELF] LoadProcess: successfully loaded %s into pid=%u at entry "
-          "0x%08x\n",
-          filename, proc->pid, ehdr.e_entry);
-
-   // Force restore kernel page directory to ensure we're back in kernel space
-   g_HalPagingOperations->SwitchPageDirectory(kernel_pdir);
+   logfmt(LOG_INFO, "[ELF] LoadProcess: staged %s pid=%u entry=0x%08x%s\n",
+          filename, proc->pid, proc->eip, from_cache ? " (cached)" : "");
 
    return proc;
 }
@@ -40,6 +40,16 @@ typedef struct
    uint32_t p_align;
 } __attribute__((packed)) Elf32_Phdr;
 
+// Read and validate the ELF header (magic, 32-bit little-endian, i386).
+// Returns 0 on success, -1 on a short read or unsupported image.  Shared
+// by ELF_LoadProcess and Process_Execute so there is one parse path.
+int ELF_ReadHeader(VFS_File *file, Elf32_Ehdr *ehdr);
+
+// Record the PT_LOAD extents into proc->segments instead of reading them
+// in; pages are then mapped and filled on first access by
+// Process_HandlePageFault, and repeat loads hit the exec cache.
+int ELF_RecordSegments(VFS_File *file, Process *proc, const Elf32_Ehdr *ehdr);
+
 // Load an ELF32 file from an opened VFS_File into memory. On success returns
 // true and sets *entryOut to the ELF entry point (as a pointer). The loader
 // will read program headers (PT_LOAD) and copy them to their p_paddr (or
@@ -8,6 +8,7 @@
  */
 
 #include "kmod.h"
+#include <crypto/crypto.h>
 #include <fs/fs.h>
 #include <hal/mem.h>
 #include <mem/mm_kernel.h>
@@ -94,7 +95,8 @@ typedef struct
    uint32_t jmprel_size; // Size of .rel.plt
    uint32_t pltgot_addr; // Address of .got.plt (for PLT patching)
 
-   uint32_t alloc_size; // Heap bytes reserved for this module image
+   uint32_t alloc_size; // Arena bytes reserved for this module
+   uint32_t arena_used; // Bump cursor into the arena
    int loaded;          // 1 if loaded in memory, 0 if not
 } ExtendedLibData;
 
@@ -104,14 +106,53 @@ static uint32_t kmod_total_allocated = 0;
 static LibRecord s_lib_registry[LIB_REGISTRY_MAX];
 static ExtendedLibData extended_data[LIB_REGISTRY_MAX];
 
-// Global symbol table - shared across all loaded libraries and kernel
+// Global symbol table - shared across all loaded libraries and kernel.
+// Entries are stored densely in registration order (so lsmod-style dumps
+// stay readable); lookups go through an open-addressing hash index so
+// apply_relocations stays O(1) per entry instead of scanning the array.
 static GlobalSymbolEntry global_symtab[KMOD_MAX_GLOBAL_SYMBOLS];
 static int global_symtab_count = 0;
 
+/* Hash index: each slot holds (dense index + 1), 0 means empty.  Sized
+ * at twice the entry capacity (power of two) so linear probing always
+ * terminates and chains stay short even at a full table. */
+#define KMOD_SYMHASH_SIZE (KMOD_MAX_GLOBAL_SYMBOLS * 2)
+static uint16_t global_symtab_index[KMOD_SYMHASH_SIZE];
+
+// FNV-1a over the symbol name
+static uint32_t symhash(const char *s)
+{
+   uint32_t h = 2166136261u;
+   while (*s)
+   {
+      h ^= (uint8_t)*s++;
+      h *= 16777619u;
+   }
+   return h;
+}
+
+/* Prelink cache: a sidecar file written next to the module after its
+ * first load, holding the fully relocated image together with the load
+ * base it was relocated for and a checksum of the original file.  Load
+ * addresses from KMOD_MemoryAllocate are deterministic for a given boot
+ * image, so later boots can blit the cached image and skip the
+ * relocation pass entirely; any mismatch falls back to relocating. */
+#define KMOD_PRECACHE_MAGIC 0x4B505245u /* "EPRK" */
+#define KMOD_PRECACHE_SUFFIX ".pre"
+
+typedef struct
+{
+   uint32_t magic;
+   uint32_t load_base;  // Address the cached image was relocated for
+   uint32_t image_size; // Size of the cached (and original) image
+   uint32_t checksum;   // FNV-1a over the original, unrelocated file
+} PrecacheHeader;
+
 // Forward declarations
 static int parse_elf_symbols(ExtendedLibData *ext, uint32_t base_addr,
-                             uint32_t size);
+                             uint32_t size, int apply_relocs);
 static int find_index(const char *name);
+static int ensure_record(const char *name);
 
 static kmod_register_symbols_t symbol_callback = NULL;
 
@@ -131,6 +172,7 @@ int KMOD_MemoryInitialize(void)
       extended_data[i].rel_addr = 0;
       extended_data[i].jmprel_addr = 0;
       extended_data[i].alloc_size = 0;
+      extended_data[i].arena_used = 0;
       extended_data[i].loaded = 0;
    }
 
@@ -172,16 +214,32 @@ int KMOD_AddGlobalSymbol(const char *name, uint32_t address,
    entry->lib_name[63] = '\0';
    entry->is_kernel = is_kernel;
 
+   /* Index the entry under its (possibly truncated) stored name.  On a
+    * duplicate name the first registration keeps the index slot, matching
+    * the old scan which returned the earliest match. */
+   uint32_t slot = symhash(entry->name) & (KMOD_SYMHASH_SIZE - 1);
+   while (global_symtab_index[slot] != 0)
+   {
+      if (strcmp(global_symtab[global_symtab_index[slot] - 1].name,
+                 entry->name) == 0)
+         break;
+      slot = (slot + 1) & (KMOD_SYMHASH_SIZE - 1);
+   }
+   if (global_symtab_index[slot] == 0)
+      global_symtab_index[slot] = (uint16_t)(global_symtab_count + 1);
+
    global_symtab_count++;
    return 0;
 }
 
 uint32_t KMOD_LookupGlobalSymbol(const char *name)
 {
-   for (int i = 0; i < global_symtab_count; i++)
+   uint32_t slot = symhash(name) & (KMOD_SYMHASH_SIZE - 1);
+   while (global_symtab_index[slot] != 0)
    {
-      if (strcmp(global_symtab[i].name, name) == 0)
-         return global_symtab[i].address;
+      GlobalSymbolEntry *e = &global_symtab[global_symtab_index[slot] - 1];
+      if (strcmp(e->name, name) == 0) return e->address;
+      slot = (slot + 1) & (KMOD_SYMHASH_SIZE - 1);
    }
    return 0; // Not found
 }
@@ -205,9 +263,45 @@ void KMOD_PrintGlobalSymtab(void)
 void KMOD_ClearGlobalSymtab(void)
 {
    global_symtab_count = 0;
+   memset(global_symtab_index, 0, sizeof(global_symtab_index));
    logfmt(LOG_INFO, "[KMOD] Global symbol table cleared\n");
 }
 
+/* Drop every global symbol a library registered and rebuild the hash
+ * index from the survivors.  The dense array keeps registration order,
+ * so replaying the inserts preserves the first-registration-wins rule
+ * for names several libraries export.  Unload is rare enough that a
+ * full rebuild beats tombstone bookkeeping in the probe loops. */
+static void symtab_remove_library(const char *lib_name)
+{
+   int kept = 0;
+   for (int i = 0; i < global_symtab_count; i++)
+   {
+      GlobalSymbolEntry *e = &global_symtab[i];
+      if (!e->is_kernel && strcmp(e->lib_name, lib_name) == 0) continue;
+      if (kept != i) global_symtab[kept] = *e;
+      kept++;
+   }
+
+   if (kept == global_symtab_count) return;
+   global_symtab_count = kept;
+
+   memset(global_symtab_index, 0, sizeof(global_symtab_index));
+   for (int i = 0; i < global_symtab_count; i++)
+   {
+      uint32_t slot = symhash(global_symtab[i].name) & (KMOD_SYMHASH_SIZE - 1);
+      while (global_symtab_index[slot] != 0)
+      {
+         if (strcmp(global_symtab[global_symtab_index[slot] - 1].name,
+                    global_symtab[i].name) == 0)
+            break;
+         slot = (slot + 1) & (KMOD_SYMHASH_SIZE - 1);
+      }
+      if (global_symtab_index[slot] == 0)
+         global_symtab_index[slot] = (uint16_t)(i + 1);
+   }
+}
+
 // ============================================================================
 // Relocation Application
 // ============================================================================
@@ -421,12 +515,9 @@ int KMOD_ApplyKernelRelocations(void)
    return 0;
 }
 
-uint32_t KMOD_MemoryAllocate(const char *lib_name, uint32_t size)
+int KMOD_ArenaReserve(const char *lib_name, uint32_t size)
 {
-   if (size == 0)
-   {
-      return 0;
-   }
+   if (size == 0) return -1;
 
    if (!kmod_mem_initialized)
    {
@@ -434,34 +525,79 @@ uint32_t KMOD_MemoryAllocate(const char *lib_name, uint32_t size)
       if (KMOD_MemoryInitialize() != 0)
       {
          logfmt(LOG_ERROR, "[KMOD] Failed to initialize kmod memory\n");
-         return 0;
+         return -1;
       }
    }
 
-   // Round up to 16-byte boundary for alignment
-   uint32_t aligned_size = (size + 15) & ~15;
+   int idx = ensure_record(lib_name);
+   if (idx < 0) return -1;
 
-   void *alloc = kmalloc(aligned_size);
-   if (!alloc)
+   LibRecord *lib = &s_lib_registry[idx];
+   ExtendedLibData *ext = &extended_data[idx];
+
+   if (lib->base)
    {
-      logfmt(LOG_ERROR, "[KMOD] Out of heap memory allocating %u bytes\n",
-             aligned_size);
-      return 0;
+      logfmt(LOG_WARNING, "[KMOD] %s already has an arena (%u bytes)\n",
+             lib_name, ext->alloc_size);
+      return -1;
    }
 
-   int idx = find_index(lib_name);
-   if (idx >= 0)
+   uint32_t aligned_size = (size + 15) & ~15;
+   void *arena = kmalloc(aligned_size);
+   if (!arena)
    {
-      s_lib_registry[idx].base = alloc;
-      extended_data[idx].alloc_size = aligned_size;
+      logfmt(LOG_ERROR, "[KMOD] Out of heap memory reserving %u bytes for %s\n",
+             aligned_size, lib_name);
+      return -1;
    }
 
+   lib->base = arena;
+   ext->alloc_size = aligned_size;
+   ext->arena_used = 0;
+
    if (kmod_total_allocated <= UINT32_MAX - aligned_size)
       kmod_total_allocated += aligned_size;
    else
       kmod_total_allocated = UINT32_MAX;
 
-   return (uint32_t)(uintptr_t)alloc;
+   return 0;
+}
+
+/* Bump allocation out of the library's arena.  Without an up-front
+ * KMOD_ArenaReserve the first call sizes the arena, which matches the
+ * load paths reserving the whole image in one call.  No per-allocation
+ * metadata exists: the arena pointer and cursor in the registry are the
+ * entire bookkeeping, and KMOD_MemoryFree drops it all at once. */
+uint32_t KMOD_MemoryAllocate(const char *lib_name, uint32_t size)
+{
+   if (size == 0)
+   {
+      return 0;
+   }
+
+   uint32_t aligned_size = (size + 15) & ~15;
+
+   int idx = find_index(lib_name);
+   if (idx < 0 || !s_lib_registry[idx].base)
+   {
+      if (KMOD_ArenaReserve(lib_name, aligned_size) != 0) return 0;
+      idx = find_index(lib_name);
+   }
+
+   LibRecord *lib = &s_lib_registry[idx];
+   ExtendedLibData *ext = &extended_data[idx];
+
+   if (ext->arena_used + aligned_size > ext->alloc_size)
+   {
+      logfmt(LOG_ERROR,
+             "[KMOD] %s: arena exhausted (need %u, used %u of %u)\n", lib_name,
+             aligned_size, ext->arena_used, ext->alloc_size);
+      return 0;
+   }
+
+   uint32_t addr = (uint32_t)(uintptr_t)lib->base + ext->arena_used;
+   ext->arena_used += aligned_size;
+   return addr;
 }
 
 // Helper: find index of library by name
@@ -745,7 +881,7 @@ int KMOD_ParseSymbols(LibRecord *lib)
           "[KMOD] Parsing symbols for pre-loaded library: %s at 0x%x\n",
           lib->name, (unsigned int)lib->base);
 
-   parse_elf_symbols(ext, (uint32_t)lib->base, lib->size);
+   parse_elf_symbols(ext, (uint32_t)lib->base, lib->size, 1);
 
    ext->loaded = 1; // Mark as loaded so symbol table is available
 
@@ -775,6 +911,7 @@ int KMOD_MemoryFree(const char *lib_name)
    free(lib->base);
    lib->base = NULL;
    ext->alloc_size = 0;
+   ext->arena_used = 0;
 
    if (kmod_total_allocated >= freed)
       kmod_total_allocated -= freed;
@@ -828,14 +965,16 @@ int KMOD_Load(const char *name, const void *image, uint32_t size)
           load_addr);
 
    // Parse ELF symbols from the loaded library
-   parse_elf_symbols(ext, load_addr, size);
+   parse_elf_symbols(ext, load_addr, size, 1);
 
    return 0;
 }
 
-// Parse ELF header and extract dynamic symbols from a loaded library
+// Parse ELF header and extract dynamic symbols from a loaded library.
+// apply_relocs is 0 when the image came from the prelink cache and is
+// already relocated for base_addr.
 static int parse_elf_symbols(ExtendedLibData *ext, uint32_t base_addr,
-                             uint32_t size)
+                             uint32_t size, int apply_relocs)
 {
    // Validate input parameters
    if (!ext || base_addr == 0 || size == 0)
@@ -1078,7 +1217,7 @@ static int parse_elf_symbols(ExtendedLibData *ext, uint32_t base_addr,
    // If we later need to support non-PIC libraries, we should use formal
    // relocation sections (SHT_REL) instead of heuristic scanning.
 
-   for (int i = 0; i < e_shnum; i++)
+   for (int i = 0; apply_relocs && i < e_shnum; i++)
    {
       Elf32_Shdr *sh = (Elf32_Shdr *)(elf_data + e_shoff + (i * e_shentsize));
 
@@ -1124,6 +1263,90 @@ static int parse_elf_symbols(ExtendedLibData *ext, uint32_t base_addr,
    return 0;
 }
 
+/* Module images are fingerprinted with CRC32 (sliced four bytes per
+ * step); stale prelink caches written under the old FNV-1a scheme just
+ * miss and get rewritten.  The checksum is streamed over the image as
+ * it arrives from disk (KMOD_LoadFromDisk) rather than computed in a
+ * second pass: each chunk is folded in while it is still hot in the
+ * cache, so verification costs no extra walk over the image. */
+#define KMOD_READ_CHUNK (64u * 1024u)
+
+// Build "<filepath>.pre"; returns 0 on success, -1 if it would not fit
+static int precache_path(const char *filepath, char *out, uint32_t out_size)
+{
+   uint32_t len = strlen(filepath);
+   if (len + sizeof(KMOD_PRECACHE_SUFFIX) > out_size) return -1;
+   memcpy(out, filepath, len);
+   memcpy(out + len, KMOD_PRECACHE_SUFFIX, sizeof(KMOD_PRECACHE_SUFFIX));
+   return 0;
+}
+
+/* Try to satisfy a module load from its prelink cache.  On success the
+ * relocated image has been read over the buffer at load_addr and 0 is
+ * returned; any header/base/checksum mismatch leaves the buffer alone
+ * and returns -1 so the caller relocates from scratch. */
+static int precache_try_load(const char *filepath, uint32_t load_addr,
+                             uint32_t file_size, uint32_t checksum)
+{
+   char path[256];
+   if (precache_path(filepath, path, sizeof(path)) < 0) return -1;
+
+   VFS_File *file = VFS_Open(path);
+   if (!file) return -1;
+
+   PrecacheHeader hdr;
+   if (VFS_Read(file, sizeof(hdr), &hdr) != sizeof(hdr) ||
+       hdr.magic != KMOD_PRECACHE_MAGIC || hdr.load_base != load_addr ||
+       hdr.image_size != file_size || hdr.checksum != checksum)
+   {
+      VFS_Close(file);
+      return -1;
+   }
+
+   uint32_t got = VFS_Read(file, file_size, (void *)load_addr);
+   VFS_Close(file);
+   if (got != file_size)
+   {
+      logfmt(LOG_WARNING, "[KMOD] Truncated prelink cache: %s\n", path);
+      return -1;
+   }
+
+   return 0;
+}
+
+// Write the relocated image at load_addr to the module's prelink cache
+static void precache_store(const char *filepath, uint32_t load_addr,
+                           uint32_t file_size, uint32_t checksum)
+{
+   char path[256];
+   if (precache_path(filepath, path, sizeof(path)) < 0) return;
+
+   VFS_File *file = VFS_Create(path, 0644);
+   if (!file) file = VFS_Open(path); /* Overwrite a stale cache */
+   if (!file)
+   {
+      logfmt(LOG_WARNING, "[KMOD] Cannot create prelink cache: %s\n", path);
+      return;
+   }
+
+   PrecacheHeader hdr;
+   hdr.magic = KMOD_PRECACHE_MAGIC;
+   hdr.load_base = load_addr;
+   hdr.image_size = file_size;
+   hdr.checksum = checksum;
+
+   if (VFS_Write(file, sizeof(hdr), &hdr) != sizeof(hdr) ||
+       VFS_Write(file, file_size, (const void *)load_addr) != file_size)
+   {
+      logfmt(LOG_WARNING, "[KMOD] Short write to prelink cache: %s\n", path);
+      VFS_Close(file);
+      VFS_Delete(path); /* Don't leave a half-written cache behind */
+      return;
+   }
+
+   VFS_Close(file);
+}
+
 int KMOD_LoadFromDisk(const char *name, const char *filepath)
 {
    if (!kmod_mem_initialized) KMOD_MemoryInitialize();
@@ -1172,9 +1395,26 @@ int KMOD_LoadFromDisk(const char *name, const char *filepath)
       return -1;
    }
 
-   // Read library data from disk
+   /* Read the image in chunks and stream the verification checksum
+    * over each chunk as it lands, instead of reading everything and
+    * then walking the whole (by now cache-cold) image a second time. */
    VFS_Seek(file, 0);
-   uint32_t bytes_read = VFS_Read(file, file_size, (void *)load_addr);
+   CRC32_Context crc;
+   CRC32_Init(&crc);
+
+   uint32_t bytes_read = 0;
+   while (bytes_read < file_size)
+   {
+      uint32_t want = file_size - bytes_read;
+      if (want > KMOD_READ_CHUNK) want = KMOD_READ_CHUNK;
+
+      uint32_t got = VFS_Read(file, want, (void *)(load_addr + bytes_read));
+      if (got == 0) break;
+
+      CRC32_Update(&crc, (const void *)(load_addr + bytes_read), got);
+      bytes_read += got;
+   }
+
    if (bytes_read != file_size)
    {
       logfmt(LOG_ERROR,
@@ -1196,8 +1436,22 @@ int KMOD_LoadFromDisk(const char *name, const char *filepath)
    logfmt(LOG_INFO, "[KMOD] Loaded %s (%d bytes) from disk at 0x%x\n", name,
           file_size, load_addr);
 
-   // Parse ELF symbols from the loaded library
-   parse_elf_symbols(ext, load_addr, file_size);
+   /* The unrelocated image's fingerprint was streamed during the read;
+    * try the prelink cache with it: on a hit the relocated image is
+    * blitted over the buffer and only symbol extraction remains; on a
+    * miss relocate as usual and write the cache for the next boot. */
+   uint32_t checksum = CRC32_Final(&crc);
+   if (precache_try_load(filepath, load_addr, file_size, checksum) == 0)
+   {
+      logfmt(LOG_INFO, "[KMOD] %s: prelink cache hit, relocations skipped\n",
+             name);
+      parse_elf_symbols(ext, load_addr, file_size, 0);
+   }
+   else
+   {
+      parse_elf_symbols(ext, load_addr, file_size, 1);
+      precache_store(filepath, load_addr, file_size, checksum);
+   }
 
    if (symbol_callback)
    {
@@ -1207,6 +1461,143 @@ int KMOD_LoadFromDisk(const char *name, const char *filepath)
    return 0;
 }
 
+/* Walk one space-delimited field, NUL-terminate it in place and advance
+ * the cursor.  Returns NULL at end of line. */
+static char *manifest_field(char **cursor)
+{
+   char *p = *cursor;
+   while (*p == ' ') p++;
+   if (*p == '\0') return NULL;
+
+   char *start = p;
+   while (*p != '\0' && *p != ' ') p++;
+   if (*p != '\0') *p++ = '\0';
+   *cursor = p;
+   return start;
+}
+
+/* Load one manifest entry.  The manifest is topologically ordered, so
+ * every listed dependency came from an earlier line; record the list
+ * with a loaded-flag check instead of re-walking the registry per name
+ * the way KMOD_ResolveDependencies does. */
+static int manifest_load_one(const char *name, const char *image, char *deps)
+{
+   if (KMOD_LoadFromDisk(name, image) < 0) return -1;
+
+   int idx = find_index(name);
+   if (idx < 0) return -1;
+
+   ExtendedLibData *ext = &extended_data[idx];
+
+   ext->dep_count = 0;
+   if (deps && !str_eq(deps, "-"))
+   {
+      while (deps && *deps)
+      {
+         char *comma = (char *)strchr(deps, ',');
+         if (comma) *comma++ = '\0';
+
+         if (ext->dep_count >= KMOD_MAX_DEPS)
+         {
+            logfmt(LOG_WARNING, "[KMOD] %s: too many dependencies\n", name);
+            break;
+         }
+
+         DependencyRecord *dep = &ext->deps[ext->dep_count++];
+         strncpy(dep->name, deps, sizeof(dep->name) - 1);
+         dep->name[sizeof(dep->name) - 1] = '\0';
+         dep->resolved = KMOD_IsLoaded(deps);
+         deps = comma;
+      }
+   }
+
+   if (!KMOD_CheckDependencies(name))
+   {
+      logfmt(LOG_ERROR, "[KMOD] unresolved dependencies for %s\n", name);
+      KMOD_Remove(name);
+      return -1;
+   }
+
+   if (s_lib_registry[idx].entry && KMOD_CallIfExists(name) < 0)
+   {
+      logfmt(LOG_ERROR, "[KMOD] module init failed for %s\n", name);
+      KMOD_Remove(name);
+      return -1;
+   }
+
+   return 0;
+}
+
+int KMOD_LoadManifest(const char *path)
+{
+   VFS_File *file = VFS_Open(path);
+   if (!file)
+   {
+      logfmt(LOG_INFO, "[KMOD] no module manifest at %s\n", path);
+      return 0;
+   }
+
+   uint32_t size = VFS_GetSize(file);
+   char *text = size ? kmalloc(size + 1) : NULL;
+   if (!text)
+   {
+      VFS_Close(file);
+      return -1;
+   }
+
+   if (VFS_Read(file, size, text) != size)
+   {
+      logfmt(LOG_ERROR, "[KMOD] short read of manifest %s\n", path);
+      free(text);
+      VFS_Close(file);
+      return -1;
+   }
+   VFS_Close(file);
+   text[size] = '\0';
+
+   int loaded = 0;
+   int failed = 0;
+   char *line = text;
+   while (line && *line)
+   {
+      char *next = (char *)strchr(line, '\n');
+      if (next) *next++ = '\0';
+
+      if (*line != '\0' && *line != '#')
+      {
+         char *cursor = line;
+         const char *name = manifest_field(&cursor);
+         const char *image = manifest_field(&cursor);
+         char *deps = manifest_field(&cursor);
+         /* Fourth field (undefined-symbol list) is informational; the
+          * relocation pass resolves through the global symtab anyway. */
+
+         if (!name || !image)
+         {
+            logfmt(LOG_WARNING, "[KMOD] malformed manifest line in %s\n",
+                   path);
+            failed++;
+         }
+         else if (manifest_load_one(name, image, deps) == 0)
+         {
+            loaded++;
+         }
+         else
+         {
+            failed++;
+         }
+      }
+
+      line = next;
+   }
+
+   free(text);
+
+   logfmt(LOG_INFO, "[KMOD] manifest %s: %d loaded, %d failed\n", path,
+          loaded, failed);
+   return failed ? -1 : loaded;
+}
+
 int KMOD_Remove(const char *name)
 {
    int idx = find_index(name);
@@ -1244,6 +1635,62 @@ int KMOD_Remove(const char *name)
    return 0;
 }
 
+/* Return the registry index of a loaded module that lists `name` as a
+ * dependency, or -1 when nothing does. */
+static int find_dependent(const char *name)
+{
+   for (int i = 0; i < LIB_REGISTRY_MAX; i++)
+   {
+      if (s_lib_registry[i].name[0] == '\0' || !extended_data[i].loaded)
+         continue;
+      if (strcmp(s_lib_registry[i].name, name) == 0) continue;
+
+      for (int d = 0; d < extended_data[i].dep_count; d++)
+      {
+         if (strcmp(extended_data[i].deps[d].name, name) == 0) return i;
+      }
+   }
+   return -1;
+}
+
+int KMOD_Unload(const char *name)
+{
+   int idx = find_index(name);
+   if (idx < 0)
+   {
+      logfmt(LOG_ERROR, "[KMOD] Library not found: %s\n", name);
+      return KMOD_ENOTFOUND;
+   }
+
+   LibRecord *lib = &s_lib_registry[idx];
+   ExtendedLibData *ext = &extended_data[idx];
+
+   /* Refuse while another loaded module still links against this one;
+    * its relocations point into the arena we are about to free. */
+   int dependent = find_dependent(lib->name);
+   if (dependent >= 0)
+   {
+      logfmt(LOG_ERROR, "[KMOD] %s is in use by %s\n", lib->name,
+             s_lib_registry[dependent].name);
+      return KMOD_EDEPEND;
+   }
+
+   /* Drop the module's exports before the arena goes away so a lookup
+    * can never hand out an address into freed memory. */
+   symtab_remove_library(lib->name);
+
+   if (lib->base && ext->alloc_size != 0) KMOD_MemoryFree(lib->name);
+
+   logfmt(LOG_INFO, "[KMOD] Unloaded %s\n", lib->name);
+
+   /* Release the registry slot entirely so the name (or another module)
+    * can take it on a later load. */
+   memset(ext, 0, sizeof(*ext));
+   memset(lib, 0, sizeof(*lib));
+
+   return SUCCESS;
+}
+
 void KMOD_MemoryStatus(void)
 {
    if (!kmod_mem_initialized)
@@ -1328,7 +1775,7 @@ int KMOD_Insmod(const char *name, const char *filepath)
 
    if (KMOD_ResolveDependencies(name) < 0)
    {
-      KMOD_Remove(name);
+      KMOD_Unload(name);
       logfmt(LOG_ERROR, "[KMOD] unresolved dependencies for %s\n", name);
       return KMOD_EDEPEND;
    }
@@ -1338,7 +1785,7 @@ int KMOD_Insmod(const char *name, const char *filepath)
    {
       if (KMOD_CallIfExists(name) < 0)
       {
-         KMOD_Remove(name);
+         KMOD_Unload(name);
          logfmt(LOG_ERROR, "[KMOD] module init failed for %s\n", name);
          return KMOD_EINITCALL;
       }
@@ -1355,9 +1802,10 @@ int KMOD_Rmmod(const char *name)
       return -EINVAL;
    }
 
-   if (KMOD_Remove(name) < 0)
+   int rc = KMOD_Unload(name);
+   if (rc != SUCCESS)
    {
-      return KMOD_ENOTFOUND;
+      return rc;
    }
 
    logfmt(LOG_INFO, "[KMOD] removed module %s\n", name);
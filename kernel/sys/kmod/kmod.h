@@ -112,10 +112,17 @@ int KMOD_ApplyKernelRelocations(void);
 // Initialize the kmod memory allocator
 int KMOD_MemoryInitialize(void);
 
-// Allocate memory for a library. Returns allocated address or 0 on failure.
+// Reserve the library's arena up front (one contiguous block the later
+// KMOD_MemoryAllocate calls bump-allocate from).  Loaders that know the
+// full footprint from the ELF headers call this once; without it the
+// first allocation sizes the arena instead.
+int KMOD_ArenaReserve(const char *lib_name, uint32_t size);
+
+// Allocate memory for a library from its arena (bump pointer, 16-byte
+// aligned). Returns allocated address or 0 on failure.
 uint32_t KMOD_MemoryAllocate(const char *lib_name, uint32_t size);
 
-// Deallocate memory for a library. Returns 0 on success, -1 on failure.
+// Release a library's arena as a unit. Returns 0 on success, -1 on failure.
 int KMOD_MemoryFree(const char *lib_name);
 
 // Load a library from disk into memory. Returns 0 on success, -1 on failure.
@@ -127,9 +134,22 @@ int KMOD_LoadFromDisk(const char *name, const char *filepath);
 // Load a library from memory image. Returns 0 on success, -1 on failure.
 int KMOD_Load(const char *name, const void *image, uint32_t size);
 
+// Load every module listed in a build-time manifest (scripts/mkmodorder.py
+// writes one to /usr/lib/kmod.order).  The manifest is topologically
+// ordered with per-module dependency lists precomputed, so boot walks a
+// flat list instead of re-resolving the graph.  Returns the number of
+// modules loaded, 0 if no manifest exists, or -1 if any entry failed.
+int KMOD_LoadManifest(const char *path);
+
 // Remove a library from memory. Returns 0 on success, -1 on failure.
 int KMOD_Remove(const char *name);
 
+// Unload a module completely: refuse while another loaded module depends
+// on it, drop its entries from the global symbol table, release its arena
+// back to the kernel heap, and free the registry slot for reuse.
+// Returns SUCCESS, KMOD_ENOTFOUND, or KMOD_EDEPEND.
+int KMOD_Unload(const char *name);
+
 // Get memory usage statistics
 void KMOD_MemoryStatus(void);
 
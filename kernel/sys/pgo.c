@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/* PGO counter dump for instrumented (Pgo=gen) kernels.
+ *
+ * -fprofile-arcs plants an execution counter on every branch arc and
+ * -fprofile-info-section collects one gcov_info pointer per object
+ * file in the .gcov_info section (bracketed by symbols in linker.ld).
+ * PGO_Dump walks that array at shutdown and streams each object's
+ * profile to /pgo.dump on the FAT root through libgcov's freestanding
+ * serializers (GCC >= 11).
+ *
+ * Harvest on the host, from the directory the kernel was built in:
+ *
+ *    gcov-tool merge-stream < pgo.dump
+ *
+ * which drops the .gcda files next to the object files recorded at
+ * compile time; a rebuild with Pgo=use then consumes them.
+ */
+
+#include "pgo.h"
+
+#ifdef PGO_GEN
+
+#include <fs/fs.h>
+#include <mem/mm_kernel.h>
+#include <std/stdio.h>
+#include <stdint.h>
+
+struct gcov_info;
+
+extern const struct gcov_info *const __gcov_info_start[];
+extern const struct gcov_info *const __gcov_info_end[];
+
+void __gcov_info_to_gcda(const struct gcov_info *info,
+                         void (*filename_fn)(const char *, void *),
+                         void (*dump_fn)(const void *, unsigned, void *),
+                         void *(*allocate_fn)(unsigned, void *), void *arg);
+void __gcov_filename_to_gcfn(const char *filename,
+                             void (*dump_fn)(const void *, unsigned, void *),
+                             void *arg);
+
+typedef struct
+{
+   VFS_File *file;
+   int failed;
+} PgoSink;
+
+static void pgo_dump_bytes(const void *data, unsigned length, void *arg)
+{
+   PgoSink *sink = (PgoSink *)arg;
+   if (sink->failed || length == 0) return;
+   if (VFS_Write(sink->file, length, data) != length) sink->failed = 1;
+}
+
+static void pgo_dump_filename(const char *filename, void *arg)
+{
+   __gcov_filename_to_gcfn(filename, pgo_dump_bytes, arg);
+}
+
+static void *pgo_allocate(unsigned length, void *arg)
+{
+   (void)arg;
+   return kmalloc(length);
+}
+
+void PGO_Dump(void)
+{
+   VFS_File *file = VFS_Create("/pgo.dump", 0644);
+   if (!file) file = VFS_Open("/pgo.dump"); /* Overwrite an old dump */
+   if (!file)
+   {
+      logfmt(LOG_ERROR, "[PGO] cannot create /pgo.dump\n");
+      return;
+   }
+
+   PgoSink sink = {file, 0};
+   uint32_t objects = 0;
+
+   const struct gcov_info *const *info = __gcov_info_start;
+   const struct gcov_info *const *end = __gcov_info_end;
+
+   /* Keep the compiler from assuming the two extern arrays are
+      distinct objects and folding the comparison. */
+   __asm__("" : "+r"(info));
+
+   for (; info != end && !sink.failed; ++info)
+   {
+      __gcov_info_to_gcda(*info, pgo_dump_filename, pgo_dump_bytes,
+                          pgo_allocate, &sink);
+      objects++;
+   }
+
+   VFS_Close(file);
+   DISK_Sync();
+
+   if (sink.failed)
+   {
+      logfmt(LOG_ERROR, "[PGO] short write to /pgo.dump\n");
+   }
+   else
+   {
+      logfmt(LOG_INFO, "[PGO] dumped %u object profiles to /pgo.dump\n",
+             objects);
+   }
+}
+
+#else
+
+/* Stub so callers need no conditional compilation of their own. */
+void PGO_Dump(void) {}
+
+#endif /* PGO_GEN */
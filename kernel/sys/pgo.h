@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef PGO_H
+#define PGO_H
+
+/* Serialize the PGO arc counters of a Pgo=gen kernel to /pgo.dump on
+ * the FAT root, in the stream format `gcov-tool merge-stream` consumes.
+ * Compiled to a stub unless the build defines PGO_GEN; call it right
+ * before shutdown, while interrupts and the VFS are still up. */
+void PGO_Dump(void);
+
+#endif /* PGO_H */
@@ -3,6 +3,7 @@
 #include <sys/valecium.h>
 
 #include "sys.h"
+#include <arch/i686/cpu/smp.h>
 #include <std/stdio.h>
 #include <std/string.h>
 #include <stdint.h>
@@ -31,6 +32,11 @@ void SYS_Initialize()
    cpu_brand[63] = '\0';
    g_SysInfo->arch.arch = arch;
    g_SysInfo->arch.cpu_count = cpu_count;
+
+   /* CPUID only reports logical width; the MP/ACPI tables say how many
+      cores the board actually has. */
+   uint32_t smp_count = i686_SMP_Detect();
+   if (smp_count) g_SysInfo->arch.cpu_count = smp_count;
    /* Detect CPU frequency, cache line size, and feature flags via CPUID */
    uint32_t freq = get_cpu_frequency();
    g_SysInfo->arch.cpu_frequency = freq;
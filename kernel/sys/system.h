@@ -24,6 +24,42 @@ typedef struct
    uint32_t type;     /* 1 = available RAM; anything else = reserved/unusable */
 } __attribute__((packed)) BOOT_MemMapEntry;
 
+/**
+ * BOOT_PartMap - partition map resolved by stage-2 and handed to the
+ * kernel so DISK_Scan can mount without re-reading the MBR.
+ *
+ * Stage-2 already parses the partition tables while hunting for the
+ * corefs volume (boot/common/fs/mbr.c).  It publishes the result at the
+ * fixed physical address BOOT_PARTMAP_ADDR (conventional memory that is
+ * free once the kernel runs).  Multiboot v1 has no tag mechanism for
+ * custom data, so the handshake is magic + checksum at a known address;
+ * a loader that does not publish the map (e.g. GRUB) simply fails the
+ * validation and the kernel falls back to parsing the MBR itself.
+ *
+ * The struct layouts here are the wire format - both sides compile this
+ * verbatim, so any change must touch bootloader and kernel together.
+ */
+#define BOOT_PARTMAP_ADDR 0x00000600u
+#define BOOT_PARTMAP_MAGIC 0x544D5056u /* "VPMT" little-endian */
+#define BOOT_PARTMAP_MAX 8
+
+typedef struct
+{
+   uint8_t drive; /* BIOS drive number (0x80 = first hard disk) */
+   uint8_t type;  /* MBR partition type byte */
+   uint16_t reserved;
+   uint32_t lbaStart;    /* LBA of the first sector */
+   uint32_t sectorCount; /* Partition length in sectors */
+} __attribute__((packed)) BOOT_PartMapEntry;
+
+typedef struct
+{
+   uint32_t magic;    /* BOOT_PARTMAP_MAGIC */
+   uint16_t count;    /* Valid entries (<= BOOT_PARTMAP_MAX) */
+   uint16_t checksum; /* 16-bit byte sum over entries[0..count) */
+   BOOT_PartMapEntry entries[BOOT_PARTMAP_MAX];
+} __attribute__((packed)) BOOT_PartMap;
+
 /**
  * BOOT_Info - Bootloader-agnostic boot parameters.
  *
@@ -39,6 +75,13 @@ typedef struct
    char bootLoaderName[64]; /* Null-terminated bootloader name string */
    uint32_t
        totalMemoryUpper; /* Memory above 1 MB reported by bootloader (KB) */
+   BOOT_PartMapEntry partMap[BOOT_PARTMAP_MAX]; /* Resolved partition map */
+   uint32_t partMapCount; /* 0 = no map published; parse the MBR instead */
+   uint64_t fbAddr;       /* Linear framebuffer physical base; 0 = text mode */
+   uint32_t fbPitch;      /* Framebuffer bytes per scanline */
+   uint32_t fbWidth;      /* Framebuffer width in pixels */
+   uint32_t fbHeight;     /* Framebuffer height in pixels */
+   uint8_t fbBpp;         /* Bits per pixel (direct-RGB modes only) */
 } BOOT_Info;
 
 #endif
\ No newline at end of file
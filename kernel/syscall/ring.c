@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "syscall.h"
+#include <constants.h>
+#include <cpu/process.h>
+#include <fs/fs.h>
+#include <hal/mem.h>
+#include <mem/mm_kernel.h>
+#include <mem/mm_proc.h>
+#include <std/stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Batched-syscall rings
+ *
+ * One page per process, shared with userspace: a sys_ring_header
+ * followed by the SQE and CQE arrays.  The user fills submission
+ * entries and advances sq_tail; sys_ring_enter consumes them, services
+ * each operation synchronously through the FD layer, and posts a
+ * completion per entry, so a batch of small I/O operations pays for a
+ * single ring transition.
+ *
+ * The page is writable by the process, so nothing security-relevant is
+ * trusted from it: entry counts and array offsets are cached in the
+ * Process at setup time and only the free-running index fields are read
+ * back (they are masked before use, so a scribbled index can at worst
+ * corrupt the process's own ring).  Each SQE is snapshotted into kernel
+ * memory before dispatch so it cannot change underneath the checks.
+ */
+
+static sys_ring_sqe *ring_sqes(Process *proc)
+{
+   return (sys_ring_sqe *)((uint8_t *)proc->ring_page +
+                           sizeof(sys_ring_header));
+}
+
+static sys_ring_cqe *ring_cqes(Process *proc)
+{
+   return (sys_ring_cqe *)((uint8_t *)ring_sqes(proc) +
+                           proc->ring_sq_entries * sizeof(sys_ring_sqe));
+}
+
+intptr_t sys_ring_setup(uint32_t entries)
+{
+   Process *proc = Process_GetCurrent();
+   if (!proc) return -EINVAL;
+   if (proc->ring_page) return -EINVAL; // One ring per process
+
+   if (entries == 0 || entries > RING_MAX_SQ_ENTRIES) return -EINVAL;
+
+   /* Round up to a power of two so the indices mask cheaply; the
+      completion ring gets twice the depth so completions never stall
+      a full submission batch.  Worst case fits the page comfortably:
+      32 + 64*32 + 128*8 = 3104 bytes. */
+   uint32_t sq_entries = 1;
+   while (sq_entries < entries) sq_entries <<= 1;
+   uint32_t cq_entries = sq_entries * 2;
+
+   ProcessMapping *m = NULL;
+   for (int i = 0; i < PROCESS_MAX_MAPPINGS; ++i)
+   {
+      if (!proc->mappings[i].used)
+      {
+         m = &proc->mappings[i];
+         break;
+      }
+   }
+   if (!m) return -ENOMEM;
+
+   uint32_t page_flags = HAL_PAGE_USER | HAL_PAGE_RW;
+   void *va = VMM_AllocateInDir(proc->page_directory, NULL, PAGE_SIZE,
+                                page_flags);
+   if (!va) return -ENOMEM;
+
+   uint32_t phys = VMM_GetPhysInDir(proc->page_directory, (uint32_t)va);
+   if (phys == 0)
+   {
+      VMM_FreeInDir(proc->page_directory, va, PAGE_SIZE);
+      return -ENOMEM;
+   }
+
+   /* Carrying the page in mappings[] makes teardown free: exec and exit
+      already release every used mapping. */
+   m->start = (uint32_t)va;
+   m->length = PAGE_SIZE;
+   m->page_flags = page_flags | HAL_PAGE_PRESENT;
+   m->file_backed = false;
+   m->file = NULL;
+   m->path[0] = '\0';
+   m->used = true;
+
+   proc->ring_page = (void *)phys; // Kernel view via the identity map
+   proc->ring_sq_entries = sq_entries;
+   proc->ring_cq_entries = cq_entries;
+
+   /* The frame arrived zeroed, so all indices start at 0. */
+   sys_ring_header *hdr = (sys_ring_header *)proc->ring_page;
+   hdr->sq_entries = sq_entries;
+   hdr->cq_entries = cq_entries;
+   hdr->sqe_offset = sizeof(sys_ring_header);
+   hdr->cqe_offset = hdr->sqe_offset + sq_entries * sizeof(sys_ring_sqe);
+
+   logfmt(LOG_INFO, "[RING] pid %u: %u-entry submission ring at 0x%x\n",
+          proc->pid, sq_entries, (uint32_t)va);
+   return (intptr_t)va;
+}
+
+/* Service one snapshotted submission entry.  Buffer and path pointers
+   come from user memory, so they get the same validation the plain
+   syscalls apply before reaching the FD layer. */
+static int32_t ring_execute(Process *proc, const sys_ring_sqe *sqe)
+{
+   switch (sqe->opcode)
+   {
+   case RING_OP_NOP:
+      return SUCCESS;
+
+   case RING_OP_READ:
+      if (user_range_ok((const void *)sqe->addr, sqe->len) != SUCCESS)
+         return -EFAULT;
+      return FD_Read(proc, sqe->fd, (void *)sqe->addr, sqe->len);
+
+   case RING_OP_WRITE:
+      if (user_range_ok((const void *)sqe->addr, sqe->len) != SUCCESS)
+         return -EFAULT;
+      return FD_Write(proc, sqe->fd, (const void *)sqe->addr, sqe->len);
+
+   case RING_OP_OPEN:
+      if (user_range_ok((const void *)sqe->addr, 1) != SUCCESS)
+         return -EFAULT;
+      return FD_Open(proc, (const char *)sqe->addr, (int)sqe->flags,
+                     sqe->mode);
+
+   case RING_OP_CLOSE:
+      return FD_Close(proc, sqe->fd);
+
+   default:
+      return -EINVAL;
+   }
+}
+
+intptr_t sys_ring_enter(uint32_t to_submit)
+{
+   Process *proc = Process_GetCurrent();
+   if (!proc || !proc->ring_page) return -EINVAL;
+
+   sys_ring_header *hdr = (sys_ring_header *)proc->ring_page;
+   sys_ring_sqe *sqes = ring_sqes(proc);
+   sys_ring_cqe *cqes = ring_cqes(proc);
+   uint32_t sq_mask = proc->ring_sq_entries - 1;
+   uint32_t cq_mask = proc->ring_cq_entries - 1;
+
+   uint32_t head = hdr->sq_head;
+   uint32_t tail = hdr->sq_tail;
+   if (tail - head > proc->ring_sq_entries) return -EINVAL;
+
+   uint32_t done = 0;
+   while (done < to_submit && head != tail)
+   {
+      /* Stop rather than overwrite unread completions; the user drains
+         the CQ and calls back in. */
+      if (hdr->cq_tail - hdr->cq_head >= proc->ring_cq_entries) break;
+
+      sys_ring_sqe sqe = sqes[head & sq_mask];
+      int32_t res = ring_execute(proc, &sqe);
+
+      sys_ring_cqe *cqe = &cqes[hdr->cq_tail & cq_mask];
+      cqe->user_data = sqe.user_data;
+      cqe->res = res;
+      hdr->cq_tail++; // Publish after the payload is in place
+
+      head++;
+      hdr->sq_head = head;
+      done++;
+   }
+   return (intptr_t)done;
+}
@@ -2,11 +2,21 @@
 
 #include "syscall.h"
 #include <constants.h>
+#include <cpu/futex.h>
 #include <cpu/process.h>
+#include <cpu/scheduler.h>
+#include <cpu/timer.h>
 #include <fs/fs.h>
+#include <fs/pipe/pipe.h>
 #include <hal/scheduler.h>
 #include <mem/mm_proc.h>
+#include <net/net.h>
+#include <signal/signal.h>
 #include <std/stdio.h>
+#include <std/string.h>
+#include <std/trace.h>
+#include <sys/cmdline.h>
+#include <sys/sys.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -15,6 +25,72 @@ static inline Process *get_current_process(void)
    return Process_GetCurrent();
 }
 
+/* -------------------------------------------------------------------------
+ * Optional syscall profiling (boot with "syscall_prof" to enable)
+ *
+ * Counts invocations and accumulates rdtsc cycles per syscall number
+ * into a static table; /dev/kstat renders it as text.  When the flag
+ * is absent the dispatcher pays a single branch.
+ * ---------------------------------------------------------------------- */
+
+#define SYSCALL_PROF_MAX 256
+
+typedef struct
+{
+   uint64_t calls;
+   uint64_t cycles;
+} SyscallProfEntry;
+
+static bool g_SyscallProfEnabled = false;
+static SyscallProfEntry g_SyscallProf[SYSCALL_PROF_MAX];
+
+static inline uint64_t syscall_prof_rdtsc(void)
+{
+   uint32_t lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((uint64_t)hi << 32) | lo;
+}
+
+void Syscall_ProfileInitialize(void)
+{
+   if (CmdLine_GetBool(CMDLINE_OPT_SYSCALL_PROF))
+   {
+      g_SyscallProfEnabled = true;
+      logfmt(LOG_INFO, "[SYSCALL] profiling enabled\n");
+   }
+}
+
+uint32_t Syscall_ProfileRead(uint32_t offset, uint32_t size, void *buffer)
+{
+   static char text[4096];
+   uint32_t len = 0;
+
+   for (uint32_t num = 0; num < SYSCALL_PROF_MAX; num++)
+   {
+      const SyscallProfEntry *e = &g_SyscallProf[num];
+      if (e->calls == 0) continue;
+
+      int n = snprintf(text + len, sizeof(text) - len,
+                       "num=%u calls=%llu cycles=%llu\n", num, e->calls,
+                       e->cycles);
+      if (n < 0) break;
+      if (len + (uint32_t)n >= sizeof(text))
+      {
+         len = sizeof(text) - 1;
+         break;
+      }
+      len += (uint32_t)n;
+   }
+
+   if (offset >= len) return 0;
+
+   uint32_t avail = len - offset;
+   if (avail > size) avail = size;
+   memcpy((uint8_t *)buffer, text + offset, avail);
+
+   return avail;
+}
+
 static inline intptr_t map_exec_error(int exec_result)
 {
    if (exec_result == -2) return -ENOENT;
@@ -62,12 +138,48 @@ intptr_t sys_close(int fd)
    return FD_Close(proc, fd);
 }
 
+intptr_t sys_dup(int oldfd)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return FD_Dup(proc, oldfd);
+}
+
+intptr_t sys_dup2(int oldfd, int newfd)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return FD_Dup2(proc, oldfd, newfd);
+}
+
+intptr_t sys_pipe(int *fds)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   int kfds[2];
+   intptr_t rc = FD_Pipe(proc, kfds);
+   if (rc < 0) return rc;
+
+   if (copy_to_user(fds, kfds, sizeof(kfds)) != SUCCESS)
+   {
+      FD_Close(proc, kfds[0]);
+      FD_Close(proc, kfds[1]);
+      return -EFAULT;
+   }
+   return rc;
+}
+
+// The bulk-data paths validate the whole user range once (three
+// comparisons) and then stream directly - no per-byte checking cost.
 intptr_t sys_read(int fd, void *buf, uint32_t count)
 {
    Process *proc = get_current_process();
    if (!proc) return -1;
+   if (user_range_ok(buf, count) != SUCCESS) return -EFAULT;
 
-   // logfmt(LOG_FATAL, "[SYSCALL] %d\n", fd);
    return FD_Read(proc, fd, buf, count);
 }
 
@@ -75,10 +187,128 @@ intptr_t sys_write(int fd, const void *buf, uint32_t count)
 {
    Process *proc = get_current_process();
    if (!proc) return -1;
+   if (user_range_ok(buf, count) != SUCCESS) return -EFAULT;
 
    return FD_Write(proc, fd, buf, count);
 }
 
+// Scatter-gather read/write: sys_iovec matches FD_IoVec field for field,
+// so the table is handed through without copying once each segment's
+// range has been validated
+static intptr_t iovec_ranges_ok(const sys_iovec *iov, int iovcnt)
+{
+   if (iovcnt < 0) return -EINVAL;
+   if (user_range_ok(iov, (uint32_t)iovcnt * sizeof(*iov)) != SUCCESS)
+      return -EFAULT;
+
+   for (int i = 0; i < iovcnt; ++i)
+   {
+      if (user_range_ok(iov[i].iov_base, iov[i].iov_len) != SUCCESS)
+         return -EFAULT;
+   }
+   return SUCCESS;
+}
+
+intptr_t sys_readv(int fd, const sys_iovec *iov, int iovcnt)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   intptr_t rc = iovec_ranges_ok(iov, iovcnt);
+   if (rc != SUCCESS) return rc;
+
+   return FD_Readv(proc, fd, (const FD_IoVec *)iov, iovcnt);
+}
+
+intptr_t sys_writev(int fd, const sys_iovec *iov, int iovcnt)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   intptr_t rc = iovec_ranges_ok(iov, iovcnt);
+   if (rc != SUCCESS) return rc;
+
+   return FD_Writev(proc, fd, (const FD_IoVec *)iov, iovcnt);
+}
+
+// Multi-descriptor readiness wait: sys_pollfd matches FD_PollFd field
+// for field, so the table is handed through without copying
+intptr_t sys_poll(sys_pollfd *fds, uint32_t nfds, int timeout_ms)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+   if (user_range_ok(fds, nfds * sizeof(*fds)) != SUCCESS) return -EFAULT;
+
+   return FD_Poll(proc, (FD_PollFd *)fds, nfds, timeout_ms);
+}
+
+// Stat syscalls: metadata comes from VFS_Stat, which the filesystems
+// serve from their dentry and metadata-index caches where warm
+static void stat_fill(sys_stat_t *buf, const VFS_StatInfo *info)
+{
+   buf->st_size = info->size;
+   buf->st_mode = info->mode;
+   buf->st_uid = info->uid;
+   buf->st_gid = info->gid;
+   buf->st_isdir = info->is_directory ? 1 : 0;
+}
+
+intptr_t sys_stat(const char *path, sys_stat_t *buf)
+{
+   if (!path || !buf) return -EINVAL;
+
+   VFS_StatInfo info;
+   int rc = VFS_Stat(path, &info);
+   if (rc < 0) return rc;
+
+   sys_stat_t tmp;
+   stat_fill(&tmp, &info);
+   return copy_to_user(buf, &tmp, sizeof(tmp));
+}
+
+intptr_t sys_fstat(int fd, sys_stat_t *buf)
+{
+   Process *proc = get_current_process();
+   if (!proc || !buf) return -EINVAL;
+
+   FileDescriptor *file = FD_Get(proc, fd);
+   if (!file) return -EBADF;
+
+   sys_stat_t tmp;
+   if (file->pipe)
+   {
+      /* Pipes have no backing path; report the bytes in flight. */
+      memset(&tmp, 0, sizeof(tmp));
+      tmp.st_size = ((Pipe *)file->pipe)->count;
+      return copy_to_user(buf, &tmp, sizeof(tmp));
+   }
+
+   VFS_StatInfo info;
+   int rc = VFS_Stat(file->path, &info);
+   if (rc < 0) return rc;
+
+   stat_fill(&tmp, &info);
+   return copy_to_user(buf, &tmp, sizeof(tmp));
+}
+
+intptr_t sys_ioctl(int fd, uint32_t cmd, void *arg)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return FD_Ioctl(proc, fd, cmd, arg);
+}
+
+// Bulk directory listing: each record in buf is an FD_Dirent
+intptr_t sys_getdents(int fd, void *buf, uint32_t count)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+   if (user_range_ok(buf, count) != SUCCESS) return -EFAULT;
+
+   return FD_GetDents(proc, fd, buf, count);
+}
+
 intptr_t sys_lseek(int fd, int32_t offset, int whence)
 {
    Process *proc = get_current_process();
@@ -105,6 +335,243 @@ intptr_t sys_chown(const char *path, uint32_t uid, uint32_t gid)
    return VFS_Chown(path, uid, gid);
 }
 
+intptr_t sys_sync(void)
+{
+   /* Flush every dirty sector parked in the block cache to its device. */
+   return DISK_Sync();
+}
+
+intptr_t sys_nanosleep(const sys_timespec *req, sys_timespec *rem)
+{
+   if (!req) return -EINVAL;
+
+   sys_timespec kreq;
+   if (copy_from_user(&kreq, req, sizeof(kreq)) != SUCCESS) return -EFAULT;
+   if (kreq.tv_sec < 0 || kreq.tv_nsec < 0 || kreq.tv_nsec >= 1000000000)
+      return -EINVAL;
+
+   uint32_t ms = (uint32_t)kreq.tv_sec * 1000u +
+                 (uint32_t)(kreq.tv_nsec / 1000000);
+   Timer_SleepMs(ms);
+
+   /* Sleeps are not interruptible by signals yet, so the full interval
+    * always elapses; pending signals are taken on the way back out. */
+   if (rem)
+   {
+      sys_timespec zero = {0, 0};
+      return copy_to_user(rem, &zero, sizeof(zero));
+   }
+   return 0;
+}
+
+intptr_t sys_clock_gettime(uint32_t clock_id, sys_timespec *tp)
+{
+   if (!tp) return -EINVAL;
+
+   switch (clock_id)
+   {
+   case CLOCK_MONOTONIC:
+   case CLOCK_MONOTONIC_RAW:
+   {
+      /* No NTP-style slewing exists, so RAW and MONOTONIC coincide. */
+      uint64_t ns = Timer_GetMonotonicNs();
+      sys_timespec ts;
+      ts.tv_sec = (int32_t)(ns / 1000000000u);
+      ts.tv_nsec = (int32_t)(ns % 1000000000u);
+      return copy_to_user(tp, &ts, sizeof(ts));
+   }
+   default:
+      /* CLOCK_REALTIME included: there is no RTC driver to anchor it. */
+      return -EINVAL;
+   }
+}
+
+intptr_t sys_mmap(void *addr, uint32_t length, uint32_t prot, uint32_t flags,
+                  int fd, uint32_t offset)
+{
+   (void)addr; /* Placement hints are not honoured */
+
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return Process_Mmap(proc, length, prot, flags, fd, offset);
+}
+
+intptr_t sys_munmap(void *addr, uint32_t length)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return Process_Munmap(proc, (uint32_t)addr, length);
+}
+
+// Shared memory: create (or look up by key) a segment, and map one
+// into the caller.  Detach is an ordinary munmap of the returned range.
+intptr_t sys_shm_create(int32_t key, uint32_t size)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return SHM_Create(key, size);
+}
+
+intptr_t sys_shm_attach(int id)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return SHM_Attach(proc, id);
+}
+
+// Futex: sleep while *uaddr holds val / wake up to val sleepers.  The
+// uncontended user-space fast path never reaches this handler.
+intptr_t sys_futex(uint32_t *uaddr, int op, uint32_t val)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+   if (user_range_ok(uaddr, sizeof(*uaddr)) != SUCCESS) return -EFAULT;
+
+   switch (op)
+   {
+   case FUTEX_WAIT:
+      return Futex_Wait(proc, uaddr, val);
+   case FUTEX_WAKE:
+      return Futex_Wake(proc, uaddr, val);
+   default:
+      return -EINVAL;
+   }
+}
+
+// UDP datagram out: the stack builds the frame in the NIC's descriptor
+// buffer, so the payload is copied once.
+intptr_t sys_sendto(const void *buf, uint32_t len, const sys_sockaddr *dest,
+                    uint16_t src_port)
+{
+   if (!buf || !dest) return -EINVAL;
+   if (user_range_ok(buf, len) != SUCCESS) return -EFAULT;
+
+   sys_sockaddr kdest;
+   if (copy_from_user(&kdest, dest, sizeof(kdest)) != SUCCESS)
+      return -EFAULT;
+
+   return Net_UdpSend(kdest.sin_addr, kdest.sin_port, src_port, buf, len);
+}
+
+// UDP datagram in: first call binds the port, then blocks for data.
+intptr_t sys_recvfrom(uint16_t port, void *buf, uint32_t len,
+                      sys_sockaddr *src)
+{
+   uint32_t src_ip = 0;
+   uint16_t src_port = 0;
+
+   if (user_range_ok(buf, len) != SUCCESS) return -EFAULT;
+
+   int rc = Net_UdpRecv(port, buf, len, &src_ip, &src_port);
+   if (rc < 0) return rc;
+
+   if (src)
+   {
+      sys_sockaddr ksrc;
+      ksrc.sin_addr = src_ip;
+      ksrc.sin_port = src_port;
+      if (copy_to_user(src, &ksrc, sizeof(ksrc)) != SUCCESS) return -EFAULT;
+   }
+   return rc;
+}
+
+/* Tracepoint control: flip per-site enable bits at runtime.  Root
+ * only - the rings expose kernel addresses and timing. */
+intptr_t sys_tracectl(int op, uint32_t mask)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+   if (proc->euid != 0) return -EACCES;
+
+   switch (op)
+   {
+   case TRACECTL_GET:
+      return (intptr_t)Trace_GetMask();
+   case TRACECTL_ENABLE:
+      Trace_SetMask(Trace_GetMask() | mask);
+      return SUCCESS;
+   case TRACECTL_DISABLE:
+      Trace_SetMask(Trace_GetMask() & ~mask);
+      return SUCCESS;
+   case TRACECTL_SET:
+      Trace_SetMask(mask);
+      return SUCCESS;
+   default:
+      return -EINVAL;
+   }
+}
+
+// Signal syscalls: thin wrappers over the kernel/signal back-ends
+intptr_t sys_kill(int32_t pid, int signum)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   return Signal_Kill(proc, pid, signum);
+}
+
+intptr_t sys_sigaction(int signum, uintptr_t handler, uintptr_t *old_handler)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   uintptr_t old = 0;
+   intptr_t rc = Signal_SetAction(proc, signum, handler,
+                                  old_handler ? &old : NULL);
+   if (rc != SUCCESS) return rc;
+
+   if (old_handler && copy_to_user(old_handler, &old, sizeof(old)) != SUCCESS)
+      return -EFAULT;
+   return rc;
+}
+
+intptr_t sys_sigprocmask(int how, const uint32_t *set, uint32_t *old_set)
+{
+   Process *proc = get_current_process();
+   if (!proc) return -1;
+
+   uint32_t old_mask = proc->signal_mask;
+
+   /* A NULL set queries the current mask without changing it. */
+   if (set)
+   {
+      uint32_t new_mask;
+      if (copy_from_user(&new_mask, set, sizeof(new_mask)) != SUCCESS)
+         return -EFAULT;
+
+      intptr_t rc = Signal_SetMask(proc, how, new_mask, &old_mask);
+      if (rc != SUCCESS) return rc;
+   }
+
+   if (old_set && copy_to_user(old_set, &old_mask, sizeof(old_mask)) != SUCCESS)
+      return -EFAULT;
+   return SUCCESS;
+}
+
+intptr_t sys_sigreturn(Registers *regs)
+{
+   Process *proc = get_current_process();
+   if (!proc || !regs) return -1;
+
+   intptr_t rc = -EINVAL;
+   if (g_HalSignalOperations && g_HalSignalOperations->Sigreturn)
+      rc = g_HalSignalOperations->Sigreturn(proc, regs);
+
+   if (rc < 0)
+   {
+      /* The frame on the user stack is gone or corrupt, so there is no
+       * context left to resume - the process cannot continue. */
+      Process_Exit(proc, 128 + SIGSEGV);
+      if (g_HalSchedulerOperations && g_HalSchedulerOperations->ContextSwitch)
+         g_HalSchedulerOperations->ContextSwitch();
+   }
+   return rc;
+}
+
 intptr_t sys_fork(const Registers *regs)
 {
    Process *parent = get_current_process();
@@ -193,15 +660,109 @@ intptr_t Syscall_SetGid(uint32_t gid)
    return Process_SetGid(proc, gid);
 }
 
-intptr_t Syscall_Wait4(int32_t pid, int *status, int options, void *rusage)
+/* Convert an accumulated tick count to a timespec (PIT runs at
+   TIMER_HZ, so one tick is 1e9/TIMER_HZ nanoseconds). */
+static sys_timespec ticks_to_timespec(uint64_t ticks)
 {
-   (void)rusage;
+   sys_timespec ts;
+   ts.tv_sec = (int32_t)(ticks / TIMER_HZ);
+   ts.tv_nsec = (int32_t)((ticks % TIMER_HZ) * (1000000000u / TIMER_HZ));
+   return ts;
+}
 
+intptr_t Syscall_Wait4(int32_t pid, int *status, int options, void *rusage)
+{
    Process *proc = get_current_process();
    if (!proc) return -1;
 
    if (options != 0) return -EINVAL;
-   return Process_Wait(proc, pid, status, options);
+
+   int kstatus = 0;
+   intptr_t rc = Process_Wait(proc, pid, status ? &kstatus : NULL, options);
+   if (rc < 0) return rc;
+
+   if (status && copy_to_user(status, &kstatus, sizeof(kstatus)) != SUCCESS)
+      return -EFAULT;
+
+   if (rusage)
+   {
+      /* Process_Wait captured the reaped child's CPU times before
+         destroying it. */
+      sys_rusage usage;
+      usage.ru_utime = ticks_to_timespec(proc->reaped_user_ticks);
+      usage.ru_stime = ticks_to_timespec(proc->reaped_system_ticks);
+      if (copy_to_user(rusage, &usage, sizeof(usage)) != SUCCESS)
+         return -EFAULT;
+   }
+   return rc;
+}
+
+/* Mapped extent of a process in KB.  No swap exists, so everything
+   mapped is resident once touched; this over-counts only pages that
+   were never faulted in. */
+static uint32_t procinfo_rss_kb(const Process *proc)
+{
+   uint32_t bytes = 0;
+
+   for (uint32_t s = 0; s < proc->segment_count; ++s)
+      bytes += proc->segments[s].memsz;
+
+   if (proc->heap_end > proc->heap_start)
+      bytes += proc->heap_end - proc->heap_start;
+   if (proc->stack_end > proc->stack_start)
+      bytes += proc->stack_end - proc->stack_start;
+
+   for (uint32_t m = 0; m < PROCESS_MAX_MAPPINGS; ++m)
+   {
+      if (proc->mappings[m].used) bytes += proc->mappings[m].length;
+   }
+
+   return bytes / 1024u;
+}
+
+intptr_t sys_procinfo(sys_procinfo_t *buf, uint32_t max)
+{
+   if (!buf || max == 0) return -EINVAL;
+
+   /* One pass over the scheduler table fills the caller's whole array,
+      so a monitor costs a single trap per refresh instead of one per
+      process. */
+   uint32_t written = 0;
+   uint32_t slots = Scheduler_GetProcessCount();
+   for (uint32_t i = 0; i < slots && written < max; ++i)
+   {
+      Process *proc = Scheduler_GetProcessAt(i);
+      if (!proc) continue;
+
+      sys_procinfo_t rec;
+      memset(&rec, 0, sizeof(rec));
+      rec.pid = proc->pid;
+      rec.ppid = proc->ppid;
+      rec.state = proc->state;
+      rec.priority = proc->priority;
+      rec.sched_class = proc->sched_class;
+      rec.rss_kb = procinfo_rss_kb(proc);
+      rec.cpu_user_ms = proc->cpu_user_ticks * 1000u / TIMER_HZ;
+      rec.cpu_system_ms = proc->cpu_system_ticks * 1000u / TIMER_HZ;
+
+      /* Basename of the exec path; kernel threads have no binary. */
+      const char *name = proc->kernel_mode ? "[kernel]" : "?";
+      if (proc->exec_path[0] != '\0')
+      {
+         name = proc->exec_path;
+         for (const char *p = proc->exec_path; *p != '\0'; ++p)
+         {
+            if (*p == '/' && p[1] != '\0') name = p + 1;
+         }
+      }
+      strncpy(rec.name, name, PROCINFO_NAME_MAX - 1);
+
+      if (copy_to_user(&buf[written], &rec, sizeof(rec)) != SUCCESS)
+         return -EFAULT;
+      written++;
+   }
+
+   return (intptr_t)written;
 }
 
 /* Generic syscall dispatcher
@@ -214,7 +775,8 @@ intptr_t syscall(uint32_t syscall_num, uint32_t *args)
    return syscall_dispatch(syscall_num, args, NULL);
 }
 
-intptr_t syscall_dispatch(uint32_t syscall_num, uint32_t *args, Registers *regs)
+static intptr_t syscall_invoke(uint32_t syscall_num, uint32_t *args,
+                               Registers *regs)
 {
    switch (syscall_num)
    {
@@ -262,23 +824,147 @@ intptr_t syscall_dispatch(uint32_t syscall_num, uint32_t *args, Registers *regs)
    case SYS_CLOSE:
       return sys_close(args[0]);
 
+   case SYS_DUP:
+      return sys_dup(args[0]);
+
+   case SYS_DUP2:
+      return sys_dup2(args[0], args[1]);
+
+   case SYS_PIPE:
+      return sys_pipe((int *)args[0]);
+
    case SYS_READ:
       return sys_read(args[0], (void *)args[1], args[2]);
 
    case SYS_WRITE:
       return sys_write(args[0], (const void *)args[1], args[2]);
 
+   case SYS_READV:
+      return sys_readv(args[0], (const sys_iovec *)args[1], (int)args[2]);
+
+   case SYS_WRITEV:
+      return sys_writev(args[0], (const sys_iovec *)args[1], (int)args[2]);
+
    case SYS_LSEEK:
       return sys_lseek(args[0], (int32_t)args[1], args[2]);
 
+   case SYS_POLL:
+      return sys_poll((sys_pollfd *)args[0], args[1], (int)args[2]);
+
+   case SYS_IOCTL:
+      return sys_ioctl((int)args[0], args[1], (void *)args[2]);
+
+   case SYS_STAT:
+      return sys_stat((const char *)args[0], (sys_stat_t *)args[1]);
+
+   case SYS_FSTAT:
+      return sys_fstat((int)args[0], (sys_stat_t *)args[1]);
+
+   case SYS_GETDENTS:
+      return sys_getdents((int)args[0], (void *)args[1], args[2]);
+
    case SYS_CHMOD:
       return sys_chmod((const char *)args[0], (uint16_t)args[1]);
 
    case SYS_CHOWN:
       return sys_chown((const char *)args[0], args[1], args[2]);
 
+   case SYS_SYNC:
+      return sys_sync();
+
+   case SYS_MMAP:
+      return sys_mmap((void *)args[0], args[1], args[2], args[3],
+                      (int)args[4], args[5]);
+
+   case SYS_MUNMAP:
+      return sys_munmap((void *)args[0], args[1]);
+
+   case SYS_SHM_CREATE:
+      return sys_shm_create((int32_t)args[0], args[1]);
+
+   case SYS_SHM_ATTACH:
+      return sys_shm_attach((int)args[0]);
+
+   case SYS_PROCINFO:
+      return sys_procinfo((sys_procinfo_t *)args[0], args[1]);
+
+   case SYS_FUTEX:
+      return sys_futex((uint32_t *)args[0], (int)args[1], args[2]);
+
+   case SYS_SENDTO:
+      return sys_sendto((const void *)args[0], args[1],
+                        (const sys_sockaddr *)args[2], (uint16_t)args[3]);
+
+   case SYS_RECVFROM:
+      return sys_recvfrom((uint16_t)args[0], (void *)args[1], args[2],
+                          (sys_sockaddr *)args[3]);
+
+   case SYS_KILL:
+      return sys_kill((int32_t)args[0], (int)args[1]);
+
+   case SYS_SIGACTION:
+      return sys_sigaction((int)args[0], (uintptr_t)args[1],
+                           (uintptr_t *)args[2]);
+
+   case SYS_SIGPROCMASK:
+      return sys_sigprocmask((int)args[0], (const uint32_t *)args[1],
+                             (uint32_t *)args[2]);
+
+   case SYS_SIGRETURN:
+      return sys_sigreturn(regs);
+
+   case SYS_TRACECTL:
+      return sys_tracectl((int)args[0], args[1]);
+
+   case SYS_NANOSLEEP:
+      return sys_nanosleep((const sys_timespec *)args[0],
+                           (sys_timespec *)args[1]);
+
+   case SYS_CLOCK_GETTIME:
+      return sys_clock_gettime(args[0], (sys_timespec *)args[1]);
+
+   case SYS_RING_SETUP:
+      return sys_ring_setup(args[0]);
+
+   case SYS_RING_ENTER:
+      return sys_ring_enter(args[0]);
+
    default:
       logfmt(LOG_ERROR, "[SYSCALL] unknown syscall %u\n", syscall_num);
       return -1;
    }
 }
+
+intptr_t syscall_dispatch(uint32_t syscall_num, uint32_t *args, Registers *regs)
+{
+   TRACE_EVENT(TRACE_EV_SYSCALL, syscall_num);
+
+   /* Mark the process as inside a syscall so timer ticks that land
+      here are charged to system time (see Timer_Tick). */
+   Process *proc = get_current_process();
+   if (proc) proc->syscall_depth++;
+
+   intptr_t result;
+   if (!g_SyscallProfEnabled)
+   {
+      result = syscall_invoke(syscall_num, args, regs);
+   }
+   else
+   {
+      uint64_t start = syscall_prof_rdtsc();
+      result = syscall_invoke(syscall_num, args, regs);
+
+      if (syscall_num < SYSCALL_PROF_MAX)
+      {
+         g_SyscallProf[syscall_num].calls++;
+         g_SyscallProf[syscall_num].cycles += syscall_prof_rdtsc() - start;
+      }
+   }
+
+   /* exit/execve may not return through here for the original process;
+      re-fetch rather than trusting the saved pointer. */
+   proc = get_current_process();
+   if (proc && proc->syscall_depth > 0) proc->syscall_depth--;
+
+   return result;
+}
@@ -58,12 +58,243 @@
 #ifndef SYS_LSEEK
 #define SYS_LSEEK 19
 #endif
+#ifndef SYS_READV
+#define SYS_READV 145
+#endif
+#ifndef SYS_WRITEV
+#define SYS_WRITEV 146
+#endif
 #ifndef SYS_CHMOD
 #define SYS_CHMOD 15
 #endif
 #ifndef SYS_CHOWN
 #define SYS_CHOWN 182
 #endif
+#ifndef SYS_SYNC
+#define SYS_SYNC 36
+#endif
+#ifndef SYS_NANOSLEEP
+#define SYS_NANOSLEEP 162
+#endif
+#ifndef SYS_CLOCK_GETTIME
+#define SYS_CLOCK_GETTIME 265
+#endif
+#ifndef SYS_MMAP
+#define SYS_MMAP 90
+#endif
+#ifndef SYS_MUNMAP
+#define SYS_MUNMAP 91
+#endif
+#ifndef SYS_DUP
+#define SYS_DUP 41
+#endif
+#ifndef SYS_DUP2
+#define SYS_DUP2 63
+#endif
+#ifndef SYS_PIPE
+#define SYS_PIPE 42
+#endif
+#ifndef SYS_KILL
+#define SYS_KILL 37
+#endif
+#ifndef SYS_SIGACTION
+#define SYS_SIGACTION 67
+#endif
+#ifndef SYS_SIGPROCMASK
+#define SYS_SIGPROCMASK 126
+#endif
+#ifndef SYS_SIGRETURN
+#define SYS_SIGRETURN 119
+#endif
+#ifndef SYS_TRACECTL
+#define SYS_TRACECTL 201
+#endif
+#ifndef SYS_POLL
+#define SYS_POLL 168
+#endif
+#ifndef SYS_IOCTL
+#define SYS_IOCTL 54
+#endif
+#ifndef SYS_STAT
+#define SYS_STAT 106
+#endif
+#ifndef SYS_FSTAT
+#define SYS_FSTAT 108
+#endif
+#ifndef SYS_GETDENTS
+#define SYS_GETDENTS 141
+#endif
+#ifndef SYS_SHM_CREATE
+#define SYS_SHM_CREATE 202
+#endif
+#ifndef SYS_SHM_ATTACH
+#define SYS_SHM_ATTACH 203
+#endif
+#ifndef SYS_PROCINFO
+#define SYS_PROCINFO 204
+#endif
+#ifndef SYS_FUTEX
+#define SYS_FUTEX 240
+#endif
+#ifndef SYS_SENDTO
+#define SYS_SENDTO 369
+#endif
+#ifndef SYS_RECVFROM
+#define SYS_RECVFROM 371
+#endif
+#ifndef SYS_RING_SETUP
+#define SYS_RING_SETUP 425
+#endif
+#ifndef SYS_RING_ENTER
+#define SYS_RING_ENTER 426
+#endif
+
+/* tracectl operations */
+#define TRACECTL_GET 0
+#define TRACECTL_ENABLE 1
+#define TRACECTL_DISABLE 2
+#define TRACECTL_SET 3
+
+/* mmap protection and flag bits shared with userspace */
+#define PROT_NONE 0x0
+#define PROT_READ 0x1
+#define PROT_WRITE 0x2
+#define PROT_EXEC 0x4
+
+#define MAP_SHARED 0x01
+#define MAP_PRIVATE 0x02
+#define MAP_ANONYMOUS 0x20
+
+#define MAP_FAILED ((void *)-1)
+
+/* Clock ids for clock_gettime.  No RTC driver exists, so only the
+ * monotonic clocks are served; CLOCK_REALTIME is rejected. */
+#define CLOCK_MONOTONIC 1
+#define CLOCK_MONOTONIC_RAW 4
+
+/* Minimal timespec layout shared with userspace (no libc headers here). */
+typedef struct
+{
+   int32_t tv_sec;
+   int32_t tv_nsec;
+} sys_timespec;
+
+/* Minimal iovec layout shared with userspace (readv/writev segments). */
+typedef struct
+{
+   void *iov_base;
+   uint32_t iov_len;
+} sys_iovec;
+
+/* Minimal stat layout shared with userspace (fixed-width fields). */
+typedef struct
+{
+   uint32_t st_size;
+   uint32_t st_mode;
+   uint32_t st_uid;
+   uint32_t st_gid;
+   uint32_t st_isdir;
+} sys_stat_t;
+
+/* Minimal socket address shared with userspace (UDP endpoints; both
+ * fields host byte order). */
+typedef struct
+{
+   uint32_t sin_addr;
+   uint16_t sin_port;
+} sys_sockaddr;
+
+/* Minimal rusage layout shared with userspace (CPU times only, as
+ * timespecs - this kernel has no timeval).  Filled by wait4 from the
+ * reaped child's per-process tick accounting. */
+typedef struct
+{
+   sys_timespec ru_utime;
+   sys_timespec ru_stime;
+} sys_rusage;
+
+/* Minimal per-process record shared with userspace (SYS_PROCINFO).
+ * One call copies the whole process table so monitoring costs a single
+ * trap per refresh instead of one per process.  CPU times are converted
+ * from PIT ticks to milliseconds in the kernel so userspace needs no
+ * knowledge of TIMER_HZ; rss_kb sums the mapped extent of the exec
+ * segments, heap, stack and mmap regions (there is no swap, so mapped
+ * memory is resident once touched). */
+#define PROCINFO_NAME_MAX 32
+
+typedef struct
+{
+   uint32_t pid;
+   uint32_t ppid;
+   uint32_t state;       /* ProcessState numbering */
+   uint32_t priority;
+   uint32_t sched_class; /* ProcessClass numbering */
+   uint32_t rss_kb;
+   uint64_t cpu_user_ms;
+   uint64_t cpu_system_ms;
+   char name[PROCINFO_NAME_MAX]; /* basename of the exec path */
+} sys_procinfo_t;
+
+/* Minimal pollfd layout shared with userspace (poll entries). */
+typedef struct
+{
+   int32_t fd;
+   int16_t events;
+   int16_t revents;
+} sys_pollfd;
+
+/* Batched-syscall rings (syscall/ring.c)
+ *
+ * ring_setup maps one shared page into the caller, laid out as a header
+ * followed by the submission (SQE) and completion (CQE) arrays at the
+ * offsets the header reports.  The user appends SQEs and bumps sq_tail;
+ * ring_enter consumes them synchronously and posts CQEs, so a batch of
+ * I/O costs a single trap.  All index fields are free-running counters
+ * masked by entries - 1 (entry counts are powers of two).
+ */
+#define RING_OP_NOP 0
+#define RING_OP_READ 1
+#define RING_OP_WRITE 2
+#define RING_OP_OPEN 3
+#define RING_OP_CLOSE 4
+
+#define RING_MAX_SQ_ENTRIES 64
+
+/* Minimal submission entry shared with userspace (32 bytes).
+ * addr is the user buffer for read/write and the path for open. */
+typedef struct
+{
+   uint8_t opcode; /* RING_OP_* */
+   uint8_t reserved0;
+   uint16_t mode; /* open: creation mode */
+   int32_t fd;
+   uint32_t addr;
+   uint32_t len;
+   uint32_t flags;     /* open: open flags */
+   uint32_t user_data; /* echoed back in the completion */
+   uint32_t reserved1[2];
+} sys_ring_sqe;
+
+/* Minimal completion entry shared with userspace (8 bytes). */
+typedef struct
+{
+   uint32_t user_data;
+   int32_t res; /* result or -errno, syscall convention */
+} sys_ring_cqe;
+
+/* Ring page header shared with userspace.  The kernel owns sq_head and
+ * cq_tail; userspace owns sq_tail and cq_head. */
+typedef struct
+{
+   volatile uint32_t sq_head;
+   volatile uint32_t sq_tail;
+   volatile uint32_t cq_head;
+   volatile uint32_t cq_tail;
+   uint32_t sq_entries;
+   uint32_t cq_entries;
+   uint32_t sqe_offset;
+   uint32_t cqe_offset;
+} sys_ring_header;
 
 /* Syscall handler prototypes
  * These are called by arch-specific dispatcher after extracting parameters
@@ -72,11 +303,42 @@ intptr_t sys_brk(void *addr);
 void *sys_sbrk(intptr_t increment);
 intptr_t sys_open(const char *path, int flags, uint16_t mode);
 intptr_t sys_close(int fd);
+intptr_t sys_dup(int oldfd);
+intptr_t sys_dup2(int oldfd, int newfd);
+intptr_t sys_pipe(int *fds);
 intptr_t sys_read(int fd, void *buf, uint32_t count);
 intptr_t sys_write(int fd, const void *buf, uint32_t count);
+intptr_t sys_readv(int fd, const sys_iovec *iov, int iovcnt);
+intptr_t sys_writev(int fd, const sys_iovec *iov, int iovcnt);
 intptr_t sys_lseek(int fd, int32_t offset, int whence);
+intptr_t sys_poll(sys_pollfd *fds, uint32_t nfds, int timeout_ms);
+intptr_t sys_ioctl(int fd, uint32_t cmd, void *arg);
+intptr_t sys_stat(const char *path, sys_stat_t *buf);
+intptr_t sys_fstat(int fd, sys_stat_t *buf);
+intptr_t sys_getdents(int fd, void *buf, uint32_t count);
 intptr_t sys_chmod(const char *path, uint16_t mode);
 intptr_t sys_chown(const char *path, uint32_t uid, uint32_t gid);
+intptr_t sys_sync(void);
+intptr_t sys_nanosleep(const sys_timespec *req, sys_timespec *rem);
+intptr_t sys_clock_gettime(uint32_t clock_id, sys_timespec *tp);
+intptr_t sys_mmap(void *addr, uint32_t length, uint32_t prot, uint32_t flags,
+                  int fd, uint32_t offset);
+intptr_t sys_munmap(void *addr, uint32_t length);
+intptr_t sys_shm_create(int32_t key, uint32_t size);
+intptr_t sys_shm_attach(int id);
+intptr_t sys_futex(uint32_t *uaddr, int op, uint32_t val);
+intptr_t sys_sendto(const void *buf, uint32_t len, const sys_sockaddr *dest,
+                    uint16_t src_port);
+intptr_t sys_recvfrom(uint16_t port, void *buf, uint32_t len,
+                      sys_sockaddr *src);
+intptr_t sys_ring_setup(uint32_t entries);
+intptr_t sys_ring_enter(uint32_t to_submit);
+intptr_t sys_kill(int32_t pid, int signum);
+intptr_t sys_sigaction(int signum, uintptr_t handler, uintptr_t *old_handler);
+intptr_t sys_sigprocmask(int how, const uint32_t *set, uint32_t *old_set);
+intptr_t sys_sigreturn(Registers *regs);
+intptr_t sys_procinfo(sys_procinfo_t *buf, uint32_t max);
+intptr_t sys_tracectl(int op, uint32_t mask);
 intptr_t sys_fork(const Registers *regs);
 intptr_t sys_execve(const char *path, const char *const argv[],
                     const char *const envp[], Registers *regs);
@@ -97,4 +359,9 @@ intptr_t syscall(uint32_t syscall_num, uint32_t *args);
 intptr_t syscall_dispatch(uint32_t syscall_num, uint32_t *args,
                           Registers *regs);
 
+/* Optional per-syscall call/cycle profiling ("syscall_prof" boot flag).
+ * The table is rendered as text through /dev/kstat. */
+void Syscall_ProfileInitialize(void);
+uint32_t Syscall_ProfileRead(uint32_t offset, uint32_t size, void *buffer);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-only
+"""
+Generate keymap_gen.c: flat scancode-set-1 translation tables.
+
+One 128-entry ASCII table per modifier state (none, shift, caps,
+shift+caps), so translation is a single indexed load instead of
+per-scancode modifier branching.
+
+Usage: mkkeymap.py <keymap_gen.c>
+"""
+
+import sys
+
+# Base US layout, scancode set 1 (make codes 0x00-0x3B).
+BASE = {
+    0x01: "\x1b",
+    0x02: "1", 0x03: "2", 0x04: "3", 0x05: "4", 0x06: "5",
+    0x07: "6", 0x08: "7", 0x09: "8", 0x0A: "9", 0x0B: "0",
+    0x0C: "-", 0x0D: "=", 0x0E: "\b", 0x0F: "\t",
+    0x10: "q", 0x11: "w", 0x12: "e", 0x13: "r", 0x14: "t",
+    0x15: "y", 0x16: "u", 0x17: "i", 0x18: "o", 0x19: "p",
+    0x1A: "[", 0x1B: "]", 0x1C: "\n",
+    0x1E: "a", 0x1F: "s", 0x20: "d", 0x21: "f", 0x22: "g",
+    0x23: "h", 0x24: "j", 0x25: "k", 0x26: "l", 0x27: ";",
+    0x28: "'", 0x29: "`", 0x2B: "\\",
+    0x2C: "z", 0x2D: "x", 0x2E: "c", 0x2F: "v", 0x30: "b",
+    0x31: "n", 0x32: "m", 0x33: ",", 0x34: ".", 0x35: "/",
+    0x37: "*", 0x39: " ",
+}
+
+# Shifted symbols (letters are handled by case conversion below).
+SHIFTED = {
+    "1": "!", "2": "@", "3": "#", "4": "$", "5": "%",
+    "6": "^", "7": "&", "8": "*", "9": "(", "0": ")",
+    "-": "_", "=": "+", "[": "{", "]": "}", "\\": "|",
+    ";": ":", "'": '"', "`": "~", ",": "<", ".": ">", "/": "?",
+}
+
+
+def translate(ch, shift, caps):
+    """Apply a modifier state to one base character."""
+    if ch.isalpha():
+        # Shift and caps cancel for letters.
+        return ch.upper() if (shift != caps) else ch
+    if shift:
+        return SHIFTED.get(ch, ch)
+    return ch
+
+
+def c_char(ch):
+    if ch == "":
+        return "0"
+    specials = {"\x1b": "27", "\b": "'\\b'", "\t": "'\\t'", "\n": "'\\n'",
+                "\\": "'\\\\'", "'": "'\\''"}
+    if ch in specials:
+        return specials[ch]
+    return f"'{ch}'"
+
+
+def emit_table(shift, caps):
+    cells = []
+    for code in range(128):
+        ch = BASE.get(code, "")
+        cells.append(c_char(translate(ch, shift, caps) if ch else ""))
+    lines = []
+    for i in range(0, 128, 8):
+        lines.append("        " + ", ".join(cells[i : i + 8]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(f"Usage: {sys.argv[0]} <keymap_gen.c>", file=sys.stderr)
+        sys.exit(1)
+
+    tables = []
+    for state, (shift, caps) in enumerate(
+        [(False, False), (True, False), (False, True), (True, True)]
+    ):
+        label = ["none", "shift", "caps", "shift+caps"][state]
+        tables.append(f"    /* KEYMAP_STATE: {label} */\n    {{\n"
+                      + emit_table(shift, caps) + "\n    },")
+
+    content = (
+        "// SPDX-License-Identifier: GPL-3.0-only\n"
+        "\n"
+        '#include "keymap.h"\n'
+        "\n"
+        "/* Scancode-set-1 translation tables, one per modifier state.\n"
+        " * Generated by scripts/mkkeymap.py - do not edit by hand. */\n"
+        "const char g_Keymap[KEYMAP_STATES][KEYMAP_CODES] = {\n"
+        + "\n".join(tables)
+        + "\n};\n"
+    )
+
+    with open(sys.argv[1], "w") as f:
+        f.write(content)
+
+
+if __name__ == "__main__":
+    main()
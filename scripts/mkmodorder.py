@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+"""
+Generate kmod.order: the precomputed module load manifest.
+
+Reads the built .so modules, extracts DT_NEEDED dependencies and the
+undefined dynamic symbols from each, topologically sorts the set, and
+writes a flat manifest so the kernel loads modules in one pass instead
+of re-resolving the dependency graph by name lookups every boot.
+
+Manifest format (one module per line, fields space-separated):
+
+    <name> <image-path> <dep,dep,...|-> <undef,undef,...|->
+
+Lines starting with '#' are comments.  Dependencies are listed by
+module name (basename without the lib prefix or .so suffix) and appear
+earlier in the file than their dependents.
+
+Usage: mkmodorder.py <kmod.order> <install-prefix> <module.so>...
+"""
+
+import os
+import struct
+import sys
+
+SHT_DYNSYM = 11
+SHT_DYNAMIC = 6
+DT_NEEDED = 1
+
+
+def module_name(path):
+    base = os.path.basename(path)
+    if base.endswith(".so"):
+        base = base[:-3]
+    if base.startswith("lib"):
+        base = base[3:]
+    return base
+
+
+def parse_elf(path):
+    """Return (needed_names, undefined_symbols) for an ELF32 shared object."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if len(data) < 52 or data[:4] != b"\x7fELF":
+        raise SystemExit(f"{path}: not an ELF file")
+    if data[4] != 1 or data[5] != 1:
+        raise SystemExit(f"{path}: not 32-bit little-endian")
+
+    e_shoff, = struct.unpack_from("<I", data, 32)
+    e_shentsize, e_shnum = struct.unpack_from("<HH", data, 46)
+
+    sections = []
+    for i in range(e_shnum):
+        off = e_shoff + i * e_shentsize
+        name, sh_type, flags, addr, offset, size, link = struct.unpack_from(
+            "<7I", data, off
+        )
+        sections.append((sh_type, offset, size, link))
+
+    def strtab(index):
+        _, offset, size, _ = sections[index]
+        return data[offset : offset + size]
+
+    def string_at(table, pos):
+        end = table.find(b"\0", pos)
+        return table[pos:end].decode("ascii")
+
+    needed = []
+    undefined = []
+
+    for sh_type, offset, size, link in sections:
+        if sh_type == SHT_DYNAMIC:
+            names = strtab(link)
+            for pos in range(offset, offset + size, 8):
+                d_tag, d_val = struct.unpack_from("<II", data, pos)
+                if d_tag == DT_NEEDED:
+                    needed.append(module_name(string_at(names, d_val)))
+        elif sh_type == SHT_DYNSYM:
+            names = strtab(link)
+            for pos in range(offset, offset + size, 16):
+                st_name, _, _, _, _, st_shndx = struct.unpack_from(
+                    "<3I2BH", data, pos
+                )
+                if st_shndx == 0 and st_name != 0:
+                    undefined.append(string_at(names, st_name))
+
+    return needed, undefined
+
+
+def topo_sort(modules):
+    """Order so every module follows its in-set dependencies."""
+    order = []
+    state = {}  # name -> 1 visiting, 2 done
+
+    def visit(name, chain):
+        if state.get(name) == 2:
+            return
+        if state.get(name) == 1:
+            cycle = " -> ".join(chain + [name])
+            raise SystemExit(f"dependency cycle: {cycle}")
+        state[name] = 1
+        for dep in modules[name][0]:
+            if dep in modules:
+                visit(dep, chain + [name])
+        state[name] = 2
+        order.append(name)
+
+    for name in sorted(modules):
+        visit(name, [])
+    return order
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 1
+
+    out_path = sys.argv[1]
+    prefix = sys.argv[2].rstrip("/")
+    paths = sys.argv[3:]
+
+    modules = {}  # name -> (needed, undefined, image_path)
+    for path in paths:
+        needed, undefined = parse_elf(path)
+        name = module_name(path)
+        image = f"{prefix}/{os.path.basename(path)}"
+        modules[name] = (needed, undefined, image)
+
+    with open(out_path, "w") as out:
+        out.write("# kmod.order - generated by scripts/mkmodorder.py\n")
+        out.write("# <name> <image-path> <deps|-> <undefined-symbols|->\n")
+        for name in topo_sort(modules):
+            needed, undefined, image = modules[name]
+            deps = ",".join(needed) if needed else "-"
+            undefs = ",".join(undefined) if undefined else "-"
+            out.write(f"{name} {image} {deps} {undefs}\n")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Fold /dev/profile samples into a flat per-symbol profile.
+#
+# Boot with "profile" on the kernel command line, capture the sample
+# ring (e.g. `cat /dev/profile > samples.txt`), then run:
+#
+#   scripts/profile_symbolize.py samples.txt build/.../kernel.elf
+#
+# Each input line is one EIP sample as eight hex digits; samples are
+# attributed to the nearest preceding symbol in the kernel ELF.
+
+import argparse
+import bisect
+import subprocess
+import sys
+
+
+def load_symbols(elf_path, nm="nm"):
+    """Return sorted (address, name) pairs for the ELF's text symbols."""
+    out = subprocess.run(
+        [nm, "-C", "--defined-only", elf_path],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+
+    symbols = []
+    for line in out.splitlines():
+        parts = line.split(None, 2)
+        if len(parts) != 3:
+            continue
+        addr, kind, name = parts
+        if kind.lower() not in ("t", "w"):
+            continue
+        symbols.append((int(addr, 16), name))
+
+    symbols.sort()
+    if not symbols:
+        raise SystemExit(f"no text symbols in {elf_path}")
+    return symbols
+
+
+def symbolize(sample, addrs, names):
+    i = bisect.bisect_right(addrs, sample) - 1
+    if i < 0:
+        return "<below kernel>"
+    return names[i]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Map /dev/profile EIP samples to kernel symbols"
+    )
+    parser.add_argument("samples", help="dump of /dev/profile (hex lines)")
+    parser.add_argument("elf", help="kernel ELF with symbols")
+    parser.add_argument("--nm", default="nm", help="nm binary to use")
+    parser.add_argument(
+        "--top", type=int, default=0, help="only print the N hottest symbols"
+    )
+    parser.add_argument(
+        "--layout",
+        metavar="FILE",
+        help="also write a linker INCLUDE fragment that places the ranked "
+        "symbols contiguously (see kernel/arch/i686/hotfns.ld)",
+    )
+    args = parser.parse_args()
+
+    symbols = load_symbols(args.elf, args.nm)
+    addrs = [a for a, _ in symbols]
+    names = [n for _, n in symbols]
+
+    counts = {}
+    total = 0
+    with open(args.samples) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                sample = int(line, 16)
+            except ValueError:
+                continue
+            name = symbolize(sample, addrs, names)
+            counts[name] = counts.get(name, 0) + 1
+            total += 1
+
+    if total == 0:
+        raise SystemExit("no samples (did you boot with 'profile'?)")
+
+    ranked = sorted(counts.items(), key=lambda kv: kv[1], reverse=True)
+    if args.top:
+        ranked = ranked[: args.top]
+
+    print(f"{total} samples")
+    for name, count in ranked:
+        print(f"{count:8d}  {100.0 * count / total:5.1f}%  {name}")
+
+    if args.layout:
+        # One input-section rule per ranked symbol, hottest first; the
+        # kernel builds with -ffunction-sections so each function has
+        # its own .text.<name> section the rule can claim.
+        with open(args.layout, "w") as out:
+            out.write("/* SPDX-License-Identifier: GPL-3.0-only */\n\n")
+            out.write(
+                f"/* Generated by profile_symbolize.py from {total} samples;"
+                " hottest first. */\n"
+            )
+            for name, _ in ranked:
+                if not name.isidentifier():
+                    continue  # skip <below kernel> and mangled names
+                out.write(f"*(.text.{name})\n")
+        print(f"layout fragment written to {args.layout}")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,123 @@
+# SPDX-License-Identifier: BSD-3-Clause
+"""
+LZ4 kernel image compression for the disk image pipeline.
+
+Produces the minimal chunked container decoded by boot/bios/lz4.c:
+
+    u32 magic "VLZ4"
+    u32 uncompressed size
+    per chunk:
+        u32 csize (0 = chunk stored uncompressed)
+        u32 dsize
+        payload
+
+Chunks are compressed independently so the loader can decode each one
+as soon as its sectors arrive.  The compressor is a plain greedy LZ4
+block encoder; no external lz4 tool or module is required.
+"""
+
+import struct
+
+IMAGE_MAGIC = 0x345A4C56  # "VLZ4"
+CHUNK_MAX = 32768  # must match LZ4_CHUNK_MAX in boot/bios/lz4.h
+
+_MIN_MATCH = 4
+_MAX_OFFSET = 0xFFFF
+
+
+def _compress_block(src: bytes) -> bytes:
+    """Greedy LZ4 block compression with a 4-byte hash table."""
+    n = len(src)
+    dst = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+
+    # Spec: matches may not start within the last 12 bytes, and the
+    # last 5 bytes are always literals.
+    match_limit = n - 12 if n >= 12 else 0
+    literal_end = n - 5 if n >= 5 else 0
+
+    while i < match_limit:
+        seq = src[i : i + _MIN_MATCH]
+        j = table.get(seq)
+        table[seq] = i
+        if j is None or i - j > _MAX_OFFSET:
+            i += 1
+            continue
+
+        # Extend the match forward
+        m = i + _MIN_MATCH
+        k = j + _MIN_MATCH
+        while m < literal_end and src[m] == src[k]:
+            m += 1
+            k += 1
+        match_len = m - i
+
+        # Emit literals since the last match
+        lit_len = i - anchor
+        ml_code = match_len - _MIN_MATCH
+        token_lit = 15 if lit_len >= 15 else lit_len
+        token_ml = 15 if ml_code >= 15 else ml_code
+        dst.append((token_lit << 4) | token_ml)
+        if lit_len >= 15:
+            rem = lit_len - 15
+            while rem >= 255:
+                dst.append(255)
+                rem -= 255
+            dst.append(rem)
+        dst += src[anchor:i]
+
+        offset = i - j
+        dst.append(offset & 0xFF)
+        dst.append(offset >> 8)
+        if ml_code >= 15:
+            rem = ml_code - 15
+            while rem >= 255:
+                dst.append(255)
+                rem -= 255
+            dst.append(rem)
+
+        i = m
+        anchor = i
+
+    # Trailing literals
+    lit_len = n - anchor
+    token_lit = 15 if lit_len >= 15 else lit_len
+    dst.append(token_lit << 4)
+    if lit_len >= 15:
+        rem = lit_len - 15
+        while rem >= 255:
+            dst.append(255)
+            rem -= 255
+        dst.append(rem)
+    dst += src[anchor:]
+
+    return bytes(dst)
+
+
+def CompressImageFile(SourcePath: str, TargetPath: str) -> float:
+    """Compress SourcePath into the chunked container at TargetPath.
+
+    Returns the compression ratio (compressed / original size).
+    """
+    with open(SourcePath, "rb") as SrcFile:
+        Data = SrcFile.read()
+
+    Out = bytearray(struct.pack("<II", IMAGE_MAGIC, len(Data)))
+
+    for Offset in range(0, len(Data), CHUNK_MAX):
+        Chunk = Data[Offset : Offset + CHUNK_MAX]
+        Packed = _compress_block(Chunk)
+        if len(Packed) < len(Chunk):
+            Out += struct.pack("<II", len(Packed), len(Chunk))
+            Out += Packed
+        else:
+            # Incompressible chunk: store raw (csize 0)
+            Out += struct.pack("<II", 0, len(Chunk))
+            Out += Chunk
+
+    with open(TargetPath, "wb") as DstFile:
+        DstFile.write(Out)
+
+    return len(Out) / len(Data) if Data else 1.0
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+/**
+ * Q16.16 fixed-point math: integer-only mul/div/sqrt and table-driven
+ * trig for loops that must stay off the FPU.
+ */
+
+#include "fixed.h"
+
+/* ===== Fixed-Point Arithmetic ===== */
+
+fixed_t fixed_mul(fixed_t a, fixed_t b)
+{
+   return (fixed_t)(((int64_t)a * b) >> 16);
+}
+
+fixed_t fixed_div(fixed_t a, fixed_t b)
+{
+   if (b == 0) return 0;
+   return (fixed_t)(((int64_t)a << 16) / b);
+}
+
+/* Bit-by-bit integer square root of x·2¹⁶, so the result lands back in
+ * Q16.16.  24 iterations of shift/compare/subtract, no division. */
+fixed_t fixed_sqrt(fixed_t x)
+{
+   if (x <= 0) return 0;
+
+   uint64_t value = (uint64_t)(uint32_t)x << 16;
+   uint64_t result = 0;
+   uint64_t bit = 1ull << 46; /* Highest power of four ≤ 2⁴⁸ */
+
+   while (bit > value) bit >>= 2;
+
+   while (bit != 0)
+   {
+      if (value >= result + bit)
+      {
+         value -= result + bit;
+         result = (result >> 1) + bit;
+      }
+      else
+      {
+         result >>= 1;
+      }
+      bit >>= 2;
+   }
+
+   return (fixed_t)result;
+}
+
+/* ===== Fixed-Point Trigonometry ===== */
+
+/* Quarter-wave sine table: sin(i·π/128) in Q16.16 for i = 0..64.  The
+ * other three quadrants come from symmetry, so 65 entries (260 bytes)
+ * cover the full circle. */
+static const int32_t s_SinQuarter[65] = {
+   0, 1608, 3216, 4821, 6424, 8022, 9616, 11204,
+   12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+   25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+   36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+   46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+   54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+   60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+   64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+   65536,
+};
+
+/* Look up sin for a quarter-turn position t ∈ [0, 0x4000], where 0x4000
+ * is π/2.  Linearly interpolates between adjacent table entries. */
+static fixed_t sin_quarter(uint32_t t)
+{
+   if (t >= 0x4000) return s_SinQuarter[64];
+
+   uint32_t index = t >> 8;    /* 0..63 */
+   uint32_t fraction = t & 0xFF;
+   int32_t lo = s_SinQuarter[index];
+   int32_t hi = s_SinQuarter[index + 1];
+
+   return lo + (fixed_t)(((int64_t)(hi - lo) * fraction) >> 8);
+}
+
+fixed_t fixed_sin(fixed_t angle)
+{
+   /* Reduce to [0, 2π), then rescale so a full turn is 0x10000 phase
+    * units: 0x4000 per quadrant matches the table granularity. */
+   int32_t reduced = angle % FIXED_TWO_PI;
+   if (reduced < 0) reduced += FIXED_TWO_PI;
+
+   uint32_t phase = (uint32_t)(((int64_t)reduced << 16) / FIXED_TWO_PI);
+   uint32_t t = phase & 0x3FFF;
+
+   switch ((phase >> 14) & 3)
+   {
+   case 0:
+      return sin_quarter(t);
+   case 1:
+      return sin_quarter(0x4000 - t);
+   case 2:
+      return -sin_quarter(t);
+   default:
+      return -sin_quarter(0x4000 - t);
+   }
+}
+
+fixed_t fixed_cos(fixed_t angle) { return fixed_sin(angle + FIXED_HALF_PI); }
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+/**
+ * @file fixed.h
+ * @brief Q16.16 fixed-point math for ValeciumOS userland
+ *
+ * Integer-only arithmetic for hot control loops that must not touch the
+ * FPU: the kernel does not yet save FPU state across context switches,
+ * and once lazy FPU switching lands these routines keep callers off the
+ * state-restore slow path entirely.
+ *
+ * Format: signed 32-bit, 16 integer bits and 16 fraction bits, so the
+ * representable range is [-32768, 32768) with a resolution of 2⁻¹⁶.
+ */
+
+#ifndef LIBMATH_FIXED_H
+#define LIBMATH_FIXED_H
+
+#include <stdint.h>
+
+/** Q16.16 fixed-point value */
+typedef int32_t fixed_t;
+
+/* ===== Fixed-Point Constants ===== */
+
+#define FIXED_ONE 0x00010000        /**< 1.0 in Q16.16 */
+#define FIXED_HALF 0x00008000       /**< 0.5 in Q16.16 */
+#define FIXED_PI 205887             /**< π in Q16.16 */
+#define FIXED_TWO_PI 411775         /**< 2π in Q16.16 */
+#define FIXED_HALF_PI 102944        /**< π/2 in Q16.16 */
+
+/* ===== Conversions ===== */
+
+#define FIXED_FROM_INT(n) ((fixed_t)((n) << 16))   /**< Integer to Q16.16 */
+#define FIXED_TO_INT(x) ((int32_t)((x) >> 16))     /**< Q16.16 to integer (truncating) */
+
+/* ===== Fixed-Point Arithmetic ===== */
+
+/**
+ * Multiply two Q16.16 values
+ * @param a First factor
+ * @param b Second factor
+ * @return a · b in Q16.16 (64-bit intermediate, no overflow up to range)
+ */
+extern fixed_t fixed_mul(fixed_t a, fixed_t b);
+
+/**
+ * Divide two Q16.16 values
+ * @param a Dividend
+ * @param b Divisor
+ * @return a / b in Q16.16 (returns 0 if b == 0)
+ */
+extern fixed_t fixed_div(fixed_t a, fixed_t b);
+
+/**
+ * Square root of a Q16.16 value
+ * @param x Value (negative inputs return 0)
+ * @return √x in Q16.16
+ */
+extern fixed_t fixed_sqrt(fixed_t x);
+
+/* ===== Fixed-Point Trigonometry ===== */
+
+/**
+ * Sine of a Q16.16 angle in radians
+ * @param angle Angle in radians, Q16.16
+ * @return sin(angle) in Q16.16, range [-FIXED_ONE, FIXED_ONE]
+ */
+extern fixed_t fixed_sin(fixed_t angle);
+
+/**
+ * Cosine of a Q16.16 angle in radians
+ * @param angle Angle in radians, Q16.16
+ * @return cos(angle) in Q16.16, range [-FIXED_ONE, FIXED_ONE]
+ */
+extern fixed_t fixed_cos(fixed_t angle);
+
+#endif /* LIBMATH_FIXED_H */
@@ -46,73 +46,104 @@ double fabs(double x) { return x < 0.0 ? -x : x; }
 
 /* ===== Trigonometric Functions ===== */
 
-/* sin(x) using Taylor series: x - x^3/3! + x^5/5! - x^7/7! + ... */
-float sinf(float x)
+/* Fixed-latency kernels: every input takes the same range reduction and
+ * the same fixed-degree minimax polynomial, so a call costs the same
+ * number of cycles regardless of the argument (no data-dependent early
+ * exits).  Coefficients are the standard fdlibm minimax sets for the
+ * reduced interval [-π/4, π/4]. */
+
+typedef union
+{
+   double d;
+   unsigned long long u;
+} DoubleBits;
+
+/* π/2 split for Cody-Waite reduction: PIO2_HI carries the leading bits
+ * exactly, PIO2_LO the remainder, so x - k·π/2 stays accurate. */
+#define PIO2_HI 1.57079632679489655800e+00
+#define PIO2_LO 6.12323399573676603587e-17
+#define INV_PIO2 6.36619772367581382433e-01
+
+/* sin(r) ≈ r + r³·poly(r²) on [-π/4, π/4] */
+static double sin_kernel(double r)
 {
-   /* Reduce x to [-pi, pi] */
-   while (x > M_PI) x -= 2 * M_PI;
-   while (x < -M_PI) x += 2 * M_PI;
+   double z = r * r;
+   return r +
+          (z * r) *
+              (-1.66666666666666324348e-01 +
+               z * (8.33333333332248946124e-03 +
+                    z * (-1.98412698298579493134e-04 +
+                         z * (2.75573137070700676789e-06 +
+                              z * (-2.50507602534068634195e-08 +
+                                   z * 1.58969099521155010221e-10)))));
+}
 
-   float result = x;
-   float term = x;
-   for (int i = 1; i < 20; i++)
-   {
-      term *= -x * x / ((2 * i) * (2 * i + 1));
-      result += term;
-      if (fabsf(term) < 1e-7f) break;
-   }
-   return result;
+/* cos(r) ≈ 1 - r²/2 + r⁴·poly(r²) on [-π/4, π/4] */
+static double cos_kernel(double r)
+{
+   double z = r * r;
+   return 1.0 - 0.5 * z +
+          (z * z) * (4.16666666666666019037e-02 +
+                     z * (-1.38888888888741095749e-03 +
+                          z * (2.48015872894767294178e-05 +
+                               z * (-2.75573143513906633035e-07 +
+                                    z * (2.08757232129817482790e-09 +
+                                         z * -1.13596475577881948265e-11)))));
 }
 
-double sin(double x)
+/* Reduce x to r ∈ [-π/4, π/4] with x = k·π/2 + r; returns r and the
+ * quadrant k mod 4.  Exact for |x| well below 2⁵², which covers every
+ * angle our callers produce. */
+static double trig_reduce(double x, int *quadrant)
 {
-   while (x > M_PI) x -= 2 * M_PI;
-   while (x < -M_PI) x += 2 * M_PI;
+   double k = x * INV_PIO2;
+   k = (k >= 0.0) ? (double)(long long)(k + 0.5)
+                  : (double)(long long)(k - 0.5);
 
-   double result = x;
-   double term = x;
-   for (int i = 1; i < 40; i++)
-   {
-      term *= -x * x / ((2 * i) * (2 * i + 1));
-      result += term;
-      if (fabs(term) < 1e-15) break;
-   }
-   return result;
+   *quadrant = (int)((long long)k & 3);
+   return (x - k * PIO2_HI) - k * PIO2_LO;
 }
 
-/* cos(x) using Taylor series: 1 - x^2/2! + x^4/4! - x^6/6! + ... */
-float cosf(float x)
+double sin(double x)
 {
-   while (x > M_PI) x -= 2 * M_PI;
-   while (x < -M_PI) x += 2 * M_PI;
+   int quadrant;
+   double r = trig_reduce(x, &quadrant);
 
-   float result = 1.0f;
-   float term = 1.0f;
-   for (int i = 1; i < 20; i++)
+   switch (quadrant)
    {
-      term *= -x * x / ((2 * i - 1) * (2 * i));
-      result += term;
-      if (fabsf(term) < 1e-7f) break;
+   case 0:
+      return sin_kernel(r);
+   case 1:
+      return cos_kernel(r);
+   case 2:
+      return -sin_kernel(r);
+   default:
+      return -cos_kernel(r);
    }
-   return result;
 }
 
+float sinf(float x) { return (float)sin((double)x); }
+
 double cos(double x)
 {
-   while (x > M_PI) x -= 2 * M_PI;
-   while (x < -M_PI) x += 2 * M_PI;
+   int quadrant;
+   double r = trig_reduce(x, &quadrant);
 
-   double result = 1.0;
-   double term = 1.0;
-   for (int i = 1; i < 40; i++)
+   switch (quadrant)
    {
-      term *= -x * x / ((2 * i - 1) * (2 * i));
-      result += term;
-      if (fabs(term) < 1e-15) break;
+   case 0:
+      return cos_kernel(r);
+   case 1:
+      return -sin_kernel(r);
+   case 2:
+      return -cos_kernel(r);
+   default:
+      return sin_kernel(r);
    }
-   return result;
 }
 
+float cosf(float x) { return (float)cos((double)x); }
+
 /* tan(x) = sin(x) / cos(x) */
 float tanf(float x) { return sinf(x) / cosf(x); }
 
@@ -120,55 +151,77 @@ double tan(double x) { return sin(x) / cos(x); }
 
 /* ===== Exponential & Logarithm ===== */
 
-/* exp(x) using Taylor series: 1 + x + x^2/2! + x^3/3! + ... */
-float expf(float x)
-{
-   if (x > 100.0f) return INFINITY;
-   if (x < -100.0f) return 0.0f;
-
-   float result = 1.0f;
-   float term = 1.0f;
-   for (int i = 1; i < 50; i++)
-   {
-      term *= x / i;
-      result += term;
-      if (fabsf(term) < 1e-7f) break;
-   }
-   return result;
-}
+/* ln2 split for exp's Cody-Waite reduction. */
+#define LN2_HI 6.93147180369123816490e-01
+#define LN2_LO 1.90821492927058770002e-10
+#define INV_LN2 1.44269504088896338700e+00
 
+/* exp(x) = 2ᵏ · exp(r) with r ∈ [-ln2/2, ln2/2]: a fixed degree-11
+ * Taylor polynomial on the reduced interval (remainder below 1e-14
+ * there), then the 2ᵏ scale applied by building the exponent field
+ * directly. */
 double exp(double x)
 {
    if (x > 700.0) return INFINITY;
    if (x < -700.0) return 0.0;
 
-   double result = 1.0;
-   double term = 1.0;
-   for (int i = 1; i < 100; i++)
-   {
-      term *= x / i;
-      result += term;
-      if (fabs(term) < 1e-15) break;
-   }
-   return result;
+   int n = (int)(x * INV_LN2 + (x >= 0.0 ? 0.5 : -0.5));
+   double r = (x - n * LN2_HI) - n * LN2_LO;
+
+   double p =
+       1.0 +
+       r * (1.0 +
+            r * (5.00000000000000000000e-01 +
+                 r * (1.66666666666666666667e-01 +
+                      r * (4.16666666666666666667e-02 +
+                           r * (8.33333333333333333333e-03 +
+                                r * (1.38888888888888888889e-03 +
+                                     r * (1.98412698412698412698e-04 +
+                                          r * (2.48015873015873015873e-05 +
+                                               r * (2.75573192239858906526e-06 +
+                                                    r * (2.75573192239858906526e-07 +
+                                                         r * 2.50521083854417187751e-08))))))))));
+
+   DoubleBits scale;
+   scale.u = (unsigned long long)(1023 + n) << 52;
+   return p * scale.d;
 }
 
-/* Natural logarithm using Newton's method */
+float expf(float x) { return (float)exp((double)x); }
+
+/* log(x) = e·ln2 + log(m) with x = 2ᵉ·m, m ∈ [√2/2, √2): the mantissa
+ * is pulled out of the bit pattern, then log(m) comes from the fixed
+ * atanh-style series in s = (m-1)/(m+1), which converges fast because
+ * |s| ≤ 0.172 on that interval. */
 double log(double x)
 {
    if (x <= 0.0) return -INFINITY;
-   if (x == 1.0) return 0.0;
 
-   /* First approximation using bit manipulation (fast log) */
-   double y = (double)((*(long long *)&x - 0x3fe6a09e667f3bcc) >> 1) *
-              1.4426950408889634;
+   DoubleBits bits;
+   bits.d = x;
+   int e = (int)((bits.u >> 52) & 0x7FF) - 1023;
+   bits.u = (bits.u & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
 
-   /* Newton iterations for refinement */
-   for (int i = 0; i < 10; i++)
+   double m = bits.d;
+   if (m > M_SQRT2)
    {
-      y = y - (expf(y) - x) / expf(y);
+      m *= 0.5;
+      e++;
    }
-   return y;
+
+   double s = (m - 1.0) / (m + 1.0);
+   double z = s * s;
+   double p =
+       2.0 * s *
+       (1.0 +
+        z * (3.33333333333333333333e-01 +
+             z * (2.00000000000000000000e-01 +
+                  z * (1.42857142857142857143e-01 +
+                       z * (1.11111111111111111111e-01 +
+                            z * (9.09090909090909090909e-02 +
+                                 z * 7.69230769230769230769e-02))))));
+
+   return e * LN2_HI + (p + e * LN2_LO);
 }
 
 float logf(float x) { return (float)log((double)x); }
@@ -193,12 +246,18 @@ double pow(double x, double y)
 
 float powf(float x, float y) { return (float)pow((double)x, (double)y); }
 
-/* sqrt(x) using Newton's method: x_{n+1} = (x_n + x/x_n) / 2 */
+/* sqrt: the FPU's fsqrt is correctly rounded and fixed latency; the
+ * Newton loop only remains as a fallback for non-x86 builds. */
 float sqrtf(float x)
 {
    if (x < 0.0f) return NAN;
    if (x == 0.0f) return 0.0f;
 
+#if defined(__i386__) || defined(__x86_64__)
+   float result;
+   __asm__("fsqrt" : "=t"(result) : "0"(x));
+   return result;
+#else
    float guess = x * 0.5f;
    for (int i = 0; i < 20; i++)
    {
@@ -207,6 +266,7 @@ float sqrtf(float x)
       guess = next;
    }
    return guess;
+#endif
 }
 
 double sqrt(double x)
@@ -214,6 +274,11 @@ double sqrt(double x)
    if (x < 0.0) return NAN;
    if (x == 0.0) return 0.0;
 
+#if defined(__i386__) || defined(__x86_64__)
+   double result;
+   __asm__("fsqrt" : "=t"(result) : "0"(x));
+   return result;
+#else
    double guess = x * 0.5;
    for (int i = 0; i < 40; i++)
    {
@@ -222,6 +287,7 @@ double sqrt(double x)
       guess = next;
    }
    return guess;
+#endif
 }
 
 /* ===== Rounding ===== */
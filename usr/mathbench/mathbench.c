@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+/**
+ * mathbench - cycles-per-call measurement for the libmath transcendentals.
+ *
+ * Sweeps each function across its useful input range and reports the
+ * average TSC cycles per call, so regressions in the fixed-latency
+ * kernels show up as a single number per function.
+ */
+
+#include <stdio.h>
+
+#include "math.h"
+
+static unsigned long long rdtsc(void)
+{
+   unsigned int lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((unsigned long long)hi << 32) | lo;
+}
+
+typedef double (*MathFn)(double);
+
+/* Accumulated so the calls cannot be optimized away. */
+static double g_Sink;
+
+static void bench(const char *name, MathFn fn, double lo, double hi)
+{
+   enum
+   {
+      CALLS = 4096
+   };
+   double step = (hi - lo) / CALLS;
+
+   /* Warm pass: page in the code and settle the FPU state. */
+   double x = lo;
+   for (int i = 0; i < CALLS; i++, x += step) g_Sink += fn(x);
+
+   x = lo;
+   unsigned long long start = rdtsc();
+   for (int i = 0; i < CALLS; i++, x += step) g_Sink += fn(x);
+   unsigned long long cycles = rdtsc() - start;
+
+   printf("%-5s [%g, %g]: %llu cycles/call\n", name, lo, hi,
+          cycles / CALLS);
+}
+
+int main(void)
+{
+   bench("sin", sin, -100.0, 100.0);
+   bench("cos", cos, -100.0, 100.0);
+   bench("exp", exp, -700.0, 700.0);
+   bench("log", log, 1e-6, 1e6);
+   bench("sqrt", sqrt, 1e-6, 1e6);
+
+   /* Keep the sink observable. */
+   printf("checksum: %g\n", g_Sink);
+   return 0;
+}
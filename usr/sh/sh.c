@@ -9,11 +9,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
 char *version = "1.0";
 
+/* Hidden by the POSIX feature macros this build uses, but the kernel
+ * implements it (Syscall_Wait4) and the time builtin needs the rusage. */
+pid_t wait4(pid_t pid, int *status, int options, struct rusage *rusage);
+
 typedef struct
 {
    char *version;
@@ -48,19 +54,60 @@ Variable vars[MAX_VARS];
 int var_count = 0;
 char remaining_command[PATH_MAX] = {0};
 
+/* Command-name → resolved-path cache (bash's `hash` builtin).  A PATH
+ * probe costs an open attempt per candidate directory, so repeat
+ * commands skip the walk entirely.  The table is dropped by the rehash
+ * builtin and whenever PATH changes. */
+#define HASH_BUCKETS 64
+typedef struct HashEntry
+{
+   char *name;
+   char *path;
+   struct HashEntry *next;
+} HashEntry;
+HashEntry *hash_table[HASH_BUCKETS];
+
+/* Background jobs (trailing &).  One entry per launched line; pipelines
+ * keep every stage pid so nothing is left as a zombie.  Finished jobs
+ * are reaped with WNOHANG - from the SIGCHLD handler when the kernel
+ * delivers it, and again just before each prompt - and announced before
+ * the next prompt is printed. */
+#define MAX_JOBS 32
+#define JOB_MAX_PIDS 8
+typedef struct
+{
+   int id;
+   int state;  /* 0 = free, 1 = running, 2 = done (unreported) */
+   int npids;  /* pids launched for this job */
+   int nleft;  /* pids not yet reaped */
+   pid_t pids[JOB_MAX_PIDS];
+   char cmdline[64];
+} Job;
+Job jobs[MAX_JOBS];
+int next_job_id = 1;
+volatile sig_atomic_t jobs_done_pending = 0;
+
 Shell g_Shell;
 
 void init();
 void loop();
-void execute(Command *command);
-void execute_pipeline(Pipeline *pipeline);
+void execute(Command *command, int background, const char *cmdline);
+void execute_pipeline(Pipeline *pipeline, int background, const char *cmdline);
 Command *parse(char command[PATH_MAX]);
 Pipeline *parse_pipeline(char command[PATH_MAX]);
 void set(const char *var, const char *value);
+int job_add(int npids, const pid_t *pids, const char *cmdline);
+void job_reap(void);
+void report_done_jobs(void);
 
 void Command_CD(Command *command);
 void Command_HELP(Command *command);
 void Command_EXIT(Command *command);
+void Command_JOBS(Command *command);
+void Command_TIME(Command *command);
+const char *hash_lookup(const char *name);
+void hash_insert(const char *name, const char *path);
+void hash_clear(void);
 int open_input_file(const char *filename);
 int open_output_file(const char *filename, int append);
 
@@ -70,8 +117,83 @@ void sigint_handler(int sig)
    // Let child processes handle it
 }
 
+int job_add(int npids, const pid_t *pids, const char *cmdline)
+{
+   if (npids <= 0 || npids > JOB_MAX_PIDS) return -1;
+
+   for (int i = 0; i < MAX_JOBS; i++)
+   {
+      if (jobs[i].state != 0) continue;
+
+      jobs[i].npids = npids;
+      jobs[i].nleft = 0;
+      for (int j = 0; j < npids; j++)
+      {
+         jobs[i].pids[j] = pids[j];
+         if (pids[j] > 0) jobs[i].nleft++;
+      }
+      if (jobs[i].nleft == 0) return -1; /* nothing actually launched */
+
+      jobs[i].id = next_job_id++;
+      jobs[i].state = 1;
+      strncpy(jobs[i].cmdline, cmdline, sizeof(jobs[i].cmdline) - 1);
+      jobs[i].cmdline[sizeof(jobs[i].cmdline) - 1] = '\0';
+      return jobs[i].id;
+   }
+   return -1;
+}
+
+void job_reap(void)
+{
+   // Only poll pids from the job table: a foreground child must stay
+   // reapable by the synchronous waitpid in execute_with_redirect.
+   for (int i = 0; i < MAX_JOBS; i++)
+   {
+      if (jobs[i].state != 1) continue;
+
+      for (int j = 0; j < jobs[i].npids; j++)
+      {
+         if (jobs[i].pids[j] < 0) continue;
+         if (waitpid(jobs[i].pids[j], NULL, WNOHANG) == jobs[i].pids[j])
+         {
+            jobs[i].pids[j] = -1;
+            jobs[i].nleft--;
+         }
+      }
+
+      if (jobs[i].nleft == 0)
+      {
+         jobs[i].state = 2;
+         jobs_done_pending = 1;
+      }
+   }
+}
+
+void sigchld_handler(int sig)
+{
+   job_reap();
+}
+
+void report_done_jobs(void)
+{
+   if (!jobs_done_pending) return;
+   jobs_done_pending = 0;
+
+   for (int i = 0; i < MAX_JOBS; i++)
+   {
+      if (jobs[i].state == 2)
+      {
+         printf("[%d] Done %s\n", jobs[i].id, jobs[i].cmdline);
+         jobs[i].state = 0;
+      }
+   }
+}
+
 void set(const char *var, const char *value)
 {
+   // A new PATH invalidates every remembered resolution
+   if (strcmp(var, "PATH") == 0) hash_clear();
+
    // Check if variable already exists
    for (int i = 0; i < var_count; i++)
    {
@@ -113,8 +235,72 @@ const char *get_var(const char *name)
    return NULL;
 }
 
+unsigned hash_name(const char *name)
+{
+   unsigned h = 5381;
+   while (*name) h = h * 33 + (unsigned char)*name++;
+   return h % HASH_BUCKETS;
+}
+
+const char *hash_lookup(const char *name)
+{
+   for (HashEntry *e = hash_table[hash_name(name)]; e != NULL; e = e->next)
+   {
+      if (strcmp(e->name, name) == 0) return e->path;
+   }
+   return NULL;
+}
+
+void hash_insert(const char *name, const char *path)
+{
+   HashEntry *e = malloc(sizeof(HashEntry));
+   if (e == NULL) return;
+
+   e->name = malloc(strlen(name) + 1);
+   e->path = malloc(strlen(path) + 1);
+   if (e->name == NULL || e->path == NULL)
+   {
+      free(e->name);
+      free(e->path);
+      free(e);
+      return;
+   }
+   strcpy(e->name, name);
+   strcpy(e->path, path);
+
+   unsigned bucket = hash_name(name);
+   e->next = hash_table[bucket];
+   hash_table[bucket] = e;
+}
+
+void hash_clear(void)
+{
+   for (int i = 0; i < HASH_BUCKETS; i++)
+   {
+      HashEntry *e = hash_table[i];
+      while (e != NULL)
+      {
+         HashEntry *next = e->next;
+         free(e->name);
+         free(e->path);
+         free(e);
+         e = next;
+      }
+      hash_table[i] = NULL;
+   }
+}
+
 char *find_executable_in_path(const char *executable)
 {
+   /* Cache hit: hand back a copy so the caller's free stays valid. */
+   const char *cached = hash_lookup(executable);
+   if (cached != NULL)
+   {
+      char *result = malloc(strlen(cached) + 1);
+      if (result != NULL) strcpy(result, cached);
+      return result;
+   }
+
    const char *path_str = get_var("PATH");
    if (path_str == NULL) return NULL;
 
@@ -132,6 +318,7 @@ char *find_executable_in_path(const char *executable)
       // Check if file exists and is executable
       if (access(full_path, X_OK) == 0)
       {
+         hash_insert(executable, full_path);
          char *result = malloc(strlen(full_path) + 1);
          strcpy(result, full_path);
          free(path_copy);
@@ -146,7 +333,8 @@ char *find_executable_in_path(const char *executable)
 }
 
 void execute_with_redirect(const char *full_path, Command *command,
-                           int stdin_fd, int stdout_fd)
+                           int stdin_fd, int stdout_fd, int background,
+                           const char *cmdline)
 {
    pid_t pid = fork();
 
@@ -185,6 +373,17 @@ void execute_with_redirect(const char *full_path, Command *command,
       if (stdin_fd != STDIN_FILENO) close(stdin_fd);
       if (stdout_fd != STDOUT_FILENO) close(stdout_fd);
 
+      if (background)
+      {
+         int id = job_add(1, &pid, cmdline);
+         if (id > 0)
+         {
+            printf("[%d] %d\n", id, (int)pid);
+            return;
+         }
+         printf("sh: job table full; waiting for %d\n", (int)pid);
+      }
+
       int status;
       waitpid(pid, &status, 0);
    }
@@ -223,7 +422,8 @@ int open_output_file(const char *filename, int append)
    return fd;
 }
 
-void execute_pipeline(Pipeline *pipeline)
+void execute_pipeline(Pipeline *pipeline, int background,
+                      const char *cmdline)
 {
    if (pipeline == NULL || pipeline->count == 0) return;
 
@@ -243,6 +443,7 @@ void execute_pipeline(Pipeline *pipeline)
    for (int i = 0; i < pipeline->count; i++)
    {
       Command *cmd = pipeline->commands[i];
+      pids[i] = -1; /* stays -1 when the stage never launches */
       char *full_path = find_executable_in_path(cmd->executable);
 
       if (full_path == NULL)
@@ -323,6 +524,20 @@ void execute_pipeline(Pipeline *pipeline)
    }
    free(pipes);
 
+   if (background && pipeline->count <= JOB_MAX_PIDS)
+   {
+      // Hand the whole pipeline to the jobs table; it is Done once the
+      // reaper has collected every stage.
+      int id = job_add(pipeline->count, pids, cmdline);
+      if (id > 0)
+      {
+         printf("[%d] %d\n", id, (int)pids[pipeline->count - 1]);
+         free(pids);
+         return;
+      }
+      printf("sh: job table full; waiting\n");
+   }
+
    // Wait for all children
    for (int i = 0; i < pipeline->count; i++)
    {
@@ -445,9 +660,108 @@ void Command_HELP(Command *command)
    printf("  exit [code] - Exit the shell\n");
    printf("  cd [dir] - Change directory\n");
    printf("  help - Show this help message\n");
+   printf("  jobs - List background jobs\n");
+   printf("  time command - Run a command and report real/user/sys time\n");
+   printf("  rehash - Forget remembered command locations\n");
+}
+
+void Command_TIME(Command *command)
+{
+   if (command->argc == 0)
+   {
+      printf("Usage: time command [args...]\n");
+      return;
+   }
+
+   char *full_path = find_executable_in_path(command->argv[0]);
+   if (full_path == NULL)
+   {
+      printf("Unknown command: %s\n", command->argv[0]);
+      return;
+   }
+
+   struct timespec start, end;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   pid_t pid = fork();
+   if (pid == 0)
+   {
+      // Honor the line's redirections for the timed child
+      if (command->input_file != NULL)
+      {
+         int fd = open_input_file(command->input_file);
+         if (fd != -1)
+         {
+            dup2(fd, STDIN_FILENO);
+            close(fd);
+         }
+      }
+      if (command->output_file != NULL)
+      {
+         int fd =
+             open_output_file(command->output_file, command->append_output);
+         if (fd != -1)
+         {
+            dup2(fd, STDOUT_FILENO);
+            close(fd);
+         }
+      }
+
+      char **argv = malloc(sizeof(char *) * (command->argc + 1));
+      for (int i = 0; i < command->argc; i++)
+      {
+         argv[i] = command->argv[i];
+      }
+      argv[command->argc] = NULL;
+
+      execv(full_path, argv);
+      perror("execv");
+      exit(1);
+   }
+   else if (pid > 0)
+   {
+      int status;
+      struct rusage usage;
+      memset(&usage, 0, sizeof(usage));
+      wait4(pid, &status, 0, &usage);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+
+      long long real_ms = (long long)(end.tv_sec - start.tv_sec) * 1000 +
+                          (end.tv_nsec - start.tv_nsec) / 1000000;
+      // The kernel fills rusage CPU times as timespecs (sys_rusage in
+      // kernel/syscall/syscall.h), so the usec field carries nanoseconds.
+      long long user_ms = (long long)usage.ru_utime.tv_sec * 1000 +
+                          usage.ru_utime.tv_usec / 1000000;
+      long long sys_ms = (long long)usage.ru_stime.tv_sec * 1000 +
+                         usage.ru_stime.tv_usec / 1000000;
+
+      printf("real\t%lldm%lld.%03llds\n", real_ms / 60000,
+             (real_ms % 60000) / 1000, real_ms % 1000);
+      printf("user\t%lldm%lld.%03llds\n", user_ms / 60000,
+             (user_ms % 60000) / 1000, user_ms % 1000);
+      printf("sys\t%lldm%lld.%03llds\n", sys_ms / 60000,
+             (sys_ms % 60000) / 1000, sys_ms % 1000);
+   }
+   else
+   {
+      perror("fork");
+   }
+
+   free(full_path);
+}
+
+void Command_JOBS(Command *command)
+{
+   job_reap();
+   for (int i = 0; i < MAX_JOBS; i++)
+   {
+      if (jobs[i].state == 0) continue;
+      printf("[%d] %s %s\n", jobs[i].id,
+             jobs[i].state == 1 ? "Running" : "Done", jobs[i].cmdline);
+   }
 }
 
-void execute(Command *command)
+void execute(Command *command, int background, const char *cmdline)
 {
    if (command == NULL) return;
 
@@ -463,6 +777,18 @@ void execute(Command *command)
    {
       Command_HELP(command);
    }
+   else if (strcmp(command->executable, "jobs") == 0)
+   {
+      Command_JOBS(command);
+   }
+   else if (strcmp(command->executable, "time") == 0)
+   {
+      Command_TIME(command);
+   }
+   else if (strcmp(command->executable, "rehash") == 0)
+   {
+      hash_clear();
+   }
    else if (strchr(command->executable, '=') != NULL)
    {
       const char *equal = strchr(command->executable, '=');
@@ -506,7 +832,8 @@ void execute(Command *command)
             }
          }
 
-         execute_with_redirect(full_path, command, stdin_fd, stdout_fd);
+         execute_with_redirect(full_path, command, stdin_fd, stdout_fd,
+                               background, cmdline);
          free(full_path);
       }
       else
@@ -674,7 +1001,13 @@ void loop()
 {
    while (true)
    {
+      // Reap and announce finished background jobs before prompting, so
+      // completions land between commands instead of mid-line.
+      job_reap();
+      report_done_jobs();
+
       printf("sh-%s %s %c ", g_Shell.version, g_Shell.cwd, g_Shell.starter);
+      fflush(stdout); /* one write for the whole prompt */
 
       char input[PATH_MAX];
       if (remaining_command[0] != '\0')
@@ -688,18 +1021,40 @@ void loop()
          fgets(input, PATH_MAX, stdin);
       }
 
+      // A trailing '&' (but not '&&', which parse() splits) sends the
+      // line to the background.
+      int background = 0;
+      size_t inlen = strlen(input);
+      while (inlen > 0 &&
+             (input[inlen - 1] == '\n' || input[inlen - 1] == ' '))
+      {
+         input[--inlen] = '\0';
+      }
+      if (inlen > 0 && input[inlen - 1] == '&' &&
+          (inlen < 2 || input[inlen - 2] != '&'))
+      {
+         input[--inlen] = '\0';
+         while (inlen > 0 && input[inlen - 1] == ' ') input[--inlen] = '\0';
+         background = 1;
+      }
+
+      // Keep the raw line for the jobs table before parsing consumes it
+      char jobline[64];
+      strncpy(jobline, input, sizeof(jobline) - 1);
+      jobline[sizeof(jobline) - 1] = '\0';
+
       Pipeline *pipeline = parse_pipeline(input);
       if (pipeline != NULL)
       {
          if (pipeline->count == 1 && pipeline->commands[0] != NULL)
          {
             // Single command
-            execute(pipeline->commands[0]);
+            execute(pipeline->commands[0], background, jobline);
          }
          else if (pipeline->count > 1)
          {
             // Multiple commands (pipe)
-            execute_pipeline(pipeline);
+            execute_pipeline(pipeline, background, jobline);
             // Clean up pipeline
             for (int i = 0; i < pipeline->count; i++)
             {
@@ -733,6 +1088,10 @@ void init()
    // Set up signal handler for Ctrl+C
    signal(SIGINT, sigint_handler);
 
+   // Reap background children as they die; loop() polls again before
+   // each prompt in case delivery is delayed.
+   signal(SIGCHLD, sigchld_handler);
+
    char *cwd;
    cwd = getcwd(NULL, 0);
    if (cwd != NULL)